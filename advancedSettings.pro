@@ -78,6 +78,24 @@ win32 {
     opensslCopy.path = $$COPY_DEST_DIR
 }
 
+# Build the offline session analyzer next to AdvancedSettings. It doesn't use
+# Qt, so it is its own qmake project that is built as part of the default
+# target. The target is phony and its build directory named differently,
+# otherwise make takes the directory for the target's output and never runs
+# the commands again.
+SESSION_ANALYZER_BUILD_DIR = $$shell_path($$OUT_PWD/session_analyzer_build)
+sessionAnalyzer.target = session_analyzer
+sessionAnalyzer.CONFIG = phony
+sessionAnalyzer.commands = \
+    $$sprintf($$QMAKE_MKDIR_CMD, $$shell_quote($$SESSION_ANALYZER_BUILD_DIR)) \
+    $$escape_expand(\n\t)cd $$shell_quote($$SESSION_ANALYZER_BUILD_DIR) \
+    && $$shell_quote($$shell_path($$QMAKE_QMAKE)) \
+       $$shell_quote($$shell_path($$PWD/src/tools/session_analyzer/session_analyzer.pro)) \
+       DESTDIR=$$shell_quote($$shell_path($$COPY_DEST_DIR)) \
+    && $(MAKE)
+first.depends = $(first) session_analyzer
+QMAKE_EXTRA_TARGETS += first sessionAnalyzer
+
 # Deploy resources and DLLs to exe dir on Windows
 win32 {
     WINDEPLOYQT_LOCATION = $$dirname(QMAKE_QMAKE)/windeployqt6.exe
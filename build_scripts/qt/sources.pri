@@ -3,48 +3,87 @@ SOURCES += src/main.cpp\
     src/tabcontrollers/AudioTabController.cpp \
     src/tabcontrollers/ChaperoneTabController.cpp \
     src/tabcontrollers/BoundrySync.cpp \
+    src/tabcontrollers/DiscoveryBroadcaster.cpp \
+    src/tabcontrollers/PoseStream.cpp \
+    src/tabcontrollers/PushToTalkService.cpp \
+    src/tabcontrollers/AudioRules.cpp \
     src/tabcontrollers/FixFloorTabController.cpp \
     src/tabcontrollers/MoveCenterTabController.cpp \
     src/tabcontrollers/SettingsTabController.cpp \
     src/tabcontrollers/StatisticsTabController.cpp \
+    src/tabcontrollers/statistics/FrameTimings.cpp \
+    src/tabcontrollers/statistics/SessionFormat.cpp \
+    src/tabcontrollers/statistics/SessionRecorder.cpp \
+    src/tabcontrollers/statistics/TimeSeries.cpp \
     src/tabcontrollers/SteamVRTabController.cpp \
+    src/tabcontrollers/bindings/BindingIndex.cpp \
+    src/tabcontrollers/bindings/BindingApplyQueue.cpp \
     src/tabcontrollers/UtilitiesTabController.cpp \
+    src/tabcontrollers/nowplaying/NowPlayingOverlay.cpp \
+    src/tabcontrollers/nowplaying/NowPlayingView.cpp \
     src/tabcontrollers/VideoTabController.cpp \
     src/tabcontrollers/RotationTabController.cpp\
     src/utils/ChaperoneUtils.cpp \
     src/openvr/openvr_init.cpp \
     src/openvr/ivrinput.cpp \
     src/openvr/ovr_settings_wrapper.cpp \
+    src/openvr/ovr_settings_cache.cpp \
     src/openvr/ovr_overlay_wrapper.cpp \
 	src/openvr/ovr_system_wrapper.cpp \
 	src/openvr/lh_console_util.cpp \
+	src/openvr/lh_console_parser.cpp \
 	src/openvr/ovr_application_wrapper.cpp \
     src/utils/setup.cpp \
     src/utils/paths.cpp \
     src/utils/FrameRateUtils.cpp \
+    src/utils/GlyphAtlas.cpp \
     src/keyboard_input/keyboard_input.cpp \
     src/keyboard_input/input_parser.cpp \
+    src/keyboard_input/keyboard_macro.cpp \
     src/settings/settings.cpp \
     src/settings/settings_object.cpp \
+    src/settings/profile_store.cpp \
+    src/settings/settings_file_watcher.cpp \
     src/alarm_clock/vr_alarm.cpp \
     src/utils/update_rate.cpp \
+    src/utils/startup_profiler.cpp \
+    src/utils/startup_tasks.cpp \
+    src/control_socket/control_protocol.cpp \
+    src/control_socket/control_server.cpp \
+    src/control_socket/control_commands.cpp \
 
 
 
 HEADERS += src/overlaycontroller.h \
     src/tabcontrollers/AudioTabController.h \
+    src/tabcontrollers/DiscoveryBroadcaster.h \
+    src/tabcontrollers/DiscoveryProtocol.h \
+    src/tabcontrollers/PoseStream.h \
+    src/tabcontrollers/PoseStreamProtocol.h \
+    src/tabcontrollers/PushToTalkService.h \
+    src/tabcontrollers/AudioRules.h \
     src/tabcontrollers/ChaperoneTabController.h \
     src/tabcontrollers/FixFloorTabController.h \
     src/tabcontrollers/MoveCenterTabController.h \
     src/tabcontrollers/SettingsTabController.h \
     src/tabcontrollers/StatisticsTabController.h \
+    src/tabcontrollers/statistics/FrameTimings.h \
+    src/tabcontrollers/statistics/HdrHistogram.h \
+    src/tabcontrollers/statistics/SessionFormat.h \
+    src/tabcontrollers/statistics/SessionRecorder.h \
+    src/tabcontrollers/statistics/TimeSeries.h \
     src/tabcontrollers/SteamVRTabController.h \
+    src/tabcontrollers/bindings/BindingIndex.h \
+    src/tabcontrollers/bindings/BindingApplyQueue.h \
     src/tabcontrollers/UtilitiesTabController.h \
+    src/tabcontrollers/nowplaying/NowPlayingOverlay.h \
+    src/tabcontrollers/nowplaying/NowPlayingView.h \
     src/tabcontrollers/VideoTabController.h \
     src/tabcontrollers/audiomanager/AudioManager.h \
     src/tabcontrollers/RotationTabController.h\
     src/keyboard_input/keyboard_input.h \
     src/media_keys/media_keys.h \
+    src/media_keys/now_playing.h \
     src/utils/Matrix.h \
     src/utils/ChaperoneUtils.h \
     src/quaternion/quaternion.h \
@@ -55,26 +94,39 @@ HEADERS += src/overlaycontroller.h \
     src/openvr/ivrinput_input_source.h \
     src/openvr/ivrinput.h \
     src/openvr/ovr_settings_wrapper.h \
+    src/openvr/ovr_settings_cache.h \
     src/openvr/ovr_overlay_wrapper.h \
 	src/openvr/ovr_system_wrapper.h \
 	src/openvr/ovr_application_wrapper.h \
 	src/openvr/lh_console_util.h \
+	src/openvr/lh_console_parser.h \
     src/utils/setup.h \
     src/utils/paths.h \
     src/utils/FrameRateUtils.h \
+    src/utils/GlyphAtlas.h \
     src/keyboard_input/input_parser.h \
     src/keyboard_input/input_sender.h \
+    src/keyboard_input/keyboard_macro.h \
     src/settings/settings.h \
-    src/settings/internal/setting_value.h \
     src/settings/internal/settings_internal.h \
     src/settings/internal/settings_controller.h \
-    src/settings/internal/specific_setting_value.h \
+    src/settings/internal/settings_writer.h \
     src/settings/settings_object.h \
+    src/settings/profile_store.h \
+    src/settings/profile_list.h \
+    src/settings/settings_file_watcher.h \
     src/settings/internal/settings_object_data.h \
     src/alarm_clock/vr_alarm.h \
     src/settings/internal/settings_object_data.h \
     src/settings/internal/settings_object_data.h \
     src/utils/update_rate.h \
+    src/utils/spsc_queue.h \
+    src/utils/mpsc_queue.h \
+    src/utils/startup_profiler.h \
+    src/utils/startup_tasks.h \
+    src/control_socket/control_protocol.h \
+    src/control_socket/control_server.h \
+    src/control_socket/control_commands.h \
 
 
 win32 {
@@ -85,6 +137,11 @@ win32 {
 }
 
 unix:!macx {
+    SOURCES += src/keyboard_input/uinput_device.cpp \
+        src/keyboard_input/uinput_sender.cpp
+    HEADERS += src/keyboard_input/uinput_device.h \
+        src/keyboard_input/uinput_sender.h
+
     !noX11 {
         message(X11 features enabled.)
         SOURCES += src/keyboard_input/input_sender_X11.cpp
@@ -93,12 +150,14 @@ unix:!macx {
     }
     else {
         message(X11 features disabled.)
-        SOURCES += src/keyboard_input/input_sender_dummy.cpp
+        SOURCES += src/keyboard_input/input_sender_uinput.cpp
     }
 
     !noDBUS {
         message(DBUS features enabled.)
-        SOURCES += src/media_keys/media_keys_dbus.cpp
+        SOURCES += src/media_keys/media_keys_dbus.cpp \
+            src/media_keys/mpris_registry.cpp
+        HEADERS += src/media_keys/mpris_registry.h
         QT += dbus
     }
     else {
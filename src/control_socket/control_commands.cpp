@@ -0,0 +1,371 @@
+#include "control_commands.h"
+#include <QDir>
+#include <QStandardPaths>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+#include "../overlaycontroller.h"
+#include "../settings/settings.h"
+
+namespace control_socket
+{
+namespace
+{
+    using Controller = advsettings::OverlayController;
+
+    const nlohmann::json& argument( const Request& request, const char* name )
+    {
+        const auto it = request.args.find( name );
+        if ( it == request.args.end() )
+        {
+            throw std::invalid_argument( "Missing argument \""
+                                         + std::string( name ) + "\"." );
+        }
+        return *it;
+    }
+
+    std::string stringArgument( const Request& request, const char* name )
+    {
+        const auto& value = argument( request, name );
+        if ( !value.is_string() )
+        {
+            throw std::invalid_argument( "Argument \"" + std::string( name )
+                                         + "\" must be a string." );
+        }
+        return value.get<std::string>();
+    }
+
+    settings::AnySetting findSetting( const Request& request )
+    {
+        const auto key = stringArgument( request, "key" );
+        const auto setting = settings::findSetting( key );
+        if ( !setting )
+        {
+            throw std::invalid_argument( "Unknown setting '" + key + "'." );
+        }
+        return *setting;
+    }
+
+    nlohmann::json settingValue( const settings::AnySetting& setting )
+    {
+        return std::visit(
+            []( const auto s ) {
+                return nlohmann::json( settings::getSetting( s ) );
+            },
+            setting );
+    }
+
+    // Converts value to the type of setting, the same way readSettingsFile()
+    // rejects values it can't convert.
+    settings::SettingValues toSettingValues( const settings::AnySetting& any,
+                                             const nlohmann::json& value )
+    {
+        settings::SettingValues values;
+        if ( const auto setting = std::get_if<settings::BoolSetting>( &any ) )
+        {
+            if ( value.is_boolean() )
+            {
+                values.bools.emplace_back( *setting, value.get<bool>() );
+            }
+        }
+        else if ( const auto setting
+                  = std::get_if<settings::DoubleSetting>( &any ) )
+        {
+            if ( value.is_number() && std::isfinite( value.get<double>() ) )
+            {
+                values.doubles.emplace_back( *setting, value.get<double>() );
+            }
+        }
+        else if ( const auto setting
+                  = std::get_if<settings::IntSetting>( &any ) )
+        {
+            if ( value.is_number_integer()
+                 && value.get<long long>()
+                        >= std::numeric_limits<int>::min()
+                 && value.get<long long>()
+                        <= std::numeric_limits<int>::max() )
+            {
+                values.ints.emplace_back( *setting, value.get<int>() );
+            }
+        }
+        else if ( const auto setting
+                  = std::get_if<settings::StringSetting>( &any ) )
+        {
+            if ( value.is_string() )
+            {
+                values.strings.emplace_back( *setting,
+                                             value.get<std::string>() );
+            }
+        }
+
+        if ( values.empty() )
+        {
+            throw std::invalid_argument( "Value " + value.dump()
+                                         + " doesn't fit the setting." );
+        }
+        return values;
+    }
+
+    nlohmann::json ping( Controller& controller, const Request& )
+    {
+        return { { "version", controller.getVersionString().toStdString() } };
+    }
+
+    nlohmann::json settingsGet( Controller&, const Request& request )
+    {
+        return { { "value", settingValue( findSetting( request ) ) } };
+    }
+
+    nlohmann::json settingsSet( Controller& controller, const Request& request )
+    {
+        const auto setting = findSetting( request );
+        // Goes through the same setters as an edit of the settings file, so
+        // the change takes effect and the UI follows it.
+        controller.applyExternalSettings(
+            toSettingValues( setting, argument( request, "value" ) ) );
+        return { { "value", settingValue( setting ) } };
+    }
+
+    // The profiles of one tab: how to count, name and apply them.
+    struct ProfileType
+    {
+        const char* name;
+        unsigned ( *count )( Controller& );
+        QString ( *profileName )( Controller&, unsigned );
+        void ( *apply )( Controller&, unsigned );
+    };
+
+    const std::array<ProfileType, 4> k_profileTypes{ {
+        { "video",
+          []( Controller& c ) {
+              return static_cast<unsigned>(
+                  c.m_videoTabController.getVideoProfileCount() );
+          },
+          []( Controller& c, unsigned i ) {
+              return c.m_videoTabController.getVideoProfileName( i );
+          },
+          []( Controller& c, unsigned i ) {
+              c.m_videoTabController.applyVideoProfile( i );
+          } },
+        { "chaperone",
+          []( Controller& c ) {
+              return c.m_chaperoneTabController.getChaperoneProfileCount();
+          },
+          []( Controller& c, unsigned i ) {
+              return c.m_chaperoneTabController.getChaperoneProfileName( i );
+          },
+          []( Controller& c, unsigned i ) {
+              c.m_chaperoneTabController.applyChaperoneProfile( i );
+          } },
+        { "offset",
+          []( Controller& c ) {
+              return c.m_moveCenterTabController.getOffsetProfileCount();
+          },
+          []( Controller& c, unsigned i ) {
+              return c.m_moveCenterTabController.getOffsetProfileName( i );
+          },
+          []( Controller& c, unsigned i ) {
+              c.m_moveCenterTabController.applyOffsetProfile( i );
+          } },
+        { "audio",
+          []( Controller& c ) {
+              return c.m_audioTabController.getAudioProfileCount();
+          },
+          []( Controller& c, unsigned i ) {
+              return c.m_audioTabController.getAudioProfileName( i );
+          },
+          []( Controller& c, unsigned i ) {
+              c.m_audioTabController.applyAudioProfile( i );
+          } },
+    } };
+
+    const ProfileType& profileType( const Request& request )
+    {
+        const auto type = stringArgument( request, "type" );
+        for ( const auto& candidate : k_profileTypes )
+        {
+            if ( type == candidate.name )
+            {
+                return candidate;
+            }
+        }
+        throw std::invalid_argument( "Unknown profile type '" + type + "'." );
+    }
+
+    nlohmann::json profileList( Controller& controller,
+                                const Request& request )
+    {
+        const auto& type = profileType( request );
+        auto names = nlohmann::json::array();
+        const auto count = type.count( controller );
+        for ( unsigned i = 0; i < count; ++i )
+        {
+            names.push_back( type.profileName( controller, i ).toStdString() );
+        }
+        return { { "profiles", names } };
+    }
+
+    nlohmann::json profileApply( Controller& controller,
+                                 const Request& request )
+    {
+        const auto& type = profileType( request );
+        const auto name = stringArgument( request, "name" );
+        const auto count = type.count( controller );
+        for ( unsigned i = 0; i < count; ++i )
+        {
+            if ( type.profileName( controller, i ).toStdString() == name )
+            {
+                LOG( INFO ) << "[Control] Applying " << type.name
+                            << " profile '" << name << "'.";
+                type.apply( controller, i );
+                return { { "applied", name } };
+            }
+        }
+        throw std::invalid_argument( "No " + std::string( type.name )
+                                     + " profile named '" + name + "'." );
+    }
+
+    nlohmann::json
+        offsets( const advsettings::MoveCenterTabController& moveCenter )
+    {
+        return {
+            { "x", moveCenter.offsetX() },
+            { "y", moveCenter.offsetY() },
+            { "z", moveCenter.offsetZ() },
+            { "rotation", moveCenter.rotation() },
+        };
+    }
+
+    nlohmann::json offsetsGet( Controller& controller, const Request& )
+    {
+        return offsets( controller.m_moveCenterTabController );
+    }
+
+    nlohmann::json offsetsSet( Controller& controller, const Request& request )
+    {
+        // Validate everything before moving anything.
+        std::array<std::optional<float>, 3> axes;
+        constexpr std::array<const char*, 3> k_axisNames{ "x", "y", "z" };
+        for ( std::size_t i = 0; i < axes.size(); ++i )
+        {
+            const auto it = request.args.find( k_axisNames[i] );
+            if ( it == request.args.end() )
+            {
+                continue;
+            }
+            if ( !it->is_number() || !std::isfinite( it->get<double>() ) )
+            {
+                throw std::invalid_argument( "Argument \""
+                                             + std::string( k_axisNames[i] )
+                                             + "\" must be a number." );
+            }
+            axes[i] = it->get<float>();
+        }
+        std::optional<int> rotation;
+        const auto it = request.args.find( "rotation" );
+        if ( it != request.args.end() )
+        {
+            if ( !it->is_number_integer() )
+            {
+                throw std::invalid_argument(
+                    "Argument \"rotation\" must be an integer." );
+            }
+            rotation = it->get<int>();
+        }
+
+        auto& moveCenter = controller.m_moveCenterTabController;
+        if ( axes[0] )
+        {
+            moveCenter.setOffsetX( *axes[0] );
+        }
+        if ( axes[1] )
+        {
+            moveCenter.setOffsetY( *axes[1] );
+        }
+        if ( axes[2] )
+        {
+            moveCenter.setOffsetZ( *axes[2] );
+        }
+        if ( rotation )
+        {
+            moveCenter.setRotation( *rotation );
+        }
+        return offsets( moveCenter );
+    }
+
+    nlohmann::json offsetsReset( Controller& controller, const Request& )
+    {
+        controller.m_moveCenterTabController.reset();
+        return offsets( controller.m_moveCenterTabController );
+    }
+
+    nlohmann::json statsGet( Controller& controller, const Request& )
+    {
+        const auto& stats = controller.m_statisticsTabController;
+        return {
+            { "hmdDistanceMoved", stats.hmdDistanceMoved() },
+            { "hmdRotations", stats.hmdRotations() },
+            { "leftControllerMaxSpeed", stats.leftControllerMaxSpeed() },
+            { "rightControllerMaxSpeed", stats.rightControllerMaxSpeed() },
+            { "presentedFrames", stats.presentedFrames() },
+            { "droppedFrames", stats.droppedFrames() },
+            { "reprojectedFrames", stats.reprojectedFrames() },
+            { "timedOut", stats.timedOut() },
+            { "totalReprojectedRatio", stats.totalReprojectedRatio() },
+            { "frameTimingSpikes", stats.frameTimingSpikes() },
+            { "averageFrameGpuMs", stats.averageFrameGpuMs() },
+        };
+    }
+
+    using Command = nlohmann::json ( * )( Controller&, const Request& );
+
+    constexpr std::array<std::pair<const char*, Command>, 9> k_commands{ {
+        { "ping", ping },
+        { "settings.get", settingsGet },
+        { "settings.set", settingsSet },
+        { "profile.list", profileList },
+        { "profile.apply", profileApply },
+        { "offsets.get", offsetsGet },
+        { "offsets.set", offsetsSet },
+        { "offsets.reset", offsetsReset },
+        { "stats.get", statsGet },
+    } };
+} // namespace
+
+nlohmann::json runCommand( advsettings::OverlayController& controller,
+                           const Request& request )
+{
+    for ( const auto& [name, command] : k_commands )
+    {
+        if ( request.command == name )
+        {
+            return command( controller, request );
+        }
+    }
+    throw std::invalid_argument( "Unknown command '" + request.command
+                                 + "'." );
+}
+
+std::string defaultSocketPath()
+{
+    auto directory
+        = QStandardPaths::writableLocation( QStandardPaths::RuntimeLocation );
+    if ( directory.isEmpty() )
+    {
+        // Never the shared temp directory, the socket must stay private to
+        // the user.
+        directory = QStandardPaths::writableLocation(
+            QStandardPaths::AppLocalDataLocation );
+    }
+    if ( directory.isEmpty() || !QDir().mkpath( directory ) )
+    {
+        return {};
+    }
+    return directory.toStdString() + "/ovras-control.sock";
+}
+
+} // namespace control_socket
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include "control_protocol.h"
+
+namespace advsettings
+{
+class OverlayController;
+} // namespace advsettings
+
+namespace control_socket
+{
+/*!
+Runs the control socket command in request against controller and returns
+its result. Must be called on the main thread.
+
+Commands:
+- ping
+- settings.get {key}, settings.set {key, value}. Keys are the ones in the
+  settings file, e.g. "videoSettings/colorRedNew".
+- profile.list {type}, profile.apply {type, name}. type is one of "video",
+  "chaperone", "offset" or "audio".
+- offsets.get, offsets.set {x, y, z, rotation}, offsets.reset. Every member
+  of offsets.set is optional, rotation is in centidegrees like in the UI.
+- stats.get
+
+Throws std::invalid_argument for unknown commands and bad arguments.
+*/
+[[nodiscard]] nlohmann::json
+    runCommand( advsettings::OverlayController& controller,
+                const Request& request );
+
+// Socket path used by the --control-socket and --send-command options, in
+// a directory only the user can reach. Empty if there is no such directory.
+[[nodiscard]] std::string defaultSocketPath();
+
+} // namespace control_socket
@@ -0,0 +1,74 @@
+#include "control_protocol.h"
+
+namespace control_socket
+{
+namespace
+{
+    std::string dumpLine( const nlohmann::json& reply )
+    {
+        // Replies may quote user input or setting values, don't let invalid
+        // UTF-8 throw.
+        return reply.dump(
+                   -1, ' ', false, nlohmann::json::error_handler_t::replace )
+               + "\n";
+    }
+} // namespace
+
+std::optional<Request> parseRequest( const std::string& line,
+                                     std::string& error )
+{
+    auto object = nlohmann::json::parse( line, nullptr, false );
+    if ( object.is_discarded() )
+    {
+        error = "Request is not valid JSON.";
+        return std::nullopt;
+    }
+    if ( !object.is_object() )
+    {
+        error = "Request must be a JSON object.";
+        return std::nullopt;
+    }
+
+    const auto command = object.find( "cmd" );
+    if ( command == object.end() || !command->is_string()
+         || command->get<std::string>().empty() )
+    {
+        error = "Request has no \"cmd\".";
+        return std::nullopt;
+    }
+
+    Request request;
+    const auto id = object.find( "id" );
+    if ( id != object.end() )
+    {
+        request.id = *id;
+    }
+    request.command = command->get<std::string>();
+    request.args = std::move( object );
+    return request;
+}
+
+std::string formatResult( const nlohmann::json& id,
+                          const nlohmann::json& result,
+                          const long long latencyUs )
+{
+    nlohmann::json reply{
+        { "id", id },
+        { "ok", true },
+        { "result", result },
+        { "latencyUs", latencyUs },
+    };
+    return dumpLine( reply );
+}
+
+std::string formatError( const nlohmann::json& id, const std::string& message )
+{
+    nlohmann::json reply{
+        { "id", id },
+        { "ok", false },
+        { "error", message },
+    };
+    return dumpLine( reply );
+}
+
+} // namespace control_socket
@@ -0,0 +1,41 @@
+#pragma once
+#include <optional>
+#include <string>
+#include "../../third-party/nlhomann/json.hpp"
+
+namespace control_socket
+{
+/*!
+One command received on the control socket.
+
+The protocol is JSON lines: every request and every reply is a single JSON
+object terminated by '\n'. A request names its command in "cmd" and passes
+arguments as further members of the same object, an optional "id" of any
+type is echoed in the reply:
+
+\code
+{"id":1,"cmd":"settings.get","key":"videoSettings/colorRedNew"}
+{"id":1,"ok":true,"result":{"value":1.0},"latencyUs":412}
+{"id":2,"cmd":"nope"}
+{"id":2,"ok":false,"error":"Unknown command 'nope'."}
+\endcode
+*/
+struct Request
+{
+    nlohmann::json id;
+    std::string command;
+    // The whole request object, including id and cmd.
+    nlohmann::json args;
+};
+
+// Returns std::nullopt and sets error if line isn't a valid request.
+[[nodiscard]] std::optional<Request> parseRequest( const std::string& line,
+                                                   std::string& error );
+
+[[nodiscard]] std::string formatResult( const nlohmann::json& id,
+                                        const nlohmann::json& result,
+                                        const long long latencyUs );
+[[nodiscard]] std::string formatError( const nlohmann::json& id,
+                                       const std::string& message );
+
+} // namespace control_socket
@@ -0,0 +1,563 @@
+#include "control_server.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <easylogging++.h>
+
+#ifdef _WIN32
+#    include <winsock2.h>
+#    include <afunix.h>
+#    pragma comment( lib, "ws2_32.lib" )
+#else
+#    include <fcntl.h>
+#    include <sys/select.h>
+#    include <sys/socket.h>
+#    include <sys/stat.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+#    include <cerrno>
+#endif
+
+namespace control_socket
+{
+namespace
+{
+#ifdef _WIN32
+    constexpr SocketHandle k_invalidSocket = INVALID_SOCKET;
+    void closeSocket( const SocketHandle s )
+    {
+        closesocket( static_cast<SOCKET>( s ) );
+    }
+    void setNonBlocking( const SocketHandle s )
+    {
+        u_long enabled = 1;
+        ioctlsocket( static_cast<SOCKET>( s ), FIONBIO, &enabled );
+    }
+    bool wouldBlock()
+    {
+        return WSAGetLastError() == WSAEWOULDBLOCK;
+    }
+    constexpr int k_sendFlags = 0;
+    constexpr int k_shutdownBoth = SD_BOTH;
+    using IoSize = int;
+
+    // Winsock is reference counted, every user brackets its sockets.
+    void startSockets()
+    {
+        WSADATA data{};
+        WSAStartup( MAKEWORD( 2, 2 ), &data );
+    }
+    void stopSockets()
+    {
+        WSACleanup();
+    }
+#else
+    constexpr SocketHandle k_invalidSocket = -1;
+    void closeSocket( const SocketHandle s )
+    {
+        close( s );
+    }
+    void setNonBlocking( const SocketHandle s )
+    {
+        fcntl( s, F_SETFL, fcntl( s, F_GETFL, 0 ) | O_NONBLOCK );
+    }
+    bool wouldBlock()
+    {
+#if EAGAIN != EWOULDBLOCK
+        if ( errno == EWOULDBLOCK )
+        {
+            return true;
+        }
+#endif
+        return errno == EAGAIN;
+    }
+    // A client that went away must not kill us with SIGPIPE.
+    constexpr int k_sendFlags = MSG_NOSIGNAL;
+    constexpr int k_shutdownBoth = SHUT_RDWR;
+    using IoSize = std::size_t;
+
+    void startSockets() {}
+    void stopSockets() {}
+#endif
+
+    struct SocketsScope
+    {
+        SocketsScope()
+        {
+            startSockets();
+        }
+        ~SocketsScope()
+        {
+            stopSockets();
+        }
+    };
+
+    // Upper bound on a single select() wait so stop() is honoured promptly.
+    constexpr auto k_maxWaitSlice = std::chrono::milliseconds( 250 );
+
+    bool makeAddress( const std::string& path, sockaddr_un& address )
+    {
+        address = sockaddr_un{};
+        address.sun_family = AF_UNIX;
+        if ( path.empty() || path.size() >= sizeof( address.sun_path ) )
+        {
+            return false;
+        }
+        std::memcpy( address.sun_path, path.c_str(), path.size() );
+        return true;
+    }
+
+    enum class ExistingSocket
+    {
+        None,
+        // Left behind by an instance that is gone.
+        Stale,
+        // Another instance is listening on it.
+        InUse,
+        Unknown,
+    };
+
+    // Tries to connect to the socket at path to find out whether something
+    // already listens there.
+    ExistingSocket probeSocket( const std::string& path,
+                                const sockaddr_un& address )
+    {
+        std::error_code error;
+        if ( !std::filesystem::exists( path, error ) )
+        {
+            return error ? ExistingSocket::Unknown : ExistingSocket::None;
+        }
+        const auto s = socket( AF_UNIX, SOCK_STREAM, 0 );
+        if ( s == k_invalidSocket )
+        {
+            return ExistingSocket::Unknown;
+        }
+        const auto connected = connect( s,
+                                        reinterpret_cast<const sockaddr*>(
+                                            &address ),
+                                        sizeof( address ) )
+                               == 0;
+#ifdef _WIN32
+        const auto refused = WSAGetLastError() == WSAECONNREFUSED;
+#else
+        const auto refused = errno == ECONNREFUSED;
+#endif
+        closeSocket( s );
+        if ( connected )
+        {
+            return ExistingSocket::InUse;
+        }
+        return refused ? ExistingSocket::Stale : ExistingSocket::Unknown;
+    }
+
+    // Waits until s is readable or timeout passed.
+    bool waitReadable( const SocketHandle s,
+                       const std::chrono::milliseconds timeout )
+    {
+        fd_set readSet;
+        FD_ZERO( &readSet );
+        FD_SET( s, &readSet );
+        const auto micros
+            = std::chrono::duration_cast<std::chrono::microseconds>( timeout )
+                  .count();
+        timeval tv{};
+        tv.tv_sec = static_cast<decltype( tv.tv_sec )>( micros / 1000000 );
+        tv.tv_usec = static_cast<decltype( tv.tv_usec )>( micros % 1000000 );
+        return select(
+                   static_cast<int>( s + 1 ), &readSet, nullptr, nullptr, &tv )
+               > 0;
+    }
+
+    bool sendAll( const SocketHandle s, const std::string& data )
+    {
+        std::size_t sent = 0;
+        while ( sent < data.size() )
+        {
+            const auto result = send( s,
+                                      data.data() + sent,
+                                      static_cast<IoSize>( data.size() - sent ),
+                                      k_sendFlags );
+            if ( result <= 0 )
+            {
+                return false;
+            }
+            sent += static_cast<std::size_t>( result );
+        }
+        return true;
+    }
+} // namespace
+
+struct ControlServer::Connection
+{
+    explicit Connection( const SocketHandle s ) : socket( s ) {}
+
+    ~Connection()
+    {
+        close();
+    }
+
+    // Called from the reader and the main loop. A client that doesn't read
+    // its replies fills the socket buffer, it is dropped instead of
+    // blocking the main loop.
+    bool send( const std::string& line )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( broken )
+        {
+            return false;
+        }
+        if ( !sendAll( socket, line ) )
+        {
+            LOG_IF( wouldBlock(), WARNING )
+                << "[Control] Client isn't reading replies, disconnecting.";
+            // Only shut down, the reader notices and closes the socket.
+            // Closing it here could hand its number to another socket while
+            // the reader still waits on it.
+            shutdown( socket, k_shutdownBoth );
+            broken = true;
+            return false;
+        }
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        if ( socket != k_invalidSocket )
+        {
+            closeSocket( socket );
+            socket = k_invalidSocket;
+        }
+        broken = true;
+    }
+
+    std::mutex mutex;
+    // Only closed by the reader thread or the destructor.
+    SocketHandle socket;
+    bool broken = false;
+    std::thread reader;
+    std::atomic<bool> finished{ false };
+};
+
+ControlServer::ControlServer( std::string path )
+    : m_path( std::move( path ) ), m_listenSocket( k_invalidSocket )
+{
+}
+
+ControlServer::~ControlServer()
+{
+    stop();
+}
+
+bool ControlServer::start()
+{
+    if ( m_running )
+    {
+        return true;
+    }
+    sockaddr_un address{};
+    if ( !makeAddress( m_path, address ) )
+    {
+        LOG( ERROR ) << "[Control] Socket path '" << m_path
+                     << "' is empty or too long.";
+        return false;
+    }
+
+    startSockets();
+    switch ( probeSocket( m_path, address ) )
+    {
+    case ExistingSocket::InUse:
+        LOG( ERROR ) << "[Control] Another instance is listening on '"
+                     << m_path << "'.";
+        stopSockets();
+        return false;
+    case ExistingSocket::Stale:
+        // Left behind by a crashed instance, it would make bind fail.
+        std::remove( m_path.c_str() );
+        break;
+    case ExistingSocket::None:
+    case ExistingSocket::Unknown:
+        // Anything else at the path is left alone, bind reports it.
+        break;
+    }
+
+    m_listenSocket = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( m_listenSocket == k_invalidSocket )
+    {
+        LOG( ERROR ) << "[Control] Socket creation failed.";
+        stopSockets();
+        return false;
+    }
+
+#ifndef _WIN32
+    // Anyone who can connect can change settings, so the socket is created
+    // accessible to the user only instead of being restricted after bind.
+    const auto previousMask = umask( S_IRWXG | S_IRWXO );
+#endif
+    const auto bound = bind( m_listenSocket,
+                             reinterpret_cast<sockaddr*>( &address ),
+                             sizeof( address ) )
+                       == 0;
+#ifndef _WIN32
+    umask( previousMask );
+#endif
+    if ( !bound
+         || listen( m_listenSocket, static_cast<int>( k_maxClients ) ) != 0 )
+    {
+        LOG( ERROR ) << "[Control] Could not listen on '" << m_path << "'.";
+        closeSocket( m_listenSocket );
+        m_listenSocket = k_invalidSocket;
+        stopSockets();
+        return false;
+    }
+
+    m_running = true;
+    m_acceptThread = std::thread( &ControlServer::acceptLoop, this );
+    LOG( INFO ) << "[Control] Listening on '" << m_path << "'.";
+    return true;
+}
+
+void ControlServer::stop()
+{
+    if ( !m_running )
+    {
+        return;
+    }
+    m_running = false;
+
+    if ( m_acceptThread.joinable() )
+    {
+        m_acceptThread.join();
+    }
+    reapConnections( true );
+
+    // Drop requests nobody will run anymore, they hold their connection.
+    Pending pending;
+    while ( m_queue.tryPop( pending ) )
+    {
+    }
+    pending = Pending{};
+
+    closeSocket( m_listenSocket );
+    m_listenSocket = k_invalidSocket;
+    std::remove( m_path.c_str() );
+    stopSockets();
+    LOG( INFO ) << "[Control] Stopped.";
+}
+
+bool ControlServer::isRunning() const noexcept
+{
+    return m_running;
+}
+
+const std::string& ControlServer::path() const noexcept
+{
+    return m_path;
+}
+
+std::size_t ControlServer::processPending( const Handler& handler )
+{
+    std::size_t processed = 0;
+    Pending pending;
+    while ( m_queue.tryPop( pending ) )
+    {
+        const auto& request = pending.request;
+        std::string reply;
+        try
+        {
+            const auto result = handler( request );
+            const auto latency
+                = std::chrono::duration_cast<std::chrono::microseconds>(
+                    Clock::now() - pending.received );
+            reply = formatResult(
+                request.id, result, static_cast<long long>( latency.count() ) );
+        }
+        catch ( const std::exception& e )
+        {
+            reply = formatError( request.id, e.what() );
+        }
+        pending.connection->send( reply );
+        ++processed;
+    }
+    return processed;
+}
+
+void ControlServer::acceptLoop()
+{
+    while ( m_running )
+    {
+        reapConnections( false );
+        if ( !waitReadable( m_listenSocket, k_maxWaitSlice ) )
+        {
+            continue;
+        }
+        const auto client = accept( m_listenSocket, nullptr, nullptr );
+        if ( client == k_invalidSocket )
+        {
+            continue;
+        }
+
+        auto connection = std::make_shared<Connection>( client );
+        std::lock_guard<std::mutex> lock( m_connectionsMutex );
+        if ( m_connections.size() >= k_maxClients )
+        {
+            connection->send(
+                formatError( nullptr, "Too many control clients." ) );
+            continue;
+        }
+        setNonBlocking( client );
+        connection->reader
+            = std::thread( &ControlServer::readLoop, this, connection );
+        m_connections.push_back( std::move( connection ) );
+    }
+}
+
+void ControlServer::readLoop( const std::shared_ptr<Connection>& connection )
+{
+    std::string buffer;
+    char chunk[4096];
+    const auto s = connection->socket;
+    while ( m_running )
+    {
+        if ( !waitReadable( s, k_maxWaitSlice ) )
+        {
+            continue;
+        }
+        const auto received
+            = recv( s, chunk, static_cast<IoSize>( sizeof( chunk ) ), 0 );
+        if ( received <= 0 )
+        {
+            if ( received < 0 && wouldBlock() )
+            {
+                continue;
+            }
+            // Closed by the client, or shut down by send().
+            break;
+        }
+        buffer.append( chunk, static_cast<std::size_t>( received ) );
+
+        std::size_t start = 0;
+        for ( auto end = buffer.find( '\n' ); end != std::string::npos;
+              end = buffer.find( '\n', start ) )
+        {
+            auto line = buffer.substr( start, end - start );
+            start = end + 1;
+            if ( !line.empty() && line.back() == '\r' )
+            {
+                line.pop_back();
+            }
+            if ( !line.empty() )
+            {
+                handleLine( connection, line );
+            }
+        }
+        buffer.erase( 0, start );
+
+        if ( buffer.size() > k_maxLineLength )
+        {
+            connection->send( formatError( nullptr, "Request too long." ) );
+            break;
+        }
+    }
+    connection->close();
+    connection->finished = true;
+}
+
+void ControlServer::handleLine( const std::shared_ptr<Connection>& connection,
+                                const std::string& line )
+{
+    std::string error;
+    auto request = parseRequest( line, error );
+    if ( !request )
+    {
+        connection->send( formatError( nullptr, error ) );
+        return;
+    }
+
+    const auto id = request->id;
+    if ( !m_queue.tryPush(
+             Pending{ connection, std::move( *request ), Clock::now() } ) )
+    {
+        connection->send( formatError( id, "Command queue is full." ) );
+    }
+}
+
+void ControlServer::reapConnections( const bool all )
+{
+    std::vector<std::shared_ptr<Connection>> done;
+    {
+        std::lock_guard<std::mutex> lock( m_connectionsMutex );
+        const auto split = std::stable_partition(
+            m_connections.begin(),
+            m_connections.end(),
+            [all]( const auto& c ) { return !all && !c->finished; } );
+        done.assign( std::make_move_iterator( split ),
+                     std::make_move_iterator( m_connections.end() ) );
+        m_connections.erase( split, m_connections.end() );
+    }
+    for ( const auto& connection : done )
+    {
+        if ( connection->reader.joinable() )
+        {
+            connection->reader.join();
+        }
+    }
+}
+
+std::optional<std::string>
+    sendCommand( const std::string& path,
+                 const std::string& line,
+                 const std::chrono::milliseconds timeout )
+{
+    const SocketsScope sockets;
+
+    sockaddr_un address{};
+    if ( !makeAddress( path, address ) )
+    {
+        return std::nullopt;
+    }
+    const auto s = socket( AF_UNIX, SOCK_STREAM, 0 );
+    if ( s == k_invalidSocket )
+    {
+        return std::nullopt;
+    }
+    std::optional<std::string> reply;
+    const auto connected
+        = connect(
+              s, reinterpret_cast<sockaddr*>( &address ), sizeof( address ) )
+          == 0;
+    if ( connected && sendAll( s, line + "\n" ) )
+    {
+        const auto deadline = Clock::now() + timeout;
+        std::string buffer;
+        char chunk[4096];
+        while ( Clock::now() < deadline )
+        {
+            const auto remaining
+                = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - Clock::now() );
+            if ( !waitReadable( s, remaining ) )
+            {
+                continue;
+            }
+            const auto received
+                = recv( s, chunk, static_cast<IoSize>( sizeof( chunk ) ), 0 );
+            if ( received <= 0 )
+            {
+                break;
+            }
+            buffer.append( chunk, static_cast<std::size_t>( received ) );
+            const auto end = buffer.find( '\n' );
+            if ( end != std::string::npos )
+            {
+                reply = buffer.substr( 0, end );
+                break;
+            }
+        }
+    }
+    closeSocket( s );
+    return reply;
+}
+
+} // namespace control_socket
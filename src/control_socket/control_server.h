@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "control_protocol.h"
+#include "../utils/mpsc_queue.h"
+
+namespace control_socket
+{
+using Clock = std::chrono::steady_clock;
+
+#ifdef _WIN32
+using SocketHandle = std::uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+
+// Runs one command and returns its result. Throwing a std::exception
+// reports its message to the client as an error.
+using Handler = std::function<nlohmann::json( const Request& request )>;
+
+/*!
+Local control socket for scripting the application without its UI.
+
+Listens on a Unix domain socket at path (AF_UNIX is also available on
+Windows 10 and later). Every client gets its own reader thread that splits
+the stream into lines, parses them and pushes the requests into a lock free
+MPSC queue. Nothing is executed on those threads: processPending() is called
+from the main loop and runs the queued requests there, in the order they
+arrived per client, so handlers can use the controllers like any UI action.
+
+Replies carry the time from receiving the line to finishing the command in
+"latencyUs", which makes command to effect latency measurable from scripts.
+
+Malformed lines are answered by the reader thread right away. When the queue
+is full the request is rejected with an error instead of blocking the
+reader.
+*/
+class ControlServer
+{
+public:
+    static constexpr std::size_t k_queueSize = 256;
+    static constexpr std::size_t k_maxClients = 8;
+    static constexpr std::size_t k_maxLineLength = 64 * 1024;
+
+    explicit ControlServer( std::string path );
+    ~ControlServer();
+
+    ControlServer( const ControlServer& ) = delete;
+    ControlServer& operator=( const ControlServer& ) = delete;
+
+    // Returns false if the socket couldn't be created.
+    bool start();
+    void stop();
+    [[nodiscard]] bool isRunning() const noexcept;
+
+    // Main loop side. Runs every queued request with handler and replies
+    // to its client. Returns the number of requests run.
+    std::size_t processPending( const Handler& handler );
+
+    [[nodiscard]] const std::string& path() const noexcept;
+
+private:
+    struct Connection;
+
+    struct Pending
+    {
+        std::shared_ptr<Connection> connection;
+        Request request;
+        Clock::time_point received;
+    };
+
+    void acceptLoop();
+    void readLoop( const std::shared_ptr<Connection>& connection );
+    void handleLine( const std::shared_ptr<Connection>& connection,
+                     const std::string& line );
+    void reapConnections( const bool all );
+
+    std::string m_path;
+    SocketHandle m_listenSocket;
+    std::atomic<bool> m_running{ false };
+
+    utils::MpscQueue<Pending, k_queueSize> m_queue;
+
+    std::mutex m_connectionsMutex;
+    std::vector<std::shared_ptr<Connection>> m_connections;
+    std::thread m_acceptThread;
+};
+
+/*!
+Client side, used by the command line. Connects to the server at path, sends
+line and returns the reply line without its '\n'. Returns std::nullopt if
+the server can't be reached or doesn't reply within timeout.
+*/
+[[nodiscard]] std::optional<std::string>
+    sendCommand( const std::string& path,
+                 const std::string& line,
+                 const std::chrono::milliseconds timeout );
+
+} // namespace control_socket
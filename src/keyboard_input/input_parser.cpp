@@ -1,282 +1,309 @@
 #include "input_parser.h"
+#include <array>
 
-std::optional<Token> getModifier( const char& character ) noexcept
+namespace
 {
-    switch ( character )
-    {
-    case '^':
-        return Token::MODIFIER_CTRL;
-    case '*':
-        return Token::MODIFIER_ALT;
-    case '>':
-        return Token::MODIFIER_SHIFT;
-    case '#':
-        return Token::MODIFIER_SUPER;
-    default:
-        return std::nullopt;
-    }
-}
-
-std::optional<Token> getNumberOrLetter( const char& character ) noexcept
+enum class CharClass
 {
-    if ( islower( character ) || isdigit( character ) )
-    {
-        return static_cast<Token>( character );
-    }
-    return std::nullopt;
-}
-
-std::optional<Token> getFunctionNumber( const char& character ) noexcept
+    Unknown,
+    // Lower case letters and digits, the token is the character.
+    Literal,
+    Modifier,
+    Space,
+    // F1 to F9.
+    FunctionKey,
+    // G0 to G9 for F10 to F19.
+    ExtendedFunctionKey,
+    // Any other upper case letter starts a key name.
+    KeyName,
+};
+
+struct CharEntry
 {
-    switch ( character )
-    {
-    case '1':
-        return Token::KEY_F1;
-    case '2':
-        return Token::KEY_F2;
-    case '3':
-        return Token::KEY_F3;
-    case '4':
-        return Token::KEY_F4;
-    case '5':
-        return Token::KEY_F5;
-    case '6':
-        return Token::KEY_F6;
-    case '7':
-        return Token::KEY_F7;
-    case '8':
-        return Token::KEY_F8;
-    case '9':
-        return Token::KEY_F9;
+    CharClass type = CharClass::Unknown;
+    Token token = Token::KEY_a;
+};
 
-    default:
-        LOG( INFO ) << "Unknown function key number: " << character;
-        return std::nullopt;
-    }
-}
+using CharTable = std::array<CharEntry, 256>;
 
-std::optional<Token> getFunctionNumberExtended( const char& character ) noexcept
+constexpr CharTable makeCharTable() noexcept
 {
-    switch ( character )
+    CharTable table{};
+    for ( std::size_t c = 'a'; c <= 'z'; ++c )
     {
-    case '0':
-        return Token::KEY_F10;
-    case '1':
-        return Token::KEY_F11;
-    case '2':
-        return Token::KEY_F12;
-    case '3':
-        return Token::KEY_F13;
-    case '4':
-        return Token::KEY_F14;
-    case '5':
-        return Token::KEY_F15;
-    case '6':
-        return Token::KEY_F16;
-    case '7':
-        return Token::KEY_F17;
-    case '8':
-        return Token::KEY_F18;
-    case '9':
-        return Token::KEY_F19;
-    default:
-        LOG( INFO ) << "Unknown function key number: " << character;
-        return std::nullopt;
-    }
-}
-
-std::optional<Token> checkIfLegalCapitalLiteral( std::string input ) noexcept
-{
-    // C++ can't do string comparisons in switches. :(
-    if ( input == "BACKSPACE" )
-    {
-        return Token::KEY_BACKSPACE;
+        table[c] = { CharClass::Literal, static_cast<Token>( c ) };
     }
-    if ( input == "SPACE" )
+    for ( std::size_t c = '0'; c <= '9'; ++c )
     {
-        return Token::KEY_SPACE;
+        table[c] = { CharClass::Literal, static_cast<Token>( c ) };
     }
-    if ( input == "TAB" )
+    for ( std::size_t c = 'A'; c <= 'Z'; ++c )
     {
-        return Token::KEY_TAB;
+        table[c].type = CharClass::KeyName;
     }
-    if ( input == "ESC" )
+    table['F'].type = CharClass::FunctionKey;
+    table['G'].type = CharClass::ExtendedFunctionKey;
+    // Same characters as isspace() in the C locale.
+    for ( const auto c : std::string_view( " \t\n\v\f\r" ) )
     {
-        return Token::KEY_ESC;
+        table[static_cast<unsigned char>( c )].type = CharClass::Space;
     }
-    if ( input == "INS" )
-    {
-        return Token::KEY_INS;
-    }
-    if ( input == "DEL" )
-    {
-        return Token::KEY_DEL;
-    }
-    if ( input == "END" )
-    {
-        return Token::KEY_END;
-    }
-    if ( input == "PGDN" )
-    {
-        return Token::KEY_PGDN;
-    }
-    if ( input == "PGUP" )
-    {
-        return Token::KEY_PGUP;
-    }
-    if ( input == "CAPS" )
-    {
-        return Token::KEY_CAPS;
-    }
-    if ( input == "PRNSCRN" )
-    {
-        return Token::KEY_PRNSCRN;
-    }
-    if ( input == "PAUSE" )
-    {
-        return Token::KEY_PAUSE;
-    }
-    if ( input == "SCRLOCK" )
-    {
-        return Token::KEY_SCRLOCK;
-    }
-    if ( input == "LEFTARROW" )
-    {
-        return Token::KEY_LEFTARROW;
-    }
-    if ( input == "RIGHTARROW" )
+    table['^'] = { CharClass::Modifier, Token::MODIFIER_CTRL };
+    table['*'] = { CharClass::Modifier, Token::MODIFIER_ALT };
+    table['>'] = { CharClass::Modifier, Token::MODIFIER_SHIFT };
+    table['#'] = { CharClass::Modifier, Token::MODIFIER_SUPER };
+    return table;
+}
+
+constexpr CharTable k_charTable = makeCharTable();
+
+struct KeyName
+{
+    std::string_view name;
+    Token token;
+};
+
+// No name is the start of another one, so the first match is the only one.
+constexpr std::array<KeyName, 23> k_keyNames = { {
+    { "BACKSPACE", Token::KEY_BACKSPACE },
+    { "SPACE", Token::KEY_SPACE },
+    { "TAB", Token::KEY_TAB },
+    { "ESC", Token::KEY_ESC },
+    { "INS", Token::KEY_INS },
+    { "DEL", Token::KEY_DEL },
+    { "END", Token::KEY_END },
+    { "PGDN", Token::KEY_PGDN },
+    { "PGUP", Token::KEY_PGUP },
+    { "CAPS", Token::KEY_CAPS },
+    { "PRNSCRN", Token::KEY_PRNSCRN },
+    { "PAUSE", Token::KEY_PAUSE },
+    { "SCRLOCK", Token::KEY_SCRLOCK },
+    { "LEFTARROW", Token::KEY_LEFTARROW },
+    { "RIGHTARROW", Token::KEY_RIGHTARROW },
+    { "UPARROW", Token::KEY_UPARROW },
+    { "DOWNARROW", Token::KEY_DOWNARROW },
+    { "KPSLASH", Token::KEY_KPSLASH },
+    { "KPSTAR", Token::KEY_KPSTAR },
+    { "KPMINUS", Token::KEY_KPMINUS },
+    { "KPPLUS", Token::KEY_KPPLUS },
+    { "ENTER", Token::KEY_ENTER },
+    { "BACKSLASH", Token::KEY_BACKSLASH },
+} };
+
+static_assert( static_cast<int>( Token::KEY_F1 ) == 0
+                   && static_cast<int>( Token::KEY_F19 ) == 18,
+               "Function keys are looked up by number." );
+
+std::optional<Token> getFunctionKey( const CharClass type,
+                                     const char digit ) noexcept
+{
+    if ( digit < '0' || digit > '9' )
     {
-        return Token::KEY_RIGHTARROW;
+        return std::nullopt;
     }
-    if ( input == "UPARROW" )
+    const auto number = ( type == CharClass::FunctionKey ? 0 : 10 )
+                        + ( digit - '0' );
+    if ( number == 0 )
     {
-        return Token::KEY_UPARROW;
+        return std::nullopt;
     }
-    if ( input == "DOWNARROW" )
+    return static_cast<Token>( number - 1 );
+}
+
+const KeyName* getKeyName( const std::string_view rest ) noexcept
+{
+    for ( const auto& key : k_keyNames )
     {
-        return Token::KEY_DOWNARROW;
+        if ( rest.substr( 0, key.name.size() ) == key.name )
+        {
+            return &key;
+        }
     }
-    if ( input == "KPSLASH" )
+    return nullptr;
+}
+
+unsigned modifierBit( const Token modifier ) noexcept
+{
+    return 1u << ( static_cast<int>( modifier )
+                   - static_cast<int>( Token::MODIFIER_CTRL ) );
+}
+
+// Writes tokens into the buffer. With dropIncorrect it also does what
+// removeIncorrectTokens() does to the tokens, while they are written.
+class TokenWriter
+{
+public:
+    TokenWriter( Token* buffer,
+                 const std::size_t capacity,
+                 const bool dropIncorrect ) noexcept
+        : m_buffer( buffer ), m_capacity( capacity ),
+          m_dropIncorrect( dropIncorrect )
     {
-        return Token::KEY_KPSLASH;
     }
-    if ( input == "KPSTAR" )
+
+    [[nodiscard]] bool hasRoom( const std::size_t tokens ) const noexcept
     {
-        return Token::KEY_KPSTAR;
+        return m_capacity - m_count >= tokens;
     }
-    if ( input == "KPMINUS" )
+
+    void newSequence() noexcept
     {
-        return Token::KEY_KPMINUS;
+        m_modifiersInSequence = 0;
+        if ( m_dropIncorrect && m_count > 0
+             && m_buffer[m_count - 1] == Token::TOKEN_NEW_SEQUENCE )
+        {
+            return;
+        }
+        write( Token::TOKEN_NEW_SEQUENCE );
     }
-    if ( input == "KPPLUS" )
+
+    void modifier( const Token modifier ) noexcept
     {
-        return Token::KEY_KPPLUS;
+        write( Token::TOKEN_NO_KEYUP_NEXT );
+        const auto bit = modifierBit( modifier );
+        if ( m_dropIncorrect && ( m_modifiersInSequence & bit ) != 0 )
+        {
+            return;
+        }
+        m_modifiersInSequence |= bit;
+        write( modifier );
     }
-    if ( input == "ENTER" )
+
+    void write( const Token token ) noexcept
     {
-        return Token::KEY_ENTER;
+        m_buffer[m_count++] = token;
     }
-    if ( input == "BACKSLASH" )
+
+    [[nodiscard]] std::size_t count() const noexcept
     {
-        return Token::KEY_BACKSLASH;
+        return m_count;
     }
 
-    return std::nullopt;
-}
+private:
+    Token* m_buffer;
+    std::size_t m_capacity;
+    bool m_dropIncorrect;
+    std::size_t m_count = 0;
+    unsigned m_modifiersInSequence = 0;
+};
 
-std::vector<Token>
-    ParseKeyboardInputsToTokens( const std::string inputs ) noexcept
+LexResult lex( const std::string_view inputs,
+               Token* buffer,
+               const std::size_t capacity,
+               const bool dropIncorrect ) noexcept
 {
-    std::vector<Token> tokens{};
-
-    for ( auto ch = inputs.begin(), end = inputs.end(); ch != end; ++ch )
-    {
-        if ( const auto c = getNumberOrLetter( *ch ); c.has_value() )
+    TokenWriter writer( buffer, capacity, dropIncorrect );
+    LexResult result;
+    const auto fail = [&result, &writer]( const LexError error,
+                                          const std::size_t position ) {
+        if ( result.error == LexError::None )
         {
-            tokens.push_back( *c );
-            continue;
-        }
-        if ( const auto c = getModifier( *ch ); c.has_value() )
-        {
-            tokens.push_back( Token::TOKEN_NO_KEYUP_NEXT );
-            tokens.push_back( *c );
-            continue;
+            result.error = error;
+            result.errorPosition = position;
         }
+        result.count = writer.count();
+        return result;
+    };
 
-        if ( isspace( *ch ) )
+    for ( std::size_t i = 0; i < inputs.size(); ++i )
+    {
+        const auto& entry
+            = k_charTable[static_cast<unsigned char>( inputs[i] )];
+        if ( entry.type == CharClass::Unknown )
         {
-            tokens.push_back( Token::TOKEN_NEW_SEQUENCE );
+            fail( LexError::UnknownCharacter, i );
+            continue;
         }
-
-        if ( !isupper( *ch ) || isspace( *ch ) )
+        if ( !writer.hasRoom( entry.type == CharClass::Modifier ? 2 : 1 ) )
         {
-            LOG( INFO ) << "Unknown character found in sequence: " << *ch;
-            continue;
+            return fail( LexError::BufferFull, i );
         }
-        // Everything below is upper case
 
-        if ( *ch == 'F' )
+        switch ( entry.type )
         {
-            ++ch;
-            if ( ch == end )
-            {
-                break;
-            }
-            const auto token = getFunctionNumber( *ch );
-            if ( token.has_value() )
-            {
-                tokens.push_back( *token );
-                continue;
-            }
-            else
-            {
-                // Spec says to abort on errors and submit correct values before
-                // error.
-                break;
-            }
-        }
-        else if ( *ch == 'G' )
+        case CharClass::Literal:
+            writer.write( entry.token );
+            break;
+        case CharClass::Modifier:
+            writer.modifier( entry.token );
+            break;
+        case CharClass::Space:
+            writer.newSequence();
+            break;
+        case CharClass::FunctionKey:
+            [[fallthrough]];
+        case CharClass::ExtendedFunctionKey:
         {
-            ++ch;
-            if ( ch == end )
+            const auto token = getFunctionKey(
+                entry.type, i + 1 < inputs.size() ? inputs[i + 1] : '\0' );
+            if ( !token.has_value() )
             {
-                break;
-            }
-            const auto token = getFunctionNumberExtended( *ch );
-            if ( token.has_value() )
-            {
-                tokens.push_back( *token );
-                continue;
-            }
-            else
-            {
-                // Spec says to abort on errors and submit correct values before
-                // error.
-                break;
+                // Spec says to abort on errors and submit correct values
+                // before error.
+                return fail( LexError::BadFunctionKey, i );
             }
+            writer.write( *token );
+            ++i;
+            break;
         }
-
-        std::string characters;
-        characters.push_back( *ch );
-        while ( ch + 1 != end )
+        case CharClass::KeyName:
         {
-            ++ch;
-            characters.push_back( *ch );
-            if ( auto c = checkIfLegalCapitalLiteral( characters );
-                 c.has_value() )
+            const auto key = getKeyName( inputs.substr( i ) );
+            if ( key == nullptr )
             {
-                tokens.push_back( *c );
-                characters.clear();
-                // break out of the while
-                break;
+                return fail( LexError::UnknownKeyName, i );
             }
+            writer.write( key->token );
+            i += key->name.size() - 1;
+            break;
         }
-        if ( ch == end )
-        {
+        case CharClass::Unknown:
             break;
         }
     }
 
+    result.count = writer.count();
+    return result;
+}
+} // namespace
+
+LexResult lexKeyboardInputs( const std::string_view inputs,
+                             Token* buffer,
+                             const std::size_t capacity ) noexcept
+{
+    return lex( inputs, buffer, capacity, true );
+}
+
+const char* lexErrorMessage( const LexError error ) noexcept
+{
+    switch ( error )
+    {
+    case LexError::None:
+        return "No error";
+    case LexError::UnknownCharacter:
+        return "Unknown character";
+    case LexError::BadFunctionKey:
+        return "Function key needs F1 to F9 or G0 to G9";
+    case LexError::UnknownKeyName:
+        return "Unknown key name";
+    case LexError::BufferFull:
+        return "Too many keys";
+    }
+    return "Unknown error";
+}
+
+std::vector<Token>
+    ParseKeyboardInputsToTokens( const std::string inputs ) noexcept
+{
+    std::vector<Token> tokens( lexBufferSize( inputs.size() ) );
+    const auto result = lex( inputs, tokens.data(), tokens.size(), false );
+    tokens.resize( result.count );
+    if ( !result.ok() )
+    {
+        LOG( INFO ) << lexErrorMessage( result.error )
+                    << " in keyboard input at position "
+                    << result.errorPosition;
+    }
     return tokens;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <cctype>
 #include <optional>
@@ -104,6 +105,52 @@ enum class Token
     KEY_9 = '9',
 };
 
+enum class LexError
+{
+    None,
+    // Skipped, lexing goes on after it.
+    UnknownCharacter,
+    // F or G without a valid number after it, ends lexing.
+    BadFunctionKey,
+    // Upper case letters that don't spell a key name, ends lexing.
+    UnknownKeyName,
+    // The buffer can't hold the next token, ends lexing.
+    BufferFull,
+};
+
+struct LexResult
+{
+    // Tokens written to the buffer.
+    std::size_t count = 0;
+    // The first error in the input and where it starts.
+    LexError error = LexError::None;
+    std::size_t errorPosition = 0;
+
+    [[nodiscard]] bool ok() const noexcept
+    {
+        return error == LexError::None;
+    }
+};
+
+// A buffer this large always holds the tokens of an input of inputSize
+// characters.
+constexpr std::size_t lexBufferSize( const std::size_t inputSize ) noexcept
+{
+    return inputSize * 2;
+}
+
+/*!
+Lexes inputs in a single pass into buffer, without allocating. The tokens are
+the same as removeIncorrectTokens( ParseKeyboardInputsToTokens( inputs ) ).
+Like the parser, lexing stops at the first error it can't skip and keeps the
+tokens before it.
+*/
+LexResult lexKeyboardInputs( const std::string_view inputs,
+                             Token* buffer,
+                             const std::size_t capacity ) noexcept;
+
+const char* lexErrorMessage( const LexError error ) noexcept;
+
 std::vector<Token>
     ParseKeyboardInputsToTokens( const std::string inputs ) noexcept;
 std::vector<Token>
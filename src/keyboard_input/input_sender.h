@@ -1,5 +1,7 @@
 #pragma once
+#include <array>
 #include "input_parser.h"
+#include "keyboard_macro.h"
 #include <easylogging++.h>
 
 enum class KeyStatus
@@ -13,6 +15,12 @@ void shutdownOsSystems();
 
 void sendKeyPress( const Token token, const KeyStatus status );
 
+// Platform key code for compiling keyboard_macro::Macro.
+uint32_t resolveKeyCode( const Token token );
+// Sends all events of the macro in one batch.
+void sendMacro( const keyboard_macro::Macro& macro );
+void sendMacroKey( const uint32_t keyCode, const KeyStatus status );
+
 inline void sendTokensAsInput( const std::vector<Token> tokens )
 {
     initOsSystems();
@@ -72,17 +80,27 @@ inline void sendTokenPress( const Token token, KeyStatus event = KeyStatus::Up )
 inline void sendFirstCharAsInput( const std::string inputstring,
                                   KeyStatus event )
 {
-    const auto tokens = ParseKeyboardInputsToTokens( inputstring );
-    const auto inputs = removeIncorrectTokens( tokens );
-    if ( !tokens.empty() )
+    // A modifier takes two tokens.
+    std::array<Token, 2> tokens;
+    const auto result
+        = lexKeyboardInputs( inputstring, tokens.data(), tokens.size() );
+    if ( result.count > 0 )
     {
-        sendTokenPress( inputs.front(), event );
+        sendTokenPress( tokens.front(), event );
     }
 }
 
 inline void sendStringAsInput( const std::string input )
 {
-    const auto tokens = ParseKeyboardInputsToTokens( input );
-    const auto inputs = removeIncorrectTokens( tokens );
+    std::vector<Token> inputs( lexBufferSize( input.size() ) );
+    const auto result
+        = lexKeyboardInputs( input, inputs.data(), inputs.size() );
+    if ( !result.ok() )
+    {
+        LOG( INFO ) << lexErrorMessage( result.error )
+                    << " in keyboard input at position "
+                    << result.errorPosition;
+    }
+    inputs.resize( result.count );
     sendTokensAsInput( inputs );
 }
@@ -1,4 +1,7 @@
 #include "input_sender.h"
+#include <cstdlib>
+#include <string>
+#include "uinput_sender.h"
 #include <X11/Xlib.h>
 #include <X11/Intrinsic.h>
 #include <X11/extensions/XTest.h>
@@ -185,25 +188,96 @@ unsigned int tokenToKeySym( const Token token )
     }
 }
 
+Display* getDisplay();
+
+namespace
+{
+enum class Backend
+{
+    Disabled,
+    X11,
+    Uinput,
+};
+
+Display* openDisplay()
+{
+    const auto display = XOpenDisplay( nullptr );
+    if ( !display )
+    {
+        LOG( WARNING ) << "Could not open the X display.";
+    }
+    return display;
+}
+
+/*!
+XTest events only reach X clients, on Wayland that leaves out the compositor
+and every native Wayland window. uinput goes through the kernel instead, so
+it is preferred there and used whenever there is no X display.
+*/
+Backend chooseBackend()
+{
+    const auto session = std::getenv( "XDG_SESSION_TYPE" );
+    const auto wayland = session && std::string( session ) == "wayland";
+    if ( !wayland && getDisplay() )
+    {
+        return Backend::X11;
+    }
+    if ( uinput_sender::available() )
+    {
+        LOG( INFO ) << "Sending keyboard input through uinput.";
+        return Backend::Uinput;
+    }
+    if ( getDisplay() )
+    {
+        return Backend::X11;
+    }
+    LOG( WARNING ) << "No keyboard input backend available, keyboard "
+                      "shortcuts are disabled.";
+    return Backend::Disabled;
+}
+
+Backend backend()
+{
+    static const auto chosen = chooseBackend();
+    return chosen;
+}
+} // namespace
+
 Display* getDisplay()
 {
-    static Display* display = XOpenDisplay( nullptr );
+    static Display* display = openDisplay();
     return display;
 }
 
 void initOsSystems()
 {
-    XTestGrabControl( getDisplay(), True );
+    if ( backend() == Backend::X11 )
+    {
+        XTestGrabControl( getDisplay(), True );
+    }
 }
 
 void shutdownOsSystems()
 {
-    XSync( getDisplay(), False );
-    XTestGrabControl( getDisplay(), False );
+    if ( backend() == Backend::X11 )
+    {
+        XSync( getDisplay(), False );
+        XTestGrabControl( getDisplay(), False );
+    }
 }
 
 void sendKeyPress( const Token token, const KeyStatus status )
 {
+    if ( backend() == Backend::Uinput )
+    {
+        uinput_sender::sendKeyPress( token, status );
+        return;
+    }
+    if ( backend() != Backend::X11 )
+    {
+        return;
+    }
+
     bool keyDown = false;
 
     if ( status == KeyStatus::Down )
@@ -216,3 +290,64 @@ void sendKeyPress( const Token token, const KeyStatus status )
                        keyDown,
                        0 );
 }
+
+uint32_t resolveKeyCode( const Token token )
+{
+    switch ( backend() )
+    {
+    case Backend::X11:
+        return XKeysymToKeycode( getDisplay(), tokenToKeySym( token ) );
+    case Backend::Uinput:
+        return uinput_sender::resolveKeyCode( token );
+    case Backend::Disabled:
+        break;
+    }
+    return 0;
+}
+
+/*!
+Queues every event and only flushes once. Delays are passed to the XTest
+extension, the server waits before the event, so nothing blocks here.
+*/
+void sendMacro( const keyboard_macro::Macro& macro )
+{
+    if ( backend() == Backend::Uinput )
+    {
+        uinput_sender::sendMacro( macro );
+        return;
+    }
+    const auto display = getDisplay();
+    if ( backend() != Backend::X11 || macro.ops.empty() )
+    {
+        return;
+    }
+
+    unsigned long delayMs = 0;
+    for ( const auto& op : macro.ops )
+    {
+        delayMs += op.delayMs;
+        if ( op.keyCode == 0 )
+        {
+            continue;
+        }
+        XTestFakeKeyEvent( display, op.keyCode, op.down, delayMs );
+        delayMs = 0;
+    }
+    XFlush( display );
+}
+
+void sendMacroKey( const uint32_t keyCode, const KeyStatus status )
+{
+    if ( backend() == Backend::Uinput )
+    {
+        uinput_sender::sendMacroKey( keyCode, status );
+        return;
+    }
+    const auto display = getDisplay();
+    if ( backend() != Backend::X11 || keyCode == 0 )
+    {
+        return;
+    }
+    XTestFakeKeyEvent( display, keyCode, status == KeyStatus::Down, 0 );
+    XFlush( display );
+}
@@ -1,6 +1,34 @@
 #include "input_sender.h"
 
-void sendTokensAsInput( [[maybe_unused]] const std::vector<Token> tokens )
+void initOsSystems()
+{
+    // dummy
+}
+
+void shutdownOsSystems()
+{
+    // dummy
+}
+
+void sendKeyPress( [[maybe_unused]] const Token token,
+                   [[maybe_unused]] const KeyStatus status )
+{
+    // dummy
+}
+
+uint32_t resolveKeyCode( const Token token )
+{
+    // Any non zero code, so macros still compile like on other platforms.
+    return static_cast<uint32_t>( token ) + 1;
+}
+
+void sendMacro( [[maybe_unused]] const keyboard_macro::Macro& macro )
+{
+    // dummy
+}
+
+void sendMacroKey( [[maybe_unused]] const uint32_t keyCode,
+                   [[maybe_unused]] const KeyStatus status )
 {
     // dummy
 }
@@ -0,0 +1,34 @@
+#include "input_sender.h"
+#include "uinput_sender.h"
+
+// Linux builds without X11 send everything through uinput.
+
+void initOsSystems()
+{
+    // Nothing to grab, the device is created on first use.
+}
+
+void shutdownOsSystems()
+{
+    // The device stays until exit.
+}
+
+void sendKeyPress( const Token token, const KeyStatus status )
+{
+    uinput_sender::sendKeyPress( token, status );
+}
+
+uint32_t resolveKeyCode( const Token token )
+{
+    return uinput_sender::resolveKeyCode( token );
+}
+
+void sendMacro( const keyboard_macro::Macro& macro )
+{
+    uinput_sender::sendMacro( macro );
+}
+
+void sendMacroKey( const uint32_t keyCode, const KeyStatus status )
+{
+    uinput_sender::sendMacroKey( keyCode, status );
+}
@@ -1,4 +1,9 @@
 #include "input_sender.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <Windows.h>
 #include <cctype>
@@ -194,9 +199,137 @@ void sendKeyboardInputRaw( std::vector<INPUT> inputs )
     }
 }
 
+namespace
+{
+/*!
+Sends macros from a thread of its own, in the order they were sent, so their
+delays don't stall the caller and two macros never interleave. Everything
+between two delays goes out with one SendInput() call. The destructor stops
+the thread, macros that weren't sent by then are dropped.
+*/
+class MacroSender
+{
+public:
+    MacroSender() : m_thread( &MacroSender::run, this ) {}
+
+    ~MacroSender()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    MacroSender( const MacroSender& ) = delete;
+    MacroSender& operator=( const MacroSender& ) = delete;
+
+    void send( std::vector<keyboard_macro::MacroOp> ops )
+    {
+        if ( ops.empty() )
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_queue.push_back( std::move( ops ) );
+        }
+        m_wake.notify_all();
+    }
+
+private:
+    void run()
+    {
+        while ( true )
+        {
+            std::vector<keyboard_macro::MacroOp> ops;
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_wake.wait(
+                    lock, [this] { return m_stopping || !m_queue.empty(); } );
+                if ( m_stopping )
+                {
+                    return;
+                }
+                ops = std::move( m_queue.front() );
+                m_queue.pop_front();
+            }
+            if ( !write( ops ) )
+            {
+                return;
+            }
+        }
+    }
+
+    // False if it stopped early.
+    bool write( const std::vector<keyboard_macro::MacroOp>& ops )
+    {
+        std::vector<INPUT> inputs;
+        for ( const auto& op : ops )
+        {
+            if ( op.delayMs > 0 )
+            {
+                sendKeyboardInputRaw( inputs );
+                inputs.clear();
+                if ( !waitFor( std::chrono::milliseconds( op.delayMs ) ) )
+                {
+                    return false;
+                }
+            }
+            if ( op.keyCode != 0 )
+            {
+                const auto status = op.down ? KeyStatus::Down : KeyStatus::Up;
+                inputs.push_back( createInputStruct(
+                    static_cast<WORD>( op.keyCode ), status ) );
+            }
+        }
+        sendKeyboardInputRaw( inputs );
+        return true;
+    }
+
+    // False if the sender is stopping.
+    bool waitFor( const std::chrono::milliseconds delay )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        return !m_wake.wait_for( lock, delay, [this] { return m_stopping; } );
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::vector<keyboard_macro::MacroOp>> m_queue;
+    bool m_stopping = false;
+    // Last, so it starts after everything it uses.
+    std::thread m_thread;
+};
+
+MacroSender& sender()
+{
+    static MacroSender keyboard;
+    return keyboard;
+}
+} // namespace
+
 void sendKeyPress( const Token token, const KeyStatus status )
 {
-    std::vector<INPUT> v
-        = { createInputStruct( convertToVirtualKeycode( token ), status ) };
-    sendKeyboardInputRaw( v );
+    sendMacroKey( convertToVirtualKeycode( token ), status );
+}
+
+uint32_t resolveKeyCode( const Token token )
+{
+    return convertToVirtualKeycode( token );
+}
+
+void sendMacro( const keyboard_macro::Macro& macro )
+{
+    sender().send( macro.ops );
+}
+
+void sendMacroKey( const uint32_t keyCode, const KeyStatus status )
+{
+    if ( keyCode != 0 )
+    {
+        sender().send( { keyboard_macro::MacroOp{
+            keyCode, status == KeyStatus::Down, 0 } } );
+    }
 }
@@ -0,0 +1,256 @@
+#include "keyboard_macro.h"
+#include <algorithm>
+#include <cctype>
+
+namespace keyboard_macro
+{
+namespace
+{
+    // Turns tokens into key events the same way sendTokensAsInput() sends
+    // them.
+    class MacroBuilder
+    {
+    public:
+        explicit MacroBuilder( const KeyCodeResolver resolve )
+            : m_resolve( resolve )
+        {
+        }
+
+        void feed( const Token* tokens, const std::size_t count )
+        {
+            for ( std::size_t i = 0; i < count; ++i )
+            {
+                const auto token = tokens[i];
+                // maintained for support w/o altering other binds/parsers
+                if ( token == Token::TOKEN_NO_KEYUP_NEXT )
+                {
+                    continue;
+                }
+                if ( token == Token::TOKEN_NEW_SEQUENCE )
+                {
+                    releaseHeld();
+                    m_sequenceStart = m_macro.ops.size();
+                    continue;
+                }
+                if ( !isModifier( token ) && !isLiteral( token ) )
+                {
+                    continue;
+                }
+
+                const auto keyCode = m_resolve( token );
+                if ( keyCode == 0 )
+                {
+                    LOG( WARNING ) << "No key code for keyboard token "
+                                   << static_cast<int>( token );
+                    continue;
+                }
+                if ( m_macro.firstKeyCode == 0 )
+                {
+                    m_macro.firstKeyCode = keyCode;
+                }
+                add( keyCode, true );
+                // Modifiers are held until the sequence ends.
+                if ( isModifier( token ) )
+                {
+                    m_held.push_back( keyCode );
+                }
+                else
+                {
+                    add( keyCode, false );
+                }
+            }
+        }
+
+        void wait( const uint32_t delayMs )
+        {
+            m_delayMs += delayMs;
+        }
+
+        void repeat( const uint32_t count )
+        {
+            releaseHeld();
+            flushDelay();
+            const auto end = m_macro.ops.size();
+            const auto length = end - m_sequenceStart;
+            for ( uint32_t i = 1; i < count && length > 0; ++i )
+            {
+                if ( m_macro.ops.size() + length > k_maxOps )
+                {
+                    LOG( WARNING ) << "Keyboard macro repeat cut short after "
+                                   << i << " of " << count << " times.";
+                    break;
+                }
+                for ( auto op = m_sequenceStart; op < end; ++op )
+                {
+                    m_macro.ops.push_back( m_macro.ops[op] );
+                }
+            }
+            m_sequenceStart = m_macro.ops.size();
+        }
+
+        void fail( const std::size_t position, const std::string& message )
+        {
+            if ( !m_macro.error.has_value() )
+            {
+                m_macro.error = MacroError{ position, message };
+            }
+        }
+
+        Macro finish()
+        {
+            releaseHeld();
+            // A delay at the end has nothing left to delay.
+            return std::move( m_macro );
+        }
+
+    private:
+        void add( const uint32_t keyCode, const bool down )
+        {
+            m_macro.ops.push_back( MacroOp{ keyCode, down, m_delayMs } );
+            m_delayMs = 0;
+        }
+
+        void flushDelay()
+        {
+            if ( m_delayMs > 0 )
+            {
+                add( 0, false );
+            }
+        }
+
+        void releaseHeld()
+        {
+            for ( const auto keyCode : m_held )
+            {
+                add( keyCode, false );
+            }
+            m_held.clear();
+        }
+
+        KeyCodeResolver m_resolve;
+        Macro m_macro;
+        std::vector<uint32_t> m_held;
+        std::size_t m_sequenceStart = 0;
+        uint32_t m_delayMs = 0;
+    };
+
+    bool parseCount( const std::string& digits,
+                     const uint32_t min,
+                     const uint32_t max,
+                     uint32_t& value )
+    {
+        if ( digits.empty() || digits.size() > 5
+             || !std::all_of( digits.begin(), digits.end(), []( char c ) {
+                    return std::isdigit( static_cast<unsigned char>( c ) );
+                } ) )
+        {
+            return false;
+        }
+        value = static_cast<uint32_t>( std::stoul( digits ) );
+        return value >= min && value <= max;
+    }
+} // namespace
+
+bool Macro::hasDelays() const noexcept
+{
+    return std::any_of( ops.begin(), ops.end(), []( const MacroOp& op ) {
+        return op.delayMs > 0;
+    } );
+}
+
+Macro compileMacro( const std::string& text, const KeyCodeResolver resolve )
+{
+    MacroBuilder builder( resolve );
+    std::vector<Token> tokens( lexBufferSize( text.size() ) );
+    std::size_t keysStart = 0;
+    // Returns false if lexing stopped at an error.
+    const auto feedKeys = [&]( const std::size_t keysEnd ) {
+        const auto result
+            = lexKeyboardInputs( std::string_view( text ).substr(
+                                     keysStart, keysEnd - keysStart ),
+                                 tokens.data(),
+                                 tokens.size() );
+        builder.feed( tokens.data(), result.count );
+        if ( !result.ok() )
+        {
+            builder.fail( keysStart + result.errorPosition,
+                          lexErrorMessage( result.error ) );
+        }
+        return result.ok() || result.error == LexError::UnknownCharacter;
+    };
+    const auto finish = [&builder, &text]() {
+        auto macro = builder.finish();
+        if ( macro.error.has_value() )
+        {
+            LOG( INFO ) << macro.error->message
+                        << " in keyboard macro at position "
+                        << macro.error->position << ": " << text;
+        }
+        return macro;
+    };
+
+    for ( std::size_t i = 0; i < text.size(); ++i )
+    {
+        const auto c = text[i];
+        if ( c != '[' && c != '{' )
+        {
+            continue;
+        }
+
+        if ( !feedKeys( i ) )
+        {
+            return finish();
+        }
+        const auto close = text.find( c == '[' ? ']' : '}', i );
+        uint32_t value = 0;
+        const auto valid
+            = close != std::string::npos
+              && ( c == '['
+                       ? parseCount( text.substr( i + 1, close - i - 1 ),
+                                     0,
+                                     k_maxDelayMs,
+                                     value )
+                       : parseCount( text.substr( i + 1, close - i - 1 ),
+                                     1,
+                                     k_maxRepeat,
+                                     value ) );
+        if ( !valid )
+        {
+            // Spec says to abort on errors and submit correct values before
+            // error.
+            builder.fail( i,
+                          c == '[' ? "Malformed delay" : "Malformed repeat" );
+            return finish();
+        }
+
+        if ( c == '[' )
+        {
+            builder.wait( value );
+        }
+        else
+        {
+            builder.repeat( value );
+        }
+        i = close;
+        keysStart = close + 1;
+    }
+    feedKeys( text.size() );
+    return finish();
+}
+
+MacroCache::MacroCache( const KeyCodeResolver resolve ) : m_resolve( resolve )
+{
+}
+
+const Macro& MacroCache::get( const std::string& text )
+{
+    if ( !m_compiled || text != m_text )
+    {
+        m_macro = compileMacro( text, m_resolve );
+        m_text = text;
+        m_compiled = true;
+    }
+    return m_macro;
+}
+
+} // namespace keyboard_macro
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "input_parser.h"
+
+/* Keyboard shortcuts compiled into the key events they send.
+ *
+ * On top of the input_parser syntax a macro can contain
+ *
+ *     [<ms>]  waits ms milliseconds before the next key event (up to 10000),
+ *     {<n>}   repeats the sequence before it, n times in total (1 to 100).
+ *             The sequence is everything since the last space, {n} or the
+ *             start of the macro.
+ *
+ * e.g. "^c [100] ^v" or "BACKSPACE{8}".
+ */
+namespace keyboard_macro
+{
+constexpr uint32_t k_maxDelayMs = 10000;
+constexpr uint32_t k_maxRepeat = 100;
+// Repeats stop growing the macro past this.
+constexpr std::size_t k_maxOps = 4096;
+
+struct MacroOp
+{
+    // Platform key code, 0 for an op that only waits.
+    uint32_t keyCode = 0;
+    bool down = false;
+    // Waited before the key event.
+    uint32_t delayMs = 0;
+
+    bool operator==( const MacroOp& other ) const noexcept
+    {
+        return keyCode == other.keyCode && down == other.down
+               && delayMs == other.delayMs;
+    }
+};
+
+struct MacroError
+{
+    // Offset into the macro's text.
+    std::size_t position = 0;
+    std::string message;
+};
+
+struct Macro
+{
+    std::vector<MacroOp> ops;
+    // Key code of the first key in the macro, 0 if there is none. Used by
+    // the key press bindings that hold a single key.
+    uint32_t firstKeyCode = 0;
+    // The first error in the text. The macro still sends the keys before
+    // it, and the keys around unknown characters.
+    std::optional<MacroError> error;
+
+    [[nodiscard]] bool hasDelays() const noexcept;
+};
+
+// Maps a token to the platform key code, 0 if the platform has none.
+using KeyCodeResolver = uint32_t ( * )( const Token token );
+
+/*!
+Lexes text and resolves every key code once. Unknown characters are
+skipped like sendStringAsInput() does. A malformed [] or {} ends the macro,
+like other lex errors.
+*/
+Macro compileMacro( const std::string& text, const KeyCodeResolver resolve );
+
+/*!
+Keeps the compiled macro for a setting's text, it is only compiled again
+when the text changes.
+*/
+class MacroCache
+{
+public:
+    explicit MacroCache( const KeyCodeResolver resolve );
+
+    const Macro& get( const std::string& text );
+
+private:
+    KeyCodeResolver m_resolve;
+    bool m_compiled = false;
+    std::string m_text;
+    Macro m_macro;
+};
+
+} // namespace keyboard_macro
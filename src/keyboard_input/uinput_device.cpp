@@ -0,0 +1,181 @@
+#include "uinput_device.h"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/uinput.h>
+#include <easylogging++.h>
+
+namespace uinput
+{
+namespace
+{
+    constexpr std::array<uint16_t, 26> k_letterKeys = {
+        KEY_A, KEY_B, KEY_C, KEY_D, KEY_E, KEY_F, KEY_G, KEY_H, KEY_I,
+        KEY_J, KEY_K, KEY_L, KEY_M, KEY_N, KEY_O, KEY_P, KEY_Q, KEY_R,
+        KEY_S, KEY_T, KEY_U, KEY_V, KEY_W, KEY_X, KEY_Y, KEY_Z,
+    };
+
+    constexpr std::array<uint16_t, 10> k_digitKeys = {
+        KEY_0, KEY_1, KEY_2, KEY_3, KEY_4,
+        KEY_5, KEY_6, KEY_7, KEY_8, KEY_9,
+    };
+
+    constexpr std::array<uint16_t, 19> k_functionKeys = {
+        KEY_F1,  KEY_F2,  KEY_F3,  KEY_F4,  KEY_F5,  KEY_F6,  KEY_F7,
+        KEY_F8,  KEY_F9,  KEY_F10, KEY_F11, KEY_F12, KEY_F13, KEY_F14,
+        KEY_F15, KEY_F16, KEY_F17, KEY_F18, KEY_F19,
+    };
+
+    constexpr std::array<uint16_t, 23> k_namedKeys = {
+        KEY_BACKSPACE,  KEY_SPACE,      KEY_TAB,        KEY_ESC,
+        KEY_INSERT,     KEY_DELETE,     KEY_END,        KEY_PAGEDOWN,
+        KEY_PAGEUP,     KEY_CAPSLOCK,   KEY_SYSRQ,      KEY_PAUSE,
+        KEY_SCROLLLOCK, KEY_LEFT,       KEY_RIGHT,      KEY_UP,
+        KEY_DOWN,       KEY_KPSLASH,    KEY_KPASTERISK, KEY_KPMINUS,
+        KEY_KPPLUS,     KEY_ENTER,      KEY_BACKSLASH,
+    };
+
+    constexpr std::array<uint16_t, 6> k_modifierKeys = {
+        KEY_LEFTCTRL,   KEY_LEFTALT,  KEY_LEFTSHIFT,
+        KEY_RIGHTSHIFT, KEY_LEFTMETA, KEY_GRAVE,
+    };
+
+    template <std::size_t size>
+    uint16_t keyAt( const std::array<uint16_t, size>& keys,
+                    const std::size_t index ) noexcept
+    {
+        return index < keys.size() ? keys[index] : 0;
+    }
+
+    bool enableKeys( const int fd )
+    {
+        if ( ioctl( fd, UI_SET_EVBIT, EV_KEY ) < 0
+             || ioctl( fd, UI_SET_EVBIT, EV_SYN ) < 0 )
+        {
+            return false;
+        }
+        const auto enable = [fd]( const auto& keys ) {
+            for ( const auto key : keys )
+            {
+                if ( ioctl( fd, UI_SET_KEYBIT, key ) < 0 )
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+        return enable( k_letterKeys ) && enable( k_digitKeys )
+               && enable( k_functionKeys ) && enable( k_namedKeys )
+               && enable( k_modifierKeys );
+    }
+
+    input_event makeEvent( const uint16_t type,
+                           const uint16_t code,
+                           const int32_t value )
+    {
+        input_event event{};
+        event.type = type;
+        event.code = code;
+        event.value = value;
+        return event;
+    }
+} // namespace
+
+uint16_t letterKey( const std::size_t index ) noexcept
+{
+    return keyAt( k_letterKeys, index );
+}
+
+uint16_t digitKey( const std::size_t index ) noexcept
+{
+    return keyAt( k_digitKeys, index );
+}
+
+uint16_t functionKey( const std::size_t index ) noexcept
+{
+    return keyAt( k_functionKeys, index );
+}
+
+uint16_t namedKey( const std::size_t index ) noexcept
+{
+    return keyAt( k_namedKeys, index );
+}
+
+uint16_t modifierKey( const std::size_t index ) noexcept
+{
+    return keyAt( k_modifierKeys, index );
+}
+
+std::unique_ptr<Device> Device::create( const char* path )
+{
+    const auto fd = open( path, O_WRONLY | O_NONBLOCK | O_CLOEXEC );
+    if ( fd < 0 )
+    {
+        LOG( WARNING ) << "Could not open " << path << ": "
+                       << std::strerror( errno )
+                       << ". Keyboard input through uinput needs write "
+                          "access to it.";
+        return nullptr;
+    }
+    auto device = std::make_unique<Device>( fd );
+
+    uinput_setup setup{};
+    setup.id.bustype = BUS_VIRTUAL;
+    std::strncpy( setup.name,
+                  "OpenVR Advanced Settings Keyboard",
+                  UINPUT_MAX_NAME_SIZE - 1 );
+    if ( !enableKeys( fd ) || ioctl( fd, UI_DEV_SETUP, &setup ) < 0
+         || ioctl( fd, UI_DEV_CREATE ) < 0 )
+    {
+        LOG( WARNING ) << "Could not create the uinput keyboard: "
+                       << std::strerror( errno );
+        return nullptr;
+    }
+    device->m_created = true;
+    LOG( INFO ) << "Created uinput keyboard through " << path;
+    return device;
+}
+
+Device::Device( const int fd ) noexcept : m_fd( fd )
+{
+}
+
+Device::~Device()
+{
+    if ( m_created )
+    {
+        ioctl( m_fd, UI_DEV_DESTROY );
+    }
+    close( m_fd );
+}
+
+bool Device::write( const std::vector<KeyEvent>& events )
+{
+    if ( events.empty() )
+    {
+        return true;
+    }
+
+    std::vector<input_event> raw;
+    raw.reserve( events.size() * 2 );
+    for ( const auto& event : events )
+    {
+        raw.push_back( makeEvent( EV_KEY, event.code, event.down ? 1 : 0 ) );
+        raw.push_back( makeEvent( EV_SYN, SYN_REPORT, 0 ) );
+    }
+
+    const auto size = raw.size() * sizeof( input_event );
+    const auto written = ::write( m_fd, raw.data(), size );
+    if ( written < 0 || static_cast<std::size_t>( written ) != size )
+    {
+        LOG( ERROR ) << "Could not write " << events.size()
+                     << " key events to uinput: " << std::strerror( errno );
+        return false;
+    }
+    return true;
+}
+
+} // namespace uinput
@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/* A virtual keyboard created through /dev/uinput.
+ *
+ * The kernel feeds its events to everything reading evdev devices, so unlike
+ * XTest it also works on Wayland and without any display server.
+ *
+ * Nothing here includes the linux input headers or input_parser.h, their
+ * KEY_* macros and Token names clash.
+ */
+namespace uinput
+{
+struct KeyEvent
+{
+    // evdev key code.
+    uint16_t code = 0;
+    bool down = false;
+};
+
+// Desktops take a moment to pick up a new device, events written before that
+// are lost. Device::create() doesn't wait for it.
+constexpr auto k_deviceSettleTime = std::chrono::milliseconds( 200 );
+
+// evdev key codes for the Token ranges, 0 for an index past the range.
+// a to z.
+uint16_t letterKey( const std::size_t index ) noexcept;
+// 0 to 9.
+uint16_t digitKey( const std::size_t index ) noexcept;
+// F1 to F19.
+uint16_t functionKey( const std::size_t index ) noexcept;
+// BACKSPACE to BACKSLASH, in Token order.
+uint16_t namedKey( const std::size_t index ) noexcept;
+// CTRL, ALT, SHIFT, RSHIFT, SUPER and TILDE, in Token order.
+uint16_t modifierKey( const std::size_t index ) noexcept;
+
+class Device
+{
+public:
+    /*!
+    Opens path and creates a keyboard that can send every key above. Returns
+    nullptr if the device can't be opened or created, usually because the
+    user has no write access to /dev/uinput.
+    */
+    static std::unique_ptr<Device> create( const char* path = "/dev/uinput" );
+
+    // Writes into an already open fd without creating a device, e.g. into a
+    // pipe standing in for uinput. Takes ownership of fd.
+    explicit Device( const int fd ) noexcept;
+    ~Device();
+
+    Device( const Device& ) = delete;
+    Device& operator=( const Device& ) = delete;
+
+    /*!
+    Writes all events with a single write(). Every key event is followed by
+    a SYN_REPORT, so readers see each one as its own report.
+    */
+    bool write( const std::vector<KeyEvent>& events );
+
+private:
+    int m_fd;
+    bool m_created = false;
+};
+
+} // namespace uinput
@@ -0,0 +1,186 @@
+#include "uinput_sender.h"
+
+namespace uinput_sender
+{
+namespace
+{
+    MacroSender& sender()
+    {
+        static MacroSender keyboard( uinput::Device::create(),
+                                     uinput::k_deviceSettleTime );
+        return keyboard;
+    }
+
+    std::size_t offset( const Token token, const Token first ) noexcept
+    {
+        return static_cast<std::size_t>( static_cast<int>( token )
+                                          - static_cast<int>( first ) );
+    }
+
+    bool inRange( const Token token,
+                  const Token first,
+                  const Token last ) noexcept
+    {
+        return static_cast<int>( token ) >= static_cast<int>( first )
+               && static_cast<int>( token ) <= static_cast<int>( last );
+    }
+} // namespace
+
+MacroSender::MacroSender( std::unique_ptr<uinput::Device> device,
+                          const std::chrono::milliseconds settleTime )
+    : m_device( std::move( device ) )
+{
+    if ( m_device )
+    {
+        m_thread = std::thread( &MacroSender::run, this, settleTime );
+    }
+}
+
+MacroSender::~MacroSender()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    if ( m_thread.joinable() )
+    {
+        m_thread.join();
+    }
+}
+
+bool MacroSender::available() const noexcept
+{
+    return m_device != nullptr;
+}
+
+void MacroSender::send( std::vector<keyboard_macro::MacroOp> ops )
+{
+    if ( !m_device || ops.empty() )
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_queue.push_back( std::move( ops ) );
+    }
+    m_wake.notify_all();
+}
+
+void MacroSender::run( const std::chrono::milliseconds settleTime )
+{
+    if ( !waitFor( settleTime ) )
+    {
+        return;
+    }
+    while ( true )
+    {
+        std::vector<keyboard_macro::MacroOp> ops;
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_wake.wait( lock,
+                         [this] { return m_stopping || !m_queue.empty(); } );
+            if ( m_stopping )
+            {
+                return;
+            }
+            ops = std::move( m_queue.front() );
+            m_queue.pop_front();
+        }
+        if ( !write( ops ) )
+        {
+            return;
+        }
+    }
+}
+
+bool MacroSender::write( const std::vector<keyboard_macro::MacroOp>& ops )
+{
+    std::vector<uinput::KeyEvent> events;
+    for ( const auto& op : ops )
+    {
+        if ( op.delayMs > 0 )
+        {
+            m_device->write( events );
+            events.clear();
+            if ( !waitFor( std::chrono::milliseconds( op.delayMs ) ) )
+            {
+                return false;
+            }
+        }
+        if ( op.keyCode != 0 )
+        {
+            events.push_back( uinput::KeyEvent{
+                static_cast<uint16_t>( op.keyCode ), op.down } );
+        }
+    }
+    m_device->write( events );
+    return true;
+}
+
+bool MacroSender::waitFor( const std::chrono::milliseconds delay )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    return !m_wake.wait_for( lock, delay, [this] { return m_stopping; } );
+}
+
+bool available()
+{
+    return sender().available();
+}
+
+uint16_t tokenToKeyCode( const Token token ) noexcept
+{
+    if ( inRange( token, Token::KEY_a, Token::KEY_z ) )
+    {
+        return uinput::letterKey( offset( token, Token::KEY_a ) );
+    }
+    if ( inRange( token, Token::KEY_0, Token::KEY_9 ) )
+    {
+        return uinput::digitKey( offset( token, Token::KEY_0 ) );
+    }
+    if ( inRange( token, Token::KEY_F1, Token::KEY_F19 ) )
+    {
+        return uinput::functionKey( offset( token, Token::KEY_F1 ) );
+    }
+    if ( inRange( token, Token::KEY_BACKSPACE, Token::KEY_BACKSLASH ) )
+    {
+        return uinput::namedKey( offset( token, Token::KEY_BACKSPACE ) );
+    }
+    if ( inRange( token, Token::MODIFIER_CTRL, Token::MODIFIER_TILDE ) )
+    {
+        return uinput::modifierKey( offset( token, Token::MODIFIER_CTRL ) );
+    }
+    return 0;
+}
+
+void sendKeyPress( const Token token, const KeyStatus status )
+{
+    const auto code = tokenToKeyCode( token );
+    if ( code != 0 )
+    {
+        sender().send( { keyboard_macro::MacroOp{
+            code, status == KeyStatus::Down, 0 } } );
+    }
+}
+
+uint32_t resolveKeyCode( const Token token )
+{
+    return tokenToKeyCode( token );
+}
+
+void sendMacro( const keyboard_macro::Macro& macro )
+{
+    sender().send( macro.ops );
+}
+
+void sendMacroKey( const uint32_t keyCode, const KeyStatus status )
+{
+    if ( keyCode != 0 )
+    {
+        sender().send( { keyboard_macro::MacroOp{
+            keyCode, status == KeyStatus::Down, 0 } } );
+    }
+}
+
+} // namespace uinput_sender
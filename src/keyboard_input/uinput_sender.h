@@ -0,0 +1,64 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "input_sender.h"
+#include "uinput_device.h"
+
+/* The input_sender.h functions on top of a uinput::Device. Used by
+ * input_sender_X11.cpp when there is no X display or the session is Wayland,
+ * and by input_sender_uinput.cpp in builds without X11.
+ */
+namespace uinput_sender
+{
+/*!
+Writes macros to a uinput::Device from a thread of its own, in the order
+they were sent, so neither their delays nor the time a new device needs to
+settle stall the caller. The destructor stops the thread before the device
+goes away, macros that weren't written by then are dropped.
+*/
+class MacroSender
+{
+public:
+    MacroSender( std::unique_ptr<uinput::Device> device,
+                 const std::chrono::milliseconds settleTime );
+    ~MacroSender();
+
+    MacroSender( const MacroSender& ) = delete;
+    MacroSender& operator=( const MacroSender& ) = delete;
+
+    // False if there is no device, send() does nothing then.
+    bool available() const noexcept;
+    void send( std::vector<keyboard_macro::MacroOp> ops );
+
+private:
+    void run( const std::chrono::milliseconds settleTime );
+    // Writes everything between two delays with one write(), false if it
+    // stopped early.
+    bool write( const std::vector<keyboard_macro::MacroOp>& ops );
+    // False if the sender is stopping.
+    bool waitFor( const std::chrono::milliseconds delay );
+
+    std::unique_ptr<uinput::Device> m_device;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<std::vector<keyboard_macro::MacroOp>> m_queue;
+    bool m_stopping = false;
+    std::thread m_thread;
+};
+
+// Creates the device the first time, false if that failed.
+bool available();
+
+uint16_t tokenToKeyCode( const Token token ) noexcept;
+
+void sendKeyPress( const Token token, const KeyStatus status );
+uint32_t resolveKeyCode( const Token token );
+void sendMacro( const keyboard_macro::Macro& macro );
+void sendMacroKey( const uint32_t keyCode, const KeyStatus status );
+
+} // namespace uinput_sender
@@ -1,6 +1,9 @@
 #include "utils/setup.h"
 #include "settings/settings.h"
 #include "openvr/ovr_settings_wrapper.h"
+#include "control_socket/control_commands.h"
+#include "control_socket/control_server.h"
+#include "utils/startup_profiler.h"
 #ifdef _WIN64
 #    include <windows.h>
 extern "C" __declspec( dllexport ) DWORD NvOptimusEnablement = 0x00000001;
@@ -12,11 +15,14 @@ INITIALIZE_EASYLOGGINGPP
 void BoundrySyncStop();
 int main( int argc, char* argv[] )
 {
+    // Startup times are measured from here.
+    utils::startupProfiler();
     setUpLogging();
     qputenv("QT_QUICK_CONTROLS_IGNORE_CUSTOMIZATION_WARNINGS", "1");
     QLoggingCategory::setFilterRules("qt.qml.connections=false");
-    LOG( INFO ) << "Settings File: "
-                << settings::initializeAndGetSettingsPath();
+    const auto settingsPath = utils::timedPhase(
+        "settings", [] { return settings::initializeAndGetSettingsPath(); } );
+    LOG( INFO ) << "Settings File: " << settingsPath;
 
     LOG( INFO ) << settings::getSettingsAndValues();
 
@@ -47,16 +53,38 @@ int main( int argc, char* argv[] )
                                    commandLineArgs.forceRemoveManifest );
     }
 
-    openvr_init::initializeOpenVR(
-        openvr_init::OpenVrInitializationType::Overlay );
+    // Scripting client, talks to an already running instance.
+    if ( !commandLineArgs.sendCommand.empty() )
+    {
+        const auto reply = control_socket::sendCommand(
+            control_socket::defaultSocketPath(),
+            commandLineArgs.sendCommand,
+            std::chrono::seconds( 5 ) );
+        if ( !reply )
+        {
+            std::cerr << "No reply from the control socket.\n";
+            return ReturnErrorCode::GENERAL_FAILURE;
+        }
+        std::cout << *reply << '\n';
+        return ReturnErrorCode::SUCCESS;
+    }
+
+    utils::timedPhase( "openvr init", [] {
+        openvr_init::initializeOpenVR(
+            openvr_init::OpenVrInitializationType::Overlay );
+    } );
 
     try
     {
         QQmlEngine qmlEngine;
 
+        std::optional<utils::StartupProfiler::Phase> controllerPhase;
+        controllerPhase.emplace( utils::startupProfiler(),
+                                 "overlay controller" );
         advsettings::OverlayController controller( commandLineArgs.desktopMode,
                                                    commandLineArgs.forceNoSound,
                                                    qmlEngine );
+        controllerPhase.reset();
 
         constexpr auto widgetPath = "res/qml/common/mainwidget.qml";
         const auto path = paths::binaryDirectoryFindFile( widgetPath );
@@ -71,17 +99,28 @@ int main( int argc, char* argv[] )
         const auto url
             = QUrl::fromLocalFile( QString::fromStdString( ( *path ) ) );
 
-        QQmlComponent component( &qmlEngine, url );
+        QQmlComponent component( &qmlEngine );
+        utils::timedPhase( "qml load",
+                           [&component, &url] { component.loadUrl( url ); } );
         auto errors = component.errors();
         for ( auto& e : errors )
         {
             LOG( ERROR ) << "QML Error: " << e.toString().toStdString()
                          << std::endl;
         }
-        auto quickObj = component.create();
-        controller.SetWidget( qobject_cast<QQuickItem*>( quickObj ),
-                              application_strings::applicationDisplayName,
-                              application_strings::applicationKey );
+        auto quickObj = utils::timedPhase(
+            "qml create", [&component] { return component.create(); } );
+        utils::timedPhase( "set widget", [&controller, quickObj] {
+            controller.SetWidget( qobject_cast<QQuickItem*>( quickObj ),
+                                  application_strings::applicationDisplayName,
+                                  application_strings::applicationKey );
+        } );
+
+        if ( commandLineArgs.controlSocket )
+        {
+            controller.startControlServer(
+                control_socket::defaultSocketPath() );
+        }
 
         // Attempts to install the application manifest on all "regular" starts.
         if ( !commandLineArgs.forceNoManifest )
@@ -2,6 +2,9 @@
 #include <easylogging++.h>
 #include <vector>
 #include <QString>
+#include "now_playing.h"
+
+class QObject;
 
 namespace keyboardinput
 {
@@ -15,4 +18,12 @@ void sendMediaPreviousSong();
 void sendMediaPausePlay();
 void sendMediaStopSong();
 
+// What the player the media keys control is on, empty if nothing is known.
+NowPlaying nowPlaying();
+/*!
+Connects slot on receiver to be called whenever nowPlaying() changes.
+Returns false on platforms that can't tell what is playing.
+*/
+bool connectNowPlaying( QObject* receiver, const char* slot );
+
 } // namespace keyboardinput
@@ -1,59 +1,73 @@
 #include "media_keys.h"
 #include <QtCore/QCoreApplication>
-#include <QtCore/QDebug>
-#include <QtCore/QStringList>
 #include <QtDBus/QtDBus>
+#include "mpris_registry.h"
 
 namespace keyboardinput
 {
-void callMethodForAllMediaPlayerAvailableServices( const QString& method )
+namespace
 {
-    if ( !QDBusConnection::sessionBus().isConnected() )
+    // Created on the first media key and kept until the application quits.
+    mpris::PlayerRegistry* mediaPlayers()
     {
-        LOG( ERROR ) << "Media Keys: Unable to connect to DBUS session bus.";
-        return;
+        static const auto players = []() -> mpris::PlayerRegistry* {
+            if ( !QDBusConnection::sessionBus().isConnected() )
+            {
+                LOG( ERROR )
+                    << "Media Keys: Unable to connect to DBUS session bus.";
+                return nullptr;
+            }
+            return new mpris::PlayerRegistry(
+                QDBusConnection::sessionBus(),
+                QCoreApplication::instance() );
+        }();
+        return players;
     }
+} // namespace
 
-    QDBusReply<QStringList> names
-        = QDBusConnection::sessionBus().interface()->registeredServiceNames();
-    if ( !names.isValid() )
-    {
-        LOG( ERROR )
-            << "Media Keys: Error getting DBUS registered service names:";
-        LOG( ERROR ) << names.error().message();
-    }
-
-    foreach ( QString name, names.value() )
+void callMediaPlayers( const QString& method )
+{
+    if ( const auto players = mediaPlayers() )
     {
-        if ( name.contains( "org.mpris.MediaPlayer2" ) )
-        {
-            QDBusInterface iface( name,
-                                  "/org/mpris/MediaPlayer2",
-                                  "org.mpris.MediaPlayer2.Player",
-                                  QDBusConnection::sessionBus() );
-            iface.call( method );
-        }
+        players->call( method );
     }
 }
 
 void sendMediaNextSong()
 {
-    callMethodForAllMediaPlayerAvailableServices( "Next" );
+    callMediaPlayers( "Next" );
 }
 
 void sendMediaPreviousSong()
 {
-    callMethodForAllMediaPlayerAvailableServices( "Previous" );
+    callMediaPlayers( "Previous" );
 }
 
 void sendMediaPausePlay()
 {
-    callMethodForAllMediaPlayerAvailableServices( "PlayPause" );
+    callMediaPlayers( "PlayPause" );
 }
 
 void sendMediaStopSong()
 {
-    callMethodForAllMediaPlayerAvailableServices( "Stop" );
+    callMediaPlayers( "Stop" );
+}
+
+NowPlaying nowPlaying()
+{
+    if ( const auto players = mediaPlayers() )
+    {
+        return players->nowPlaying();
+    }
+    return {};
+}
+
+bool connectNowPlaying( QObject* receiver, const char* slot )
+{
+    const auto players = mediaPlayers();
+    return players != nullptr
+           && QObject::connect(
+               players, SIGNAL( nowPlayingChanged() ), receiver, slot );
 }
 
 } // namespace keyboardinput
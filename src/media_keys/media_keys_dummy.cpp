@@ -22,4 +22,15 @@ void sendMediaStopSong()
     // dummy
 }
 
+NowPlaying nowPlaying()
+{
+    return {};
+}
+
+bool connectNowPlaying( [[maybe_unused]] QObject* receiver,
+                        [[maybe_unused]] const char* slot )
+{
+    return false;
+}
+
 } // namespace keyboardinput
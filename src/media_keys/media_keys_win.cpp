@@ -91,4 +91,16 @@ void sendMediaStopSong()
     sendKeyboardInputRaw( inputs ); // noop
 }
 
+// Windows would need the WinRT media session API, which isn't used yet.
+NowPlaying nowPlaying()
+{
+    return {};
+}
+
+bool connectNowPlaying( [[maybe_unused]] QObject* receiver,
+                        [[maybe_unused]] const char* slot )
+{
+    return false;
+}
+
 } // namespace keyboardinput
@@ -0,0 +1,412 @@
+#include "mpris_registry.h"
+#include <utility>
+#include <QtDBus/QDBusArgument>
+#include <QtDBus/QDBusPendingCallWatcher>
+#include <QtDBus/QDBusPendingReply>
+#include <QtDBus/QDBusVariant>
+#include <easylogging++.h>
+
+namespace mpris
+{
+namespace
+{
+    constexpr auto k_busService = "org.freedesktop.DBus";
+    constexpr auto k_busPath = "/org/freedesktop/DBus";
+    constexpr auto k_busInterface = "org.freedesktop.DBus";
+    constexpr auto k_propertiesInterface = "org.freedesktop.DBus.Properties";
+    constexpr auto k_playbackStatus = "PlaybackStatus";
+    constexpr auto k_metadata = "Metadata";
+    constexpr auto k_rate = "Rate";
+    constexpr auto k_position = "Position";
+
+    bool isPlayer( const QString& name )
+    {
+        return name.startsWith( k_servicePrefix );
+    }
+
+    QDBusMessage busCall( const QString& method )
+    {
+        return QDBusMessage::createMethodCall(
+            k_busService, k_busPath, k_busInterface, method );
+    }
+
+    // Calls handler with the reply to message once it arrives, unless context
+    // is gone by then.
+    template <typename Reply, typename Handler>
+    void callAsync( QDBusConnection& connection,
+                    const QDBusMessage& message,
+                    QObject* context,
+                    Handler handler )
+    {
+        const auto watcher = new QDBusPendingCallWatcher(
+            connection.asyncCall( message, k_callTimeoutMs ), context );
+        QObject::connect( watcher,
+                          &QDBusPendingCallWatcher::finished,
+                          context,
+                          [handler]( QDBusPendingCallWatcher* finished ) {
+                              const Reply reply = *finished;
+                              if ( reply.isValid() )
+                              {
+                                  handler( reply.value() );
+                              }
+                              finished->deleteLater();
+                          } );
+    }
+} // namespace
+
+PlayerRegistry::PlayerRegistry( const QDBusConnection& connection,
+                                QObject* parent )
+    : QObject( parent ), m_connection( connection )
+{
+    // Subscribed before listing, so no player can slip in between.
+    m_connection.connect(
+        k_busService,
+        k_busPath,
+        k_busInterface,
+        "NameOwnerChanged",
+        this,
+        SLOT( onNameOwnerChanged( QString, QString, QString ) ) );
+    // An empty service matches the signal from every sender.
+    m_connection.connect( "",
+                          k_objectPath,
+                          k_propertiesInterface,
+                          "PropertiesChanged",
+                          this,
+                          SLOT( onPropertiesChanged( QDBusMessage ) ) );
+    m_connection.connect( "",
+                          k_objectPath,
+                          k_playerInterface,
+                          "Seeked",
+                          this,
+                          SLOT( onSeeked( QDBusMessage ) ) );
+
+    m_connection.callWithCallback( busCall( "ListNames" ),
+                                   this,
+                                   SLOT( onNames( QStringList ) ),
+                                   SLOT( onNamesError( QDBusError ) ),
+                                   k_callTimeoutMs );
+}
+
+void PlayerRegistry::call( const QString& method )
+{
+    if ( !m_ready )
+    {
+        m_pendingCalls.append( method );
+        return;
+    }
+
+    const auto active = activePlayer();
+    if ( !active.isEmpty() )
+    {
+        send( active, method );
+        return;
+    }
+    for ( auto player = m_players.cbegin(); player != m_players.cend();
+          ++player )
+    {
+        send( player.key(), method );
+    }
+}
+
+QStringList PlayerRegistry::players() const
+{
+    return m_players.keys();
+}
+
+QString PlayerRegistry::activePlayer() const
+{
+    QString active;
+    quint64 lastActive = 0;
+    for ( auto player = m_players.cbegin(); player != m_players.cend();
+          ++player )
+    {
+        if ( player->lastActive > lastActive )
+        {
+            active = player.key();
+            lastActive = player->lastActive;
+        }
+    }
+    return active;
+}
+
+bool PlayerRegistry::ready() const noexcept
+{
+    return m_ready;
+}
+
+keyboardinput::NowPlaying PlayerRegistry::nowPlaying() const
+{
+    const auto active = activePlayer();
+    if ( active.isEmpty() )
+    {
+        return {};
+    }
+    return m_players.value( active ).track;
+}
+
+void PlayerRegistry::onNames( const QStringList& names )
+{
+    for ( const auto& name : names )
+    {
+        if ( isPlayer( name ) && !m_players.contains( name ) )
+        {
+            addPlayer( name, "" );
+            queryOwner( name );
+        }
+    }
+    LOG( INFO ) << "Media Keys: Found " << m_players.size()
+                << " MPRIS players.";
+    sendPendingCalls();
+}
+
+void PlayerRegistry::onNamesError( const QDBusError& error )
+{
+    LOG( ERROR ) << "Media Keys: Error getting DBUS registered service names: "
+                 << error.message();
+    // Players still show up through NameOwnerChanged.
+    sendPendingCalls();
+}
+
+void PlayerRegistry::onNameOwnerChanged(
+    const QString& name,
+    [[maybe_unused]] const QString& oldOwner,
+    const QString& newOwner )
+{
+    if ( !isPlayer( name ) )
+    {
+        return;
+    }
+    if ( newOwner.isEmpty() )
+    {
+        const auto wasActive = activePlayer() == name;
+        if ( m_players.remove( name ) > 0 )
+        {
+            emit playersChanged();
+        }
+        if ( wasActive )
+        {
+            emit nowPlayingChanged();
+        }
+        return;
+    }
+    if ( m_players.contains( name ) )
+    {
+        // Restarted under the same name, with a new track if any.
+        m_players[name].owner = newOwner;
+        queryProperties( name );
+        return;
+    }
+    addPlayer( name, newOwner );
+}
+
+void PlayerRegistry::onPropertiesChanged( const QDBusMessage& message )
+{
+    const auto arguments = message.arguments();
+    if ( arguments.size() < 3 || arguments[0].toString() != k_playerInterface )
+    {
+        return;
+    }
+
+    const auto name = playerOwnedBy( message.service() );
+    if ( name.isEmpty() )
+    {
+        // From a player whose owner hasn't arrived yet, ask those players.
+        for ( auto player = m_players.cbegin(); player != m_players.cend();
+              ++player )
+        {
+            if ( player->owner.isEmpty() )
+            {
+                queryProperties( player.key() );
+            }
+        }
+        return;
+    }
+
+    setProperties( name, qdbus_cast<QVariantMap>( arguments[1] ) );
+    // Changed without the new value, players do that for expensive ones.
+    for ( const auto& property : arguments[2].toStringList() )
+    {
+        if ( property == k_playbackStatus || property == k_metadata
+             || property == k_rate )
+        {
+            queryProperty( name, property );
+        }
+    }
+}
+
+void PlayerRegistry::onSeeked( const QDBusMessage& message )
+{
+    if ( message.arguments().isEmpty() )
+    {
+        return;
+    }
+    const auto name = playerOwnedBy( message.service() );
+    if ( !name.isEmpty() )
+    {
+        setProperties( name, { { k_position, message.arguments()[0] } } );
+        return;
+    }
+    // As for PropertiesChanged, ask the players whose owner is unknown.
+    for ( auto player = m_players.cbegin(); player != m_players.cend();
+          ++player )
+    {
+        if ( player->owner.isEmpty() )
+        {
+            queryProperty( player.key(), k_position );
+        }
+    }
+}
+
+void PlayerRegistry::onCallFinished()
+{
+    // Players don't answer with anything worth reading.
+}
+
+void PlayerRegistry::onCallError( const QDBusError& error,
+                                  const QDBusMessage& call )
+{
+    LOG( WARNING ) << "Media Keys: " << call.member() << " failed: "
+                   << error.message();
+}
+
+void PlayerRegistry::sendPendingCalls()
+{
+    m_ready = true;
+    const auto pending = std::move( m_pendingCalls );
+    m_pendingCalls.clear();
+    for ( const auto& method : pending )
+    {
+        call( method );
+    }
+}
+
+void PlayerRegistry::addPlayer( const QString& name, const QString& owner )
+{
+    m_players.insert( name, Player{ owner, 0, {} } );
+    queryProperties( name );
+    emit playersChanged();
+}
+
+QString PlayerRegistry::playerOwnedBy( const QString& owner ) const
+{
+    for ( auto player = m_players.cbegin(); player != m_players.cend();
+          ++player )
+    {
+        if ( player->owner == owner )
+        {
+            return player.key();
+        }
+    }
+    return {};
+}
+
+void PlayerRegistry::queryOwner( const QString& name )
+{
+    auto message = busCall( "GetNameOwner" );
+    message << name;
+    callAsync<QDBusPendingReply<QString>>(
+        m_connection, message, this, [this, name]( const QString& owner ) {
+            if ( m_players.contains( name )
+                 && m_players[name].owner.isEmpty() )
+            {
+                m_players[name].owner = owner;
+            }
+        } );
+}
+
+void PlayerRegistry::queryProperties( const QString& name )
+{
+    auto message = QDBusMessage::createMethodCall(
+        name, k_objectPath, k_propertiesInterface, "GetAll" );
+    message << QString( k_playerInterface );
+    callAsync<QDBusPendingReply<QVariantMap>>(
+        m_connection,
+        message,
+        this,
+        [this, name]( const QVariantMap& properties ) {
+            setProperties( name, properties );
+        } );
+}
+
+void PlayerRegistry::queryProperty( const QString& name,
+                                    const QString& property )
+{
+    auto message = QDBusMessage::createMethodCall(
+        name, k_objectPath, k_propertiesInterface, "Get" );
+    message << QString( k_playerInterface ) << property;
+    callAsync<QDBusPendingReply<QDBusVariant>>(
+        m_connection,
+        message,
+        this,
+        [this, name, property]( const QDBusVariant& value ) {
+            setProperties( name, { { property, value.variant() } } );
+        } );
+}
+
+void PlayerRegistry::setProperties( const QString& name,
+                                    const QVariantMap& properties )
+{
+    if ( !m_players.contains( name ) )
+    {
+        return;
+    }
+    const auto previousActive = activePlayer();
+    auto& player = m_players[name];
+    auto& track = player.track;
+
+    // Settle the extrapolated position before the status or rate change it.
+    const auto now = keyboardinput::NowPlaying::Clock::now();
+    track.lastPosition = track.positionAt( now );
+    track.lastPositionTime = now;
+
+    if ( properties.contains( k_metadata ) )
+    {
+        const auto metadata
+            = qdbus_cast<QVariantMap>( properties.value( k_metadata ) );
+        track.title = metadata.value( "xesam:title" ).toString();
+        track.artist
+            = metadata.value( "xesam:artist" ).toStringList().join( ", " );
+        track.length = metadata.value( "mpris:length" ).toLongLong();
+        // Position never comes with the change, so ask once per track.
+        track.lastPosition = 0;
+        if ( !properties.contains( k_position ) )
+        {
+            queryProperty( name, k_position );
+        }
+    }
+    if ( properties.contains( k_playbackStatus ) )
+    {
+        track.playing
+            = properties.value( k_playbackStatus ).toString() == "Playing";
+        if ( track.playing )
+        {
+            player.lastActive = ++m_activity;
+        }
+    }
+    if ( properties.contains( k_rate ) )
+    {
+        track.rate = properties.value( k_rate ).toDouble();
+    }
+    if ( properties.contains( k_position ) )
+    {
+        track.lastPosition = properties.value( k_position ).toLongLong();
+    }
+
+    if ( name == activePlayer() || previousActive != activePlayer() )
+    {
+        emit nowPlayingChanged();
+    }
+}
+
+void PlayerRegistry::send( const QString& name, const QString& method )
+{
+    m_connection.callWithCallback(
+        QDBusMessage::createMethodCall(
+            name, k_objectPath, k_playerInterface, method ),
+        this,
+        SLOT( onCallFinished() ),
+        SLOT( onCallError( QDBusError, QDBusMessage ) ),
+        k_callTimeoutMs );
+}
+
+} // namespace mpris
@@ -0,0 +1,96 @@
+#pragma once
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusError>
+#include <QtDBus/QDBusMessage>
+#include <QVariantMap>
+#include "now_playing.h"
+
+namespace mpris
+{
+constexpr auto k_servicePrefix = "org.mpris.MediaPlayer2.";
+constexpr auto k_objectPath = "/org/mpris/MediaPlayer2";
+constexpr auto k_playerInterface = "org.mpris.MediaPlayer2.Player";
+// Long enough for a busy player, a hung one only costs a log line.
+constexpr int k_callTimeoutMs = 2000;
+
+/*!
+The MPRIS media players on a bus.
+
+The player list is fetched once and then kept up to date from the bus's
+NameOwnerChanged signal. Each player's properties are fetched once when it
+shows up and then kept up to date from its PropertiesChanged and Seeked
+signals, nothing is polled. Every D-Bus call is asynchronous, so a slow or
+hung player never blocks the caller.
+*/
+class PlayerRegistry : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlayerRegistry( const QDBusConnection& connection,
+                             QObject* parent = nullptr );
+
+    /*!
+    Calls method on the player that most recently started playing, or on
+    every player if none has played yet. Calls made before the player list
+    arrived are sent once it does.
+    */
+    void call( const QString& method );
+
+    // Bus names of all players.
+    [[nodiscard]] QStringList players() const;
+    // The player call() targets, empty if it targets all of them.
+    [[nodiscard]] QString activePlayer() const;
+    // True once the player list arrived.
+    [[nodiscard]] bool ready() const noexcept;
+    // The track of activePlayer(), empty if there is none.
+    [[nodiscard]] keyboardinput::NowPlaying nowPlaying() const;
+
+signals:
+    void playersChanged();
+    // nowPlaying() changed, or activePlayer() did.
+    void nowPlayingChanged();
+
+private slots:
+    void onNames( const QStringList& names );
+    void onNamesError( const QDBusError& error );
+    void onNameOwnerChanged( const QString& name,
+                             const QString& oldOwner,
+                             const QString& newOwner );
+    void onPropertiesChanged( const QDBusMessage& message );
+    void onSeeked( const QDBusMessage& message );
+    void onCallFinished();
+    void onCallError( const QDBusError& error, const QDBusMessage& call );
+
+private:
+    struct Player
+    {
+        // Unique bus name, signals are sent from it.
+        QString owner;
+        // Orders the players by when they last started playing, 0 if never.
+        quint64 lastActive = 0;
+        keyboardinput::NowPlaying track;
+    };
+
+    void sendPendingCalls();
+    void addPlayer( const QString& name, const QString& owner );
+    // The player whose unique name is owner, empty if none is known.
+    [[nodiscard]] QString playerOwnedBy( const QString& owner ) const;
+    void queryOwner( const QString& name );
+    void queryProperties( const QString& name );
+    void queryProperty( const QString& name, const QString& property );
+    void setProperties( const QString& name, const QVariantMap& properties );
+    void send( const QString& name, const QString& method );
+
+    QDBusConnection m_connection;
+    QHash<QString, Player> m_players;
+    quint64 m_activity = 0;
+    bool m_ready = false;
+    QStringList m_pendingCalls;
+};
+
+} // namespace mpris
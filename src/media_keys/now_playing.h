@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <QString>
+
+namespace keyboardinput
+{
+/*!
+The track a media player is on.
+
+Players only report their position when it jumps, so it is kept as the last
+reported position and the time it was reported, and extrapolated from there.
+*/
+struct NowPlaying
+{
+    using Clock = std::chrono::steady_clock;
+
+    QString title;
+    QString artist;
+    // Microseconds, like MPRIS. 0 if unknown.
+    qint64 length = 0;
+    qint64 lastPosition = 0;
+    Clock::time_point lastPositionTime;
+    double rate = 1.0;
+    bool playing = false;
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return title.isEmpty() && artist.isEmpty();
+    }
+
+    // Microseconds, never past the end of a track with a known length.
+    [[nodiscard]] qint64 positionAt( const Clock::time_point now ) const
+    {
+        auto position = lastPosition;
+        if ( playing && now > lastPositionTime )
+        {
+            const auto elapsed
+                = std::chrono::duration_cast<std::chrono::microseconds>(
+                      now - lastPositionTime )
+                      .count();
+            position += static_cast<qint64>( static_cast<double>( elapsed )
+                                             * rate );
+        }
+        position = std::max<qint64>( position, 0 );
+        return length > 0 ? std::min( position, length ) : position;
+    }
+};
+
+} // namespace keyboardinput
@@ -0,0 +1,111 @@
+#include "lh_console_parser.h"
+#include <cstring>
+#include <utility>
+
+namespace lh_con_util
+{
+namespace
+{
+    constexpr auto k_receiverListHeader
+        = "Attached lighthouse receiver devices:";
+    constexpr auto k_consoleName = "lighthouse_console";
+    constexpr auto k_prompt = "lighthouse_console:";
+    constexpr auto k_waitingPrompt = "lighthouse_console: ";
+    constexpr auto k_connected = "Connected to receiver";
+
+    std::string trimmed( const std::string& text )
+    {
+        constexpr auto k_whitespace = " \t\r\n";
+        const auto first = text.find_first_not_of( k_whitespace );
+        if ( first == std::string::npos )
+        {
+            return {};
+        }
+        const auto last = text.find_last_not_of( k_whitespace );
+        return text.substr( first, last - first + 1 );
+    }
+
+    bool startsWithPrompt( const std::string& text )
+    {
+        return text.compare( 0, std::strlen( k_prompt ), k_prompt ) == 0;
+    }
+
+    bool contains( const std::string& text, const char* part )
+    {
+        return text.find( part ) != std::string::npos;
+    }
+} // namespace
+
+std::vector<ConsoleOutputParser::Event>
+    ConsoleOutputParser::feed( const std::string& output )
+{
+    m_partial += output;
+
+    std::vector<Event> events;
+    std::size_t lineStart = 0;
+    while ( true )
+    {
+        const auto lineEnd = m_partial.find_first_of( "\r\n", lineStart );
+        if ( lineEnd == std::string::npos )
+        {
+            break;
+        }
+        parseLine( trimmed( m_partial.substr( lineStart,
+                                              lineEnd - lineStart ) ),
+                   events );
+        lineStart = lineEnd + 1;
+    }
+    m_partial.erase( 0, lineStart );
+
+    // The prompt isn't followed by a line break until a command was sent.
+    if ( m_partial == k_waitingPrompt )
+    {
+        m_partial.clear();
+        m_inReceiverList = false;
+        events.push_back( Event{ Event::Type::Prompt, {} } );
+    }
+    return events;
+}
+
+void ConsoleOutputParser::parseLine( std::string line,
+                                     std::vector<Event>& events )
+{
+    // Prompts that arrived in the same chunk as the following output, like
+    // "lighthouse_console: lighthouse_console: Connected to receiver".
+    while ( startsWithPrompt( line ) )
+    {
+        auto rest = trimmed( line.substr( std::strlen( k_prompt ) ) );
+        if ( !rest.empty() && !startsWithPrompt( rest ) )
+        {
+            break;
+        }
+        m_inReceiverList = false;
+        events.push_back( Event{ Event::Type::Prompt, {} } );
+        line = std::move( rest );
+    }
+    if ( line.empty() )
+    {
+        return;
+    }
+    if ( contains( line, k_receiverListHeader ) )
+    {
+        m_inReceiverList = true;
+        return;
+    }
+    if ( m_inReceiverList )
+    {
+        if ( !contains( line, k_consoleName ) )
+        {
+            events.push_back( Event{ Event::Type::Receiver, line } );
+            return;
+        }
+        m_inReceiverList = false;
+    }
+    if ( contains( line, k_connected ) )
+    {
+        const auto source = line.substr( 0, line.find( ':' ) );
+        events.push_back( Event{ Event::Type::Connected, trimmed( source ) } );
+    }
+}
+
+} // namespace lh_con_util
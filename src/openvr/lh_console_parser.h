@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace lh_con_util
+{
+/*!
+Incremental parser for the output of an interactive lighthouse_console
+session.
+
+Output can be fed in chunks of any size as it arrives, lines split across
+chunks are kept until they are complete. The session prints the attached
+receivers when it starts and then a "lighthouse_console: " prompt without a
+line break whenever it waits for a command, so a trailing prompt is
+reported without waiting for the end of its line. That also means a line
+which starts like the prompt and happens to be split right after it reads
+as a prompt.
+*/
+class ConsoleOutputParser
+{
+public:
+    struct Event
+    {
+        enum class Type
+        {
+            // text is the serial of a receiver in the startup listing.
+            Receiver,
+            // A "<source>: Connected to receiver ..." line, text is the
+            // source. That is the serial of the paired device, or
+            // "lighthouse_console" when the console itself connected.
+            Connected,
+            // The console is waiting for the next command.
+            Prompt,
+        };
+
+        Type type;
+        std::string text;
+
+        bool operator==( const Event& other ) const
+        {
+            return type == other.type && text == other.text;
+        }
+    };
+
+    [[nodiscard]] std::vector<Event> feed( const std::string& output );
+
+private:
+    void parseLine( std::string line, std::vector<Event>& events );
+
+    std::string m_partial;
+    bool m_inReceiverList = false;
+};
+
+} // namespace lh_con_util
@@ -1,128 +1,328 @@
 #include "lh_console_util.h"
-#include <QRegularExpression>
+#include <algorithm>
+#include <utility>
+#include <easylogging++.h>
 
 namespace lh_con_util
 {
-bool LHCUtil::FindAll()
+ConsoleSession::ConsoleSession( const QString& path, QObject* parent )
+    : QObject( parent ), m_path( path )
 {
-    if ( !FindAllRX() )
+    m_process.setProcessChannelMode( QProcess::MergedChannels );
+    connect( &m_process, SIGNAL( readyRead() ), this, SLOT( OnReadyRead() ) );
+    connect( &m_process,
+             SIGNAL( errorOccurred( QProcess::ProcessError ) ),
+             this,
+             SLOT( OnErrorOccurred( QProcess::ProcessError ) ) );
+    connect( &m_process,
+             SIGNAL( finished( int, QProcess::ExitStatus ) ),
+             this,
+             SLOT( OnFinished( int, QProcess::ExitStatus ) ) );
+}
+
+void ConsoleSession::start()
+{
+    m_process.start( m_path, QStringList() );
+}
+
+void ConsoleSession::query( const QString& rxSerial )
+{
+    if ( m_ended )
     {
-        LOG( ERROR ) << "Find All Recievers Failed";
-        return false;
+        emit queried( rxSerial, "", false );
+        return;
     }
-    if ( !FindAllTX() )
+    m_queue.push_back( rxSerial );
+    sendNext();
+}
+
+void ConsoleSession::close()
+{
+    m_queue.clear();
+    // Writes while the console is still starting are sent once it runs.
+    if ( m_process.state() != QProcess::NotRunning && !m_ended )
     {
-        LOG( ERROR ) << "Find All Transmitters Failed";
-        return false;
+        m_process.write( "exit\n" );
+        m_process.closeWriteChannel();
     }
-    return true;
+    m_ended = true;
 }
 
-bool LHCUtil::FindAllRX()
+void ConsoleSession::dispose()
 {
-    QProcess* lhProcess = new QProcess();
-    QString program = "lighthouse_console.exe";
-    lhProcess->start( path_, QStringList() << "" );
-    lhProcess->waitForFinished();
-
-    QString output = QString( lhProcess->readAllStandardOutput() );
-    QStringList outputLines 
-            = output.split(QRegularExpression("[\\r\\n]"), Qt::SkipEmptyParts);
-    bool RecieverStart = false;
-
-    for ( auto OutputLine : outputLines )
+    close();
+    m_disposed = true;
+    if ( m_process.state() == QProcess::NotRunning )
     {
-        if ( OutputLine.contains( "Attached lighthouse receiver devices:" ) )
-        {
-            RecieverStart = true;
-            continue;
-        }
-        if ( RecieverStart )
-        {
-            if ( OutputLine.contains( "lighthouse_console" ) )
-            {
-                break;
-            }
-            OutputLine.simplified().remove( " " );
-            OutputLine.remove( 0, 1 );
-            // LOG( WARNING ) << OutputLine << std::endl;
-            RXTX_Pairs_.push_back( RXTX_Pair{ OutputLine, " ", true, false } );
-        }
+        deleteLater();
+        return;
     }
-    return !RXTX_Pairs_.empty();
+    // ~QProcess would kill a running console and block the event loop until
+    // it is gone, so the session waits for OnFinished() instead.
+    QTimer::singleShot( k_exitTimeoutMs, this, SLOT( OnExitTimeout() ) );
 }
 
-bool LHCUtil::FindConnectedTX( QString RXSerial )
+void ConsoleSession::OnExitTimeout()
 {
-    LOG( WARNING ) << RXSerial;
-    QProcess* lhProcess = new QProcess();
-    lhProcess->start( path_, QStringList() << "/serial" << RXSerial << "exit" );
-    lhProcess->waitForFinished();
+    if ( m_process.state() != QProcess::NotRunning )
+    {
+        LOG( WARNING ) << "lighthouse_console did not exit, killing it.";
+        m_process.kill();
+    }
+}
 
-    QString output = QString( lhProcess->readAllStandardOutput() );
-    QStringList outputLines
-        = output.split(QRegularExpression("[\\r\\n]"), Qt::SkipEmptyParts);
-    // std::vector<std::string> OutputLines
-    //   = exec( ( "\"" + path_ + "\" /serial " + RXSerial + " exit" ).c_str()
-    //   );
-    bool lhConFound = false;
-    for ( auto outputLine : outputLines )
+void ConsoleSession::OnReadyRead()
+{
+    const auto output = m_process.readAll().toStdString();
+    for ( const auto& event : m_parser.feed( output ) )
     {
-        // LOG( WARNING ) << outputLine;
-        if ( outputLine.contains( "Connected to receiver" ) )
+        switch ( event.type )
         {
-            auto splitList = outputLine.split( ":" );
-            QString TXSerial = splitList[0];
-            if ( TXSerial == "lighthouse_console" )
+        case ConsoleOutputParser::Event::Type::Receiver:
+            m_receivers.append( QString::fromStdString( event.text ) );
+            break;
+        case ConsoleOutputParser::Event::Type::Connected:
+            if ( event.text == "lighthouse_console" )
             {
-                lhConFound = true;
-                continue;
+                m_consoleConnected = true;
             }
-            for ( auto& rxtx : RXTX_Pairs_ )
+            else
             {
-                if ( rxtx.RX_Serial == RXSerial )
-                {
-                    rxtx.TX_Serial = TXSerial;
-                    rxtx.Is_Paired = true;
-                    rxtx.Is_Init = true;
-                    LOG( WARNING )
-                        << "tx serial stored: " << TXSerial.toStdString();
-                    return true;
-                }
+                m_currentTX = QString::fromStdString( event.text );
             }
-            // TODO error handling
-            return false;
+            break;
+        case ConsoleOutputParser::Event::Type::Prompt:
+            onPrompt();
+            break;
         }
     }
-    if ( lhConFound )
+}
+
+void ConsoleSession::onPrompt()
+{
+    if ( !m_listed )
     {
-        for ( auto rxtx : RXTX_Pairs_ )
+        m_listed = true;
+        emit receiversListed( m_receivers );
+    }
+    if ( !m_current.isEmpty() )
+    {
+        // Without a transmitter the console only reports its own
+        // connection, the receiver is there but not paired.
+        const bool ok = !m_currentTX.isEmpty() || m_consoleConnected;
+        const auto rxSerial = m_current;
+        m_current.clear();
+        emit queried( rxSerial, m_currentTX, ok );
+    }
+    m_ready = true;
+    sendNext();
+}
+
+void ConsoleSession::sendNext()
+{
+    if ( !m_ready || m_ended || m_queue.empty() )
+    {
+        return;
+    }
+    m_current = m_queue.front();
+    m_queue.pop_front();
+    m_currentTX.clear();
+    m_consoleConnected = false;
+    m_ready = false;
+    m_process.write( QString( "serial %1\n" ).arg( m_current ).toUtf8() );
+}
+
+void ConsoleSession::OnErrorOccurred( QProcess::ProcessError error )
+{
+    // Crashes are followed by finished(), failing to start isn't.
+    if ( error == QProcess::FailedToStart )
+    {
+        LOG( ERROR ) << "Could not start lighthouse_console: "
+                     << m_process.errorString().toStdString();
+        abandon();
+        if ( m_disposed )
         {
-            if ( rxtx.RX_Serial == RXSerial )
-            {
-                rxtx.TX_Serial = "";
-                rxtx.Is_Paired = false;
-                rxtx.Is_Init = true;
-                LOG( WARNING ) << "tx oops";
-                return true;
-            }
+            deleteLater();
         }
     }
-    // TODO error handling
-    return false;
 }
 
-bool LHCUtil::FindAllTX()
+void ConsoleSession::OnFinished( int exitCode,
+                                 QProcess::ExitStatus exitStatus )
 {
-    bool NoError = true;
-    for ( auto rxtx : RXTX_Pairs_ )
+    if ( exitStatus != QProcess::NormalExit || exitCode != 0 )
+    {
+        LOG( WARNING ) << "lighthouse_console exited with code " << exitCode;
+    }
+    abandon();
+    if ( m_disposed )
+    {
+        deleteLater();
+    }
+}
+
+void ConsoleSession::abandon()
+{
+    const bool wasEnded = m_ended;
+    m_ended = true;
+    m_ready = false;
+    if ( wasEnded )
+    {
+        return;
+    }
+
+    if ( !m_listed )
+    {
+        emit failed();
+    }
+    auto unanswered = std::move( m_queue );
+    m_queue.clear();
+    if ( !m_current.isEmpty() )
+    {
+        unanswered.push_front( m_current );
+        m_current.clear();
+    }
+    for ( const auto& rxSerial : unanswered )
+    {
+        emit queried( rxSerial, "", false );
+    }
+}
+
+LHCUtil::LHCUtil( QString path, QObject* parent )
+    : QObject( parent ), path_( std::move( path ) )
+{
+    m_timeout.setSingleShot( true );
+    m_timeout.setInterval( k_scanTimeoutMs );
+    connect( &m_timeout, SIGNAL( timeout() ), this, SLOT( OnScanTimeout() ) );
+}
+
+void LHCUtil::scan()
+{
+    if ( m_scanning )
+    {
+        return;
+    }
+    m_scanning = true;
+    m_success = true;
+    m_pending = 0;
+    RXTX_Pairs_.clear();
+
+    auto discovery = addSession();
+    connect( discovery,
+             SIGNAL( receiversListed( QStringList ) ),
+             this,
+             SLOT( OnReceiversListed( QStringList ) ) );
+    connect( discovery, SIGNAL( failed() ), this, SLOT( OnDiscoveryFailed() ) );
+    m_timeout.start();
+    discovery->start();
+}
+
+ConsoleSession* LHCUtil::addSession()
+{
+    auto session = new ConsoleSession( path_, this );
+    connect( session,
+             SIGNAL( queried( QString, QString, bool ) ),
+             this,
+             SLOT( OnQueried( QString, QString, bool ) ) );
+    m_sessions.push_back( session );
+    return session;
+}
+
+void LHCUtil::OnReceiversListed( QStringList rxSerials )
+{
+    if ( rxSerials.isEmpty() )
+    {
+        LOG( ERROR ) << "Find All Recievers Failed";
+        finishScan( false );
+        return;
+    }
+
+    for ( const auto& rxSerial : rxSerials )
+    {
+        RXTX_Pairs_.push_back( RXTX_Pair{ rxSerial, "", false, false } );
+        emit receiverFound( rxSerial );
+    }
+
+    // The discovery session is already running and takes the first share.
+    const auto sessionCount
+        = std::min( k_maxSessions, static_cast<int>( rxSerials.size() ) );
+    while ( static_cast<int>( m_sessions.size() ) < sessionCount )
+    {
+        addSession()->start();
+    }
+    m_pending = static_cast<int>( rxSerials.size() );
+    for ( int i = 0; i < rxSerials.size() && m_scanning; ++i )
     {
-        if ( !FindConnectedTX( rxtx.RX_Serial ) )
+        m_sessions[static_cast<std::size_t>( i % sessionCount )]->query(
+            rxSerials[i] );
+    }
+}
+
+void LHCUtil::OnQueried( QString rxSerial, QString txSerial, bool ok )
+{
+    if ( !m_scanning )
+    {
+        return;
+    }
+    for ( auto& rxtx : RXTX_Pairs_ )
+    {
+        if ( rxtx.RX_Serial == rxSerial )
         {
-            NoError = false;
+            rxtx.TX_Serial = txSerial;
+            rxtx.Is_Init = ok;
+            rxtx.Is_Paired = ok && !txSerial.isEmpty();
         }
     }
-    return NoError;
+
+    if ( ok )
+    {
+        emit transmitterFound( rxSerial, txSerial );
+    }
+    else
+    {
+        LOG( ERROR ) << "Could not query receiver " << rxSerial.toStdString();
+        m_success = false;
+    }
+
+    if ( --m_pending == 0 )
+    {
+        finishScan( m_success );
+    }
+}
+
+void LHCUtil::OnDiscoveryFailed()
+{
+    LOG( ERROR ) << "Find All Recievers Failed";
+    finishScan( false );
+}
+
+void LHCUtil::OnScanTimeout()
+{
+    LOG( ERROR ) << "lighthouse_console did not answer within "
+                 << k_scanTimeoutMs << " ms";
+    finishScan( false );
+}
+
+void LHCUtil::finishScan( bool success )
+{
+    if ( !m_scanning )
+    {
+        return;
+    }
+    m_scanning = false;
+    m_timeout.stop();
+
+    // Sessions may be the sender of the signal being handled, so they are
+    // only deleted once control returns to the event loop, and not before
+    // their console has exited.
+    for ( auto session : m_sessions )
+    {
+        disconnect( session, nullptr, this, nullptr );
+        session->dispose();
+    }
+    m_sessions.clear();
+
+    emit scanFinished( success );
 }
 
 QString LHCUtil::GetLinkedTX( QString RXSerial )
@@ -1,18 +1,12 @@
 #pragma once
-#include "openvr.h"
+#include <deque>
 #include <vector>
-#include <utility>
-#include <cstdio>
-#include <iostream>
-#include <memory>
-#include <stdexcept>
-#include <string>
-#include <array>
+#include <QObject>
 #include <QProcess>
 #include <QString>
 #include <QStringList>
-#include <QRegularExpression>
-#include <easylogging++.h>
+#include <QTimer>
+#include "lh_console_parser.h"
 
 namespace lh_con_util
 {
@@ -23,26 +17,119 @@ struct RXTX_Pair
     bool Is_Init = false;
     bool Is_Paired = false;
 };
-class LHCUtil
+
+/*!
+One long lived interactive lighthouse_console process.
+
+Receivers are queried by writing "serial <RX>" to stdin, the answer is
+parsed as the output arrives and is complete once the console prompts for
+the next command. Queries are queued and sent one at a time.
+*/
+class ConsoleSession : public QObject
 {
+    Q_OBJECT
+
+public:
+    ConsoleSession( const QString& path, QObject* parent );
+
+    void start();
+    void query( const QString& rxSerial );
+    // Asks the console to exit, queries that are still queued are dropped.
+    void close();
+    // Closes the session and deletes it once the console has exited, or
+    // after killing it if it hasn't within k_exitTimeoutMs.
+    void dispose();
+
+    static constexpr int k_exitTimeoutMs = 2000;
+
+signals:
+    // The receivers the console listed when it started.
+    void receiversListed( QStringList rxSerials );
+    // ok is false if the console didn't answer. txSerial is empty if the
+    // receiver isn't paired.
+    void queried( QString rxSerial, QString txSerial, bool ok );
+    // The console ended before it listed the receivers.
+    void failed();
+
+private slots:
+    void OnReadyRead();
+    void OnErrorOccurred( QProcess::ProcessError error );
+    void OnFinished( int exitCode, QProcess::ExitStatus exitStatus );
+    void OnExitTimeout();
+
 private:
-    QString path_;
-    bool InPairs( std::string RXSerial );
-    bool FindAllRX();
-    bool FindAllTX();
-    bool path_Init = false;
+    void onPrompt();
+    void sendNext();
+    void abandon();
+
+    QString m_path;
+    QProcess m_process;
+    ConsoleOutputParser m_parser;
+
+    bool m_listed = false;
+    bool m_ready = false;
+    bool m_ended = false;
+    bool m_disposed = false;
+    QStringList m_receivers;
+
+    std::deque<QString> m_queue;
+    QString m_current;
+    QString m_currentTX;
+    bool m_consoleConnected = false;
+};
+
+/*!
+Finds the lighthouse receivers and their paired transmitters without
+blocking the caller.
+
+scan() starts one console session that lists the receivers and then spreads
+the receivers over up to k_maxSessions sessions which query them in
+parallel. Results are reported through the signals as they arrive and are
+kept in RXTX_Pairs_.
+*/
+class LHCUtil : public QObject
+{
+    Q_OBJECT
 
 public:
-    explicit LHCUtil( QString path )
+    static constexpr int k_maxSessions = 4;
+    static constexpr int k_scanTimeoutMs = 20000;
+
+    explicit LHCUtil( QString path, QObject* parent = nullptr );
+
+    // Does nothing while a scan is running.
+    void scan();
+    bool isScanning() const
     {
-        path_ = path;
+        return m_scanning;
     }
+
     std::vector<RXTX_Pair> RXTX_Pairs_;
-    bool FindAll();
-    bool FindConnectedTX( QString RXSerial );
     QString GetLinkedTX( QString RXSerial );
     QString GetLinkedRX( QString TXSerial );
-    RXTX_Pair GetConnectedTXRXPair();
-    bool pairDevice( QString RXSerial );
+
+signals:
+    void receiverFound( QString rxSerial );
+    // txSerial is empty if the receiver isn't paired.
+    void transmitterFound( QString rxSerial, QString txSerial );
+    // success is false if any receiver couldn't be queried.
+    void scanFinished( bool success );
+
+private slots:
+    void OnReceiversListed( QStringList rxSerials );
+    void OnQueried( QString rxSerial, QString txSerial, bool ok );
+    void OnDiscoveryFailed();
+    void OnScanTimeout();
+
+private:
+    ConsoleSession* addSession();
+    void finishScan( bool success );
+
+    QString path_;
+    std::vector<ConsoleSession*> m_sessions;
+    QTimer m_timeout;
+    bool m_scanning = false;
+    bool m_success = true;
+    int m_pending = 0;
 };
 } // namespace lh_con_util
@@ -99,6 +99,26 @@ OverlayError setOverlayFromFile( vr::VROverlayHandle_t overlayHandle,
     }
 }
 
+OverlayError setOverlayRaw( vr::VROverlayHandle_t overlayHandle,
+                            void* buffer,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t bytesPerPixel,
+                            std::string customErrorMsg )
+{
+    vr::VROverlayError oError = vr::VROverlay()->SetOverlayRaw(
+        overlayHandle, buffer, width, height, bytesPerPixel );
+    if ( oError != vr::VROverlayError_None )
+    {
+        LOG( ERROR ) << "Error setting Overlay Image For "
+                     << getOverlayKey( overlayHandle ) << " with error: "
+                     << vr::VROverlay()->GetOverlayErrorNameFromEnum( oError )
+                     << " " << customErrorMsg;
+        return OverlayError::UndefinedError;
+    }
+    return OverlayError::NoError;
+}
+
 OverlayError showOverlay( vr::VROverlayHandle_t overlayHandle,
                           std::string customErrorMsg )
 {
@@ -148,6 +168,26 @@ OverlayError setOverlayTransformAbsolute(
     return OverlayError::NoError;
 }
 
+OverlayError setOverlayTransformTrackedDeviceRelative(
+    vr::VROverlayHandle_t overlayHandle,
+    vr::TrackedDeviceIndex_t trackedDevice,
+    const vr::HmdMatrix34_t* trackedDeviceToOverlayTransform,
+    std::string customErrorMsg )
+{
+    vr::VROverlayError oError
+        = vr::VROverlay()->SetOverlayTransformTrackedDeviceRelative(
+            overlayHandle, trackedDevice, trackedDeviceToOverlayTransform );
+    if ( oError != vr::VROverlayError_None )
+    {
+        LOG( ERROR ) << "Error setting Overlay Position For "
+                     << getOverlayKey( overlayHandle ) << " with error: "
+                     << vr::VROverlay()->GetOverlayErrorNameFromEnum( oError )
+                     << " " << customErrorMsg;
+        return OverlayError::UndefinedError;
+    }
+    return OverlayError::NoError;
+}
+
 std::string getOverlayKey( vr::VROverlayHandle_t overlayHandle )
 {
     // max size as of ovr 1.11.11 128 bytes
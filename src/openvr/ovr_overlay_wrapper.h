@@ -43,6 +43,12 @@ OverlayError setOverlayWidthInMeters( vr::VROverlayHandle_t overlayHandle,
 OverlayError setOverlayFromFile( vr::VROverlayHandle_t overlayHandle,
                                  std::string fileName,
                                  std::string customErrorMsg = "" );
+OverlayError setOverlayRaw( vr::VROverlayHandle_t overlayHandle,
+                            void* buffer,
+                            uint32_t width,
+                            uint32_t height,
+                            uint32_t bytesPerPixel,
+                            std::string customErrorMsg = "" );
 OverlayError showOverlay( vr::VROverlayHandle_t overlayHandle,
                           std::string customErrorMsg = "" );
 OverlayError hideOverlay( vr::VROverlayHandle_t overlayHandle,
@@ -53,6 +59,12 @@ OverlayError setOverlayTransformAbsolute(
     const vr::HmdMatrix34_t* trackingOriginToOverlayTransform,
     std::string customErrorMsg = "" );
 
+OverlayError setOverlayTransformTrackedDeviceRelative(
+    vr::VROverlayHandle_t overlayHandle,
+    vr::TrackedDeviceIndex_t trackedDevice,
+    const vr::HmdMatrix34_t* trackedDeviceToOverlayTransform,
+    std::string customErrorMsg = "" );
+
 std::string getOverlayKey( vr::VROverlayHandle_t overlayHandle );
 
 } // namespace ovr_overlay_wrapper
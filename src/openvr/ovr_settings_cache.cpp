@@ -0,0 +1,347 @@
+#include "ovr_settings_cache.h"
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace ovr_settings_wrapper
+{
+namespace
+{
+    // Same buffer size the settings wrapper always used for strings.
+    constexpr uint32_t k_stringBufferSize = 4096;
+
+    struct EventSection
+    {
+        uint32_t eventType;
+        const char* section;
+    };
+
+    constexpr std::array<EventSection, 19> k_eventSections{ {
+        { vr::VREvent_ChaperoneSettingsHaveChanged,
+          vr::k_pch_CollisionBounds_Section },
+        { vr::VREvent_AudioSettingsHaveChanged, vr::k_pch_audio_Section },
+        { vr::VREvent_CameraSettingsHaveChanged, vr::k_pch_Camera_Section },
+        { vr::VREvent_ModelSkinSettingsHaveChanged,
+          vr::k_pch_modelskin_Section },
+        { vr::VREvent_PowerSettingsHaveChanged, vr::k_pch_Power_Section },
+        { vr::VREvent_SteamVRSectionSettingChanged, vr::k_pch_SteamVR_Section },
+        { vr::VREvent_LighthouseSectionSettingChanged,
+          vr::k_pch_Lighthouse_Section },
+        { vr::VREvent_NullSectionSettingChanged, vr::k_pch_Null_Section },
+        { vr::VREvent_UserInterfaceSectionSettingChanged,
+          vr::k_pch_UserInterface_Section },
+        { vr::VREvent_NotificationsSectionSettingChanged,
+          vr::k_pch_Notifications_Section },
+        { vr::VREvent_KeyboardSectionSettingChanged,
+          vr::k_pch_Keyboard_Section },
+        { vr::VREvent_PerfSectionSettingChanged, vr::k_pch_Perf_Section },
+        { vr::VREvent_DashboardSectionSettingChanged,
+          vr::k_pch_Dashboard_Section },
+        { vr::VREvent_WebInterfaceSectionSettingChanged,
+          vr::k_pch_WebInterface_Section },
+        { vr::VREvent_TrackersSectionSettingChanged,
+          vr::k_pch_Trackers_Section },
+        { vr::VREvent_LastKnownSectionSettingChanged,
+          vr::k_pch_LastKnown_Section },
+        { vr::VREvent_DismissedWarningsSectionSettingChanged,
+          vr::k_pch_DismissedWarnings_Section },
+        { vr::VREvent_GpuSpeedSectionSettingChanged,
+          vr::k_pch_GpuSpeed_Section },
+        { vr::VREvent_WindowsMRSectionSettingChanged,
+          vr::k_pch_WindowsMR_Section },
+    } };
+
+    template <typename T>
+    T read( vr::IVRSettings& settings,
+            const std::string& section,
+            const std::string& settingsKey,
+            vr::EVRSettingsError* error )
+    {
+        if constexpr ( std::is_same<T, bool>::value )
+        {
+            return settings.GetBool(
+                section.c_str(), settingsKey.c_str(), error );
+        }
+        else if constexpr ( std::is_same<T, int32_t>::value )
+        {
+            return settings.GetInt32(
+                section.c_str(), settingsKey.c_str(), error );
+        }
+        else if constexpr ( std::is_same<T, float>::value )
+        {
+            return settings.GetFloat(
+                section.c_str(), settingsKey.c_str(), error );
+        }
+        else if constexpr ( std::is_same<T, std::string>::value )
+        {
+            char buffer[k_stringBufferSize] = {};
+            settings.GetString( section.c_str(),
+                                settingsKey.c_str(),
+                                buffer,
+                                k_stringBufferSize,
+                                error );
+            return buffer;
+        }
+    }
+
+    template <typename T>
+    void write( vr::IVRSettings& settings,
+                const std::string& section,
+                const std::string& settingsKey,
+                const T& value,
+                vr::EVRSettingsError* error )
+    {
+        if constexpr ( std::is_same<T, bool>::value )
+        {
+            settings.SetBool(
+                section.c_str(), settingsKey.c_str(), value, error );
+        }
+        else if constexpr ( std::is_same<T, int32_t>::value )
+        {
+            settings.SetInt32(
+                section.c_str(), settingsKey.c_str(), value, error );
+        }
+        else if constexpr ( std::is_same<T, float>::value )
+        {
+            settings.SetFloat(
+                section.c_str(), settingsKey.c_str(), value, error );
+        }
+        else if constexpr ( std::is_same<T, std::string>::value )
+        {
+            settings.SetString( section.c_str(),
+                                settingsKey.c_str(),
+                                value.c_str(),
+                                error );
+        }
+    }
+
+    void report( vr::EVRSettingsError* out, const vr::EVRSettingsError error )
+    {
+        if ( out != nullptr )
+        {
+            *out = error;
+        }
+    }
+} // namespace
+
+SettingsCache::SettingsCache( Backend backend )
+    : m_backend( std::move( backend ) )
+{
+}
+
+template <typename T>
+T SettingsCache::get( const std::string& section,
+                      const std::string& settingsKey,
+                      vr::EVRSettingsError* error )
+{
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        const auto s = m_sections.find( section );
+        if ( s != m_sections.end() )
+        {
+            const auto k = s->second.find( settingsKey );
+            if ( k != s->second.end()
+                 && std::holds_alternative<T>( k->second ) )
+            {
+                ++m_hits;
+                report( error, vr::VRSettingsError_None );
+                return std::get<T>( k->second );
+            }
+        }
+        ++m_misses;
+        generation = m_generation;
+    }
+
+    auto settings = m_backend ? m_backend() : nullptr;
+    if ( settings == nullptr )
+    {
+        report( error, vr::VRSettingsError_IPCFailed );
+        return T{};
+    }
+    auto readError = vr::VRSettingsError_None;
+    auto value = read<T>( *settings, section, settingsKey, &readError );
+    report( error, readError );
+
+    if ( readError == vr::VRSettingsError_None )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if ( generation == m_generation )
+        {
+            m_sections[section][settingsKey] = value;
+        }
+    }
+    return value;
+}
+
+template <typename T>
+void SettingsCache::set( const std::string& section,
+                         const std::string& settingsKey,
+                         const T& value,
+                         vr::EVRSettingsError* error )
+{
+    auto settings = m_backend ? m_backend() : nullptr;
+    if ( settings == nullptr )
+    {
+        report( error, vr::VRSettingsError_IPCFailed );
+        return;
+    }
+    auto writeError = vr::VRSettingsError_None;
+    write<T>( *settings, section, settingsKey, value, &writeError );
+    report( error, writeError );
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    ++m_generation;
+    if ( writeError == vr::VRSettingsError_None )
+    {
+        m_sections[section][settingsKey] = value;
+        return;
+    }
+    // Unknown what OpenVR holds now.
+    const auto s = m_sections.find( section );
+    if ( s != m_sections.end() )
+    {
+        s->second.erase( settingsKey );
+    }
+}
+
+bool SettingsCache::getBool( const std::string& section,
+                             const std::string& settingsKey,
+                             vr::EVRSettingsError* error )
+{
+    return get<bool>( section, settingsKey, error );
+}
+
+int32_t SettingsCache::getInt32( const std::string& section,
+                                 const std::string& settingsKey,
+                                 vr::EVRSettingsError* error )
+{
+    return get<int32_t>( section, settingsKey, error );
+}
+
+float SettingsCache::getFloat( const std::string& section,
+                               const std::string& settingsKey,
+                               vr::EVRSettingsError* error )
+{
+    return get<float>( section, settingsKey, error );
+}
+
+std::string SettingsCache::getString( const std::string& section,
+                                      const std::string& settingsKey,
+                                      vr::EVRSettingsError* error )
+{
+    return get<std::string>( section, settingsKey, error );
+}
+
+void SettingsCache::setBool( const std::string& section,
+                             const std::string& settingsKey,
+                             const bool value,
+                             vr::EVRSettingsError* error )
+{
+    set( section, settingsKey, value, error );
+}
+
+void SettingsCache::setInt32( const std::string& section,
+                              const std::string& settingsKey,
+                              const int32_t value,
+                              vr::EVRSettingsError* error )
+{
+    set( section, settingsKey, value, error );
+}
+
+void SettingsCache::setFloat( const std::string& section,
+                              const std::string& settingsKey,
+                              const float value,
+                              vr::EVRSettingsError* error )
+{
+    set( section, settingsKey, value, error );
+}
+
+void SettingsCache::setString( const std::string& section,
+                               const std::string& settingsKey,
+                               const std::string& value,
+                               vr::EVRSettingsError* error )
+{
+    set( section, settingsKey, value, error );
+}
+
+void SettingsCache::removeSection( const std::string& section,
+                                   vr::EVRSettingsError* error )
+{
+    auto settings = m_backend ? m_backend() : nullptr;
+    if ( settings == nullptr )
+    {
+        report( error, vr::VRSettingsError_IPCFailed );
+        return;
+    }
+    settings->RemoveSection( section.c_str(), error );
+    invalidateSection( section );
+}
+
+void SettingsCache::removeKeyInSection( const std::string& section,
+                                        const std::string& settingsKey,
+                                        vr::EVRSettingsError* error )
+{
+    auto settings = m_backend ? m_backend() : nullptr;
+    if ( settings == nullptr )
+    {
+        report( error, vr::VRSettingsError_IPCFailed );
+        return;
+    }
+    settings->RemoveKeyInSection(
+        section.c_str(), settingsKey.c_str(), error );
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    ++m_generation;
+    const auto s = m_sections.find( section );
+    if ( s != m_sections.end() )
+    {
+        s->second.erase( settingsKey );
+    }
+}
+
+void SettingsCache::handleEvent( const uint32_t eventType )
+{
+    for ( const auto& eventSection : k_eventSections )
+    {
+        if ( eventSection.eventType == eventType )
+        {
+            invalidateSection( eventSection.section );
+            return;
+        }
+    }
+    // The remaining settings events don't say which section changed.
+    if ( eventType >= vr::VREvent_BackgroundSettingHasChanged
+         && eventType <= vr::VREvent_OtherSectionSettingChanged )
+    {
+        invalidateAll();
+    }
+}
+
+void SettingsCache::invalidateSection( const std::string& section )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    ++m_generation;
+    m_sections.erase( section );
+}
+
+void SettingsCache::invalidateAll()
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    ++m_generation;
+    m_sections.clear();
+}
+
+uint64_t SettingsCache::hits() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_hits;
+}
+
+uint64_t SettingsCache::misses() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_misses;
+}
+
+} // namespace ovr_settings_wrapper
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <openvr.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <variant>
+
+namespace ovr_settings_wrapper
+{
+/*!
+Read-through cache in front of \c vr::IVRSettings.
+
+Every getter returns the cached value if the key was read or written through
+the cache before, and only talks to OpenVR on a miss. A cached value is
+dropped when:
+  - it is written or removed through the cache, which stores the new value
+    right away,
+  - OpenVR reports that settings of its section changed, see handleEvent(),
+  - it is read as a different type than it was cached as.
+
+Failed reads aren't cached, so errors are reported on every access like
+before.
+
+The backend is looked up on every miss rather than stored, since the
+interface pointer is only valid while OpenVR is initialized. Tests pass a
+function returning a mock.
+*/
+class SettingsCache
+{
+public:
+    using Backend = std::function<vr::IVRSettings*()>;
+
+    explicit SettingsCache( Backend backend );
+
+    bool getBool( const std::string& section,
+                  const std::string& settingsKey,
+                  vr::EVRSettingsError* error = nullptr );
+    int32_t getInt32( const std::string& section,
+                      const std::string& settingsKey,
+                      vr::EVRSettingsError* error = nullptr );
+    float getFloat( const std::string& section,
+                    const std::string& settingsKey,
+                    vr::EVRSettingsError* error = nullptr );
+    std::string getString( const std::string& section,
+                           const std::string& settingsKey,
+                           vr::EVRSettingsError* error = nullptr );
+
+    void setBool( const std::string& section,
+                  const std::string& settingsKey,
+                  const bool value,
+                  vr::EVRSettingsError* error = nullptr );
+    void setInt32( const std::string& section,
+                   const std::string& settingsKey,
+                   const int32_t value,
+                   vr::EVRSettingsError* error = nullptr );
+    void setFloat( const std::string& section,
+                   const std::string& settingsKey,
+                   const float value,
+                   vr::EVRSettingsError* error = nullptr );
+    void setString( const std::string& section,
+                    const std::string& settingsKey,
+                    const std::string& value,
+                    vr::EVRSettingsError* error = nullptr );
+
+    void removeSection( const std::string& section,
+                        vr::EVRSettingsError* error = nullptr );
+    void removeKeyInSection( const std::string& section,
+                             const std::string& settingsKey,
+                             vr::EVRSettingsError* error = nullptr );
+
+    // Drops the cached values a VREvent_*SettingsHaveChanged or
+    // VREvent_*SectionSettingChanged event may have made stale. Other events
+    // are ignored.
+    void handleEvent( const uint32_t eventType );
+    void invalidateSection( const std::string& section );
+    void invalidateAll();
+
+    [[nodiscard]] uint64_t hits() const;
+    [[nodiscard]] uint64_t misses() const;
+
+private:
+    using Value = std::variant<bool, int32_t, float, std::string>;
+
+    template <typename T>
+    T get( const std::string& section,
+           const std::string& settingsKey,
+           vr::EVRSettingsError* error );
+    template <typename T>
+    void set( const std::string& section,
+              const std::string& settingsKey,
+              const T& value,
+              vr::EVRSettingsError* error );
+
+    Backend m_backend;
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, std::map<std::string, Value>> m_sections;
+    // Bumped by every invalidation, so a read that raced with one doesn't
+    // store its possibly stale result.
+    uint64_t m_generation = 0;
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+} // namespace ovr_settings_wrapper
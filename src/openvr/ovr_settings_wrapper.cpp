@@ -6,6 +6,12 @@ namespace ovr_settings_wrapper
 // (most likely false)
 bool unsetSettingErrorEnabled = true;
 
+SettingsCache& settingsCache()
+{
+    static SettingsCache cache( [] { return vr::VRSettings(); } );
+    return cache;
+}
+
 SettingsError handleErrors( std::string settingsKey,
                             vr::EVRSettingsError error,
                             std::string customErrorMsg )
@@ -40,8 +46,7 @@ std::pair<SettingsError, bool> getBool( std::string section,
 {
     bool value;
     vr::EVRSettingsError error;
-    value = vr::VRSettings()->GetBool(
-        section.c_str(), settingsKey.c_str(), &error );
+    value = settingsCache().getBool( section, settingsKey, &error );
     SettingsError e = handleErrors( settingsKey, error, customErrorMsg );
     std::pair<SettingsError, bool> p( e, value );
     return p;
@@ -54,8 +59,8 @@ std::pair<SettingsError, int> getInt32( std::string section,
 {
     int value;
     vr::EVRSettingsError error;
-    value = static_cast<int>( vr::VRSettings()->GetInt32(
-        section.c_str(), settingsKey.c_str(), &error ) );
+    value = static_cast<int>(
+        settingsCache().getInt32( section, settingsKey, &error ) );
     SettingsError e = handleErrors( settingsKey, error, customErrorMsg );
     std::pair<SettingsError, int> p( e, value );
     return p;
@@ -68,9 +73,7 @@ std::pair<SettingsError, float> getFloat( std::string section,
 {
     float value;
     vr::EVRSettingsError error;
-    value = vr::VRSettings()->GetFloat(
-        section.c_str(), settingsKey.c_str(), &error );
-    handleErrors( settingsKey, error, customErrorMsg );
+    value = settingsCache().getFloat( section, settingsKey, &error );
     SettingsError e = handleErrors( settingsKey, error, customErrorMsg );
     std::pair<SettingsError, float> p( e, value );
     return p;
@@ -82,15 +85,8 @@ std::pair<SettingsError, std::string> getString( std::string section,
 
 {
     vr::EVRSettingsError error;
-    // This appears to be correct value as set in CVRSettingHelper as of
-    // ovr 1.11.11
-    const uint32_t bufferMax = 4096;
-    char cStringOut[bufferMax];
-
-    vr::VRSettings()->GetString(
-        section.c_str(), settingsKey.c_str(), cStringOut, bufferMax, &error );
-    handleErrors( settingsKey, error, customErrorMsg );
-    std::string value = cStringOut;
+    std::string value
+        = settingsCache().getString( section, settingsKey, &error );
     SettingsError e = handleErrors( settingsKey, error, customErrorMsg );
     std::pair<SettingsError, std::string> p( e, value );
     return p;
@@ -104,8 +100,7 @@ SettingsError setBool( std::string section,
                        std::string customErrorMsg )
 {
     vr::EVRSettingsError error;
-    vr::VRSettings()->SetBool(
-        section.c_str(), settingsKey.c_str(), value, &error );
+    settingsCache().setBool( section, settingsKey, value, &error );
     return handleErrors( settingsKey, error, customErrorMsg );
 }
 
@@ -115,10 +110,8 @@ SettingsError setInt32( std::string section,
                         std::string customErrorMsg )
 {
     vr::EVRSettingsError error;
-    vr::VRSettings()->SetInt32( section.c_str(),
-                                settingsKey.c_str(),
-                                static_cast<int32_t>( value ),
-                                &error );
+    settingsCache().setInt32(
+        section, settingsKey, static_cast<int32_t>( value ), &error );
     return handleErrors( settingsKey, error, customErrorMsg );
 }
 
@@ -128,26 +121,24 @@ SettingsError setFloat( std::string section,
                         std::string customErrorMsg )
 {
     vr::EVRSettingsError error;
-    vr::VRSettings()->SetFloat(
-        section.c_str(), settingsKey.c_str(), value, &error );
+    settingsCache().setFloat( section, settingsKey, value, &error );
     return handleErrors( settingsKey, error, customErrorMsg );
 }
 
 SettingsError setString( std::string section,
                          std::string settingsKey,
-                         char* value,
+                         std::string value,
                          std::string customErrorMsg )
 {
     vr::EVRSettingsError error;
-    vr::VRSettings()->SetString(
-        section.c_str(), settingsKey.c_str(), value, &error );
+    settingsCache().setString( section, settingsKey, value, &error );
     return handleErrors( settingsKey, error, customErrorMsg );
 }
 
 SettingsError removeSection( std::string section, std::string customErrorMsg )
 {
     vr::EVRSettingsError error;
-    vr::VRSettings()->RemoveSection( section.c_str(), &error );
+    settingsCache().removeSection( section, &error );
     return handleErrors( "section", error, customErrorMsg );
 }
 
@@ -156,8 +147,7 @@ SettingsError removeKeyInSection( std::string section,
                                   std::string customErrorMsg )
 {
     vr::EVRSettingsError error;
-    vr::VRSettings()->RemoveKeyInSection(
-        section.c_str(), settingsKey.c_str(), &error );
+    settingsCache().removeKeyInSection( section, settingsKey, &error );
     return handleErrors( settingsKey, error, customErrorMsg );
 }
 
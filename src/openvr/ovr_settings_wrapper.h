@@ -5,10 +5,13 @@
 #include <string>
 #include <easylogging++.h>
 #include <utility>
+#include "ovr_settings_cache.h"
 
 /* Wrapper For OpenVR's IVR settings class, allows us to do our error logging
  * while also minimizing code
  *
+ * All reads and writes go through settingsCache(), so polling the same key
+ * every tick only costs an IPC call when the value may have changed.
  */
 namespace ovr_settings_wrapper
 {
@@ -51,7 +54,7 @@ SettingsError setFloat( std::string section,
                         std::string customErrorMsg = "" );
 SettingsError setString( std::string section,
                          std::string settingsKey,
-                         char* value,
+                         std::string value,
                          std::string customErrorMsg = "" );
 
 SettingsError removeSection( std::string section,
@@ -66,5 +69,9 @@ SettingsError handleErrors( std::string settingsKey,
 
 extern bool unsetSettingErrorEnabled;
 
+// Cache used by the functions above. Code that calls it directly instead of
+// going through them does its own error handling.
+SettingsCache& settingsCache();
+
 void resetAllSettings();
 } // namespace ovr_settings_wrapper
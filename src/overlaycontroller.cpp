@@ -18,14 +18,20 @@
 #include <QQuickRenderTarget>
 #include <QQuickGraphicsDevice>
 #include <iostream>
+#include <chrono>
 #include <cmath>
 #include <openvr.h>
 #include <easylogging++.h>
 #include "utils/Matrix.h"
 #include "keyboard_input/input_sender.h"
 #include "settings/settings.h"
+#include "settings/settings_object.h"
+#include "control_socket/control_commands.h"
+#include "utils/startup_profiler.h"
+#include "utils/startup_tasks.h"
 void BoundrySyncStart(vr::IVRSystem* vr,advsettings::MoveCenterTabController* moveCenterTabController);
 void BoundrySyncStop();
+void BoundrySyncPushPoses(const vr::TrackedDevicePose_t* devicePoses);
 // application namespace
 namespace advsettings
 {
@@ -51,6 +57,27 @@ OverlayController::OverlayController( bool desktopMode,
           settings::IntSetting::APPLICATION_customTickRateMs ) ) ),
       m_actions(), m_alarm()
 {
+    // Reading the profile indexes is file IO that doesn't need the main
+    // thread, it runs while the main thread sets up OpenGL and OpenVR.
+    // Everything else here uses QObjects or OpenVR state owned by the main
+    // thread, so does moving old profiles out of the shared QSettings.
+    settings::migrateProfileStore();
+    utils::StartupTasks startupTasks;
+    const auto profileStore = startupTasks.add(
+        "profile store", [] { settings::preloadProfileStore(); } );
+    startupTasks.add(
+        "chaperone profiles",
+        [this] { m_chaperoneTabController.reloadChaperoneProfiles(); },
+        { profileStore } );
+    startupTasks.add(
+        "offset profiles",
+        [this] { m_moveCenterTabController.reloadOffsetProfiles(); },
+        { profileStore } );
+    startupTasks.add(
+        "video profiles",
+        [this] { m_videoTabController.reloadVideoProfiles(); },
+        { profileStore } );
+
     // Arbitrarily chosen Max Length of Directory path, should be sufficient for
     // Any set-up
     const uint32_t maxLength = 16192;
@@ -137,16 +164,18 @@ OverlayController::OverlayController( bool desktopMode,
     format.setStencilBufferSize( 8 );
     format.setSamples( 16 );
 
-    m_openGLContext.setFormat( format );
-    if ( !m_openGLContext.create() )
-    {
-        throw std::runtime_error( "Could not create OpenGL context" );
-    }
+    utils::timedPhase( "opengl context", [this, &format] {
+        m_openGLContext.setFormat( format );
+        if ( !m_openGLContext.create() )
+        {
+            throw std::runtime_error( "Could not create OpenGL context" );
+        }
 
-    // create an offscreen surface to attach the context and FBO to
-    m_offscreenSurface.setFormat( m_openGLContext.format() );
-    m_offscreenSurface.create();
-    m_openGLContext.makeCurrent( &m_offscreenSurface );
+        // create an offscreen surface to attach the context and FBO to
+        m_offscreenSurface.setFormat( m_openGLContext.format() );
+        m_offscreenSurface.create();
+        m_openGLContext.makeCurrent( &m_offscreenSurface );
+    } );
 
     if ( !vr::VROverlay() )
     {
@@ -156,13 +185,20 @@ OverlayController::OverlayController( bool desktopMode,
     }
 
     // Init controllers
-    m_steamVRTabController.initStage1();
-    m_chaperoneTabController.initStage1();
-    m_moveCenterTabController.initStage1();
-    m_audioTabController.initStage1();
-    m_settingsTabController.initStage1();
-    m_videoTabController.initStage1();
-    m_rotationTabController.initStage1();
+    utils::timedPhase( "steamvr init",
+                       [this] { m_steamVRTabController.initStage1(); } );
+    utils::timedPhase( "chaperone init",
+                       [this] { m_chaperoneTabController.initStage1(); } );
+    utils::timedPhase( "offsets init",
+                       [this] { m_moveCenterTabController.initStage1(); } );
+    utils::timedPhase( "audio init",
+                       [this] { m_audioTabController.initStage1(); } );
+    utils::timedPhase( "settings init",
+                       [this] { m_settingsTabController.initStage1(); } );
+    utils::timedPhase( "video init",
+                       [this] { m_videoTabController.initStage1(); } );
+    utils::timedPhase( "rotation init",
+                       [this] { m_rotationTabController.initStage1(); } );
     BoundrySyncStart(vr::VRSystem(),&m_moveCenterTabController);
 
     // init action handles
@@ -353,6 +389,18 @@ OverlayController::OverlayController( bool desktopMode,
 
     LOG( INFO ) << "OPENSSL VERSION: "
                 << QSslSocket::sslLibraryBuildVersionString();
+
+    // The profile lists are used from here on.
+    utils::timedPhase( "wait for startup tasks", [&startupTasks] {
+        try
+        {
+            startupTasks.waitAll();
+        }
+        catch ( const std::exception& e )
+        {
+            LOG( ERROR ) << "Could not load profiles: " << e.what();
+        }
+    } );
 }
 
 OverlayController::~OverlayController()
@@ -374,6 +422,11 @@ void OverlayController::exitApp()
     m_audioTabController.shutdown();
     m_chaperoneTabController.shutdown();
 
+    LOG( INFO ) << "OpenVR settings cache: "
+                << ovr_settings_wrapper::settingsCache().hits() << " hits, "
+                << ovr_settings_wrapper::settingsCache().misses()
+                << " misses.";
+
     Shutdown();
     qInstallMessageHandler(nullptr);
     QApplication::exit();
@@ -390,6 +443,7 @@ void OverlayController::Shutdown()
                 this,
                 SLOT( OnTimeoutPumpEvents() ) );
     m_pumpEventsTimer.stop();
+    m_controlServer.reset();
 
     if ( m_pRenderTimer )
     {
@@ -527,16 +581,24 @@ void OverlayController::SetWidget( QQuickItem* quickItem,
 
     m_pumpEventsTimer.start();
 
-    m_steamVRTabController.initStage2( this );
-    m_chaperoneTabController.initStage2( this );
-    m_fixFloorTabController.initStage2( this );
-    m_audioTabController.initStage2();
-    m_statisticsTabController.initStage2( this );
-    m_settingsTabController.initStage2( this );
-    m_utilitiesTabController.initStage2( this );
-    m_moveCenterTabController.initStage2( this );
-    m_rotationTabController.initStage2( this );
-    m_videoTabController.initStage2();
+    utils::timedPhase( "controllers stage 2", [this] {
+        m_steamVRTabController.initStage2( this );
+        m_chaperoneTabController.initStage2( this );
+        m_fixFloorTabController.initStage2( this );
+        m_audioTabController.initStage2();
+        m_statisticsTabController.initStage2( this );
+        m_settingsTabController.initStage2( this );
+        m_utilitiesTabController.initStage2( this );
+        m_moveCenterTabController.initStage2( this );
+        m_rotationTabController.initStage2( this );
+        m_videoTabController.initStage2();
+    } );
+
+    connect( &m_settingsFileWatcher,
+             SIGNAL( settingsChanged( settings::SettingValues ) ),
+             this,
+             SLOT( applyExternalSettings( settings::SettingValues ) ) );
+    m_settingsFileWatcher.watch( settings::initializeAndGetSettingsPath() );
 
     if ( autoApplyChaperoneEnabled() )
     {
@@ -758,7 +820,7 @@ void OverlayController::processKeyboardBindings()
         const auto commands = settings::getSetting(
             settings::StringSetting::KEYBOARDSHORTCUT_keyboardOne );
 
-        sendStringAsInput( commands );
+        sendMacro( m_keyboardOneMacro.get( commands ) );
     }
 
     if ( m_actions.keyboardTwo() )
@@ -766,7 +828,7 @@ void OverlayController::processKeyboardBindings()
         const auto commands = settings::getSetting(
             settings::StringSetting::KEYBOARDSHORTCUT_keyboardTwo );
 
-        sendStringAsInput( commands );
+        sendMacro( m_keyboardTwoMacro.get( commands ) );
     }
 
     if ( m_actions.keyboardThree() )
@@ -774,21 +836,23 @@ void OverlayController::processKeyboardBindings()
         const auto commands = settings::getSetting(
             settings::StringSetting::KEYBOARDSHORTCUT_keyboardThree );
 
-        sendStringAsInput( commands );
+        sendMacro( m_keyboardThreeMacro.get( commands ) );
     }
     // Press Key One
     if ( m_actions.keyPressMisc() && !m_keyPressOneState )
     {
         const auto commands = settings::getSetting(
             settings::StringSetting::KEYBOARDSHORTCUT_keyPressMisc );
-        sendFirstCharAsInput( commands, KeyStatus::Down );
+        sendMacroKey( m_keyPressMiscMacro.get( commands ).firstKeyCode,
+                      KeyStatus::Down );
         m_keyPressOneState = true;
     }
     if ( m_keyPressOneState && !m_actions.keyPressMisc() )
     {
         const auto commands = settings::getSetting(
             settings::StringSetting::KEYBOARDSHORTCUT_keyPressMisc );
-        sendFirstCharAsInput( commands, KeyStatus::Up );
+        sendMacroKey( m_keyPressMiscMacro.get( commands ).firstKeyCode,
+                      KeyStatus::Up );
         m_keyPressOneState = false;
     }
 
@@ -797,14 +861,16 @@ void OverlayController::processKeyboardBindings()
     {
         const auto commands = settings::getSetting(
             settings::StringSetting::KEYBOARDSHORTCUT_keyPressSystem );
-        sendFirstCharAsInput( commands, KeyStatus::Down );
+        sendMacroKey( m_keyPressSystemMacro.get( commands ).firstKeyCode,
+                      KeyStatus::Down );
         m_keyPressTwoState = true;
     }
     if ( m_keyPressTwoState && !m_actions.keyPressSystem() )
     {
         const auto commands = settings::getSetting(
             settings::StringSetting::KEYBOARDSHORTCUT_keyPressSystem );
-        sendFirstCharAsInput( commands, KeyStatus::Up );
+        sendMacroKey( m_keyPressSystemMacro.get( commands ).firstKeyCode,
+                      KeyStatus::Up );
         m_keyPressTwoState = false;
     }
 }
@@ -1124,6 +1190,8 @@ void OverlayController::mainEventLoop()
     if ( !vr::VRSystem() )
         return;
 
+    const auto tickStart = std::chrono::steady_clock::now();
+
     m_actions.UpdateStates();
 
     processInputBindings();
@@ -1132,6 +1200,7 @@ void OverlayController::mainEventLoop()
     bool chaperoneDataAlreadyUpdated = false;
     while ( pollNextEvent( m_ulOverlayHandle, &vrEvent ) )
     {
+        ovr_settings_wrapper::settingsCache().handleEvent( vrEvent.eventType );
         switch ( vrEvent.eventType )
         {
         case vr::VREvent_MouseMove:
@@ -1239,6 +1308,12 @@ void OverlayController::mainEventLoop()
         }
         break;
 
+        case vr::VREvent_SceneApplicationChanged:
+        {
+            m_audioTabController.onSceneApplicationChanged();
+        }
+        break;
+
         case vr::VREvent_KeyboardDone:
         {
             char keyboardBuffer[1024];
@@ -1311,6 +1386,8 @@ void OverlayController::mainEventLoop()
         devicePoses,
         vr::k_unMaxTrackedDeviceCount );
 
+    BoundrySyncPushPoses( devicePoses );
+
     // HMD/Controller Velocities
     auto leftId = vr::VRSystem()->GetTrackedDeviceIndexForControllerRole(
         vr::TrackedControllerRole_LeftHand );
@@ -1342,6 +1419,12 @@ void OverlayController::mainEventLoop()
     m_statisticsTabController.eventLoopTick(
         devicePoses, leftSpeed, rightSpeed );
     m_chaperoneTabController.eventLoopTick( universe, devicePoses );
+    audio_rules::Frame audioRulesFrame;
+    audioRulesFrame.hmdPresent = m_actions.proxState();
+    audioRulesFrame.dashboardOpen = m_dashboardVisible;
+    audioRulesFrame.chaperoneDistance
+        = m_chaperoneTabController.chaperoneDistance();
+    m_audioTabController.evaluateAudioRules( audioRulesFrame );
     m_audioTabController.eventLoopTick();
     m_rotationTabController.eventLoopTick( devicePoses );
 
@@ -1371,6 +1454,30 @@ void OverlayController::mainEventLoop()
             }
         }
     }
+
+    if ( m_controlServer )
+    {
+        m_controlServer->processPending(
+            [this]( const control_socket::Request& request ) {
+                return control_socket::runCommand( *this, request );
+            } );
+    }
+
+    m_statisticsTabController.noteOverlayTick(
+        tickStart, std::chrono::steady_clock::now() - tickStart );
+
+    utils::startupProfiler().markFirstFrame();
+}
+
+void OverlayController::startControlServer( const std::string& path )
+{
+    auto server = std::make_unique<control_socket::ControlServer>( path );
+    if ( !server->start() )
+    {
+        LOG( ERROR ) << "Control socket disabled.";
+        return;
+    }
+    m_controlServer = std::move( server );
 }
 
 void OverlayController::RotateUniverseCenter(
@@ -1612,7 +1719,7 @@ void OverlayController::setDesktopModeToggle( bool value, bool notify )
     {
         emit desktopModeToggleChanged( value );
     }
-    settings::saveAllSettings();
+    settings::saveChangedSettings();
 }
 bool OverlayController::desktopModeToggle() const
 {
@@ -1620,6 +1727,341 @@ bool OverlayController::desktopModeToggle() const
         settings::BoolSetting::APPLICATION_desktopModeToggle );
 }
 
+void OverlayController::applyExternalSettings(
+    const settings::SettingValues& changes )
+{
+    for ( const auto& [setting, value] : changes.bools )
+    {
+        applyExternalSetting( setting, value );
+    }
+    for ( const auto& [setting, value] : changes.doubles )
+    {
+        applyExternalSetting( setting, value );
+    }
+    for ( const auto& [setting, value] : changes.ints )
+    {
+        applyExternalSetting( setting, value );
+    }
+    for ( const auto& [setting, value] : changes.strings )
+    {
+        applyExternalSetting( setting, value );
+    }
+    settings::saveChangedSettings();
+}
+
+void OverlayController::applyExternalSetting(
+    const settings::BoolSetting setting,
+    const bool value )
+{
+    using settings::BoolSetting;
+    switch ( setting )
+    {
+    case BoolSetting::PLAYSPACE_lockXToggle:
+        m_moveCenterTabController.setLockX( value );
+        break;
+    case BoolSetting::PLAYSPACE_lockYToggle:
+        m_moveCenterTabController.setLockY( value );
+        break;
+    case BoolSetting::PLAYSPACE_lockZToggle:
+        m_moveCenterTabController.setLockZ( value );
+        break;
+    case BoolSetting::PLAYSPACE_momentumSave:
+        m_moveCenterTabController.setMomentumSave( value );
+        break;
+    case BoolSetting::PLAYSPACE_turnBindLeft:
+        m_moveCenterTabController.setTurnBindLeft( value );
+        break;
+    case BoolSetting::PLAYSPACE_turnBindRight:
+        m_moveCenterTabController.setTurnBindRight( value );
+        break;
+    case BoolSetting::PLAYSPACE_turnBounds:
+        m_moveCenterTabController.setTurnBounds( value );
+        break;
+    case BoolSetting::PLAYSPACE_moveShortcutLeft:
+        m_moveCenterTabController.setMoveShortcutLeft( value );
+        break;
+    case BoolSetting::PLAYSPACE_moveShortcutRight:
+        m_moveCenterTabController.setMoveShortcutRight( value );
+        break;
+    case BoolSetting::PLAYSPACE_dragBounds:
+        m_moveCenterTabController.setDragBounds( value );
+        break;
+    case BoolSetting::PLAYSPACE_showLogMatricesButton:
+        m_moveCenterTabController.setShowLogMatricesButton( value );
+        break;
+    case BoolSetting::PLAYSPACE_universeCenteredRotation:
+        m_moveCenterTabController.setUniverseCenteredRotation( value );
+        break;
+
+    case BoolSetting::APPLICATION_disableVersionCheck:
+        setDisableVersionCheck( value );
+        break;
+    case BoolSetting::APPLICATION_vsyncDisabled:
+        setVsyncDisabled( value );
+        break;
+    case BoolSetting::APPLICATION_enableDebug:
+        setEnableDebug( value );
+        break;
+    case BoolSetting::APPLICATION_enableExclusiveInput:
+        setExclusiveInputEnabled( value );
+        break;
+    case BoolSetting::APPLICATION_crashRecoveryDisabled2:
+        setCrashRecoveryDisabled( value );
+        break;
+    case BoolSetting::APPLICATION_autoApplyChaperone:
+        setAutoApplyChaperoneEnabled( value );
+        break;
+    case BoolSetting::APPLICATION_desktopModeToggle:
+        setDesktopModeToggle( value );
+        break;
+    case BoolSetting::APPLICATION_sessionRecordingEnabled:
+        m_statisticsTabController.setSessionRecordingEnabled( value );
+        break;
+
+    case BoolSetting::AUDIO_pttEnabled:
+        m_audioTabController.setPttEnabled( value );
+        break;
+    case BoolSetting::AUDIO_pttShowNotification:
+        m_audioTabController.setPttShowNotification( value );
+        break;
+    case BoolSetting::AUDIO_micProximitySensorCanMute:
+        m_audioTabController.setMicProximitySensorCanMute( value );
+        break;
+    case BoolSetting::AUDIO_micReversePtt:
+        m_audioTabController.setMicReversePtt( value );
+        break;
+
+    case BoolSetting::UTILITY_alarmEnabled:
+        m_alarm.setAlarmEnabled( value );
+        break;
+    case BoolSetting::UTILITY_vrcDebug:
+        m_utilitiesTabController.setVrcDebug( value );
+        break;
+    case BoolSetting::UTILITY_trackerOverlayEnabled:
+        m_utilitiesTabController.setTrackerOvlEnabled( value );
+        break;
+    case BoolSetting::UTILITY_nowPlayingOverlayEnabled:
+        m_utilitiesTabController.setNowPlayingOvlEnabled( value );
+        break;
+
+    case BoolSetting::VIDEO_brightnessEnabled:
+        m_videoTabController.setBrightnessEnabled( value );
+        break;
+    case BoolSetting::VIDEO_isOverlayMethodActive:
+        m_videoTabController.setIsOverlayMethodActive( value );
+        break;
+    case BoolSetting::VIDEO_colorOverlayEnabled:
+        m_videoTabController.setColorOverlayEnabled( value );
+        break;
+
+    case BoolSetting::CHAPERONE_chaperoneSwitchToBeginnerEnabled:
+        m_chaperoneTabController.setChaperoneSwitchToBeginnerEnabled( value );
+        break;
+    case BoolSetting::CHAPERONE_chaperoneHapticFeedbackEnabled:
+        m_chaperoneTabController.setChaperoneHapticFeedbackEnabled( value );
+        break;
+    case BoolSetting::CHAPERONE_chaperoneAlarmSoundEnabled:
+        m_chaperoneTabController.setChaperoneAlarmSoundEnabled( value );
+        break;
+    case BoolSetting::CHAPERONE_chaperoneAlarmSoundLooping:
+        m_chaperoneTabController.setChaperoneAlarmSoundLooping( value );
+        break;
+    case BoolSetting::CHAPERONE_chaperoneAlarmSoundAdjustVolume:
+        m_chaperoneTabController.setChaperoneAlarmSoundAdjustVolume( value );
+        break;
+    case BoolSetting::CHAPERONE_chaperoneShowDashboardEnabled:
+        m_chaperoneTabController.setChaperoneShowDashboardEnabled( value );
+        break;
+    case BoolSetting::CHAPERONE_disableChaperone:
+        m_chaperoneTabController.setDisableChaperone( value );
+        break;
+    case BoolSetting::CHAPERONE_centerMarkerNew:
+        m_chaperoneTabController.setCenterMarkerNew( value );
+        break;
+
+    case BoolSetting::ROTATION_autoturnEnabled:
+        m_rotationTabController.setAutoTurnEnabled( value );
+        break;
+    case BoolSetting::ROTATION_autoturnUseCornerAngle:
+        m_rotationTabController.setAutoTurnUseCornerAngle( value );
+        break;
+    case BoolSetting::ROTATION_autoturnVestibularMotionEnabled:
+        m_rotationTabController.setVestibularMotionEnabled( value );
+        break;
+    case BoolSetting::ROTATION_autoturnViewRatchettingEnabled:
+        m_rotationTabController.setViewRatchettingEnabled( value );
+        break;
+    case BoolSetting::ROTATION_autoturnShowNotification:
+        m_rotationTabController.setAutoTurnShowNotification( value );
+        break;
+
+    case BoolSetting::STEAMVR_perappBindEnabled:
+        m_steamVRTabController.setPerAppBindEnabled( value );
+        break;
+
+    default:
+        // Only read when used, so storing the value is enough.
+        settings::setSetting( setting, value );
+        break;
+    }
+}
+
+void OverlayController::applyExternalSetting(
+    const settings::DoubleSetting setting,
+    const double value )
+{
+    using settings::DoubleSetting;
+    const auto floatValue = static_cast<float>( value );
+    switch ( setting )
+    {
+    case DoubleSetting::PLAYSPACE_heightToggleOffset:
+        m_moveCenterTabController.setHeightToggleOffset( floatValue );
+        break;
+    case DoubleSetting::PLAYSPACE_gravityStrength:
+        m_moveCenterTabController.setGravityStrength( floatValue );
+        break;
+    case DoubleSetting::PLAYSPACE_flingStrength:
+        m_moveCenterTabController.setFlingStrength( floatValue );
+        break;
+    case DoubleSetting::PLAYSPACE_dragMult:
+        m_moveCenterTabController.setDragMult( floatValue );
+        break;
+
+    case DoubleSetting::APPLICATION_appVolume:
+        setSoundVolume( value );
+        break;
+
+    case DoubleSetting::VIDEO_brightnessOpacityValue:
+        m_videoTabController.setBrightnessOpacityValue( floatValue );
+        break;
+    case DoubleSetting::VIDEO_colorOverlayOpacity:
+        m_videoTabController.setColorOverlayOpacity( floatValue );
+        break;
+    case DoubleSetting::VIDEO_colorRed:
+        m_videoTabController.setColorRed( floatValue );
+        break;
+    case DoubleSetting::VIDEO_colorGreen:
+        m_videoTabController.setColorGreen( floatValue );
+        break;
+    case DoubleSetting::VIDEO_colorBlue:
+        m_videoTabController.setColorBlue( floatValue );
+        break;
+
+    case DoubleSetting::CHAPERONE_switchToBeginnerDistance:
+        m_chaperoneTabController.setChaperoneSwitchToBeginnerDistance(
+            floatValue );
+        break;
+    case DoubleSetting::CHAPERONE_hapticFeedbackDistance:
+        m_chaperoneTabController.setChaperoneHapticFeedbackDistance(
+            floatValue );
+        break;
+    case DoubleSetting::CHAPERONE_alarmSoundDistance:
+        m_chaperoneTabController.setChaperoneAlarmSoundDistance( floatValue );
+        break;
+    case DoubleSetting::CHAPERONE_showDashboardDistance:
+        m_chaperoneTabController.setChaperoneShowDashboardDistance(
+            floatValue );
+        break;
+    case DoubleSetting::CHAPERONE_dimHeight:
+        m_chaperoneTabController.setChaperoneDimHeight( floatValue );
+        break;
+
+    case DoubleSetting::ROTATION_activationDistance:
+        m_rotationTabController.setAutoTurnActivationDistance( floatValue );
+        break;
+    case DoubleSetting::ROTATION_deactivateDistance:
+        m_rotationTabController.setAutoTurnDeactivationDistance( floatValue );
+        break;
+    case DoubleSetting::ROTATION_cordDetanglingAngle:
+        m_rotationTabController.setCordDetangleAngle( value );
+        break;
+    case DoubleSetting::ROTATION_autoturnMinCordTangle:
+        m_rotationTabController.setMinCordTangle( value );
+        break;
+    case DoubleSetting::ROTATION_autoturnVestibularMotionRadius:
+        m_rotationTabController.setVestibularMotionRadius( value );
+        break;
+    case DoubleSetting::ROTATION_autoturnViewRatchettingPercent:
+        m_rotationTabController.setViewRatchettingPercent( value );
+        break;
+
+    default:
+        settings::setSetting( setting, value );
+        break;
+    }
+}
+
+void OverlayController::applyExternalSetting(
+    const settings::IntSetting setting,
+    const int value )
+{
+    using settings::IntSetting;
+    switch ( setting )
+    {
+    case IntSetting::PLAYSPACE_snapTurnAngle:
+        m_moveCenterTabController.setSnapTurnAngle( value );
+        break;
+    case IntSetting::PLAYSPACE_smoothTurnRate:
+        m_moveCenterTabController.setSmoothTurnRate( value );
+        break;
+    case IntSetting::PLAYSPACE_dragComfortFactor:
+        m_moveCenterTabController.setDragComfortFactor( value );
+        break;
+    case IntSetting::PLAYSPACE_turnComfortFactor:
+        m_moveCenterTabController.setTurnComfortFactor( value );
+        break;
+    case IntSetting::PLAYSPACE_frictionPercent:
+        m_moveCenterTabController.setFrictionPercent( value );
+        break;
+
+    case IntSetting::APPLICATION_debugState:
+        setDebugState( value );
+        break;
+    case IntSetting::APPLICATION_customTickRateMs:
+        setCustomTickRateMs( value );
+        break;
+
+    // The alarm keeps its own copy of the time.
+    case IntSetting::UTILITY_alarmHour:
+        m_alarm.setAlarmTime(
+            value, m_alarm.getAlarmMinute(), m_alarm.getAlarmSecond() );
+        break;
+    case IntSetting::UTILITY_alarmMinute:
+        m_alarm.setAlarmTime(
+            m_alarm.getAlarmHour(), value, m_alarm.getAlarmSecond() );
+        break;
+    case IntSetting::UTILITY_alarmSecond:
+        m_alarm.setAlarmTime(
+            m_alarm.getAlarmHour(), m_alarm.getAlarmMinute(), value );
+        break;
+
+    case IntSetting::ROTATION_autoturnLinearTurnSpeed:
+        m_rotationTabController.setAutoTurnSpeed( value );
+        break;
+    case IntSetting::ROTATION_autoturnMode:
+        m_rotationTabController.setAutoTurnMode( value );
+        break;
+
+    default:
+        settings::setSetting( setting, value );
+        break;
+    }
+}
+
+void OverlayController::applyExternalSetting(
+    const settings::StringSetting setting,
+    const std::string& value )
+{
+    if ( setting == settings::StringSetting::AUDIO_rules )
+    {
+        m_audioTabController.setAudioRules( QString::fromStdString( value ) );
+        return;
+    }
+    // Keyboard shortcuts and the auto apply profile name are read when
+    // they are used, there is nothing else to update.
+    settings::setSetting( setting, value );
+}
+
 void OverlayController::playActivationSound()
 {
     if ( !m_noSound )
@@ -44,6 +44,12 @@
 
 #include "alarm_clock/vr_alarm.h"
 
+#include "keyboard_input/input_sender.h"
+
+#include "settings/settings_file_watcher.h"
+
+#include "control_socket/control_server.h"
+
 #include "utils/update_rate.h"
 
 namespace application_strings
@@ -150,6 +156,10 @@ class OverlayController : public QObject
 
     alarm_clock::VrAlarm m_alarm;
 
+    settings::SettingsFileWatcher m_settingsFileWatcher;
+
+    std::unique_ptr<control_socket::ControlServer> m_controlServer;
+
     QNetworkAccessManager* netManager = new QNetworkAccessManager( this );
     QJsonDocument m_remoteVersionJsonDocument = QJsonDocument();
     QJsonObject m_remoteVersionJsonObject;
@@ -179,10 +189,29 @@ class OverlayController : public QObject
     void processRotationBindings();
     void processExclusiveInputBinding();
 
+    // Apply a value changed in the settings file through the setter that
+    // owns it, so side effects and change notifications happen as if it was
+    // changed in the UI.
+    void applyExternalSetting( const settings::BoolSetting setting,
+                               const bool value );
+    void applyExternalSetting( const settings::DoubleSetting setting,
+                               const double value );
+    void applyExternalSetting( const settings::IntSetting setting,
+                               const int value );
+    void applyExternalSetting( const settings::StringSetting setting,
+                               const std::string& value );
+
     bool m_exclusiveState = false;
     bool m_keyPressOneState = false;
     bool m_keyPressTwoState = false;
 
+    // Compiled on first use and again whenever the shortcut setting changed.
+    keyboard_macro::MacroCache m_keyboardOneMacro{ resolveKeyCode };
+    keyboard_macro::MacroCache m_keyboardTwoMacro{ resolveKeyCode };
+    keyboard_macro::MacroCache m_keyboardThreeMacro{ resolveKeyCode };
+    keyboard_macro::MacroCache m_keyPressMiscMacro{ resolveKeyCode };
+    keyboard_macro::MacroCache m_keyPressSystemMacro{ resolveKeyCode };
+
 public:
     OverlayController( bool desktopMode, bool noSound, QQmlEngine& qmlEngine );
     virtual ~OverlayController();
@@ -236,6 +265,10 @@ class OverlayController : public QObject
                         vr::VREvent_t* pEvent );
     void mainEventLoop();
 
+    // Accepts commands on the local control socket at path. They are run by
+    // mainEventLoop().
+    void startControlServer( const std::string& path );
+
     bool crashRecoveryDisabled() const;
     bool exclusiveInputEnabled() const;
     bool autoApplyChaperoneEnabled() const;
@@ -279,6 +312,8 @@ public slots:
     void setSoundVolume( double value, bool notify = true );
     void setDesktopModeToggle( bool value, bool notify = true );
 
+    void applyExternalSettings( const settings::SettingValues& changes );
+
 signals:
     void keyBoardInputSignal( QString input, unsigned long userValue = 0 );
     void crashRecoveryDisabledChanged( bool value );
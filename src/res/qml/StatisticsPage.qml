@@ -190,10 +190,225 @@ MyStackViewPage {
                 }
             }
         }
+
+        GridLayout {
+            columns: 4
+            Layout.topMargin: 32
+
+            MyText {
+                text: "Percentiles (p50 / p95 / p99):"
+            }
+
+            MyText {
+                text: "1 min"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                text: "5 min"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                text: "60 min"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                text: "Dropped Frames/s:"
+            }
+
+            MyText {
+                id: statsTimeSeriesDropped1mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                id: statsTimeSeriesDropped5mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                id: statsTimeSeriesDropped60mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                text: "Reprojected Frames/s:"
+            }
+
+            MyText {
+                id: statsTimeSeriesReprojected1mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                id: statsTimeSeriesReprojected5mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                id: statsTimeSeriesReprojected60mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                text: "HMD Speed (m/s):"
+            }
+
+            MyText {
+                id: statsTimeSeriesHmdSpeed1mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                id: statsTimeSeriesHmdSpeed5mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyText {
+                id: statsTimeSeriesHmdSpeed60mText
+                text: "-"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyPushButton {
+                text: "Reset"
+                Layout.columnSpan: 4
+                Layout.alignment: Qt.AlignRight
+                onClicked: {
+                    StatisticsTabController.timeSeriesResetClicked()
+                }
+            }
+        }
+        GridLayout {
+            columns: 3
+            Layout.topMargin: 32
+
+            MyText {
+                text: "Avg. GPU Frame Time:"
+            }
+
+            MyText {
+                id: statsAverageFrameGpuText
+                text: "0.0 ms"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            Item {
+                Layout.preferredWidth: 1
+            }
+
+            MyText {
+                text: "Reprojection Streaks (Longest):"
+            }
+
+            MyText {
+                id: statsReprojectionStreaksText
+                text: "0 (0)"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            Item {
+                Layout.preferredWidth: 1
+            }
+
+            MyText {
+                text: "Frame Time Spikes:"
+            }
+
+            MyText {
+                id: statsFrameTimingSpikesText
+                text: "0"
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+
+            MyPushButton {
+                text: "Reset"
+                onClicked: {
+                    StatisticsTabController.frameTimingResetClicked()
+                }
+            }
+
+            MyText {
+                id: statsLastSpikeText
+                text: ""
+                Layout.columnSpan: 3
+                Layout.fillWidth: true
+            }
+        }
+
+        RowLayout {
+            Layout.topMargin: 32
+
+            MyToggleButton {
+                id: sessionRecordingToggle
+                text: "Record Session to File"
+                onCheckedChanged: {
+                    StatisticsTabController.sessionRecordingEnabled = this.checked
+                }
+            }
+
+            MyText {
+                id: sessionRecordingPathText
+                text: StatisticsTabController.sessionRecordingPath
+                elide: Text.ElideLeft
+                Layout.fillWidth: true
+                horizontalAlignment: Text.AlignRight
+                Layout.rightMargin: 10
+            }
+        }
+
         Item {
             Layout.fillHeight: true
         }
 
+        function formatPercentiles(metric, window, decimals) {
+            var p = StatisticsTabController.timeSeriesPercentiles(metric, window)
+            if (p.length === 0 || p[4] === 0) {
+                return "-"
+            }
+            return p[0].toFixed(decimals) + " / " + p[1].toFixed(decimals) + " / " + p[2].toFixed(decimals)
+        }
+
         function updateStatistics() {
             statsHmdMovedText.text = StatisticsTabController.hmdDistanceMoved.toFixed(1) + " m"
             var rotations = StatisticsTabController.hmdRotations
@@ -209,6 +424,36 @@ MyStackViewPage {
             statsReprojectionFramesText.text = StatisticsTabController.reprojectedFrames
             statsTimedOutText.text = StatisticsTabController.timedOut
             statstotalRatioText.text = (StatisticsTabController.totalReprojectedRatio*100.0).toFixed(1) + "%"
+            statsAverageFrameGpuText.text = StatisticsTabController.averageFrameGpuMs.toFixed(1) + " ms"
+            statsReprojectionStreaksText.text = StatisticsTabController.reprojectionStreaks + " (" + StatisticsTabController.longestReprojectionStreak + ")"
+            statsFrameTimingSpikesText.text = StatisticsTabController.frameTimingSpikes
+            var spikes = StatisticsTabController.recentFrameTimingSpikes(1)
+            if (spikes.length > 0) {
+                statsLastSpikeText.text = "Last spike: " + spikes[0].gpuMs.toFixed(1) + " ms (baseline " + spikes[0].baselineMs.toFixed(1) + " ms, overlay tick " + spikes[0].overlayTickMs.toFixed(1) + " ms)"
+            } else {
+                statsLastSpikeText.text = ""
+            }
+            // Metric and window indices match statistics::Metric and statistics::Window
+            statsTimeSeriesDropped1mText.text = formatPercentiles(1, 0, 0)
+            statsTimeSeriesDropped5mText.text = formatPercentiles(1, 1, 0)
+            statsTimeSeriesDropped60mText.text = formatPercentiles(1, 2, 0)
+            statsTimeSeriesReprojected1mText.text = formatPercentiles(2, 0, 0)
+            statsTimeSeriesReprojected5mText.text = formatPercentiles(2, 1, 0)
+            statsTimeSeriesReprojected60mText.text = formatPercentiles(2, 2, 0)
+            statsTimeSeriesHmdSpeed1mText.text = formatPercentiles(4, 0, 1)
+            statsTimeSeriesHmdSpeed5mText.text = formatPercentiles(4, 1, 1)
+            statsTimeSeriesHmdSpeed60mText.text = formatPercentiles(4, 2, 1)
+        }
+
+        Component.onCompleted: {
+            sessionRecordingToggle.checked = StatisticsTabController.sessionRecordingEnabled
+        }
+
+        Connections {
+            target: StatisticsTabController
+            onSessionRecordingEnabledChanged: {
+                sessionRecordingToggle.checked = StatisticsTabController.sessionRecordingEnabled
+            }
         }
 
         Timer {
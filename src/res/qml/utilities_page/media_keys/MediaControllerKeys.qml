@@ -65,5 +65,24 @@ GroupBox {
                 }
             }
         }
+
+        MyToggleButton {
+            id: nowPlayingOvlToggle
+            text: "Show Now Playing In Headset"
+            onCheckedChanged: {
+                UtilitiesTabController.setNowPlayingOvlEnabled(this.checked, false)
+            }
+        }
+    }
+
+    Component.onCompleted: {
+        nowPlayingOvlToggle.checked = UtilitiesTabController.nowPlayingOvlEnabled
+    }
+
+    Connections {
+        target: UtilitiesTabController
+        onNowPlayingOvlEnabledChanged: {
+            nowPlayingOvlToggle.checked = UtilitiesTabController.nowPlayingOvlEnabled
+        }
     }
 }
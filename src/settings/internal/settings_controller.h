@@ -1,16 +1,533 @@
 #pragma once
-#include <assert.h>
 #include <array>
+#include <bitset>
+#include <cmath>
+#include <map>
 #include <vector>
 #include <easylogging++.h>
 #include "../settings.h"
-#include "setting_value.h"
-#include "../../utils/setup.h"
-#include "specific_setting_value.h"
+#include "settings_internal.h"
+#include "settings_writer.h"
 #include "../../tabcontrollers/MoveCenterTabController.h"
 
 namespace settings
 {
+/*!
+Declaration of a single setting: the key it is stored under and the value it
+has when the settings file doesn't contain it.
+
+The tables below are the only place settings are declared. They are built at
+compile time and their order is checked with static_assert, so a table that
+doesn't match its enum fails the build instead of exiting at startup.
+*/
+template <typename Setting, typename Default> struct SettingInfo
+{
+    Setting setting;
+    SettingCategory category;
+    const char* settingName;
+    Default defaultValue;
+};
+
+using BoolSettingInfo = SettingInfo<BoolSetting, bool>;
+using DoubleSettingInfo = SettingInfo<DoubleSetting, double>;
+using IntSettingInfo = SettingInfo<IntSetting, int>;
+// Strings are stored as std::string, but that can't be constexpr.
+using StringSettingInfo = SettingInfo<StringSetting, const char*>;
+
+constexpr auto boolSettingSize
+    = static_cast<int>( BoolSetting::LAST_ENUMERATOR ) + 1;
+constexpr std::array<BoolSettingInfo, boolSettingSize> k_boolSettings{
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_lockXToggle,
+                     SettingCategory::Playspace,
+                     "lockXToggle",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_lockYToggle,
+                     SettingCategory::Playspace,
+                     "lockYToggle",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_lockZToggle,
+                     SettingCategory::Playspace,
+                     "lockZToggle",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_momentumSave,
+                     SettingCategory::Playspace,
+                     "momentumSave",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_turnBindLeft,
+                     SettingCategory::Playspace,
+                     "turnBindLeft",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_turnBindRight,
+                     SettingCategory::Playspace,
+                     "turnBindRight",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_turnBounds,
+                     SettingCategory::Playspace,
+                     "turnBounds",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_moveShortcutLeft,
+                     SettingCategory::Playspace,
+                     "moveShortcutLeft",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_moveShortcutRight,
+                     SettingCategory::Playspace,
+                     "moveShortcutRight",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_dragBounds,
+                     SettingCategory::Playspace,
+                     "dragBounds",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_allowExternalEdits,
+                     SettingCategory::Playspace,
+                     "allowExternalEdits",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_oldStyleMotion,
+                     SettingCategory::Playspace,
+                     "oldStyleMotion",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_universeCenteredRotation,
+                     SettingCategory::Playspace,
+                     "universeCenteredRotation",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_enableSeatedMotion,
+                     SettingCategory::Playspace,
+                     "enableSeatedMotion",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_adjustChaperone,
+                     SettingCategory::Playspace,
+                     "adjustChaperone",
+                     true },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_showLogMatricesButton,
+                     SettingCategory::Playspace,
+                     "showLogMatricesButton",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_simpleRecenter,
+                     SettingCategory::Playspace,
+                     "simpleRecenter",
+                     false },
+    // TODO Replace Back to Adjust Chaperone When Breaking Change is done.
+    // Needed New Setting defaulted to off w/ SVR 1.13.x release
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_adjustChaperone2,
+                     SettingCategory::Playspace,
+                     "adjustChaperone2",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_enableUncalMotion,
+                     SettingCategory::Playspace,
+                     "enableUncalMotion",
+                     false },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_adjustChaperone3,
+                     SettingCategory::Playspace,
+                     "adjustChaperone3",
+                     true },
+    BoolSettingInfo{ BoolSetting::PLAYSPACE_adjustChaperone4,
+                     SettingCategory::Playspace,
+                     "adjustChaperone4",
+                     false },
+
+    BoolSettingInfo{ BoolSetting::APPLICATION_disableVersionCheck,
+                     SettingCategory::Application,
+                     "disableVersionCheck",
+                     false },
+    BoolSettingInfo{ BoolSetting::APPLICATION_previousShutdownSafe,
+                     SettingCategory::Application,
+                     "previousShutdownSafe",
+                     true },
+    BoolSettingInfo{ BoolSetting::APPLICATION_vsyncDisabled,
+                     SettingCategory::Application,
+                     "vsyncDisabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::APPLICATION_crashRecoveryDisabled,
+                     SettingCategory::Application,
+                     "crashRecoveryDisabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::APPLICATION_enableDebug,
+                     SettingCategory::Application,
+                     "enableDebug",
+                     false },
+    BoolSettingInfo{ BoolSetting::APPLICATION_enableExclusiveInput,
+                     SettingCategory::Application,
+                     "enableExclusiveInput",
+                     false },
+    BoolSettingInfo{ BoolSetting::APPLICATION_crashRecoveryDisabled2,
+                     SettingCategory::Application,
+                     "crashRecoveryDisabled2",
+                     true },
+    BoolSettingInfo{ BoolSetting::APPLICATION_openXRWorkAround,
+                     SettingCategory::Application,
+                     "openXRWorkAround",
+                     false },
+    BoolSettingInfo{ BoolSetting::APPLICATION_autoApplyChaperone,
+                     SettingCategory::Application,
+                     "autoApplyChaperoneToggle",
+                     false },
+    BoolSettingInfo{ BoolSetting::APPLICATION_desktopModeToggle,
+                     SettingCategory::Application,
+                     "desktopModeToggle",
+                     false },
+    // Records the session to a file for offline analysis.
+    BoolSettingInfo{ BoolSetting::APPLICATION_sessionRecordingEnabled,
+                     SettingCategory::Application,
+                     "sessionRecordingEnabled",
+                     false },
+
+    BoolSettingInfo{ BoolSetting::AUDIO_pttEnabled,
+                     SettingCategory::Audio,
+                     "pttEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::AUDIO_pttShowNotification,
+                     SettingCategory::Audio,
+                     "pttShowNotification",
+                     false },
+    BoolSettingInfo{ BoolSetting::AUDIO_micProximitySensorCanMute,
+                     SettingCategory::Audio,
+                     "micProximitySensorCanMute",
+                     false },
+    BoolSettingInfo{ BoolSetting::AUDIO_micReversePtt,
+                     SettingCategory::Audio,
+                     "micReversePtt",
+                     false },
+
+    BoolSettingInfo{ BoolSetting::UTILITY_alarmEnabled,
+                     SettingCategory::Utility,
+                     "alarmEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::UTILITY_alarmIsModal,
+                     SettingCategory::Utility,
+                     "alarmIsModal",
+                     true },
+    BoolSettingInfo{ BoolSetting::UTILITY_vrcDebug,
+                     SettingCategory::Utility,
+                     "vrcDebug",
+                     false },
+    BoolSettingInfo{ BoolSetting::UTILITY_trackerOverlayEnabled,
+                     SettingCategory::Utility,
+                     "trackerOverlayEnabled",
+                     true },
+    BoolSettingInfo{ BoolSetting::UTILITY_nowPlayingOverlayEnabled,
+                     SettingCategory::Utility,
+                     "nowPlayingOverlayEnabled",
+                     false },
+
+    BoolSettingInfo{ BoolSetting::VIDEO_brightnessEnabled,
+                     SettingCategory::Video,
+                     "brightnessEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::VIDEO_isOverlayMethodActive,
+                     SettingCategory::Video,
+                     "isOverlayMethodActive",
+                     false },
+    BoolSettingInfo{ BoolSetting::VIDEO_colorOverlayEnabled,
+                     SettingCategory::Video,
+                     "colorOverlayEnabled",
+                     false },
+
+    BoolSettingInfo{ BoolSetting::CHAPERONE_chaperoneSwitchToBeginnerEnabled,
+                     SettingCategory::Chaperone,
+                     "chaperoneSwitchToBeginnerEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::CHAPERONE_chaperoneHapticFeedbackEnabled,
+                     SettingCategory::Chaperone,
+                     "chaperoneHapticFeedbackEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::CHAPERONE_chaperoneAlarmSoundEnabled,
+                     SettingCategory::Chaperone,
+                     "chaperoneAlarmSoundEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::CHAPERONE_chaperoneAlarmSoundLooping,
+                     SettingCategory::Chaperone,
+                     "chaperoneAlarmSoundLooping",
+                     true },
+    BoolSettingInfo{ BoolSetting::CHAPERONE_chaperoneAlarmSoundAdjustVolume,
+                     SettingCategory::Chaperone,
+                     "chaperoneAlarmSoundAdjustVolume",
+                     false },
+    BoolSettingInfo{ BoolSetting::CHAPERONE_chaperoneShowDashboardEnabled,
+                     SettingCategory::Chaperone,
+                     "chaperoneShowDashboardEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::CHAPERONE_disableChaperone,
+                     SettingCategory::Chaperone,
+                     "disableChaperone",
+                     false },
+    BoolSettingInfo{ BoolSetting::CHAPERONE_centerMarkerNew,
+                     SettingCategory::Chaperone,
+                     "centerMarkerNew",
+                     false },
+
+    BoolSettingInfo{ BoolSetting::ROTATION_autoturnEnabled,
+                     SettingCategory::Rotation,
+                     "autoturnEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::ROTATION_autoturnUseCornerAngle,
+                     SettingCategory::Rotation,
+                     "autoturnUseCornerAngle",
+                     true },
+    BoolSettingInfo{ BoolSetting::ROTATION_autoturnVestibularMotionEnabled,
+                     SettingCategory::Rotation,
+                     "autoturnVestibularMotionEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::ROTATION_autoturnViewRatchettingEnabled,
+                     SettingCategory::Rotation,
+                     "autoturnViewRatchettingEnabled",
+                     false },
+    BoolSettingInfo{ BoolSetting::ROTATION_autoturnShowNotification,
+                     SettingCategory::Rotation,
+                     "autoturnShowNotification",
+                     true },
+    BoolSettingInfo{ BoolSetting::STEAMVR_perappBindEnabled,
+                     SettingCategory::SteamVR,
+                     "perappBindEnabled",
+                     false },
+};
+
+constexpr auto doubleSettingSize
+    = static_cast<int>( DoubleSetting::LAST_ENUMERATOR ) + 1;
+constexpr std::array<DoubleSettingInfo, doubleSettingSize> k_doubleSettings{
+    DoubleSettingInfo{ DoubleSetting::PLAYSPACE_heightToggleOffset,
+                       SettingCategory::Playspace,
+                       "heightToggleOffset",
+                       -1.0 },
+    DoubleSettingInfo{ DoubleSetting::PLAYSPACE_gravityStrength,
+                       SettingCategory::Playspace,
+                       "gravityStrength",
+                       9.8 },
+    DoubleSettingInfo{ DoubleSetting::PLAYSPACE_flingStrength,
+                       SettingCategory::Playspace,
+                       "flingStrength",
+                       1.0 },
+    DoubleSettingInfo{ DoubleSetting::PLAYSPACE_dragMult,
+                       SettingCategory::Playspace,
+                       "dragMult",
+                       1.0 },
+
+    DoubleSettingInfo{ DoubleSetting::APPLICATION_appVolume,
+                       SettingCategory::Application,
+                       "appVolume",
+                       0.7 },
+
+    DoubleSettingInfo{ DoubleSetting::VIDEO_brightnessOpacityValue,
+                       SettingCategory::Video,
+                       "brightnessOpacityValue",
+                       1.0 },
+    DoubleSettingInfo{ DoubleSetting::VIDEO_colorOverlayOpacity,
+                       SettingCategory::Video,
+                       "colorOverlayOpacity",
+                       0.0 },
+    DoubleSettingInfo{ DoubleSetting::VIDEO_colorRed,
+                       SettingCategory::Video,
+                       "colorRedNew",
+                       1.0 },
+    DoubleSettingInfo{ DoubleSetting::VIDEO_colorGreen,
+                       SettingCategory::Video,
+                       "colorGreenNew",
+                       1.0 },
+    DoubleSettingInfo{ DoubleSetting::VIDEO_colorBlue,
+                       SettingCategory::Video,
+                       "colorBlueNew",
+                       1.0 },
+
+    // TODO BUG [breaking change] should be in Chaperone Settings Not Video
+    // fix @ breaking change
+    DoubleSettingInfo{ DoubleSetting::CHAPERONE_switchToBeginnerDistance,
+                       SettingCategory::Video,
+                       "chaperoneSwitchToBeginnerDistance",
+                       0.5 },
+    // TODO BUG [breaking change] should be in Chaperone Settings Not Video
+    // fix @ breaking change
+    DoubleSettingInfo{ DoubleSetting::CHAPERONE_hapticFeedbackDistance,
+                       SettingCategory::Video,
+                       "chaperoneHapticFeedbackDistance",
+                       0.5 },
+    // TODO BUG [breaking change] should be in Chaperone Settings Not Video
+    // fix @ breaking change
+    DoubleSettingInfo{ DoubleSetting::CHAPERONE_alarmSoundDistance,
+                       SettingCategory::Video,
+                       "chaperoneAlarmSoundDistance",
+                       0.5 },
+    // TODO BUG [breaking change] should be in Chaperone Settings Not Video
+    // fix @ breaking change
+    DoubleSettingInfo{ DoubleSetting::CHAPERONE_showDashboardDistance,
+                       SettingCategory::Video,
+                       "chaperoneShowDashboardDistance",
+                       0.5 },
+    DoubleSettingInfo{ DoubleSetting::CHAPERONE_fadeDistanceRemembered,
+                       SettingCategory::Chaperone,
+                       "fadeDistanceRemembered",
+                       0.5 },
+    DoubleSettingInfo{ DoubleSetting::CHAPERONE_dimHeight,
+                       SettingCategory::Chaperone,
+                       "dimHeight",
+                       0.0 },
+    DoubleSettingInfo{ DoubleSetting::ROTATION_activationDistance,
+                       SettingCategory::Rotation,
+                       "activationDistance",
+                       0.4 },
+    DoubleSettingInfo{ DoubleSetting::ROTATION_deactivateDistance,
+                       SettingCategory::Rotation,
+                       "deactivateDistance",
+                       0.15 },
+    DoubleSettingInfo{ DoubleSetting::ROTATION_cordDetanglingAngle,
+                       SettingCategory::Rotation,
+                       "cordDetanglingAngle",
+                       1500 * advsettings::k_centidegreesToRadians },
+    DoubleSettingInfo{ DoubleSetting::ROTATION_autoturnMinCordTangle,
+                       SettingCategory::Rotation,
+                       "autoturnMinCordTangle",
+                       2 * M_PI },
+    DoubleSettingInfo{ DoubleSetting::ROTATION_autoturnVestibularMotionRadius,
+                       SettingCategory::Rotation,
+                       "autoturnVestibularMotionRadius",
+                       22.0 },
+    DoubleSettingInfo{ DoubleSetting::ROTATION_autoturnViewRatchettingPercent,
+                       SettingCategory::Rotation,
+                       "autoturnViewRatchettingPercent",
+                       0.05 },
+};
+
+constexpr auto stringSettingsSize
+    = static_cast<int>( StringSetting::LAST_ENUMERATOR ) + 1;
+constexpr auto discordDefaultMuteKeybinding = "^>m";
+constexpr auto pressDefault = "F9";
+constexpr auto nameDefault = "«none»";
+constexpr std::array<StringSettingInfo, stringSettingsSize> k_stringSettings{
+    StringSettingInfo{ StringSetting::KEYBOARDSHORTCUT_keyboardOne,
+                       SettingCategory::KeyboardShortcut,
+                       "keyboardOne",
+                       discordDefaultMuteKeybinding },
+    StringSettingInfo{ StringSetting::KEYBOARDSHORTCUT_keyboardTwo,
+                       SettingCategory::KeyboardShortcut,
+                       "keyboardTwo",
+                       discordDefaultMuteKeybinding },
+    StringSettingInfo{ StringSetting::KEYBOARDSHORTCUT_keyboardThree,
+                       SettingCategory::KeyboardShortcut,
+                       "keyboardThree",
+                       discordDefaultMuteKeybinding },
+    StringSettingInfo{ StringSetting::KEYBOARDSHORTCUT_keyPressMisc,
+                       SettingCategory::KeyboardShortcut,
+                       "keyPressmisc",
+                       pressDefault },
+    StringSettingInfo{ StringSetting::KEYBOARDSHORTCUT_keyPressSystem,
+                       SettingCategory::KeyboardShortcut,
+                       "keyPressSystem",
+                       pressDefault },
+    StringSettingInfo{ StringSetting::APPLICATION_autoApplyChaperoneName,
+                       SettingCategory::Application,
+                       "autoApplyChaperoneName",
+                       nameDefault },
+
+    StringSettingInfo{
+        StringSetting::AUDIO_rules, SettingCategory::Audio, "rules", "" },
+};
+
+constexpr auto intSettingsSize
+    = static_cast<int>( IntSetting::LAST_ENUMERATOR ) + 1;
+constexpr std::array<IntSettingInfo, intSettingsSize> k_intSettings{
+    IntSettingInfo{ IntSetting::PLAYSPACE_snapTurnAngle,
+                    SettingCategory::Playspace,
+                    "snapTurnAngle",
+                    4500 },
+    IntSettingInfo{ IntSetting::PLAYSPACE_smoothTurnRate,
+                    SettingCategory::Playspace,
+                    "smoothTurnRate",
+                    100 },
+    IntSettingInfo{ IntSetting::PLAYSPACE_dragComfortFactor,
+                    SettingCategory::Playspace,
+                    "dragComfortFactor",
+                    0 },
+    IntSettingInfo{ IntSetting::PLAYSPACE_turnComfortFactor,
+                    SettingCategory::Playspace,
+                    "turnComfortFactor",
+                    0 },
+    IntSettingInfo{ IntSetting::PLAYSPACE_frictionPercent,
+                    SettingCategory::Playspace,
+                    "frictionPercent",
+                    0 },
+
+    IntSettingInfo{ IntSetting::APPLICATION_debugState,
+                    SettingCategory::Application,
+                    "debugState",
+                    0 },
+    IntSettingInfo{ IntSetting::APPLICATION_customTickRateMs,
+                    SettingCategory::Application,
+                    "customTickRateMs",
+                    20 },
+
+    IntSettingInfo{ IntSetting::UTILITY_alarmHour,
+                    SettingCategory::Utility,
+                    "alarmHour",
+                    0 },
+    IntSettingInfo{ IntSetting::UTILITY_alarmMinute,
+                    SettingCategory::Utility,
+                    "alarmMinute",
+                    0 },
+    IntSettingInfo{ IntSetting::UTILITY_alarmSecond,
+                    SettingCategory::Utility,
+                    "alarmSecond",
+                    0 },
+
+    // Rate of the outbound BoundrySync pose stream, 0 disables it.
+    IntSettingInfo{ IntSetting::CHAPERONE_poseStreamRateHz,
+                    SettingCategory::Chaperone,
+                    "poseStreamRateHz",
+                    0 },
+
+    IntSettingInfo{ IntSetting::ROTATION_autoturnLinearTurnSpeed,
+                    SettingCategory::Rotation,
+                    "autoturnLinearTurnSpeed",
+                    45000 },
+    IntSettingInfo{ IntSetting::ROTATION_autoturnMode,
+                    SettingCategory::Rotation,
+                    "autoturnMode",
+                    1 },
+};
+
+// Having the enum values be in the correct location makes getting a value
+// O(1) instead of O(n) due to array lookup vs traversal. Also ensures that
+// there are no missing values, since those are value initialized to the
+// first enumerator.
+template <typename Table>
+constexpr bool settingsCorrectlyOrdered( const Table& table ) noexcept
+{
+    for ( std::size_t i = 0; i < table.size(); ++i )
+    {
+        if ( static_cast<std::size_t>( table[i].setting ) != i )
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert( settingsCorrectlyOrdered( k_boolSettings ),
+               "Bool settings are out of enum order." );
+static_assert( settingsCorrectlyOrdered( k_doubleSettings ),
+               "Double settings are out of enum order." );
+static_assert( settingsCorrectlyOrdered( k_stringSettings ),
+               "String settings are out of enum order." );
+static_assert( settingsCorrectlyOrdered( k_intSettings ),
+               "Int settings are out of enum order." );
+
+// Key of a setting in the settings file.
+template <typename Info>
+[[nodiscard]] std::string settingKey( const Info& info )
+{
+    return getQtCategoryName( info.category ) + "/" + info.settingName;
+}
+
+template <typename Table>
+[[nodiscard]] std::optional<decltype( Table::value_type::setting )>
+    findInTable( const Table& table, const std::string& key )
+{
+    for ( const auto& info : table )
+    {
+        if ( settingKey( info ) == key )
+        {
+            return info.setting;
+        }
+    }
+    return std::nullopt;
+}
+
 template <typename Value> std::string valueToString( Value value )
 {
     using std::is_same;
@@ -29,76 +546,59 @@ template <typename Value> std::string valueToString( Value value )
     }
 }
 
-template <int ArraySize, typename Value>
-[[nodiscard]] std::string
-    returnSettingsAndValues( std::array<Value, ArraySize> v )
+template <typename Table, typename Values>
+[[nodiscard]] std::string returnSettingsAndValues( const Table& table,
+                                                   const Values& values )
 {
     std::string s = "default";
 
-    for ( const auto& setting : v )
+    for ( std::size_t i = 0; i < table.size(); ++i )
     {
-        s += setting.qtInfo().settingName + ": '"
-             + valueToString( setting.value() ) + "' | ";
+        s += std::string( table[i].settingName ) + ": '"
+             + valueToString( values[i] ) + "' | ";
     }
 
     return s;
 }
-template <typename Enum, int ArraySize, typename Value>
-void verifySettings( std::array<Value, ArraySize> v ) noexcept
-{
-    for ( int settingIndex = 0; settingIndex < ( ArraySize - 1 );
-          ++settingIndex )
-    {
-        // Having the enum values be in the correct location makes getting a
-        // value O(1) instead of O(n) due to array lookup vs traversal
-        // Also ensures that there are no mising values
-
-        const auto currentSetting
-            = v[static_cast<std::size_t>( settingIndex )].setting();
-
-        const auto settingCorrectlyLocated
-            = currentSetting == static_cast<Enum>( settingIndex );
-        if ( !settingCorrectlyLocated )
-        {
-            const auto enumName = typeid( Enum ).name();
-
-            const auto enumSettingNumber = static_cast<int>( currentSetting );
-
-            LOG( ERROR ) << enumName << ": at index '" << settingIndex
-                         << "' is incorrect. Current value: '"
-                         << enumSettingNumber
-                         << "'. Exiting "
-                            "with error code "
-                         << ReturnErrorCode::SETTING_INCORRECT_INDEX << ".";
-            exit( ReturnErrorCode::SETTING_INCORRECT_INDEX );
-        }
-    }
-}
 
 class SettingsController
 {
 public:
     SettingsController()
     {
-        verifySettings<BoolSetting, boolSettingSize>( m_boolSettings );
-
-        verifySettings<DoubleSetting, doubleSettingSize>( m_doubleSettings );
-
-        verifySettings<StringSetting, stringSettingsSize>( m_stringSettings );
+        // Read the file once up front instead of looking up every setting
+        // on its own.
+        auto& qsettings = getQSettings();
+        std::map<std::string, QVariant> stored;
+        for ( const auto& key : qsettings.allKeys() )
+        {
+            stored.emplace( key.toStdString(), qsettings.value( key ) );
+        }
 
-        verifySettings<IntSetting, intSettingsSize>( m_intSettings );
+        loadSettings(
+            k_boolSettings, m_boolSettings, m_dirtyBoolSettings, stored );
+        loadSettings(
+            k_doubleSettings, m_doubleSettings, m_dirtyDoubleSettings, stored );
+        loadSettings(
+            k_stringSettings, m_stringSettings, m_dirtyStringSettings, stored );
+        loadSettings(
+            k_intSettings, m_intSettings, m_dirtyIntSettings, stored );
+
+        // Settings missing from the file are created with their default, in
+        // one batch.
+        saveChangedSettings();
     }
 
     std::string getSettingsAndValues() const noexcept
     {
         std::string s;
-        s += returnSettingsAndValues<boolSettingSize>( m_boolSettings );
+        s += returnSettingsAndValues( k_boolSettings, m_boolSettings );
 
-        s += returnSettingsAndValues<doubleSettingSize>( m_doubleSettings );
+        s += returnSettingsAndValues( k_doubleSettings, m_doubleSettings );
 
-        s += returnSettingsAndValues<stringSettingsSize>( m_stringSettings );
+        s += returnSettingsAndValues( k_stringSettings, m_stringSettings );
 
-        s += returnSettingsAndValues<intSettingsSize>( m_intSettings );
+        s += returnSettingsAndValues( k_intSettings, m_intSettings );
 
         return s;
     }
@@ -108,39 +608,102 @@ class SettingsController
         return getQSettings().fileName().toStdString();
     }
 
+    // Hands every setting changed since the last call to the writer thread.
+    // No disk I/O happens on the calling thread.
     void saveChangedSettings()
     {
-        if ( m_changedSettings.empty() )
-        {
-            return;
-        }
+        std::vector<PendingSetting> batch;
+        collectSettings(
+            k_boolSettings, m_boolSettings, m_dirtyBoolSettings, batch );
+        collectSettings(
+            k_doubleSettings, m_doubleSettings, m_dirtyDoubleSettings, batch );
+        collectSettings(
+            k_stringSettings, m_stringSettings, m_dirtyStringSettings, batch );
+        collectSettings(
+            k_intSettings, m_intSettings, m_dirtyIntSettings, batch );
+
+        m_writer.enqueue( std::move( batch ) );
+    }
 
-        for ( const auto setting : m_changedSettings )
-        {
-            setting->saveValue();
-        }
+    // Writes every setting and waits until they are on disk.
+    void saveAllSettings()
+    {
+        m_dirtyBoolSettings.set();
+        m_dirtyDoubleSettings.set();
+        m_dirtyStringSettings.set();
+        m_dirtyIntSettings.set();
+        saveChangedSettings();
 
-        m_changedSettings.clear();
+        m_writer.flush();
     }
 
-    void saveAllSettings()
+    // Reads the settings file at fileName without touching the values in
+    // memory, so it can run on any thread.
+    [[nodiscard]] static SettingValues
+        readSettingsFile( const std::string& fileName )
+    {
+        const QSettings file( QString::fromStdString( fileName ),
+                              QSettings::IniFormat );
+        SettingValues values;
+        readValues( file, k_boolSettings, values.bools );
+        readValues( file, k_doubleSettings, values.doubles );
+        readValues( file, k_stringSettings, values.strings );
+        readValues( file, k_intSettings, values.ints );
+        return values;
+    }
+
+    [[nodiscard]] SettingValues
+        changedSettings( const SettingValues& values )
     {
-        for ( auto& setting : m_boolSettings )
+        SettingValues changed;
+        keepChanged( k_boolSettings,
+                     m_boolSettings,
+                     m_dirtyBoolSettings,
+                     values.bools,
+                     changed.bools );
+        keepChanged( k_doubleSettings,
+                     m_doubleSettings,
+                     m_dirtyDoubleSettings,
+                     values.doubles,
+                     changed.doubles );
+        keepChanged( k_stringSettings,
+                     m_stringSettings,
+                     m_dirtyStringSettings,
+                     values.strings,
+                     changed.strings );
+        keepChanged( k_intSettings,
+                     m_intSettings,
+                     m_dirtyIntSettings,
+                     values.ints,
+                     changed.ints );
+        return changed;
+    }
+
+    [[nodiscard]] static std::optional<AnySetting>
+        findSetting( const std::string& key )
+    {
+        if ( const auto setting = findInTable( k_boolSettings, key ) )
         {
-            setting.saveValue();
+            return *setting;
         }
-        for ( auto& setting : m_doubleSettings )
+        if ( const auto setting = findInTable( k_doubleSettings, key ) )
         {
-            setting.saveValue();
+            return *setting;
         }
-        for ( auto& setting : m_stringSettings )
+        if ( const auto setting = findInTable( k_intSettings, key ) )
         {
-            setting.saveValue();
+            return *setting;
         }
-        for ( auto& setting : m_intSettings )
+        if ( const auto setting = findInTable( k_stringSettings, key ) )
         {
-            setting.saveValue();
+            return *setting;
         }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] uint64_t writeCount()
+    {
+        return m_writer.writeCount();
     }
 
     template <typename ReturnType, typename Setting>
@@ -150,491 +713,166 @@ class SettingsController
 
         if constexpr ( std::is_same<Setting, BoolSetting>::value )
         {
-            return m_boolSettings[index].value();
+            return m_boolSettings[index];
         }
         else if constexpr ( std::is_same<Setting, DoubleSetting>::value )
         {
-            return m_doubleSettings[index].value();
+            return m_doubleSettings[index];
         }
         else if constexpr ( std::is_same<Setting, IntSetting>::value )
         {
-            return m_intSettings[index].value();
+            return m_intSettings[index];
         }
         else if constexpr ( std::is_same<Setting, StringSetting>::value )
         {
-            return m_stringSettings[index].value();
+            return m_stringSettings[index];
         }
     }
 
+    // Returns whether the stored value changed.
     template <typename Setting, typename Type>
-    void setSetting( const Setting setting, const Type value ) noexcept
+    bool setSetting( const Setting setting, const Type value ) noexcept
     {
         const auto index = static_cast<std::size_t>( setting );
 
         if constexpr ( std::is_same<Setting, BoolSetting>::value )
         {
-            auto& s = m_boolSettings[index];
-            s.setValue( value );
-
-            m_changedSettings.push_back( &s );
+            return updateValue(
+                m_boolSettings, m_dirtyBoolSettings, index, value );
         }
         else if constexpr ( std::is_same<Setting, DoubleSetting>::value )
         {
-            auto& s = m_doubleSettings[index];
-            s.setValue( value );
-
-            m_changedSettings.push_back( &s );
+            return updateValue(
+                m_doubleSettings, m_dirtyDoubleSettings, index, value );
         }
         else if constexpr ( std::is_same<Setting, IntSetting>::value )
         {
-            auto& s = m_intSettings[index];
-            s.setValue( value );
-
-            m_changedSettings.push_back( &s );
+            return updateValue(
+                m_intSettings, m_dirtyIntSettings, index, value );
         }
         else if constexpr ( std::is_same<Setting, StringSetting>::value )
         {
-            auto& s = m_stringSettings[index];
-            s.setValue( value );
-
-            m_changedSettings.push_back( &s );
+            return updateValue(
+                m_stringSettings, m_dirtyStringSettings, index, value );
         }
     }
 
 private:
-    std::vector<SettingValue*> m_changedSettings{};
-
-    constexpr static auto boolSettingSize
-        = static_cast<int>( BoolSetting::LAST_ENUMERATOR ) + 1;
-    std::array<BoolSettingValue, boolSettingSize> m_boolSettings{
-        BoolSettingValue{ BoolSetting::PLAYSPACE_lockXToggle,
-                          SettingCategory::Playspace,
-                          QtInfo{ "lockXToggle" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_lockYToggle,
-                          SettingCategory::Playspace,
-                          QtInfo{ "lockYToggle" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_lockZToggle,
-                          SettingCategory::Playspace,
-                          QtInfo{ "lockZToggle" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_momentumSave,
-                          SettingCategory::Playspace,
-                          QtInfo{ "momentumSave" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_turnBindLeft,
-                          SettingCategory::Playspace,
-                          QtInfo{ "turnBindLeft" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_turnBindRight,
-                          SettingCategory::Playspace,
-                          QtInfo{ "turnBindRight" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_turnBounds,
-                          SettingCategory::Playspace,
-                          QtInfo{ "turnBounds" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_moveShortcutLeft,
-                          SettingCategory::Playspace,
-                          QtInfo{ "moveShortcutLeft" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_moveShortcutRight,
-                          SettingCategory::Playspace,
-                          QtInfo{ "moveShortcutRight" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_dragBounds,
-                          SettingCategory::Playspace,
-                          QtInfo{ "dragBounds" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_allowExternalEdits,
-                          SettingCategory::Playspace,
-                          QtInfo{ "allowExternalEdits" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_oldStyleMotion,
-                          SettingCategory::Playspace,
-                          QtInfo{ "oldStyleMotion" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_universeCenteredRotation,
-                          SettingCategory::Playspace,
-                          QtInfo{ "universeCenteredRotation" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_enableSeatedMotion,
-                          SettingCategory::Playspace,
-                          QtInfo{ "enableSeatedMotion" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_adjustChaperone,
-                          SettingCategory::Playspace,
-                          QtInfo{ "adjustChaperone" },
-                          true },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_showLogMatricesButton,
-                          SettingCategory::Playspace,
-                          QtInfo{ "showLogMatricesButton" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_simpleRecenter,
-                          SettingCategory::Playspace,
-                          QtInfo{ "simpleRecenter" },
-                          false },
-        // TODO Replace Back to Adjust Chaperone When Breaking Change is done.
-        // Needed New Setting defaulted to off w/ SVR 1.13.x release
-        BoolSettingValue{ BoolSetting::PLAYSPACE_adjustChaperone2,
-                          SettingCategory::Playspace,
-                          QtInfo{ "adjustChaperone2" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_enableUncalMotion,
-                          SettingCategory::Playspace,
-                          QtInfo{ "enableUncalMotion" },
-                          false },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_adjustChaperone3,
-                          SettingCategory::Playspace,
-                          QtInfo{ "adjustChaperone3" },
-                          true },
-        BoolSettingValue{ BoolSetting::PLAYSPACE_adjustChaperone4,
-                          SettingCategory::Playspace,
-                          QtInfo{ "adjustChaperone4" },
-                          false },
-
-        BoolSettingValue{ BoolSetting::APPLICATION_disableVersionCheck,
-                          SettingCategory::Application,
-                          QtInfo{ "disableVersionCheck" },
-                          false },
-        BoolSettingValue{ BoolSetting::APPLICATION_previousShutdownSafe,
-                          SettingCategory::Application,
-                          QtInfo{ "previousShutdownSafe" },
-                          true },
-        BoolSettingValue{ BoolSetting::APPLICATION_vsyncDisabled,
-                          SettingCategory::Application,
-                          QtInfo{ "vsyncDisabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::APPLICATION_crashRecoveryDisabled,
-                          SettingCategory::Application,
-                          QtInfo{ "crashRecoveryDisabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::APPLICATION_enableDebug,
-                          SettingCategory::Application,
-                          QtInfo{ "enableDebug" },
-                          false },
-        BoolSettingValue{ BoolSetting::APPLICATION_enableExclusiveInput,
-                          SettingCategory::Application,
-                          QtInfo{ "enableExclusiveInput" },
-                          false },
-        BoolSettingValue{ BoolSetting::APPLICATION_crashRecoveryDisabled2,
-                          SettingCategory::Application,
-                          QtInfo{ "crashRecoveryDisabled2" },
-                          true },
-        BoolSettingValue{ BoolSetting::APPLICATION_openXRWorkAround,
-                          SettingCategory::Application,
-                          QtInfo{ "openXRWorkAround" },
-                          false },
-        BoolSettingValue{ BoolSetting::APPLICATION_autoApplyChaperone,
-                          SettingCategory::Application,
-                          QtInfo{ "autoApplyChaperoneToggle" },
-                          false },
-        BoolSettingValue{ BoolSetting::APPLICATION_desktopModeToggle,
-                          SettingCategory::Application,
-                          QtInfo{ "desktopModeToggle" },
-                          false },
-
-        BoolSettingValue{ BoolSetting::AUDIO_pttEnabled,
-                          SettingCategory::Audio,
-                          QtInfo{ "pttEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::AUDIO_pttShowNotification,
-                          SettingCategory::Audio,
-                          QtInfo{ "pttShowNotification" },
-                          false },
-        BoolSettingValue{ BoolSetting::AUDIO_micProximitySensorCanMute,
-                          SettingCategory::Audio,
-                          QtInfo{ "micProximitySensorCanMute" },
-                          false },
-        BoolSettingValue{ BoolSetting::AUDIO_micReversePtt,
-                          SettingCategory::Audio,
-                          QtInfo{ "micReversePtt" },
-                          false },
-
-        BoolSettingValue{ BoolSetting::UTILITY_alarmEnabled,
-                          SettingCategory::Utility,
-                          QtInfo{ "alarmEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::UTILITY_alarmIsModal,
-                          SettingCategory::Utility,
-                          QtInfo{ "alarmIsModal" },
-                          true },
-        BoolSettingValue{ BoolSetting::UTILITY_vrcDebug,
-                          SettingCategory::Utility,
-                          QtInfo{ "vrcDebug" },
-                          false },
-        BoolSettingValue{ BoolSetting::UTILITY_trackerOverlayEnabled,
-                          SettingCategory::Utility,
-                          QtInfo{ "trackerOverlayEnabled" },
-                          true },
-
-        BoolSettingValue{ BoolSetting::VIDEO_brightnessEnabled,
-                          SettingCategory::Video,
-                          QtInfo{ "brightnessEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::VIDEO_isOverlayMethodActive,
-                          SettingCategory::Video,
-                          QtInfo{ "isOverlayMethodActive" },
-                          false },
-        BoolSettingValue{ BoolSetting::VIDEO_colorOverlayEnabled,
-                          SettingCategory::Video,
-                          QtInfo{ "colorOverlayEnabled" },
-                          false },
-
-        BoolSettingValue{
-            BoolSetting::CHAPERONE_chaperoneSwitchToBeginnerEnabled,
-            SettingCategory::Chaperone,
-            QtInfo{ "chaperoneSwitchToBeginnerEnabled" },
-            false },
-        BoolSettingValue{ BoolSetting::CHAPERONE_chaperoneHapticFeedbackEnabled,
-                          SettingCategory::Chaperone,
-                          QtInfo{ "chaperoneHapticFeedbackEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::CHAPERONE_chaperoneAlarmSoundEnabled,
-                          SettingCategory::Chaperone,
-                          QtInfo{ "chaperoneAlarmSoundEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::CHAPERONE_chaperoneAlarmSoundLooping,
-                          SettingCategory::Chaperone,
-                          QtInfo{ "chaperoneAlarmSoundLooping" },
-                          true },
-        BoolSettingValue{
-            BoolSetting::CHAPERONE_chaperoneAlarmSoundAdjustVolume,
-            SettingCategory::Chaperone,
-            QtInfo{ "chaperoneAlarmSoundAdjustVolume" },
-            false },
-        BoolSettingValue{ BoolSetting::CHAPERONE_chaperoneShowDashboardEnabled,
-                          SettingCategory::Chaperone,
-                          QtInfo{ "chaperoneShowDashboardEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::CHAPERONE_disableChaperone,
-                          SettingCategory::Chaperone,
-                          QtInfo{ "disableChaperone" },
-                          false },
-        BoolSettingValue{ BoolSetting::CHAPERONE_centerMarkerNew,
-                          SettingCategory::Chaperone,
-                          QtInfo{ "centerMarkerNew" },
-                          false },
-
-        BoolSettingValue{ BoolSetting::ROTATION_autoturnEnabled,
-                          SettingCategory::Rotation,
-                          QtInfo{ "autoturnEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::ROTATION_autoturnUseCornerAngle,
-                          SettingCategory::Rotation,
-                          QtInfo{ "autoturnUseCornerAngle" },
-                          true },
-        BoolSettingValue{ BoolSetting::ROTATION_autoturnVestibularMotionEnabled,
-                          SettingCategory::Rotation,
-                          QtInfo{ "autoturnVestibularMotionEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::ROTATION_autoturnViewRatchettingEnabled,
-                          SettingCategory::Rotation,
-                          QtInfo{ "autoturnViewRatchettingEnabled" },
-                          false },
-        BoolSettingValue{ BoolSetting::ROTATION_autoturnShowNotification,
-                          SettingCategory::Rotation,
-                          QtInfo{ "autoturnShowNotification" },
-                          true },
-        BoolSettingValue{ BoolSetting::STEAMVR_perappBindEnabled,
-                          SettingCategory::SteamVR,
-                          QtInfo{ "perappBindEnabled" },
-                          false }
-    };
-
-    constexpr static auto doubleSettingSize
-        = static_cast<int>( DoubleSetting::LAST_ENUMERATOR ) + 1;
-    std::array<DoubleSettingValue, doubleSettingSize> m_doubleSettings{
-        DoubleSettingValue{ DoubleSetting::PLAYSPACE_heightToggleOffset,
-                            SettingCategory::Playspace,
-                            QtInfo{ "heightToggleOffset" },
-                            -1.0 },
-        DoubleSettingValue{ DoubleSetting::PLAYSPACE_gravityStrength,
-                            SettingCategory::Playspace,
-                            QtInfo{ "gravityStrength" },
-                            9.8 },
-        DoubleSettingValue{ DoubleSetting::PLAYSPACE_flingStrength,
-                            SettingCategory::Playspace,
-                            QtInfo{ "flingStrength" },
-                            1.0 },
-        DoubleSettingValue{ DoubleSetting::PLAYSPACE_dragMult,
-                            SettingCategory::Playspace,
-                            QtInfo{ "dragMult" },
-                            1.0 },
-
-        DoubleSettingValue{ DoubleSetting::APPLICATION_appVolume,
-                            SettingCategory::Application,
-                            QtInfo{ "appVolume" },
-                            0.7 },
-
-        DoubleSettingValue{ DoubleSetting::VIDEO_brightnessOpacityValue,
-                            SettingCategory::Video,
-                            QtInfo{ "brightnessOpacityValue" },
-                            1.0 },
-        DoubleSettingValue{ DoubleSetting::VIDEO_colorOverlayOpacity,
-                            SettingCategory::Video,
-                            QtInfo{ "colorOverlayOpacity" },
-                            0.0 },
-        DoubleSettingValue{ DoubleSetting::VIDEO_colorRed,
-                            SettingCategory::Video,
-                            QtInfo{ "colorRedNew" },
-                            1.0 },
-        DoubleSettingValue{ DoubleSetting::VIDEO_colorGreen,
-                            SettingCategory::Video,
-                            QtInfo{ "colorGreenNew" },
-                            1.0 },
-        DoubleSettingValue{ DoubleSetting::VIDEO_colorBlue,
-                            SettingCategory::Video,
-                            QtInfo{ "colorBlueNew" },
-                            1.0 },
-
-        // TODO BUG [breaking change] should be in Chaperone Settings Not Video
-        // fix @ breaking change
-        DoubleSettingValue{ DoubleSetting::CHAPERONE_switchToBeginnerDistance,
-                            SettingCategory::Video,
-                            QtInfo{ "chaperoneSwitchToBeginnerDistance" },
-                            0.5 },
-        // TODO BUG [breaking change] should be in Chaperone Settings Not Video
-        // fix @ breaking change
-        DoubleSettingValue{ DoubleSetting::CHAPERONE_hapticFeedbackDistance,
-                            SettingCategory::Video,
-                            QtInfo{ "chaperoneHapticFeedbackDistance" },
-                            0.5 },
-        // TODO BUG [breaking change] should be in Chaperone Settings Not Video
-        // fix @ breaking change
-        DoubleSettingValue{ DoubleSetting::CHAPERONE_alarmSoundDistance,
-                            SettingCategory::Video,
-                            QtInfo{ "chaperoneAlarmSoundDistance" },
-                            0.5 },
-        // TODO BUG [breaking change] should be in Chaperone Settings Not Video
-        // fix @ breaking change
-        DoubleSettingValue{ DoubleSetting::CHAPERONE_showDashboardDistance,
-                            SettingCategory::Video,
-                            QtInfo{ "chaperoneShowDashboardDistance" },
-                            0.5 },
-        DoubleSettingValue{ DoubleSetting::CHAPERONE_fadeDistanceRemembered,
-                            SettingCategory::Chaperone,
-                            QtInfo{ "fadeDistanceRemembered" },
-                            0.5 },
-        DoubleSettingValue{ DoubleSetting::CHAPERONE_dimHeight,
-                            SettingCategory::Chaperone,
-                            QtInfo{ "dimHeight" },
-                            0.0 },
-        DoubleSettingValue{ DoubleSetting::ROTATION_activationDistance,
-                            SettingCategory::Rotation,
-                            QtInfo{ "activationDistance" },
-                            0.4 },
-        DoubleSettingValue{ DoubleSetting::ROTATION_deactivateDistance,
-                            SettingCategory::Rotation,
-                            QtInfo{ "deactivateDistance" },
-                            0.15 },
-        DoubleSettingValue{ DoubleSetting::ROTATION_cordDetanglingAngle,
-                            SettingCategory::Rotation,
-                            QtInfo{ "cordDetanglingAngle" },
-                            1500 * advsettings::k_centidegreesToRadians },
-        DoubleSettingValue{ DoubleSetting::ROTATION_autoturnMinCordTangle,
-                            SettingCategory::Rotation,
-                            QtInfo{ "autoturnMinCordTangle" },
-                            2 * M_PI },
-        DoubleSettingValue{
-            DoubleSetting::ROTATION_autoturnVestibularMotionRadius,
-            SettingCategory::Rotation,
-            QtInfo{ "autoturnVestibularMotionRadius" },
-            22.0 },
-        DoubleSettingValue{
-            DoubleSetting::ROTATION_autoturnViewRatchettingPercent,
-            SettingCategory::Rotation,
-            QtInfo{ "autoturnViewRatchettingPercent" },
-            0.05 },
-    };
-
-    constexpr static auto stringSettingsSize
-        = static_cast<int>( StringSetting::LAST_ENUMERATOR ) + 1;
-    constexpr static auto discordDefaultMuteKeybinding = "^>m";
-    constexpr static auto pressDefault = "F9";
-    constexpr static auto nameDefault = "«none»";
-    std::array<StringSettingValue, stringSettingsSize> m_stringSettings{
-        StringSettingValue{ StringSetting::KEYBOARDSHORTCUT_keyboardOne,
-                            SettingCategory::KeyboardShortcut,
-                            QtInfo{ "keyboardOne" },
-                            discordDefaultMuteKeybinding },
-        StringSettingValue{ StringSetting::KEYBOARDSHORTCUT_keyboardTwo,
-                            SettingCategory::KeyboardShortcut,
-                            QtInfo{ "keyboardTwo" },
-                            discordDefaultMuteKeybinding },
-        StringSettingValue{ StringSetting::KEYBOARDSHORTCUT_keyboardThree,
-                            SettingCategory::KeyboardShortcut,
-                            QtInfo{ "keyboardThree" },
-                            discordDefaultMuteKeybinding },
-        StringSettingValue{ StringSetting::KEYBOARDSHORTCUT_keyPressMisc,
-                            SettingCategory::KeyboardShortcut,
-                            QtInfo{ "keyPressmisc" },
-                            pressDefault },
-        StringSettingValue{ StringSetting::KEYBOARDSHORTCUT_keyPressSystem,
-                            SettingCategory::KeyboardShortcut,
-                            QtInfo{ "keyPressSystem" },
-                            pressDefault },
-        StringSettingValue{ StringSetting::APPLICATION_autoApplyChaperoneName,
-                            SettingCategory::Application,
-                            QtInfo{ "autoApplyChaperoneName" },
-                            nameDefault },
-    };
-
-    constexpr static auto intSettingsSize
-        = static_cast<int>( IntSetting::LAST_ENUMERATOR ) + 1;
-    std::array<IntSettingValue, intSettingsSize> m_intSettings{
-        IntSettingValue{ IntSetting::PLAYSPACE_snapTurnAngle,
-                         SettingCategory::Playspace,
-                         QtInfo{ "snapTurnAngle" },
-                         4500 },
-        IntSettingValue{ IntSetting::PLAYSPACE_smoothTurnRate,
-                         SettingCategory::Playspace,
-                         QtInfo{ "smoothTurnRate" },
-                         100 },
-        IntSettingValue{ IntSetting::PLAYSPACE_dragComfortFactor,
-                         SettingCategory::Playspace,
-                         QtInfo{ "dragComfortFactor" },
-                         0 },
-        IntSettingValue{ IntSetting::PLAYSPACE_turnComfortFactor,
-                         SettingCategory::Playspace,
-                         QtInfo{ "turnComfortFactor" },
-                         0 },
-        IntSettingValue{ IntSetting::PLAYSPACE_frictionPercent,
-                         SettingCategory::Playspace,
-                         QtInfo{ "frictionPercent" },
-                         0 },
-
-        IntSettingValue{ IntSetting::APPLICATION_debugState,
-                         SettingCategory::Application,
-                         QtInfo{ "debugState" },
-                         0 },
-        IntSettingValue{ IntSetting::APPLICATION_customTickRateMs,
-                         SettingCategory::Application,
-                         QtInfo{ "customTickRateMs" },
-                         20 },
-
-        IntSettingValue{ IntSetting::UTILITY_alarmHour,
-                         SettingCategory::Utility,
-                         QtInfo{ "alarmHour" },
-                         0 },
-        IntSettingValue{ IntSetting::UTILITY_alarmMinute,
-                         SettingCategory::Utility,
-                         QtInfo{ "alarmMinute" },
-                         0 },
-        IntSettingValue{ IntSetting::UTILITY_alarmSecond,
-                         SettingCategory::Utility,
-                         QtInfo{ "alarmSecond" },
-                         0 },
-        IntSettingValue{ IntSetting::ROTATION_autoturnLinearTurnSpeed,
-                         SettingCategory::Rotation,
-                         QtInfo{ "autoturnLinearTurnSpeed" },
-                         45000 },
-        IntSettingValue{ IntSetting::ROTATION_autoturnMode,
-                         SettingCategory::Rotation,
-                         QtInfo{ "autoturnMode" },
-                         1 },
-
-    };
+    template <typename Values, typename Dirty, typename Type>
+    static bool updateValue( Values& values,
+                             Dirty& dirty,
+                             const std::size_t index,
+                             const Type& value )
+    {
+        if ( values[index] == value )
+        {
+            return false;
+        }
+        values[index] = value;
+
+        dirty.set( index );
+        return true;
+    }
+
+    template <typename Table, typename Values, typename Dirty>
+    static void loadSettings( const Table& table,
+                              Values& values,
+                              Dirty& missing,
+                              const std::map<std::string, QVariant>& stored )
+    {
+        using Value = typename Values::value_type;
+        for ( std::size_t i = 0; i < table.size(); ++i )
+        {
+            const auto& info = table[i];
+            const auto it = stored.find( settingKey( info ) );
+            if ( it != stored.end() && isValidQVariant<Value>( it->second ) )
+            {
+                values[i] = fromQVariant<Value>( it->second );
+            }
+            else
+            {
+                values[i] = info.defaultValue;
+                missing.set( i );
+            }
+        }
+    }
+
+    template <typename Table, typename Changes>
+    static void
+        readValues( const QSettings& file, const Table& table, Changes& out )
+    {
+        using Value = typename Changes::value_type::second_type;
+        for ( const auto& info : table )
+        {
+            const auto stored
+                = file.value( QString::fromStdString( settingKey( info ) ) );
+            if ( !isValidQVariant<Value>( stored ) )
+            {
+                continue;
+            }
+            const auto value = fromQVariant<Value>( stored );
+            if constexpr ( std::is_same<Value, double>::value )
+            {
+                if ( !std::isfinite( value ) )
+                {
+                    continue;
+                }
+            }
+            out.emplace_back( info.setting, value );
+        }
+    }
+
+    template <typename Table, typename Values, typename Dirty, typename Changes>
+    void keepChanged( const Table& table,
+                      const Values& values,
+                      const Dirty& dirty,
+                      const Changes& read,
+                      Changes& changed )
+    {
+        for ( const auto& [setting, value] : read )
+        {
+            const auto index = static_cast<std::size_t>( setting );
+            if ( values[index] != value && !dirty.test( index )
+                 && !m_writer.isPending( settingKey( table[index] ) ) )
+            {
+                changed.emplace_back( setting, value );
+            }
+        }
+    }
+
+    template <typename Table, typename Values, typename Dirty>
+    static void collectSettings( const Table& table,
+                                 const Values& values,
+                                 Dirty& dirty,
+                                 std::vector<PendingSetting>& batch )
+    {
+        if ( dirty.none() )
+        {
+            return;
+        }
+        for ( std::size_t i = 0; i < table.size(); ++i )
+        {
+            if ( dirty.test( i ) )
+            {
+                batch.push_back( { table[i].category,
+                                   table[i].settingName,
+                                   toQVariant( values[i] ) } );
+            }
+        }
+        dirty.reset();
+    }
+
+    SettingsWriter m_writer;
+
+    std::array<bool, boolSettingSize> m_boolSettings{};
+    std::array<double, doubleSettingSize> m_doubleSettings{};
+    std::array<std::string, stringSettingsSize> m_stringSettings{};
+    std::array<int, intSettingsSize> m_intSettings{};
+
+    // One bit per setting, set when the value changed and not yet saved.
+    std::bitset<boolSettingSize> m_dirtyBoolSettings{};
+    std::bitset<doubleSettingSize> m_dirtyDoubleSettings{};
+    std::bitset<stringSettingsSize> m_dirtyStringSettings{};
+    std::bitset<intSettingsSize> m_dirtyIntSettings{};
 };
 } // namespace settings
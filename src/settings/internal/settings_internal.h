@@ -20,11 +20,6 @@ enum class SettingCategory
     SteamVR,
 };
 
-struct QtInfo
-{
-    const std::string settingName;
-};
-
 [[nodiscard]] QSettings& getQSettings()
 {
     static QSettings s( QSettings::IniFormat,
@@ -63,27 +58,6 @@ struct QtInfo
     return "no-value";
 }
 
-[[nodiscard]] QVariant getQtSetting( const SettingCategory category,
-                                     const std::string qtSettingName )
-{
-    getQSettings().beginGroup( getQtCategoryName( category ).c_str() );
-
-    const auto v = getQSettings().value( qtSettingName.c_str() );
-
-    getQSettings().endGroup();
-
-    return v;
-}
-
-void saveQtSetting( const SettingCategory category,
-                    const std::string qtSettingName,
-                    const QVariant value )
-{
-    getQSettings().beginGroup( getQtCategoryName( category ).c_str() );
-    getQSettings().setValue( qtSettingName.c_str(), value );
-    getQSettings().endGroup();
-}
-
 template <typename Value>[[nodiscard]] bool isValidQVariant( const QVariant v )
 {
     auto savedSettingIsValid = v.isValid() && !v.isNull();
@@ -105,4 +79,38 @@ template <typename Value>[[nodiscard]] bool isValidQVariant( const QVariant v )
     return false;
 }
 
+template <typename Value>[[nodiscard]] Value fromQVariant( const QVariant& v )
+{
+    if constexpr ( std::is_same<Value, bool>::value )
+    {
+        return v.toBool();
+    }
+    else if constexpr ( std::is_same<Value, double>::value )
+    {
+        return v.toDouble();
+    }
+    else if constexpr ( std::is_same<Value, int>::value )
+    {
+        return v.toInt();
+    }
+    else if constexpr ( std::is_same<Value, std::string>::value )
+    {
+        return v.toString().toStdString();
+    }
+}
+
+template <typename Value>[[nodiscard]] QVariant toQVariant( const Value& value )
+{
+    if constexpr ( std::is_same<Value, std::string>::value )
+    {
+        // Special case for std::string because it can't be auto converted to
+        // QVariant
+        return QVariant( QString::fromStdString( value ) );
+    }
+    else
+    {
+        return QVariant( value );
+    }
+}
+
 } // namespace settings
@@ -0,0 +1,179 @@
+#pragma once
+#include <QSettings>
+#include <QVariant>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <easylogging++.h>
+#include "settings_internal.h"
+
+namespace settings
+{
+struct PendingSetting
+{
+    SettingCategory category;
+    std::string settingName;
+    QVariant value;
+};
+
+/*!
+Writes settings to disk on a background thread.
+
+Batches handed to enqueue() are merged by key, so a value that changed many
+times is only written once. The thread waits until no batch arrived for
+k_debounce (but at most k_maxDelay after the first pending change) and then
+writes everything pending with a single QSettings::sync(), which replaces
+the file atomically. The thread uses its own QSettings instance; QSettings
+keeps instances for the same file in one process consistent.
+*/
+class SettingsWriter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr auto k_debounce = std::chrono::milliseconds( 500 );
+    static constexpr auto k_maxDelay = std::chrono::seconds( 5 );
+
+    SettingsWriter() : m_thread( &SettingsWriter::run, this ) {}
+
+    ~SettingsWriter()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    SettingsWriter( const SettingsWriter& ) = delete;
+    SettingsWriter& operator=( const SettingsWriter& ) = delete;
+
+    void enqueue( std::vector<PendingSetting> batch )
+    {
+        if ( batch.empty() )
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            const auto now = Clock::now();
+            if ( m_pending.empty() )
+            {
+                m_firstChange = now;
+            }
+            m_lastChange = now;
+            for ( auto& setting : batch )
+            {
+                const auto key = getQtCategoryName( setting.category ) + "/"
+                                 + setting.settingName;
+                m_pending[key] = std::move( setting.value );
+            }
+            ++m_enqueued;
+        }
+        m_wake.notify_all();
+    }
+
+    // Blocks until everything enqueued so far is on disk.
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        const auto target = m_enqueued;
+        m_flushRequested = true;
+        m_wake.notify_all();
+        m_written.wait( lock, [&] { return m_writtenUpTo >= target; } );
+    }
+
+    // Whether key was enqueued but isn't on disk yet.
+    [[nodiscard]] bool isPending( const std::string& key )
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        return m_pending.count( key ) != 0 || m_writing.count( key ) != 0;
+    }
+
+    [[nodiscard]] uint64_t writeCount()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        return m_writes;
+    }
+
+private:
+    void run()
+    {
+        // Created here so the instance is only ever used by this thread.
+        QSettings qsettings( QSettings::IniFormat,
+                             QSettings::UserScope,
+                             application_strings::applicationOrganizationName,
+                             application_strings::applicationName );
+
+        std::unique_lock<std::mutex> lock( m_mutex );
+        while ( true )
+        {
+            if ( m_pending.empty() )
+            {
+                m_writtenUpTo = m_enqueued;
+                m_flushRequested = false;
+                m_written.notify_all();
+                if ( m_stop )
+                {
+                    return;
+                }
+                m_wake.wait( lock );
+                continue;
+            }
+
+            const auto due = std::min( m_lastChange + k_debounce,
+                                       m_firstChange + k_maxDelay );
+            if ( !m_stop && !m_flushRequested && Clock::now() < due )
+            {
+                m_wake.wait_until( lock, due );
+                continue;
+            }
+
+            // Only this thread modifies m_writing, and only while holding the
+            // lock, so it can be read unlocked here.
+            m_writing = std::move( m_pending );
+            m_pending.clear();
+            const auto batchEnd = m_enqueued;
+            lock.unlock();
+
+            for ( const auto& [key, value] : m_writing )
+            {
+                qsettings.setValue( QString::fromStdString( key ), value );
+            }
+            qsettings.sync();
+            if ( qsettings.status() != QSettings::NoError )
+            {
+                LOG( ERROR ) << "Could not write settings file '"
+                             << qsettings.fileName().toStdString() << "'.";
+            }
+
+            lock.lock();
+            m_writing.clear();
+            ++m_writes;
+            m_writtenUpTo = batchEnd;
+            m_written.notify_all();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_written;
+    std::map<std::string, QVariant> m_pending;
+    // The batch currently being written.
+    std::map<std::string, QVariant> m_writing;
+    Clock::time_point m_firstChange{};
+    Clock::time_point m_lastChange{};
+    uint64_t m_enqueued = 0;
+    uint64_t m_writtenUpTo = 0;
+    uint64_t m_writes = 0;
+    bool m_flushRequested = false;
+    bool m_stop = false;
+    // Last member, so everything above exists before the thread starts.
+    std::thread m_thread;
+};
+
+} // namespace settings
@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "settings_object.h"
+
+namespace settings
+{
+/*!
+   \brief Numbered profiles of type \a T that are loaded on demand.
+
+   Only the profile index is read when the list is (re)loaded, which is all
+   that is needed to show the profile names. A profile itself is loaded the
+   first time it is accessed with \c get() and kept in a small LRU cache.
+   Profiles are shared with the caller, so one that is evicted stays alive
+   for as long as the caller holds on to it. Changes go through \c save().
+
+   Index entries are numbered like \c saveAllObjects numbers them, so a list
+   saved with \c saveAllObjects can be read with this class and the other
+   way around.
+
+   \a T must inherit from \c ISettingsObject and have the profile name as
+   its first string value, which is what the index shows.
+ */
+template <class T> class ProfileList
+{
+    static_assert(
+        std::is_base_of<ISettingsObject, T>::value,
+        "Only objects that inherit from ISettingsObject can be listed." );
+
+public:
+    static constexpr std::size_t k_cacheSize = 4;
+
+    // Reads the index and drops all cached profiles.
+    void reload()
+    {
+        m_index = loadObjectIndex( T{} );
+        m_cache.clear();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_index.size();
+    }
+
+    [[nodiscard]] const std::string& name( const std::size_t index ) const
+    {
+        return m_index.at( index ).displayName;
+    }
+
+    [[nodiscard]] std::optional<std::size_t>
+        find( const std::string& name ) const
+    {
+        const auto it = std::find_if(
+            m_index.begin(), m_index.end(), [&name]( const auto& entry ) {
+                return entry.displayName == name;
+            } );
+        if ( it == m_index.end() )
+        {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>( it - m_index.begin() );
+    }
+
+    /*!
+       \brief Gets the profile at \a index, loading it if it isn't cached.
+     */
+    std::shared_ptr<const T> get( const std::size_t index )
+    {
+        const auto cached = std::find_if(
+            m_cache.begin(), m_cache.end(), [index]( const auto& entry ) {
+                return entry.first == index;
+            } );
+        if ( cached != m_cache.end() )
+        {
+            m_cache.splice( m_cache.begin(), m_cache, cached );
+            return m_cache.front().second;
+        }
+
+        auto profile = std::make_shared<T>();
+        loadNumberedObject( *profile, slot( index ) );
+        cache( index, profile );
+        return profile;
+    }
+
+    // Adds an empty profile at the end. It's stored once save() is called.
+    std::size_t append()
+    {
+        const auto index = m_index.size();
+        m_index.emplace_back();
+        cache( index, std::make_shared<T>() );
+        return index;
+    }
+
+    // Writes profile to index, which must exist or have been added with
+    // append().
+    void save( const std::size_t index, const T& profile )
+    {
+        saveNumberedObject( profile, slot( index ) );
+        m_cache.remove_if(
+            [index]( const auto& entry ) { return entry.first == index; } );
+        cache( index, std::make_shared<T>( profile ) );
+        m_index = loadObjectIndex( T{} );
+    }
+
+    void erase( const std::size_t index )
+    {
+        if ( index >= m_index.size() )
+        {
+            return;
+        }
+        eraseNumberedObject( T{}, slot( index ) );
+        m_index.erase( m_index.begin()
+                       + static_cast<std::ptrdiff_t>( index ) );
+
+        m_cache.remove_if(
+            [index]( const auto& entry ) { return entry.first == index; } );
+        for ( auto& entry : m_cache )
+        {
+            if ( entry.first > index )
+            {
+                --entry.first;
+            }
+        }
+    }
+
+private:
+    static int slot( const std::size_t index ) noexcept
+    {
+        return static_cast<int>( index ) + 1;
+    }
+
+    void cache( const std::size_t index, std::shared_ptr<const T> profile )
+    {
+        if ( m_cache.size() >= k_cacheSize )
+        {
+            m_cache.pop_back();
+        }
+        m_cache.emplace_front( index, std::move( profile ) );
+    }
+
+    std::vector<ProfileIndexEntry> m_index;
+    // Most recently used first.
+    std::list<std::pair<std::size_t, std::shared_ptr<const T>>> m_cache;
+};
+
+} // namespace settings
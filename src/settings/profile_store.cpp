@@ -0,0 +1,427 @@
+#include "profile_store.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace
+{
+constexpr std::array<uint8_t, 4> k_magic{ 'O', 'V', 'R', 'P' };
+constexpr std::size_t k_headerSize = 20;
+
+std::array<uint32_t, 256> makeCrcTable() noexcept
+{
+    std::array<uint32_t, 256> table{};
+    for ( uint32_t i = 0; i < table.size(); ++i )
+    {
+        auto c = i;
+        for ( int bit = 0; bit < 8; ++bit )
+        {
+            c = ( c & 1 ) ? 0xEDB88320u ^ ( c >> 1 ) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+uint32_t crc32( const uint8_t* data, const std::size_t size ) noexcept
+{
+    static const auto table = makeCrcTable();
+    uint32_t crc = 0xFFFFFFFFu;
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        crc = table[( crc ^ data[i] ) & 0xFF] ^ ( crc >> 8 );
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void putUint( std::vector<uint8_t>& out,
+              const uint64_t value,
+              const std::size_t bytes )
+{
+    for ( std::size_t i = 0; i < bytes; ++i )
+    {
+        out.push_back( static_cast<uint8_t>( value >> ( 8 * i ) ) );
+    }
+}
+
+void putDouble( std::vector<uint8_t>& out, const double value )
+{
+    uint64_t bits = 0;
+    std::memcpy( &bits, &value, sizeof( bits ) );
+    putUint( out, bits, sizeof( bits ) );
+}
+
+// Bounds checked little-endian reader, sticks to failed() once it overruns.
+class Reader
+{
+public:
+    Reader( const uint8_t* data, const std::size_t size ) noexcept
+        : m_data( data ), m_size( size )
+    {
+    }
+
+    uint64_t readUint( const std::size_t bytes ) noexcept
+    {
+        if ( !has( bytes ) )
+        {
+            return 0;
+        }
+        uint64_t value = 0;
+        for ( std::size_t i = 0; i < bytes; ++i )
+        {
+            value |= static_cast<uint64_t>( m_data[m_offset + i] ) << ( 8 * i );
+        }
+        m_offset += bytes;
+        return value;
+    }
+
+    double readDouble() noexcept
+    {
+        const auto bits = readUint( sizeof( uint64_t ) );
+        double value = 0.0;
+        std::memcpy( &value, &bits, sizeof( value ) );
+        return value;
+    }
+
+    std::string readString( const std::size_t bytes )
+    {
+        if ( !has( bytes ) )
+        {
+            return {};
+        }
+        std::string s( reinterpret_cast<const char*>( m_data + m_offset ),
+                       bytes );
+        m_offset += bytes;
+        return s;
+    }
+
+    // Fails the reader if fewer than count * bytesEach bytes remain, so a
+    // corrupt count can't trigger a huge allocation.
+    bool expect( const uint64_t count, const std::size_t bytesEach ) noexcept
+    {
+        if ( count > ( m_size - m_offset ) / bytesEach )
+        {
+            m_failed = true;
+        }
+        return !m_failed;
+    }
+
+    [[nodiscard]] bool failed() const noexcept
+    {
+        return m_failed;
+    }
+
+    [[nodiscard]] bool atEnd() const noexcept
+    {
+        return m_offset == m_size;
+    }
+
+private:
+    bool has( const std::size_t bytes ) noexcept
+    {
+        if ( m_failed || m_size - m_offset < bytes )
+        {
+            m_failed = true;
+        }
+        return !m_failed;
+    }
+
+    const uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_offset = 0;
+    bool m_failed = false;
+};
+
+void encodeBody( const settings::ProfileRecord& record,
+                 std::vector<uint8_t>& out )
+{
+    putUint( out, record.bools.size(), 4 );
+    putUint( out, record.ints.size(), 4 );
+    putUint( out, record.doubles.size(), 4 );
+    putUint( out, record.strings.size(), 4 );
+    for ( const auto value : record.bools )
+    {
+        out.push_back( value ? 1 : 0 );
+    }
+    for ( const auto value : record.ints )
+    {
+        putUint( out, static_cast<uint32_t>( value ), 4 );
+    }
+    for ( const auto value : record.doubles )
+    {
+        putDouble( out, value );
+    }
+    for ( const auto& value : record.strings )
+    {
+        putUint( out, value.size(), 4 );
+        out.insert( out.end(), value.begin(), value.end() );
+    }
+}
+
+bool decodeBody( Reader& r, settings::ProfileRecord& record )
+{
+    const auto boolCount = r.readUint( 4 );
+    const auto intCount = r.readUint( 4 );
+    const auto doubleCount = r.readUint( 4 );
+    const auto stringCount = r.readUint( 4 );
+
+    if ( r.expect( boolCount, 1 ) )
+    {
+        record.bools.resize( boolCount );
+        for ( std::size_t i = 0; i < boolCount; ++i )
+        {
+            record.bools[i] = r.readUint( 1 ) != 0;
+        }
+    }
+    if ( r.expect( intCount, 4 ) )
+    {
+        record.ints.resize( intCount );
+        for ( auto& value : record.ints )
+        {
+            value = static_cast<int32_t>( r.readUint( 4 ) );
+        }
+    }
+    if ( r.expect( doubleCount, 8 ) )
+    {
+        record.doubles.resize( doubleCount );
+        for ( auto& value : record.doubles )
+        {
+            value = r.readDouble();
+        }
+    }
+    if ( r.expect( stringCount, 4 ) )
+    {
+        record.strings.resize( stringCount );
+        for ( auto& value : record.strings )
+        {
+            value = r.readString( r.readUint( 4 ) );
+        }
+    }
+    return !r.failed() && r.atEnd();
+}
+
+} // namespace
+
+namespace settings
+{
+ProfileStoreStatus ProfileStore::decode( std::vector<uint8_t> data )
+{
+    m_entries.clear();
+    m_data = std::move( data );
+
+    Reader header( m_data.data(), std::min( m_data.size(), k_headerSize ) );
+    header.readUint( 4 );
+    const auto version = header.readUint( 2 );
+    header.readUint( 2 );
+    const auto entryCount = header.readUint( 4 );
+    if ( m_data.size() < k_magic.size()
+         || !std::equal( k_magic.begin(), k_magic.end(), m_data.data() ) )
+    {
+        return ProfileStoreStatus::Unsupported;
+    }
+    if ( version == 1 && !header.failed() )
+    {
+        return decodeVersion1( entryCount );
+    }
+
+    const auto indexSize = header.readUint( 4 );
+    const auto indexChecksum = static_cast<uint32_t>( header.readUint( 4 ) );
+    if ( header.failed() || version != k_version )
+    {
+        return ProfileStoreStatus::Unsupported;
+    }
+    if ( indexSize > m_data.size() - k_headerSize
+         || crc32( m_data.data() + k_headerSize, indexSize ) != indexChecksum )
+    {
+        // Without the index nothing can be located.
+        return ProfileStoreStatus::Damaged;
+    }
+
+    const auto bodiesStart = k_headerSize + indexSize;
+    const auto bodiesSize = m_data.size() - bodiesStart;
+    Reader index( m_data.data() + k_headerSize, indexSize );
+    for ( uint64_t i = 0; i < entryCount; ++i )
+    {
+        auto key = index.readString( index.readUint( 2 ) );
+        Entry entry;
+        entry.index.displayName = index.readString( index.readUint( 2 ) );
+        entry.index.flags = static_cast<uint32_t>( index.readUint( 4 ) );
+        const auto offset = index.readUint( 4 );
+        entry.index.bodySize = static_cast<uint32_t>( index.readUint( 4 ) );
+        entry.index.checksum = static_cast<uint32_t>( index.readUint( 4 ) );
+        if ( index.failed() || offset > bodiesSize
+             || entry.index.bodySize > bodiesSize - offset )
+        {
+            return ProfileStoreStatus::Damaged;
+        }
+        entry.inData = true;
+        entry.offset = bodiesStart + offset;
+        m_entries[std::move( key )] = std::move( entry );
+    }
+    return ProfileStoreStatus::Ok;
+}
+
+// Version 1 stored each record as u32 size | u32 CRC-32 | u16 name size
+// | name | body, without a separate index.
+ProfileStoreStatus ProfileStore::decodeVersion1( const std::size_t recordCount )
+{
+    constexpr std::size_t k_version1HeaderSize = 12;
+    auto status = ProfileStoreStatus::Ok;
+    std::size_t offset = k_version1HeaderSize;
+    for ( std::size_t i = 0; i < recordCount; ++i )
+    {
+        Reader recordHeader( m_data.data() + offset, m_data.size() - offset );
+        const auto payloadSize = recordHeader.readUint( 4 );
+        const auto checksum
+            = static_cast<uint32_t>( recordHeader.readUint( 4 ) );
+        if ( recordHeader.failed()
+             || payloadSize > m_data.size() - offset - 8 )
+        {
+            status = ProfileStoreStatus::Damaged;
+            break;
+        }
+        const auto payload = m_data.data() + offset + 8;
+        offset += 8 + payloadSize;
+
+        Reader r( payload, payloadSize );
+        const auto keySize = r.readUint( 2 );
+        const auto key = r.readString( keySize );
+        if ( r.failed() )
+        {
+            // Without a key the record can't be kept.
+            status = ProfileStoreStatus::Damaged;
+            continue;
+        }
+        const auto bodyStart = payload + 2 + keySize;
+        ProfileRecord record;
+        const auto decoded = decodeBody( r, record );
+        if ( crc32( payload, payloadSize ) == checksum && decoded )
+        {
+            set( key, record );
+            continue;
+        }
+
+        // Keeps the damaged body as it was, under a checksum it doesn't
+        // match, so load() refuses it but encode() writes it back.
+        Entry entry;
+        entry.body.assign( bodyStart, payload + payloadSize );
+        entry.index.displayName
+            = decoded && !record.strings.empty() ? record.strings.front()
+                                                 : std::string();
+        entry.index.bodySize = static_cast<uint32_t>( entry.body.size() );
+        entry.index.checksum
+            = crc32( entry.body.data(), entry.body.size() ) ^ 0xFFFFFFFFu;
+        m_entries[key] = std::move( entry );
+    }
+    m_data.clear();
+    return status;
+}
+
+std::vector<uint8_t> ProfileStore::encode() const
+{
+    std::vector<uint8_t> index;
+    std::size_t bodiesSize = 0;
+    for ( const auto& [key, entry] : m_entries )
+    {
+        putUint( index, key.size(), 2 );
+        index.insert( index.end(), key.begin(), key.end() );
+        const auto& name = entry.index.displayName;
+        putUint( index, name.size(), 2 );
+        index.insert( index.end(), name.begin(), name.end() );
+        putUint( index, entry.index.flags, 4 );
+        putUint( index, bodiesSize, 4 );
+        putUint( index, entry.index.bodySize, 4 );
+        putUint( index, entry.index.checksum, 4 );
+        bodiesSize += entry.index.bodySize;
+    }
+
+    std::vector<uint8_t> out;
+    out.reserve( k_headerSize + index.size() + bodiesSize );
+    out.insert( out.end(), k_magic.begin(), k_magic.end() );
+    putUint( out, k_version, 2 );
+    putUint( out, 0, 2 );
+    putUint( out, m_entries.size(), 4 );
+    putUint( out, index.size(), 4 );
+    putUint( out, crc32( index.data(), index.size() ), 4 );
+    out.insert( out.end(), index.begin(), index.end() );
+    for ( const auto& [key, entry] : m_entries )
+    {
+        const auto body = bodyData( entry );
+        out.insert( out.end(), body, body + entry.index.bodySize );
+    }
+    return out;
+}
+
+bool ProfileStore::contains( const std::string& key ) const
+{
+    return m_entries.count( key ) != 0;
+}
+
+const ProfileIndexEntry*
+    ProfileStore::indexEntry( const std::string& key ) const
+{
+    const auto it = m_entries.find( key );
+    return it == m_entries.end() ? nullptr : &it->second.index;
+}
+
+bool ProfileStore::load( const std::string& key, ProfileRecord& record ) const
+{
+    const auto it = m_entries.find( key );
+    if ( it == m_entries.end() )
+    {
+        return false;
+    }
+    const auto& entry = it->second;
+    const auto body = bodyData( entry );
+    if ( crc32( body, entry.index.bodySize ) != entry.index.checksum )
+    {
+        return false;
+    }
+    Reader r( body, entry.index.bodySize );
+    record = ProfileRecord{};
+    return decodeBody( r, record );
+}
+
+void ProfileStore::set( const std::string& key,
+                        const ProfileRecord& record,
+                        const uint32_t flags )
+{
+    Entry entry;
+    encodeBody( record, entry.body );
+    entry.index.displayName
+        = record.strings.empty() ? std::string() : record.strings.front();
+    entry.index.flags = flags;
+    entry.index.bodySize = static_cast<uint32_t>( entry.body.size() );
+    entry.index.checksum = crc32( entry.body.data(), entry.body.size() );
+    m_entries[key] = std::move( entry );
+}
+
+bool ProfileStore::rename( const std::string& from, const std::string& to )
+{
+    auto node = m_entries.extract( from );
+    if ( node.empty() )
+    {
+        return false;
+    }
+    m_entries.erase( to );
+    node.key() = to;
+    m_entries.insert( std::move( node ) );
+    return true;
+}
+
+bool ProfileStore::erase( const std::string& key )
+{
+    return m_entries.erase( key ) != 0;
+}
+
+std::size_t ProfileStore::size() const noexcept
+{
+    return m_entries.size();
+}
+
+const uint8_t* ProfileStore::bodyData( const Entry& entry ) const noexcept
+{
+    return entry.inData ? m_data.data() + entry.offset : entry.body.data();
+}
+
+} // namespace settings
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace settings
+{
+/*!
+   \brief Values of one saved \c ISettingsObject, in the order they were
+   added to its \c SettingsObjectData.
+ */
+struct ProfileRecord
+{
+    std::vector<bool> bools;
+    std::vector<int32_t> ints;
+    std::vector<double> doubles;
+    std::vector<std::string> strings;
+
+    bool operator==( const ProfileRecord& other ) const
+    {
+        return bools == other.bools && ints == other.ints
+               && doubles == other.doubles && strings == other.strings;
+    }
+};
+
+/*!
+   \brief What is known about a record without decoding its body.
+ */
+struct ProfileIndexEntry
+{
+    // First string value of the record, the profile name for all profiles.
+    std::string displayName;
+    uint32_t flags = 0;
+    uint32_t bodySize = 0;
+    // CRC-32 of the encoded body.
+    uint32_t checksum = 0;
+};
+
+enum class ProfileStoreStatus
+{
+    Ok,
+    // Not a profile store, or a version this build doesn't understand.
+    Unsupported,
+    // The index was cut off or failed its checksum, or a version 1 record
+    // couldn't be located. Records listed before the damage are kept,
+    // encode() would lose the rest.
+    Damaged,
+};
+
+/*!
+   \brief Binary store for \c ISettingsObject values, keyed by settings name.
+
+   Layout, all integers little-endian:
+
+   \code
+   header: "OVRP" | u16 version | u16 reserved | u32 entry count
+           | u32 index size | u32 CRC-32 of index
+   index:  per entry: u16 key size | key | u16 name size | name | u32 flags
+           | u32 body offset | u32 body size | u32 CRC-32 of body
+   bodies: u32 bool count | u32 int count | u32 double count
+           | u32 string count | bools as u8 | ints as i32
+           | doubles as IEEE 754 u64 | strings as u32 size + UTF-8 bytes
+   \endcode
+
+   Body offsets are relative to the first byte after the index.
+
+   decode() only reads the index, which is enough to list the profiles.
+   Bodies stay encoded until load() asks for them, so the work done at
+   startup doesn't depend on how large the saved profiles are. A body that
+   fails its checksum can't be loaded, but stays in the store byte for byte
+   and is written back unchanged by encode().
+
+   The store only converts to and from bytes, reading and writing the file
+   is left to the caller.
+ */
+class ProfileStore
+{
+public:
+    static constexpr uint16_t k_version = 2;
+
+    [[nodiscard]] ProfileStoreStatus decode( std::vector<uint8_t> data );
+    [[nodiscard]] std::vector<uint8_t> encode() const;
+
+    [[nodiscard]] bool contains( const std::string& key ) const;
+    // Returns nullptr if there is no record called key.
+    [[nodiscard]] const ProfileIndexEntry*
+        indexEntry( const std::string& key ) const;
+    // Decodes the body of key. Returns false if there is no such record or
+    // its body is damaged.
+    [[nodiscard]] bool load( const std::string& key,
+                             ProfileRecord& record ) const;
+
+    void set( const std::string& key,
+              const ProfileRecord& record,
+              const uint32_t flags = 0 );
+    // Moves the record at from to to, replacing any record at to. Returns
+    // whether from existed.
+    bool rename( const std::string& from, const std::string& to );
+    // Returns whether a record was removed.
+    bool erase( const std::string& key );
+    [[nodiscard]] std::size_t size() const noexcept;
+
+private:
+    struct Entry
+    {
+        ProfileIndexEntry index;
+        // Records that came from decode() point into m_data, records added
+        // by set() own their body.
+        bool inData = false;
+        std::size_t offset = 0;
+        std::vector<uint8_t> body;
+    };
+
+    [[nodiscard]] const uint8_t* bodyData( const Entry& entry ) const noexcept;
+    [[nodiscard]] ProfileStoreStatus
+        decodeVersion1( const std::size_t recordCount );
+
+    std::vector<uint8_t> m_data;
+    std::map<std::string, Entry> m_entries;
+};
+
+} // namespace settings
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include <easylogging++.h>
 #include "../overlaycontroller.h"
@@ -59,6 +61,173 @@ void setSetting( const StringSetting setting, const std::string value )
     settingController.setSetting( setting, value );
 }
 
+namespace
+{
+    template <typename Setting, typename Value>
+    void stage( std::vector<std::pair<Setting, Value>>& changes,
+                const Setting setting,
+                Value value )
+    {
+        const auto it = std::find_if(
+            changes.begin(), changes.end(), [setting]( const auto& change ) {
+                return change.first == setting;
+            } );
+        if ( it != changes.end() )
+        {
+            it->second = std::move( value );
+            return;
+        }
+        changes.emplace_back( setting, std::move( value ) );
+    }
+
+    template <typename Setting> bool isKnownSetting( const Setting setting )
+    {
+        const auto index = static_cast<int>( setting );
+        return index >= 0
+               && index <= static_cast<int>( Setting::LAST_ENUMERATOR );
+    }
+
+    template <typename Changes> bool areKnownSettings( const Changes& changes )
+    {
+        return std::all_of(
+            changes.begin(), changes.end(), []( const auto& change ) {
+                return isKnownSetting( change.first );
+            } );
+    }
+
+    template <typename Changes, typename Applied>
+    void applyChanges( const Changes& changes, Applied& applied )
+    {
+        for ( const auto& [setting, value] : changes )
+        {
+            if ( settingController.setSetting( setting, value ) )
+            {
+                applied.push_back( setting );
+            }
+        }
+    }
+
+    template <typename Setting>
+    bool contains( const std::vector<Setting>& settings, const Setting setting )
+    {
+        return std::find( settings.begin(), settings.end(), setting )
+               != settings.end();
+    }
+} // namespace
+
+void SettingsTransaction::set( const BoolSetting setting, const bool value )
+{
+    stage( m_bools, setting, value );
+}
+
+void SettingsTransaction::set( const DoubleSetting setting, const double value )
+{
+    stage( m_doubles, setting, value );
+}
+
+void SettingsTransaction::set( const IntSetting setting, const int value )
+{
+    stage( m_ints, setting, value );
+}
+
+void SettingsTransaction::set( const StringSetting setting, std::string value )
+{
+    stage( m_strings, setting, std::move( value ) );
+}
+
+bool SettingsTransaction::empty() const noexcept
+{
+    return m_bools.empty() && m_doubles.empty() && m_ints.empty()
+           && m_strings.empty();
+}
+
+bool AppliedSettings::contains( const BoolSetting setting ) const
+{
+    return settings::contains( bools, setting );
+}
+
+bool AppliedSettings::contains( const DoubleSetting setting ) const
+{
+    return settings::contains( doubles, setting );
+}
+
+bool AppliedSettings::contains( const IntSetting setting ) const
+{
+    return settings::contains( ints, setting );
+}
+
+bool AppliedSettings::contains( const StringSetting setting ) const
+{
+    return settings::contains( strings, setting );
+}
+
+bool AppliedSettings::empty() const noexcept
+{
+    return bools.empty() && doubles.empty() && ints.empty()
+           && strings.empty();
+}
+
+std::optional<AppliedSettings>
+    applySettings( const SettingsTransaction& transaction )
+{
+    const auto finite = std::all_of(
+        transaction.m_doubles.begin(),
+        transaction.m_doubles.end(),
+        []( const auto& change ) { return std::isfinite( change.second ); } );
+    if ( !areKnownSettings( transaction.m_bools )
+         || !areKnownSettings( transaction.m_doubles )
+         || !areKnownSettings( transaction.m_ints )
+         || !areKnownSettings( transaction.m_strings ) || !finite )
+    {
+        LOG( ERROR ) << "Settings transaction contains an invalid change, "
+                        "nothing was applied.";
+        return std::nullopt;
+    }
+
+    AppliedSettings applied;
+    applyChanges( transaction.m_bools, applied.bools );
+    applyChanges( transaction.m_doubles, applied.doubles );
+    applyChanges( transaction.m_ints, applied.ints );
+    applyChanges( transaction.m_strings, applied.strings );
+
+    if ( !applied.empty() )
+    {
+        settingController.saveChangedSettings();
+    }
+    return applied;
+}
+
+bool SettingValues::empty() const noexcept
+{
+    return bools.empty() && doubles.empty() && ints.empty()
+           && strings.empty();
+}
+
+std::size_t SettingValues::size() const noexcept
+{
+    return bools.size() + doubles.size() + ints.size() + strings.size();
+}
+
+SettingValues readSettingsFile( const std::string& fileName )
+{
+    return SettingsController::readSettingsFile( fileName );
+}
+
+SettingValues changedSettings( const SettingValues& values )
+{
+    return settingController.changedSettings( values );
+}
+
+std::optional<AnySetting> findSetting( const std::string& key )
+{
+    return SettingsController::findSetting( key );
+}
+
+uint64_t settingsFileWrites()
+{
+    return settingController.writeCount();
+}
+
 std::string initializeAndGetSettingsPath()
 {
     // The static object is initialized the first time the function is called.
@@ -1,5 +1,10 @@
 #pragma once
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <utility>
+#include <variant>
+#include <vector>
 
 namespace settings
 {
@@ -37,6 +42,7 @@ enum class BoolSetting
     APPLICATION_openXRWorkAround,
     APPLICATION_autoApplyChaperone,
     APPLICATION_desktopModeToggle,
+    APPLICATION_sessionRecordingEnabled,
 
     AUDIO_pttEnabled,
     AUDIO_pttShowNotification,
@@ -47,6 +53,7 @@ enum class BoolSetting
     UTILITY_alarmIsModal,
     UTILITY_vrcDebug,
     UTILITY_trackerOverlayEnabled,
+    UTILITY_nowPlayingOverlayEnabled,
 
     VIDEO_brightnessEnabled,
     VIDEO_isOverlayMethodActive,
@@ -114,7 +121,8 @@ enum class StringSetting
     APPLICATION_autoApplyChaperoneName,
 
     // LAST_ENUMERATOR must always be set to the last value
-    LAST_ENUMERATOR = APPLICATION_autoApplyChaperoneName,
+    AUDIO_rules,
+    LAST_ENUMERATOR = AUDIO_rules,
 };
 
 enum class IntSetting
@@ -132,6 +140,8 @@ enum class IntSetting
     UTILITY_alarmMinute,
     UTILITY_alarmSecond,
 
+    CHAPERONE_poseStreamRateHz,
+
     ROTATION_autoturnLinearTurnSpeed,
     // LAST_ENUMERATOR must always be set to the last value
     ROTATION_autoturnMode,
@@ -158,4 +168,92 @@ void setSetting( const IntSetting setting, const int value );
 [[nodiscard]] std::string getSetting( const StringSetting setting );
 void setSetting( const StringSetting setting, const std::string value );
 
+// The settings whose value an applied transaction actually changed.
+struct AppliedSettings
+{
+    std::vector<BoolSetting> bools;
+    std::vector<DoubleSetting> doubles;
+    std::vector<IntSetting> ints;
+    std::vector<StringSetting> strings;
+
+    [[nodiscard]] bool contains( const BoolSetting setting ) const;
+    [[nodiscard]] bool contains( const DoubleSetting setting ) const;
+    [[nodiscard]] bool contains( const IntSetting setting ) const;
+    [[nodiscard]] bool contains( const StringSetting setting ) const;
+    [[nodiscard]] bool empty() const noexcept;
+};
+
+/*!
+A set of setting changes that is applied as a whole by applySettings().
+
+Staging the same setting twice keeps the last value.
+*/
+class SettingsTransaction
+{
+public:
+    void set( const BoolSetting setting, const bool value );
+    void set( const DoubleSetting setting, const double value );
+    void set( const IntSetting setting, const int value );
+    void set( const StringSetting setting, std::string value );
+
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    friend std::optional<AppliedSettings>
+        applySettings( const SettingsTransaction& transaction );
+
+    std::vector<std::pair<BoolSetting, bool>> m_bools;
+    std::vector<std::pair<DoubleSetting, double>> m_doubles;
+    std::vector<std::pair<IntSetting, int>> m_ints;
+    std::vector<std::pair<StringSetting, std::string>> m_strings;
+};
+
+/*!
+Validates every change in transaction and only then applies all of them.
+The changed settings are handed to the writer thread as one batch.
+
+Returns std::nullopt and changes nothing if any staged change is invalid.
+Otherwise returns the settings that changed, so callers can send their
+change notifications once everything is applied.
+*/
+[[nodiscard]] std::optional<AppliedSettings>
+    applySettings( const SettingsTransaction& transaction );
+
+// Setting values, e.g. the ones stored in the settings file.
+struct SettingValues
+{
+    std::vector<std::pair<BoolSetting, bool>> bools;
+    std::vector<std::pair<DoubleSetting, double>> doubles;
+    std::vector<std::pair<IntSetting, int>> ints;
+    std::vector<std::pair<StringSetting, std::string>> strings;
+
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+};
+
+/*!
+Reads every setting stored in the settings file at fileName. Settings the
+file doesn't contain or that can't be converted are left out.
+
+Uses its own QSettings instance, so it can be called from any thread.
+*/
+[[nodiscard]] SettingValues readSettingsFile( const std::string& fileName );
+
+/*!
+Returns the values that differ from the ones in memory. Settings changed in
+memory that aren't written yet are left out, the pending write wins.
+*/
+[[nodiscard]] SettingValues changedSettings( const SettingValues& values );
+
+using AnySetting
+    = std::variant<BoolSetting, DoubleSetting, IntSetting, StringSetting>;
+
+// Looks up a setting by its key in the settings file, e.g.
+// "videoSettings/colorRedNew".
+[[nodiscard]] std::optional<AnySetting> findSetting( const std::string& key );
+
+// Number of times the settings file was written so far. Can be called from
+// any thread.
+[[nodiscard]] uint64_t settingsFileWrites();
+
 } // namespace settings
@@ -0,0 +1,106 @@
+#include "settings_file_watcher.h"
+#include <QFileInfo>
+#include <easylogging++.h>
+
+namespace settings
+{
+SettingsFileWatcher::SettingsFileWatcher( QObject* parent ) : QObject( parent )
+{
+    m_debounce.setSingleShot( true );
+    m_debounce.setInterval( k_debounceMs );
+
+    connect( &m_watcher,
+             SIGNAL( fileChanged( QString ) ),
+             this,
+             SLOT( OnFileChanged() ) );
+    connect(
+        &m_debounce, SIGNAL( timeout() ), this, SLOT( OnDebounceTimeout() ) );
+}
+
+SettingsFileWatcher::~SettingsFileWatcher()
+{
+    // The worker posts its result to this object, which drops it once
+    // destroyed. It must not outlive the object though.
+    if ( m_parse.valid() )
+    {
+        m_parse.wait();
+    }
+}
+
+void SettingsFileWatcher::watch( const std::string& fileName )
+{
+    m_fileName = fileName;
+    if ( !m_watcher.addPath( QString::fromStdString( fileName ) ) )
+    {
+        LOG( WARNING ) << "Could not watch settings file '" << fileName
+                       << "', external changes won't be picked up.";
+        return;
+    }
+    LOG( INFO ) << "Watching settings file '" << fileName << "'.";
+}
+
+void SettingsFileWatcher::OnFileChanged()
+{
+    m_debounce.start();
+}
+
+void SettingsFileWatcher::OnDebounceTimeout()
+{
+    // Replacing the file removes it from the watcher.
+    const auto path = QString::fromStdString( m_fileName );
+    if ( !m_watcher.files().contains( path ) )
+    {
+        if ( !QFileInfo::exists( path ) )
+        {
+            // Not written back yet, check again later.
+            m_debounce.start();
+            return;
+        }
+        m_watcher.addPath( path );
+    }
+    startParse();
+}
+
+void SettingsFileWatcher::startParse()
+{
+    if ( m_parsing )
+    {
+        m_reparse = true;
+        return;
+    }
+    m_parsing = true;
+    m_reparse = false;
+
+    const auto writes = settingsFileWrites();
+    m_parse = std::async(
+        std::launch::async, [this, fileName = m_fileName, writes]() {
+            const auto values = readSettingsFile( fileName );
+            QMetaObject::invokeMethod(
+                this,
+                [this, values, writes]() { finishParse( values, writes ); },
+                Qt::QueuedConnection );
+        } );
+}
+
+void SettingsFileWatcher::finishParse( const SettingValues& values,
+                                       const uint64_t writes )
+{
+    m_parsing = false;
+    if ( m_reparse || settingsFileWrites() != writes )
+    {
+        startParse();
+        return;
+    }
+
+    const auto changes = changedSettings( values );
+    if ( changes.empty() )
+    {
+        return;
+    }
+    LOG( INFO ) << "Settings file changed outside of the application, "
+                   "applying "
+                << changes.size() << " changed settings.";
+    emit settingsChanged( changes );
+}
+
+} // namespace settings
@@ -0,0 +1,56 @@
+#pragma once
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QTimer>
+#include <cstdint>
+#include <future>
+#include <string>
+#include "settings.h"
+
+namespace settings
+{
+/*!
+Watches the settings file and reports values that were changed outside of
+the application, e.g. by a config file pushed out centrally.
+
+Change notifications are collected for k_debounceMs, since editors and
+QSettings replace the file in several steps. The file is then parsed on a
+worker thread. Only the comparison with the values in memory runs on the
+thread that owns the watcher, and settingsChanged() is emitted there with
+the values that actually differ.
+
+A file written by this process while it was being parsed is parsed again,
+since the result may predate that write.
+*/
+class SettingsFileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int k_debounceMs = 250;
+
+    explicit SettingsFileWatcher( QObject* parent = nullptr );
+    ~SettingsFileWatcher() override;
+
+    void watch( const std::string& fileName );
+
+signals:
+    void settingsChanged( const settings::SettingValues& changes );
+
+private slots:
+    void OnFileChanged();
+    void OnDebounceTimeout();
+
+private:
+    void startParse();
+    void finishParse( const SettingValues& values, const uint64_t writes );
+
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounce;
+    std::string m_fileName;
+    std::future<void> m_parse;
+    bool m_parsing = false;
+    bool m_reparse = false;
+};
+
+} // namespace settings
@@ -1,5 +1,10 @@
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QSettings>
+#include <easylogging++.h>
 #include "settings_object.h"
+#include "profile_store.h"
 
 namespace settings
 {
@@ -30,33 +35,6 @@ void addListToObject( std::list<Value>& list,
     }
 }
 
-template <typename Value>
-void saveListToDisk( std::list<Value> values,
-                     const std::string structName,
-                     const std::string typeName )
-{
-    auto& s = settings::getQSettings();
-
-    s.beginGroup( structName.c_str() );
-    s.beginWriteArray( typeName.c_str() );
-
-    for ( int i = 0; !values.empty(); ++i )
-    {
-        s.setArrayIndex( i );
-        if constexpr ( std::is_same<std::string, Value>::value )
-        {
-            s.setValue( typeName.c_str(), values.front().c_str() );
-        }
-        else
-        {
-            s.setValue( typeName.c_str(), values.front() );
-        }
-        values.pop_front();
-    }
-
-    s.endArray();
-    s.endGroup();
-}
 template <typename Value>
 std::list<Value> loadListFromDisk( const std::string structName,
                                    const std::string typeName )
@@ -109,7 +87,53 @@ std::list<Value> loadListFromDisk( const std::string structName,
     return list;
 }
 
-settings::SettingsObjectData loadSettingsObject( std::string objName )
+template <typename Value, typename Stored>
+std::vector<Stored> createVectorFromObject( settings::SettingsObjectData& obj )
+{
+    std::vector<Stored> values;
+    for ( auto& value : createListFromObject<Value>( obj ) )
+    {
+        values.push_back( static_cast<Stored>( value ) );
+    }
+    return values;
+}
+
+template <typename Value, typename Stored>
+void addVectorToObject( const std::vector<Stored>& values,
+                        settings::SettingsObjectData& obj )
+{
+    for ( const auto value : values )
+    {
+        obj.addValue( static_cast<Value>( value ) );
+    }
+}
+
+settings::ProfileRecord toRecord( settings::SettingsObjectData& s )
+{
+    settings::ProfileRecord r;
+    r.bools = createVectorFromObject<bool, bool>( s );
+    r.ints = createVectorFromObject<int, int32_t>( s );
+    r.doubles = createVectorFromObject<double, double>( s );
+    auto strings = createListFromObject<std::string>( s );
+    r.strings.assign( strings.begin(), strings.end() );
+    return r;
+}
+
+settings::SettingsObjectData toObject( const settings::ProfileRecord& r )
+{
+    settings::SettingsObjectData s;
+    addVectorToObject<bool>( r.bools, s );
+    addVectorToObject<int>( r.ints, s );
+    addVectorToObject<double>( r.doubles, s );
+    for ( const auto& value : r.strings )
+    {
+        s.addValue( value );
+    }
+    return s;
+}
+
+// Objects used to be stored as QSettings arrays, one group per object.
+settings::ProfileRecord loadRecordFromQSettings( const std::string& objName )
 {
     settings::SettingsObjectData s;
 
@@ -125,22 +149,187 @@ settings::SettingsObjectData loadSettingsObject( std::string objName )
     auto stringValues = loadListFromDisk<std::string>( objName, "strings" );
     addListToObject( stringValues, s );
 
-    return s;
+    return toRecord( s );
+}
+
+bool isQSettingsObjectGroup( const QString& group )
+{
+    auto& s = settings::getQSettings();
+    return s.contains( group + "/bools/size" )
+           || s.contains( group + "/ints/size" )
+           || s.contains( group + "/doubles/size" )
+           || s.contains( group + "/strings/size" );
+}
+
+QString profileStorePath()
+{
+    // Worked out once, the first call must come from the main thread since
+    // the shared QSettings instance isn't thread safe.
+    static const QString path
+        = QFileInfo( settings::getQSettings().fileName() ).absolutePath()
+          + "/profiles.bin";
+    return path;
+}
+
+// Set when profiles.bin couldn't be read completely. The store in memory is
+// then missing profiles, so the file is moved aside before the first write
+// would replace it.
+bool g_profileStoreNeedsBackup = false;
+
+bool backUpProfileStore()
+{
+    const auto path = profileStorePath();
+    if ( !QFile::exists( path ) )
+    {
+        g_profileStoreNeedsBackup = false;
+        return true;
+    }
+    auto backup = path + ".bad";
+    for ( int i = 2; QFile::exists( backup ); ++i )
+    {
+        backup = path + ".bad" + QString::number( i );
+    }
+    if ( !QFile::rename( path, backup ) )
+    {
+        return false;
+    }
+    LOG( WARNING ) << "Moved unreadable profile store to '"
+                   << backup.toStdString() << "', starting a new one.";
+    g_profileStoreNeedsBackup = false;
+    return true;
+}
+
+bool writeProfileStore( const settings::ProfileStore& store )
+{
+    if ( g_profileStoreNeedsBackup && !backUpProfileStore() )
+    {
+        LOG( ERROR ) << "Could not move unreadable profile store '"
+                     << profileStorePath().toStdString()
+                     << "' aside, not saving profiles over it.";
+        return false;
+    }
+
+    const auto data = store.encode();
+
+    // QSaveFile writes to a temporary file and renames it on commit, so a
+    // crash never leaves a half written store behind.
+    QSaveFile file( profileStorePath() );
+    const auto written
+        = file.open( QIODevice::WriteOnly )
+          && file.write( reinterpret_cast<const char*>( data.data() ),
+                         static_cast<qint64>( data.size() ) )
+                 == static_cast<qint64>( data.size() )
+          && file.commit();
+    if ( !written )
+    {
+        LOG( ERROR ) << "Could not write profile store '"
+                     << profileStorePath().toStdString()
+                     << "': " << file.errorString().toStdString();
+    }
+    return written;
+}
+
+// Set once migrateFromQSettings() ran, later loads don't look at QSettings.
+bool g_profileStoreMigrated = false;
+
+// Moves objects saved by older versions from the QSettings file into the
+// store. They are only removed from QSettings once the store is on disk.
+void migrateFromQSettings( settings::ProfileStore& store )
+{
+    g_profileStoreMigrated = true;
+    auto& s = settings::getQSettings();
+
+    QStringList migrated;
+    for ( const auto& group : s.childGroups() )
+    {
+        if ( isQSettingsObjectGroup( group ) )
+        {
+            store.set( group.toStdString(),
+                       loadRecordFromQSettings( group.toStdString() ) );
+            migrated.push_back( group );
+        }
+    }
+    if ( migrated.empty() || !writeProfileStore( store ) )
+    {
+        return;
+    }
+
+    for ( const auto& group : migrated )
+    {
+        s.remove( group );
+    }
+    LOG( INFO ) << "Moved " << migrated.size()
+                << " saved profiles to the profile store.";
 }
 
-void saveSettingsObject( settings::SettingsObjectData& s, std::string objName )
+settings::ProfileStore loadProfileStore()
 {
-    auto boolValues = createListFromObject<bool>( s );
-    saveListToDisk( boolValues, objName, "bools" );
+    settings::ProfileStore store;
 
-    auto intValues = createListFromObject<int>( s );
-    saveListToDisk( intValues, objName, "ints" );
+    QFile file( profileStorePath() );
+    if ( !file.exists() )
+    {
+        if ( !g_profileStoreMigrated )
+        {
+            migrateFromQSettings( store );
+        }
+        return store;
+    }
+    if ( !file.open( QIODevice::ReadOnly ) )
+    {
+        LOG( ERROR ) << "Could not open profile store '"
+                     << profileStorePath().toStdString()
+                     << "': " << file.errorString().toStdString();
+        g_profileStoreNeedsBackup = true;
+        return store;
+    }
+
+    const auto data = file.readAll();
+    const auto status = store.decode(
+        std::vector<uint8_t>( data.constBegin(), data.constEnd() ) );
+    g_profileStoreNeedsBackup = status != settings::ProfileStoreStatus::Ok;
+    if ( status == settings::ProfileStoreStatus::Unsupported )
+    {
+        LOG( ERROR ) << "Profile store '" << profileStorePath().toStdString()
+                     << "' has an unsupported format, profiles not loaded.";
+    }
+    else if ( status == settings::ProfileStoreStatus::Damaged )
+    {
+        LOG( WARNING ) << "Profile store '" << profileStorePath().toStdString()
+                       << "' is damaged, found " << store.size()
+                       << " intact profiles.";
+    }
+    return store;
+}
 
-    auto doubleValues = createListFromObject<double>( s );
-    saveListToDisk( doubleValues, objName, "doubles" );
+settings::ProfileStore& profileStore()
+{
+    // Read once, only the index is decoded until an object is loaded.
+    static settings::ProfileStore store = loadProfileStore();
+    return store;
+}
 
-    auto stringValues = createListFromObject<std::string>( s );
-    saveListToDisk( stringValues, objName, "strings" );
+settings::SettingsObjectData loadSettingsObject( const std::string& objName )
+{
+    settings::ProfileRecord record;
+    if ( !profileStore().load( objName, record ) )
+    {
+        if ( profileStore().contains( objName ) )
+        {
+            LOG( ERROR ) << "Saved object '" << objName
+                         << "' is damaged, loading defaults.";
+        }
+        return settings::SettingsObjectData{};
+    }
+    return toObject( record );
+}
+
+void saveSettingsObject( settings::SettingsObjectData& s,
+                         const std::string& objName,
+                         const uint32_t flags )
+{
+    profileStore().set( objName, toRecord( s ), flags );
+    writeProfileStore( profileStore() );
 }
 
 std::string appendSlotNumberToSettingsName( const std::string name,
@@ -156,7 +345,7 @@ namespace settings
 void saveObject( const ISettingsObject& obj )
 {
     auto s = obj.saveSettings();
-    saveSettingsObject( s, obj.settingsName() );
+    saveSettingsObject( s, obj.settingsName(), obj.indexFlags() );
 }
 
 void loadObject( ISettingsObject& obj )
@@ -170,7 +359,9 @@ void saveNumberedObject( const ISettingsObject& obj, const int slot )
 {
     auto s = obj.saveSettings();
     saveSettingsObject(
-        s, appendSlotNumberToSettingsName( obj.settingsName(), slot ) );
+        s,
+        appendSlotNumberToSettingsName( obj.settingsName(), slot ),
+        obj.indexFlags() );
 }
 
 void loadNumberedObject( ISettingsObject& obj, const int slot )
@@ -180,21 +371,88 @@ void loadNumberedObject( ISettingsObject& obj, const int slot )
     obj.loadSettings( s );
 }
 
-int getAmountOfSavedObjects( ISettingsObject& obj )
+void saveNumberedObjects( const std::string& settingsName,
+                          std::vector<SettingsObjectData> objects,
+                          const std::vector<uint32_t>& flags )
+{
+    auto& store = profileStore();
+
+    int slot = 1;
+    for ( auto& object : objects )
+    {
+        const auto index = static_cast<std::size_t>( slot - 1 );
+        store.set( appendSlotNumberToSettingsName( settingsName, slot ),
+                   toRecord( object ),
+                   index < flags.size() ? flags[index] : 0 );
+        ++slot;
+    }
+    // Drop slots left over from a longer list, otherwise deleted objects
+    // would be loaded again.
+    while (
+        store.erase( appendSlotNumberToSettingsName( settingsName, slot ) ) )
+    {
+        ++slot;
+    }
+
+    writeProfileStore( store );
+}
+
+void eraseNumberedObject( const ISettingsObject& obj, const int slot )
 {
-    auto& s = getQSettings();
+    auto& store = profileStore();
+    const auto name = obj.settingsName();
+
+    if ( !store.erase( appendSlotNumberToSettingsName( name, slot ) ) )
+    {
+        return;
+    }
+    // Only the keys move, the bodies are neither decoded nor copied.
+    for ( int i = slot + 1;
+          store.rename( appendSlotNumberToSettingsName( name, i ),
+                        appendSlotNumberToSettingsName( name, i - 1 ) );
+          ++i )
+    {
+    }
+
+    writeProfileStore( store );
+}
 
-    auto groups = s.childGroups();
+std::vector<ProfileIndexEntry> loadObjectIndex( const ISettingsObject& obj )
+{
+    const auto& store = profileStore();
+    const auto name = obj.settingsName();
 
+    std::vector<ProfileIndexEntry> index;
     for ( int i = 1;; ++i )
     {
-        const auto groupDoesNotContainSetting = !groups.contains(
-            appendSlotNumberToSettingsName( obj.settingsName(), i ).c_str() );
-        if ( groupDoesNotContainSetting )
+        const auto entry
+            = store.indexEntry( appendSlotNumberToSettingsName( name, i ) );
+        if ( entry == nullptr )
         {
-            return i - 1;
+            return index;
         }
+        index.push_back( *entry );
+    }
+}
+
+int getAmountOfSavedObjects( ISettingsObject& obj )
+{
+    return static_cast<int>( loadObjectIndex( obj ).size() );
+}
+
+void migrateProfileStore()
+{
+    if ( !QFile::exists( profileStorePath() ) )
+    {
+        settings::ProfileStore store;
+        migrateFromQSettings( store );
     }
+    g_profileStoreMigrated = true;
+}
+
+void preloadProfileStore()
+{
+    static_cast<void>( profileStore() );
 }
 
 } // namespace settings
@@ -1,5 +1,8 @@
 #pragma once
+#include <string>
+#include <vector>
 #include "internal/settings_object_data.h"
+#include "profile_store.h"
 
 namespace settings
 {
@@ -63,6 +66,16 @@ class ISettingsObject
        \return Internal identifier for saving/loading.
      */
     virtual std::string settingsName() const = 0;
+
+    /*!
+       \brief Flags stored in the profile index next to the object, so they
+       can be read without loading the object.
+       \return Object specific flags, 0 by default.
+     */
+    virtual uint32_t indexFlags() const
+    {
+        return 0;
+    }
 };
 
 /*!
@@ -91,24 +104,61 @@ void loadObject( ISettingsObject& obj );
  */
 void saveNumberedObject( const ISettingsObject& obj, const int slot );
 
+/*!
+   \brief Saves \a objects to the numbered slots of \a settingsName.
+   \param settingsName Name the objects are saved under.
+   \param objects Data of the objects, in slot order.
+
+   Saves the objects starting from \c slot 1 to \c slot
+   \c{objects.size()} and removes any higher slots that were saved before.
+   Everything is written to permanent storage in a single write.
+*/
+void saveNumberedObjects( const std::string& settingsName,
+                          std::vector<SettingsObjectData> objects,
+                          const std::vector<uint32_t>& flags );
+
+/*!
+   \brief Removes \a obj from \a slot and moves all higher slots down by one.
+   \param obj Object whose settings name is used.
+   \param slot Slot to remove.
+ */
+void eraseNumberedObject( const ISettingsObject& obj, const int slot );
+
+/*!
+   \brief Gets the index entries of the consecutive \a obj objects starting
+   from \c slot 1, without loading the objects themselves.
+   \param obj Object whose settings name is used.
+   \return One entry per slot, the first entry is \c slot 1.
+ */
+std::vector<ProfileIndexEntry> loadObjectIndex( const ISettingsObject& obj );
+
 /*!
    \brief Saves \a vec of \c ISettingsObject.
    \param vec Vector of \c ISettingsObject derived objects.
 
-   Saves the objects starting from \c slot 1 to \c slot \c{1 + vec.size()}.
+   Saves the objects starting from \c slot 1 to \c slot \c{vec.size()}.
+   Slots above that are removed.
 */
-template <class T> void saveAllObjects( const std::vector<T> vec )
+template <class T> void saveAllObjects( const std::vector<T>& vec )
 {
     static_assert(
         std::is_base_of<ISettingsObject, T>::value,
         "Only objects that inherit from ISettingsObject can be saved." );
 
-    auto i = 1;
+    std::vector<SettingsObjectData> objects;
+    std::vector<uint32_t> flags;
+    objects.reserve( vec.size() );
+    flags.reserve( vec.size() );
     for ( auto& p : vec )
     {
-        saveNumberedObject( p, i );
-        ++i;
+        objects.push_back( p.saveSettings() );
+        flags.push_back( p.indexFlags() );
     }
+
+    // We'll need to know which name the objects are saved under, even if
+    // vec is empty.
+    const auto o = T{};
+    saveNumberedObjects( o.settingsName(), std::move( objects ), flags );
 }
 
 /*!
@@ -172,4 +222,23 @@ void loadNumberedObject( ISettingsObject& obj, const int slot );
  */
 int getAmountOfSavedObjects( ISettingsObject& obj );
 
+/*!
+   \brief Moves profiles saved by older versions out of the QSettings file.
+
+   Uses the shared QSettings instance, so it must run on the main thread.
+   Call it before \c preloadProfileStore() is handed to a worker thread,
+   which then only reads the profile store file.
+ */
+void migrateProfileStore();
+
+/*!
+   \brief Reads the profile store from disk if that didn't happen yet.
+
+   Every other function here reads it on first use. Calling this ahead of
+   time from a worker thread, after \c migrateProfileStore(), moves the file
+   read out of the way. It is safe to call concurrently with the index
+   functions, which only read the store.
+ */
+void preloadProfileStore();
+
 } // namespace settings
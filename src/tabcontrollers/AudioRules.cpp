@@ -0,0 +1,376 @@
+#include "AudioRules.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <easylogging++.h>
+
+namespace audio_rules
+{
+namespace
+{
+    constexpr CompiledRules::Facts k_hmdRemovedFact = 1u << 0;
+    constexpr CompiledRules::Facts k_dashboardOpenFact = 1u << 1;
+    constexpr std::size_t k_fixedFactCount = 2;
+
+    std::string trim( const std::string& text )
+    {
+        const auto first = text.find_first_not_of( " \t\r" );
+        if ( first == std::string::npos )
+        {
+            return "";
+        }
+        const auto last = text.find_last_not_of( " \t\r" );
+        return text.substr( first, last - first + 1 );
+    }
+
+    std::vector<std::string> splitWords( const std::string& text )
+    {
+        std::vector<std::string> words;
+        std::istringstream stream( text );
+        std::string word;
+        while ( stream >> word )
+        {
+            words.push_back( word );
+        }
+        return words;
+    }
+
+    bool parseNumber( const std::string& word, float& value )
+    {
+        try
+        {
+            std::size_t used = 0;
+            value = std::stof( word, &used );
+            return used == word.size() && std::isfinite( value );
+        }
+        catch ( const std::exception& )
+        {
+            return false;
+        }
+    }
+
+    // Returns an error message, empty on success.
+    std::string parseCondition( const std::vector<std::string>& words,
+                                Condition& condition )
+    {
+        std::size_t i = 0;
+        if ( i < words.size() && words[i] == "not" )
+        {
+            condition.negated = true;
+            ++i;
+        }
+        if ( i >= words.size() )
+        {
+            return "missing condition";
+        }
+
+        const auto& name = words[i++];
+        const auto argumentCount = words.size() - i;
+        if ( name == "hmd_removed" || name == "dashboard_open" )
+        {
+            condition.type = name == "hmd_removed"
+                                 ? ConditionType::HmdRemoved
+                                 : ConditionType::DashboardOpen;
+            return argumentCount == 0 ? "" : name + " takes no argument";
+        }
+        if ( name == "chaperone_within" )
+        {
+            condition.type = ConditionType::ChaperoneWithin;
+            if ( argumentCount != 1
+                 || !parseNumber( words[i], condition.distance )
+                 || condition.distance < 0.0f )
+            {
+                return "chaperone_within needs a distance in meters";
+            }
+            return "";
+        }
+        if ( name == "app" )
+        {
+            condition.type = ConditionType::AppRunning;
+            if ( argumentCount != 1 )
+            {
+                return "app needs one app key";
+            }
+            condition.appKey = words[i];
+            return "";
+        }
+        return "unknown condition \"" + name + "\"";
+    }
+
+    std::string parseAction( const std::string& text, Action& action )
+    {
+        const auto words = splitWords( text );
+        if ( words.empty() )
+        {
+            return "missing action";
+        }
+
+        const auto& name = words[0];
+        if ( name == "mute" )
+        {
+            action.type = ActionType::MuteMic;
+            return words.size() == 1 ? "" : "mute takes no argument";
+        }
+        if ( name == "duck" )
+        {
+            action.type = ActionType::DuckMirror;
+            float percent = 0.0f;
+            if ( words.size() != 2 || !parseNumber( words[1], percent )
+                 || percent < 0.0f || percent > 100.0f )
+            {
+                return "duck needs a percentage between 0 and 100";
+            }
+            action.volume = percent / 100.0f;
+            return "";
+        }
+        if ( name == "mirror" )
+        {
+            action.type = ActionType::SwitchMirror;
+            // Device ids are taken verbatim up to the end of the line.
+            const auto id = trim( trim( text ).substr( name.size() ) );
+            if ( id.empty() )
+            {
+                return "mirror needs a device id or none";
+            }
+            action.mirrorDeviceId = id == "none" ? "" : id;
+            return "";
+        }
+        return "unknown action \"" + name + "\"";
+    }
+
+    std::string parseRule( const std::string& line, Rule& rule )
+    {
+        const auto arrow = line.find( "->" );
+        if ( arrow == std::string::npos )
+        {
+            return "missing \"->\"";
+        }
+
+        std::vector<std::string> conditionWords;
+        auto words = splitWords( line.substr( 0, arrow ) );
+        words.push_back( "and" );
+        for ( const auto& word : words )
+        {
+            if ( word != "and" )
+            {
+                conditionWords.push_back( word );
+                continue;
+            }
+            Condition condition;
+            const auto error = parseCondition( conditionWords, condition );
+            if ( !error.empty() )
+            {
+                return error;
+            }
+            rule.conditions.push_back( condition );
+            conditionWords.clear();
+        }
+
+        return parseAction( line.substr( arrow + 2 ), rule.action );
+    }
+} // namespace
+
+ParseResult parseRules( const std::string& text )
+{
+    ParseResult result;
+    std::istringstream stream( text );
+    std::string line;
+    int lineNumber = 0;
+    while ( std::getline( stream, line ) )
+    {
+        ++lineNumber;
+        line = trim( line );
+        if ( line.empty() || line[0] == '#' )
+        {
+            continue;
+        }
+
+        Rule rule;
+        const auto error = parseRule( line, rule );
+        if ( error.empty() )
+        {
+            result.rules.push_back( std::move( rule ) );
+        }
+        else
+        {
+            result.errors.push_back( "line " + std::to_string( lineNumber )
+                                     + ": " + error );
+        }
+    }
+    return result;
+}
+
+CompiledRules::CompiledRules( const std::vector<Rule>& rules )
+    : m_factCount( k_fixedFactCount )
+{
+    for ( const auto& rule : rules )
+    {
+        Predicate predicate;
+        bool fits = true;
+        for ( const auto& condition : rule.conditions )
+        {
+            Facts fact = 0;
+            if ( !factFor( condition, fact ) )
+            {
+                fits = false;
+                break;
+            }
+            ( condition.negated ? predicate.forbidden : predicate.required )
+                |= fact;
+        }
+        if ( !fits )
+        {
+            LOG( WARNING ) << "Audio rule dropped, the rules use more than "
+                           << k_maxFacts << " distinct conditions.";
+            continue;
+        }
+
+        predicate.action = rule.action.type;
+        predicate.volume = rule.action.volume;
+        if ( rule.action.type == ActionType::SwitchMirror )
+        {
+            const auto target = std::find( m_mirrorTargets.begin(),
+                                           m_mirrorTargets.end(),
+                                           rule.action.mirrorDeviceId );
+            predicate.mirrorTarget
+                = static_cast<int>( target - m_mirrorTargets.begin() );
+            if ( target == m_mirrorTargets.end() )
+            {
+                m_mirrorTargets.push_back( rule.action.mirrorDeviceId );
+            }
+        }
+        m_predicates.push_back( predicate );
+    }
+}
+
+// Finds the bit for the condition, assigning a new one the first time it is
+// seen. Returns false if all bits are taken.
+bool CompiledRules::factFor( const Condition& condition, Facts& fact )
+{
+    switch ( condition.type )
+    {
+    case ConditionType::HmdRemoved:
+        fact = k_hmdRemovedFact;
+        return true;
+    case ConditionType::DashboardOpen:
+        fact = k_dashboardOpenFact;
+        return true;
+    case ConditionType::ChaperoneWithin:
+        for ( const auto& distanceFact : m_distanceFacts )
+        {
+            if ( distanceFact.distance == condition.distance )
+            {
+                fact = distanceFact.fact;
+                return true;
+            }
+        }
+        break;
+    case ConditionType::AppRunning:
+        for ( const auto& appFact : m_appFacts )
+        {
+            if ( appFact.appKey == condition.appKey )
+            {
+                fact = appFact.fact;
+                return true;
+            }
+        }
+        break;
+    }
+
+    if ( m_factCount >= k_maxFacts )
+    {
+        return false;
+    }
+    fact = Facts{ 1 } << m_factCount++;
+    if ( condition.type == ConditionType::ChaperoneWithin )
+    {
+        m_distanceFacts.push_back( DistanceFact{ condition.distance, fact } );
+    }
+    else
+    {
+        m_appFacts.push_back( AppFact{ condition.appKey, fact } );
+    }
+    return true;
+}
+
+void CompiledRules::setSceneApp( const std::string& appKey )
+{
+    m_sceneAppFacts = 0;
+    for ( const auto& appFact : m_appFacts )
+    {
+        if ( appFact.appKey == appKey )
+        {
+            m_sceneAppFacts |= appFact.fact;
+        }
+    }
+}
+
+Decision CompiledRules::evaluate( const Frame& frame ) const noexcept
+{
+    Facts facts = m_sceneAppFacts;
+    if ( !frame.hmdPresent )
+    {
+        facts |= k_hmdRemovedFact;
+    }
+    if ( frame.dashboardOpen )
+    {
+        facts |= k_dashboardOpenFact;
+    }
+    // NaN compares false, so an unknown distance is never within.
+    for ( const auto& distanceFact : m_distanceFacts )
+    {
+        if ( frame.chaperoneDistance <= distanceFact.distance )
+        {
+            facts |= distanceFact.fact;
+        }
+    }
+
+    Decision decision;
+    for ( const auto& predicate : m_predicates )
+    {
+        if ( ( facts & predicate.required ) != predicate.required
+             || ( facts & predicate.forbidden ) != 0 )
+        {
+            continue;
+        }
+        switch ( predicate.action )
+        {
+        case ActionType::MuteMic:
+            decision.muteMic = true;
+            break;
+        case ActionType::DuckMirror:
+            decision.mirrorDuck
+                = std::min( decision.mirrorDuck, predicate.volume );
+            break;
+        case ActionType::SwitchMirror:
+            if ( decision.mirrorTarget == k_noMirrorTarget )
+            {
+                decision.mirrorTarget = predicate.mirrorTarget;
+            }
+            break;
+        }
+    }
+    return decision;
+}
+
+bool CompiledRules::empty() const noexcept
+{
+    return m_predicates.empty();
+}
+
+std::size_t CompiledRules::size() const noexcept
+{
+    return m_predicates.size();
+}
+
+bool CompiledRules::usesSceneApp() const noexcept
+{
+    return !m_appFacts.empty();
+}
+
+const std::string& CompiledRules::mirrorTarget( const int index ) const
+{
+    return m_mirrorTargets.at( static_cast<std::size_t>( index ) );
+}
+
+} // namespace audio_rules
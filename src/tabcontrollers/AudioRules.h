@@ -0,0 +1,162 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace audio_rules
+{
+enum class ConditionType
+{
+    HmdRemoved,
+    DashboardOpen,
+    // Any tracked HMD or controller within distance meters of the chaperone.
+    ChaperoneWithin,
+    // The scene application's app key equals appKey.
+    AppRunning,
+};
+
+struct Condition
+{
+    ConditionType type = ConditionType::HmdRemoved;
+    bool negated = false;
+    float distance = 0.0f;
+    std::string appKey;
+};
+
+enum class ActionType
+{
+    MuteMic,
+    // Lowers the mirror volume to volume times its value before ducking.
+    DuckMirror,
+    // Switches the mirror device, an empty id disables mirroring.
+    SwitchMirror,
+};
+
+struct Action
+{
+    ActionType type = ActionType::MuteMic;
+    float volume = 1.0f;
+    std::string mirrorDeviceId;
+};
+
+// All conditions have to hold for the action to apply.
+struct Rule
+{
+    std::vector<Condition> conditions;
+    Action action;
+};
+
+struct ParseResult
+{
+    std::vector<Rule> rules;
+    // One message per rejected line, the other lines are still parsed.
+    std::vector<std::string> errors;
+};
+
+/*!
+Parses one rule per line:
+
+    <condition> [and <condition> ...] -> <action>
+
+Conditions are "hmd_removed", "dashboard_open", "chaperone_within <meters>"
+and "app <app key>", each can be prefixed with "not". Actions are "mute",
+"duck <percent>" and "mirror <device id>" or "mirror none". Empty lines and
+lines starting with '#' are skipped.
+*/
+ParseResult parseRules( const std::string& text );
+
+// Everything the rules look at that changes per frame.
+struct Frame
+{
+    bool hmdPresent = true;
+    bool dashboardOpen = false;
+    // NaN while no tracked device has a known distance.
+    float chaperoneDistance = std::numeric_limits<float>::quiet_NaN();
+};
+
+constexpr int k_noMirrorTarget = -1;
+
+// What the matching rules ask for, compared between frames to only act on
+// changes.
+struct Decision
+{
+    bool muteMic = false;
+    // 1.0 while no duck rule matches, the lowest factor otherwise.
+    float mirrorDuck = 1.0f;
+    // Index into CompiledRules::mirrorTarget(), from the first matching
+    // mirror rule.
+    int mirrorTarget = k_noMirrorTarget;
+
+    bool operator==( const Decision& other ) const noexcept
+    {
+        return muteMic == other.muteMic && mirrorDuck == other.mirrorDuck
+               && mirrorTarget == other.mirrorTarget;
+    }
+    bool operator!=( const Decision& other ) const noexcept
+    {
+        return !( *this == other );
+    }
+};
+
+/*!
+Rules compiled into a flat predicate table.
+
+Every distinct condition becomes one bit of a fact mask. evaluate() derives
+the mask from the frame once and then only compares each predicate's
+required and forbidden bits against it, nothing is parsed, allocated or
+looked up per frame. The scene application only changes on events, so its
+bits are set by setSceneApp() instead of per frame.
+*/
+class CompiledRules
+{
+public:
+    using Facts = uint64_t;
+    static constexpr std::size_t k_maxFacts = 64;
+
+    CompiledRules() = default;
+    // Rules needing more than k_maxFacts distinct conditions are dropped
+    // with a warning.
+    explicit CompiledRules( const std::vector<Rule>& rules );
+
+    void setSceneApp( const std::string& appKey );
+
+    [[nodiscard]] Decision evaluate( const Frame& frame ) const noexcept;
+
+    [[nodiscard]] bool empty() const noexcept;
+    [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool usesSceneApp() const noexcept;
+    [[nodiscard]] const std::string& mirrorTarget( const int index ) const;
+
+private:
+    struct Predicate
+    {
+        Facts required = 0;
+        Facts forbidden = 0;
+        ActionType action = ActionType::MuteMic;
+        float volume = 1.0f;
+        int mirrorTarget = k_noMirrorTarget;
+    };
+
+    struct DistanceFact
+    {
+        float distance = 0.0f;
+        Facts fact = 0;
+    };
+    struct AppFact
+    {
+        std::string appKey;
+        Facts fact = 0;
+    };
+
+    bool factFor( const Condition& condition, Facts& fact );
+
+    std::vector<Predicate> m_predicates;
+    std::vector<DistanceFact> m_distanceFacts;
+    std::vector<AppFact> m_appFacts;
+    std::size_t m_factCount = 0;
+    std::vector<std::string> m_mirrorTargets;
+    Facts m_sceneAppFacts = 0;
+};
+
+} // namespace audio_rules
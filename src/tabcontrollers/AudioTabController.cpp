@@ -5,6 +5,7 @@
 #include "../settings/settings.h"
 #include "../settings/settings_object.h"
 #include "../utils/update_rate.h"
+#include "../openvr/ovr_application_wrapper.h"
 #ifdef _WIN32
 #    include "audiomanager/AudioManagerWindows.h"
 #elif __linux__
@@ -27,16 +28,20 @@ void AudioTabController::initStage1()
     audioManager.reset( new AudioManagerDummy() );
 #endif
     audioManager->init( this );
+#ifdef __linux__
+    // The PulseAudio backend is safe to call from any thread and only queues
+    // the request for its own.
+    m_pttService = std::make_unique<push_to_talk::PushToTalkService>(
+        [this]( bool muted ) { return audioManager->setMicMuted( muted ); } );
+#endif
     initOverride();
     m_playbackDevices = audioManager->getPlaybackDevices();
     m_recordingDevices = audioManager->getRecordingDevices();
     findPlaybackDeviceIndex( audioManager->getPlaybackDevId(), false );
-    char deviceId[1024];
-    vr::VRSettings()->GetString( vr::k_pch_audio_Section,
-                                 vr::k_pch_audio_PlaybackMirrorDevice_String,
-                                 deviceId,
-                                 1024,
-                                 &vrSettingsError );
+    const auto deviceId = ovr_settings_wrapper::settingsCache().getString(
+        vr::k_pch_audio_Section,
+        vr::k_pch_audio_PlaybackMirrorDevice_String,
+        &vrSettingsError );
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
         LOG( WARNING ) << "Could not read \""
@@ -137,6 +142,8 @@ void AudioTabController::reloadAudioSettings()
 
     setMicReversePtt(
         settings::getSetting( settings::BoolSetting::AUDIO_micReversePtt ) );
+
+    compileAudioRules();
 }
 
 float AudioTabController::mirrorVolume() const
@@ -170,6 +177,12 @@ bool AudioTabController::micReversePtt() const
     return settings::getSetting( settings::BoolSetting::AUDIO_micReversePtt );
 }
 
+QString AudioTabController::audioRules() const
+{
+    return QString::fromStdString(
+        settings::getSetting( settings::StringSetting::AUDIO_rules ) );
+}
+
 bool AudioTabController::audioProfileDefault() const
 {
     return m_isDefaultAudioProfile;
@@ -188,12 +201,10 @@ void AudioTabController::eventLoopTick()
     }
 
     vr::EVRSettingsError vrSettingsError;
-    char mirrorDeviceId[1024];
-    vr::VRSettings()->GetString( vr::k_pch_audio_Section,
-                                 vr::k_pch_audio_PlaybackMirrorDevice_String,
-                                 mirrorDeviceId,
-                                 1024,
-                                 &vrSettingsError );
+    const auto mirrorDeviceId = ovr_settings_wrapper::settingsCache().getString(
+        vr::k_pch_audio_Section,
+        vr::k_pch_audio_PlaybackMirrorDevice_String,
+        &vrSettingsError );
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
         LOG( WARNING ) << "Could not read \""
@@ -207,7 +218,24 @@ void AudioTabController::eventLoopTick()
         audioManager->setMirrorDevice( mirrorDeviceId );
         findMirrorDeviceIndex( audioManager->getMirrorDevId() );
         lastMirrorDevId = mirrorDeviceId;
+        refreshVolumeState();
+    }
+    else if ( !audioManager->reportsVolumeChanges() )
+    {
+        refreshVolumeState();
     }
+
+    eventLoopMutex.unlock();
+}
+
+/*!
+Reads the mirror and microphone volume and mute state from the audio manager.
+The setters only notify QML about values that actually changed.
+*/
+void AudioTabController::refreshVolumeState()
+{
+    std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
+
     if ( m_mirrorDeviceIndex >= 0 )
     {
         setMirrorVolume( audioManager->getMirrorVolume() );
@@ -216,10 +244,12 @@ void AudioTabController::eventLoopTick()
     if ( m_recordingDeviceIndex >= 0 )
     {
         setMicVolume( audioManager->getMicVolume() );
-        setMicMuted( audioManager->getMicMuted() );
+        // Would undo push-to-talk changes that weren't applied yet.
+        if ( !m_pttService || !m_pttService->pending() )
+        {
+            setMicMuted( audioManager->getMicMuted() );
+        }
     }
-
-    eventLoopMutex.unlock();
 }
 
 bool AudioTabController::pttChangeValid()
@@ -231,11 +261,11 @@ void AudioTabController::onPttStart()
 {
     if ( micReversePtt() )
     {
-        setMicMuted( true );
+        setMicMutedQueued( true );
     }
     else
     {
-        setMicMuted( false );
+        setMicMutedQueued( false );
     }
 }
 
@@ -255,11 +285,11 @@ void AudioTabController::onPttStop()
 {
     if ( micReversePtt() )
     {
-        setMicMuted( false );
+        setMicMutedQueued( false );
     }
     else
     {
-        setMicMuted( true );
+        setMicMutedQueued( true );
     }
 }
 
@@ -337,6 +367,134 @@ void AudioTabController::setMicMuted( bool value, bool notify )
     }
 }
 
+/*!
+Mutes for push-to-talk or an audio rule. With a push-to-talk service the
+backend is left to its thread, so neither the event loop lock nor the audio
+backend are waited for.
+*/
+void AudioTabController::setMicMutedQueued( bool value )
+{
+    if ( !m_pttService )
+    {
+        setMicMuted( value );
+        return;
+    }
+
+    if ( value != m_micMuted )
+    {
+        m_micMuted = value;
+        if ( !m_pttService->post( value, push_to_talk::Clock::now() ) )
+        {
+            LOG( WARNING ) << "Push-to-talk queue full, mute change dropped.";
+        }
+        emit micMutedChanged( value );
+    }
+}
+
+void AudioTabController::compileAudioRules()
+{
+    std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
+
+    const auto parsed = audio_rules::parseRules(
+        settings::getSetting( settings::StringSetting::AUDIO_rules ) );
+    for ( const auto& error : parsed.errors )
+    {
+        LOG( WARNING ) << "Audio rule ignored, " << error;
+    }
+
+    // Undo what the old rules did, the new ones start from scratch.
+    applyAudioRuleDecision( audio_rules::Decision{} );
+    m_audioRules = audio_rules::CompiledRules( parsed.rules );
+    m_sceneAppKnown = false;
+    if ( !m_audioRules.empty() )
+    {
+        LOG( INFO ) << "Compiled " << m_audioRules.size() << " audio rules.";
+    }
+}
+
+/*!
+Called every frame after the chaperone tab has looked at the poses. Backend
+calls only happen when the rules' decision changes, and never on this frame.
+*/
+void AudioTabController::evaluateAudioRules( const audio_rules::Frame& frame )
+{
+    if ( m_audioRules.empty() )
+    {
+        return;
+    }
+    // Only app rules need the scene app, and asking for it without one
+    // running logs warnings.
+    if ( !m_sceneAppKnown && m_audioRules.usesSceneApp() )
+    {
+        m_audioRules.setSceneApp( ovr_application_wrapper::getSceneAppID() );
+        m_sceneAppKnown = true;
+    }
+
+    const auto decision = m_audioRules.evaluate( frame );
+    if ( decision != m_audioRulesDecision )
+    {
+        applyAudioRuleDecision( decision );
+    }
+}
+
+void AudioTabController::onSceneApplicationChanged()
+{
+    m_sceneAppKnown = false;
+}
+
+/*!
+Mutes go through the push-to-talk service where there is one. The mirror
+isn't safe to change off the event loop on every backend, so those changes
+are queued to run after the current frame.
+*/
+void AudioTabController::applyAudioRuleDecision(
+    const audio_rules::Decision& decision )
+{
+    const auto previous = m_audioRulesDecision;
+    m_audioRulesDecision = decision;
+
+    if ( decision.muteMic != previous.muteMic )
+    {
+        if ( decision.muteMic )
+        {
+            m_micMutedBeforeRules = m_micMuted;
+        }
+        setMicMutedQueued( decision.muteMic || m_micMutedBeforeRules );
+    }
+
+    if ( decision.mirrorTarget != previous.mirrorTarget )
+    {
+        if ( previous.mirrorTarget == audio_rules::k_noMirrorTarget )
+        {
+            m_mirrorDeviceBeforeRules = audioManager->getMirrorDevId();
+        }
+        const auto deviceId
+            = decision.mirrorTarget == audio_rules::k_noMirrorTarget
+                  ? m_mirrorDeviceBeforeRules
+                  : m_audioRules.mirrorTarget( decision.mirrorTarget );
+        QMetaObject::invokeMethod(
+            this,
+            [this, deviceId]() {
+                std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
+                audioManager->setMirrorDevice( deviceId );
+            },
+            Qt::QueuedConnection );
+    }
+
+    if ( decision.mirrorDuck != previous.mirrorDuck )
+    {
+        if ( previous.mirrorDuck >= 1.0f )
+        {
+            m_mirrorVolumeBeforeDuck = m_mirrorVolume;
+        }
+        const auto volume = m_mirrorVolumeBeforeDuck * decision.mirrorDuck;
+        QMetaObject::invokeMethod(
+            this,
+            [this, volume]() { setMirrorVolume( volume ); },
+            Qt::QueuedConnection );
+    }
+}
+
 void AudioTabController::setMicProximitySensorCanMute( bool value, bool notify )
 {
     std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
@@ -402,6 +560,7 @@ void AudioTabController::setAudioProfileDefault( bool value, bool notify )
 void AudioTabController::onNewRecordingDevice()
 {
     findMicDeviceIndex( audioManager->getMicDevId() );
+    onVolumeStateChanged();
 }
 
 void AudioTabController::onNewPlaybackDevice()
@@ -421,6 +580,25 @@ void AudioTabController::onNewMirrorDevice()
     {
         findMirrorDeviceIndex( devid );
     }
+    onVolumeStateChanged();
+}
+
+void AudioTabController::onVolumeStateChanged()
+{
+    // Backends report from their own threads, and a dragged volume slider
+    // reports many changes in a row. One refresh on the event loop covers
+    // all changes reported until it runs.
+    if ( m_volumeRefreshQueued.exchange( true ) )
+    {
+        return;
+    }
+    QMetaObject::invokeMethod(
+        this,
+        [this]() {
+            m_volumeRefreshQueued = false;
+            refreshVolumeState();
+        },
+        Qt::QueuedConnection );
 }
 
 void AudioTabController::onDeviceStateChanged()
@@ -434,6 +612,7 @@ void AudioTabController::onDeviceStateChanged()
     findMicDeviceIndex( audioManager->getMicDevId(), false );
     emit playbackDeviceListChanged();
     emit recordingDeviceListChanged();
+    onVolumeStateChanged();
 }
 
 int AudioTabController::getPlaybackDeviceCount()
@@ -565,7 +744,7 @@ void AudioTabController::setMirrorDeviceIndex( int index, bool notify )
         if ( index == -1 )
         {
             vr::EVRSettingsError vrSettingsError;
-            vr::VRSettings()->RemoveKeyInSection(
+            ovr_settings_wrapper::settingsCache().removeKeyInSection(
                 vr::k_pch_audio_Section,
                 vr::k_pch_audio_PlaybackMirrorDevice_String,
                 &vrSettingsError );
@@ -589,10 +768,10 @@ void AudioTabController::setMirrorDeviceIndex( int index, bool notify )
                   && index != m_mirrorDeviceIndex )
         {
             vr::EVRSettingsError vrSettingsError;
-            vr::VRSettings()->SetString(
+            ovr_settings_wrapper::settingsCache().setString(
                 vr::k_pch_audio_Section,
                 vr::k_pch_audio_PlaybackMirrorDevice_String,
-                m_playbackDevices[static_cast<size_t>( index )].id().c_str(),
+                m_playbackDevices[static_cast<size_t>( index )].id(),
                 &vrSettingsError );
             if ( vrSettingsError != vr::VRSettingsError_None )
             {
@@ -877,7 +1056,7 @@ void AudioTabController::deleteAudioProfile( unsigned index )
         if ( audioProfiles.at( index ).defaultProfile )
         {
             vr::EVRSettingsError vrSettingsError;
-            vr::VRSettings()->RemoveKeyInSection(
+            ovr_settings_wrapper::settingsCache().removeKeyInSection(
                 vr::k_pch_audio_Section,
                 vr::k_pch_audio_PlaybackDeviceOverrideName_String,
                 &vrSettingsError );
@@ -891,7 +1070,7 @@ void AudioTabController::deleteAudioProfile( unsigned index )
                            vrSettingsError );
             }
 
-            vr::VRSettings()->RemoveKeyInSection(
+            ovr_settings_wrapper::settingsCache().removeKeyInSection(
                 vr::k_pch_audio_Section,
                 vr::k_pch_audio_RecordingDeviceOverrideName_String,
                 &vrSettingsError );
@@ -929,7 +1108,7 @@ void AudioTabController::setPlaybackOverride( bool value, bool notify )
     {
         m_isPlaybackOverride = value;
         vr::EVRSettingsError vrSettingsError;
-        vr::VRSettings()->SetBool(
+        ovr_settings_wrapper::settingsCache().setBool(
             vr::k_pch_audio_Section,
             vr::k_pch_audio_EnablePlaybackDeviceOverride_Bool,
             m_isPlaybackOverride,
@@ -952,7 +1131,7 @@ void AudioTabController::setRecordingOverride( bool value, bool notify )
     {
         m_isRecordingOverride = value;
         vr::EVRSettingsError vrSettingsError;
-        vr::VRSettings()->SetBool(
+        ovr_settings_wrapper::settingsCache().setBool(
             vr::k_pch_audio_Section,
             vr::k_pch_audio_EnableRecordingDeviceOverride_Bool,
             m_isRecordingOverride,
@@ -973,7 +1152,7 @@ void AudioTabController::setRecordingOverride( bool value, bool notify )
 void AudioTabController::initOverride()
 {
     vr::EVRSettingsError vrSettingsError;
-    auto temp = vr::VRSettings()->GetBool(
+    auto temp = ovr_settings_wrapper::settingsCache().getBool(
         vr::k_pch_audio_Section,
         vr::k_pch_audio_EnableRecordingDeviceOverride_Bool,
         &vrSettingsError );
@@ -989,7 +1168,7 @@ void AudioTabController::initOverride()
     {
         setRecordingOverride( temp );
     }
-    temp = vr::VRSettings()->GetBool(
+    temp = ovr_settings_wrapper::settingsCache().getBool(
         vr::k_pch_audio_Section,
         vr::k_pch_audio_EnablePlaybackDeviceOverride_Bool,
         &vrSettingsError );
@@ -1084,10 +1263,10 @@ int AudioTabController::getMirrorIndex( std::string str )
 void AudioTabController::setDefaultPlayback( int index, bool notify )
 {
     vr::EVRSettingsError vrSettingsError;
-    vr::VRSettings()->SetString(
+    ovr_settings_wrapper::settingsCache().setString(
         vr::k_pch_audio_Section,
         vr::k_pch_audio_PlaybackDeviceOverrideName_String,
-        m_playbackDevices[static_cast<size_t>( index )].id().c_str(),
+        m_playbackDevices[static_cast<size_t>( index )].id(),
         &vrSettingsError );
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
@@ -1107,10 +1286,10 @@ void AudioTabController::setDefaultPlayback( int index, bool notify )
 void AudioTabController::setDefaultMic( int index, bool notify )
 {
     vr::EVRSettingsError vrSettingsError;
-    vr::VRSettings()->SetString(
+    ovr_settings_wrapper::settingsCache().setString(
         vr::k_pch_audio_Section,
         vr::k_pch_audio_RecordingDeviceOverrideName_String,
-        m_recordingDevices[static_cast<size_t>( index )].id().c_str(),
+        m_recordingDevices[static_cast<size_t>( index )].id(),
         &vrSettingsError );
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
@@ -1132,7 +1311,7 @@ void AudioTabController::setDefaultMirror( int index, bool notify )
     if ( index == -1 )
     {
         vr::EVRSettingsError vrSettingsError;
-        vr::VRSettings()->RemoveKeyInSection(
+        ovr_settings_wrapper::settingsCache().removeKeyInSection(
             vr::k_pch_audio_Section,
             vr::k_pch_audio_PlaybackMirrorDevice_String,
             &vrSettingsError );
@@ -1152,10 +1331,10 @@ void AudioTabController::setDefaultMirror( int index, bool notify )
     else
     {
         vr::EVRSettingsError vrSettingsError;
-        vr::VRSettings()->SetString(
+        ovr_settings_wrapper::settingsCache().setString(
             vr::k_pch_audio_Section,
             vr::k_pch_audio_PlaybackMirrorDevice_String,
-            m_playbackDevices[static_cast<size_t>( index )].id().c_str(),
+            m_playbackDevices[static_cast<size_t>( index )].id(),
             &vrSettingsError );
         if ( vrSettingsError != vr::VRSettingsError_None )
         {
@@ -1228,6 +1407,8 @@ int AudioTabController::getDefaultAudioProfileIndex()
 
 void AudioTabController::shutdown()
 {
+    // Applies the queued push-to-talk changes before unmuting below.
+    m_pttService.reset();
     setMicMuted( false, true );
     std::string mID;
     bool hasDefaultProfile = false;
@@ -1335,4 +1516,18 @@ void AudioTabController::setPttShowNotification( bool value, bool notify )
     }
 }
 
+void AudioTabController::setAudioRules( QString value, bool notify )
+{
+    std::lock_guard<std::recursive_mutex> lock( eventLoopMutex );
+
+    settings::setSetting( settings::StringSetting::AUDIO_rules,
+                          value.toStdString() );
+    compileAudioRules();
+
+    if ( notify )
+    {
+        emit audioRulesChanged( value );
+    }
+}
+
 } // namespace advsettings
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <QObject>
+#include <atomic>
 #include <mutex>
 
 #include "audiomanager/AudioManager.h"
 #include <memory>
+#include "PushToTalkService.h"
+#include "AudioRules.h"
 #include "../utils/FrameRateUtils.h"
 #include "../settings/settings_object.h"
 
@@ -109,6 +112,8 @@ class AudioTabController : public QObject
     Q_PROPERTY( bool pttActive READ pttActive NOTIFY pttActiveChanged )
     Q_PROPERTY( bool pttShowNotification READ pttShowNotification WRITE
                     setPttShowNotification NOTIFY pttShowNotificationChanged )
+    Q_PROPERTY( QString audioRules READ audioRules WRITE setAudioRules NOTIFY
+                    audioRulesChanged )
 
 private:
     struct
@@ -138,16 +143,33 @@ class AudioTabController : public QObject
     bool m_pttActive = false;
 
     std::unique_ptr<AudioManager> audioManager;
+    // Only set where the audio backend can be used from the push-to-talk
+    // thread, push-to-talk mutes on the event loop otherwise. Declared after
+    // audioManager so it is stopped first.
+    std::unique_ptr<push_to_talk::PushToTalkService> m_pttService;
     std::vector<AudioDevice> m_recordingDevices;
     std::vector<AudioDevice> m_playbackDevices;
     std::string lastMirrorDevId;
 
     std::recursive_mutex eventLoopMutex;
+    std::atomic<bool> m_volumeRefreshQueued{ false };
+
+    audio_rules::CompiledRules m_audioRules;
+    audio_rules::Decision m_audioRulesDecision;
+    bool m_sceneAppKnown = false;
+    // What the rules changed, restored once no rule asks for it anymore.
+    bool m_micMutedBeforeRules = false;
+    float m_mirrorVolumeBeforeDuck = 0.0f;
+    std::string m_mirrorDeviceBeforeRules;
 
     void onPttStart();
     void onPttStop();
     void onPttEnabled();
     void onPttDisabled();
+    void setMicMutedQueued( bool value );
+    void refreshVolumeState();
+    void compileAudioRules();
+    void applyAudioRuleDecision( const audio_rules::Decision& decision );
 
     virtual vr::VROverlayHandle_t getNotificationOverlayHandle()
     {
@@ -183,6 +205,8 @@ class AudioTabController : public QObject
     void reloadAudioSettings();
 
     void eventLoopTick();
+    void evaluateAudioRules( const audio_rules::Frame& frame );
+    void onSceneApplicationChanged();
 
     bool pttChangeValid();
 
@@ -200,6 +224,7 @@ class AudioTabController : public QObject
     bool audioProfileDefault() const;
     bool playbackOverride() const;
     bool recordingOverride() const;
+    QString audioRules() const;
 
     void reloadAudioProfiles();
     void saveAudioProfiles();
@@ -219,6 +244,8 @@ class AudioTabController : public QObject
     void onNewPlaybackDevice();
     void onNewMirrorDevice();
     void onDeviceStateChanged();
+    // Can be called from any thread.
+    void onVolumeStateChanged();
     void shutdown();
 
     bool pttEnabled() const;
@@ -253,6 +280,8 @@ public slots:
     void setPttEnabled( bool value, bool notify = true );
     void setPttShowNotification( bool value, bool notify = true );
 
+    void setAudioRules( QString value, bool notify = true );
+
 signals:
     void playbackDeviceIndexChanged( int index );
 
@@ -281,5 +310,6 @@ public slots:
     void pttEnabledChanged( bool value );
     void pttActiveChanged( bool value );
     void pttShowNotificationChanged( bool value );
+    void audioRulesChanged( QString value );
 };
 } // namespace advsettings
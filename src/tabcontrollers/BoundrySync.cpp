@@ -14,141 +14,18 @@
 #include <string>
 #include <filesystem>
 #include <thread>
+#include <mutex>
 #include <chrono>
 #include <windows.h> // 必须包含
 #include "ChaperoneTabController.h"
 #include "DiscoveryProtocol.h"
+#include "DiscoveryBroadcaster.h"
+#include "PoseStream.h"
+#include "../settings/settings.h"
 #include <easylogging++.h>
 
 
 
-class DiscoveryBroadcaster {
-public:
-    // tcpPort: 告诉 Android 连接此 TCP 端口
-    // udpPort: UDP 广播的目标端口 (Android 监听端口)
-    DiscoveryBroadcaster(int tcpPort, int udpPort);
-    ~DiscoveryBroadcaster();
-
-    bool start();
-    void stop();
-
-    // 设置单播目标 IP。传入 "" (空字符串) 则只发广播。
-    void setTargetIP(const std::string& ip);
-
-private:
-    void workerLoop();
-
-    int m_tcpPort;
-    int m_udpPort;
-    
-    std::atomic<bool> m_isRunning;
-    std::thread m_workerThread;
-    SOCKET m_socket;
-
-    std::mutex m_ipMutex;
-    std::string m_targetIP;
-};
-DiscoveryBroadcaster::DiscoveryBroadcaster(int tcpPort, int udpPort)
-    : m_tcpPort(tcpPort), m_udpPort(udpPort), m_isRunning(false), m_socket(INVALID_SOCKET) {
-}
-
-DiscoveryBroadcaster::~DiscoveryBroadcaster() {
-    stop();
-}
-
-bool DiscoveryBroadcaster::start() {
-    if (m_isRunning) return true;
-
-    // 创建 UDP Socket
-    m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
-    if (m_socket == INVALID_SOCKET) {
-        std::cerr << "[PC] Create socket failed: " << WSAGetLastError() << std::endl;
-        return false;
-    }
-
-    // 启用广播
-    BOOL broadcast = TRUE;
-    if (setsockopt(m_socket, SOL_SOCKET, SO_BROADCAST, (char*)&broadcast, sizeof(broadcast)) < 0) {
-        std::cerr << "[PC] Setsockopt broadcast failed." << std::endl;
-        closesocket(m_socket);
-        return false;
-    }
-
-    m_isRunning = true;
-    m_workerThread = std::thread(&DiscoveryBroadcaster::workerLoop, this);
-    std::cout << "[PC] Discovery Service Started." << std::endl;
-    return true;
-}
-
-void DiscoveryBroadcaster::stop() {
-    if (!m_isRunning) return;
-    m_isRunning = false;
-
-    if (m_socket != INVALID_SOCKET) {
-        closesocket(m_socket);
-        m_socket = INVALID_SOCKET;
-    }
-
-    if (m_workerThread.joinable()) {
-        m_workerThread.join();
-    }
-    std::cout << "[PC] Discovery Service Stopped." << std::endl;
-}
-
-void DiscoveryBroadcaster::setTargetIP(const std::string& ip) {
-    std::lock_guard<std::mutex> lock(m_ipMutex);
-    m_targetIP = ip;
-    if (!ip.empty()) {
-        std::cout << "[PC] Added Unicast Target: " << ip << std::endl;
-    } else {
-        std::cout << "[PC] Unicast Target Cleared (Broadcast Only)." << std::endl;
-    }
-}
-
-void DiscoveryBroadcaster::workerLoop() {
-    // 准备数据包
-    DiscoveryPacket packet;
-    // 使用 htonl/htons 转为网络字节序 (Big Endian)
-    packet.magic = htonl(DISCOVERY_MAGIC);
-    packet.version = htons(DISCOVERY_VERSION);
-    packet.tcpPort = htons((uint16_t)m_tcpPort);
-    // 计算校验和 (注意：对已经转为网络序的数据进行计算)
-    packet.checksum = htonl(calculateChecksum(packet));
-
-    // 广播地址
-    sockaddr_in broadcastAddr;
-    broadcastAddr.sin_family = AF_INET;
-    broadcastAddr.sin_port = htons(m_udpPort);
-    broadcastAddr.sin_addr.s_addr = INADDR_BROADCAST;
-
-    while (m_isRunning) {
-        // 1. 发送广播
-        sendto(m_socket, (const char*)&packet, sizeof(packet), 0, 
-               (sockaddr*)&broadcastAddr, sizeof(broadcastAddr));
-
-        // 2. 发送单播 (如果设置了 IP)
-        std::string currentIP;
-        {
-            std::lock_guard<std::mutex> lock(m_ipMutex);
-            currentIP = m_targetIP;
-        }
-
-        if (!currentIP.empty()) {
-            sockaddr_in unicastAddr;
-            unicastAddr.sin_family = AF_INET;
-            unicastAddr.sin_port = htons(m_udpPort);
-            // 将字符串 IP 转为地址结构
-            if (inet_pton(AF_INET, currentIP.c_str(), &unicastAddr.sin_addr) == 1) {
-                sendto(m_socket, (const char*)&packet, sizeof(packet), 0, 
-                       (sockaddr*)&unicastAddr, sizeof(unicastAddr));
-            }
-        }
-
-        // 间隔 1 秒
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
-}
-
 // ==========================================
 // 1. 数据结构定义 (与 Android 端对齐)
 // ==========================================
@@ -218,10 +95,27 @@ class ChaperoneSyncClient {
     }
 
     void Run() {
-        clientSock = accept(listenSock, NULL, NULL);
-        if (clientSock == INVALID_SOCKET) return;
+        SOCKET listening;
+        {
+            std::lock_guard<std::mutex> lock(m_socketMutex);
+            listening = listenSock;
+        }
+        SOCKET accepted = accept(listening, NULL, NULL);
+        if (accepted == INVALID_SOCKET) return;
+        {
+            // Stop() 可能在 accept 返回之后才关掉监听, 此时它看不到新连接
+            std::lock_guard<std::mutex> lock(m_socketMutex);
+            if (m_stopping) {
+                closesocket(accepted);
+                return;
+            }
+            clientSock = accepted;
+        }
 
         std::cout << ">>> Quest Connected!" << std::endl;
+        // 已连接, 降低发现包频率
+        m_discoveryBroadcaster.setPeerConnected(true);
+        StartPoseSender(accepted);
 
         // 缓存上一次的中心点，防止微小抖动导致每一帧都 Commit
         Vector3 lastCenter = { 0,0,0 };
@@ -229,9 +123,10 @@ class ChaperoneSyncClient {
 
         while (true) {
             SteamVRChaperoneData data;
-            int ret = recv(clientSock, (char*)&data, sizeof(data), 0);
+            int ret = recv(accepted, (char*)&data, sizeof(data), 0);
             if (ret <= 0) {
                 std::cout << "Disconnected." << std::endl;
+                m_discoveryBroadcaster.setPeerConnected(false);
                 break;
             }
 
@@ -240,15 +135,32 @@ class ChaperoneSyncClient {
             }
         }
 
+        StopPoseSender();
+        std::lock_guard<std::mutex> lock(m_socketMutex);
+        closesocket(clientSock);
+        clientSock = INVALID_SOCKET;
     }
     void Stop() {
-        if (listenSock) {
+        std::lock_guard<std::mutex> lock(m_socketMutex);
+        m_stopping = true;
+        if (listenSock != INVALID_SOCKET) {
             closesocket(listenSock);
             listenSock = INVALID_SOCKET;
         }
+        // 让阻塞中的 recv 返回, 否则工作线程无法退出
+        if (clientSock != INVALID_SOCKET) {
+            shutdown(clientSock, SD_BOTH);
+        }
         m_discoveryBroadcaster.stop();
     }
 
+    // 由 mainEventLoop 每帧调用, 只做拷贝入队, 不会阻塞渲染循环
+    void PushPoses(const vr::TrackedDevicePose_t* devicePoses) {
+        m_poseStreamer.setRateHz(settings::getSetting(
+            settings::IntSetting::CHAPERONE_poseStreamRateHz));
+        m_poseStreamer.sampleFrame(devicePoses);
+    }
+
     bool PollEvent(vr::VREvent_t *event,uint32_t size) {
         return m_pHMD->PollNextEvent(event, size);
     }
@@ -257,9 +169,62 @@ class ChaperoneSyncClient {
     vr::IVRSystem* m_pHMD = nullptr;
     vr::IVRChaperoneSetup* m_pSetup = nullptr;
     advsettings::MoveCenterTabController* m_moveCenterTabController = nullptr;
-    DiscoveryBroadcaster m_discoveryBroadcaster{ 1191, DISCOVERY_PORT };
+    discovery::DiscoveryBroadcaster m_discoveryBroadcaster{ 1191, DISCOVERY_PORT };
+    // Run() 在工作线程, Stop() 在主线程, 两个句柄都由 m_socketMutex 保护
+    std::mutex m_socketMutex;
     SOCKET listenSock = INVALID_SOCKET;
     SOCKET clientSock = INVALID_SOCKET;
+    bool m_stopping = false;
+
+    // 位姿输出流: 渲染循环 -> SPSC 队列 -> 发送线程 -> clientSock
+    pose_stream::PoseStreamer m_poseStreamer;
+    std::thread m_poseSender;
+    std::atomic<bool> m_poseSenderRunning{ false };
+
+    void StartPoseSender(SOCKET sock) {
+        m_poseSenderRunning = true;
+        m_poseStreamer.setActive(true);
+        // sock 在 StopPoseSender() 返回之前不会被关闭
+        m_poseSender = std::thread(&ChaperoneSyncClient::PoseSenderLoop, this, sock);
+    }
+
+    void StopPoseSender() {
+        m_poseSenderRunning = false;
+        // 唤醒等待中的发送线程
+        m_poseStreamer.setActive(false);
+        if (m_poseSender.joinable()) {
+            m_poseSender.join();
+        }
+        // 丢弃残留的旧数据, 下次连接从新数据开始
+        pose_stream::PoseSample stale;
+        while (m_poseStreamer.popSample(stale)) {}
+    }
+
+    void PoseSenderLoop(SOCKET sock) {
+        pose_stream::PoseSample sample;
+        uint8_t frame[pose_stream::k_maxFrameSize];
+        uint32_t reportedDrops = 0;
+        while (m_poseSenderRunning) {
+            if (!m_poseStreamer.waitForSample(sample)) {
+                break;
+            }
+            const auto size = pose_stream::encodePoseSample(sample, frame, sizeof(frame));
+            size_t sent = 0;
+            while (sent < size && m_poseSenderRunning) {
+                int ret = send(sock, (const char*)frame + sent, (int)(size - sent), 0);
+                if (ret == SOCKET_ERROR) {
+                    // 连接已断开, 由 Run() 中的 recv 负责收尾
+                    return;
+                }
+                sent += ret;
+            }
+            const auto drops = m_poseStreamer.droppedSamples();
+            if (drops != reportedDrops) {
+                LOG(WARNING) << "[PoseStream] Network too slow, dropped " << drops - reportedDrops << " frames.";
+                reportedDrops = drops;
+            }
+        }
+    }
     void ProcessData(const SteamVRChaperoneData& data, Vector3& lastCenter, bool& hasSyncedOnce) {
         if(data.playAreaX <= 0 || data.playAreaZ <= 0) {
             LOG(INFO) << "[ChaperoneSync] updateChaperoneResetData";
@@ -343,6 +308,11 @@ void BoundrySyncStart(vr::IVRSystem* vr,advsettings::MoveCenterTabController* mo
         g_bRunning = false;
     }
 }
+void BoundrySyncPushPoses(const vr::TrackedDevicePose_t* devicePoses) {
+    if (g_bRunning) {
+        app.PushPoses(devicePoses);
+    }
+}
 void BoundrySyncStop(){
     g_bRunning = false;
     app.Stop();
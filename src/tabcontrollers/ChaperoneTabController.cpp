@@ -18,7 +18,7 @@ void ChaperoneTabController::initStage1()
         setFadeDistance( 0.0f, true );
     }
 
-    reloadChaperoneProfiles();
+    // The profiles are loaded by OverlayController on a startup task.
     initCenterMarkerOverlay();
     eventLoopTick( m_trackingUniverse, nullptr );
 }
@@ -60,12 +60,12 @@ ChaperoneTabController::~ChaperoneTabController()
 
 void ChaperoneTabController::reloadChaperoneProfiles()
 {
-    settings::loadAllObjects( chaperoneProfiles );
+    chaperoneProfiles.reload();
 }
 
-void ChaperoneTabController::saveChaperoneProfiles()
+float ChaperoneTabController::chaperoneDistance() const noexcept
 {
-    settings::saveAllObjects( chaperoneProfiles );
+    return m_chaperoneDistance;
 }
 
 void ChaperoneTabController::handleChaperoneWarnings( float distance )
@@ -101,6 +101,9 @@ void ChaperoneTabController::handleChaperoneWarnings( float distance )
                 false,
                 true );
             m_chaperoneSwitchToBeginnerActive = true;
+            parent->m_statisticsTabController.sessionRecorder()
+                .recordComfortEvent(
+                    statistics::ComfortFeature::ChaperoneBeginnerSwitch, 1 );
         }
         else if ( ( distance > activationDistance || !m_isHMDActive )
                   && m_chaperoneSwitchToBeginnerActive )
@@ -108,6 +111,9 @@ void ChaperoneTabController::handleChaperoneWarnings( float distance )
             setCollisionBoundStyle( m_chaperoneSwitchToBeginnerLastStyle,
                                     true );
             m_chaperoneSwitchToBeginnerActive = false;
+            parent->m_statisticsTabController.sessionRecorder()
+                .recordComfortEvent(
+                    statistics::ComfortFeature::ChaperoneBeginnerSwitch, 0 );
         }
     }
 
@@ -363,6 +369,7 @@ void ChaperoneTabController::eventLoopTick(
                 }
             }
         }
+        m_chaperoneDistance = minDistance;
         if ( !std::isnan( minDistance ) )
         {
             handleChaperoneWarnings( minDistance );
@@ -739,7 +746,7 @@ Q_INVOKABLE QString
     }
     else
     {
-        return QString::fromStdString( chaperoneProfiles[index].profileName );
+        return QString::fromStdString( chaperoneProfiles.name( index ) );
     }
 }
 
@@ -1234,23 +1241,11 @@ void ChaperoneTabController::addChaperoneProfile(
     bool includeForceBounds,
     bool includesProximityWarningSettings )
 {
-    ChaperoneProfile* profile = nullptr;
-    for ( auto& p : chaperoneProfiles )
-    {
-        if ( p.profileName.compare( name.toStdString() ) == 0 )
-        {
-            profile = &p;
-            break;
-        }
-    }
-    if ( !profile )
-    {
-        auto i = chaperoneProfiles.size();
-        chaperoneProfiles.emplace_back();
-        profile = &chaperoneProfiles[i];
-    }
-    profile->profileName = name.toStdString();
-    profile->includesChaperoneGeometry = includeGeometry;
+    const auto existing = chaperoneProfiles.find( name.toStdString() );
+    const auto index = existing ? *existing : chaperoneProfiles.append();
+    auto profile = *chaperoneProfiles.get( index );
+    profile.profileName = name.toStdString();
+    profile.includesChaperoneGeometry = includeGeometry;
     if ( includeGeometry )
     {
         vr::VRChaperoneSetup()->HideWorkingSetPreview();
@@ -1258,89 +1253,89 @@ void ChaperoneTabController::addChaperoneProfile(
         uint32_t quadCount = 0;
         vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo( nullptr,
                                                             &quadCount );
-        profile->chaperoneGeometryQuadCount = quadCount;
+        profile.chaperoneGeometryQuadCount = quadCount;
         for ( int i = 0; i < static_cast<int>( quadCount ); ++i )
         {
-            profile->chaperoneGeometryQuads.emplace_back();
+            profile.chaperoneGeometryQuads.emplace_back();
         }
 
         vr::VRChaperoneSetup()->GetLiveCollisionBoundsInfo(
-            profile->chaperoneGeometryQuads.data(), &quadCount );
+            profile.chaperoneGeometryQuads.data(), &quadCount );
         vr::VRChaperoneSetup()->GetWorkingStandingZeroPoseToRawTrackingPose(
-            &profile->standingCenter );
+            &profile.standingCenter );
         vr::VRChaperoneSetup()->GetWorkingPlayAreaSize(
-            &profile->playSpaceAreaX, &profile->playSpaceAreaZ );
+            &profile.playSpaceAreaX, &profile.playSpaceAreaZ );
     }
-    profile->includesVisibility = includeVisbility;
+    profile.includesVisibility = includeVisbility;
     if ( includeVisbility )
     {
-        profile->visibility = boundsVisibility();
+        profile.visibility = boundsVisibility();
     }
-    profile->includesFadeDistance = includeFadeDistance;
+    profile.includesFadeDistance = includeFadeDistance;
     if ( includeFadeDistance )
     {
-        profile->fadeDistance = m_fadeDistance;
-        profile->chaperoneDimHeight = chaperoneDimHeight();
+        profile.fadeDistance = m_fadeDistance;
+        profile.chaperoneDimHeight = chaperoneDimHeight();
     }
-    profile->includesCenterMarker = includeCenterMarker;
+    profile.includesCenterMarker = includeCenterMarker;
     if ( includeCenterMarker )
     {
-        profile->centerMarker = m_centerMarker;
-        profile->centerMarkerNew = centerMarkerNew();
+        profile.centerMarker = m_centerMarker;
+        profile.centerMarkerNew = centerMarkerNew();
     }
-    profile->includesPlaySpaceMarker = includePlaySpaceMarker;
+    profile.includesPlaySpaceMarker = includePlaySpaceMarker;
     if ( includePlaySpaceMarker )
     {
-        profile->playSpaceMarker = m_playSpaceMarker;
+        profile.playSpaceMarker = m_playSpaceMarker;
     }
-    profile->includesFloorBoundsMarker = includeFloorBounds;
+    profile.includesFloorBoundsMarker = includeFloorBounds;
     if ( includeFloorBounds )
     {
-        profile->floorBoundsMarker = m_chaperoneFloorToggle;
+        profile.floorBoundsMarker = m_chaperoneFloorToggle;
     }
-    profile->includesBoundsColor = includeBoundsColor;
+    profile.includesBoundsColor = includeBoundsColor;
     if ( includeBoundsColor )
     {
-        profile->boundsColor[0] = chaperoneColorR();
-        profile->boundsColor[1] = chaperoneColorG();
-        profile->boundsColor[2] = chaperoneColorB();
+        profile.boundsColor[0] = chaperoneColorR();
+        profile.boundsColor[1] = chaperoneColorG();
+        profile.boundsColor[2] = chaperoneColorB();
     }
-    profile->includesChaperoneStyle = includeChaperoneStyle;
+    profile.includesChaperoneStyle = includeChaperoneStyle;
     if ( includeChaperoneStyle )
     {
-        profile->chaperoneStyle
+        profile.chaperoneStyle
 
             = m_collisionBoundStyle;
     }
-    profile->includesForceBounds = includeForceBounds;
+    profile.includesForceBounds = includeForceBounds;
     if ( includeForceBounds )
     {
-        profile->forceBounds = m_forceBounds;
+        profile.forceBounds = m_forceBounds;
     }
-    profile->includesProximityWarningSettings
+    profile.includesProximityWarningSettings
         = includesProximityWarningSettings;
     if ( includesProximityWarningSettings )
     {
-        profile->enableChaperoneSwitchToBeginner
+        profile.enableChaperoneSwitchToBeginner
             = isChaperoneSwitchToBeginnerEnabled();
-        profile->chaperoneSwitchToBeginnerDistance
+        profile.chaperoneSwitchToBeginnerDistance
             = chaperoneSwitchToBeginnerDistance();
-        profile->enableChaperoneHapticFeedback
+        profile.enableChaperoneHapticFeedback
             = isChaperoneHapticFeedbackEnabled();
-        profile->chaperoneHapticFeedbackDistance
+        profile.chaperoneHapticFeedbackDistance
             = chaperoneHapticFeedbackDistance();
-        profile->enableChaperoneAlarmSound = isChaperoneAlarmSoundEnabled();
-        profile->chaperoneAlarmSoundLooping = isChaperoneAlarmSoundLooping();
-        profile->chaperoneAlarmSoundAdjustVolume
+        profile.enableChaperoneAlarmSound = isChaperoneAlarmSoundEnabled();
+        profile.chaperoneAlarmSoundLooping = isChaperoneAlarmSoundLooping();
+        profile.chaperoneAlarmSoundAdjustVolume
             = isChaperoneAlarmSoundAdjustVolume();
-        profile->chaperoneAlarmSoundDistance = chaperoneAlarmSoundDistance();
-        profile->enableChaperoneShowDashboard
+        profile.chaperoneAlarmSoundDistance = chaperoneAlarmSoundDistance();
+        profile.enableChaperoneShowDashboard
             = isChaperoneShowDashboardEnabled();
-        profile->chaperoneShowDashboardDistance
+        profile.chaperoneShowDashboardDistance
             = chaperoneShowDashboardDistance();
     }
 
-    saveChaperoneProfiles();
+    chaperoneProfiles.save( index, profile );
     emit chaperoneProfilesUpdated();
 }
 
@@ -1348,90 +1343,230 @@ void ChaperoneTabController::applyChaperoneProfile( unsigned index )
 {
     if ( index < chaperoneProfiles.size() )
     {
-        auto& profile = chaperoneProfiles[index];
-        if ( profile.includesChaperoneGeometry )
+        const auto profile = chaperoneProfiles.get( index );
+        if ( profile->includesChaperoneGeometry )
         {
             parent->m_moveCenterTabController.reset();
             vr::VRChaperoneSetup()->HideWorkingSetPreview();
             vr::VRChaperoneSetup()->RevertWorkingCopy();
+            // OpenVR takes the quads as non-const, the shared profile isn't
+            // handed out for writing.
+            auto quads = profile->chaperoneGeometryQuads;
             vr::VRChaperoneSetup()->SetWorkingCollisionBoundsInfo(
-                profile.chaperoneGeometryQuads.data(),
-                profile.chaperoneGeometryQuadCount );
+                quads.data(), profile->chaperoneGeometryQuadCount );
             vr::VRChaperoneSetup()->SetWorkingStandingZeroPoseToRawTrackingPose(
-                &profile.standingCenter );
+                &profile->standingCenter );
             vr::VRChaperoneSetup()->SetWorkingPlayAreaSize(
-                profile.playSpaceAreaX, profile.playSpaceAreaZ );
+                profile->playSpaceAreaX, profile->playSpaceAreaZ );
             vr::VRChaperoneSetup()->CommitWorkingCopy(
                 vr::EChaperoneConfigFile_Live );
             parent->m_moveCenterTabController.zeroOffsets();
         }
-        if ( profile.includesVisibility )
+        if ( profile->includesVisibility )
         {
-            setBoundsVisibility( profile.visibility );
+            setBoundsVisibility( profile->visibility );
         }
-        if ( profile.includesFadeDistance )
+        if ( profile->includesFadeDistance )
         {
-            setFadeDistance( profile.fadeDistance );
-            setChaperoneDimHeight( profile.chaperoneDimHeight );
+            setFadeDistance( profile->fadeDistance );
+            setChaperoneDimHeight( profile->chaperoneDimHeight );
         }
-        if ( profile.includesCenterMarker )
+        if ( profile->includesCenterMarker )
         {
-            setCenterMarker( profile.centerMarker );
-            setCenterMarkerNew( profile.centerMarkerNew );
+            setCenterMarker( profile->centerMarker );
+            setCenterMarkerNew( profile->centerMarkerNew );
         }
-        if ( profile.includesPlaySpaceMarker )
+        if ( profile->includesPlaySpaceMarker )
         {
-            setPlaySpaceMarker( profile.playSpaceMarker );
+            setPlaySpaceMarker( profile->playSpaceMarker );
         }
-        if ( profile.includesFloorBoundsMarker )
+        if ( profile->includesFloorBoundsMarker )
         {
-            setChaperoneFloorToggle( profile.floorBoundsMarker );
+            setChaperoneFloorToggle( profile->floorBoundsMarker );
         }
-        if ( profile.includesBoundsColor )
+        if ( profile->includesBoundsColor )
         {
-            setChaperoneColorR( profile.boundsColor[0] );
-            setChaperoneColorG( profile.boundsColor[1] );
-            setChaperoneColorB( profile.boundsColor[2] );
+            setChaperoneColorR( profile->boundsColor[0] );
+            setChaperoneColorG( profile->boundsColor[1] );
+            setChaperoneColorB( profile->boundsColor[2] );
         }
-        if ( profile.includesChaperoneStyle )
+        if ( profile->includesChaperoneStyle )
         {
-            setCollisionBoundStyle( profile.chaperoneStyle, true );
+            setCollisionBoundStyle( profile->chaperoneStyle, true );
         }
-        if ( profile.includesForceBounds )
+        if ( profile->includesForceBounds )
         {
-            setForceBounds( profile.forceBounds );
+            setForceBounds( profile->forceBounds );
         }
-        if ( profile.includesProximityWarningSettings )
+        if ( profile->includesProximityWarningSettings )
         {
-            setChaperoneSwitchToBeginnerDistance(
-                profile.chaperoneSwitchToBeginnerDistance );
-            setChaperoneSwitchToBeginnerEnabled(
-                profile.enableChaperoneSwitchToBeginner );
-            setChaperoneHapticFeedbackDistance(
-                profile.chaperoneHapticFeedbackDistance );
-            setChaperoneHapticFeedbackEnabled(
-                profile.enableChaperoneHapticFeedback );
-            setChaperoneAlarmSoundLooping( profile.chaperoneAlarmSoundLooping );
-            setChaperoneAlarmSoundAdjustVolume(
-                profile.chaperoneAlarmSoundAdjustVolume );
-            setChaperoneAlarmSoundDistance(
-                profile.chaperoneAlarmSoundDistance );
-            setChaperoneAlarmSoundEnabled( profile.enableChaperoneAlarmSound );
-            setChaperoneShowDashboardDistance(
-                profile.chaperoneShowDashboardDistance );
-            setChaperoneShowDashboardEnabled(
-                profile.enableChaperoneShowDashboard );
+            applyProximityWarningSettings( *profile );
         }
     }
 }
 
+// Applies all proximity warning settings of profile as one settings
+// transaction and sends the change signals once they're all applied.
+void ChaperoneTabController::applyProximityWarningSettings(
+    const ChaperoneProfile& profile )
+{
+    using settings::BoolSetting;
+    using settings::DoubleSetting;
+
+    const auto alarmWasEnabled = isChaperoneAlarmSoundEnabled();
+    const auto alarmWasLooping = isChaperoneAlarmSoundLooping();
+
+    settings::SettingsTransaction transaction;
+    transaction.set( DoubleSetting::CHAPERONE_switchToBeginnerDistance,
+                     static_cast<double>(
+                         profile.chaperoneSwitchToBeginnerDistance ) );
+    transaction.set( BoolSetting::CHAPERONE_chaperoneSwitchToBeginnerEnabled,
+                     profile.enableChaperoneSwitchToBeginner );
+    transaction.set(
+        DoubleSetting::CHAPERONE_hapticFeedbackDistance,
+        static_cast<double>( profile.chaperoneHapticFeedbackDistance ) );
+    transaction.set( BoolSetting::CHAPERONE_chaperoneHapticFeedbackEnabled,
+                     profile.enableChaperoneHapticFeedback );
+    transaction.set( BoolSetting::CHAPERONE_chaperoneAlarmSoundLooping,
+                     profile.chaperoneAlarmSoundLooping );
+    transaction.set( BoolSetting::CHAPERONE_chaperoneAlarmSoundAdjustVolume,
+                     profile.chaperoneAlarmSoundAdjustVolume );
+    transaction.set(
+        DoubleSetting::CHAPERONE_alarmSoundDistance,
+        static_cast<double>( profile.chaperoneAlarmSoundDistance ) );
+    transaction.set( BoolSetting::CHAPERONE_chaperoneAlarmSoundEnabled,
+                     profile.enableChaperoneAlarmSound );
+    transaction.set(
+        DoubleSetting::CHAPERONE_showDashboardDistance,
+        static_cast<double>( profile.chaperoneShowDashboardDistance ) );
+    transaction.set( BoolSetting::CHAPERONE_chaperoneShowDashboardEnabled,
+                     profile.enableChaperoneShowDashboard );
+
+    const auto applied = settings::applySettings( transaction );
+    if ( !applied )
+    {
+        LOG( ERROR ) << "Could not apply proximity warning settings of '"
+                     << profile.profileName << "'.";
+        return;
+    }
+
+    // Same side effects as the individual setters.
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneSwitchToBeginnerEnabled ) )
+    {
+        if ( !isChaperoneSwitchToBeginnerEnabled()
+             && m_chaperoneSwitchToBeginnerActive )
+        {
+            ovr_settings_wrapper::setInt32(
+                vr::k_pch_CollisionBounds_Section,
+                vr::k_pch_CollisionBounds_Style_Int32,
+                m_chaperoneSwitchToBeginnerLastStyle,
+                "" );
+        }
+        m_chaperoneSwitchToBeginnerActive = false;
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneHapticFeedbackEnabled ) )
+    {
+        m_chaperoneHapticFeedbackActive = false;
+        if ( m_chaperoneHapticFeedbackThread.joinable() )
+        {
+            m_chaperoneHapticFeedbackThread.join();
+        }
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneAlarmSoundLooping )
+         && alarmWasEnabled && m_chaperoneAlarmSoundActive )
+    {
+        if ( alarmWasLooping )
+        {
+            parent->playAlarm01Sound( alarmWasLooping );
+        }
+        else
+        {
+            parent->cancelAlarm01Sound();
+        }
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneAlarmSoundEnabled ) )
+    {
+        if ( !isChaperoneAlarmSoundEnabled() && m_chaperoneAlarmSoundActive )
+        {
+            parent->cancelAlarm01Sound();
+        }
+        m_chaperoneAlarmSoundActive = false;
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneShowDashboardEnabled ) )
+    {
+        m_chaperoneShowDashboardActive = false;
+    }
+
+    // Notifications //
+    if ( applied->contains(
+             DoubleSetting::CHAPERONE_switchToBeginnerDistance ) )
+    {
+        emit chaperoneSwitchToBeginnerDistanceChanged(
+            chaperoneSwitchToBeginnerDistance() );
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneSwitchToBeginnerEnabled ) )
+    {
+        emit chaperoneSwitchToBeginnerEnabledChanged(
+            isChaperoneSwitchToBeginnerEnabled() );
+    }
+    if ( applied->contains( DoubleSetting::CHAPERONE_hapticFeedbackDistance ) )
+    {
+        emit chaperoneHapticFeedbackDistanceChanged(
+            chaperoneHapticFeedbackDistance() );
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneHapticFeedbackEnabled ) )
+    {
+        emit chaperoneHapticFeedbackEnabledChanged(
+            isChaperoneHapticFeedbackEnabled() );
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneAlarmSoundLooping ) )
+    {
+        emit chaperoneAlarmSoundLoopingChanged(
+            isChaperoneAlarmSoundLooping() );
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneAlarmSoundAdjustVolume ) )
+    {
+        emit chaperoneAlarmSoundAdjustVolumeChanged(
+            isChaperoneAlarmSoundAdjustVolume() );
+    }
+    if ( applied->contains( DoubleSetting::CHAPERONE_alarmSoundDistance ) )
+    {
+        emit chaperoneAlarmSoundDistanceChanged(
+            chaperoneAlarmSoundDistance() );
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneAlarmSoundEnabled ) )
+    {
+        emit chaperoneAlarmSoundEnabledChanged(
+            isChaperoneAlarmSoundEnabled() );
+    }
+    if ( applied->contains( DoubleSetting::CHAPERONE_showDashboardDistance ) )
+    {
+        emit chaperoneShowDashboardDistanceChanged(
+            chaperoneShowDashboardDistance() );
+    }
+    if ( applied->contains(
+             BoolSetting::CHAPERONE_chaperoneShowDashboardEnabled ) )
+    {
+        emit chaperoneShowDashboardEnabledChanged(
+            isChaperoneShowDashboardEnabled() );
+    }
+}
+
 void ChaperoneTabController::deleteChaperoneProfile( unsigned index )
 {
     if ( index < chaperoneProfiles.size() )
     {
-        auto pos = chaperoneProfiles.begin() + index;
-        chaperoneProfiles.erase( pos );
-        saveChaperoneProfiles();
+        chaperoneProfiles.erase( index );
         emit chaperoneProfilesUpdated();
     }
 }
@@ -1439,19 +1574,12 @@ void ChaperoneTabController::deleteChaperoneProfile( unsigned index )
 std::pair<bool, unsigned>
     ChaperoneTabController::getChaperoneProfileIndexFromName( std::string name )
 {
-    std::pair<bool, unsigned> result = { false, 0 };
-    unsigned profileIndex = 0;
-    for ( auto& p : chaperoneProfiles )
+    const auto index = chaperoneProfiles.find( name );
+    if ( !index )
     {
-        if ( name == p.profileName )
-        {
-            result.first = true;
-            result.second = profileIndex;
-            break;
-        }
-        profileIndex++;
+        return { false, 0 };
     }
-    return result;
+    return { true, static_cast<unsigned>( *index ) };
 }
 
 void ChaperoneTabController::createNewAutosaveProfile()
@@ -1477,9 +1605,10 @@ void ChaperoneTabController::createNewAutosaveProfile()
         = getChaperoneProfileIndexFromName( "«Autosaved Profile»" );
     if ( currentAutosaveIndexLookup.first )
     {
-        chaperoneProfiles[currentAutosaveIndexLookup.second].profileName
-            = "«Autosaved Profile (previous)»";
-        saveChaperoneProfiles();
+        auto profile
+            = *chaperoneProfiles.get( currentAutosaveIndexLookup.second );
+        profile.profileName = "«Autosaved Profile (previous)»";
+        chaperoneProfiles.save( currentAutosaveIndexLookup.second, profile );
         emit chaperoneProfilesUpdated();
     }
     else
@@ -10,6 +10,7 @@
 #include "../utils/FrameRateUtils.h"
 #include "../utils/ChaperoneUtils.h"
 #include "../settings/settings_object.h"
+#include "../settings/profile_list.h"
 #include "MoveCenterTabController.h"
 #include "../openvr/ovr_overlay_wrapper.h"
 #include "../openvr/ovr_settings_wrapper.h"
@@ -248,6 +249,14 @@ struct ChaperoneProfile : settings::ISettingsObject
     {
         return "ChaperoneTabController::ChaperoneProfile";
     }
+
+    // Lets the index tell geometry profiles apart without loading them.
+    static constexpr uint32_t k_indexFlagIncludesGeometry = 1;
+
+    virtual uint32_t indexFlags() const override
+    {
+        return includesChaperoneGeometry ? k_indexFlagIncludesGeometry : 0;
+    }
 };
 
 class ChaperoneTabController : public QObject
@@ -368,6 +377,7 @@ class ChaperoneTabController : public QObject
     bool m_autosaveComplete = false;
 
     int m_updateTicksChaperoneReload = 0;
+    float m_chaperoneDistance = NAN;
 
     vr::VRActionHandle_t m_rightActionHandle;
     vr::VRActionHandle_t m_leftActionHandle;
@@ -377,11 +387,12 @@ class ChaperoneTabController : public QObject
     vr::VROverlayHandle_t m_chaperoneFloorOverlayHandle
         = vr::k_ulOverlayHandleInvalid;
 
-    std::vector<ChaperoneProfile> chaperoneProfiles;
+    settings::ProfileList<ChaperoneProfile> chaperoneProfiles;
 
     std::string m_floorMarkerFN = "/res/img/chaperone/centermark.png";
     void initCenterMarkerOverlay();
     void updateCenterMarkerOverlayColor();
+    void applyProximityWarningSettings( const ChaperoneProfile& profile );
     void checkCenterMarkerOverlayRotationCount();
     int m_rotationUpdateCounter = 0;
     int m_rotationCurrent = 0;
@@ -404,6 +415,9 @@ class ChaperoneTabController : public QObject
                         vr::TrackedDevicePose_t* devicePoses );
     void dashboardLoopTick();
     void handleChaperoneWarnings( float distance );
+    // Closest distance of the HMD or a controller to the chaperone in the
+    // last eventLoopTick(), NaN if none was known.
+    float chaperoneDistance() const noexcept;
 
     void updateCenterMarkerOverlay( vr::HmdMatrix34_t* centerPlaySpaceMatrix );
 
@@ -452,7 +466,6 @@ class ChaperoneTabController : public QObject
     float chaperoneShowDashboardDistance() const;
 
     void reloadChaperoneProfiles();
-    void saveChaperoneProfiles();
 
     Q_INVOKABLE unsigned getChaperoneProfileCount();
     Q_INVOKABLE QString getChaperoneProfileName( unsigned index );
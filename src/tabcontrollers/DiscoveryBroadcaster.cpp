@@ -0,0 +1,538 @@
+#include "DiscoveryBroadcaster.h"
+#include "DiscoveryProtocol.h"
+#include <algorithm>
+#include <easylogging++.h>
+
+#ifdef _WIN32
+#    define _WINSOCK_DEPRECATED_NO_WARNINGS
+#    include <winsock2.h>
+#    include <ws2tcpip.h>
+#    include <iphlpapi.h>
+#    pragma comment( lib, "ws2_32.lib" )
+#    pragma comment( lib, "iphlpapi.lib" )
+#else
+#    include <arpa/inet.h>
+#    include <ifaddrs.h>
+#    include <net/if.h>
+#    include <netinet/in.h>
+#    include <sys/select.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+namespace discovery
+{
+namespace
+{
+#ifdef _WIN32
+    constexpr SocketHandle k_invalidSocket = INVALID_SOCKET;
+    void closeSocket( const SocketHandle s )
+    {
+        closesocket( static_cast<SOCKET>( s ) );
+    }
+    using SockLen = int;
+#else
+    constexpr SocketHandle k_invalidSocket = -1;
+    void closeSocket( const SocketHandle s )
+    {
+        close( s );
+    }
+    using SockLen = socklen_t;
+#endif
+
+    constexpr auto k_baseInterval = std::chrono::seconds( 1 );
+    constexpr auto k_maxInterval = std::chrono::seconds( 32 );
+    // Interfaces come and go (DHCP renewals, VPNs, Wi-Fi roaming), so the
+    // broadcast list is rebuilt periodically instead of only at start.
+    constexpr auto k_interfaceRefreshInterval = std::chrono::seconds( 30 );
+    // Upper bound on a single select() wait so stop() is honoured promptly
+    // even on platforms where closing the socket doesn't wake the waiter.
+    constexpr auto k_maxWaitSlice = std::chrono::milliseconds( 250 );
+
+    std::string addressToString( const uint32_t address )
+    {
+        in_addr a{};
+        a.s_addr = address;
+        char buffer[INET_ADDRSTRLEN] = {};
+        inet_ntop( AF_INET, &a, buffer, sizeof( buffer ) );
+        return buffer;
+    }
+
+    sockaddr_in makeAddress( const uint32_t address, const int port )
+    {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons( static_cast<uint16_t>( port ) );
+        addr.sin_addr.s_addr = address;
+        return addr;
+    }
+} // namespace
+
+BackoffSchedule::BackoffSchedule( const Clock::duration baseInterval,
+                                  const Clock::duration maxInterval ) noexcept
+    : m_baseInterval( baseInterval ),
+      m_maxInterval( std::max( baseInterval, maxInterval ) ),
+      m_interval( baseInterval )
+{
+}
+
+void BackoffSchedule::setPeerConnected( const bool connected,
+                                        const Clock::time_point now ) noexcept
+{
+    if ( connected == m_peerConnected )
+    {
+        return;
+    }
+    m_peerConnected = connected;
+    m_interval = m_baseInterval;
+    if ( !connected )
+    {
+        // Lost the peer, advertise again right away.
+        m_nextDeadline = now;
+    }
+}
+
+bool BackoffSchedule::peerConnected() const noexcept
+{
+    return m_peerConnected;
+}
+
+bool BackoffSchedule::isDue( const Clock::time_point now ) const noexcept
+{
+    return now >= m_nextDeadline;
+}
+
+void BackoffSchedule::onSent( const Clock::time_point now ) noexcept
+{
+    m_nextDeadline = now + m_interval;
+    if ( m_peerConnected )
+    {
+        m_interval = std::min( m_interval * 2, m_maxInterval );
+    }
+}
+
+Clock::time_point BackoffSchedule::nextDeadline() const noexcept
+{
+    return m_nextDeadline;
+}
+
+Clock::duration BackoffSchedule::currentInterval() const noexcept
+{
+    return m_interval;
+}
+
+TargetList::TargetList() noexcept
+{
+    for ( auto& slot : m_slots )
+    {
+        slot.store( k_emptySlot, std::memory_order_relaxed );
+    }
+}
+
+void TargetList::setManual( const uint32_t address ) noexcept
+{
+    m_slots[0].store( address, std::memory_order_release );
+}
+
+uint32_t TargetList::manual() const noexcept
+{
+    return m_slots[0].load( std::memory_order_acquire );
+}
+
+bool TargetList::learn( const uint32_t address ) noexcept
+{
+    if ( address == k_emptySlot )
+    {
+        return false;
+    }
+    for ( const auto& slot : m_slots )
+    {
+        if ( slot.load( std::memory_order_relaxed ) == address )
+        {
+            return false;
+        }
+    }
+    // Oldest learned entry is replaced once all slots are in use.
+    m_slots[m_nextLearnedSlot].store( address, std::memory_order_release );
+    m_nextLearnedSlot = m_nextLearnedSlot + 1 < k_slotCount
+                            ? m_nextLearnedSlot + 1
+                            : 1;
+    return true;
+}
+
+void TargetList::clearLearned() noexcept
+{
+    for ( std::size_t i = 1; i < k_slotCount; ++i )
+    {
+        m_slots[i].store( k_emptySlot, std::memory_order_release );
+    }
+    m_nextLearnedSlot = 1;
+}
+
+std::size_t
+    TargetList::snapshot( std::array<uint32_t, k_slotCount>& out ) const noexcept
+{
+    std::size_t count = 0;
+    for ( const auto& slot : m_slots )
+    {
+        const auto address = slot.load( std::memory_order_acquire );
+        if ( address == k_emptySlot )
+        {
+            continue;
+        }
+        if ( std::find( out.begin(), out.begin() + count, address )
+             == out.begin() + count )
+        {
+            out[count++] = address;
+        }
+    }
+    return count;
+}
+
+uint32_t directedBroadcast( const uint32_t address,
+                            const uint32_t netmask ) noexcept
+{
+    return address | ~netmask;
+}
+
+std::vector<uint32_t> enumerateBroadcastAddresses()
+{
+    std::vector<uint32_t> result;
+    auto add = [&result]( const uint32_t broadcast )
+    {
+        if ( std::find( result.begin(), result.end(), broadcast )
+             == result.end() )
+        {
+            result.push_back( broadcast );
+        }
+    };
+
+#ifdef _WIN32
+    ULONG size = 15 * 1024;
+    std::vector<unsigned char> buffer;
+    ULONG ret = ERROR_BUFFER_OVERFLOW;
+    for ( int attempt = 0; attempt < 3 && ret == ERROR_BUFFER_OVERFLOW;
+          ++attempt )
+    {
+        buffer.resize( size );
+        ret = GetAdaptersAddresses(
+            AF_INET,
+            GAA_FLAG_SKIP_ANYCAST | GAA_FLAG_SKIP_MULTICAST
+                | GAA_FLAG_SKIP_DNS_SERVER,
+            nullptr,
+            reinterpret_cast<IP_ADAPTER_ADDRESSES*>( buffer.data() ),
+            &size );
+    }
+    if ( ret != NO_ERROR )
+    {
+        LOG( WARNING ) << "[Discovery] GetAdaptersAddresses failed: " << ret;
+        return result;
+    }
+    for ( auto adapter
+          = reinterpret_cast<IP_ADAPTER_ADDRESSES*>( buffer.data() );
+          adapter != nullptr;
+          adapter = adapter->Next )
+    {
+        if ( adapter->OperStatus != IfOperStatusUp
+             || adapter->IfType == IF_TYPE_SOFTWARE_LOOPBACK )
+        {
+            continue;
+        }
+        for ( auto unicast = adapter->FirstUnicastAddress; unicast != nullptr;
+              unicast = unicast->Next )
+        {
+            const auto sa = reinterpret_cast<sockaddr_in*>(
+                unicast->Address.lpSockaddr );
+            if ( sa->sin_family != AF_INET )
+            {
+                continue;
+            }
+            ULONG mask = 0;
+            ConvertLengthToIpv4Mask( unicast->OnLinkPrefixLength, &mask );
+            add( directedBroadcast( sa->sin_addr.s_addr, mask ) );
+        }
+    }
+#else
+    ifaddrs* interfaces = nullptr;
+    if ( getifaddrs( &interfaces ) != 0 )
+    {
+        LOG( WARNING ) << "[Discovery] getifaddrs failed.";
+        return result;
+    }
+    for ( auto ifa = interfaces; ifa != nullptr; ifa = ifa->ifa_next )
+    {
+        if ( ifa->ifa_addr == nullptr || ifa->ifa_netmask == nullptr
+             || ifa->ifa_addr->sa_family != AF_INET
+             || !( ifa->ifa_flags & IFF_UP ) || ( ifa->ifa_flags & IFF_LOOPBACK )
+             || !( ifa->ifa_flags & IFF_BROADCAST ) )
+        {
+            continue;
+        }
+        const auto addr
+            = reinterpret_cast<sockaddr_in*>( ifa->ifa_addr )->sin_addr.s_addr;
+        const auto mask = reinterpret_cast<sockaddr_in*>( ifa->ifa_netmask )
+                              ->sin_addr.s_addr;
+        add( directedBroadcast( addr, mask ) );
+    }
+    freeifaddrs( interfaces );
+#endif
+
+    return result;
+}
+
+DiscoveryBroadcaster::DiscoveryBroadcaster( const int tcpPort,
+                                            const int udpPort,
+                                            TimeSource timeSource )
+    : m_tcpPort( tcpPort ), m_udpPort( udpPort ),
+      m_now( std::move( timeSource ) ), m_isRunning( false ),
+      m_peerConnected( false ), m_lastReplyAddress( TargetList::k_emptySlot ),
+      m_socket( k_invalidSocket ),
+      m_schedule( k_baseInterval, k_maxInterval )
+{
+}
+
+DiscoveryBroadcaster::~DiscoveryBroadcaster()
+{
+    stop();
+}
+
+bool DiscoveryBroadcaster::start()
+{
+    if ( m_isRunning )
+    {
+        return true;
+    }
+
+    const auto s = socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    m_socket = static_cast<SocketHandle>( s );
+    if ( m_socket == k_invalidSocket )
+    {
+        LOG( ERROR ) << "[Discovery] Create socket failed.";
+        return false;
+    }
+
+#ifdef _WIN32
+    BOOL broadcast = TRUE;
+#else
+    int broadcast = 1;
+#endif
+    if ( setsockopt( m_socket,
+                     SOL_SOCKET,
+                     SO_BROADCAST,
+                     reinterpret_cast<const char*>( &broadcast ),
+                     sizeof( broadcast ) )
+         < 0 )
+    {
+        LOG( ERROR ) << "[Discovery] Setsockopt broadcast failed.";
+        closeSocket( m_socket );
+        m_socket = k_invalidSocket;
+        return false;
+    }
+
+    // Bind to an ephemeral port so replies sent back to the source address
+    // of our broadcasts arrive on this socket.
+    auto any = makeAddress( htonl( INADDR_ANY ), 0 );
+    if ( bind( m_socket, reinterpret_cast<sockaddr*>( &any ), sizeof( any ) )
+         < 0 )
+    {
+        LOG( WARNING ) << "[Discovery] Bind failed, replies will be ignored.";
+    }
+
+    m_isRunning = true;
+    m_workerThread = std::thread( &DiscoveryBroadcaster::workerLoop, this );
+    LOG( INFO ) << "[Discovery] Service started.";
+    return true;
+}
+
+void DiscoveryBroadcaster::stop()
+{
+    if ( !m_isRunning )
+    {
+        return;
+    }
+    m_isRunning = false;
+
+    if ( m_workerThread.joinable() )
+    {
+        m_workerThread.join();
+    }
+
+    if ( m_socket != k_invalidSocket )
+    {
+        closeSocket( m_socket );
+        m_socket = k_invalidSocket;
+    }
+    LOG( INFO ) << "[Discovery] Service stopped.";
+}
+
+void DiscoveryBroadcaster::setTargetIP( const std::string& ip )
+{
+    if ( ip.empty() )
+    {
+        m_targets.setManual( TargetList::k_emptySlot );
+        LOG( INFO ) << "[Discovery] Unicast target cleared.";
+        return;
+    }
+
+    in_addr addr{};
+    if ( inet_pton( AF_INET, ip.c_str(), &addr ) != 1 )
+    {
+        LOG( WARNING ) << "[Discovery] Ignoring invalid unicast target '" << ip
+                       << "'.";
+        return;
+    }
+    m_targets.setManual( addr.s_addr );
+    LOG( INFO ) << "[Discovery] Unicast target set: " << ip;
+}
+
+void DiscoveryBroadcaster::setPeerConnected( const bool connected )
+{
+    m_peerConnected.store( connected, std::memory_order_release );
+}
+
+std::string DiscoveryBroadcaster::learnedPeer() const
+{
+    const auto address = m_lastReplyAddress.load( std::memory_order_acquire );
+    if ( address == TargetList::k_emptySlot )
+    {
+        return "";
+    }
+    return addressToString( address );
+}
+
+void DiscoveryBroadcaster::refreshInterfaces( const Clock::time_point now )
+{
+    m_broadcastAddresses = enumerateBroadcastAddresses();
+    if ( m_broadcastAddresses.empty() )
+    {
+        // Fall back to the limited broadcast so single homed hosts without
+        // usable interface information still work.
+        m_broadcastAddresses.push_back( htonl( INADDR_BROADCAST ) );
+    }
+    m_nextInterfaceRefresh = now + k_interfaceRefreshInterval;
+}
+
+void DiscoveryBroadcaster::sendDiscovery()
+{
+    DiscoveryPacket packet;
+    packet.magic = htonl( DISCOVERY_MAGIC );
+    packet.version = htons( DISCOVERY_VERSION );
+    packet.tcpPort = htons( static_cast<uint16_t>( m_tcpPort ) );
+    packet.checksum = htonl( calculateChecksum( packet ) );
+
+    auto sendTo = [this, &packet]( const uint32_t address )
+    {
+        const auto addr = makeAddress( address, m_udpPort );
+        sendto( m_socket,
+                reinterpret_cast<const char*>( &packet ),
+                sizeof( packet ),
+                0,
+                reinterpret_cast<const sockaddr*>( &addr ),
+                sizeof( addr ) );
+    };
+
+    // Once a peer has answered, directed unicast is enough; broadcasts are
+    // only kept while we don't know where the peer is.
+    std::array<uint32_t, TargetList::k_slotCount> targets{};
+    const auto targetCount = m_targets.snapshot( targets );
+    const auto haveLearnedPeer = m_lastReplyAddress.load(
+                                     std::memory_order_relaxed )
+                                 != TargetList::k_emptySlot;
+    if ( !haveLearnedPeer )
+    {
+        for ( const auto broadcast : m_broadcastAddresses )
+        {
+            sendTo( broadcast );
+        }
+    }
+    for ( std::size_t i = 0; i < targetCount; ++i )
+    {
+        sendTo( targets[i] );
+    }
+}
+
+void DiscoveryBroadcaster::receiveReplies( const Clock::duration maxWait )
+{
+    const auto wait = std::min(
+        std::chrono::duration_cast<std::chrono::microseconds>( maxWait ),
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            k_maxWaitSlice ) );
+
+    fd_set readSet;
+    FD_ZERO( &readSet );
+    FD_SET( m_socket, &readSet );
+    timeval timeout{};
+    timeout.tv_sec = static_cast<long>( wait.count() / 1000000 );
+    timeout.tv_usec = static_cast<long>( wait.count() % 1000000 );
+
+    const auto ready = select( static_cast<int>( m_socket + 1 ),
+                               &readSet,
+                               nullptr,
+                               nullptr,
+                               &timeout );
+    if ( ready <= 0 )
+    {
+        return;
+    }
+
+    DiscoveryPacket reply;
+    sockaddr_in from{};
+    SockLen fromLength = sizeof( from );
+    const auto received = recvfrom( m_socket,
+                                    reinterpret_cast<char*>( &reply ),
+                                    sizeof( reply ),
+                                    0,
+                                    reinterpret_cast<sockaddr*>( &from ),
+                                    &fromLength );
+    if ( received != static_cast<int>( sizeof( reply ) )
+         || !isValidDiscoveryReply( reply ) )
+    {
+        return;
+    }
+
+    const auto address = from.sin_addr.s_addr;
+    m_lastReplyAddress.store( address, std::memory_order_release );
+    if ( m_targets.learn( address ) )
+    {
+        LOG( INFO ) << "[Discovery] Peer answered from "
+                    << addressToString( address )
+                    << ", switching to unicast.";
+    }
+}
+
+void DiscoveryBroadcaster::workerLoop()
+{
+    refreshInterfaces( m_now() );
+
+    while ( m_isRunning )
+    {
+        const auto now = m_now();
+        const auto connected
+            = m_peerConnected.load( std::memory_order_acquire );
+        if ( !connected && m_schedule.peerConnected() )
+        {
+            // The peer may come back on a different address, so forget
+            // where it answered from and broadcast again until it answers.
+            m_lastReplyAddress.store( TargetList::k_emptySlot,
+                                      std::memory_order_release );
+            m_targets.clearLearned();
+        }
+        m_schedule.setPeerConnected( connected, now );
+
+        if ( now >= m_nextInterfaceRefresh )
+        {
+            refreshInterfaces( now );
+        }
+
+        if ( m_schedule.isDue( now ) )
+        {
+            sendDiscovery();
+            m_schedule.onSent( now );
+        }
+
+        const auto remaining = m_schedule.nextDeadline() - m_now();
+        receiveReplies( std::max( remaining, Clock::duration::zero() ) );
+    }
+}
+
+} // namespace discovery
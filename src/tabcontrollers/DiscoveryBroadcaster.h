@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace discovery
+{
+using Clock = std::chrono::steady_clock;
+
+// Source of "now" for the broadcaster. Tests inject a manual clock so the
+// backoff can be verified without sleeping.
+using TimeSource = std::function<Clock::time_point()>;
+
+#ifdef _WIN32
+using SocketHandle = std::uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+
+/*!
+Decides when the next discovery packet is due.
+
+While no peer is connected packets go out every base interval so a headset
+that was just switched on finds us quickly. Once a peer is connected the
+interval doubles after every send up to the maximum, since the broadcast is
+only needed to recover from a dropped connection.
+*/
+class BackoffSchedule
+{
+public:
+    BackoffSchedule( const Clock::duration baseInterval,
+                     const Clock::duration maxInterval ) noexcept;
+
+    void setPeerConnected( const bool connected,
+                           const Clock::time_point now ) noexcept;
+    [[nodiscard]] bool peerConnected() const noexcept;
+
+    [[nodiscard]] bool isDue( const Clock::time_point now ) const noexcept;
+    void onSent( const Clock::time_point now ) noexcept;
+
+    [[nodiscard]] Clock::time_point nextDeadline() const noexcept;
+    [[nodiscard]] Clock::duration currentInterval() const noexcept;
+
+private:
+    const Clock::duration m_baseInterval;
+    const Clock::duration m_maxInterval;
+    Clock::duration m_interval;
+    Clock::time_point m_nextDeadline{};
+    bool m_peerConnected = false;
+};
+
+/*!
+Fixed size set of unicast targets, stored as IPv4 addresses in network byte
+order. Slot 0 is the manually configured target, the remaining slots are
+learned from discovery replies. Reads and writes are plain atomic
+loads/stores so the send loop never takes a lock; learned slots are only
+written by the worker thread.
+*/
+class TargetList
+{
+public:
+    static constexpr std::size_t k_slotCount = 4;
+    static constexpr uint32_t k_emptySlot = 0;
+
+    TargetList() noexcept;
+
+    void setManual( const uint32_t address ) noexcept;
+    [[nodiscard]] uint32_t manual() const noexcept;
+
+    // Returns true if the address was not already known.
+    bool learn( const uint32_t address ) noexcept;
+    void clearLearned() noexcept;
+
+    [[nodiscard]] std::size_t
+        snapshot( std::array<uint32_t, k_slotCount>& out ) const noexcept;
+
+private:
+    std::array<std::atomic<uint32_t>, k_slotCount> m_slots;
+    std::size_t m_nextLearnedSlot = 1;
+};
+
+// Directed broadcast address of a subnet. All values in network byte order.
+[[nodiscard]] uint32_t directedBroadcast( const uint32_t address,
+                                          const uint32_t netmask ) noexcept;
+
+// Directed broadcast addresses of all up, non-loopback IPv4 interfaces.
+[[nodiscard]] std::vector<uint32_t> enumerateBroadcastAddresses();
+
+class DiscoveryBroadcaster
+{
+public:
+    // tcpPort: the TCP port the Quest side should connect to.
+    // udpPort: the UDP port the Quest side listens on for discovery packets.
+    DiscoveryBroadcaster( const int tcpPort,
+                          const int udpPort,
+                          TimeSource timeSource = &Clock::now );
+    ~DiscoveryBroadcaster();
+
+    bool start();
+    void stop();
+
+    // Sets the manual unicast target. An empty string clears it.
+    void setTargetIP( const std::string& ip );
+
+    // Called by the TCP side when a peer connects or disconnects so that
+    // discovery traffic can back off while it isn't needed.
+    void setPeerConnected( const bool connected );
+
+    [[nodiscard]] std::string learnedPeer() const;
+
+private:
+    void workerLoop();
+    void sendDiscovery();
+    void receiveReplies( const Clock::duration maxWait );
+    void refreshInterfaces( const Clock::time_point now );
+
+    const int m_tcpPort;
+    const int m_udpPort;
+    const TimeSource m_now;
+
+    std::atomic<bool> m_isRunning;
+    std::atomic<bool> m_peerConnected;
+    std::atomic<uint32_t> m_lastReplyAddress;
+    std::thread m_workerThread;
+    SocketHandle m_socket;
+
+    TargetList m_targets;
+    BackoffSchedule m_schedule;
+
+    std::vector<uint32_t> m_broadcastAddresses;
+    Clock::time_point m_nextInterfaceRefresh{};
+};
+
+} // namespace discovery
@@ -12,6 +12,8 @@
 const uint32_t DISCOVERY_MAGIC = 0x5F444953;
 const uint16_t DISCOVERY_VERSION = 1;
 const uint16_t DISCOVERY_PORT = 19191;
+// 应答魔数 "_ACK" (Android 端收到广播后回给 PC 的包, 结构同 DiscoveryPacket)
+const uint32_t DISCOVERY_REPLY_MAGIC = 0x5F41434B;
 // 强制 1 字节对齐，确保跨平台内存布局一致
 #pragma pack(push, 1)
 struct DiscoveryPacket {
@@ -35,4 +37,18 @@ inline uint32_t calculateChecksum(const DiscoveryPacket& pkg) {
         hash *= 16777619u; // FNV prime
     }
     return hash;
-}
\ No newline at end of file
+}
+
+// 校验收到的应答包 (字段均为网络字节序)
+inline bool isValidDiscoveryReply(const DiscoveryPacket& pkg) {
+    uint32_t magic = 0;
+    uint32_t checksum = 0;
+    // 逐字节还原, 避免依赖平台的 ntohl 头文件
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(&pkg.magic);
+    const uint8_t* c = reinterpret_cast<const uint8_t*>(&pkg.checksum);
+    for (int i = 0; i < 4; ++i) {
+        magic = (magic << 8) | m[i];
+        checksum = (checksum << 8) | c[i];
+    }
+    return magic == DISCOVERY_REPLY_MAGIC && checksum == calculateChecksum(pkg);
+}
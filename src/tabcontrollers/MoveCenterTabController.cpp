@@ -38,7 +38,7 @@ namespace advsettings
 {
 void MoveCenterTabController::initStage1()
 {
-    reloadOffsetProfiles();
+    // The profiles are loaded by OverlayController on a startup task.
     m_lastDragUpdateTimePoint = std::chrono::steady_clock::now();
     m_lastGravityUpdateTimePoint = std::chrono::steady_clock::now();
 }
@@ -51,12 +51,7 @@ void MoveCenterTabController::initStage2( OverlayController* var_parent )
 
 void MoveCenterTabController::reloadOffsetProfiles()
 {
-    settings::loadAllObjects( m_offsetProfiles );
-}
-
-void MoveCenterTabController::saveOffsetProfiles()
-{
-    settings::saveAllObjects( m_offsetProfiles );
+    m_offsetProfiles.reload();
 }
 
 Q_INVOKABLE unsigned MoveCenterTabController::getOffsetProfileCount()
@@ -73,33 +68,21 @@ Q_INVOKABLE QString
     }
     else
     {
-        return QString::fromStdString( m_offsetProfiles[index].profileName );
+        return QString::fromStdString( m_offsetProfiles.name( index ) );
     }
 }
 
 void MoveCenterTabController::addOffsetProfile( QString name )
 {
-    OffsetProfile* profile = nullptr;
-    for ( auto& p : m_offsetProfiles )
-    {
-        if ( p.profileName.compare( name.toStdString() ) == 0 )
-        {
-            profile = &p;
-            break;
-        }
-    }
-    if ( !profile )
-    {
-        auto i = m_offsetProfiles.size();
-        m_offsetProfiles.emplace_back();
-        profile = &m_offsetProfiles[i];
-    }
-    profile->profileName = name.toStdString();
-    profile->offsetX = m_offsetX;
-    profile->offsetY = m_offsetY;
-    profile->offsetZ = m_offsetZ;
-    profile->rotation = m_rotation;
-    saveOffsetProfiles();
+    const auto existing = m_offsetProfiles.find( name.toStdString() );
+    const auto index = existing ? *existing : m_offsetProfiles.append();
+    auto profile = *m_offsetProfiles.get( index );
+    profile.profileName = name.toStdString();
+    profile.offsetX = m_offsetX;
+    profile.offsetY = m_offsetY;
+    profile.offsetZ = m_offsetZ;
+    profile.rotation = m_rotation;
+    m_offsetProfiles.save( index, profile );
     emit offsetProfilesUpdated();
 }
 
@@ -107,16 +90,16 @@ void MoveCenterTabController::applyOffsetProfile( unsigned index )
 {
     if ( index < m_offsetProfiles.size() )
     {
-        auto& profile = m_offsetProfiles[index];
-        m_rotation = profile.rotation;
-        m_offsetX = profile.offsetX;
-        m_offsetY = profile.offsetY;
-        m_offsetZ = profile.offsetZ;
+        const auto profile = m_offsetProfiles.get( index );
+        m_rotation = profile->rotation;
+        m_offsetX = profile->offsetX;
+        m_offsetY = profile->offsetY;
+        m_offsetZ = profile->offsetZ;
         emit rotationChanged( m_rotation );
         emit offsetXChanged( m_offsetX );
         emit offsetYChanged( m_offsetY );
         emit offsetZChanged( m_offsetZ );
-        LOG( INFO ) << "Applying Offset Profile:" << profile.profileName
+        LOG( INFO ) << "Applying Offset Profile:" << profile->profileName
                     << " X:" << m_offsetX << " Y:" << m_offsetY
                     << " Z:" << m_offsetZ << " Rotation:"
                     << ( static_cast<float>( m_rotation ) / 100 );
@@ -148,9 +131,7 @@ void MoveCenterTabController::deleteOffsetProfile( unsigned index )
 {
     if ( index < m_offsetProfiles.size() )
     {
-        auto pos = m_offsetProfiles.begin() + index;
-        m_offsetProfiles.erase( pos );
-        saveOffsetProfiles();
+        m_offsetProfiles.erase( index );
         emit offsetProfilesUpdated();
     }
 }
@@ -1949,6 +1930,8 @@ void MoveCenterTabController::snapTurnLeft( bool snapTurnLeftJustPressed )
     }
 
     setRotation( newRotationAngleDeg );
+    parent->m_statisticsTabController.sessionRecorder().recordComfortEvent(
+        statistics::ComfortFeature::SnapTurn, -snapTurnAngle() );
 }
 
 void MoveCenterTabController::snapTurnRight( bool snapTurnRightJustPressed )
@@ -1970,6 +1953,8 @@ void MoveCenterTabController::snapTurnRight( bool snapTurnRightJustPressed )
     }
 
     setRotation( newRotationAngleDeg );
+    parent->m_statisticsTabController.sessionRecorder().recordComfortEvent(
+        statistics::ComfortFeature::SnapTurn, snapTurnAngle() );
 }
 
 void MoveCenterTabController::smoothTurnLeft( bool smoothTurnLeftActive )
@@ -8,6 +8,7 @@
 #include "../utils/Matrix.h"
 #include "../utils/FrameRateUtils.h"
 #include "../settings/settings_object.h"
+#include "../settings/profile_list.h"
 
 class QQuickWindow;
 // application namespace
@@ -228,7 +229,7 @@ class MoveCenterTabController : public QObject
     // void saveUncommittedChaperone();
     void outputLogHmdMatrix( vr::HmdMatrix34_t hmdMatrix );
 
-    std::vector<OffsetProfile> m_offsetProfiles;
+    settings::ProfileList<OffsetProfile> m_offsetProfiles;
 
 public:
     void initStage1();
@@ -276,7 +277,6 @@ class MoveCenterTabController : public QObject
     void updateChaperoneResetData(bool fromCalibration = true);
 
     void reloadOffsetProfiles();
-    void saveOffsetProfiles();
     Q_INVOKABLE unsigned getOffsetProfileCount();
     Q_INVOKABLE QString getOffsetProfileName( unsigned index );
 
@@ -0,0 +1,238 @@
+#include "PoseStream.h"
+#include "../quaternion/quaternion.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pose_stream
+{
+namespace
+{
+    template <typename Int> Int toFixed( const double value, const float scale )
+    {
+        const auto scaled = std::round( value * static_cast<double>( scale ) );
+        const auto clamped = std::clamp(
+            scaled,
+            static_cast<double>( std::numeric_limits<Int>::min() ),
+            static_cast<double>( std::numeric_limits<Int>::max() ) );
+        return static_cast<Int>( clamped );
+    }
+
+    // Writes big endian (network order) integers independent of the host.
+    class Writer
+    {
+    public:
+        explicit Writer( uint8_t* buffer ) noexcept : m_cursor( buffer ) {}
+
+        void u8( const uint8_t v ) noexcept
+        {
+            *m_cursor++ = v;
+        }
+        void u16( const uint16_t v ) noexcept
+        {
+            u8( static_cast<uint8_t>( v >> 8 ) );
+            u8( static_cast<uint8_t>( v ) );
+        }
+        void u32( const uint32_t v ) noexcept
+        {
+            u16( static_cast<uint16_t>( v >> 16 ) );
+            u16( static_cast<uint16_t>( v ) );
+        }
+        void u64( const uint64_t v ) noexcept
+        {
+            u32( static_cast<uint32_t>( v >> 32 ) );
+            u32( static_cast<uint32_t>( v ) );
+        }
+
+    private:
+        uint8_t* m_cursor;
+    };
+
+    constexpr bool isStreamedClass( const vr::ETrackedDeviceClass c ) noexcept
+    {
+        return c == vr::TrackedDeviceClass_HMD
+               || c == vr::TrackedDeviceClass_Controller
+               || c == vr::TrackedDeviceClass_GenericTracker;
+    }
+} // namespace
+
+std::size_t encodePoseSample( const PoseSample& sample,
+                              uint8_t* buffer,
+                              const std::size_t bufferSize ) noexcept
+{
+    const auto payloadSize = sample.deviceCount * sizeof( PoseStreamDevice );
+    const auto frameSize = sizeof( PoseStreamHeader ) + payloadSize;
+    if ( frameSize > bufferSize )
+    {
+        return 0;
+    }
+
+    Writer w( buffer );
+    w.u32( POSE_STREAM_MAGIC );
+    w.u16( POSE_STREAM_VERSION );
+    w.u16( static_cast<uint16_t>( payloadSize ) );
+    w.u32( sample.sequence );
+    w.u64( sample.timestampUs );
+    w.u8( sample.deviceCount );
+
+    for ( std::size_t i = 0; i < sample.deviceCount; ++i )
+    {
+        const auto& d = sample.devices[i];
+        w.u8( d.deviceIndex );
+        w.u8( d.deviceClass );
+        w.u8( d.flags );
+        for ( int axis = 0; axis < 3; ++axis )
+        {
+            w.u32( static_cast<uint32_t>( toFixed<int32_t>(
+                d.pose.m[axis][3], POSE_STREAM_POSITION_SCALE ) ) );
+        }
+        const auto q = quaternion::fromHmdMatrix34( d.pose );
+        for ( const auto component : { q.w, q.x, q.y, q.z } )
+        {
+            w.u16( static_cast<uint16_t>(
+                toFixed<int16_t>( component, POSE_STREAM_ROTATION_SCALE ) ) );
+        }
+        for ( int axis = 0; axis < 3; ++axis )
+        {
+            w.u16( static_cast<uint16_t>( toFixed<int16_t>(
+                d.velocity.v[axis], POSE_STREAM_VELOCITY_SCALE ) ) );
+        }
+    }
+
+    return frameSize;
+}
+
+void PoseStreamer::setRateHz( const int rateHz ) noexcept
+{
+    m_rateHz.store( std::max( rateHz, 0 ), std::memory_order_relaxed );
+}
+
+int PoseStreamer::rateHz() const noexcept
+{
+    return m_rateHz.load( std::memory_order_relaxed );
+}
+
+void PoseStreamer::setActive( const bool active ) noexcept
+{
+    if ( active && !m_active.load( std::memory_order_relaxed ) )
+    {
+        m_restart.store( true, std::memory_order_relaxed );
+    }
+    {
+        std::lock_guard<std::mutex> lock( m_wakeMutex );
+        m_active.store( active, std::memory_order_release );
+    }
+    m_wake.notify_all();
+}
+
+bool PoseStreamer::active() const noexcept
+{
+    return m_active.load( std::memory_order_acquire );
+}
+
+uint8_t PoseStreamer::deviceClass( const uint32_t index,
+                                   const bool connected ) noexcept
+{
+    if ( connected != m_deviceConnected[index] )
+    {
+        m_deviceConnected[index] = connected;
+        m_deviceClasses[index]
+            = connected ? static_cast<uint8_t>(
+                  vr::VRSystem()->GetTrackedDeviceClass( index ) )
+                        : static_cast<uint8_t>( vr::TrackedDeviceClass_Invalid );
+    }
+    return m_deviceClasses[index];
+}
+
+void PoseStreamer::sampleFrame(
+    const vr::TrackedDevicePose_t* devicePoses ) noexcept
+{
+    const auto rate = rateHz();
+    if ( rate <= 0 || !active() || devicePoses == nullptr )
+    {
+        return;
+    }
+
+    const auto now = Clock::now();
+    if ( m_restart.exchange( false, std::memory_order_relaxed ) )
+    {
+        m_streamStart = now;
+        m_nextSample = now;
+        m_sequence = 0;
+    }
+    if ( now < m_nextSample )
+    {
+        return;
+    }
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>( 1.0 / rate ) );
+    // Schedule from the previous deadline to keep the average rate exact,
+    // but don't try to catch up after a long stall.
+    m_nextSample = std::max( m_nextSample + period, now );
+
+    auto& sample = m_scratch;
+    sample.sequence = m_sequence++;
+    sample.timestampUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            now - m_streamStart )
+            .count() );
+    sample.deviceCount = 0;
+
+    for ( uint32_t i = 0; i < vr::k_unMaxTrackedDeviceCount
+                          && sample.deviceCount < k_maxStreamedDevices;
+          ++i )
+    {
+        const auto& pose = devicePoses[i];
+        const auto c = deviceClass( i, pose.bDeviceIsConnected );
+        if ( !isStreamedClass( static_cast<vr::ETrackedDeviceClass>( c ) ) )
+        {
+            continue;
+        }
+
+        auto& d = sample.devices[sample.deviceCount++];
+        d.deviceIndex = static_cast<uint8_t>( i );
+        d.deviceClass = c;
+        d.flags = PoseStreamFlag_Connected;
+        if ( pose.bPoseIsValid )
+        {
+            d.flags |= PoseStreamFlag_PoseValid;
+        }
+        if ( pose.eTrackingResult == vr::TrackingResult_Running_OK )
+        {
+            d.flags |= PoseStreamFlag_TrackingOk;
+        }
+        d.pose = pose.mDeviceToAbsoluteTracking;
+        d.velocity = pose.vVelocity;
+    }
+
+    if ( !m_queue.tryPush( sample ) )
+    {
+        m_droppedSamples.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock( m_wakeMutex );
+    }
+    m_wake.notify_one();
+}
+
+bool PoseStreamer::popSample( PoseSample& out ) noexcept
+{
+    return m_queue.tryPop( out );
+}
+
+bool PoseStreamer::waitForSample( PoseSample& out )
+{
+    std::unique_lock<std::mutex> lock( m_wakeMutex );
+    m_wake.wait( lock, [this, &out]() {
+        return !active() || m_queue.tryPop( out );
+    } );
+    return active();
+}
+
+uint32_t PoseStreamer::droppedSamples() const noexcept
+{
+    return m_droppedSamples.load( std::memory_order_relaxed );
+}
+
+} // namespace pose_stream
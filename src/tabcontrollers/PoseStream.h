@@ -0,0 +1,106 @@
+#pragma once
+
+#include <openvr.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "PoseStreamProtocol.h"
+#include "../utils/spsc_queue.h"
+
+namespace pose_stream
+{
+// HMD, two controllers and a full body tracker set fit comfortably.
+constexpr std::size_t k_maxStreamedDevices = 16;
+constexpr std::size_t k_queueCapacity = 8;
+
+struct DeviceSample
+{
+    uint8_t deviceIndex;
+    uint8_t deviceClass;
+    uint8_t flags;
+    vr::HmdMatrix34_t pose;
+    vr::HmdVector3_t velocity;
+};
+
+struct PoseSample
+{
+    uint32_t sequence = 0;
+    uint64_t timestampUs = 0;
+    uint8_t deviceCount = 0;
+    std::array<DeviceSample, k_maxStreamedDevices> devices{};
+};
+
+// Largest possible encoded frame.
+constexpr std::size_t k_maxFrameSize
+    = sizeof( PoseStreamHeader )
+      + k_maxStreamedDevices * sizeof( PoseStreamDevice );
+
+// Encodes a sample into the wire format described in PoseStreamProtocol.h.
+// Returns the number of bytes written, or 0 if the buffer is too small.
+std::size_t encodePoseSample( const PoseSample& sample,
+                              uint8_t* buffer,
+                              const std::size_t bufferSize ) noexcept;
+
+/*!
+Hands per-frame poses from the event loop to the BoundrySync network thread.
+
+sampleFrame() is called from mainEventLoop with the poses it already fetched.
+It only copies the streamed devices into the queue and returns; when the
+network thread falls behind samples are dropped (visible as sequence gaps)
+instead of blocking the frame.
+*/
+class PoseStreamer
+{
+public:
+    void setRateHz( const int rateHz ) noexcept;
+    [[nodiscard]] int rateHz() const noexcept;
+
+    // Samples are only produced while a consumer is attached. Activating
+    // restarts the sequence numbers and timestamps at zero.
+    void setActive( const bool active ) noexcept;
+    [[nodiscard]] bool active() const noexcept;
+
+    // Event loop side.
+    void sampleFrame( const vr::TrackedDevicePose_t* devicePoses ) noexcept;
+
+    // Network side.
+    bool popSample( PoseSample& out ) noexcept;
+    // Blocks until a sample arrives, false once the streamer is deactivated.
+    bool waitForSample( PoseSample& out );
+
+    [[nodiscard]] uint32_t droppedSamples() const noexcept;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint8_t deviceClass( const uint32_t index,
+                         const bool connected ) noexcept;
+
+    std::atomic<int> m_rateHz{ 0 };
+    std::atomic<bool> m_active{ false };
+    std::atomic<bool> m_restart{ false };
+    std::atomic<uint32_t> m_droppedSamples{ 0 };
+
+    // Only held to notify, so a wake up can't slip in between the consumer
+    // finding the queue empty and going to sleep.
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+
+    // Only touched by the event loop. The start of the current stream, set
+    // when the first sample after setActive( true ) is taken.
+    Clock::time_point m_streamStart{};
+    Clock::time_point m_nextSample{};
+    uint32_t m_sequence = 0;
+    PoseSample m_scratch{};
+    // GetTrackedDeviceClass is an IPC call, so classes are cached and only
+    // looked up again when a device (dis)connects.
+    std::array<uint8_t, vr::k_unMaxTrackedDeviceCount> m_deviceClasses{};
+    std::array<bool, vr::k_unMaxTrackedDeviceCount> m_deviceConnected{};
+
+    utils::SpscQueue<PoseSample, k_queueCapacity> m_queue;
+};
+
+} // namespace pose_stream
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+// Outbound pose stream sent from the PC to the Quest over the BoundrySync TCP
+// connection. Every frame is a PoseStreamHeader followed by deviceCount
+// PoseStreamDevice records. All multi-byte fields are in network byte order,
+// like the discovery packets.
+
+// "_POS"
+const uint32_t POSE_STREAM_MAGIC = 0x5F504F53;
+const uint16_t POSE_STREAM_VERSION = 1;
+
+// Fixed point scales.
+// Positions are in 1/10 mm, which covers +-214 km at int32.
+const float POSE_STREAM_POSITION_SCALE = 10000.0f;
+// Quaternion components are normalized to [-1, 1].
+const float POSE_STREAM_ROTATION_SCALE = 32767.0f;
+// Velocities are in mm/s, which covers +-32 m/s at int16.
+const float POSE_STREAM_VELOCITY_SCALE = 1000.0f;
+
+enum PoseStreamDeviceFlags : uint8_t
+{
+    PoseStreamFlag_PoseValid = 1 << 0,
+    PoseStreamFlag_TrackingOk = 1 << 1,
+    PoseStreamFlag_Connected = 1 << 2,
+};
+
+#pragma pack( push, 1 )
+struct PoseStreamHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    // Number of bytes following this header.
+    uint16_t payloadSize;
+    // Incremented for every sampled frame. Gaps mean frames were dropped
+    // because the network side could not keep up.
+    uint32_t sequence;
+    // Microseconds since the stream was started, steady clock.
+    uint64_t timestampUs;
+    uint8_t deviceCount;
+};
+
+struct PoseStreamDevice
+{
+    uint8_t deviceIndex;
+    // vr::ETrackedDeviceClass
+    uint8_t deviceClass;
+    // PoseStreamDeviceFlags
+    uint8_t flags;
+    int32_t position[3];
+    // w, x, y, z
+    int16_t rotation[4];
+    int16_t velocity[3];
+};
+#pragma pack( pop )
+
+static_assert( sizeof( PoseStreamHeader ) == 21,
+               "PoseStreamHeader layout is part of the wire format." );
+static_assert( sizeof( PoseStreamDevice ) == 29,
+               "PoseStreamDevice layout is part of the wire format." );
@@ -0,0 +1,129 @@
+#include "PushToTalkService.h"
+#include <algorithm>
+#include <easylogging++.h>
+
+namespace push_to_talk
+{
+namespace
+{
+    uint32_t toMicroseconds( const Clock::duration duration ) noexcept
+    {
+        const auto us
+            = std::chrono::duration_cast<std::chrono::microseconds>( duration )
+                  .count();
+        return static_cast<uint32_t>( std::clamp<int64_t>(
+            us, 0, LatencyHistogram::k_maxTrackableValue ) );
+    }
+} // namespace
+
+PushToTalkService::PushToTalkService( std::function<bool( bool )> setMuted )
+    : m_setMuted( std::move( setMuted ) ),
+      m_thread( &PushToTalkService::run, this )
+{
+}
+
+PushToTalkService::~PushToTalkService()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_wakeMutex );
+        m_running = false;
+        m_wake.notify_one();
+    }
+    m_thread.join();
+
+    const auto latencies = this->latencies();
+    if ( latencies.totalCount() > 0 )
+    {
+        LOG( INFO ) << "Push-to-talk latency over " << latencies.totalCount()
+                    << " changes: p50 " << latencies.percentile( 50.0 )
+                    << " us, p99 " << latencies.percentile( 99.0 )
+                    << " us, max " << latencies.maxValue() << " us, "
+                    << droppedChanges() << " dropped.";
+    }
+}
+
+bool PushToTalkService::post( const bool muted,
+                              const Clock::time_point sampled ) noexcept
+{
+    // Counted first so pending() can't miss a change the thread already
+    // took.
+    m_posted.fetch_add( 1, std::memory_order_acq_rel );
+    if ( !m_queue.tryPush( MuteCommand{ muted, sampled } ) )
+    {
+        m_posted.fetch_sub( 1, std::memory_order_acq_rel );
+        m_dropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+    // Notified under the mutex, so the thread can't check the queue, miss
+    // this change and then go to sleep.
+    std::lock_guard<std::mutex> lock( m_wakeMutex );
+    m_wake.notify_one();
+    return true;
+}
+
+bool PushToTalkService::pending() const noexcept
+{
+    return m_applied.load( std::memory_order_acquire )
+           != m_posted.load( std::memory_order_acquire );
+}
+
+LatencyHistogram PushToTalkService::latencies() const
+{
+    std::lock_guard<std::mutex> lock( m_latencyMutex );
+    return m_latencies;
+}
+
+uint64_t PushToTalkService::droppedChanges() const noexcept
+{
+    return m_dropped.load( std::memory_order_relaxed );
+}
+
+void PushToTalkService::run()
+{
+    while ( true )
+    {
+        // Read before draining, so everything posted before the destructor
+        // is still applied.
+        const auto running = m_running.load( std::memory_order_acquire );
+
+        MuteCommand command;
+        MuteCommand latest;
+        uint64_t taken = 0;
+        while ( m_queue.tryPop( command ) )
+        {
+            latest = command;
+            ++taken;
+        }
+
+        if ( taken > 0 )
+        {
+            if ( !m_setMuted( latest.muted ) )
+            {
+                LOG( WARNING ) << "Push-to-talk could not set the microphone "
+                               << ( latest.muted ? "muted" : "unmuted" )
+                               << ".";
+            }
+            const auto latency
+                = toMicroseconds( Clock::now() - latest.sampled );
+            {
+                std::lock_guard<std::mutex> lock( m_latencyMutex );
+                m_latencies.record( latency );
+            }
+            m_applied.fetch_add( taken, std::memory_order_release );
+            continue;
+        }
+
+        if ( !running )
+        {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock( m_wakeMutex );
+        m_wake.wait( lock, [this] {
+            return !m_running.load( std::memory_order_acquire )
+                   || !m_queue.empty();
+        } );
+    }
+}
+
+} // namespace push_to_talk
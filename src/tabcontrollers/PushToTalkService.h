@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "statistics/HdrHistogram.h"
+#include "../utils/spsc_queue.h"
+
+namespace push_to_talk
+{
+// Mute changes buffered between the input loop and the push-to-talk thread.
+constexpr std::size_t k_muteQueueCapacity = 64;
+
+using Clock = std::chrono::steady_clock;
+// Microseconds from the action change to the mute being handed to the audio
+// backend, exact up to 32 us and within 3% above.
+using LatencyHistogram = statistics::HdrHistogram<5, 20>;
+
+struct MuteCommand
+{
+    bool muted = false;
+    Clock::time_point sampled{};
+};
+
+/*!
+Applies push-to-talk mute changes on a dedicated thread.
+
+The input loop only posts the new mute state into a lock-free queue, so
+engaging or releasing push-to-talk never waits for the audio backend or the
+audio tab's locks. When several changes queued up while the backend was
+busy only the latest one is applied.
+
+setMuted is called on the service thread only, the audio backend behind it
+has to be safe to use from there.
+*/
+class PushToTalkService
+{
+public:
+    explicit PushToTalkService( std::function<bool( bool )> setMuted );
+    ~PushToTalkService();
+
+    PushToTalkService( const PushToTalkService& ) = delete;
+    PushToTalkService& operator=( const PushToTalkService& ) = delete;
+
+    // Never waits for the audio backend, the wake mutex it takes is only
+    // held by the service thread to check the queue. sampled is when the
+    // input loop saw the action change, it starts the measured latency.
+    // Returns false if the queue is full and the change was dropped.
+    bool post( const bool muted, const Clock::time_point sampled ) noexcept;
+
+    // True while posted changes haven't been applied yet. The backend's
+    // mute state is stale until then.
+    [[nodiscard]] bool pending() const noexcept;
+
+    [[nodiscard]] LatencyHistogram latencies() const;
+    [[nodiscard]] uint64_t droppedChanges() const noexcept;
+
+private:
+    void run();
+
+    std::function<bool( bool )> m_setMuted;
+    utils::SpscQueue<MuteCommand, k_muteQueueCapacity> m_queue;
+    std::atomic<uint64_t> m_posted{ 0 };
+    std::atomic<uint64_t> m_applied{ 0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+    std::atomic<bool> m_running{ true };
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+
+    mutable std::mutex m_latencyMutex;
+    LatencyHistogram m_latencies;
+
+    // Last, so everything above exists when the thread starts.
+    std::thread m_thread;
+};
+
+} // namespace push_to_talk
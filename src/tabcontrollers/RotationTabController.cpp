@@ -511,6 +511,10 @@ void RotationTabController::doAutoTurn(
                             += static_cast<int>( delta_degrees );
                         break;
                     }
+                    parent->m_statisticsTabController.sessionRecorder()
+                        .recordComfortEvent(
+                            statistics::ComfortFeature::AutoTurn,
+                            static_cast<int64_t>( delta_degrees ) );
                 } while ( false );
 
                 m_autoTurnWallActive[i] = true;
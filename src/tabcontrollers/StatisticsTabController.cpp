@@ -1,6 +1,13 @@
 #include "StatisticsTabController.h"
+#include <QDateTime>
+#include <QDir>
 #include <QQuickWindow>
+#include <QVariantMap>
+#include <algorithm>
+#include <easylogging++.h>
 #include "../overlaycontroller.h"
+#include "../settings/settings.h"
+#include "../utils/paths.h"
 
 // application namespace
 namespace advsettings
@@ -8,6 +15,11 @@ namespace advsettings
 void StatisticsTabController::initStage2( OverlayController* var_parent )
 {
     this->parent = var_parent;
+
+    if ( sessionRecordingEnabled() )
+    {
+        startSessionRecording();
+    }
 }
 
 void StatisticsTabController::eventLoopTick(
@@ -29,6 +41,52 @@ void StatisticsTabController::eventLoopTick(
     }
     m_cumStats = pStats;
 
+    // Time series //
+    {
+        const auto& hmd = devicePoses[0];
+        float hmdSpeed = 0.0f;
+        float hmdRotationRate = 0.0f;
+        if ( hmd.bPoseIsValid
+             && hmd.eTrackingResult == vr::TrackingResult_Running_OK )
+        {
+            const auto& v = hmd.vVelocity.v;
+            const auto& w = hmd.vAngularVelocity.v;
+            hmdSpeed = std::sqrt( v[0] * v[0] + v[1] * v[1] + v[2] * v[2] );
+            hmdRotationRate
+                = std::sqrt( w[0] * w[0] + w[1] * w[1] + w[2] * w[2] )
+                  * 180.0f / static_cast<float>( M_PI );
+        }
+        const statistics::FrameCounters counters{
+            pStats.m_nPid,
+            pStats.m_nNumFramePresents,
+            pStats.m_nNumDroppedFrames,
+            pStats.m_nNumReprojectedFrames,
+            pStats.m_nNumTimedOut,
+        };
+        if ( const auto sample = m_secondAggregator.tick(
+                 statistics::SecondAggregator::Clock::now(),
+                 counters,
+                 hmdSpeed,
+                 hmdRotationRate ) )
+        {
+            m_timeSeries.push( *sample );
+            m_sessionRecorder.recordSecond( *sample,
+                                            m_secondLeftControllerPeak,
+                                            m_secondRightControllerPeak );
+            m_secondLeftControllerPeak = 0.0f;
+            m_secondRightControllerPeak = 0.0f;
+        }
+        m_secondLeftControllerPeak
+            = std::max( m_secondLeftControllerPeak, leftSpeed );
+        m_secondRightControllerPeak
+            = std::max( m_secondRightControllerPeak, rightSpeed );
+    }
+
+    // Frame timings //
+    m_frameTimings.eventLoopTick(
+        vr::VRCompositor(), statistics::FrameTimingCollector::Clock::now() );
+    recordNewFrames();
+
     auto& m = devicePoses->mDeviceToAbsoluteTracking.m;
 
     // Hmd Distance //
@@ -144,6 +202,79 @@ float StatisticsTabController::totalReprojectedRatio() const
     }
 }
 
+const statistics::TimeSeriesStore& StatisticsTabController::timeSeries() const
+{
+    return m_timeSeries;
+}
+
+QVariantList StatisticsTabController::timeSeriesPercentiles( int metric,
+                                                             int window ) const
+{
+    if ( metric < 0
+         || metric >= static_cast<int>( statistics::k_metricCount )
+         || window < 0
+         || window >= static_cast<int>( statistics::k_windowCount ) )
+    {
+        return {};
+    }
+    const auto p
+        = m_timeSeries.percentiles( static_cast<statistics::Metric>( metric ),
+                                    static_cast<statistics::Window>( window ) );
+    return { p.p50,
+             p.p95,
+             p.p99,
+             p.max,
+             static_cast<unsigned long long>( p.samples ) };
+}
+
+void StatisticsTabController::noteOverlayTick(
+    statistics::FrameTimingCollector::Clock::time_point start,
+    statistics::FrameTimingCollector::Clock::duration duration )
+{
+    m_frameTimings.noteOverlayTick( start, duration );
+    m_sessionRecorder.recordOverlayTick( duration );
+}
+
+int StatisticsTabController::frameTimingSpikes() const
+{
+    return static_cast<int>( m_frameTimings.spikeCount() );
+}
+
+int StatisticsTabController::reprojectionStreaks() const
+{
+    return static_cast<int>( m_frameTimings.reprojectionStreaks() );
+}
+
+int StatisticsTabController::longestReprojectionStreak() const
+{
+    return static_cast<int>( m_frameTimings.longestReprojectionStreak() );
+}
+
+float StatisticsTabController::averageFrameGpuMs() const
+{
+    return m_frameTimings.averageGpuMs();
+}
+
+QVariantList StatisticsTabController::recentFrameTimingSpikes( int max ) const
+{
+    QVariantList spikes;
+    const auto count = std::min( static_cast<std::size_t>( std::max( max, 0 ) ),
+                                 m_frameTimings.storedSpikes() );
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+        const auto& spike = m_frameTimings.spikesAgo( i );
+        QVariantMap entry;
+        entry["frameIndex"] = spike.frameIndex;
+        entry["gpuMs"] = spike.totalGpuMs;
+        entry["baselineMs"] = spike.baselineMs;
+        entry["compositorCpuMs"] = spike.compositorCpuMs;
+        entry["overlayTickMs"] = spike.overlayTickMs;
+        entry["reprojected"] = spike.reprojected;
+        spikes.push_back( entry );
+    }
+    return spikes;
+}
+
 void StatisticsTabController::statsDistanceResetClicked()
 {
     lastHmdPosValid = false;
@@ -201,4 +332,100 @@ void StatisticsTabController::totalRatioResetClicked()
     m_totalRatioReprojectedOffset = m_cumStats.m_nNumReprojectedFrames;
 }
 
+void StatisticsTabController::timeSeriesResetClicked()
+{
+    m_timeSeries.clear();
+    m_secondAggregator.reset();
+}
+
+void StatisticsTabController::frameTimingResetClicked()
+{
+    m_frameTimings.reset();
+    m_recordedFrames = 0;
+}
+
+void StatisticsTabController::recordNewFrames()
+{
+    const auto total = m_frameTimings.totalFrames();
+    if ( m_sessionRecorder.recording() )
+    {
+        // Frames that already left the ring buffer can't be recorded.
+        const auto newFrames = std::min(
+            static_cast<std::size_t>( total - m_recordedFrames ),
+            m_frameTimings.size() );
+        for ( auto age = newFrames; age > 0; --age )
+        {
+            m_sessionRecorder.recordFrame(
+                m_frameTimings.framesAgo( age - 1 ) );
+        }
+    }
+    m_recordedFrames = total;
+}
+
+statistics::SessionRecorder& StatisticsTabController::sessionRecorder()
+{
+    return m_sessionRecorder;
+}
+
+bool StatisticsTabController::sessionRecordingEnabled() const
+{
+    return settings::getSetting(
+        settings::BoolSetting::APPLICATION_sessionRecordingEnabled );
+}
+
+QString StatisticsTabController::sessionRecordingPath() const
+{
+    return m_sessionRecorder.recording()
+               ? QString::fromStdString( m_sessionRecorder.path() )
+               : QString();
+}
+
+void StatisticsTabController::startSessionRecording()
+{
+    const auto settingsDir = paths::settingsDirectory();
+    if ( !settingsDir.has_value() )
+    {
+        LOG( ERROR ) << "No settings directory, session recording disabled.";
+        return;
+    }
+
+    const QDir sessionDir(
+        QString::fromStdString( *settingsDir ) + QStringLiteral( "/sessions" ) );
+    if ( !QDir().mkpath( sessionDir.absolutePath() ) )
+    {
+        LOG( ERROR ) << "Could not create session directory '"
+                     << sessionDir.absolutePath().toStdString() << "'.";
+        return;
+    }
+
+    const auto fileName
+        = QStringLiteral( "session-" )
+          + QDateTime::currentDateTime().toString( "yyyyMMdd-HHmmss" )
+          + QStringLiteral( ".ovrs" );
+    m_sessionRecorder.start(
+        sessionDir.absoluteFilePath( fileName ).toStdString() );
+    m_recordedFrames = m_frameTimings.totalFrames();
+}
+
+void StatisticsTabController::setSessionRecordingEnabled( bool value,
+                                                          bool notify )
+{
+    settings::setSetting(
+        settings::BoolSetting::APPLICATION_sessionRecordingEnabled, value );
+
+    if ( value && !m_sessionRecorder.recording() )
+    {
+        startSessionRecording();
+    }
+    else if ( !value )
+    {
+        m_sessionRecorder.stop();
+    }
+
+    if ( notify )
+    {
+        emit sessionRecordingEnabledChanged( value );
+    }
+}
+
 } // namespace advsettings
@@ -2,7 +2,11 @@
 #pragma once
 
 #include <QObject>
+#include <QVariantList>
 #include <openvr.h>
+#include "statistics/FrameTimings.h"
+#include "statistics/SessionRecorder.h"
+#include "statistics/TimeSeries.h"
 
 class QQuickWindow;
 // application namespace
@@ -23,6 +27,15 @@ class StatisticsTabController : public QObject
     Q_PROPERTY( int reprojectedFrames READ reprojectedFrames )
     Q_PROPERTY( int timedOut READ timedOut )
     Q_PROPERTY( float totalReprojectedRatio READ totalReprojectedRatio )
+    Q_PROPERTY( int frameTimingSpikes READ frameTimingSpikes )
+    Q_PROPERTY( int reprojectionStreaks READ reprojectionStreaks )
+    Q_PROPERTY( int longestReprojectionStreak READ longestReprojectionStreak )
+    Q_PROPERTY( float averageFrameGpuMs READ averageFrameGpuMs )
+    Q_PROPERTY( bool sessionRecordingEnabled READ sessionRecordingEnabled WRITE
+                    setSessionRecordingEnabled NOTIFY
+                        sessionRecordingEnabledChanged )
+    Q_PROPERTY( QString sessionRecordingPath READ sessionRecordingPath NOTIFY
+                    sessionRecordingEnabledChanged )
 
 private:
     OverlayController* parent;
@@ -50,6 +63,18 @@ class StatisticsTabController : public QObject
     unsigned m_totalRatioPresentedOffset = 0;
     unsigned m_totalRatioReprojectedOffset = 0;
 
+    statistics::SecondAggregator m_secondAggregator;
+    statistics::TimeSeriesStore m_timeSeries;
+    statistics::FrameTimingCollector m_frameTimings;
+
+    statistics::SessionRecorder m_sessionRecorder;
+    uint64_t m_recordedFrames = 0;
+    float m_secondLeftControllerPeak = 0.0f;
+    float m_secondRightControllerPeak = 0.0f;
+
+    void startSessionRecording();
+    void recordNewFrames();
+
 public:
     void initStage2( OverlayController* parent );
 
@@ -68,6 +93,34 @@ class StatisticsTabController : public QObject
     unsigned timedOut() const;
     float totalReprojectedRatio() const;
 
+    const statistics::TimeSeriesStore& timeSeries() const;
+
+    // Duration of one OverlayController::mainEventLoop run, used to tell
+    // whether a frame timing spike coincided with our own work.
+    void noteOverlayTick(
+        statistics::FrameTimingCollector::Clock::time_point start,
+        statistics::FrameTimingCollector::Clock::duration duration );
+
+    int frameTimingSpikes() const;
+    int reprojectionStreaks() const;
+    int longestReprojectionStreak() const;
+    float averageFrameGpuMs() const;
+
+    // Most recent spikes first, each a map with frameIndex, gpuMs,
+    // baselineMs, compositorCpuMs, overlayTickMs and reprojected.
+    Q_INVOKABLE QVariantList recentFrameTimingSpikes( int max ) const;
+
+    // Comfort features report to the recorder when they act.
+    statistics::SessionRecorder& sessionRecorder();
+
+    bool sessionRecordingEnabled() const;
+    QString sessionRecordingPath() const;
+
+    // Returns [p50, p95, p99, max, samples] of a statistics::Metric over a
+    // statistics::Window, in display units.
+    Q_INVOKABLE QVariantList timeSeriesPercentiles( int metric,
+                                                    int window ) const;
+
 public slots:
     void statsDistanceResetClicked();
     void statsRotationResetClicked();
@@ -78,6 +131,13 @@ public slots:
     void reprojectedFramesResetClicked();
     void timedOutResetClicked();
     void totalRatioResetClicked();
+    void timeSeriesResetClicked();
+    void frameTimingResetClicked();
+
+    void setSessionRecordingEnabled( bool value, bool notify = true );
+
+signals:
+    void sessionRecordingEnabledChanged( bool value );
 };
 
 } // namespace advsettings
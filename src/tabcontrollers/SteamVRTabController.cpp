@@ -11,6 +11,10 @@ namespace advsettings
 {
 void SteamVRTabController::initStage1()
 {
+    m_bindingIndex.watch(
+        QFileInfo(
+            QString::fromStdString( settings::initializeAndGetSettingsPath() ) )
+            .absolutePath() );
     dashboardLoopTick();
 }
 
@@ -773,17 +777,8 @@ bool SteamVRTabController::saveBind( std::string appID,
     QFileInfo fi(
         QString::fromStdString( settings::initializeAndGetSettingsPath() ) );
     QDir directory = fi.absolutePath();
-    QString Fn;
-    if ( def )
-    {
-        Fn = QString::fromStdString( "defovl" + appID + "ctrl" + ctrlType
-                                     + ".json" );
-    }
-    else
-    {
-        Fn = QString::fromStdString( "ovl" + appID + "scene" + sceneAppID
-                                     + "ctrl" + ctrlType + ".json" );
-    }
+    const QString Fn = QString::fromStdString( bindings::bindingFileName(
+        { appID, def ? "" : sceneAppID, ctrlType } ) );
     QString absPath = directory.absolutePath() + "/" + Fn;
 
     QFile bindFile( absPath );
@@ -795,6 +790,7 @@ bool SteamVRTabController::saveBind( std::string appID,
     bindFile.close();
     if ( bindFile.exists() )
     {
+        m_bindingIndex.insert( Fn.toStdString() );
         LOG( INFO ) << ( def ? "Default " : ( sceneAppID + " " ) )
                            + "Binding File saved at:"
                     << absPath.toStdString();
@@ -821,14 +817,7 @@ bool SteamVRTabController::customBindExists( std::string appID,
     {
         ctrl = ovr_system_wrapper::getControllerName();
     }
-    QFileInfo fi( QString::fromStdString(
-        settings::initializeAndGetSettingsPath() + "ovl" + appID + "scene"
-        + sceneAppID + "ctrl" + ctrl + ".json" ) );
-    if ( fi.exists() )
-    {
-        return true;
-    }
-    return false;
+    return m_bindingIndex.contains( { appID, sceneAppID, ctrl } );
 }
 
 bool SteamVRTabController::defBindExists( std::string appID, std::string ctrl )
@@ -841,107 +830,23 @@ bool SteamVRTabController::defBindExists( std::string appID, std::string ctrl )
     {
         ctrl = ovr_system_wrapper::getControllerName();
     }
-    QFileInfo fi( QString::fromStdString(
-        settings::initializeAndGetSettingsPath() + "defovl" + appID + "ctrl"
-        + ctrl + ".json" ) );
-    if ( fi.exists() )
-    {
-        return true;
-    }
-    return false;
+    return m_bindingIndex.contains( { appID, "", ctrl } );
 }
 
-void SteamVRTabController::applyBindingReq( std::string appID )
+void SteamVRTabController::applyBindingReq( const std::string& appID,
+                                            const std::string& sceneAppID,
+                                            const std::string& ctrlType )
 {
-    std::string ctrlType = ovr_system_wrapper::getControllerName();
-    QFileInfo fi(
-        QString::fromStdString( settings::initializeAndGetSettingsPath() ) );
-    QDir directory = fi.absolutePath();
-    QString Fn;
-    std::string sceneAppID = ovr_application_wrapper::getSceneAppID();
-    if ( sceneAppID == "" )
+    const auto fileName = m_bindingIndex.find( appID, sceneAppID, ctrlType );
+    if ( !fileName.has_value() )
     {
-        LOG( ERROR ) << "NO Scene App Detected unable to apply bindings";
+        LOG( INFO ) << "No Binding Detected for: " + appID
+                           + " for Scene: " + sceneAppID
+                           + " Not Adjusting Bindings";
         return;
     }
-
-    // TODO check forward slash compatibility with linux
-    Fn = QString::fromStdString( "ovl" + appID + "scene" + sceneAppID + "ctrl"
-                                 + ctrlType + ".json" );
-    if ( !QFileInfo::exists( fi.absolutePath() + QString( "/" ) + Fn ) )
-    {
-        LOG( INFO ) << "No Specific Binding Detected for: " + appID
-                           + "for Scene: " + sceneAppID + " Checking Default";
-        Fn = QString::fromStdString( "defovl" + appID + "ctrl" + ctrlType
-                                     + ".json" );
-        if ( !QFileInfo::exists( fi.absolutePath() + QString( "/" ) + Fn ) )
-        {
-            LOG( INFO ) << "No Def Binding Detected for: " + appID
-                               + " Not Adjusting Bindings";
-            return;
-        }
-    }
-    // TODO possible linux compatibility issue
-    QString absPath = directory.absolutePath() + "/" + Fn;
-    QUrl urlized = QUrl::fromLocalFile( absPath );
-    // std::string filePath = "file:///" + absPath.toStdString();
-    std::string url = "http://localhost:27062/input/selectconfig.action";
-    // LOG( INFO ) << urlized.toEncoded().toStdString();
-    QUrl urls = QUrl( url.c_str() );
-    QNetworkRequest request;
-    request.setUrl( urls );
-    LOG( INFO ) << "Attempting to Apply Binding at: "
-                << urlized
-                       .toEncoded( QUrl::EncodeSpaces | QUrl::EncodeReserved )
-                       .toStdString();
-    // This is Important as otherwise Valve's VRWebServerWillIgnore the Request
-    // If referrer is wrong
-    request.setHeader( QNetworkRequest::ContentTypeHeader,
-                       "application/x-www-form-urlencoded" );
-    request.setRawHeader(
-        QByteArray( "Referer" ),
-        QByteArray(
-            "http://localhost:27062/dashboard/controllerbinding.html" ) );
-    QByteArray data
-        = ( "{\"app_key\":\"" + appID + "\",\"controller_type\":\"" + ctrlType
-            + "\",\"url\":\""
-            + urlized.toEncoded( QUrl::EncodeSpaces | QUrl::EncodeReserved )
-                  .toStdString()
-            + "\"}" )
-              .c_str();
-    //    LOG( INFO ) << "Sending Binding Set Request";
-    //    LOG( INFO ) << data.toStdString();
-    connect( &m_networkManagerApply,
-             SIGNAL( finished( QNetworkReply* ) ),
-             this,
-             SLOT( onApplyBindingResponse( QNetworkReply* ) ) );
-    m_networkManagerApply.post( request, data );
-}
-
-void SteamVRTabController::onApplyBindingResponse( QNetworkReply* reply )
-{
-    json output = "";
-    QString data = QString::fromUtf8( reply->readAll() );
-    if ( data.size() < 2 )
-    {
-        return;
-    }
-    //    LOG( INFO ) << "APPLY RESPONSE";
-    //    LOG( INFO ) << data.toStdString();
-    reply->close();
-    json jsonfull = json::parse( data.toStdString() );
-    if ( !jsonfull.contains( "success" ) )
-    {
-        LOG( ERROR ) << "Apply Binding Packet Mal-Formed?";
-        return;
-    }
-    if ( !jsonfull["success"].get<bool>() )
-    {
-        // TODO better error handling?
-        LOG( ERROR ) << "Binding Failed To Apply";
-    }
-    LOG( INFO ) << "New Binding Applied";
-    return;
+    m_bindingApplyQueue.apply(
+        appID, ctrlType, m_bindingIndex.filePath( *fileName ) );
 }
 
 void SteamVRTabController::setBindingQMLWrapper( QString appID, bool def )
@@ -969,40 +874,21 @@ void SteamVRTabController::setPerAppBindEnabled( bool value, bool notify )
 
 void SteamVRTabController::applyAllCustomBindings()
 {
-    QFileInfo fi(
-        QString::fromStdString( settings::initializeAndGetSettingsPath() ) );
-    QDir directory = fi.absolutePath();
-    QStringList bindings = directory.entryList( QStringList() << "*.json"
-                                                              << "*.JSON",
-                                                QDir::Files );
-    std::set<std::string> appIDs;
-    std::regex r1( "ovl(.*)scene" );
-    std::regex r2( "defovl(.*)ctrl" );
-    foreach ( QString filename, bindings )
-    {
-        std::smatch m;
-        std::string s = filename.toStdString();
-
-        if ( regex_search( s, m, r1 ) )
-        {
-            if ( m.size() == 2 )
-            {
-                appIDs.insert( m[1].str() );
-                continue;
-            }
-        }
-        if ( regex_search( s, m, r2 ) )
-        {
-            if ( m.size() == 2 )
-            {
-                appIDs.insert( m[1].str() );
-                continue;
-            }
-        }
+    const auto appIDs = m_bindingIndex.appIDs();
+    if ( appIDs.empty() )
+    {
+        return;
+    }
+    const auto sceneAppID = ovr_application_wrapper::getSceneAppID();
+    if ( sceneAppID == "" )
+    {
+        LOG( ERROR ) << "NO Scene App Detected unable to apply bindings";
+        return;
     }
-    foreach ( std::string appID, appIDs )
+    const auto ctrlType = ovr_system_wrapper::getControllerName();
+    for ( const auto& appID : appIDs )
     {
-        applyBindingReq( appID );
+        applyBindingReq( appID, sceneAppID, ctrlType );
     }
 }
 
@@ -20,6 +20,8 @@
 #include <QNetworkReply>
 #include <set>
 #include <regex>
+#include "bindings/BindingIndex.h"
+#include "bindings/BindingApplyQueue.h"
 
 using namespace nlohmann;
 class QQuickWindow;
@@ -79,7 +81,8 @@ class SteamVRTabController : public QObject
     bool m_dnd = false;
     bool m_controllerPower = false;
     bool m_noHMD = false;
-    QNetworkAccessManager m_networkManagerApply;
+    bindings::BindingIndex m_bindingIndex;
+    bindings::BindingApplyQueue m_bindingApplyQueue;
     QNetworkAccessManager m_networkManagerUrl;
     QNetworkAccessManager m_networkManagerBind;
     QNetworkRequest m_networkRequest;
@@ -103,7 +106,9 @@ class SteamVRTabController : public QObject
     void synchSteamVR();
     std::vector<QString> getDongleSerialList( std::string deviceString );
     bool isSteamVRTracked( QString sn );
-    void applyBindingReq( std::string appID );
+    void applyBindingReq( const std::string& appID,
+                          const std::string& sceneAppID,
+                          const std::string& ctrlType );
 
 public:
     void initStage1();
@@ -181,7 +186,6 @@ public slots:
 
     void restartSteamVR();
     void onGetBindingUrlResponse( QNetworkReply* reply );
-    void onApplyBindingResponse( QNetworkReply* reply );
     void onGetBindingDataResponse( QNetworkReply* reply );
 
 signals:
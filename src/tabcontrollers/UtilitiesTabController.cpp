@@ -14,6 +14,7 @@ namespace advsettings
 void UtilitiesTabController::initStage2( OverlayController* var_parent )
 {
     this->m_parent = var_parent;
+    m_nowPlayingOverlay.setEnabled( nowPlayingOvlEnabled() );
 }
 
 void UtilitiesTabController::sendKeyboardInput( QString input )
@@ -190,6 +191,36 @@ void UtilitiesTabController::sendKeyboardThree()
     sendStringAsInput( commands );
 }
 
+namespace
+{
+    std::optional<keyboard_macro::MacroError>
+        checkKeyboardShortcut( const QString& shortcut )
+    {
+        // Only the errors are needed, not the platform key codes.
+        const auto anyKeyCode = []( const Token ) -> uint32_t { return 1; };
+        return keyboard_macro::compileMacro( shortcut.toStdString(),
+                                             anyKeyCode )
+            .error;
+    }
+} // namespace
+
+QString UtilitiesTabController::keyboardShortcutError( QString shortcut )
+{
+    const auto error = checkKeyboardShortcut( shortcut );
+    if ( !error.has_value() )
+    {
+        return "";
+    }
+    return QString::fromStdString( error->message ) + " at position "
+           + QString::number( error->position );
+}
+
+int UtilitiesTabController::keyboardShortcutErrorPosition( QString shortcut )
+{
+    const auto error = checkKeyboardShortcut( shortcut );
+    return error.has_value() ? static_cast<int>( error->position ) : -1;
+}
+
 bool UtilitiesTabController::vrcDebug() const
 {
     return settings::getSetting( settings::BoolSetting::UTILITY_vrcDebug );
@@ -224,6 +255,23 @@ void UtilitiesTabController::setTrackerOvlEnabled( bool value, bool notify )
     }
 }
 
+bool UtilitiesTabController::nowPlayingOvlEnabled() const
+{
+    return settings::getSetting(
+        settings::BoolSetting::UTILITY_nowPlayingOverlayEnabled );
+}
+
+void UtilitiesTabController::setNowPlayingOvlEnabled( bool value, bool notify )
+{
+    settings::setSetting(
+        settings::BoolSetting::UTILITY_nowPlayingOverlayEnabled, value );
+    m_nowPlayingOverlay.setEnabled( value );
+    if ( notify )
+    {
+        emit nowPlayingOvlEnabledChanged( value );
+    }
+}
+
 QString getBatteryIconPath( int batteryState )
 {
     constexpr auto batteryPrefix = "/res/img/battery/battery_";
@@ -8,6 +8,7 @@
 #include "src/keyboard_input/keyboard_input.h"
 #include "src/media_keys/media_keys.h"
 #include "../utils/FrameRateUtils.h"
+#include "nowplaying/NowPlayingOverlay.h"
 
 class QQuickWindow;
 // application namespace
@@ -23,6 +24,8 @@ class UtilitiesTabController : public QObject
         bool vrcDebug READ vrcDebug WRITE setVrcDebug NOTIFY vrcDebugChanged )
     Q_PROPERTY( bool trackerOvlEnabled READ trackerOvlEnabled WRITE
                     setTrackerOvlEnabled NOTIFY trackerOvlEnabledChanged )
+    Q_PROPERTY( bool nowPlayingOvlEnabled READ nowPlayingOvlEnabled WRITE
+                    setNowPlayingOvlEnabled NOTIFY nowPlayingOvlEnabledChanged )
 
 private:
     OverlayController* m_parent;
@@ -38,6 +41,8 @@ class UtilitiesTabController : public QObject
                                                 unsigned style = 0 );
     void destroyBatteryOverlays();
 
+    NowPlayingOverlay m_nowPlayingOverlay;
+
 public:
     void initStage2( OverlayController* var_parent );
 
@@ -45,6 +50,7 @@ class UtilitiesTabController : public QObject
 
     bool vrcDebug() const;
     bool trackerOvlEnabled() const;
+    bool nowPlayingOvlEnabled() const;
 
 public slots:
     void sendKeyboardInput( QString input );
@@ -81,13 +87,18 @@ public slots:
     Q_INVOKABLE void sendKeyboardOne();
     Q_INVOKABLE void sendKeyboardTwo();
     Q_INVOKABLE void sendKeyboardThree();
+    // Empty and -1 if the shortcut has no errors.
+    Q_INVOKABLE QString keyboardShortcutError( QString shortcut );
+    Q_INVOKABLE int keyboardShortcutErrorPosition( QString shortcut );
 
     void setVrcDebug( bool value, bool notify = true );
     void setTrackerOvlEnabled( bool value, bool notify = true );
+    void setNowPlayingOvlEnabled( bool value, bool notify = true );
 
 signals:
     void vrcDebugChanged( bool value );
     void trackerOvlEnabledChanged( bool value );
+    void nowPlayingOvlEnabledChanged( bool value );
 };
 
 } // namespace advsettings
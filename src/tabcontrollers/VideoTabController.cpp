@@ -4,6 +4,7 @@
 #include "../settings/settings.h"
 #include "../overlaycontroller.h"
 #include "../utils/update_rate.h"
+#include <algorithm>
 #include <cmath>
 
 namespace advsettings
@@ -20,7 +21,7 @@ void VideoTabController::initStage1()
     initColorOverlay();
     m_overlayInit = true;
     reloadVideoConfig();
-    reloadVideoProfiles();
+    // The profiles are loaded by OverlayController on a startup task.
 
     if ( brightnessEnabled() )
     {
@@ -391,7 +392,7 @@ void VideoTabController::synchGain( bool setValue )
 {
     vr::EVRSettingsError vrSettingsError;
 
-    auto red = vr::VRSettings()->GetFloat(
+    auto red = ovr_settings_wrapper::settingsCache().getFloat(
         vr::k_pch_SteamVR_Section,
         vr::k_pch_SteamVR_HmdDisplayColorGainR_Float,
         &vrSettingsError );
@@ -412,7 +413,7 @@ void VideoTabController::synchGain( bool setValue )
                                   static_cast<double>( red ) );
         }
     }
-    auto blue = vr::VRSettings()->GetFloat(
+    auto blue = ovr_settings_wrapper::settingsCache().getFloat(
         vr::k_pch_SteamVR_Section,
         vr::k_pch_SteamVR_HmdDisplayColorGainB_Float,
         &vrSettingsError );
@@ -433,7 +434,7 @@ void VideoTabController::synchGain( bool setValue )
                                   static_cast<double>( blue ) );
         }
     }
-    auto green = vr::VRSettings()->GetFloat(
+    auto green = ovr_settings_wrapper::settingsCache().getFloat(
         vr::k_pch_SteamVR_Section,
         vr::k_pch_SteamVR_HmdDisplayColorGainG_Float,
         &vrSettingsError );
@@ -481,7 +482,7 @@ void VideoTabController::setColorRed( float value, bool notify, bool keepValue )
         else
         {
             vr::EVRSettingsError vrSettingsError;
-            vr::VRSettings()->SetFloat(
+            ovr_settings_wrapper::settingsCache().setFloat(
                 vr::k_pch_SteamVR_Section,
                 vr::k_pch_SteamVR_HmdDisplayColorGainR_Float,
                 colorRed(),
@@ -531,7 +532,7 @@ void VideoTabController::setColorGreen( float value,
         else
         {
             vr::EVRSettingsError vrSettingsError;
-            vr::VRSettings()->SetFloat(
+            ovr_settings_wrapper::settingsCache().setFloat(
                 vr::k_pch_SteamVR_Section,
                 vr::k_pch_SteamVR_HmdDisplayColorGainG_Float,
                 colorGreen(),
@@ -580,7 +581,7 @@ void VideoTabController::setColorBlue( float value,
         else
         {
             vr::EVRSettingsError vrSettingsError;
-            vr::VRSettings()->SetFloat(
+            ovr_settings_wrapper::settingsCache().setFloat(
                 vr::k_pch_SteamVR_Section,
                 vr::k_pch_SteamVR_HmdDisplayColorGainB_Float,
                 colorBlue(),
@@ -606,10 +607,11 @@ void VideoTabController::setColorBlue( float value,
 void VideoTabController::resetGain()
 {
     vr::EVRSettingsError vrSettingsError;
-    vr::VRSettings()->SetFloat( vr::k_pch_SteamVR_Section,
-                                vr::k_pch_SteamVR_HmdDisplayColorGainR_Float,
-                                1.0f,
-                                &vrSettingsError );
+    ovr_settings_wrapper::settingsCache().setFloat(
+        vr::k_pch_SteamVR_Section,
+        vr::k_pch_SteamVR_HmdDisplayColorGainR_Float,
+        1.0f,
+        &vrSettingsError );
 
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
@@ -617,10 +619,11 @@ void VideoTabController::resetGain()
                      << vr::VRSettings()->GetSettingsErrorNameFromEnum(
                             vrSettingsError );
     }
-    vr::VRSettings()->SetFloat( vr::k_pch_SteamVR_Section,
-                                vr::k_pch_SteamVR_HmdDisplayColorGainG_Float,
-                                1.0f,
-                                &vrSettingsError );
+    ovr_settings_wrapper::settingsCache().setFloat(
+        vr::k_pch_SteamVR_Section,
+        vr::k_pch_SteamVR_HmdDisplayColorGainG_Float,
+        1.0f,
+        &vrSettingsError );
 
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
@@ -629,10 +632,11 @@ void VideoTabController::resetGain()
                             vrSettingsError );
     }
 
-    vr::VRSettings()->SetFloat( vr::k_pch_SteamVR_Section,
-                                vr::k_pch_SteamVR_HmdDisplayColorGainB_Float,
-                                1.0f,
-                                &vrSettingsError );
+    ovr_settings_wrapper::settingsCache().setFloat(
+        vr::k_pch_SteamVR_Section,
+        vr::k_pch_SteamVR_HmdDisplayColorGainB_Float,
+        1.0f,
+        &vrSettingsError );
 
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
@@ -642,6 +646,25 @@ void VideoTabController::resetGain()
     }
 }
 
+// Pushes the stored color to whichever of the color overlay and the display
+// gain is in use. The overlay takes all three channels in one call.
+void VideoTabController::applyColor()
+{
+    if ( !isOverlayMethodActive() )
+    {
+        setColor( colorRed(), colorGreen(), colorBlue(), false, true );
+        return;
+    }
+    const auto overlayError = vr::VROverlay()->SetOverlayColor(
+        m_colorOverlayHandle, colorRed(), colorGreen(), colorBlue() );
+    if ( overlayError != vr::VROverlayError_None )
+    {
+        LOG( ERROR ) << "Could not set color overlay color: "
+                     << vr::VROverlay()->GetOverlayErrorNameFromEnum(
+                            overlayError );
+    }
+}
+
 void VideoTabController::setColor( float R,
                                    float G,
                                    float B,
@@ -796,57 +819,161 @@ void VideoTabController::setAllowSupersampleFiltering( const bool value,
 
 void VideoTabController::addVideoProfile( const QString name )
 {
-    VideoProfile* profile = nullptr;
-    for ( auto& p : videoProfiles )
-    {
-        if ( p.profileName.compare( name.toStdString() ) == 0 )
-        {
-            profile = &p;
-            break;
-        }
-    }
-    if ( !profile )
-    {
-        auto i = videoProfiles.size();
-        videoProfiles.emplace_back();
-        profile = &videoProfiles[i];
-    }
-    profile->profileName = name.toStdString();
-
-    profile->supersampleOverride = m_allowSupersampleOverride;
-    profile->supersampling = m_superSampling;
-    profile->anisotropicFiltering = m_allowSupersampleFiltering;
-    profile->motionSmooth = m_motionSmoothing;
-    profile->colorRed = colorRed();
-    profile->colorGreen = colorGreen();
-    profile->colorBlue = colorBlue();
-    profile->brightnessToggle = brightnessEnabled();
-    profile->brightnessOpacityValue = brightnessOpacityValue();
-    profile->opacity = colorOverlayOpacity();
-    profile->overlayMethodState = isOverlayMethodActive();
-
-    saveVideoProfiles();
+    const auto existing = videoProfiles.find( name.toStdString() );
+    const auto index = existing ? *existing : videoProfiles.append();
+    auto profile = *videoProfiles.get( index );
+    profile.profileName = name.toStdString();
+
+    profile.supersampleOverride = m_allowSupersampleOverride;
+    profile.supersampling = m_superSampling;
+    profile.anisotropicFiltering = m_allowSupersampleFiltering;
+    profile.motionSmooth = m_motionSmoothing;
+    profile.colorRed = colorRed();
+    profile.colorGreen = colorGreen();
+    profile.colorBlue = colorBlue();
+    profile.brightnessToggle = brightnessEnabled();
+    profile.brightnessOpacityValue = brightnessOpacityValue();
+    profile.opacity = colorOverlayOpacity();
+    profile.overlayMethodState = isOverlayMethodActive();
+
+    videoProfiles.save( index, profile );
     emit videoProfilesUpdated();
     emit videoProfileAdded();
 }
 
 void VideoTabController::applyVideoProfile( const unsigned index )
 {
-    if ( index < videoProfiles.size() )
+    using settings::BoolSetting;
+    using settings::DoubleSetting;
+
+    if ( index >= videoProfiles.size() )
     {
-        auto& profile = videoProfiles[index];
+        return;
+    }
+    const auto profile = videoProfiles.get( index );
+
+    // Everything stored in our own settings is applied as one transaction,
+    // OpenVR is only told about the values that actually changed and the
+    // change signals are sent once at the end.
+    settings::SettingsTransaction transaction;
+    transaction.set( BoolSetting::VIDEO_isOverlayMethodActive,
+                     profile->overlayMethodState );
+    if ( !profile->overlayMethodState )
+    {
+        transaction.set( BoolSetting::VIDEO_colorOverlayEnabled, false );
+    }
+    transaction.set( DoubleSetting::VIDEO_colorRed,
+                     static_cast<double>( profile->colorRed ) );
+    transaction.set( DoubleSetting::VIDEO_colorGreen,
+                     static_cast<double>( profile->colorGreen ) );
+    transaction.set( DoubleSetting::VIDEO_colorBlue,
+                     static_cast<double>( profile->colorBlue ) );
+    transaction.set( BoolSetting::VIDEO_brightnessEnabled,
+                     profile->brightnessToggle );
+    transaction.set( DoubleSetting::VIDEO_brightnessOpacityValue,
+                     static_cast<double>( profile->brightnessOpacityValue ) );
+    transaction.set(
+        DoubleSetting::VIDEO_colorOverlayOpacity,
+        static_cast<double>( std::min( profile->opacity, 0.85f ) ) );
+
+    const auto applied = settings::applySettings( transaction );
+    if ( !applied )
+    {
+        LOG( ERROR ) << "Could not apply video profile '"
+                     << profile->profileName << "'.";
+        return;
+    }
 
-        setAllowSupersampleOverride( profile.supersampleOverride );
-        setSuperSampling( profile.supersampling );
-        setAllowSupersampleFiltering( profile.anisotropicFiltering );
-        setMotionSmoothing( profile.motionSmooth );
-        setIsOverlayMethodActive( profile.overlayMethodState );
-        setColorRed( profile.colorRed );
-        setColorBlue( profile.colorBlue );
-        setColorGreen( profile.colorGreen );
-        setBrightnessEnabled( profile.brightnessToggle );
-        setBrightnessOpacityValue( profile.brightnessOpacityValue );
-        setColorOverlayOpacity( profile.opacity );
+    const auto methodChanged
+        = applied->contains( BoolSetting::VIDEO_isOverlayMethodActive );
+    const auto colorChanged
+        = methodChanged || applied->contains( DoubleSetting::VIDEO_colorRed )
+          || applied->contains( DoubleSetting::VIDEO_colorGreen )
+          || applied->contains( DoubleSetting::VIDEO_colorBlue );
+    const auto brightnessChanged
+        = applied->contains( BoolSetting::VIDEO_brightnessEnabled )
+          || applied->contains( DoubleSetting::VIDEO_brightnessOpacityValue );
+
+    if ( methodChanged )
+    {
+        resetGain();
+    }
+    if ( applied->contains( BoolSetting::VIDEO_colorOverlayEnabled ) )
+    {
+        setColorOverlayEnabled( colorOverlayEnabled(), false, true );
+    }
+    if ( colorChanged )
+    {
+        applyColor();
+    }
+    if ( brightnessChanged )
+    {
+        setBrightnessEnabled( brightnessEnabled(), false, true );
+    }
+    if ( applied->contains( DoubleSetting::VIDEO_colorOverlayOpacity ) )
+    {
+        ovr_overlay_wrapper::setOverlayAlpha( m_colorOverlayHandle,
+                                              colorOverlayOpacity() );
+    }
+
+    const auto oldAllowSupersampleOverride = m_allowSupersampleOverride;
+    const auto oldSuperSampling = m_superSampling;
+    const auto oldAllowSupersampleFiltering = m_allowSupersampleFiltering;
+    const auto oldMotionSmoothing = m_motionSmoothing;
+    setAllowSupersampleOverride( profile->supersampleOverride, false );
+    setSuperSampling( profile->supersampling, false );
+    setAllowSupersampleFiltering( profile->anisotropicFiltering, false );
+    setMotionSmoothing( profile->motionSmooth, false );
+
+    // Notifications //
+    if ( methodChanged )
+    {
+        emit isOverlayMethodActiveChanged( isOverlayMethodActive() );
+    }
+    if ( applied->contains( BoolSetting::VIDEO_colorOverlayEnabled ) )
+    {
+        emit colorOverlayEnabledChanged( colorOverlayEnabled() );
+    }
+    if ( applied->contains( DoubleSetting::VIDEO_colorRed ) )
+    {
+        emit colorRedChanged( colorRed() );
+    }
+    if ( applied->contains( DoubleSetting::VIDEO_colorGreen ) )
+    {
+        emit colorGreenChanged( colorGreen() );
+    }
+    if ( applied->contains( DoubleSetting::VIDEO_colorBlue ) )
+    {
+        emit colorBlueChanged( colorBlue() );
+    }
+    if ( applied->contains( BoolSetting::VIDEO_brightnessEnabled ) )
+    {
+        emit brightnessEnabledChanged( brightnessEnabled() );
+    }
+    if ( applied->contains( DoubleSetting::VIDEO_brightnessOpacityValue ) )
+    {
+        emit brightnessOpacityValueChanged( brightnessOpacityValue() );
+    }
+    if ( applied->contains( DoubleSetting::VIDEO_colorOverlayOpacity ) )
+    {
+        emit colorOverlayOpacityChanged( colorOverlayOpacity() );
+    }
+    if ( m_allowSupersampleOverride != oldAllowSupersampleOverride )
+    {
+        emit allowSupersampleOverrideChanged( m_allowSupersampleOverride );
+    }
+    if ( fabs( static_cast<double>( m_superSampling - oldSuperSampling ) )
+         > .005 )
+    {
+        emit superSamplingChanged( m_superSampling );
+    }
+    if ( m_allowSupersampleFiltering != oldAllowSupersampleFiltering )
+    {
+        emit allowSupersampleFilteringChanged( m_allowSupersampleFiltering );
+    }
+    if ( m_motionSmoothing != oldMotionSmoothing )
+    {
+        emit motionSmoothingChanged( m_motionSmoothing );
     }
 }
 
@@ -854,21 +981,14 @@ void VideoTabController::deleteVideoProfile( const unsigned index )
 {
     if ( index < videoProfiles.size() )
     {
-        auto pos = videoProfiles.begin() + index;
-        videoProfiles.erase( pos );
-        saveVideoProfiles();
+        videoProfiles.erase( index );
         emit videoProfilesUpdated();
     }
 }
 
 void VideoTabController::reloadVideoProfiles()
 {
-    settings::loadAllObjects( videoProfiles );
-}
-
-void VideoTabController::saveVideoProfiles()
-{
-    settings::saveAllObjects( videoProfiles );
+    videoProfiles.reload();
 }
 
 int VideoTabController::getVideoProfileCount()
@@ -884,7 +1004,7 @@ QString VideoTabController::getVideoProfileName( const unsigned index )
     }
     else
     {
-        return QString::fromStdString( videoProfiles[index].profileName );
+        return QString::fromStdString( videoProfiles.name( index ) );
     }
 }
 
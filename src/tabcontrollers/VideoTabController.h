@@ -8,6 +8,7 @@
 #include "../openvr/ovr_overlay_wrapper.h"
 #include "../utils/FrameRateUtils.h"
 #include "../settings/settings_object.h"
+#include "../settings/profile_list.h"
 
 class QQuickWindow;
 
@@ -157,6 +158,7 @@ class VideoTabController : public QObject
                    float B,
                    bool notify = true,
                    bool keepValue = false );
+    void applyColor();
     void resetGain();
 
     void initColorOverlay();
@@ -169,7 +171,7 @@ class VideoTabController : public QObject
     void synchGain( bool setValue = false );
     void synchSteamVR();
 
-    std::vector<VideoProfile> videoProfiles;
+    settings::ProfileList<VideoProfile> videoProfiles;
 
     QString getSettingsName()
     {
@@ -210,7 +212,6 @@ class VideoTabController : public QObject
     void dashboardLoopTick();
 
     void reloadVideoProfiles();
-    void saveVideoProfiles();
 
     Q_INVOKABLE int getVideoProfileCount();
     Q_INVOKABLE QString getVideoProfileName( unsigned index );
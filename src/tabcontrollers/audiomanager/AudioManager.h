@@ -64,6 +64,14 @@ class AudioManager
 
     virtual std::vector<AudioDevice> getRecordingDevices() = 0;
     virtual std::vector<AudioDevice> getPlaybackDevices() = 0;
+
+    // Backends that call AudioTabController::onVolumeStateChanged whenever
+    // a mirror or microphone volume or mute state changes don't need to be
+    // polled for them.
+    virtual bool reportsVolumeChanges()
+    {
+        return false;
+    }
 };
 
 } // namespace advsettings
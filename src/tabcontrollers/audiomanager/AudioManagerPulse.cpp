@@ -13,12 +13,23 @@ namespace advsettings
 AudioManagerPulse::~AudioManagerPulse()
 {
     restorePulseAudioState();
+    shutdownPulseAudio();
 }
 
 void AudioManagerPulse::init( AudioTabController* controller )
 {
     m_controller = controller;
 
+    // Device changes are reported on the PulseAudio thread.
+    pulseAudioData.onDevicesChanged = [controller]() {
+        QMetaObject::invokeMethod(
+            controller,
+            [controller]() { controller->onDeviceStateChanged(); },
+            Qt::QueuedConnection );
+    };
+    pulseAudioData.onVolumesChanged
+        = [controller]() { controller->onVolumeStateChanged(); };
+
     initializePulseAudio();
 }
 
@@ -150,4 +161,9 @@ std::vector<AudioDevice> AudioManagerPulse::getPlaybackDevices()
     return returnPlaybackDevices();
 }
 
+bool AudioManagerPulse::reportsVolumeChanges()
+{
+    return true;
+}
+
 } // namespace advsettings
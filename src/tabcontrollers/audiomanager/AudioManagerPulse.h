@@ -39,6 +39,8 @@ class AudioManagerPulse : public AudioManager
     virtual std::vector<AudioDevice> getRecordingDevices() override;
     virtual std::vector<AudioDevice> getPlaybackDevices() override;
 
+    virtual bool reportsVolumeChanges() override;
+
 private:
     AudioTabController* m_controller;
 };
@@ -1,6 +1,10 @@
 #pragma once
 #include <pulse/pulseaudio.h>
+#include <algorithm>
+#include <functional>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include <easylogging++.h>
 #include "AudioManager.h"
 
@@ -8,6 +12,12 @@
 // parameter. The cast is to get GCC to shut up about it.
 #define UNREFERENCED_PARAMETER( P ) static_cast<void>( ( P ) )
 
+// PulseAudio runs on its own thread through pa_threaded_mainloop. The sinks,
+// sources and default devices are fetched once when connecting and are kept
+// current by subscribing to server events afterwards, so reads only copy from
+// the cache and writes are sent without waiting for the server to answer.
+// Everything in pulseAudioData is guarded by the mainloop lock, callbacks
+// already run with it held.
 namespace advsettings
 {
 enum class PulseAudioIsLastMeaning
@@ -17,21 +27,28 @@ enum class PulseAudioIsLastMeaning
     PreviousDeviceWasLastReal,
 };
 
-enum class PulseAudioLoopControl
+struct PulseAudioDevice
 {
-    Stop,
-    Run,
+    uint32_t index;
+    std::string id;
+    std::string name;
+    pa_cvolume volume;
+    bool muted;
 };
 
 struct
 {
-    pa_mainloop* mainLoop;
+    pa_threaded_mainloop* mainLoop;
     pa_mainloop_api* api;
     pa_context* context;
 } pulseAudioPointers;
 
 struct
 {
+    bool connected = false;
+    // Queries of the initial fetch that haven't finished yet.
+    int pendingInitialQueries = 0;
+
     std::string defaultSinkOutputDeviceId;
     std::string defaultSourceInputDeviceId;
 
@@ -41,26 +58,49 @@ struct
     float originalDefaultOutputDeviceVolume;
     float originalDefaultInputDeviceVolume;
 
-    std::vector<AudioDevice> sinkOutputDevices;
-    std::vector<AudioDevice> sourceInputDevices;
+    std::vector<PulseAudioDevice> sinkOutputDevices;
+    std::vector<PulseAudioDevice> sourceInputDevices;
 
-    pa_sink_info currentDefaultSinkInfo;
-    pa_source_info currentDefaultSourceInfo;
-} pulseAudioData;
+    // Source the source outputs are moved to by setMicrophoneDevice.
+    std::string sourceOutputTarget;
 
-static PulseAudioLoopControl loopControl = PulseAudioLoopControl::Run;
+    // Called on the PulseAudio thread when devices were added or removed or
+    // the default devices changed. Volume and mute changes don't count.
+    std::function<void()> onDevicesChanged;
+    // Called on the PulseAudio thread when the volume or mute state of a
+    // device changed.
+    std::function<void()> onVolumesChanged;
+} pulseAudioData;
 
-void customPulseLoop()
+// Holds the mainloop lock for reads and writes from outside the PulseAudio
+// thread.
+class PulseAudioLock
 {
-    while ( loopControl == PulseAudioLoopControl::Run )
+public:
+    PulseAudioLock()
     {
-        constexpr auto noReturnValue = nullptr;
-        constexpr auto blockForEvents = 1;
-        pa_mainloop_iterate(
-            pulseAudioPointers.mainLoop, blockForEvents, noReturnValue );
+        if ( pulseAudioPointers.mainLoop )
+        {
+            pa_threaded_mainloop_lock( pulseAudioPointers.mainLoop );
+        }
     }
+    ~PulseAudioLock()
+    {
+        if ( pulseAudioPointers.mainLoop )
+        {
+            pa_threaded_mainloop_unlock( pulseAudioPointers.mainLoop );
+        }
+    }
+
+    PulseAudioLock( const PulseAudioLock& ) = delete;
+    PulseAudioLock& operator=( const PulseAudioLock& ) = delete;
+};
 
-    loopControl = PulseAudioLoopControl::Run;
+void signalPulseAudioWaiters()
+{
+    constexpr auto dontWaitForAccept = 0;
+    pa_threaded_mainloop_signal( pulseAudioPointers.mainLoop,
+                                 dontWaitForAccept );
 }
 
 // Error function
@@ -72,6 +112,7 @@ void dumpPulseAudioState()
     LOG( ERROR ) << "mainLoop: " << pulseAudioPointers.mainLoop;
     LOG( ERROR ) << "api: " << pulseAudioPointers.api;
     LOG( ERROR ) << "context: " << pulseAudioPointers.context;
+    LOG( ERROR ) << "connected: " << pulseAudioData.connected;
 
     LOG( ERROR ) << "";
 
@@ -83,20 +124,13 @@ void dumpPulseAudioState()
 
     LOG( ERROR ) << "";
 
-    LOG( ERROR ) << "\tcurrentDefaultSinkInfo name: "
-                 << pulseAudioData.currentDefaultSinkInfo.name;
-    LOG( ERROR ) << "\tcurrentDefaultSourceInfo name: "
-                 << pulseAudioData.currentDefaultSourceInfo.name;
-
-    LOG( ERROR ) << "";
-
     LOG( ERROR ) << "sinkOutputDevices: ";
     LOG_IF( pulseAudioData.sinkOutputDevices.size() == 0, ERROR )
         << "\tOutput devices size zero.";
     for ( const auto& device : pulseAudioData.sinkOutputDevices )
     {
-        LOG( ERROR ) << "\tDevice Name: " << device.name();
-        LOG( ERROR ) << "\tDevice Id: " << device.id();
+        LOG( ERROR ) << "\tDevice Name: " << device.name;
+        LOG( ERROR ) << "\tDevice Id: " << device.id;
     }
 
     LOG( ERROR ) << "";
@@ -106,8 +140,8 @@ void dumpPulseAudioState()
         << "\tInput devices size zero.";
     for ( const auto& device : pulseAudioData.sourceInputDevices )
     {
-        LOG( ERROR ) << "\tDevice Name: " << device.name();
-        LOG( ERROR ) << "\tDevice Id: " << device.id();
+        LOG( ERROR ) << "\tDevice Name: " << device.name;
+        LOG( ERROR ) << "\tDevice Id: " << device.id;
     }
 
     LOG( ERROR ) << "____";
@@ -135,6 +169,7 @@ std::string getDeviceName( pa_proplist* p )
     if ( !p )
     {
         LOG( ERROR ) << "proplist not valid.";
+        return "ERROR";
     }
 
     constexpr auto deviceDescription = "device.description";
@@ -151,7 +186,28 @@ std::string getDeviceName( pa_proplist* p )
     return s;
 }
 
-template <class T> void deviceCallback( const T* i, const int isLast )
+void notifyDevicesChanged()
+{
+    // Changes during the initial fetch are picked up by init.
+    if ( pulseAudioData.pendingInitialQueries == 0
+         && pulseAudioData.onDevicesChanged )
+    {
+        pulseAudioData.onDevicesChanged();
+    }
+}
+
+// userdata is non null for the queries of the initial fetch.
+void finishQuery( void* userdata )
+{
+    if ( userdata != nullptr )
+    {
+        --pulseAudioData.pendingInitialQueries;
+        signalPulseAudioWaiters();
+    }
+}
+
+template <class T>
+void deviceCallback( const T* i, const int isLast, void* userdata )
 {
     static_assert(
         std::is_same<pa_source_info, T>::value
@@ -161,41 +217,53 @@ template <class T> void deviceCallback( const T* i, const int isLast )
     const auto deviceState = getIsLastMeaning( isLast );
     if ( deviceState == PulseAudioIsLastMeaning::PreviousDeviceWasLastReal )
     {
-        loopControl = PulseAudioLoopControl::Stop;
+        finishQuery( userdata );
         return;
     }
     else if ( deviceState == PulseAudioIsLastMeaning::Error )
     {
+        // Also happens when a device is removed before its info arrived.
         LOG( ERROR ) << "Error in deviceCallback function.";
-        dumpPulseAudioState();
-        loopControl = PulseAudioLoopControl::Stop;
+        finishQuery( userdata );
         return;
     }
 
-    if constexpr ( std::is_same<pa_source_info, T>::value )
+    auto& devices = std::is_same<pa_source_info, T>::value
+                        ? pulseAudioData.sourceInputDevices
+                        : pulseAudioData.sinkOutputDevices;
+
+    auto device = std::find_if(
+        devices.begin(), devices.end(), [i]( const PulseAudioDevice& d ) {
+            return d.index == i->index;
+        } );
+    const auto name = getDeviceName( i->proplist );
+    const auto listChanged = device == devices.end() || device->name != name
+                             || device->id != i->name;
+    const auto volumeChanged
+        = !listChanged
+          && ( !pa_cvolume_equal( &device->volume, &i->volume )
+               || device->muted != ( i->mute != 0 ) );
+    if ( device == devices.end() )
     {
-        if ( i->name == pulseAudioData.defaultSourceInputDeviceId )
-        {
-            pulseAudioData.currentDefaultSourceInfo = *i;
-        }
-
-        LOG( DEBUG ) << "Adding device to input: '" << i->name << "', '"
-                     << getDeviceName( i->proplist ) << "'.";
-        pulseAudioData.sourceInputDevices.push_back(
-            AudioDevice( i->name, getDeviceName( i->proplist ) ) );
+        LOG( DEBUG ) << "Adding device: '" << i->name << "', '" << name
+                     << "'.";
+        devices.push_back( PulseAudioDevice{} );
+        device = devices.end() - 1;
     }
 
-    else if constexpr ( std::is_same<pa_sink_info, T>::value )
-    {
-        if ( i->name == pulseAudioData.defaultSinkOutputDeviceId )
-        {
-            pulseAudioData.currentDefaultSinkInfo = *i;
-        }
+    device->index = i->index;
+    device->id.assign( i->name );
+    device->name = name;
+    device->volume = i->volume;
+    device->muted = i->mute != 0;
 
-        LOG( DEBUG ) << "Adding device to output: '" << i->name << "', '"
-                     << getDeviceName( i->proplist ) << "'.";
-        pulseAudioData.sinkOutputDevices.push_back(
-            AudioDevice( i->name, getDeviceName( i->proplist ) ) );
+    if ( listChanged )
+    {
+        notifyDevicesChanged();
+    }
+    else if ( volumeChanged && pulseAudioData.onVolumesChanged )
+    {
+        pulseAudioData.onVolumesChanged();
     }
 }
 
@@ -204,10 +272,9 @@ void setInputDevicesCallback( pa_context* c,
                               int isLast,
                               void* userdata )
 {
-    UNREFERENCED_PARAMETER( userdata );
     UNREFERENCED_PARAMETER( c );
 
-    deviceCallback( i, isLast );
+    deviceCallback( i, isLast, userdata );
 }
 
 void setOutputDevicesCallback( pa_context* c,
@@ -215,10 +282,9 @@ void setOutputDevicesCallback( pa_context* c,
                                int isLast,
                                void* userdata )
 {
-    UNREFERENCED_PARAMETER( userdata );
     UNREFERENCED_PARAMETER( c );
 
-    deviceCallback( i, isLast );
+    deviceCallback( i, isLast, userdata );
 }
 
 void getDefaultDevicesCallback( pa_context* c,
@@ -226,135 +292,250 @@ void getDefaultDevicesCallback( pa_context* c,
                                 void* userdata )
 {
     UNREFERENCED_PARAMETER( c );
-    UNREFERENCED_PARAMETER( userdata );
 
     if ( !i )
     {
         LOG( ERROR ) << "i == 0";
         pulseAudioData.defaultSinkOutputDeviceId = "DDO:ERROR";
         pulseAudioData.defaultSourceInputDeviceId = "DDI:ERROR";
+        finishQuery( userdata );
         return;
     }
 
-    // Copy because we don't know how long the pa_server_info* lives for
-    pulseAudioData.defaultSinkOutputDeviceId.assign( i->default_sink_name );
-    pulseAudioData.defaultSourceInputDeviceId.assign( i->default_source_name );
+    // The names are empty while there is no default device.
+    const std::string sink = i->default_sink_name ? i->default_sink_name : "";
+    const std::string source
+        = i->default_source_name ? i->default_source_name : "";
+    const auto changed = sink != pulseAudioData.defaultSinkOutputDeviceId
+                         || source != pulseAudioData.defaultSourceInputDeviceId;
 
-    loopControl = PulseAudioLoopControl::Stop;
+    pulseAudioData.defaultSinkOutputDeviceId = sink;
+    pulseAudioData.defaultSourceInputDeviceId = source;
 
     LOG( DEBUG ) << "getDefaultDevicesCallback done with sink output device: '"
                  << pulseAudioData.defaultSinkOutputDeviceId
                  << "' and source input '"
                  << pulseAudioData.defaultSourceInputDeviceId << "'.";
+
+    finishQuery( userdata );
+    if ( changed )
+    {
+        notifyDevicesChanged();
+    }
+}
+
+void removeDevice( std::vector<PulseAudioDevice>& devices,
+                   const uint32_t index )
+{
+    const auto removed = std::remove_if(
+        devices.begin(), devices.end(), [index]( const PulseAudioDevice& d ) {
+            return d.index == index;
+        } );
+    if ( removed != devices.end() )
+    {
+        devices.erase( removed, devices.end() );
+        notifyDevicesChanged();
+    }
+}
+
+void forgetOperation( pa_operation* operation )
+{
+    if ( operation )
+    {
+        pa_operation_unref( operation );
+    }
+}
+
+void subscriptionCallback( pa_context* c,
+                           pa_subscription_event_type_t event,
+                           uint32_t index,
+                           void* userdata )
+{
+    UNREFERENCED_PARAMETER( userdata );
+
+    const auto facility = event & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+    const auto type = event & PA_SUBSCRIPTION_EVENT_TYPE_MASK;
+    constexpr auto noCustomUserdata = nullptr;
+
+    if ( facility == PA_SUBSCRIPTION_EVENT_SERVER )
+    {
+        forgetOperation( pa_context_get_server_info(
+            c, getDefaultDevicesCallback, noCustomUserdata ) );
+    }
+    else if ( facility == PA_SUBSCRIPTION_EVENT_SINK )
+    {
+        if ( type == PA_SUBSCRIPTION_EVENT_REMOVE )
+        {
+            removeDevice( pulseAudioData.sinkOutputDevices, index );
+            return;
+        }
+        forgetOperation( pa_context_get_sink_info_by_index(
+            c, index, setOutputDevicesCallback, noCustomUserdata ) );
+    }
+    else if ( facility == PA_SUBSCRIPTION_EVENT_SOURCE )
+    {
+        if ( type == PA_SUBSCRIPTION_EVENT_REMOVE )
+        {
+            removeDevice( pulseAudioData.sourceInputDevices, index );
+            return;
+        }
+        forgetOperation( pa_context_get_source_info_by_index(
+            c, index, setInputDevicesCallback, noCustomUserdata ) );
+    }
 }
 
 void stateCallbackFunction( pa_context* c, void* userdata )
 {
-    UNREFERENCED_PARAMETER( c );
     UNREFERENCED_PARAMETER( userdata );
 
     switch ( pa_context_get_state( c ) )
     {
     case PA_CONTEXT_TERMINATED:
         LOG( ERROR ) << "PA_CONTEXT_TERMINATED in stateCallbackFunction";
-        dumpPulseAudioState();
-        return;
+        pulseAudioData.connected = false;
+        break;
     case PA_CONTEXT_CONNECTING:
         LOG( DEBUG ) << "PA_CONTEXT_CONNECTING";
-        return;
+        break;
     case PA_CONTEXT_AUTHORIZING:
         LOG( DEBUG ) << "PA_CONTEXT_AUTHORIZING";
-        return;
+        break;
     case PA_CONTEXT_SETTING_NAME:
         LOG( DEBUG ) << "PA_CONTEXT_SETTING_NAME";
-        return;
+        break;
     case PA_CONTEXT_UNCONNECTED:
         LOG( DEBUG ) << "PA_CONTEXT_UNCONNECTED";
-        return;
+        break;
     case PA_CONTEXT_FAILED:
-        LOG( DEBUG ) << "PA_CONTEXT_FAILED";
-        return;
+        LOG( ERROR ) << "PA_CONTEXT_FAILED";
+        pulseAudioData.connected = false;
+        break;
 
     case PA_CONTEXT_READY:
         LOG( DEBUG ) << "PA_CONTEXT_READY";
-        loopControl = PulseAudioLoopControl::Stop;
-        return;
+        pulseAudioData.connected = true;
+        break;
     }
+
+    // initializePulseAudio waits for the connection to be ready or failed.
+    signalPulseAudioWaiters();
 }
 
-void updateAllPulseData()
+// userdata is the description of the operation for the log.
+void successCallback( pa_context* c, int success, void* userdata )
 {
-    constexpr auto noCustomUserdata = nullptr;
+    UNREFERENCED_PARAMETER( c );
+
+    if ( !success )
+    {
+        LOG( ERROR ) << "Non successful callback operation: "
+                     << static_cast<const char*>( userdata ) << ".";
+        dumpPulseAudioState();
+    }
+}
 
-    pa_context_get_server_info( pulseAudioPointers.context,
-                                getDefaultDevicesCallback,
-                                noCustomUserdata );
-    customPulseLoop();
+// Sends the operation without waiting for the server to answer, failures
+// are logged by successCallback.
+bool sendOperation( pa_operation* operation, const char* description )
+{
+    if ( !operation )
+    {
+        LOG( ERROR ) << description << " could not be sent: "
+                     << pa_strerror(
+                            pa_context_errno( pulseAudioPointers.context ) );
+        return false;
+    }
+    pa_operation_unref( operation );
+    return true;
+}
 
-    pulseAudioData.sinkOutputDevices.clear();
-    pa_context_get_sink_info_list( pulseAudioPointers.context,
-                                   setOutputDevicesCallback,
-                                   noCustomUserdata );
-    customPulseLoop();
+void* describe( const char* description )
+{
+    return const_cast<char*>( description );
+}
 
-    pulseAudioData.sourceInputDevices.clear();
-    pa_context_get_source_info_list(
-        pulseAudioPointers.context, setInputDevicesCallback, noCustomUserdata );
-    customPulseLoop();
+PulseAudioDevice* findDevice( std::vector<PulseAudioDevice>& devices,
+                              const std::string& id )
+{
+    for ( auto& device : devices )
+    {
+        if ( device.id == id )
+        {
+            return &device;
+        }
+    }
+    return nullptr;
+}
 
-    LOG( DEBUG ) << "updateAllPulseData done.";
+PulseAudioDevice* defaultSink()
+{
+    return findDevice( pulseAudioData.sinkOutputDevices,
+                       pulseAudioData.defaultSinkOutputDeviceId );
 }
 
-void successCallback( pa_context* c, int success, void* successVariable )
+PulseAudioDevice* defaultSource()
 {
-    UNREFERENCED_PARAMETER( c );
+    return findDevice( pulseAudioData.sourceInputDevices,
+                       pulseAudioData.defaultSourceInputDeviceId );
+}
 
-    if ( successVariable != nullptr )
+float linearVolume( const PulseAudioDevice* device )
+{
+    if ( !device )
     {
-        *static_cast<bool*>( successVariable ) = success;
+        return 0.0f;
     }
+    return static_cast<float>(
+        pa_sw_volume_to_linear( pa_cvolume_avg( &device->volume ) ) );
+}
 
-    if ( !success )
+std::vector<AudioDevice> toAudioDevices(
+    const std::vector<PulseAudioDevice>& devices )
+{
+    std::vector<AudioDevice> audioDevices;
+    audioDevices.reserve( devices.size() );
+    for ( const auto& device : devices )
     {
-        LOG( ERROR ) << "Non successful callback operation.";
-        dumpPulseAudioState();
+        audioDevices.emplace_back( device.id, device.name );
     }
-
-    loopControl = PulseAudioLoopControl::Stop;
+    return audioDevices;
 }
 
 void setPlaybackDeviceInternal( const std::string& id )
 {
-    updateAllPulseData();
-
-    auto success = false;
-    pa_context_set_default_sink(
-        pulseAudioPointers.context, id.c_str(), successCallback, &success );
-
-    customPulseLoop();
+    PulseAudioLock lock;
+    if ( !pulseAudioData.connected )
+    {
+        return;
+    }
 
-    if ( !success )
+    if ( !sendOperation(
+             pa_context_set_default_sink( pulseAudioPointers.context,
+                                          id.c_str(),
+                                          successCallback,
+                                          describe( "set default sink" ) ),
+             "set default sink" ) )
     {
         LOG( ERROR ) << "setPlaybackDeviceInternal failed to set default sink "
                         "for device '"
                      << id << "'.";
+        return;
     }
 
+    // The server event confirms it later, until then follow up writes
+    // already go to the new device.
+    pulseAudioData.defaultSinkOutputDeviceId = id;
+
     LOG( DEBUG ) << "setPlaybackDeviceInternal done with id: " << id;
 }
 
 std::string getCurrentDefaultPlaybackDeviceName()
 {
-    updateAllPulseData();
+    PulseAudioLock lock;
 
-    for ( const auto& dev : pulseAudioData.sinkOutputDevices )
+    if ( const auto device = defaultSink() )
     {
-        if ( dev.id() == pulseAudioData.defaultSinkOutputDeviceId )
-        {
-            LOG( DEBUG ) << "getCurrentDefaultPlaybackDeviceName done with "
-                         << dev.name();
-            return dev.name();
-        }
+        return device->name;
     }
     LOG( ERROR ) << "Unable to find default playback device.";
 
@@ -363,142 +544,128 @@ std::string getCurrentDefaultPlaybackDeviceName()
 
 std::string getCurrentDefaultPlaybackDeviceId()
 {
-    updateAllPulseData();
-
-    LOG( DEBUG ) << "getCurrentDefaultPlaybackDeviceId done with "
-                 << pulseAudioData.defaultSinkOutputDeviceId;
+    PulseAudioLock lock;
 
     return pulseAudioData.defaultSinkOutputDeviceId;
 }
 
 std::string getCurrentDefaultRecordingDeviceName()
 {
-    updateAllPulseData();
+    PulseAudioLock lock;
 
-    for ( const auto& dev : pulseAudioData.sourceInputDevices )
+    if ( const auto device = defaultSource() )
     {
-        if ( dev.id() == pulseAudioData.defaultSourceInputDeviceId )
-        {
-            LOG( DEBUG ) << "getCurrentDefaultRecordingDeviceName done with: "
-                         << dev.name();
-            return dev.name();
-        }
+        return device->name;
     }
-    LOG( ERROR ) << "Unable to find default playback device.";
+    LOG( ERROR ) << "Unable to find default recording device.";
 
     return "ERROR";
 }
 
 std::string getCurrentDefaultRecordingDeviceId()
 {
-    updateAllPulseData();
-
-    LOG( DEBUG ) << "getCurrentDefaultRecordingDeviceId done with "
-                 << pulseAudioData.defaultSourceInputDeviceId;
+    PulseAudioLock lock;
 
     return pulseAudioData.defaultSourceInputDeviceId;
 }
 
 std::vector<AudioDevice> returnRecordingDevices()
 {
-    updateAllPulseData();
+    PulseAudioLock lock;
 
-    return pulseAudioData.sourceInputDevices;
+    return toAudioDevices( pulseAudioData.sourceInputDevices );
 }
 
 std::vector<AudioDevice> returnPlaybackDevices()
 {
-    updateAllPulseData();
+    PulseAudioLock lock;
 
-    return pulseAudioData.sinkOutputDevices;
+    return toAudioDevices( pulseAudioData.sinkOutputDevices );
 }
 
 bool isMicrophoneValid()
 {
-    updateAllPulseData();
-
-    const auto valid = pulseAudioData.defaultSourceInputDeviceId != "";
+    PulseAudioLock lock;
 
-    return valid;
+    return pulseAudioData.connected
+           && pulseAudioData.defaultSourceInputDeviceId != "";
 }
 
 float getMicrophoneVolume()
 {
-    updateAllPulseData();
-
-    const auto linearVolume = pa_sw_volume_to_linear(
-        pa_cvolume_avg( &pulseAudioData.currentDefaultSourceInfo.volume ) );
+    PulseAudioLock lock;
 
-    return static_cast<float>( linearVolume );
+    return linearVolume( defaultSource() );
 }
 
 bool getMicrophoneMuted()
 {
-    updateAllPulseData();
+    PulseAudioLock lock;
 
-    return pulseAudioData.currentDefaultSourceInfo.mute;
+    const auto device = defaultSource();
+    return device && device->muted;
 }
 
 void sourceOutputCallback( pa_context* c,
                            const pa_source_output_info* i,
                            int isLast,
-                           void* success )
+                           void* userdata )
 {
+    UNREFERENCED_PARAMETER( userdata );
+
     const auto deviceState = getIsLastMeaning( isLast );
-    if ( deviceState == PulseAudioIsLastMeaning::PreviousDeviceWasLastReal )
-    {
-        loopControl = PulseAudioLoopControl::Stop;
-        return;
-    }
-    else if ( deviceState == PulseAudioIsLastMeaning::Error )
+    if ( deviceState != PulseAudioIsLastMeaning::RealDevice )
     {
-        LOG( ERROR ) << "Error in sourceOutputCallback function.";
-        dumpPulseAudioState();
         return;
     }
 
-    const auto sourceOutputIndex = i->index;
-    const auto sourceIndex = pulseAudioData.currentDefaultSourceInfo.index;
-
-    LOG( DEBUG ) << "Attempting to move sourceOutputIndex: '"
-                 << sourceOutputIndex << "' to sourceIndex '" << sourceIndex
+    LOG( DEBUG ) << "Attempting to move sourceOutputIndex: '" << i->index
+                 << "' to source '" << pulseAudioData.sourceOutputTarget
                  << "' with source output name " << i->name << ".";
 
-    pa_context_move_source_output_by_index(
-        c, sourceOutputIndex, sourceIndex, successCallback, &success );
+    sendOperation( pa_context_move_source_output_by_name(
+                       c,
+                       i->index,
+                       pulseAudioData.sourceOutputTarget.c_str(),
+                       successCallback,
+                       describe( "move source output" ) ),
+                   "move source output" );
 }
 
 void setMicrophoneDevice( const std::string& id )
 {
     LOG( DEBUG ) << "setMicrophoneDevice called with 'id': " << id;
 
-    updateAllPulseData();
-
-    auto success = false;
-    pa_context_set_default_source(
-        pulseAudioPointers.context, id.c_str(), successCallback, &success );
-
-    customPulseLoop();
+    PulseAudioLock lock;
+    if ( !pulseAudioData.connected )
+    {
+        return;
+    }
 
-    if ( !success )
+    if ( !sendOperation(
+             pa_context_set_default_source( pulseAudioPointers.context,
+                                            id.c_str(),
+                                            successCallback,
+                                            describe( "set default source" ) ),
+             "set default source" ) )
     {
         LOG( ERROR ) << "Error setting microphone device for '" << id << "'.";
+        return;
     }
+    pulseAudioData.defaultSourceInputDeviceId = id;
 
-    updateAllPulseData();
-
-    pa_context_get_source_output_info_list(
-        pulseAudioPointers.context, sourceOutputCallback, &success );
-
-    customPulseLoop();
-
-    if ( !success )
+    // Streams that are already recording stay on the old source otherwise.
+    pulseAudioData.sourceOutputTarget = id;
+    constexpr auto noCustomUserdata = nullptr;
+    if ( !sendOperation(
+             pa_context_get_source_output_info_list( pulseAudioPointers.context,
+                                                     sourceOutputCallback,
+                                                     noCustomUserdata ),
+             "list source outputs" ) )
     {
         LOG( ERROR ) << "Error in moving source outputs to new source.";
     }
 
-    updateAllPulseData();
-
     LOG( DEBUG ) << "setMicrophoneDevice done.";
 }
 
@@ -506,28 +673,30 @@ bool setPlaybackVolume( const float volume )
 {
     LOG( DEBUG ) << "setPlaybackVolume called with 'volume': " << volume;
 
-    updateAllPulseData();
+    PulseAudioLock lock;
+    const auto device = defaultSink();
+    if ( !pulseAudioData.connected || !device )
+    {
+        LOG( ERROR ) << "setPlaybackVolume failed to set volume '" << volume
+                     << "' for device '"
+                     << pulseAudioData.defaultSinkOutputDeviceId << "'.";
+        return false;
+    }
 
-    auto pulseVolume = pulseAudioData.currentDefaultSinkInfo.volume;
+    auto pulseVolume = device->volume;
     const auto vol = pa_sw_volume_from_linear( static_cast<double>( volume ) );
-
     pa_cvolume_set( &pulseVolume, pulseVolume.channels, vol );
 
-    auto success = false;
-    pa_context_set_sink_volume_by_name(
-        pulseAudioPointers.context,
-        pulseAudioData.defaultSinkOutputDeviceId.c_str(),
-        &pulseVolume,
-        successCallback,
-        &success );
-
-    customPulseLoop();
-
-    if ( !success )
+    const auto success = sendOperation(
+        pa_context_set_sink_volume_by_name( pulseAudioPointers.context,
+                                            device->id.c_str(),
+                                            &pulseVolume,
+                                            successCallback,
+                                            describe( "set sink volume" ) ),
+        "set sink volume" );
+    if ( success )
     {
-        LOG( ERROR ) << "setPlaybackVolume failed to set volume '" << volume
-                     << "' for device '"
-                     << pulseAudioData.defaultSinkOutputDeviceId << "'.";
+        device->volume = pulseVolume;
     }
 
     LOG( DEBUG ) << "setPlaybackVolume done with 'success': " << success;
@@ -539,28 +708,30 @@ bool setMicrophoneVolume( const float volume )
 {
     LOG( DEBUG ) << "setMicrophoneVolume called with 'volume': " << volume;
 
-    updateAllPulseData();
+    PulseAudioLock lock;
+    const auto device = defaultSource();
+    if ( !pulseAudioData.connected || !device )
+    {
+        LOG( ERROR ) << "setMicrophoneVolume failed to set volume '" << volume
+                     << "' for device '"
+                     << pulseAudioData.defaultSourceInputDeviceId << "'.";
+        return false;
+    }
 
-    auto pulseVolume = pulseAudioData.currentDefaultSourceInfo.volume;
+    auto pulseVolume = device->volume;
     const auto vol = pa_sw_volume_from_linear( static_cast<double>( volume ) );
-
     pa_cvolume_set( &pulseVolume, pulseVolume.channels, vol );
 
-    auto success = false;
-    pa_context_set_source_volume_by_name(
-        pulseAudioPointers.context,
-        pulseAudioData.defaultSourceInputDeviceId.c_str(),
-        &pulseVolume,
-        successCallback,
-        &success );
-
-    customPulseLoop();
-
-    if ( !success )
+    const auto success = sendOperation(
+        pa_context_set_source_volume_by_name( pulseAudioPointers.context,
+                                              device->id.c_str(),
+                                              &pulseVolume,
+                                              successCallback,
+                                              describe( "set source volume" ) ),
+        "set source volume" );
+    if ( success )
     {
-        LOG( ERROR ) << "seMicrophoneVolume failed to set volume '" << volume
-                     << "' for device '"
-                     << pulseAudioData.defaultSourceInputDeviceId << "'.";
+        device->volume = pulseVolume;
     }
 
     LOG( DEBUG ) << "setMicrophoneVolume done with 'success': " << success;
@@ -568,32 +739,68 @@ bool setMicrophoneVolume( const float volume )
     return success;
 }
 
+// Called for every push-to-talk change, it only queues the request for the
+// PulseAudio thread.
 bool setMicMuteState( const bool muted )
 {
-    LOG( DEBUG ) << "setMicMuteState called with 'muted': " << muted;
-    bool success = false;
-
-    pa_context_set_source_mute_by_name(
-        pulseAudioPointers.context,
-        pulseAudioData.defaultSourceInputDeviceId.c_str(),
-        muted,
-        successCallback,
-        &success );
-
-    customPulseLoop();
-
-    if ( !success )
+    PulseAudioLock lock;
+    const auto device = defaultSource();
+    if ( !pulseAudioData.connected || !device )
     {
         LOG( ERROR ) << "setMicMuteState failed to set muted '" << muted
                      << "' for device '"
                      << pulseAudioData.defaultSourceInputDeviceId << "'.";
+        return false;
     }
 
-    LOG( DEBUG ) << "setMicMuteState done with 'success': " << success;
+    const auto success = sendOperation(
+        pa_context_set_source_mute_by_name( pulseAudioPointers.context,
+                                            device->id.c_str(),
+                                            muted,
+                                            successCallback,
+                                            describe( "set source mute" ) ),
+        "set source mute" );
+    if ( success )
+    {
+        device->muted = muted;
+    }
 
     return success;
 }
 
+void drainCallback( pa_context* c, void* userdata )
+{
+    UNREFERENCED_PARAMETER( c );
+    UNREFERENCED_PARAMETER( userdata );
+
+    signalPulseAudioWaiters();
+}
+
+// Waits until the server answered everything sent so far.
+void drainPulseAudio()
+{
+    PulseAudioLock lock;
+    if ( !pulseAudioData.connected )
+    {
+        return;
+    }
+
+    constexpr auto noCustomUserdata = nullptr;
+    const auto operation = pa_context_drain(
+        pulseAudioPointers.context, drainCallback, noCustomUserdata );
+    if ( !operation )
+    {
+        // Nothing was pending.
+        return;
+    }
+    while ( pa_operation_get_state( operation ) == PA_OPERATION_RUNNING
+            && pulseAudioData.connected )
+    {
+        pa_threaded_mainloop_wait( pulseAudioPointers.mainLoop );
+    }
+    pa_operation_unref( operation );
+}
+
 void restorePulseAudioState()
 {
     LOG( DEBUG ) << "restorePulseAudioState called.";
@@ -604,46 +811,119 @@ void restorePulseAudioState()
     setMicrophoneDevice( pulseAudioData.originalDefaultInputDeviceId );
     setMicrophoneVolume( pulseAudioData.originalDefaultInputDeviceVolume );
 
+    drainPulseAudio();
+
     LOG( DEBUG ) << "restorePulseAudioState done.";
 }
 
+// Connects and fills the cache. This is the only place that waits for the
+// server.
 void initializePulseAudio()
 {
     LOG( DEBUG ) << "initializePulseAudio called.";
 
-    pulseAudioPointers.mainLoop = pa_mainloop_new();
-
-    pulseAudioPointers.api = pa_mainloop_get_api( pulseAudioPointers.mainLoop );
-
+    pulseAudioPointers.mainLoop = pa_threaded_mainloop_new();
+    pulseAudioPointers.api
+        = pa_threaded_mainloop_get_api( pulseAudioPointers.mainLoop );
     pulseAudioPointers.context
         = pa_context_new( pulseAudioPointers.api, "openvr-advanced-settings" );
 
     constexpr auto noCustomUserdata = nullptr;
     pa_context_set_state_callback(
         pulseAudioPointers.context, stateCallbackFunction, noCustomUserdata );
+    pa_context_set_subscribe_callback(
+        pulseAudioPointers.context, subscriptionCallback, noCustomUserdata );
+
+    PulseAudioLock lock;
 
     constexpr auto useDefaultServer = nullptr;
     constexpr auto useDefaultSpawnApi = nullptr;
-    pa_context_connect( pulseAudioPointers.context,
-                        useDefaultServer,
-                        PA_CONTEXT_NOFLAGS,
-                        useDefaultSpawnApi );
-    customPulseLoop();
+    if ( pa_context_connect( pulseAudioPointers.context,
+                             useDefaultServer,
+                             PA_CONTEXT_NOFLAGS,
+                             useDefaultSpawnApi )
+             < 0
+         || pa_threaded_mainloop_start( pulseAudioPointers.mainLoop ) < 0 )
+    {
+        LOG( ERROR ) << "Could not connect to PulseAudio: "
+                     << pa_strerror(
+                            pa_context_errno( pulseAudioPointers.context ) );
+        return;
+    }
 
-    pulseAudioData.originalDefaultInputDeviceId
-        = getCurrentDefaultRecordingDeviceId();
+    while ( !pulseAudioData.connected
+            && PA_CONTEXT_IS_GOOD(
+                pa_context_get_state( pulseAudioPointers.context ) ) )
+    {
+        pa_threaded_mainloop_wait( pulseAudioPointers.mainLoop );
+    }
+    if ( !pulseAudioData.connected )
+    {
+        LOG( ERROR ) << "Could not connect to PulseAudio.";
+        dumpPulseAudioState();
+        return;
+    }
+
+    // Subscribing first means no change between the fetch and the
+    // subscription gets lost.
+    const auto mask = static_cast<pa_subscription_mask_t>(
+        PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SOURCE
+        | PA_SUBSCRIPTION_MASK_SERVER );
+    sendOperation( pa_context_subscribe( pulseAudioPointers.context,
+                                         mask,
+                                         successCallback,
+                                         describe( "subscribe" ) ),
+                   "subscribe" );
+
+    auto initialQuery = &pulseAudioData;
+    pulseAudioData.pendingInitialQueries = 3;
+    forgetOperation( pa_context_get_server_info(
+        pulseAudioPointers.context, getDefaultDevicesCallback, initialQuery ) );
+    forgetOperation(
+        pa_context_get_sink_info_list( pulseAudioPointers.context,
+                                       setOutputDevicesCallback,
+                                       initialQuery ) );
+    forgetOperation(
+        pa_context_get_source_info_list( pulseAudioPointers.context,
+                                         setInputDevicesCallback,
+                                         initialQuery ) );
+    while ( pulseAudioData.pendingInitialQueries > 0
+            && pulseAudioData.connected )
+    {
+        pa_threaded_mainloop_wait( pulseAudioPointers.mainLoop );
+    }
 
+    pulseAudioData.originalDefaultInputDeviceId
+        = pulseAudioData.defaultSourceInputDeviceId;
     pulseAudioData.originalDefaultInputDeviceVolume
-        = static_cast<float>( pa_sw_volume_to_linear( pa_cvolume_avg(
-            &pulseAudioData.currentDefaultSourceInfo.volume ) ) );
+        = linearVolume( defaultSource() );
 
     pulseAudioData.originalDefaultOutputDeviceId
-        = getCurrentDefaultPlaybackDeviceId();
-
+        = pulseAudioData.defaultSinkOutputDeviceId;
     pulseAudioData.originalDefaultOutputDeviceVolume
-        = static_cast<float>( pa_sw_volume_to_linear(
-            pa_cvolume_avg( &pulseAudioData.currentDefaultSinkInfo.volume ) ) );
+        = linearVolume( defaultSink() );
 
     LOG( DEBUG ) << "initializePulseAudio finished.";
 }
+
+void shutdownPulseAudio()
+{
+    if ( !pulseAudioPointers.mainLoop )
+    {
+        return;
+    }
+
+    {
+        PulseAudioLock lock;
+        pulseAudioData.onDevicesChanged = nullptr;
+        pulseAudioData.onVolumesChanged = nullptr;
+        pa_context_disconnect( pulseAudioPointers.context );
+    }
+    pa_threaded_mainloop_stop( pulseAudioPointers.mainLoop );
+
+    pa_context_unref( pulseAudioPointers.context );
+    pa_threaded_mainloop_free( pulseAudioPointers.mainLoop );
+    pulseAudioPointers = {};
+    pulseAudioData.connected = false;
+}
 } // namespace advsettings
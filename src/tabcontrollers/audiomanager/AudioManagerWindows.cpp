@@ -14,14 +14,8 @@ AudioManagerWindows::~AudioManagerWindows()
     std::lock_guard<std::recursive_mutex> lock( _mutex );
     audioDeviceEnumerator->UnregisterEndpointNotificationCallback(
         static_cast<IMMNotificationClient*>( this ) );
-    if ( mirrorAudioEndpointVolume )
-    {
-        mirrorAudioEndpointVolume->Release();
-    }
-    if ( micAudioEndpointVolume )
-    {
-        micAudioEndpointVolume->Release();
-    }
+    replaceEndpointVolume( mirrorAudioEndpointVolume, nullptr );
+    replaceEndpointVolume( micAudioEndpointVolume, nullptr );
     if ( mirrorAudioDevice )
     {
         mirrorAudioDevice->Release();
@@ -51,15 +45,17 @@ void AudioManagerWindows::init( AudioTabController* var_controller )
         LOG( WARNING ) << "Could not find a default recording device.";
     }
     micAudioDevice = getDefaultRecordingDevice( audioDeviceEnumerator );
+    // Set first, the volume callback may fire as soon as it is registered.
+    this->controller = var_controller;
     if ( micAudioDevice )
     {
-        micAudioEndpointVolume = getAudioEndpointVolume( micAudioDevice );
+        replaceEndpointVolume( micAudioEndpointVolume,
+                               getAudioEndpointVolume( micAudioDevice ) );
     }
     else
     {
         LOG( WARNING ) << "Could not find a default recording device.";
     }
-    this->controller = var_controller;
     audioDeviceEnumerator->RegisterEndpointNotificationCallback(
         static_cast<IMMNotificationClient*>( this ) );
     policyConfig = getPolicyConfig();
@@ -137,8 +133,9 @@ void AudioManagerWindows::setMirrorDevice( const std::string& id, bool notify )
         if ( dev )
         {
             mirrorAudioDevice = dev;
-            mirrorAudioEndpointVolume
-                = getAudioEndpointVolume( mirrorAudioDevice );
+            replaceEndpointVolume(
+                mirrorAudioEndpointVolume,
+                getAudioEndpointVolume( mirrorAudioDevice ) );
         }
         else
         {
@@ -153,11 +150,7 @@ void AudioManagerWindows::setMirrorDevice( const std::string& id, bool notify )
 
 void AudioManagerWindows::deleteMirrorDevice()
 {
-    if ( mirrorAudioEndpointVolume )
-    {
-        mirrorAudioEndpointVolume->Release();
-        mirrorAudioEndpointVolume = nullptr;
-    }
+    replaceEndpointVolume( mirrorAudioEndpointVolume, nullptr );
     if ( mirrorAudioDevice )
     {
         mirrorAudioDevice->Release();
@@ -245,6 +238,11 @@ bool AudioManagerWindows::setMirrorMuted( bool value )
     return false;
 }
 
+bool AudioManagerWindows::reportsVolumeChanges()
+{
+    return true;
+}
+
 bool AudioManagerWindows::isMicValid()
 {
     return micAudioEndpointVolume != nullptr;
@@ -478,6 +476,26 @@ IAudioEndpointVolume*
     return pEndpointVolume;
 }
 
+// Registers for volume notifications of the new endpoint volume and releases
+// the previous one.
+void AudioManagerWindows::replaceEndpointVolume(
+    IAudioEndpointVolume*& endpointVolume,
+    IAudioEndpointVolume* replacement )
+{
+    if ( endpointVolume )
+    {
+        endpointVolume->UnregisterControlChangeNotify(
+            static_cast<IAudioEndpointVolumeCallback*>( this ) );
+        endpointVolume->Release();
+    }
+    endpointVolume = replacement;
+    if ( endpointVolume )
+    {
+        endpointVolume->RegisterControlChangeNotify(
+            static_cast<IAudioEndpointVolumeCallback*>( this ) );
+    }
+}
+
 std::string AudioManagerWindows::getDeviceName( IMMDevice* device )
 {
     IPropertyStore* pProps = nullptr;
@@ -545,13 +563,19 @@ HRESULT AudioManagerWindows::QueryInterface( REFIID riid, void** ppvObject )
     if ( IID_IUnknown == riid )
     {
         AddRef();
-        *ppvObject = static_cast<IUnknown*>( this );
+        *ppvObject = static_cast<IUnknown*>(
+            static_cast<IMMNotificationClient*>( this ) );
     }
     else if ( __uuidof( IMMNotificationClient ) == riid )
     {
         AddRef();
         *ppvObject = static_cast<IMMNotificationClient*>( this );
     }
+    else if ( __uuidof( IAudioEndpointVolumeCallback ) == riid )
+    {
+        AddRef();
+        *ppvObject = static_cast<IAudioEndpointVolumeCallback*>( this );
+    }
     else
     {
         *ppvObject = nullptr;
@@ -612,8 +636,9 @@ AudioManagerWindows::OnDefaultDeviceChanged( EDataFlow flow,
                 micAudioDevice = device;
                 if ( micAudioDevice )
                 {
-                    micAudioEndpointVolume
-                        = getAudioEndpointVolume( micAudioDevice );
+                    replaceEndpointVolume(
+                        micAudioEndpointVolume,
+                        getAudioEndpointVolume( micAudioDevice ) );
                 }
                 else if ( !pwstrDefaultDeviceId )
                 {
@@ -699,4 +724,14 @@ HRESULT AudioManagerWindows::OnPropertyValueChanged( LPCWSTR,
     return S_OK;
 }
 
+HRESULT AudioManagerWindows::OnNotify( PAUDIO_VOLUME_NOTIFICATION_DATA )
+{
+    // Called on a system thread, the controller only queues a refresh.
+    if ( controller )
+    {
+        controller->onVolumeStateChanged();
+    }
+    return S_OK;
+}
+
 } // namespace advsettings
@@ -11,7 +11,9 @@
 // application namespace
 namespace advsettings
 {
-class AudioManagerWindows : public AudioManager, IMMNotificationClient
+class AudioManagerWindows : public AudioManager,
+                            IMMNotificationClient,
+                            IAudioEndpointVolumeCallback
 {
     friend class AudioNotificationClient;
 
@@ -59,6 +61,8 @@ class AudioManagerWindows : public AudioManager, IMMNotificationClient
     virtual std::vector<AudioDevice> getRecordingDevices() override;
     virtual std::vector<AudioDevice> getPlaybackDevices() override;
 
+    virtual bool reportsVolumeChanges() override;
+
     void deleteMirrorDevice();
 
     // from IMMNotificationClient
@@ -76,6 +80,9 @@ class AudioManagerWindows : public AudioManager, IMMNotificationClient
     virtual HRESULT OnPropertyValueChanged( LPCWSTR pwstrDeviceId,
                                             const PROPERTYKEY key ) override;
 
+    // from IAudioEndpointVolumeCallback
+    virtual HRESULT OnNotify( PAUDIO_VOLUME_NOTIFICATION_DATA data ) override;
+
 private:
     IMMDeviceEnumerator* getAudioDeviceEnumerator();
     IPolicyConfig* getPolicyConfig();
@@ -87,6 +94,8 @@ class AudioManagerWindows : public AudioManager, IMMNotificationClient
                           const std::string& id );
     IMMDevice* getDevice( IMMDeviceEnumerator* deviceEnumerator, LPCWSTR id );
     IAudioEndpointVolume* getAudioEndpointVolume( IMMDevice* device );
+    void replaceEndpointVolume( IAudioEndpointVolume*& endpointVolume,
+                                IAudioEndpointVolume* replacement );
     std::string getDeviceName( IMMDevice* device );
     std::string getDeviceId( IMMDevice* device );
     std::vector<AudioDevice> getDevices( IMMDeviceEnumerator* deviceEnumerator,
@@ -0,0 +1,205 @@
+#include "BindingApplyQueue.h"
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <algorithm>
+#include <utility>
+#include <easylogging++.h>
+#include "../../../third-party/nlhomann/json.hpp"
+
+namespace bindings
+{
+BindingApplyQueue::BindingApplyQueue( const QUrl& server, QObject* parent )
+    : QObject( parent ),
+      m_url( server.resolved( QUrl( "/input/selectconfig.action" ) ) ),
+      // SteamVR's web server ignores requests not coming from its own pages.
+      m_referer( server.resolved( QUrl( "/dashboard/controllerbinding.html" ) )
+                     .toEncoded() )
+{
+    m_sendTimer.setSingleShot( true );
+    m_timeout.setSingleShot( true );
+    m_timeout.setInterval( k_timeoutMs );
+    m_clock.start();
+
+    connect( &m_network,
+             SIGNAL( finished( QNetworkReply* ) ),
+             this,
+             SLOT( onFinished( QNetworkReply* ) ) );
+    connect( &m_sendTimer, SIGNAL( timeout() ), this, SLOT( sendNext() ) );
+    connect( &m_timeout, SIGNAL( timeout() ), this, SLOT( onTimeout() ) );
+}
+
+void BindingApplyQueue::apply( const std::string& appID,
+                               const std::string& controller,
+                               const QString& filePath )
+{
+    enqueue( Request{ appID, controller, filePath, 0, 0 } );
+}
+
+int BindingApplyQueue::pending() const noexcept
+{
+    return static_cast<int>( m_queue.size() ) + ( m_reply != nullptr ? 1 : 0 );
+}
+
+void BindingApplyQueue::sendNext()
+{
+    if ( m_reply != nullptr || m_queue.empty() )
+    {
+        return;
+    }
+    const auto now = m_clock.elapsed();
+    const auto next
+        = std::find_if( m_queue.begin(),
+                        m_queue.end(),
+                        [now]( const Request& request ) {
+                            return request.notBefore <= now;
+                        } );
+    if ( now - m_lastSend < k_minIntervalMs || next == m_queue.end() )
+    {
+        schedule();
+        return;
+    }
+    m_inFlight = std::move( *next );
+    m_queue.erase( next );
+    ++m_inFlight.attempts;
+    m_lastSend = now;
+
+    QNetworkRequest request( m_url );
+    request.setHeader( QNetworkRequest::ContentTypeHeader,
+                       "application/x-www-form-urlencoded" );
+    request.setRawHeader( "Referer", m_referer );
+    const auto fileUrl = QUrl::fromLocalFile( m_inFlight.filePath )
+                             .toEncoded( QUrl::EncodeSpaces
+                                         | QUrl::EncodeReserved );
+    const nlohmann::json body = { { "app_key", m_inFlight.appID },
+                                  { "controller_type", m_inFlight.controller },
+                                  { "url", fileUrl.toStdString() } };
+    LOG( INFO ) << "Attempting to Apply Binding at: " << fileUrl.toStdString();
+    m_reply = m_network.post( request,
+                              QByteArray::fromStdString( body.dump() ) );
+    m_timeout.start();
+}
+
+void BindingApplyQueue::onFinished( QNetworkReply* reply )
+{
+    reply->deleteLater();
+    if ( reply != m_reply )
+    {
+        return;
+    }
+    m_reply = nullptr;
+    m_timeout.stop();
+
+    auto success = false;
+    if ( reply->error() != QNetworkReply::NoError )
+    {
+        LOG( WARNING ) << "Apply Binding request for " << m_inFlight.appID
+                       << " failed: " << reply->errorString();
+    }
+    else
+    {
+        const auto answer = nlohmann::json::parse(
+            reply->readAll().toStdString(), nullptr, false );
+        const auto field = answer.find( "success" );
+        if ( answer.is_discarded() || field == answer.end()
+             || !field->is_boolean() )
+        {
+            LOG( WARNING ) << "Apply Binding Packet Mal-Formed?";
+        }
+        else if ( !field->get<bool>() )
+        {
+            LOG( WARNING ) << "SteamVR did not apply the binding for "
+                           << m_inFlight.appID;
+        }
+        else
+        {
+            success = true;
+        }
+    }
+    finish( success );
+}
+
+void BindingApplyQueue::onTimeout()
+{
+    if ( m_reply != nullptr )
+    {
+        LOG( WARNING ) << "Apply Binding request for " << m_inFlight.appID
+                       << " timed out.";
+        // Finishes the reply with OperationCanceledError.
+        m_reply->abort();
+    }
+}
+
+void BindingApplyQueue::enqueue( Request request )
+{
+    if ( m_reply != nullptr && request == m_inFlight )
+    {
+        return;
+    }
+    const auto queued = std::find_if(
+        m_queue.begin(), m_queue.end(), [&request]( const Request& other ) {
+            return other.sameTarget( request );
+        } );
+    if ( queued != m_queue.end() )
+    {
+        *queued = std::move( request );
+    }
+    else
+    {
+        m_queue.push_back( std::move( request ) );
+    }
+    schedule();
+}
+
+void BindingApplyQueue::schedule()
+{
+    if ( m_reply != nullptr || m_queue.empty() )
+    {
+        return;
+    }
+    auto next = m_lastSend + k_minIntervalMs;
+    const auto earliest = std::min_element(
+        m_queue.begin(),
+        m_queue.end(),
+        []( const Request& left, const Request& right ) {
+            return left.notBefore < right.notBefore;
+        } );
+    next = std::max( next, earliest->notBefore );
+    const auto delay = std::max<qint64>( next - m_clock.elapsed(), 0 );
+    m_sendTimer.start( static_cast<int>( delay ) );
+}
+
+void BindingApplyQueue::finish( const bool success )
+{
+    auto request = std::move( m_inFlight );
+    const auto appID = QString::fromStdString( request.appID );
+    const auto superseded = std::any_of(
+        m_queue.begin(), m_queue.end(), [&request]( const Request& other ) {
+            return other.sameTarget( request );
+        } );
+
+    if ( success )
+    {
+        LOG( INFO ) << "New Binding Applied for " << request.appID;
+        emit applied( appID, true );
+    }
+    else if ( !superseded && request.attempts < k_maxAttempts )
+    {
+        const auto delay = k_retryDelayMs << ( request.attempts - 1 );
+        request.notBefore = m_clock.elapsed() + delay;
+        LOG( INFO ) << "Retrying to apply binding for " << request.appID
+                    << " in " << delay << "ms.";
+        m_queue.push_back( std::move( request ) );
+    }
+    else
+    {
+        if ( !superseded )
+        {
+            LOG( ERROR ) << "Binding Failed To Apply for " << request.appID
+                         << " after " << request.attempts << " attempts.";
+        }
+        emit applied( appID, false );
+    }
+    schedule();
+}
+
+} // namespace bindings
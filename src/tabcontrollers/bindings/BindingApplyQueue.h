@@ -0,0 +1,95 @@
+#pragma once
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+#include <deque>
+#include <string>
+
+class QNetworkReply;
+
+namespace bindings
+{
+/*!
+Sends binding files to SteamVR's selectconfig.action, one request at a time.
+
+- A request replaces a queued one for the same app and controller, and is
+  dropped if it equals the one in flight, so a burst of manifest reloads
+  costs one request per app.
+- Requests are sent at least k_minIntervalMs apart.
+- Failed requests, including ones without an answer after k_timeoutMs, are
+  retried up to k_maxAttempts times, k_retryDelayMs apart and doubling,
+  unless a newer request for the same app and controller came in meanwhile.
+*/
+class BindingApplyQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr auto k_defaultServer = "http://localhost:27062";
+    static constexpr int k_minIntervalMs = 100;
+    static constexpr int k_timeoutMs = 5000;
+    static constexpr int k_maxAttempts = 3;
+    static constexpr int k_retryDelayMs = 250;
+
+    explicit BindingApplyQueue( const QUrl& server = QUrl( k_defaultServer ),
+                                QObject* parent = nullptr );
+
+    // Asks SteamVR to use the binding at filePath for appID with controller.
+    void apply( const std::string& appID,
+                const std::string& controller,
+                const QString& filePath );
+
+    // Requests queued or in flight.
+    [[nodiscard]] int pending() const noexcept;
+
+signals:
+    // After the last attempt of a request.
+    void applied( const QString& appID, bool success );
+
+private slots:
+    void sendNext();
+    void onFinished( QNetworkReply* reply );
+    void onTimeout();
+
+private:
+    struct Request
+    {
+        std::string appID;
+        std::string controller;
+        QString filePath;
+        int attempts = 0;
+        // Not sent before this point of m_clock, for retries.
+        qint64 notBefore = 0;
+
+        [[nodiscard]] bool sameTarget( const Request& other ) const
+        {
+            return appID == other.appID && controller == other.controller;
+        }
+        [[nodiscard]] bool operator==( const Request& other ) const
+        {
+            return sameTarget( other ) && filePath == other.filePath;
+        }
+    };
+
+    void enqueue( Request request );
+    // Starts the send timer for when the next request may go out.
+    void schedule();
+    void finish( const bool success );
+
+    QNetworkAccessManager m_network;
+    QUrl m_url;
+    QByteArray m_referer;
+    std::deque<Request> m_queue;
+    // Valid while m_reply is set.
+    Request m_inFlight;
+    QNetworkReply* m_reply = nullptr;
+    QTimer m_sendTimer;
+    QTimer m_timeout;
+    QElapsedTimer m_clock;
+    qint64 m_lastSend = -k_minIntervalMs;
+};
+
+} // namespace bindings
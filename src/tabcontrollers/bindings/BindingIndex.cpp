@@ -0,0 +1,229 @@
+#include "BindingIndex.h"
+#include <QDir>
+#include <cctype>
+#include <utility>
+#include <easylogging++.h>
+
+namespace bindings
+{
+namespace
+{
+    constexpr std::string_view k_scenePrefix = "ovl";
+    constexpr std::string_view k_defaultPrefix = "defovl";
+    constexpr std::string_view k_scene = "scene";
+    constexpr std::string_view k_controller = "ctrl";
+    constexpr std::string_view k_extension = ".json";
+
+    bool startsWith( const std::string_view text,
+                     const std::string_view prefix ) noexcept
+    {
+        return text.substr( 0, prefix.size() ) == prefix;
+    }
+
+    // Either case, .JSON files have always been picked up too.
+    bool hasExtension( const std::string_view text ) noexcept
+    {
+        if ( text.size() < k_extension.size() )
+        {
+            return false;
+        }
+        const auto extension = text.substr( text.size() - k_extension.size() );
+        for ( std::size_t i = 0; i < extension.size(); ++i )
+        {
+            const auto c = static_cast<unsigned char>( extension[i] );
+            if ( std::tolower( c ) != k_extension[i] )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Splits text around the last separator, false if it has none.
+    bool splitLast( const std::string_view text,
+                    const std::string_view separator,
+                    std::string_view& before,
+                    std::string_view& after ) noexcept
+    {
+        const auto position = text.rfind( separator );
+        if ( position == std::string_view::npos )
+        {
+            return false;
+        }
+        before = text.substr( 0, position );
+        after = text.substr( position + separator.size() );
+        return true;
+    }
+} // namespace
+
+std::optional<BindingKey> parseBindingFileName( std::string_view fileName )
+{
+    if ( !hasExtension( fileName ) )
+    {
+        return std::nullopt;
+    }
+    fileName.remove_suffix( k_extension.size() );
+
+    const auto isDefault = startsWith( fileName, k_defaultPrefix );
+    if ( !isDefault && !startsWith( fileName, k_scenePrefix ) )
+    {
+        return std::nullopt;
+    }
+    fileName.remove_prefix( isDefault ? k_defaultPrefix.size()
+                                      : k_scenePrefix.size() );
+
+    std::string_view app;
+    std::string_view scene;
+    std::string_view controller;
+    if ( !splitLast( fileName, k_controller, app, controller ) )
+    {
+        return std::nullopt;
+    }
+    if ( !isDefault && !splitLast( app, k_scene, app, scene ) )
+    {
+        return std::nullopt;
+    }
+    if ( app.empty() || controller.empty() || ( !isDefault && scene.empty() ) )
+    {
+        return std::nullopt;
+    }
+    return BindingKey{ std::string( app ),
+                       std::string( scene ),
+                       std::string( controller ) };
+}
+
+std::string bindingFileName( const BindingKey& key )
+{
+    std::string fileName;
+    if ( key.sceneAppID.empty() )
+    {
+        fileName.append( k_defaultPrefix ).append( key.appID );
+    }
+    else
+    {
+        fileName.append( k_scenePrefix )
+            .append( key.appID )
+            .append( k_scene )
+            .append( key.sceneAppID );
+    }
+    return fileName.append( k_controller )
+        .append( key.controller )
+        .append( k_extension );
+}
+
+BindingIndex::BindingIndex( QObject* parent ) : QObject( parent )
+{
+    m_debounce.setSingleShot( true );
+    m_debounce.setInterval( k_debounceMs );
+
+    connect( &m_watcher,
+             SIGNAL( directoryChanged( QString ) ),
+             this,
+             SLOT( OnDirectoryChanged() ) );
+    connect( &m_debounce, SIGNAL( timeout() ), this, SLOT( rescan() ) );
+}
+
+void BindingIndex::watch( const QString& directory )
+{
+    if ( !m_directory.isEmpty() )
+    {
+        m_watcher.removePath( m_directory );
+    }
+    m_directory = directory;
+    if ( !m_watcher.addPath( directory ) )
+    {
+        LOG( WARNING ) << "Could not watch binding directory '" << directory
+                       << "', new binding files won't be picked up.";
+    }
+    rescan();
+}
+
+void BindingIndex::insert( const std::string& fileName )
+{
+    const auto key = parseBindingFileName( fileName );
+    if ( !key.has_value() )
+    {
+        return;
+    }
+    const auto [file, added] = m_files.emplace( *key, fileName );
+    if ( added || file->second != fileName )
+    {
+        file->second = fileName;
+        emit changed();
+    }
+}
+
+bool BindingIndex::contains( const BindingKey& key ) const
+{
+    return m_files.count( key ) > 0;
+}
+
+std::optional<std::string>
+    BindingIndex::find( const std::string& appID,
+                        const std::string& sceneAppID,
+                        const std::string& controller ) const
+{
+    auto file = m_files.find( BindingKey{ appID, sceneAppID, controller } );
+    if ( file == m_files.end() )
+    {
+        file = m_files.find( BindingKey{ appID, "", controller } );
+    }
+    if ( file == m_files.end() )
+    {
+        return std::nullopt;
+    }
+    return file->second;
+}
+
+std::vector<std::string> BindingIndex::appIDs() const
+{
+    std::vector<std::string> apps;
+    for ( const auto& file : m_files )
+    {
+        // Sorted by app first, so each app's files are next to each other.
+        if ( apps.empty() || apps.back() != file.first.appID )
+        {
+            apps.push_back( file.first.appID );
+        }
+    }
+    return apps;
+}
+
+QString BindingIndex::filePath( const std::string& fileName ) const
+{
+    return m_directory + "/" + QString::fromStdString( fileName );
+}
+
+std::size_t BindingIndex::size() const noexcept
+{
+    return m_files.size();
+}
+
+void BindingIndex::OnDirectoryChanged()
+{
+    m_debounce.start();
+}
+
+void BindingIndex::rescan()
+{
+    std::map<BindingKey, std::string> files;
+    const auto names = QDir( m_directory ).entryList( QDir::Files );
+    for ( const auto& name : names )
+    {
+        auto fileName = name.toStdString();
+        if ( const auto key = parseBindingFileName( fileName ) )
+        {
+            files.emplace( *key, std::move( fileName ) );
+        }
+    }
+    if ( files == m_files )
+    {
+        return;
+    }
+    m_files = std::move( files );
+    LOG( INFO ) << "Found " << m_files.size() << " binding files in '"
+                << m_directory << "'.";
+    emit changed();
+}
+
+} // namespace bindings
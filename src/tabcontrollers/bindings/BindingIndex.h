@@ -0,0 +1,94 @@
+#pragma once
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace bindings
+{
+/*!
+What a per-app binding file is for. An empty sceneAppID stands for the
+app's default binding, used in scenes without one of their own.
+*/
+struct BindingKey
+{
+    std::string appID;
+    std::string sceneAppID;
+    std::string controller;
+
+    bool operator==( const BindingKey& other ) const
+    {
+        return std::tie( appID, sceneAppID, controller )
+               == std::tie( other.appID, other.sceneAppID, other.controller );
+    }
+    bool operator<( const BindingKey& other ) const
+    {
+        return std::tie( appID, sceneAppID, controller )
+               < std::tie( other.appID, other.sceneAppID, other.controller );
+    }
+};
+
+/*!
+Parses "ovl<app>scene<scene>ctrl<controller>.json" and
+"defovl<app>ctrl<controller>.json". Anything else isn't a binding file.
+*/
+std::optional<BindingKey> parseBindingFileName( std::string_view fileName );
+// The inverse of parseBindingFileName().
+std::string bindingFileName( const BindingKey& key );
+
+/*!
+The binding files in a directory, by what they are for.
+
+The directory is listed once by watch() and then again after changes to it,
+collected for k_debounceMs since files are usually written in several
+steps. Lookups never touch the file system.
+*/
+class BindingIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int k_debounceMs = 250;
+
+    explicit BindingIndex( QObject* parent = nullptr );
+
+    void watch( const QString& directory );
+    // Adds a file right away, without waiting for the watcher to see it.
+    void insert( const std::string& fileName );
+
+    [[nodiscard]] bool contains( const BindingKey& key ) const;
+    /*!
+    The file to apply for appID in sceneAppID with controller: the scene's
+    own binding if there is one, else the app's default. Empty if there is
+    neither.
+    */
+    [[nodiscard]] std::optional<std::string>
+        find( const std::string& appID,
+              const std::string& sceneAppID,
+              const std::string& controller ) const;
+    // Every app with a binding file, sorted.
+    [[nodiscard]] std::vector<std::string> appIDs() const;
+    [[nodiscard]] QString filePath( const std::string& fileName ) const;
+    [[nodiscard]] std::size_t size() const noexcept;
+
+signals:
+    void changed();
+
+private slots:
+    void OnDirectoryChanged();
+    void rescan();
+
+private:
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounce;
+    QString m_directory;
+    std::map<BindingKey, std::string> m_files;
+};
+
+} // namespace bindings
@@ -0,0 +1,174 @@
+#include "NowPlayingOverlay.h"
+#include <string>
+#include "NowPlayingView.h"
+#include "../../media_keys/media_keys.h"
+#include "../../openvr/ovr_overlay_wrapper.h"
+#include "../../overlaycontroller.h"
+
+namespace advsettings
+{
+namespace
+{
+    constexpr auto k_overlayKeySuffix = ".nowplaying";
+    constexpr float k_widthInMeters = 0.24f;
+    constexpr int k_visibleMs = 5000;
+    // Often enough for the shown second to never lag far behind, the image
+    // is only redrawn when it actually changed.
+    constexpr int k_positionIntervalMs = 500;
+
+    // Half a meter ahead of and a bit below the user's view, tilted up
+    // towards them.
+    const vr::HmdMatrix34_t k_transform
+        = { { { 1.0f, 0.0f, 0.0f, 0.0f },
+              { 0.0f, 0.966f, 0.259f, -0.14f },
+              { 0.0f, -0.259f, 0.966f, -0.5f } } };
+} // namespace
+
+NowPlayingOverlay::NowPlayingOverlay( QObject* parent ) : QObject( parent )
+{
+    m_positionTimer.setInterval( k_positionIntervalMs );
+    m_hideTimer.setSingleShot( true );
+    m_hideTimer.setInterval( k_visibleMs );
+    connect( &m_positionTimer,
+             SIGNAL( timeout() ),
+             this,
+             SLOT( onPositionTimer() ) );
+    connect( &m_hideTimer, SIGNAL( timeout() ), this, SLOT( hide() ) );
+}
+
+// OpenVR may already be shut down here, the overlay goes with the process.
+NowPlayingOverlay::~NowPlayingOverlay() = default;
+
+void NowPlayingOverlay::setEnabled( const bool enabled )
+{
+    if ( enabled == this->enabled() )
+    {
+        return;
+    }
+    if ( !enabled )
+    {
+        destroyOverlay();
+        return;
+    }
+
+    if ( !m_connected )
+    {
+        m_connected = keyboardinput::connectNowPlaying(
+            this, SLOT( onNowPlayingChanged() ) );
+        if ( !m_connected )
+        {
+            LOG( WARNING ) << "Now playing overlay: Can't tell what media "
+                              "is playing on this platform.";
+            return;
+        }
+    }
+    if ( createOverlay() )
+    {
+        m_track = keyboardinput::nowPlaying();
+    }
+}
+
+bool NowPlayingOverlay::enabled() const noexcept
+{
+    return m_handle != vr::k_ulOverlayHandleInvalid;
+}
+
+void NowPlayingOverlay::onNowPlayingChanged()
+{
+    if ( !enabled() )
+    {
+        return;
+    }
+    m_track = keyboardinput::nowPlaying();
+    if ( m_track.empty() )
+    {
+        hide();
+        return;
+    }
+    show();
+}
+
+void NowPlayingOverlay::onPositionTimer()
+{
+    render();
+}
+
+void NowPlayingOverlay::hide()
+{
+    m_positionTimer.stop();
+    m_hideTimer.stop();
+    if ( m_visible )
+    {
+        ovr_overlay_wrapper::hideOverlay( m_handle );
+        m_visible = false;
+    }
+}
+
+bool NowPlayingOverlay::createOverlay()
+{
+    const auto key = std::string( application_strings::applicationKey )
+                     + k_overlayKeySuffix;
+    if ( ovr_overlay_wrapper::createOverlay( key, key, &m_handle )
+         != ovr_overlay_wrapper::OverlayError::NoError )
+    {
+        m_handle = vr::k_ulOverlayHandleInvalid;
+        return false;
+    }
+    ovr_overlay_wrapper::setOverlayWidthInMeters( m_handle, k_widthInMeters );
+    ovr_overlay_wrapper::setOverlayTransformTrackedDeviceRelative(
+        m_handle, vr::k_unTrackedDeviceIndex_Hmd, &k_transform );
+    m_view = std::make_unique<NowPlayingView>();
+    LOG( INFO ) << "Created now playing overlay.";
+    return true;
+}
+
+void NowPlayingOverlay::destroyOverlay()
+{
+    hide();
+    const auto error = vr::VROverlay()->DestroyOverlay( m_handle );
+    if ( error != vr::VROverlayError_None )
+    {
+        LOG( ERROR ) << "Could not destroy now playing overlay: "
+                     << vr::VROverlay()->GetOverlayErrorNameFromEnum( error );
+    }
+    m_handle = vr::k_ulOverlayHandleInvalid;
+    m_view.reset();
+}
+
+void NowPlayingOverlay::show()
+{
+    // The image has to be there before the overlay is.
+    render();
+    if ( !m_visible )
+    {
+        ovr_overlay_wrapper::showOverlay( m_handle );
+        m_visible = true;
+    }
+    m_hideTimer.start();
+    if ( m_track.playing )
+    {
+        m_positionTimer.start();
+    }
+    else
+    {
+        m_positionTimer.stop();
+    }
+}
+
+void NowPlayingOverlay::render()
+{
+    if ( !m_view->update( m_track, keyboardinput::NowPlaying::Clock::now() ) )
+    {
+        return;
+    }
+    const auto& image = m_view->image();
+    // OpenVR only reads the buffer, it copies it into its own texture.
+    ovr_overlay_wrapper::setOverlayRaw(
+        m_handle,
+        const_cast<uchar*>( image.constBits() ),
+        static_cast<uint32_t>( image.width() ),
+        static_cast<uint32_t>( image.height() ),
+        4 );
+}
+
+} // namespace advsettings
@@ -0,0 +1,54 @@
+#pragma once
+#include <QObject>
+#include <QTimer>
+#include <memory>
+#include <openvr.h>
+#include "../../media_keys/now_playing.h"
+
+namespace advsettings
+{
+class NowPlayingView;
+
+/*!
+A small overlay below the user's view showing what the media player is
+playing.
+
+It shows up for a few seconds whenever the track, the playback status or
+the position changes, as reported by the media player. Nothing is polled:
+while it's hidden it does no work at all, and while it's visible and playing
+the image is only redrawn and uploaded when the shown position changes.
+*/
+class NowPlayingOverlay : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit NowPlayingOverlay( QObject* parent = nullptr );
+    ~NowPlayingOverlay() override;
+
+    // Creates or destroys the overlay. Needs OpenVR to be initialized.
+    void setEnabled( const bool enabled );
+    [[nodiscard]] bool enabled() const noexcept;
+
+private slots:
+    void onNowPlayingChanged();
+    void onPositionTimer();
+    void hide();
+
+private:
+    bool createOverlay();
+    void destroyOverlay();
+    void show();
+    void render();
+
+    vr::VROverlayHandle_t m_handle = vr::k_ulOverlayHandleInvalid;
+    // Created with the overlay, its fonts need the application to exist.
+    std::unique_ptr<NowPlayingView> m_view;
+    keyboardinput::NowPlaying m_track;
+    QTimer m_positionTimer;
+    QTimer m_hideTimer;
+    bool m_connected = false;
+    bool m_visible = false;
+};
+
+} // namespace advsettings
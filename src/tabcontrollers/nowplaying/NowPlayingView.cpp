@@ -0,0 +1,128 @@
+#include "NowPlayingView.h"
+#include <algorithm>
+#include <utility>
+#include <QPainter>
+
+namespace advsettings
+{
+namespace
+{
+    constexpr int k_margin = 16;
+    constexpr int k_textWidth = NowPlayingView::k_width - 2 * k_margin;
+    // Between the artist and the time next to it.
+    constexpr int k_gap = 12;
+    constexpr int k_barHeight = 6;
+    constexpr qint64 k_microsecondsPerSecond = 1000000;
+
+    const QColor k_background( 30, 33, 39, 220 );
+    const QColor k_titleColor( 255, 255, 255 );
+    const QColor k_detailColor( 176, 180, 188 );
+    const QColor k_barBackground( 70, 74, 82 );
+    const QColor k_barColor( 76, 156, 232 );
+
+    QFont textFont( const int pixelSize, const bool bold )
+    {
+        QFont font;
+        font.setPixelSize( pixelSize );
+        font.setBold( bold );
+        return font;
+    }
+} // namespace
+
+QString formatPlaybackTime( const qint64 microseconds )
+{
+    const auto seconds
+        = std::max<qint64>( microseconds, 0 ) / k_microsecondsPerSecond;
+    const auto hours = seconds / 3600;
+    const auto minutes = seconds / 60 % 60;
+    const QChar zero( '0' );
+    if ( hours > 0 )
+    {
+        return QString( "%1:%2:%3" )
+            .arg( hours )
+            .arg( minutes, 2, 10, zero )
+            .arg( seconds % 60, 2, 10, zero );
+    }
+    return QString( "%1:%2" ).arg( minutes ).arg( seconds % 60, 2, 10, zero );
+}
+
+NowPlayingView::NowPlayingView()
+    : m_titleText( textFont( 28, true ), k_titleColor ),
+      m_detailText( textFont( 22, false ), k_detailColor ),
+      m_image( k_width, k_height, QImage::Format_RGBA8888 )
+{
+}
+
+bool NowPlayingView::update(
+    const keyboardinput::NowPlaying& track,
+    const keyboardinput::NowPlaying::Clock::time_point now )
+{
+    const auto position = track.positionAt( now );
+
+    Shown shown;
+    shown.title = track.title;
+    shown.artist = track.artist;
+    shown.time = formatPlaybackTime( position );
+    if ( track.length > 0 )
+    {
+        shown.time += " / " + formatPlaybackTime( track.length );
+        shown.progress = static_cast<int>( k_textWidth * position
+                                           / track.length );
+    }
+    if ( !track.playing )
+    {
+        shown.time = "Paused  " + shown.time;
+    }
+
+    if ( m_drawn && shown == m_shown )
+    {
+        return false;
+    }
+    m_shown = std::move( shown );
+    draw();
+    m_drawn = true;
+    return true;
+}
+
+const QImage& NowPlayingView::image() const noexcept
+{
+    return m_image;
+}
+
+int NowPlayingView::rasterizedCount() const noexcept
+{
+    return m_titleText.rasterizedCount() + m_detailText.rasterizedCount();
+}
+
+void NowPlayingView::draw()
+{
+    m_image.fill( Qt::transparent );
+    QPainter painter( &m_image );
+    painter.setRenderHint( QPainter::Antialiasing );
+    painter.setPen( Qt::NoPen );
+    painter.setBrush( k_background );
+    painter.drawRoundedRect( m_image.rect(), 12, 12 );
+
+    auto y = k_margin;
+    m_titleText.draw( painter, { k_margin, y }, m_shown.title, k_textWidth );
+    y += m_titleText.lineHeight();
+
+    const auto timeWidth = m_detailText.width( m_shown.time );
+    m_detailText.draw( painter,
+                       { k_margin, y },
+                       m_shown.artist,
+                       k_textWidth - timeWidth - k_gap );
+    m_detailText.draw( painter,
+                       { k_margin + k_textWidth - timeWidth, y },
+                       m_shown.time,
+                       timeWidth );
+
+    const auto barTop = k_height - k_margin - k_barHeight;
+    painter.setRenderHint( QPainter::Antialiasing, false );
+    painter.setBrush( k_barBackground );
+    painter.drawRect( k_margin, barTop, k_textWidth, k_barHeight );
+    painter.setBrush( k_barColor );
+    painter.drawRect( k_margin, barTop, m_shown.progress, k_barHeight );
+}
+
+} // namespace advsettings
@@ -0,0 +1,65 @@
+#pragma once
+#include <QImage>
+#include <QString>
+#include "../../media_keys/now_playing.h"
+#include "../../utils/GlyphAtlas.h"
+
+namespace advsettings
+{
+// "m:ss", or "h:mm:ss" from an hour on.
+QString formatPlaybackTime( const qint64 microseconds );
+
+/*!
+The image of the now playing overlay: title, artist, position and a progress
+bar.
+
+The image is only redrawn when something it shows changed, which for the
+position means once a second at most.
+*/
+class NowPlayingView
+{
+public:
+    static constexpr int k_width = 512;
+    static constexpr int k_height = 128;
+
+    NowPlayingView();
+
+    /*!
+    Redraws the image if what it shows of track at now differs from what it
+    shows already. Returns true if it was redrawn.
+    */
+    bool update( const keyboardinput::NowPlaying& track,
+                 const keyboardinput::NowPlaying::Clock::time_point now );
+
+    // RGBA, k_width by k_height.
+    [[nodiscard]] const QImage& image() const noexcept;
+
+    // Glyphs rasterized so far by both fonts.
+    [[nodiscard]] int rasterizedCount() const noexcept;
+
+private:
+    struct Shown
+    {
+        QString title;
+        QString artist;
+        QString time;
+        // Width of the progress bar's filled part.
+        int progress = 0;
+
+        bool operator==( const Shown& other ) const
+        {
+            return title == other.title && artist == other.artist
+                   && time == other.time && progress == other.progress;
+        }
+    };
+
+    void draw();
+
+    GlyphAtlas m_titleText;
+    GlyphAtlas m_detailText;
+    QImage m_image;
+    Shown m_shown;
+    bool m_drawn = false;
+};
+
+} // namespace advsettings
@@ -0,0 +1,298 @@
+#include "FrameTimings.h"
+#include <algorithm>
+#include <cmath>
+
+namespace statistics
+{
+namespace
+{
+    // Frames before the running mean is trusted for spike detection.
+    constexpr uint32_t k_spikeWarmupFrames = 45;
+    constexpr double k_meanWeight = 1.0 / 32.0;
+    constexpr double k_spikeSigmas = 4.0;
+    // A spike must also be this much above the mean, both relative and
+    // absolute, so a perfectly steady frame time doesn't flag noise.
+    constexpr double k_spikeMinRelative = 0.25;
+    constexpr double k_spikeMinAbsoluteMs = 1.0;
+    constexpr float k_fallbackFrameIntervalMs = 11.1f;
+    // Headroom on the expected frame count for frame rate changes and
+    // polls that come late.
+    constexpr double k_batchHeadroom = 1.5;
+
+    FrameTimingSample toSample( const vr::Compositor_FrameTiming& t ) noexcept
+    {
+        FrameTimingSample s;
+        s.frameIndex = t.m_nFrameIndex;
+        s.systemTimeSeconds = t.m_flSystemTimeInSeconds;
+        s.appGpuMs = t.m_flPreSubmitGpuMs + t.m_flPostSubmitGpuMs;
+        s.totalGpuMs = t.m_flTotalRenderGpuMs;
+        s.compositorGpuMs = t.m_flCompositorRenderGpuMs;
+        s.compositorCpuMs = t.m_flCompositorRenderCpuMs;
+        s.clientFrameIntervalMs = t.m_flClientFrameIntervalMs;
+        s.presents = t.m_nNumFramePresents;
+        s.mispresented = t.m_nNumMisPresented;
+        s.dropped = t.m_nNumDroppedFrames;
+        s.reprojectionFlags = t.m_nReprojectionFlags;
+        return s;
+    }
+
+    float toMs( const FrameTimingCollector::Clock::duration d ) noexcept
+    {
+        return std::chrono::duration<float, std::milli>( d ).count();
+    }
+} // namespace
+
+void FrameTimingCollector::eventLoopTick( vr::IVRCompositor* compositor,
+                                          const Clock::time_point now ) noexcept
+{
+    if ( compositor == nullptr )
+    {
+        return;
+    }
+    if ( m_havePolled && now - m_lastPoll < k_frameTimingPollInterval )
+    {
+        return;
+    }
+    const auto wanted = framesSince( now );
+    m_havePolled = true;
+    m_lastPoll = now;
+
+    // Only the first entry's size needs to be set.
+    m_batch[0].m_nSize = sizeof( vr::Compositor_FrameTiming );
+    const auto count = compositor->GetFrameTimings( m_batch.data(), wanted );
+    ingest( m_batch.data(), count, now );
+}
+
+uint32_t FrameTimingCollector::framesSince(
+    const Clock::time_point now ) const noexcept
+{
+    if ( !m_havePolled )
+    {
+        return k_frameTimingBatchSize;
+    }
+    const auto seconds
+        = std::chrono::duration<double>( now - m_lastPoll ).count();
+    // One more for the newest frame, which ingest() leaves for next time.
+    const auto expected
+        = std::ceil( seconds * m_frameRateHz * k_batchHeadroom ) + 2.0;
+    return static_cast<uint32_t>(
+        std::min( expected, static_cast<double>( k_frameTimingBatchSize ) ) );
+}
+
+void FrameTimingCollector::ingest( const vr::Compositor_FrameTiming* timings,
+                                   const uint32_t count,
+                                   const Clock::time_point fetchTime ) noexcept
+{
+    // The newest frame may still be presented again, so it is left for the
+    // next batch and only serves as the time reference.
+    if ( timings == nullptr || count < 2 )
+    {
+        return;
+    }
+    const auto newestSystemTime = timings[count - 1].m_flSystemTimeInSeconds;
+    const auto span = newestSystemTime - timings[0].m_flSystemTimeInSeconds;
+    if ( span > 0.0 )
+    {
+        m_frameRateHz = ( count - 1 ) / span;
+    }
+
+    for ( uint32_t i = 0; i + 1 < count; ++i )
+    {
+        const auto& timing = timings[i];
+        if ( m_haveLastFrame )
+        {
+            const auto delta = static_cast<int32_t>( timing.m_nFrameIndex
+                                                     - m_lastFrameIndex );
+            if ( delta <= 0 )
+            {
+                continue;
+            }
+            m_missedFrames += static_cast<uint32_t>( delta - 1 );
+        }
+        m_haveLastFrame = true;
+        m_lastFrameIndex = timing.m_nFrameIndex;
+
+        const auto age = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>( newestSystemTime
+                                           - timing.m_flSystemTimeInSeconds ) );
+        addFrame( toSample( timing ), fetchTime - age );
+    }
+}
+
+void FrameTimingCollector::addFrame( const FrameTimingSample& frame,
+                                     const Clock::time_point frameEnd ) noexcept
+{
+    m_frames[m_nextFrame] = frame;
+    m_nextFrame = ( m_nextFrame + 1 ) % k_frameTimingHistory;
+    m_frameCount = std::min( m_frameCount + 1, k_frameTimingHistory );
+    ++m_totalFrames;
+
+    // Spike detection //
+    const auto value = static_cast<double>( frame.totalGpuMs );
+    const auto sigma = std::sqrt( m_variance );
+    if ( m_warmupFrames >= k_spikeWarmupFrames )
+    {
+        const auto threshold
+            = m_mean
+              + std::max( { k_spikeSigmas * sigma,
+                            k_spikeMinRelative * m_mean,
+                            k_spikeMinAbsoluteMs } );
+        if ( value > threshold )
+        {
+            const auto interval = frame.clientFrameIntervalMs > 0.0f
+                                      ? frame.clientFrameIntervalMs
+                                      : k_fallbackFrameIntervalMs;
+            const auto frameStart
+                = frameEnd
+                  - std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<float, std::milli>( interval ) );
+
+            auto& spike = m_spikes[m_nextSpike];
+            spike.frameIndex = frame.frameIndex;
+            spike.systemTimeSeconds = frame.systemTimeSeconds;
+            spike.totalGpuMs = frame.totalGpuMs;
+            spike.compositorCpuMs = frame.compositorCpuMs;
+            spike.clientFrameIntervalMs = frame.clientFrameIntervalMs;
+            spike.baselineMs = static_cast<float>( m_mean );
+            spike.overlayTickMs = longestOverlayTick( frameStart, frameEnd );
+            spike.reprojected = frame.reprojected();
+            m_nextSpike = ( m_nextSpike + 1 ) % k_spikeHistory;
+            ++m_spikeCount;
+        }
+    }
+    else
+    {
+        ++m_warmupFrames;
+    }
+
+    // Clamp outliers so a single spike doesn't drag the baseline up.
+    const auto clamped
+        = m_warmupFrames >= k_spikeWarmupFrames
+              ? std::min( value, m_mean + k_spikeSigmas * sigma + 1.0 )
+              : value;
+    const auto diff = clamped - m_mean;
+    m_mean += k_meanWeight * diff;
+    m_variance = ( 1.0 - k_meanWeight ) * ( m_variance + k_meanWeight * diff
+                                                             * diff );
+
+    // Reprojection streaks //
+    if ( frame.reprojected() )
+    {
+        ++m_streak;
+        if ( m_streak == k_minReprojectionStreak )
+        {
+            ++m_streaks;
+        }
+        m_longestStreak = std::max( m_longestStreak, m_streak );
+    }
+    else
+    {
+        m_streak = 0;
+    }
+}
+
+void FrameTimingCollector::noteOverlayTick(
+    const Clock::time_point start,
+    const Clock::duration duration ) noexcept
+{
+    m_overlayTicks[m_nextOverlayTick] = { start, duration };
+    m_nextOverlayTick = ( m_nextOverlayTick + 1 ) % k_overlayTickHistory;
+}
+
+float FrameTimingCollector::longestOverlayTick(
+    const Clock::time_point from,
+    const Clock::time_point to ) const noexcept
+{
+    Clock::duration longest{};
+    for ( const auto& tick : m_overlayTicks )
+    {
+        if ( tick.duration > longest && tick.start < to
+             && tick.start + tick.duration > from )
+        {
+            longest = tick.duration;
+        }
+    }
+    return toMs( longest );
+}
+
+void FrameTimingCollector::reset() noexcept
+{
+    m_havePolled = false;
+    m_frameRateHz = k_defaultFrameRateHz;
+    m_nextFrame = 0;
+    m_frameCount = 0;
+    m_totalFrames = 0;
+    m_haveLastFrame = false;
+    m_lastFrameIndex = 0;
+    m_missedFrames = 0;
+    m_nextSpike = 0;
+    m_spikeCount = 0;
+    m_mean = 0.0;
+    m_variance = 0.0;
+    m_warmupFrames = 0;
+    m_streak = 0;
+    m_streaks = 0;
+    m_longestStreak = 0;
+}
+
+std::size_t FrameTimingCollector::size() const noexcept
+{
+    return m_frameCount;
+}
+
+const FrameTimingSample&
+    FrameTimingCollector::framesAgo( const std::size_t age ) const noexcept
+{
+    return m_frames[( m_nextFrame + k_frameTimingHistory - 1
+                      - age % k_frameTimingHistory )
+                    % k_frameTimingHistory];
+}
+
+uint64_t FrameTimingCollector::totalFrames() const noexcept
+{
+    return m_totalFrames;
+}
+
+std::size_t FrameTimingCollector::spikeCount() const noexcept
+{
+    return m_spikeCount;
+}
+
+const FrameTimingSpike&
+    FrameTimingCollector::spikesAgo( const std::size_t age ) const noexcept
+{
+    return m_spikes[( m_nextSpike + k_spikeHistory - 1 - age % k_spikeHistory )
+                    % k_spikeHistory];
+}
+
+std::size_t FrameTimingCollector::storedSpikes() const noexcept
+{
+    return std::min( m_spikeCount, k_spikeHistory );
+}
+
+uint32_t FrameTimingCollector::reprojectionStreaks() const noexcept
+{
+    return m_streaks;
+}
+
+uint32_t FrameTimingCollector::longestReprojectionStreak() const noexcept
+{
+    return m_longestStreak;
+}
+
+uint32_t FrameTimingCollector::currentReprojectionStreak() const noexcept
+{
+    return m_streak;
+}
+
+uint32_t FrameTimingCollector::missedFrames() const noexcept
+{
+    return m_missedFrames;
+}
+
+float FrameTimingCollector::averageGpuMs() const noexcept
+{
+    return static_cast<float>( m_mean );
+}
+
+} // namespace statistics
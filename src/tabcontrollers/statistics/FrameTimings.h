@@ -0,0 +1,159 @@
+#pragma once
+#include <openvr.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace statistics
+{
+// Most frames fetched per GetFrameTimings call.
+constexpr uint32_t k_frameTimingBatchSize = 256;
+// Least time between two GetFrameTimings calls. The event loop tick rate is
+// user configurable, so polls are timed instead of counted in ticks.
+constexpr std::chrono::milliseconds k_frameTimingPollInterval{ 100 };
+// Assumed until the first batch shows the actual frame rate.
+constexpr double k_defaultFrameRateHz = 144.0;
+constexpr std::size_t k_frameTimingHistory = 1024;
+constexpr std::size_t k_spikeHistory = 64;
+constexpr std::size_t k_overlayTickHistory = 256;
+// Reprojected frames in a row before they are reported as a streak.
+constexpr uint32_t k_minReprojectionStreak = 3;
+
+struct FrameTimingSample
+{
+    uint32_t frameIndex = 0;
+    double systemTimeSeconds = 0.0;
+    // GPU time of the application (pre + post submit).
+    float appGpuMs = 0.0f;
+    float totalGpuMs = 0.0f;
+    float compositorGpuMs = 0.0f;
+    float compositorCpuMs = 0.0f;
+    float clientFrameIntervalMs = 0.0f;
+    uint32_t presents = 0;
+    uint32_t mispresented = 0;
+    uint32_t dropped = 0;
+    uint32_t reprojectionFlags = 0;
+
+    [[nodiscard]] bool reprojected() const noexcept
+    {
+        return ( reprojectionFlags
+                 & ( vr::VRCompositor_ReprojectionReason_Cpu
+                     | vr::VRCompositor_ReprojectionReason_Gpu ) )
+               != 0;
+    }
+};
+
+struct FrameTimingSpike
+{
+    uint32_t frameIndex = 0;
+    double systemTimeSeconds = 0.0;
+    float totalGpuMs = 0.0f;
+    float compositorCpuMs = 0.0f;
+    float clientFrameIntervalMs = 0.0f;
+    // Running average of totalGpuMs before the spike.
+    float baselineMs = 0.0f;
+    // Longest overlay event loop tick that overlapped the frame. Lets the
+    // user tell spikes caused by this overlay from ones caused elsewhere.
+    float overlayTickMs = 0.0f;
+    bool reprojected = false;
+};
+
+/*!
+Collects per-frame compositor timings with GetFrameTimings.
+
+Instead of one GetFrameTiming IPC per frame, the collector asks for the
+frames rendered since its last poll, at most every k_frameTimingPollInterval,
+and keeps the ones it hasn't seen yet. The batch is sized from the time since
+the last poll and the frame rate seen in earlier batches, so neither a slow
+tick rate nor a high refresh rate skips frames. Each new frame is checked
+against a running mean/variance of its GPU time to flag spikes, and
+consecutive reprojected frames are folded into streaks.
+*/
+class FrameTimingCollector
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Called once per event loop tick, polls the compositor when due.
+    void eventLoopTick( vr::IVRCompositor* compositor,
+                        const Clock::time_point now ) noexcept;
+
+    // Adds a batch as returned by GetFrameTimings (oldest first). The newest
+    // frame is assumed to have been rendered at fetchTime, which is used to
+    // map compositor time onto overlay tick times.
+    void ingest( const vr::Compositor_FrameTiming* timings,
+                 const uint32_t count,
+                 const Clock::time_point fetchTime ) noexcept;
+
+    void noteOverlayTick( const Clock::time_point start,
+                          const Clock::duration duration ) noexcept;
+
+    void reset() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    // Frames added since the last reset, including ones no longer stored.
+    [[nodiscard]] uint64_t totalFrames() const noexcept;
+    // 0 is the most recent frame.
+    [[nodiscard]] const FrameTimingSample&
+        framesAgo( const std::size_t age ) const noexcept;
+
+    [[nodiscard]] std::size_t spikeCount() const noexcept;
+    // 0 is the most recent spike, only the last k_spikeHistory are kept.
+    [[nodiscard]] const FrameTimingSpike&
+        spikesAgo( const std::size_t age ) const noexcept;
+    [[nodiscard]] std::size_t storedSpikes() const noexcept;
+
+    [[nodiscard]] uint32_t reprojectionStreaks() const noexcept;
+    [[nodiscard]] uint32_t longestReprojectionStreak() const noexcept;
+    [[nodiscard]] uint32_t currentReprojectionStreak() const noexcept;
+    [[nodiscard]] uint32_t missedFrames() const noexcept;
+
+    [[nodiscard]] float averageGpuMs() const noexcept;
+
+private:
+    void addFrame( const FrameTimingSample& frame,
+                   const Clock::time_point frameEnd ) noexcept;
+    [[nodiscard]] float
+        longestOverlayTick( const Clock::time_point from,
+                            const Clock::time_point to ) const noexcept;
+
+    struct OverlayTick
+    {
+        Clock::time_point start{};
+        Clock::duration duration{};
+    };
+
+    [[nodiscard]] uint32_t
+        framesSince( const Clock::time_point now ) const noexcept;
+
+    bool m_havePolled = false;
+    Clock::time_point m_lastPoll{};
+    double m_frameRateHz = k_defaultFrameRateHz;
+    std::array<vr::Compositor_FrameTiming, k_frameTimingBatchSize> m_batch{};
+
+    std::array<FrameTimingSample, k_frameTimingHistory> m_frames{};
+    std::size_t m_nextFrame = 0;
+    std::size_t m_frameCount = 0;
+    uint64_t m_totalFrames = 0;
+    bool m_haveLastFrame = false;
+    uint32_t m_lastFrameIndex = 0;
+    uint32_t m_missedFrames = 0;
+
+    std::array<FrameTimingSpike, k_spikeHistory> m_spikes{};
+    std::size_t m_nextSpike = 0;
+    std::size_t m_spikeCount = 0;
+
+    std::array<OverlayTick, k_overlayTickHistory> m_overlayTicks{};
+    std::size_t m_nextOverlayTick = 0;
+
+    // Exponentially weighted mean and variance of totalGpuMs.
+    double m_mean = 0.0;
+    double m_variance = 0.0;
+    uint32_t m_warmupFrames = 0;
+
+    uint32_t m_streak = 0;
+    uint32_t m_streaks = 0;
+    uint32_t m_longestStreak = 0;
+};
+
+} // namespace statistics
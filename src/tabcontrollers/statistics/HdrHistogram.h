@@ -0,0 +1,159 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace statistics
+{
+/*!
+Fixed size log-linear histogram in the spirit of HdrHistogram.
+
+Values are bucketed by power of two magnitude, and every magnitude is split
+into 2^SubBucketBits linear sub buckets. The relative error of a reported
+percentile is therefore bounded by 1 / 2^(SubBucketBits - 1) regardless of
+the value range, while the memory footprint is fixed at compile time.
+
+Unlike most histograms this one supports remove(), which lets a sliding
+window be maintained incrementally: record the value entering the window and
+remove the one leaving it.
+*/
+template <unsigned SubBucketBits = 4, unsigned MagnitudeCount = 28>
+class HdrHistogram
+{
+    static_assert( SubBucketBits > 0 && SubBucketBits < 16 );
+    static_assert( MagnitudeCount + SubBucketBits <= 32 );
+
+public:
+    static constexpr uint32_t k_subBucketCount = 1u << SubBucketBits;
+    // The first magnitude uses all sub buckets, every following magnitude
+    // only needs the upper half since its lower half overlaps the previous.
+    static constexpr std::size_t k_bucketCount
+        = static_cast<std::size_t>( MagnitudeCount + 2 )
+          * ( k_subBucketCount >> 1 );
+    // Largest value that can be recorded without being clamped.
+    static constexpr uint32_t k_maxTrackableValue
+        = MagnitudeCount + SubBucketBits >= 32
+              ? std::numeric_limits<uint32_t>::max()
+              : ( 1u << ( MagnitudeCount + SubBucketBits ) ) - 1;
+
+    void record( const uint32_t value ) noexcept
+    {
+        ++m_counts[bucketIndex( value )];
+        ++m_totalCount;
+    }
+
+    void remove( const uint32_t value ) noexcept
+    {
+        auto& count = m_counts[bucketIndex( value )];
+        if ( count > 0 )
+        {
+            --count;
+            --m_totalCount;
+        }
+    }
+
+    void clear() noexcept
+    {
+        m_counts.fill( 0 );
+        m_totalCount = 0;
+    }
+
+    [[nodiscard]] uint64_t totalCount() const noexcept
+    {
+        return m_totalCount;
+    }
+
+    /*!
+    Returns the value at the given percentile in [0, 100]. The value returned
+    is the highest value equivalent to the bucket the percentile falls into,
+    so it never under reports. Returns 0 for an empty histogram.
+    */
+    [[nodiscard]] uint32_t percentile( const double p ) const noexcept
+    {
+        if ( m_totalCount == 0 )
+        {
+            return 0;
+        }
+        const auto clamped = p < 0.0 ? 0.0 : ( p > 100.0 ? 100.0 : p );
+        auto target = static_cast<uint64_t>(
+            clamped / 100.0 * static_cast<double>( m_totalCount ) + 0.5 );
+        if ( target == 0 )
+        {
+            target = 1;
+        }
+
+        uint64_t seen = 0;
+        for ( std::size_t i = 0; i < k_bucketCount; ++i )
+        {
+            seen += m_counts[i];
+            if ( seen >= target )
+            {
+                return highestEquivalentValue( i );
+            }
+        }
+        return highestEquivalentValue( k_bucketCount - 1 );
+    }
+
+    [[nodiscard]] uint32_t maxValue() const noexcept
+    {
+        for ( std::size_t i = k_bucketCount; i > 0; --i )
+        {
+            if ( m_counts[i - 1] != 0 )
+            {
+                return highestEquivalentValue( i - 1 );
+            }
+        }
+        return 0;
+    }
+
+    [[nodiscard]] static std::size_t
+        bucketIndex( const uint32_t rawValue ) noexcept
+    {
+        const auto value
+            = rawValue > k_maxTrackableValue ? k_maxTrackableValue : rawValue;
+        // Values below the sub bucket count are stored exactly in the first
+        // magnitude.
+        if ( value < k_subBucketCount )
+        {
+            return value;
+        }
+        const auto magnitude = highestBit( value ) - SubBucketBits + 1;
+        const auto subBucket
+            = ( value >> magnitude ) - ( k_subBucketCount >> 1 );
+        return static_cast<std::size_t>( magnitude ) * ( k_subBucketCount >> 1 )
+               + ( k_subBucketCount >> 1 ) + subBucket;
+    }
+
+    [[nodiscard]] static uint32_t
+        highestEquivalentValue( const std::size_t index ) noexcept
+    {
+        if ( index < k_subBucketCount )
+        {
+            return static_cast<uint32_t>( index );
+        }
+        const auto half = k_subBucketCount >> 1;
+        const auto magnitude = static_cast<unsigned>( ( index - half ) / half );
+        const auto subBucket
+            = static_cast<uint64_t>( ( index - half ) % half + half );
+        const uint64_t lowest = subBucket << magnitude;
+        const uint64_t highest = lowest + ( uint64_t{ 1 } << magnitude ) - 1;
+        return highest > k_maxTrackableValue ? k_maxTrackableValue
+                                             : static_cast<uint32_t>( highest );
+    }
+
+private:
+    static unsigned highestBit( uint32_t value ) noexcept
+    {
+        unsigned bit = 0;
+        while ( value >>= 1 )
+        {
+            ++bit;
+        }
+        return bit;
+    }
+
+    std::array<uint32_t, k_bucketCount> m_counts{};
+    uint64_t m_totalCount = 0;
+};
+
+} // namespace statistics
@@ -0,0 +1,223 @@
+#include "SessionFormat.h"
+#include <algorithm>
+
+namespace statistics
+{
+namespace
+{
+    constexpr std::size_t k_maxVarintBytes = 10;
+
+    uint64_t zigzag( const int64_t value ) noexcept
+    {
+        return ( static_cast<uint64_t>( value ) << 1 )
+               ^ static_cast<uint64_t>( value >> 63 );
+    }
+
+    int64_t unzigzag( const uint64_t value ) noexcept
+    {
+        return static_cast<int64_t>( value >> 1 )
+               ^ -static_cast<int64_t>( value & 1 );
+    }
+
+    void putVarint( std::vector<uint8_t>& out, uint64_t value )
+    {
+        while ( value >= 0x80 )
+        {
+            out.push_back( static_cast<uint8_t>( value | 0x80 ) );
+            value >>= 7;
+        }
+        out.push_back( static_cast<uint8_t>( value ) );
+    }
+
+    void putLittleEndian( std::vector<uint8_t>& out,
+                          const uint64_t value,
+                          const std::size_t bytes )
+    {
+        for ( std::size_t i = 0; i < bytes; ++i )
+        {
+            out.push_back( static_cast<uint8_t>( value >> ( 8 * i ) ) );
+        }
+    }
+
+    uint64_t getLittleEndian( const uint8_t* data,
+                              const std::size_t bytes ) noexcept
+    {
+        uint64_t value = 0;
+        for ( std::size_t i = 0; i < bytes; ++i )
+        {
+            value |= static_cast<uint64_t>( data[i] ) << ( 8 * i );
+        }
+        return value;
+    }
+
+    std::size_t typeIndex( const SessionRecordType type ) noexcept
+    {
+        return static_cast<std::size_t>( type );
+    }
+} // namespace
+
+const char* comfortFeatureName( const int64_t feature ) noexcept
+{
+    switch ( static_cast<ComfortFeature>( feature ) )
+    {
+    case ComfortFeature::AutoTurn:
+        return "autoturn";
+    case ComfortFeature::SnapTurn:
+        return "snapturn";
+    case ComfortFeature::ChaperoneBeginnerSwitch:
+        return "chaperone_beginner_switch";
+    }
+    return "unknown";
+}
+
+std::size_t sessionFieldCount( const SessionRecordType type ) noexcept
+{
+    switch ( type )
+    {
+    case SessionRecordType::Second:
+        return SecondField::Count;
+    case SessionRecordType::FrameTiming:
+        return FrameField::Count;
+    case SessionRecordType::OverlayTick:
+        return OverlayTickField::Count;
+    case SessionRecordType::Comfort:
+        return ComfortField::Count;
+    case SessionRecordType::DroppedEvents:
+        return DroppedEventsField::Count;
+    }
+    return 0;
+}
+
+void SessionEncoder::writeHeader( std::vector<uint8_t>& out,
+                                  const uint64_t startUnixMs )
+{
+    out.insert( out.end(), k_sessionMagic.begin(), k_sessionMagic.end() );
+    putLittleEndian( out, k_sessionVersion, 2 );
+    putLittleEndian( out, 0, 2 );
+    putLittleEndian( out, startUnixMs, 8 );
+}
+
+void SessionEncoder::encode( const SessionEvent& event,
+                             std::vector<uint8_t>& out )
+{
+    const auto fieldCount = sessionFieldCount( event.type );
+    if ( fieldCount == 0 )
+    {
+        return;
+    }
+
+    // Events are produced in order, but never encode a negative delta.
+    const auto timestamp = std::max( event.timestampUs, m_lastTimestampUs );
+    out.push_back( static_cast<uint8_t>( event.type ) );
+    putVarint( out, timestamp - m_lastTimestampUs );
+    m_lastTimestampUs = timestamp;
+
+    auto& previous = m_previous[typeIndex( event.type )];
+    for ( std::size_t i = 0; i < fieldCount; ++i )
+    {
+        // Wrapping subtraction, undone by the wrapping addition on decode.
+        putVarint( out,
+                   zigzag( static_cast<int64_t>(
+                       static_cast<uint64_t>( event.fields[i] )
+                       - static_cast<uint64_t>( previous[i] ) ) ) );
+        previous[i] = event.fields[i];
+    }
+}
+
+SessionDecoder::SessionDecoder( const uint8_t* data,
+                                const std::size_t size ) noexcept
+    : m_data( data ), m_size( size )
+{
+    if ( data == nullptr || size < k_sessionHeaderSize
+         || !std::equal( k_sessionMagic.begin(), k_sessionMagic.end(), data ) )
+    {
+        return;
+    }
+    m_version = static_cast<uint16_t>( getLittleEndian( data + 4, 2 ) );
+    m_startUnixMs = getLittleEndian( data + 8, 8 );
+    m_valid = m_version == k_sessionVersion;
+    m_offset = k_sessionHeaderSize;
+}
+
+bool SessionDecoder::valid() const noexcept
+{
+    return m_valid;
+}
+
+uint16_t SessionDecoder::version() const noexcept
+{
+    return m_version;
+}
+
+uint64_t SessionDecoder::startUnixMs() const noexcept
+{
+    return m_startUnixMs;
+}
+
+bool SessionDecoder::readVarint( uint64_t& value ) noexcept
+{
+    value = 0;
+    for ( std::size_t i = 0; i < k_maxVarintBytes; ++i )
+    {
+        if ( m_offset >= m_size )
+        {
+            return false;
+        }
+        const auto byte = m_data[m_offset++];
+        value |= static_cast<uint64_t>( byte & 0x7F ) << ( 7 * i );
+        if ( ( byte & 0x80 ) == 0 )
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SessionDecoder::next( SessionEvent& out ) noexcept
+{
+    if ( !m_valid || m_truncated || m_offset >= m_size )
+    {
+        return false;
+    }
+
+    const auto type = static_cast<SessionRecordType>( m_data[m_offset++] );
+    const auto fieldCount = sessionFieldCount( type );
+    uint64_t dt = 0;
+    if ( fieldCount == 0 || !readVarint( dt ) )
+    {
+        m_truncated = true;
+        return false;
+    }
+
+    SessionEvent event;
+    event.type = type;
+    event.timestampUs = m_lastTimestampUs + dt;
+
+    auto previous = m_previous[typeIndex( type )];
+    for ( std::size_t i = 0; i < fieldCount; ++i )
+    {
+        uint64_t raw = 0;
+        if ( !readVarint( raw ) )
+        {
+            m_truncated = true;
+            return false;
+        }
+        previous[i] = static_cast<int64_t>(
+            static_cast<uint64_t>( previous[i] )
+            + static_cast<uint64_t>( unzigzag( raw ) ) );
+        event.fields[i] = previous[i];
+    }
+
+    // Only commit the delta state once the whole record was read.
+    m_previous[typeIndex( type )] = previous;
+    m_lastTimestampUs = event.timestampUs;
+    out = event;
+    return true;
+}
+
+bool SessionDecoder::truncated() const noexcept
+{
+    return m_truncated;
+}
+
+} // namespace statistics
@@ -0,0 +1,184 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/*!
+Session recording file format (version 1).
+
+The file is append-only: a 16 byte header followed by records until the end of
+the file. All fixed width integers are little endian.
+
+    header:  "OVRS" | u16 version | u16 reserved | u64 start time (unix ms)
+    record:  u8 type | varint dt | varint field...
+
+dt is the number of microseconds since the previous record of any type. Every
+field is stored as the zigzag encoded difference to the same field of the
+previous record of the same type, which keeps slowly changing values (frame
+indices, per second counters) at one or two bytes. A record cut short by a
+crash is detected and ignored by the decoder.
+
+The format has no Qt or OpenVR dependency so the offline analyzer can use it
+as is.
+*/
+namespace statistics
+{
+constexpr std::array<uint8_t, 4> k_sessionMagic{ 'O', 'V', 'R', 'S' };
+constexpr uint16_t k_sessionVersion = 1;
+constexpr std::size_t k_sessionHeaderSize = 16;
+constexpr std::size_t k_sessionMaxFields = 9;
+
+enum class SessionRecordType : uint8_t
+{
+    // One per second, see SecondField.
+    Second = 1,
+    // One per compositor frame, see FrameField.
+    FrameTiming = 2,
+    // One per OverlayController::mainEventLoop run, see OverlayTickField.
+    OverlayTick = 3,
+    // A comfort feature acted, see ComfortField.
+    Comfort = 4,
+    // Events the recorder had to drop because the writer fell behind.
+    DroppedEvents = 5,
+    // LAST_ENUMERATOR must always be set to the last value
+    LAST_ENUMERATOR = DroppedEvents,
+};
+
+namespace SecondField
+{
+    enum : std::size_t
+    {
+        Presents,
+        Dropped,
+        Reprojected,
+        TimedOut,
+        // mm/s
+        HmdSpeed,
+        // centidegrees/s
+        HmdRotationRate,
+        // Peak speed in mm/s
+        LeftControllerSpeed,
+        RightControllerSpeed,
+        Count,
+    };
+}
+
+namespace FrameField
+{
+    // All times in microseconds.
+    enum : std::size_t
+    {
+        FrameIndex,
+        AppGpuUs,
+        TotalGpuUs,
+        CompositorGpuUs,
+        CompositorCpuUs,
+        ClientFrameIntervalUs,
+        Presents,
+        Dropped,
+        ReprojectionFlags,
+        Count,
+    };
+}
+
+namespace OverlayTickField
+{
+    enum : std::size_t
+    {
+        DurationUs,
+        Count,
+    };
+}
+
+namespace ComfortField
+{
+    enum : std::size_t
+    {
+        // ComfortFeature
+        Feature,
+        // Feature specific, e.g. the rotation applied in centidegrees.
+        Value,
+        Count,
+    };
+}
+
+namespace DroppedEventsField
+{
+    enum : std::size_t
+    {
+        // Events dropped since the previous DroppedEvents record.
+        Events,
+        Count,
+    };
+}
+
+enum class ComfortFeature : int64_t
+{
+    AutoTurn = 1,
+    SnapTurn = 2,
+    ChaperoneBeginnerSwitch = 3,
+};
+
+[[nodiscard]] const char* comfortFeatureName( const int64_t feature ) noexcept;
+
+// Number of fields of a record type, 0 for unknown types.
+[[nodiscard]] std::size_t
+    sessionFieldCount( const SessionRecordType type ) noexcept;
+
+struct SessionEvent
+{
+    SessionRecordType type = SessionRecordType::Second;
+    // Microseconds since the start of the session.
+    uint64_t timestampUs = 0;
+    std::array<int64_t, k_sessionMaxFields> fields{};
+};
+
+class SessionEncoder
+{
+public:
+    static void writeHeader( std::vector<uint8_t>& out,
+                             const uint64_t startUnixMs );
+
+    void encode( const SessionEvent& event, std::vector<uint8_t>& out );
+
+private:
+    uint64_t m_lastTimestampUs = 0;
+    std::array<std::array<int64_t, k_sessionMaxFields>,
+               static_cast<std::size_t>( SessionRecordType::LAST_ENUMERATOR )
+                   + 1>
+        m_previous{};
+};
+
+class SessionDecoder
+{
+public:
+    SessionDecoder( const uint8_t* data, const std::size_t size ) noexcept;
+
+    // False if the header is missing or of an unsupported version.
+    [[nodiscard]] bool valid() const noexcept;
+    [[nodiscard]] uint16_t version() const noexcept;
+    [[nodiscard]] uint64_t startUnixMs() const noexcept;
+
+    // Returns false at the end of the data or at the first malformed record.
+    bool next( SessionEvent& out ) noexcept;
+    // True if decoding stopped before the end of the data.
+    [[nodiscard]] bool truncated() const noexcept;
+
+private:
+    bool readVarint( uint64_t& value ) noexcept;
+
+    const uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_offset = 0;
+    bool m_valid = false;
+    bool m_truncated = false;
+    uint16_t m_version = 0;
+    uint64_t m_startUnixMs = 0;
+    uint64_t m_lastTimestampUs = 0;
+    std::array<std::array<int64_t, k_sessionMaxFields>,
+               static_cast<std::size_t>( SessionRecordType::LAST_ENUMERATOR )
+                   + 1>
+        m_previous{};
+};
+
+} // namespace statistics
@@ -0,0 +1,241 @@
+#include "SessionRecorder.h"
+#include <easylogging++.h>
+#include <cmath>
+#include <vector>
+#include "FrameTimings.h"
+
+namespace statistics
+{
+namespace
+{
+    constexpr auto k_flushInterval = std::chrono::seconds( 1 );
+    constexpr auto k_idleSleep = std::chrono::milliseconds( 20 );
+
+    int64_t toMicroseconds( const float milliseconds ) noexcept
+    {
+        return std::llround( static_cast<double>( milliseconds ) * 1000.0 );
+    }
+
+    int64_t toMillimeters( const float meters ) noexcept
+    {
+        return std::llround( static_cast<double>( meters ) * 1000.0 );
+    }
+} // namespace
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+bool SessionRecorder::start( const std::string& path )
+{
+    stop();
+
+    m_file.open( path, std::ios::binary | std::ios::trunc );
+    if ( !m_file )
+    {
+        LOG( ERROR ) << "Could not create session recording '" << path << "'.";
+        return false;
+    }
+
+    std::vector<uint8_t> header;
+    SessionEncoder::writeHeader(
+        header,
+        static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch() )
+                .count() ) );
+    m_file.write( reinterpret_cast<const char*>( header.data() ),
+                  static_cast<std::streamsize>( header.size() ) );
+
+    // Leftovers from a previous session, the writer isn't running.
+    SessionEvent stale;
+    while ( m_queue->tryPop( stale ) )
+    {
+    }
+
+    m_path = path;
+    m_sessionStart = Clock::now();
+    m_droppedEvents = 0;
+    m_writerRunning = true;
+    m_writer = std::thread( &SessionRecorder::writerLoop, this );
+    m_recording = true;
+
+    LOG( INFO ) << "Recording session to '" << path << "'.";
+    return true;
+}
+
+void SessionRecorder::stop()
+{
+    if ( !m_writer.joinable() )
+    {
+        return;
+    }
+    m_recording = false;
+    m_writerRunning = false;
+    m_writer.join();
+    m_file.close();
+
+    LOG( INFO ) << "Session recording '" << m_path << "' stopped, "
+                << m_droppedEvents.load() << " events dropped.";
+}
+
+bool SessionRecorder::recording() const noexcept
+{
+    return m_recording.load( std::memory_order_relaxed );
+}
+
+const std::string& SessionRecorder::path() const noexcept
+{
+    return m_path;
+}
+
+void SessionRecorder::recordSecond( const SecondSample& sample,
+                                    const float leftControllerPeakSpeed,
+                                    const float rightControllerPeakSpeed ) noexcept
+{
+    push( SessionRecordType::Second,
+          { sample[Metric::FramePresents],
+            sample[Metric::DroppedFrames],
+            sample[Metric::ReprojectedFrames],
+            sample[Metric::TimedOut],
+            sample[Metric::HmdSpeed],
+            sample[Metric::HmdRotationRate],
+            toMillimeters( leftControllerPeakSpeed ),
+            toMillimeters( rightControllerPeakSpeed ) } );
+}
+
+void SessionRecorder::recordFrame( const FrameTimingSample& frame ) noexcept
+{
+    push( SessionRecordType::FrameTiming,
+          { frame.frameIndex,
+            toMicroseconds( frame.appGpuMs ),
+            toMicroseconds( frame.totalGpuMs ),
+            toMicroseconds( frame.compositorGpuMs ),
+            toMicroseconds( frame.compositorCpuMs ),
+            toMicroseconds( frame.clientFrameIntervalMs ),
+            frame.presents,
+            frame.dropped,
+            frame.reprojectionFlags } );
+}
+
+void SessionRecorder::recordOverlayTick(
+    const Clock::duration duration ) noexcept
+{
+    push( SessionRecordType::OverlayTick,
+          { std::chrono::duration_cast<std::chrono::microseconds>( duration )
+                .count() } );
+}
+
+void SessionRecorder::recordComfortEvent( const ComfortFeature feature,
+                                          const int64_t value ) noexcept
+{
+    push( SessionRecordType::Comfort,
+          { static_cast<int64_t>( feature ), value } );
+}
+
+uint64_t SessionRecorder::droppedEvents() const noexcept
+{
+    return m_droppedEvents.load( std::memory_order_relaxed );
+}
+
+void SessionRecorder::push( const SessionRecordType type,
+                            std::initializer_list<int64_t> fields ) noexcept
+{
+    if ( !recording() )
+    {
+        return;
+    }
+
+    SessionEvent event;
+    event.type = type;
+    event.timestampUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - m_sessionStart )
+            .count() );
+    std::size_t i = 0;
+    for ( const auto field : fields )
+    {
+        event.fields[i++] = field;
+    }
+
+    if ( !m_queue->tryPush( event ) )
+    {
+        m_droppedEvents.fetch_add( 1, std::memory_order_relaxed );
+    }
+}
+
+void SessionRecorder::writerLoop()
+{
+    SessionEncoder encoder;
+    std::vector<uint8_t> buffer;
+    buffer.reserve( k_sessionFlushBytes * 2 );
+    uint64_t reportedDrops = 0;
+    auto lastFlush = Clock::now();
+    bool failed = false;
+
+    const auto flush = [&]()
+    {
+        if ( !buffer.empty() && !failed )
+        {
+            m_file.write( reinterpret_cast<const char*>( buffer.data() ),
+                          static_cast<std::streamsize>( buffer.size() ) );
+            m_file.flush();
+            if ( !m_file )
+            {
+                LOG( ERROR ) << "Writing session recording '" << m_path
+                             << "' failed, no further events are written.";
+                failed = true;
+            }
+        }
+        buffer.clear();
+        lastFlush = Clock::now();
+    };
+
+    SessionEvent event;
+    while ( true )
+    {
+        // Read before draining, so everything pushed before stop() is
+        // written.
+        const auto running = m_writerRunning.load( std::memory_order_acquire );
+
+        bool popped = false;
+        while ( m_queue->tryPop( event ) )
+        {
+            popped = true;
+            encoder.encode( event, buffer );
+            if ( buffer.size() >= k_sessionFlushBytes )
+            {
+                flush();
+            }
+        }
+
+        const auto drops = m_droppedEvents.load( std::memory_order_relaxed );
+        if ( drops != reportedDrops )
+        {
+            SessionEvent dropped;
+            dropped.type = SessionRecordType::DroppedEvents;
+            dropped.timestampUs = event.timestampUs;
+            dropped.fields[DroppedEventsField::Events]
+                = static_cast<int64_t>( drops - reportedDrops );
+            encoder.encode( dropped, buffer );
+            reportedDrops = drops;
+        }
+
+        if ( !running )
+        {
+            flush();
+            return;
+        }
+        if ( Clock::now() - lastFlush >= k_flushInterval )
+        {
+            flush();
+        }
+        if ( !popped )
+        {
+            std::this_thread::sleep_for( k_idleSleep );
+        }
+    }
+}
+
+} // namespace statistics
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "SessionFormat.h"
+#include "TimeSeries.h"
+#include "../../utils/spsc_queue.h"
+
+namespace statistics
+{
+struct FrameTimingSample;
+
+// Events buffered between the event loop and the writer thread. When the
+// writer can't keep up further events are dropped and counted instead of
+// growing memory.
+constexpr std::size_t k_sessionQueueCapacity = 4096;
+// Encoded bytes collected before they are written to disk.
+constexpr std::size_t k_sessionFlushBytes = 64 * 1024;
+
+/*!
+Records a play session to an append-only file for offline analysis.
+
+All record functions must be called from the event loop thread; they only
+copy the event into a bounded lock-free queue. A background thread delta
+encodes the events (see SessionFormat.h) and writes them in batches, so disk
+I/O never happens on the event loop.
+*/
+class SessionRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    SessionRecorder() = default;
+    ~SessionRecorder();
+    SessionRecorder( const SessionRecorder& ) = delete;
+    SessionRecorder& operator=( const SessionRecorder& ) = delete;
+
+    // Starts a new session file at path. Returns false if it can't be
+    // created, stopping any running session either way.
+    bool start( const std::string& path );
+    void stop();
+    [[nodiscard]] bool recording() const noexcept;
+    [[nodiscard]] const std::string& path() const noexcept;
+
+    void recordSecond( const SecondSample& sample,
+                       const float leftControllerPeakSpeed,
+                       const float rightControllerPeakSpeed ) noexcept;
+    void recordFrame( const FrameTimingSample& frame ) noexcept;
+    void recordOverlayTick( const Clock::duration duration ) noexcept;
+    void recordComfortEvent( const ComfortFeature feature,
+                             const int64_t value ) noexcept;
+
+    [[nodiscard]] uint64_t droppedEvents() const noexcept;
+
+private:
+    void push( const SessionRecordType type,
+               std::initializer_list<int64_t> fields ) noexcept;
+    void writerLoop();
+
+    std::atomic<bool> m_recording{ false };
+    std::atomic<bool> m_writerRunning{ false };
+    std::atomic<uint64_t> m_droppedEvents{ 0 };
+    std::string m_path;
+    Clock::time_point m_sessionStart{};
+    // Only touched by the writer thread while it runs.
+    std::ofstream m_file;
+    std::thread m_writer;
+    // Several hundred KB, so kept off the stack the controllers live on.
+    std::unique_ptr<utils::SpscQueue<SessionEvent, k_sessionQueueCapacity>>
+        m_queue = std::make_unique<
+            utils::SpscQueue<SessionEvent, k_sessionQueueCapacity>>();
+};
+
+} // namespace statistics
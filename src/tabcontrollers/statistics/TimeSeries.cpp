@@ -0,0 +1,180 @@
+#include "TimeSeries.h"
+#include <cmath>
+
+namespace statistics
+{
+void TimeSeriesStore::push( const SecondSample& sample ) noexcept
+{
+    for ( std::size_t w = 0; w < k_windowCount; ++w )
+    {
+        const auto length = windowSeconds( static_cast<Window>( w ) );
+        if ( m_count >= length )
+        {
+            // The sample that falls out of this window.
+            const auto& expired
+                = m_ring[( m_next + k_capacitySeconds - length )
+                         % k_capacitySeconds];
+            for ( std::size_t m = 0; m < k_metricCount; ++m )
+            {
+                m_histograms[m][w].remove( expired.values[m] );
+            }
+        }
+        for ( std::size_t m = 0; m < k_metricCount; ++m )
+        {
+            m_histograms[m][w].record( sample.values[m] );
+        }
+    }
+
+    m_ring[m_next] = sample;
+    m_next = ( m_next + 1 ) % k_capacitySeconds;
+    if ( m_count < k_capacitySeconds )
+    {
+        ++m_count;
+    }
+}
+
+void TimeSeriesStore::clear() noexcept
+{
+    m_next = 0;
+    m_count = 0;
+    for ( auto& metric : m_histograms )
+    {
+        for ( auto& h : metric )
+        {
+            h.clear();
+        }
+    }
+}
+
+std::size_t TimeSeriesStore::size() const noexcept
+{
+    return m_count;
+}
+
+const SecondSample&
+    TimeSeriesStore::secondsAgo( const std::size_t age ) const noexcept
+{
+    const auto clampedAge = age < m_count ? age : m_count - 1;
+    return m_ring[( m_next + k_capacitySeconds - 1 - clampedAge )
+                  % k_capacitySeconds];
+}
+
+const TimeSeriesStore::Histogram&
+    TimeSeriesStore::histogram( const Metric metric,
+                                const Window window ) const noexcept
+{
+    return m_histograms[static_cast<std::size_t>( metric )]
+                       [static_cast<std::size_t>( window )];
+}
+
+double TimeSeriesStore::percentile( const Metric metric,
+                                    const Window window,
+                                    const double p ) const noexcept
+{
+    return static_cast<double>( histogram( metric, window ).percentile( p ) )
+           / metricScale( metric );
+}
+
+Percentiles TimeSeriesStore::percentiles( const Metric metric,
+                                          const Window window ) const noexcept
+{
+    const auto& h = histogram( metric, window );
+    const auto scale = metricScale( metric );
+
+    Percentiles result;
+    result.p50 = static_cast<double>( h.percentile( 50.0 ) ) / scale;
+    result.p95 = static_cast<double>( h.percentile( 95.0 ) ) / scale;
+    result.p99 = static_cast<double>( h.percentile( 99.0 ) ) / scale;
+    result.max = static_cast<double>( h.maxValue() ) / scale;
+    result.samples = static_cast<std::size_t>( h.totalCount() );
+    return result;
+}
+
+namespace
+{
+    constexpr auto k_second = std::chrono::seconds( 1 );
+    constexpr auto k_maxGap = std::chrono::seconds( 5 );
+
+    uint32_t toFixed( const double value, const Metric metric ) noexcept
+    {
+        const auto scaled = std::lround( value * metricScale( metric ) );
+        return scaled < 0 ? 0u : static_cast<uint32_t>( scaled );
+    }
+} // namespace
+
+std::optional<SecondSample>
+    SecondAggregator::tick( const Clock::time_point now,
+                            const FrameCounters& counters,
+                            const float hmdSpeed,
+                            const float hmdRotationRate ) noexcept
+{
+    // A new compositor process restarts its counters from zero.
+    if ( !m_started || counters.pid != m_baseline.pid )
+    {
+        reset();
+        m_started = true;
+        m_secondStart = now;
+        m_baseline = counters;
+    }
+
+    m_speedSum += static_cast<double>( hmdSpeed );
+    m_rotationSum += static_cast<double>( hmdRotationRate );
+    ++m_ticks;
+
+    const auto elapsed = now - m_secondStart;
+    if ( elapsed < k_second )
+    {
+        return std::nullopt;
+    }
+
+    std::optional<SecondSample> result;
+    if ( elapsed <= k_maxGap )
+    {
+        // After a short stall the counters moved for several seconds, so
+        // they are averaged over the whole seconds that passed.
+        const auto seconds = elapsed / k_second;
+        const auto perSecond = [seconds]( const uint32_t change ) {
+            return static_cast<uint32_t>(
+                std::lround( static_cast<double>( change )
+                             / static_cast<double>( seconds ) ) );
+        };
+        SecondSample sample;
+        sample[Metric::FramePresents]
+            = perSecond( counters.presents - m_baseline.presents );
+        sample[Metric::DroppedFrames]
+            = perSecond( counters.dropped - m_baseline.dropped );
+        sample[Metric::ReprojectedFrames]
+            = perSecond( counters.reprojected - m_baseline.reprojected );
+        sample[Metric::TimedOut]
+            = perSecond( counters.timedOut - m_baseline.timedOut );
+        sample[Metric::HmdSpeed]
+            = toFixed( m_speedSum / m_ticks, Metric::HmdSpeed );
+        sample[Metric::HmdRotationRate]
+            = toFixed( m_rotationSum / m_ticks, Metric::HmdRotationRate );
+        result = sample;
+        // Advance by whole seconds so the sample boundaries don't drift with
+        // the tick rate.
+        m_secondStart += seconds * k_second;
+    }
+    else
+    {
+        m_secondStart = now;
+    }
+
+    m_baseline = counters;
+    m_speedSum = 0.0;
+    m_rotationSum = 0.0;
+    m_ticks = 0;
+    return result;
+}
+
+void SecondAggregator::reset() noexcept
+{
+    m_started = false;
+    m_baseline = FrameCounters{};
+    m_speedSum = 0.0;
+    m_rotationSum = 0.0;
+    m_ticks = 0;
+}
+
+} // namespace statistics
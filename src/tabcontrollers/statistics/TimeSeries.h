@@ -0,0 +1,170 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include "HdrHistogram.h"
+
+namespace statistics
+{
+enum class Metric
+{
+    FramePresents,
+    DroppedFrames,
+    ReprojectedFrames,
+    TimedOut,
+    // mm/s
+    HmdSpeed,
+    // centidegrees/s
+    HmdRotationRate,
+    // LAST_ENUMERATOR must always be set to the last value
+    LAST_ENUMERATOR = HmdRotationRate,
+};
+
+enum class Window
+{
+    OneMinute,
+    FiveMinutes,
+    SixtyMinutes,
+    // LAST_ENUMERATOR must always be set to the last value
+    LAST_ENUMERATOR = SixtyMinutes,
+};
+
+constexpr std::size_t k_metricCount
+    = static_cast<std::size_t>( Metric::LAST_ENUMERATOR ) + 1;
+constexpr std::size_t k_windowCount
+    = static_cast<std::size_t>( Window::LAST_ENUMERATOR ) + 1;
+
+[[nodiscard]] constexpr std::size_t windowSeconds( const Window window )
+{
+    switch ( window )
+    {
+    case Window::OneMinute:
+        return 60;
+    case Window::FiveMinutes:
+        return 5 * 60;
+    case Window::SixtyMinutes:
+        return 60 * 60;
+    }
+    return 0;
+}
+
+// Divisor that converts the stored fixed point value of a metric to its
+// display unit (frames, m/s, degrees/s).
+[[nodiscard]] constexpr double metricScale( const Metric metric )
+{
+    switch ( metric )
+    {
+    case Metric::HmdSpeed:
+        return 1000.0;
+    case Metric::HmdRotationRate:
+        return 100.0;
+    default:
+        return 1.0;
+    }
+}
+
+struct SecondSample
+{
+    std::array<uint32_t, k_metricCount> values{};
+
+    [[nodiscard]] uint32_t& operator[]( const Metric metric ) noexcept
+    {
+        return values[static_cast<std::size_t>( metric )];
+    }
+    [[nodiscard]] uint32_t operator[]( const Metric metric ) const noexcept
+    {
+        return values[static_cast<std::size_t>( metric )];
+    }
+};
+
+struct Percentiles
+{
+    double p50 = 0.0;
+    double p95 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
+    std::size_t samples = 0;
+};
+
+/*!
+Rolling store of one sample per second for the last hour.
+
+Samples live in a fixed ring buffer. Every metric/window pair has its own
+histogram that is updated incrementally when a second enters or leaves the
+window, so pushing a sample is O(metrics * windows) and a percentile query
+only walks one histogram, independent of how long the session has been.
+*/
+class TimeSeriesStore
+{
+public:
+    using Histogram = HdrHistogram<5, 20>;
+    static constexpr std::size_t k_capacitySeconds
+        = windowSeconds( Window::SixtyMinutes );
+
+    void push( const SecondSample& sample ) noexcept;
+    void clear() noexcept;
+
+    [[nodiscard]] std::size_t size() const noexcept;
+    // 0 is the most recent second.
+    [[nodiscard]] const SecondSample&
+        secondsAgo( const std::size_t age ) const noexcept;
+
+    [[nodiscard]] double percentile( const Metric metric,
+                                     const Window window,
+                                     const double p ) const noexcept;
+    [[nodiscard]] Percentiles percentiles( const Metric metric,
+                                           const Window window ) const noexcept;
+
+private:
+    [[nodiscard]] const Histogram& histogram( const Metric metric,
+                                              const Window window ) const
+        noexcept;
+
+    std::array<SecondSample, k_capacitySeconds> m_ring{};
+    std::size_t m_next = 0;
+    std::size_t m_count = 0;
+    std::array<std::array<Histogram, k_windowCount>, k_metricCount>
+        m_histograms{};
+};
+
+// Raw compositor counters, as reported by GetCumulativeStats.
+struct FrameCounters
+{
+    uint32_t pid = 0;
+    uint32_t presents = 0;
+    uint32_t dropped = 0;
+    uint32_t reprojected = 0;
+    uint32_t timedOut = 0;
+};
+
+/*!
+Folds per-frame ticks into one SecondSample per wall clock second.
+
+Compositor counters are converted to per-second deltas, HMD speed and
+rotation rate are averaged over the ticks of the second. After a short
+stall of the event loop the counter deltas are averaged over the seconds
+that passed. If it stalls for longer than a few seconds the interval is
+discarded instead.
+*/
+class SecondAggregator
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    std::optional<SecondSample> tick( const Clock::time_point now,
+                                      const FrameCounters& counters,
+                                      const float hmdSpeed,
+                                      const float hmdRotationRate ) noexcept;
+    void reset() noexcept;
+
+private:
+    bool m_started = false;
+    Clock::time_point m_secondStart{};
+    FrameCounters m_baseline{};
+    double m_speedSum = 0.0;
+    double m_rotationSum = 0.0;
+    uint32_t m_ticks = 0;
+};
+
+} // namespace statistics
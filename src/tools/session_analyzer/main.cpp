@@ -0,0 +1,442 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../tabcontrollers/statistics/HdrHistogram.h"
+#include "../../tabcontrollers/statistics/SessionFormat.h"
+
+// Offline analyzer for session recordings written by
+// statistics::SessionRecorder. Prints a summary, or one record type as CSV.
+
+namespace
+{
+using statistics::SessionEvent;
+using statistics::SessionRecordType;
+// Finer sub buckets than the overlay uses, the analyzer has memory to spare.
+using Histogram = statistics::HdrHistogram<7, 18>;
+
+constexpr std::size_t k_worstSeconds = 5;
+
+enum class CsvKind
+{
+    None,
+    Seconds,
+    Frames,
+    Ticks,
+    Comfort,
+};
+
+void printUsage()
+{
+    std::cerr << "Usage: SessionAnalyzer <session.ovrs> [--csv "
+                 "seconds|frames|ticks|comfort]\n";
+}
+
+double seconds( const uint64_t timestampUs )
+{
+    return static_cast<double>( timestampUs ) / 1e6;
+}
+
+uint32_t clampToHistogram( const int64_t value )
+{
+    return value < 0 ? 0u
+                     : static_cast<uint32_t>( std::min<int64_t>(
+                         value, Histogram::k_maxTrackableValue ) );
+}
+
+// Prints p50/p95/p99/max of a histogram, scaled by divisor.
+void printPercentiles( const char* label,
+                       const Histogram& h,
+                       const double divisor,
+                       const char* unit )
+{
+    if ( h.totalCount() == 0 )
+    {
+        std::printf( "  %-28s -\n", label );
+        return;
+    }
+    std::printf( "  %-28s p50 %8.2f  p95 %8.2f  p99 %8.2f  max %8.2f %s\n",
+                 label,
+                 h.percentile( 50.0 ) / divisor,
+                 h.percentile( 95.0 ) / divisor,
+                 h.percentile( 99.0 ) / divisor,
+                 h.maxValue() / divisor,
+                 unit );
+}
+
+struct WorstSecond
+{
+    uint64_t timestampUs;
+    int64_t dropped;
+    int64_t reprojected;
+};
+
+struct Summary
+{
+    std::array<uint64_t,
+               static_cast<std::size_t>( SessionRecordType::LAST_ENUMERATOR )
+                   + 1>
+        recordCounts{};
+    uint64_t lastTimestampUs = 0;
+    uint64_t droppedEvents = 0;
+
+    int64_t presents = 0;
+    int64_t droppedFrames = 0;
+    int64_t reprojectedFrames = 0;
+    int64_t timedOut = 0;
+    Histogram droppedPerSecond;
+    Histogram reprojectedPerSecond;
+    Histogram hmdSpeed;
+    Histogram hmdRotationRate;
+    std::vector<WorstSecond> worstSeconds;
+
+    Histogram totalGpuUs;
+    Histogram appGpuUs;
+    Histogram compositorCpuUs;
+    uint64_t reprojectedTimings = 0;
+    uint64_t missedFrameIndices = 0;
+    bool haveFrameIndex = false;
+    int64_t lastFrameIndex = 0;
+
+    Histogram overlayTickUs;
+
+    std::map<int64_t, uint64_t> comfortEvents;
+
+    void add( const SessionEvent& e )
+    {
+        ++recordCounts[static_cast<std::size_t>( e.type )];
+        lastTimestampUs = e.timestampUs;
+
+        using namespace statistics;
+        switch ( e.type )
+        {
+        case SessionRecordType::Second:
+        {
+            presents += e.fields[SecondField::Presents];
+            droppedFrames += e.fields[SecondField::Dropped];
+            reprojectedFrames += e.fields[SecondField::Reprojected];
+            timedOut += e.fields[SecondField::TimedOut];
+            droppedPerSecond.record(
+                clampToHistogram( e.fields[SecondField::Dropped] ) );
+            reprojectedPerSecond.record(
+                clampToHistogram( e.fields[SecondField::Reprojected] ) );
+            hmdSpeed.record( clampToHistogram( e.fields[SecondField::HmdSpeed] ) );
+            hmdRotationRate.record(
+                clampToHistogram( e.fields[SecondField::HmdRotationRate] ) );
+
+            const auto bad = e.fields[SecondField::Dropped]
+                             + e.fields[SecondField::Reprojected];
+            if ( bad > 0 )
+            {
+                worstSeconds.push_back( { e.timestampUs,
+                                          e.fields[SecondField::Dropped],
+                                          e.fields[SecondField::Reprojected] } );
+                // Keep only the worst few, sorted worst first.
+                std::sort( worstSeconds.begin(),
+                           worstSeconds.end(),
+                           []( const WorstSecond& a, const WorstSecond& b )
+                           {
+                               return a.dropped + a.reprojected
+                                      > b.dropped + b.reprojected;
+                           } );
+                if ( worstSeconds.size() > k_worstSeconds )
+                {
+                    worstSeconds.pop_back();
+                }
+            }
+            break;
+        }
+        case SessionRecordType::FrameTiming:
+        {
+            const auto index = e.fields[FrameField::FrameIndex];
+            if ( haveFrameIndex && index > lastFrameIndex + 1 )
+            {
+                missedFrameIndices
+                    += static_cast<uint64_t>( index - lastFrameIndex - 1 );
+            }
+            haveFrameIndex = true;
+            lastFrameIndex = index;
+
+            totalGpuUs.record(
+                clampToHistogram( e.fields[FrameField::TotalGpuUs] ) );
+            appGpuUs.record( clampToHistogram( e.fields[FrameField::AppGpuUs] ) );
+            compositorCpuUs.record(
+                clampToHistogram( e.fields[FrameField::CompositorCpuUs] ) );
+            // VRCompositor_ReprojectionReason_Cpu | _Gpu
+            if ( ( e.fields[FrameField::ReprojectionFlags] & 0x03 ) != 0 )
+            {
+                ++reprojectedTimings;
+            }
+            break;
+        }
+        case SessionRecordType::OverlayTick:
+            overlayTickUs.record(
+                clampToHistogram( e.fields[OverlayTickField::DurationUs] ) );
+            break;
+        case SessionRecordType::Comfort:
+            ++comfortEvents[e.fields[ComfortField::Feature]];
+            break;
+        case SessionRecordType::DroppedEvents:
+            droppedEvents += static_cast<uint64_t>(
+                e.fields[DroppedEventsField::Events] );
+            break;
+        }
+    }
+
+    uint64_t count( const SessionRecordType type ) const
+    {
+        return recordCounts[static_cast<std::size_t>( type )];
+    }
+
+    void print( const uint64_t startUnixMs, const bool truncated ) const
+    {
+        const auto start = static_cast<std::time_t>( startUnixMs / 1000 );
+        char startText[64] = "?";
+        if ( const auto* utc = std::gmtime( &start ) )
+        {
+            std::strftime(
+                startText, sizeof( startText ), "%Y-%m-%d %H:%M:%S UTC", utc );
+        }
+
+        std::printf( "Session started %s, %.1f minutes recorded\n",
+                     startText,
+                     seconds( lastTimestampUs ) / 60.0 );
+        if ( truncated )
+        {
+            std::printf( "Warning: the recording ends with an incomplete "
+                         "record.\n" );
+        }
+        if ( droppedEvents > 0 )
+        {
+            std::printf( "Warning: %llu events were dropped while recording.\n",
+                         static_cast<unsigned long long>( droppedEvents ) );
+        }
+
+        using statistics::SessionRecordType;
+        std::printf( "\nCompositor (%llu seconds)\n",
+                     static_cast<unsigned long long>(
+                         count( SessionRecordType::Second ) ) );
+        std::printf( "  presented %lld, dropped %lld, reprojected %lld, timed "
+                     "out %lld\n",
+                     static_cast<long long>( presents ),
+                     static_cast<long long>( droppedFrames ),
+                     static_cast<long long>( reprojectedFrames ),
+                     static_cast<long long>( timedOut ) );
+        printPercentiles( "dropped frames/s", droppedPerSecond, 1.0, "" );
+        printPercentiles(
+            "reprojected frames/s", reprojectedPerSecond, 1.0, "" );
+        printPercentiles( "HMD speed", hmdSpeed, 1000.0, "m/s" );
+        printPercentiles( "HMD rotation", hmdRotationRate, 100.0, "deg/s" );
+        for ( const auto& worst : worstSeconds )
+        {
+            std::printf( "  bad second at %8.1f s: %lld dropped, %lld "
+                         "reprojected\n",
+                         seconds( worst.timestampUs ),
+                         static_cast<long long>( worst.dropped ),
+                         static_cast<long long>( worst.reprojected ) );
+        }
+
+        const auto frames = count( SessionRecordType::FrameTiming );
+        std::printf( "\nFrame timings (%llu frames, %llu not captured)\n",
+                     static_cast<unsigned long long>( frames ),
+                     static_cast<unsigned long long>( missedFrameIndices ) );
+        printPercentiles( "total GPU", totalGpuUs, 1000.0, "ms" );
+        printPercentiles( "application GPU", appGpuUs, 1000.0, "ms" );
+        printPercentiles( "compositor CPU", compositorCpuUs, 1000.0, "ms" );
+        if ( frames > 0 )
+        {
+            std::printf( "  reprojected %.2f%%\n",
+                         100.0 * static_cast<double>( reprojectedTimings )
+                             / static_cast<double>( frames ) );
+        }
+
+        std::printf( "\nOverlay event loop (%llu ticks)\n",
+                     static_cast<unsigned long long>(
+                         count( SessionRecordType::OverlayTick ) ) );
+        printPercentiles( "tick time", overlayTickUs, 1000.0, "ms" );
+
+        std::printf( "\nComfort features\n" );
+        if ( comfortEvents.empty() )
+        {
+            std::printf( "  none fired\n" );
+        }
+        for ( const auto& [feature, events] : comfortEvents )
+        {
+            std::printf( "  %-28s %llu\n",
+                         statistics::comfortFeatureName( feature ),
+                         static_cast<unsigned long long>( events ) );
+        }
+    }
+};
+
+void printCsvHeader( const CsvKind kind )
+{
+    switch ( kind )
+    {
+    case CsvKind::Seconds:
+        std::printf( "time_s,presents,dropped,reprojected,timed_out,hmd_speed_"
+                     "mps,hmd_rotation_dps,left_controller_mps,right_"
+                     "controller_mps\n" );
+        break;
+    case CsvKind::Frames:
+        std::printf( "time_s,frame_index,app_gpu_ms,total_gpu_ms,compositor_"
+                     "gpu_ms,compositor_cpu_ms,client_interval_ms,presents,"
+                     "dropped,reprojection_flags\n" );
+        break;
+    case CsvKind::Ticks:
+        std::printf( "time_s,tick_ms\n" );
+        break;
+    case CsvKind::Comfort:
+        std::printf( "time_s,feature,value\n" );
+        break;
+    case CsvKind::None:
+        break;
+    }
+}
+
+void printCsvRow( const CsvKind kind, const SessionEvent& e )
+{
+    using namespace statistics;
+    const auto& f = e.fields;
+    const auto ms = []( const int64_t us )
+    { return static_cast<double>( us ) / 1000.0; };
+
+    if ( kind == CsvKind::Seconds && e.type == SessionRecordType::Second )
+    {
+        std::printf( "%.6f,%lld,%lld,%lld,%lld,%.3f,%.2f,%.3f,%.3f\n",
+                     seconds( e.timestampUs ),
+                     static_cast<long long>( f[SecondField::Presents] ),
+                     static_cast<long long>( f[SecondField::Dropped] ),
+                     static_cast<long long>( f[SecondField::Reprojected] ),
+                     static_cast<long long>( f[SecondField::TimedOut] ),
+                     static_cast<double>( f[SecondField::HmdSpeed] ) / 1000.0,
+                     static_cast<double>( f[SecondField::HmdRotationRate] )
+                         / 100.0,
+                     static_cast<double>( f[SecondField::LeftControllerSpeed] )
+                         / 1000.0,
+                     static_cast<double>( f[SecondField::RightControllerSpeed] )
+                         / 1000.0 );
+    }
+    else if ( kind == CsvKind::Frames
+              && e.type == SessionRecordType::FrameTiming )
+    {
+        std::printf( "%.6f,%lld,%.3f,%.3f,%.3f,%.3f,%.3f,%lld,%lld,%lld\n",
+                     seconds( e.timestampUs ),
+                     static_cast<long long>( f[FrameField::FrameIndex] ),
+                     ms( f[FrameField::AppGpuUs] ),
+                     ms( f[FrameField::TotalGpuUs] ),
+                     ms( f[FrameField::CompositorGpuUs] ),
+                     ms( f[FrameField::CompositorCpuUs] ),
+                     ms( f[FrameField::ClientFrameIntervalUs] ),
+                     static_cast<long long>( f[FrameField::Presents] ),
+                     static_cast<long long>( f[FrameField::Dropped] ),
+                     static_cast<long long>( f[FrameField::ReprojectionFlags] ) );
+    }
+    else if ( kind == CsvKind::Ticks
+              && e.type == SessionRecordType::OverlayTick )
+    {
+        std::printf( "%.6f,%.3f\n",
+                     seconds( e.timestampUs ),
+                     ms( f[OverlayTickField::DurationUs] ) );
+    }
+    else if ( kind == CsvKind::Comfort && e.type == SessionRecordType::Comfort )
+    {
+        std::printf( "%.6f,%s,%lld\n",
+                     seconds( e.timestampUs ),
+                     comfortFeatureName( f[ComfortField::Feature] ),
+                     static_cast<long long>( f[ComfortField::Value] ) );
+    }
+}
+
+CsvKind parseCsvKind( const char* name )
+{
+    if ( std::strcmp( name, "seconds" ) == 0 )
+    {
+        return CsvKind::Seconds;
+    }
+    if ( std::strcmp( name, "frames" ) == 0 )
+    {
+        return CsvKind::Frames;
+    }
+    if ( std::strcmp( name, "ticks" ) == 0 )
+    {
+        return CsvKind::Ticks;
+    }
+    if ( std::strcmp( name, "comfort" ) == 0 )
+    {
+        return CsvKind::Comfort;
+    }
+    return CsvKind::None;
+}
+
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    if ( argc != 2 && !( argc == 4 && std::strcmp( argv[2], "--csv" ) == 0 ) )
+    {
+        printUsage();
+        return 2;
+    }
+    const auto csv = argc == 4 ? parseCsvKind( argv[3] ) : CsvKind::None;
+    if ( argc == 4 && csv == CsvKind::None )
+    {
+        printUsage();
+        return 2;
+    }
+
+    std::ifstream file( argv[1], std::ios::binary );
+    if ( !file )
+    {
+        std::cerr << "Could not open '" << argv[1] << "'.\n";
+        return 1;
+    }
+    const std::vector<uint8_t> data( ( std::istreambuf_iterator<char>( file ) ),
+                                     std::istreambuf_iterator<char>() );
+
+    statistics::SessionDecoder decoder( data.data(), data.size() );
+    if ( !decoder.valid() )
+    {
+        std::cerr << "'" << argv[1]
+                  << "' is not a supported session recording.\n";
+        return 1;
+    }
+
+    if ( csv != CsvKind::None )
+    {
+        printCsvHeader( csv );
+    }
+
+    // Histograms are a few KB each, keep them off the stack.
+    auto summary = std::make_unique<Summary>();
+    SessionEvent event;
+    while ( decoder.next( event ) )
+    {
+        if ( csv != CsvKind::None )
+        {
+            printCsvRow( csv, event );
+        }
+        else
+        {
+            summary->add( event );
+        }
+    }
+
+    if ( csv == CsvKind::None )
+    {
+        summary->print( decoder.startUnixMs(), decoder.truncated() );
+    }
+    else if ( decoder.truncated() )
+    {
+        std::cerr << "Warning: the recording ends with an incomplete record.\n";
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+# Offline analyzer for session recordings, see
+# src/tabcontrollers/statistics/SessionFormat.h. Plain C++, no Qt modules.
+CONFIG   += c++1z console warn_on optimize_full
+CONFIG   -= qt app_bundle
+
+TARGET = SessionAnalyzer
+TEMPLATE = app
+
+# advancedSettings.pro passes DESTDIR so the analyzer ends up next to the
+# AdvancedSettings binary.
+isEmpty(DESTDIR) {
+    win32:DESTDIR = bin/win64/AdvancedSettings
+    unix:DESTDIR = bin/linux/AdvancedSettings
+}
+
+SOURCES += main.cpp \
+    ../../tabcontrollers/statistics/SessionFormat.cpp
+
+HEADERS += \
+    ../../tabcontrollers/statistics/HdrHistogram.h \
+    ../../tabcontrollers/statistics/SessionFormat.h
@@ -1,5 +1,6 @@
 #include "FrameRateUtils.h"
 #include <easylogging++.h>
+#include "../openvr/ovr_settings_wrapper.h"
 
 namespace utils
 {
@@ -12,9 +13,10 @@ unsigned int adjustUpdateRate( const unsigned int baseRefreshKey )
     double updateRate;
     vr::EVRSettingsError vrSettingsError;
     updateRate = static_cast<double>(
-        vr::VRSettings()->GetInt32( vr::k_pch_SteamVR_Section,
-                                    vr::k_pch_SteamVR_PreferredRefreshRate,
-                                    &vrSettingsError ) );
+        ovr_settings_wrapper::settingsCache().getInt32(
+            vr::k_pch_SteamVR_Section,
+            vr::k_pch_SteamVR_PreferredRefreshRate,
+            &vrSettingsError ) );
 
     if ( vrSettingsError != vr::VRSettingsError_None )
     {
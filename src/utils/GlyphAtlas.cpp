@@ -0,0 +1,134 @@
+#include "GlyphAtlas.h"
+#include <QPainter>
+
+namespace
+{
+constexpr int k_atlasWidth = 512;
+// Room around the advance for glyphs that overhang it, like italics.
+constexpr int k_padding = 2;
+constexpr uint k_ellipsis = 0x2026;
+
+template <typename Function>
+void forEachCodePoint( const QString& text, Function function )
+{
+    for ( auto i = 0; i < text.size(); ++i )
+    {
+        auto codePoint = static_cast<uint>( text[i].unicode() );
+        if ( text[i].isHighSurrogate() && i + 1 < text.size()
+             && text[i + 1].isLowSurrogate() )
+        {
+            codePoint = QChar::surrogateToUcs4( text[i], text[i + 1] );
+            ++i;
+        }
+        function( codePoint );
+    }
+}
+
+QString fromCodePoint( const uint codePoint )
+{
+    if ( QChar::requiresSurrogates( codePoint ) )
+    {
+        return QString( QChar( QChar::highSurrogate( codePoint ) ) )
+               + QChar( QChar::lowSurrogate( codePoint ) );
+    }
+    return QString( QChar( codePoint ) );
+}
+} // namespace
+
+GlyphAtlas::GlyphAtlas( const QFont& font, const QColor& color )
+    : m_metrics( font ), m_font( font ), m_color( color ),
+      m_image( k_atlasWidth,
+               m_metrics.height(),
+               QImage::Format_ARGB32_Premultiplied )
+{
+    m_image.fill( Qt::transparent );
+}
+
+int GlyphAtlas::lineHeight() const noexcept
+{
+    return m_metrics.height();
+}
+
+int GlyphAtlas::width( const QString& text )
+{
+    auto width = 0;
+    forEachCodePoint( text, [this, &width]( const uint codePoint ) {
+        width += glyph( codePoint ).advance;
+    } );
+    return width;
+}
+
+int GlyphAtlas::draw( QPainter& painter,
+                      const QPoint position,
+                      const QString& text,
+                      const int maxWidth )
+{
+    const auto fits = width( text ) <= maxWidth;
+    const auto ellipsis = fits ? Glyph{} : glyph( k_ellipsis );
+    const auto available = maxWidth - ellipsis.advance;
+
+    auto x = 0;
+    const auto blit = [this, &painter, &position, &x]( const Glyph& next ) {
+        painter.drawImage(
+            position + QPoint( x - k_padding, 0 ), m_image, next.cell );
+        x += next.advance;
+    };
+    auto cut = false;
+    forEachCodePoint( text, [&]( const uint codePoint ) {
+        const auto next = glyph( codePoint );
+        cut = cut || x + next.advance > available;
+        if ( !cut )
+        {
+            blit( next );
+        }
+    } );
+    if ( !fits )
+    {
+        blit( ellipsis );
+    }
+    return x;
+}
+
+int GlyphAtlas::rasterizedCount() const noexcept
+{
+    return static_cast<int>( m_glyphs.size() );
+}
+
+GlyphAtlas::Glyph GlyphAtlas::glyph( const uint codePoint )
+{
+    const auto cached = m_glyphs.constFind( codePoint );
+    if ( cached != m_glyphs.constEnd() )
+    {
+        return *cached;
+    }
+
+    const auto text = fromCodePoint( codePoint );
+    const auto advance = m_metrics.horizontalAdvance( text );
+    const auto rowHeight = m_metrics.height();
+    const auto cellWidth = advance + 2 * k_padding;
+    if ( m_cursor.x() + cellWidth > m_image.width() )
+    {
+        m_cursor = QPoint( 0, m_cursor.y() + rowHeight );
+    }
+    if ( m_cursor.y() + rowHeight > m_image.height() )
+    {
+        // The rows past the old image come out transparent.
+        m_image = m_image.copy(
+            0, 0, m_image.width(), m_cursor.y() + rowHeight * 4 );
+    }
+
+    const QRect cell( m_cursor, QSize( cellWidth, rowHeight ) );
+    {
+        QPainter painter( &m_image );
+        painter.setClipRect( cell );
+        painter.setFont( m_font );
+        painter.setPen( m_color );
+        painter.drawText(
+            cell.x() + k_padding, cell.y() + m_metrics.ascent(), text );
+    }
+    m_cursor.rx() += cellWidth;
+
+    const Glyph added{ cell, advance };
+    m_glyphs.insert( codePoint, added );
+    return added;
+}
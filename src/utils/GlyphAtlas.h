@@ -0,0 +1,59 @@
+#pragma once
+#include <QColor>
+#include <QFont>
+#include <QFontMetrics>
+#include <QHash>
+#include <QImage>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+
+class QPainter;
+
+/*!
+Text drawn from glyphs that are each rasterized only once.
+
+Drawing a string copies its glyphs out of the atlas image instead of laying
+out and rasterizing it again, so redrawing text that keeps changing, like a
+playback position, costs a few small copies. Glyphs are placed by their
+advance only, without kerning or shaping, which is fine for short labels.
+*/
+class GlyphAtlas
+{
+public:
+    GlyphAtlas( const QFont& font, const QColor& color );
+
+    [[nodiscard]] int lineHeight() const noexcept;
+    // Width of text as draw() draws it.
+    [[nodiscard]] int width( const QString& text );
+    /*!
+    Draws text with its top left corner at position. Text wider than
+    maxWidth is cut short and ends in an ellipsis. Returns the width drawn.
+    */
+    int draw( QPainter& painter,
+              const QPoint position,
+              const QString& text,
+              const int maxWidth );
+
+    // Number of glyphs rasterized so far.
+    [[nodiscard]] int rasterizedCount() const noexcept;
+
+private:
+    struct Glyph
+    {
+        // Cell in m_image, k_padding wider than the advance on both sides.
+        QRect cell;
+        int advance = 0;
+    };
+
+    // Rasterizes the glyph on first use.
+    Glyph glyph( const uint codePoint );
+
+    QFontMetrics m_metrics;
+    QFont m_font;
+    QColor m_color;
+    QImage m_image;
+    QHash<uint, Glyph> m_glyphs;
+    // Where the next glyph goes.
+    QPoint m_cursor;
+};
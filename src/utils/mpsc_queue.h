@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace utils
+{
+/*!
+Bounded multiple producer, single consumer queue.
+
+Any number of threads may call tryPush() concurrently, only one thread may
+call tryPop(). Neither side blocks, locks or allocates: tryPush() fails when
+the queue is full and tryPop() fails when it is empty.
+
+Every slot carries a sequence number telling whose turn it is. A producer
+claims a slot by advancing the shared head with a compare and swap, writes
+the value and then publishes it by bumping the slot's sequence. The consumer
+only reads slots that were published, so an element claimed but not yet
+written is never seen half finished. Elements from one producer come out in
+the order they were pushed.
+
+Capacity must be a power of two.
+*/
+template <typename T, std::size_t Capacity> class MpscQueue
+{
+    static_assert( Capacity > 0 && ( Capacity & ( Capacity - 1 ) ) == 0,
+                   "MpscQueue capacity must be a power of two." );
+    static_assert( std::is_default_constructible<T>::value
+                       && std::is_move_assignable<T>::value,
+                   "MpscQueue elements must be default constructible and "
+                   "move assignable." );
+
+public:
+    MpscQueue() noexcept
+    {
+        for ( std::size_t i = 0; i < Capacity; ++i )
+        {
+            m_slots[i].sequence.store( i, std::memory_order_relaxed );
+        }
+    }
+
+    MpscQueue( const MpscQueue& ) = delete;
+    MpscQueue& operator=( const MpscQueue& ) = delete;
+
+    // Producer side, safe to call from any thread.
+    bool tryPush( T value )
+    {
+        auto head = m_head.load( std::memory_order_relaxed );
+        Slot* slot = nullptr;
+        while ( true )
+        {
+            slot = &m_slots[head & k_mask];
+            const auto sequence
+                = slot->sequence.load( std::memory_order_acquire );
+            const auto lag = static_cast<std::intptr_t>( sequence )
+                             - static_cast<std::intptr_t>( head );
+            if ( lag == 0 )
+            {
+                if ( m_head.compare_exchange_weak(
+                         head, head + 1, std::memory_order_relaxed ) )
+                {
+                    break;
+                }
+            }
+            else if ( lag < 0 )
+            {
+                // The consumer hasn't freed this slot yet.
+                return false;
+            }
+            else
+            {
+                // Another producer claimed it first.
+                head = m_head.load( std::memory_order_relaxed );
+            }
+        }
+        slot->value = std::move( value );
+        slot->sequence.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer side.
+    bool tryPop( T& out )
+    {
+        auto& slot = m_slots[m_tail & k_mask];
+        if ( slot.sequence.load( std::memory_order_acquire ) != m_tail + 1 )
+        {
+            return false;
+        }
+        out = std::move( slot.value );
+        // Don't keep whatever the element owns alive until the slot is
+        // reused.
+        slot.value = T{};
+        slot.sequence.store( m_tail + Capacity, std::memory_order_release );
+        ++m_tail;
+        return true;
+    }
+
+    [[nodiscard]] constexpr std::size_t capacity() const noexcept
+    {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t k_mask = Capacity - 1;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence{ 0 };
+        T value{};
+    };
+
+    // Claimed by producers, kept on its own cache line so they don't false
+    // share with the consumer.
+    alignas( 64 ) std::atomic<std::size_t> m_head{ 0 };
+    // Only touched by the consumer.
+    alignas( 64 ) std::size_t m_tail = 0;
+    std::array<Slot, Capacity> m_slots;
+};
+
+} // namespace utils
@@ -71,6 +71,14 @@ CommandLineOptions returnCommandLineParser( const MyQApplication& application )
                                       k_resetSettingsDescription );
     parser.addOption( resetSettings );
 
+    QCommandLineOption controlSocket( k_controlSocket,
+                                      k_controlSocketDescription );
+    parser.addOption( controlSocket );
+
+    QCommandLineOption sendCommand(
+        k_sendCommand, k_sendCommandDescription, k_sendCommandValueName );
+    parser.addOption( sendCommand );
+
     parser.process( application );
 
     const bool desktopModeEnabled = parser.isSet( desktopMode );
@@ -94,10 +102,16 @@ CommandLineOptions returnCommandLineParser( const MyQApplication& application )
     const bool resetSettingsEnabled = parser.isSet( resetSettings );
     LOG_IF( resetSettingsEnabled, INFO ) << "Reset SteamVR Settings.";
 
+    const bool controlSocketEnabled = parser.isSet( controlSocket );
+    LOG_IF( controlSocketEnabled, INFO ) << "Control socket enabled.";
+
+    const auto sendCommandLine = parser.value( sendCommand ).toStdString();
+
     const CommandLineOptions commandLineArgs{
         desktopModeEnabled,         forceNoSoundEnabled,
         forceNoManifestEnabled,     forceInstallManifestEnabled,
-        forceRemoveManifestEnabled, resetSettingsEnabled
+        forceRemoveManifestEnabled, resetSettingsEnabled,
+        controlSocketEnabled,       sendCommandLine
     };
 
     LOG( INFO ) << "Command line arguments processed.";
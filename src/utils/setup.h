@@ -27,6 +27,9 @@ struct CommandLineOptions
     const bool forceInstallManifest = false;
     const bool forceRemoveManifest = false;
     const bool resetSettings = false;
+    const bool controlSocket = false;
+    // Empty unless the application only sends a command and exits.
+    const std::string sendCommand = "";
 };
 
 // Manages the programs control flow and main settings.
@@ -92,6 +95,16 @@ constexpr auto k_resetSettings = "reset-steamvr-settings";
 constexpr auto k_resetSettingsDescription
     = "Resets all SteamVR values that can be modified in OVRAS to defaults.";
 
+constexpr auto k_controlSocket = "control-socket";
+constexpr auto k_controlSocketDescription
+    = "Accepts JSON commands on a local socket, see --send-command.";
+
+constexpr auto k_sendCommand = "send-command";
+constexpr auto k_sendCommandDescription
+    = "Sends a JSON command to a running instance started with "
+      "--control-socket and prints the reply. Application will exit early.";
+constexpr auto k_sendCommandValueName = "json";
+
 CommandLineOptions returnCommandLineParser( const MyQApplication& application );
 
 } // namespace argument
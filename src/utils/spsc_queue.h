@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+namespace utils
+{
+/*!
+Bounded single producer, single consumer ring buffer.
+
+Neither side ever blocks or allocates: tryPush() fails when the queue is full
+and tryPop() fails when it is empty. Intended for handing data from the
+event loop to a worker thread where dropping a sample is preferable to
+stalling a frame.
+
+Capacity must be a power of two. One slot is not kept free, the indices are
+free running counters and wrap naturally.
+*/
+template <typename T, std::size_t Capacity> class SpscQueue
+{
+    static_assert( Capacity > 0 && ( Capacity & ( Capacity - 1 ) ) == 0,
+                   "SpscQueue capacity must be a power of two." );
+    static_assert( std::is_copy_assignable<T>::value,
+                   "SpscQueue elements must be copy assignable." );
+
+public:
+    // Producer side.
+    bool tryPush( const T& value ) noexcept
+    {
+        const auto head = m_head.load( std::memory_order_relaxed );
+        const auto tail = m_tail.load( std::memory_order_acquire );
+        if ( head - tail == Capacity )
+        {
+            return false;
+        }
+        m_buffer[head & k_mask] = value;
+        m_head.store( head + 1, std::memory_order_release );
+        return true;
+    }
+
+    // Consumer side.
+    bool tryPop( T& out ) noexcept
+    {
+        const auto tail = m_tail.load( std::memory_order_relaxed );
+        const auto head = m_head.load( std::memory_order_acquire );
+        if ( head == tail )
+        {
+            return false;
+        }
+        out = m_buffer[tail & k_mask];
+        m_tail.store( tail + 1, std::memory_order_release );
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_head.load( std::memory_order_acquire )
+               == m_tail.load( std::memory_order_acquire );
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_head.load( std::memory_order_acquire )
+               - m_tail.load( std::memory_order_acquire );
+    }
+
+    [[nodiscard]] constexpr std::size_t capacity() const noexcept
+    {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t k_mask = Capacity - 1;
+
+    // Producer and consumer indices live on separate cache lines so the two
+    // threads don't false share.
+    alignas( 64 ) std::atomic<std::size_t> m_head{ 0 };
+    alignas( 64 ) std::atomic<std::size_t> m_tail{ 0 };
+    std::array<T, Capacity> m_buffer{};
+};
+
+} // namespace utils
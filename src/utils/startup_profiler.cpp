@@ -0,0 +1,118 @@
+#include "startup_profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <easylogging++.h>
+
+namespace utils
+{
+namespace
+{
+    double toMs( const StartupProfiler::Clock::duration duration )
+    {
+        return std::chrono::duration<double, std::milli>( duration ).count();
+    }
+} // namespace
+
+StartupProfiler::Phase::Phase( StartupProfiler& profiler, std::string name )
+    : m_profiler( profiler ), m_name( std::move( name ) ),
+      m_start( Clock::now() )
+{
+}
+
+StartupProfiler::Phase::~Phase()
+{
+    m_profiler.record( std::move( m_name ), m_start, Clock::now() - m_start );
+}
+
+StartupProfiler::StartupProfiler()
+    : m_created( Clock::now() ), m_mainThread( std::this_thread::get_id() )
+{
+}
+
+StartupProfiler::Phase StartupProfiler::phase( std::string name )
+{
+    return Phase( *this, std::move( name ) );
+}
+
+void StartupProfiler::record( std::string name,
+                              const Clock::time_point start,
+                              const Clock::duration duration )
+{
+    const bool mainThread = std::this_thread::get_id() == m_mainThread;
+    LOG( INFO ) << "[Startup] " << name << ": " << std::fixed
+                << std::setprecision( 1 ) << toMs( duration ) << " ms"
+                << ( mainThread ? "" : " (worker)" );
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_phases.push_back( PhaseRecord{
+        std::move( name ), start - m_created, duration, mainThread } );
+}
+
+bool StartupProfiler::markFirstFrame()
+{
+    if ( m_firstFrameMarked.load( std::memory_order_acquire ) )
+    {
+        return false;
+    }
+
+    const auto now = Clock::now();
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if ( m_timeToFirstFrame )
+        {
+            return false;
+        }
+        m_timeToFirstFrame = now - m_created;
+        m_firstFrameMarked.store( true, std::memory_order_release );
+    }
+
+    constexpr std::size_t k_summaryPhases = 8;
+    LOG( INFO ) << "[Startup] Time to first frame: " << std::fixed
+                << std::setprecision( 1 ) << toMs( now - m_created )
+                << " ms. Slowest phases:\n"
+                << summary( k_summaryPhases );
+    return true;
+}
+
+std::optional<StartupProfiler::Clock::duration>
+    StartupProfiler::timeToFirstFrame() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_timeToFirstFrame;
+}
+
+std::vector<StartupProfiler::PhaseRecord> StartupProfiler::phases() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_phases;
+}
+
+std::string StartupProfiler::summary( const std::size_t maxPhases ) const
+{
+    auto sorted = phases();
+    std::stable_sort( sorted.begin(),
+                      sorted.end(),
+                      []( const PhaseRecord& a, const PhaseRecord& b ) {
+                          return a.duration > b.duration;
+                      } );
+    sorted.resize( std::min( sorted.size(), maxPhases ) );
+
+    std::ostringstream s;
+    s << std::fixed << std::setprecision( 1 );
+    for ( const auto& phase : sorted )
+    {
+        s << "  " << std::setw( 8 ) << toMs( phase.duration ) << " ms  "
+          << phase.name << " (at " << toMs( phase.start ) << " ms"
+          << ( phase.mainThread ? "" : ", worker" ) << ")\n";
+    }
+    return s.str();
+}
+
+StartupProfiler& startupProfiler()
+{
+    static StartupProfiler profiler;
+    return profiler;
+}
+
+} // namespace utils
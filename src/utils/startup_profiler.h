@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+/*!
+Records how long the phases of the startup take and logs them.
+
+Phases are timed with phase(), which returns a guard that records the time
+until it goes out of scope. They can be recorded from any thread, work done
+by StartupTasks is recorded as well.
+
+markFirstFrame() is called once the main loop ran its first frame. It logs
+the time to first frame since the profiler was created, which is the startup
+time users notice, together with the slowest phases. Only the first call
+counts.
+*/
+class StartupProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct PhaseRecord
+    {
+        std::string name;
+        // Since the profiler was created.
+        Clock::duration start;
+        Clock::duration duration;
+        bool mainThread;
+    };
+
+    class Phase
+    {
+    public:
+        Phase( StartupProfiler& profiler, std::string name );
+        ~Phase();
+
+        Phase( const Phase& ) = delete;
+        Phase& operator=( const Phase& ) = delete;
+
+    private:
+        StartupProfiler& m_profiler;
+        std::string m_name;
+        Clock::time_point m_start;
+    };
+
+    StartupProfiler();
+
+    [[nodiscard]] Phase phase( std::string name );
+    void record( std::string name,
+                 const Clock::time_point start,
+                 const Clock::duration duration );
+
+    // Returns true for the first call only.
+    bool markFirstFrame();
+    [[nodiscard]] std::optional<Clock::duration> timeToFirstFrame() const;
+
+    [[nodiscard]] std::vector<PhaseRecord> phases() const;
+    // The slowest phases, longest first, one per line.
+    [[nodiscard]] std::string summary( const std::size_t maxPhases ) const;
+
+private:
+    const Clock::time_point m_created;
+    const std::thread::id m_mainThread;
+
+    mutable std::mutex m_mutex;
+    std::vector<PhaseRecord> m_phases;
+    std::optional<Clock::duration> m_timeToFirstFrame;
+    // Lets the per frame call return without locking.
+    std::atomic<bool> m_firstFrameMarked{ false };
+};
+
+// The application wide profiler. Call it first thing in main() so the times
+// are measured from process start.
+StartupProfiler& startupProfiler();
+
+// Runs work as a phase of the application wide profiler.
+template <typename Work> decltype( auto ) timedPhase( std::string name,
+                                                      Work&& work )
+{
+    const auto phase = startupProfiler().phase( std::move( name ) );
+    return work();
+}
+
+} // namespace utils
@@ -0,0 +1,204 @@
+#include "startup_tasks.h"
+#include <algorithm>
+#include <stdexcept>
+#include <easylogging++.h>
+#include "startup_profiler.h"
+
+namespace utils
+{
+StartupTasks::StartupTasks( const std::size_t threadCount )
+{
+    const auto count = std::max<std::size_t>( threadCount, 1 );
+    m_threads.reserve( count );
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+        m_threads.emplace_back( &StartupTasks::run, this );
+    }
+}
+
+StartupTasks::~StartupTasks()
+{
+    try
+    {
+        waitAll();
+    }
+    catch ( const std::exception& e )
+    {
+        LOG( ERROR ) << "[Startup] Task failed: " << e.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_stopping = true;
+    }
+    m_taskAdded.notify_all();
+    for ( auto& thread : m_threads )
+    {
+        thread.join();
+    }
+}
+
+StartupTasks::TaskId StartupTasks::add( std::string name,
+                                        std::function<void()> work,
+                                        std::vector<TaskId> dependencies )
+{
+    TaskId id = 0;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        id = m_tasks.size();
+        for ( const auto dependency : dependencies )
+        {
+            if ( dependency >= id )
+            {
+                throw std::invalid_argument(
+                    "Startup task '" + name
+                    + "' depends on a task that wasn't added before it." );
+            }
+        }
+        m_tasks.push_back( Task{ std::move( name ),
+                                 std::move( work ),
+                                 std::move( dependencies ),
+                                 State::Waiting,
+                                 nullptr } );
+        skipFailedDependents();
+    }
+    m_taskAdded.notify_one();
+    return id;
+}
+
+void StartupTasks::wait( const TaskId task )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    if ( task >= m_tasks.size() )
+    {
+        throw std::out_of_range( "Unknown startup task." );
+    }
+    m_taskFinished.wait(
+        lock, [this, task] { return isFinished( m_tasks[task] ); } );
+    if ( m_tasks[task].error )
+    {
+        std::rethrow_exception( m_tasks[task].error );
+    }
+}
+
+void StartupTasks::waitAll()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_taskFinished.wait( lock, [this] {
+        return std::all_of(
+            m_tasks.begin(), m_tasks.end(), [this]( const Task& task ) {
+                return isFinished( task );
+            } );
+    } );
+    for ( const auto& task : m_tasks )
+    {
+        if ( task.error )
+        {
+            std::rethrow_exception( task.error );
+        }
+    }
+}
+
+std::size_t StartupTasks::defaultThreadCount() noexcept
+{
+    // Keep a core for the main thread, which still has its own startup work.
+    // The tasks are mostly file IO, more threads don't help.
+    constexpr std::size_t k_maxThreads = 4;
+    const std::size_t cores = std::thread::hardware_concurrency();
+    return std::clamp<std::size_t>( cores > 1 ? cores - 1 : 1,
+                                    1,
+                                    k_maxThreads );
+}
+
+void StartupTasks::run()
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    while ( true )
+    {
+        auto ready = m_tasks.end();
+        m_taskAdded.wait( lock, [this, &ready] {
+            ready = std::find_if( m_tasks.begin(),
+                                  m_tasks.end(),
+                                  [this]( const Task& task ) {
+                                      return isReady( task );
+                                  } );
+            return m_stopping || ready != m_tasks.end();
+        } );
+        if ( ready == m_tasks.end() )
+        {
+            return;
+        }
+
+        // m_tasks may grow while the task runs, only keep its index.
+        const auto id = static_cast<TaskId>( ready - m_tasks.begin() );
+        ready->state = State::Running;
+        auto work = std::move( ready->work );
+        const auto name = ready->name;
+
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            const auto phase = startupProfiler().phase( name );
+            work();
+        }
+        catch ( ... )
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        auto& task = m_tasks[id];
+        task.state = error ? State::Failed : State::Done;
+        task.error = error;
+        if ( error )
+        {
+            skipFailedDependents();
+        }
+        m_taskFinished.notify_all();
+        // Finishing may have made several tasks ready.
+        m_taskAdded.notify_all();
+    }
+}
+
+void StartupTasks::skipFailedDependents()
+{
+    // Dependencies always come first, so one pass reaches every dependent.
+    for ( auto& task : m_tasks )
+    {
+        if ( task.state != State::Waiting )
+        {
+            continue;
+        }
+        for ( const auto dependency : task.dependencies )
+        {
+            if ( m_tasks[dependency].state == State::Failed )
+            {
+                LOG( WARNING ) << "[Startup] Skipping '" << task.name
+                               << "', '" << m_tasks[dependency].name
+                               << "' failed.";
+                task.state = State::Failed;
+                task.error = m_tasks[dependency].error;
+                break;
+            }
+        }
+    }
+}
+
+bool StartupTasks::isReady( const Task& task ) const
+{
+    return task.state == State::Waiting
+           && std::all_of( task.dependencies.begin(),
+                           task.dependencies.end(),
+                           [this]( const TaskId dependency ) {
+                               return m_tasks[dependency].state
+                                      == State::Done;
+                           } );
+}
+
+bool StartupTasks::isFinished( const Task& task ) const noexcept
+{
+    return task.state == State::Done || task.state == State::Failed;
+}
+
+} // namespace utils
@@ -0,0 +1,84 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+/*!
+Runs independent startup work on a few worker threads.
+
+A task can depend on tasks added before it and only starts once all of them
+finished, which also rules out cycles. Tasks start as soon as they are added
+and their dependencies allow it. Every task is timed with the startup
+profiler.
+
+If a task throws, its exception is rethrown by wait() for it and for every
+task depending on it; the dependents are skipped. The destructor waits for
+all tasks.
+
+Only hand work to it that doesn't need the main thread, i.e. no QObject
+that lives there and no thread bound OS state.
+*/
+class StartupTasks
+{
+public:
+    using TaskId = std::size_t;
+
+    explicit StartupTasks( std::size_t threadCount = defaultThreadCount() );
+    ~StartupTasks();
+
+    StartupTasks( const StartupTasks& ) = delete;
+    StartupTasks& operator=( const StartupTasks& ) = delete;
+
+    TaskId add( std::string name,
+                std::function<void()> work,
+                std::vector<TaskId> dependencies = {} );
+
+    // Blocks until task finished or was skipped. Rethrows its exception.
+    void wait( const TaskId task );
+    // Waits for every task, then rethrows the first exception, if any.
+    void waitAll();
+
+    [[nodiscard]] static std::size_t defaultThreadCount() noexcept;
+
+private:
+    enum class State
+    {
+        Waiting,
+        Running,
+        Done,
+        Failed,
+    };
+
+    struct Task
+    {
+        std::string name;
+        std::function<void()> work;
+        std::vector<TaskId> dependencies;
+        State state = State::Waiting;
+        std::exception_ptr error;
+    };
+
+    void run();
+    // Marks tasks whose dependency failed as failed. Needs m_mutex.
+    void skipFailedDependents();
+    [[nodiscard]] bool isReady( const Task& task ) const;
+    [[nodiscard]] bool isFinished( const Task& task ) const noexcept;
+
+    std::mutex m_mutex;
+    std::condition_variable m_taskAdded;
+    std::condition_variable m_taskFinished;
+    std::vector<Task> m_tasks;
+    bool m_stopping = false;
+
+    // Last member, so everything above exists before the threads start.
+    std::vector<std::thread> m_threads;
+};
+
+} // namespace utils
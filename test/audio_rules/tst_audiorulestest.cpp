@@ -0,0 +1,196 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include <cmath>
+#include <string>
+#include "AudioRules.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using audio_rules::CompiledRules;
+using audio_rules::Frame;
+
+namespace
+{
+CompiledRules compile( const std::string& text )
+{
+    const auto parsed = audio_rules::parseRules( text );
+    return CompiledRules( parsed.rules );
+}
+
+Frame frame( const bool hmdPresent,
+             const bool dashboardOpen,
+             const float chaperoneDistance )
+{
+    Frame f;
+    f.hmdPresent = hmdPresent;
+    f.dashboardOpen = dashboardOpen;
+    f.chaperoneDistance = chaperoneDistance;
+    return f;
+}
+} // namespace
+
+class AudioRulesTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parsesRulesAndReportsBadLines();
+    void mutesWhileConditionsHold();
+    void negatedConditions();
+    void chaperoneDistances();
+    void sceneApps();
+    void duckTakesTheLowestAndMirrorTheFirstMatch();
+    void dropsRulesBeyondTheFactLimit();
+    void evaluate();
+};
+
+void AudioRulesTest::parsesRulesAndReportsBadLines()
+{
+    const auto parsed = audio_rules::parseRules(
+        "# comment\n"
+        "\n"
+        "hmd_removed -> mute\n"
+        "not dashboard_open and chaperone_within 0.5 -> duck 25\n"
+        "app steam.app.250820 -> mirror {0.0.0.00000000}.{abc def}\n"
+        "dashboard_open -> mirror none\n"
+        "hmd_removed mute\n"
+        "sleeping -> mute\n"
+        "chaperone_within -> mute\n"
+        "hmd_removed -> duck 150\n" );
+
+    QCOMPARE( parsed.rules.size(), std::size_t{ 4 } );
+    QCOMPARE( parsed.errors.size(), std::size_t{ 4 } );
+    QCOMPARE( parsed.errors[0].rfind( "line 7:", 0 ), std::size_t{ 0 } );
+
+    const auto& duck = parsed.rules[1];
+    QCOMPARE( duck.conditions.size(), std::size_t{ 2 } );
+    QVERIFY( duck.conditions[0].negated );
+    QVERIFY( duck.conditions[0].type
+             == audio_rules::ConditionType::DashboardOpen );
+    QCOMPARE( duck.conditions[1].distance, 0.5f );
+    QVERIFY( duck.action.type == audio_rules::ActionType::DuckMirror );
+    QCOMPARE( duck.action.volume, 0.25f );
+
+    QCOMPARE( parsed.rules[2].conditions[0].appKey,
+              std::string( "steam.app.250820" ) );
+    QCOMPARE( parsed.rules[2].action.mirrorDeviceId,
+              std::string( "{0.0.0.00000000}.{abc def}" ) );
+    QCOMPARE( parsed.rules[3].action.mirrorDeviceId, std::string() );
+}
+
+void AudioRulesTest::mutesWhileConditionsHold()
+{
+    const auto rules = compile( "hmd_removed and dashboard_open -> mute" );
+    QCOMPARE( rules.size(), std::size_t{ 1 } );
+
+    QVERIFY( !rules.evaluate( frame( true, true, NAN ) ).muteMic );
+    QVERIFY( !rules.evaluate( frame( false, false, NAN ) ).muteMic );
+    QVERIFY( rules.evaluate( frame( false, true, NAN ) ).muteMic );
+}
+
+void AudioRulesTest::negatedConditions()
+{
+    const auto rules = compile( "not dashboard_open -> mute" );
+
+    QVERIFY( rules.evaluate( frame( true, false, NAN ) ).muteMic );
+    QVERIFY( !rules.evaluate( frame( true, true, NAN ) ).muteMic );
+}
+
+void AudioRulesTest::chaperoneDistances()
+{
+    const auto rules = compile( "chaperone_within 0.3 -> mute\n"
+                                "chaperone_within 1 -> duck 50\n" );
+
+    const auto far = rules.evaluate( frame( true, false, 2.0f ) );
+    QVERIFY( !far.muteMic );
+    QCOMPARE( far.mirrorDuck, 1.0f );
+
+    const auto near = rules.evaluate( frame( true, false, 0.8f ) );
+    QVERIFY( !near.muteMic );
+    QCOMPARE( near.mirrorDuck, 0.5f );
+
+    const auto close = rules.evaluate( frame( true, false, 0.3f ) );
+    QVERIFY( close.muteMic );
+    QCOMPARE( close.mirrorDuck, 0.5f );
+
+    // Nothing is near an unknown distance.
+    QVERIFY( rules.evaluate( frame( true, false, NAN ) )
+             == audio_rules::Decision{} );
+}
+
+void AudioRulesTest::sceneApps()
+{
+    auto rules = compile( "app steam.app.1 -> mute\n"
+                          "not app steam.app.2 -> duck 10\n" );
+    QVERIFY( rules.usesSceneApp() );
+
+    auto decision = rules.evaluate( frame( true, false, NAN ) );
+    QVERIFY( !decision.muteMic );
+    QCOMPARE( decision.mirrorDuck, 0.1f );
+
+    rules.setSceneApp( "steam.app.1" );
+    decision = rules.evaluate( frame( true, false, NAN ) );
+    QVERIFY( decision.muteMic );
+    QCOMPARE( decision.mirrorDuck, 0.1f );
+
+    rules.setSceneApp( "steam.app.2" );
+    decision = rules.evaluate( frame( true, false, NAN ) );
+    QVERIFY( !decision.muteMic );
+    QCOMPARE( decision.mirrorDuck, 1.0f );
+
+    QVERIFY( !compile( "hmd_removed -> mute" ).usesSceneApp() );
+}
+
+void AudioRulesTest::duckTakesTheLowestAndMirrorTheFirstMatch()
+{
+    const auto rules = compile( "dashboard_open -> duck 60\n"
+                                "dashboard_open -> duck 20\n"
+                                "hmd_removed -> mirror speakers\n"
+                                "dashboard_open -> mirror headset\n"
+                                "dashboard_open -> mirror speakers\n" );
+
+    const auto decision = rules.evaluate( frame( true, true, NAN ) );
+    QCOMPARE( decision.mirrorDuck, 0.2f );
+    QCOMPARE( rules.mirrorTarget( decision.mirrorTarget ),
+              std::string( "headset" ) );
+
+    const auto both = rules.evaluate( frame( false, true, NAN ) );
+    QCOMPARE( rules.mirrorTarget( both.mirrorTarget ),
+              std::string( "speakers" ) );
+}
+
+void AudioRulesTest::dropsRulesBeyondTheFactLimit()
+{
+    std::string text;
+    for ( std::size_t i = 0; i < CompiledRules::k_maxFacts; ++i )
+    {
+        text += "app app." + std::to_string( i ) + " -> mute\n";
+    }
+    // Reusing a known condition still fits.
+    text += "app app.0 and hmd_removed -> duck 10\n";
+
+    const auto rules = compile( text );
+    QCOMPARE( rules.size(), CompiledRules::k_maxFacts - 1 );
+}
+
+void AudioRulesTest::evaluate()
+{
+    const auto rules
+        = compile( "hmd_removed -> mute\n"
+                   "dashboard_open -> duck 30\n"
+                   "chaperone_within 0.4 -> mute\n"
+                   "chaperone_within 0.2 -> mirror none\n"
+                   "app steam.app.1 and not hmd_removed -> mute\n" );
+    const auto f = frame( true, true, 0.3f );
+
+    audio_rules::Decision decision;
+    QBENCHMARK
+    {
+        decision = rules.evaluate( f );
+    }
+    QVERIFY( decision.muteMic );
+}
+
+QTEST_APPLESS_MAIN( AudioRulesTest )
+
+#include "tst_audiorulestest.moc"
@@ -0,0 +1,22 @@
+QT += testlib network
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE ELPP_QT_LOGGING
+
+INCLUDEPATH += ../../src/tabcontrollers/bindings \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_bindingstest.cpp \
+    ../../src/tabcontrollers/bindings/BindingIndex.cpp \
+    ../../src/tabcontrollers/bindings/BindingApplyQueue.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/tabcontrollers/bindings/BindingIndex.h \
+    ../../src/tabcontrollers/bindings/BindingApplyQueue.h
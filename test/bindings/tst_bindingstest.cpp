@@ -0,0 +1,447 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <easylogging++.h>
+#include "BindingApplyQueue.h"
+#include "BindingIndex.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using bindings::BindingApplyQueue;
+using bindings::BindingIndex;
+using bindings::BindingKey;
+
+// Stands in for SteamVR's web server, on its port.
+class FakeSteamVR : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Answer
+    {
+        Success,
+        Refuse,
+        Malformed,
+        // Closes the connection without answering.
+        Drop,
+        // Never answers.
+        Hang,
+    };
+
+    struct Received
+    {
+        QByteArray method;
+        QByteArray path;
+        // Lower case names.
+        QHash<QByteArray, QByteArray> headers;
+        QByteArray body;
+        qint64 at = 0;
+    };
+
+    FakeSteamVR()
+    {
+        connect( &m_server,
+                 &QTcpServer::newConnection,
+                 this,
+                 &FakeSteamVR::onNewConnection );
+        m_clock.start();
+    }
+
+    bool listen()
+    {
+        return m_server.listen( QHostAddress::LocalHost, 27062 );
+    }
+
+    void reset()
+    {
+        answers.clear();
+        received.clear();
+    }
+
+    // Works with both Qt 5's int and Qt 6's qsizetype sizes.
+    int requests() const
+    {
+        return static_cast<int>( received.size() );
+    }
+
+    // Used up in order, every request after them succeeds.
+    QList<Answer> answers;
+    QList<Received> received;
+
+private:
+    void onNewConnection()
+    {
+        while ( const auto socket = m_server.nextPendingConnection() )
+        {
+            connect( socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                onReadyRead( socket );
+            } );
+            connect( socket,
+                     &QTcpSocket::disconnected,
+                     socket,
+                     &QObject::deleteLater );
+        }
+    }
+
+    void onReadyRead( QTcpSocket* socket )
+    {
+        auto& buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        const auto headerEnd = buffer.indexOf( "\r\n\r\n" );
+        if ( headerEnd < 0 )
+        {
+            return;
+        }
+
+        Received request;
+        const auto lines = buffer.left( headerEnd ).split( '\n' );
+        const auto requestLine = lines.first().trimmed().split( ' ' );
+        request.method = requestLine.value( 0 );
+        request.path = requestLine.value( 1 );
+        for ( auto i = 1; i < static_cast<int>( lines.size() ); ++i )
+        {
+            const auto colon = lines[i].indexOf( ':' );
+            request.headers.insert( lines[i].left( colon ).trimmed().toLower(),
+                                    lines[i].mid( colon + 1 ).trimmed() );
+        }
+        const auto length = request.headers.value( "content-length" ).toInt();
+        if ( buffer.size() < headerEnd + 4 + length )
+        {
+            return;
+        }
+        request.body = buffer.mid( headerEnd + 4, length );
+        request.at = m_clock.elapsed();
+        m_buffers.remove( socket );
+        received.append( request );
+
+        const auto answer
+            = answers.isEmpty() ? Answer::Success : answers.takeFirst();
+        respond( socket, answer );
+    }
+
+    static void respond( QTcpSocket* socket, const Answer answer )
+    {
+        QByteArray body;
+        switch ( answer )
+        {
+        case Answer::Success:
+            body = R"({"success":true})";
+            break;
+        case Answer::Refuse:
+            body = R"({"success":false})";
+            break;
+        case Answer::Malformed:
+            body = "<html>";
+            break;
+        case Answer::Drop:
+            socket->abort();
+            return;
+        case Answer::Hang:
+            return;
+        }
+        socket->write( "HTTP/1.1 200 OK\r\n"
+                       "Content-Type: application/json\r\n"
+                       "Connection: close\r\n"
+                       "Content-Length: "
+                       + QByteArray::number( body.size() ) + "\r\n\r\n"
+                       + body );
+        socket->disconnectFromHost();
+    }
+
+    QTcpServer m_server;
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    QElapsedTimer m_clock;
+};
+
+class BindingsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void parsesBindingFileNames();
+    void ignoresOtherFiles();
+    void findsSceneBindingBeforeDefault();
+    void listsEveryAppOnce();
+    void picksUpFilesWrittenLater();
+    void insertIsImmediate();
+
+    void sendsWhatSteamVRExpects();
+    void coalescesRepeatedRequests();
+    void spacesRequestsOut();
+    void retriesFailedRequests();
+    void givesUpAfterMaxAttempts();
+    void timesOutHungRequests();
+
+private:
+    static bool touch( const QString& path );
+
+    FakeSteamVR m_steamVR;
+    bool m_listening = false;
+};
+
+void BindingsTest::initTestCase()
+{
+    m_listening = m_steamVR.listen();
+}
+
+void BindingsTest::init()
+{
+    m_steamVR.reset();
+    const QString function = QTest::currentTestFunction();
+    if ( !m_listening
+         && ( function.startsWith( "sends" ) || function.startsWith( "coal" )
+              || function.startsWith( "spaces" )
+              || function.startsWith( "retries" )
+              || function.startsWith( "gives" )
+              || function.startsWith( "times" ) ) )
+    {
+        QSKIP( "Port 27062 is taken, probably by SteamVR." );
+    }
+}
+
+bool BindingsTest::touch( const QString& path )
+{
+    QFile file( path );
+    return file.open( QIODevice::WriteOnly ) && file.write( "{}" ) == 2;
+}
+
+void BindingsTest::parsesBindingFileNames()
+{
+    const auto scene = bindings::parseBindingFileName(
+        "ovlsteam.app.620scenesteam.app.250820ctrlknuckles.json" );
+    QVERIFY( scene.has_value() );
+    QCOMPARE( scene->appID, std::string( "steam.app.620" ) );
+    QCOMPARE( scene->sceneAppID, std::string( "steam.app.250820" ) );
+    QCOMPARE( scene->controller, std::string( "knuckles" ) );
+
+    const auto fallback = bindings::parseBindingFileName(
+        "defovlsystem.generated.game.exectrlvive_controller.JSON" );
+    QVERIFY( fallback.has_value() );
+    QCOMPARE( fallback->appID, std::string( "system.generated.game.exe" ) );
+    QVERIFY( fallback->sceneAppID.empty() );
+    QCOMPARE( fallback->controller, std::string( "vive_controller" ) );
+
+    for ( const auto& key : { BindingKey{ "app", "scene.app", "knuckles" },
+                              BindingKey{ "app", "", "knuckles" } } )
+    {
+        QVERIFY( bindings::parseBindingFileName(
+                     bindings::bindingFileName( key ) )
+                 == key );
+    }
+}
+
+void BindingsTest::ignoresOtherFiles()
+{
+    for ( const auto name : { "advancedSettings.ini",
+                              "foo.json",
+                              "ovlappctrlknuckles.json",
+                              "ovlscenesctrlknuckles.json",
+                              "ovlappscenectrlknuckles.json",
+                              "ovlappscenesctrl.json",
+                              "defovlctrlknuckles.json",
+                              "ovlappscenesctrlknuckles.txt" } )
+    {
+        QVERIFY2( !bindings::parseBindingFileName( name ).has_value(), name );
+    }
+}
+
+void BindingsTest::findsSceneBindingBeforeDefault()
+{
+    BindingIndex index;
+    index.insert( "defovlappctrlknuckles.json" );
+    index.insert( "ovlappscenegamectrlknuckles.json" );
+
+    QCOMPARE( index.find( "app", "game", "knuckles" ),
+              std::optional<std::string>(
+                  "ovlappscenegamectrlknuckles.json" ) );
+    QCOMPARE( index.find( "app", "other", "knuckles" ),
+              std::optional<std::string>( "defovlappctrlknuckles.json" ) );
+    QVERIFY( !index.find( "app", "game", "vive_controller" ).has_value() );
+    QVERIFY( !index.find( "other", "game", "knuckles" ).has_value() );
+    QVERIFY( index.contains( { "app", "", "knuckles" } ) );
+    QVERIFY( !index.contains( { "app", "other", "knuckles" } ) );
+}
+
+void BindingsTest::listsEveryAppOnce()
+{
+    BindingIndex index;
+    index.insert( "ovlbscenegamectrlknuckles.json" );
+    index.insert( "defovlbctrlknuckles.json" );
+    index.insert( "defovlactrlvive_controller.json" );
+    index.insert( "ovlascenegamectrlknuckles.json" );
+    index.insert( "notabinding.json" );
+
+    QCOMPARE( index.appIDs(), std::vector<std::string>( { "a", "b" } ) );
+    QCOMPARE( index.size(), std::size_t( 4 ) );
+}
+
+void BindingsTest::picksUpFilesWrittenLater()
+{
+    QTemporaryDir directory;
+    QVERIFY( directory.isValid() );
+    QVERIFY( touch( directory.filePath( "advancedSettings.ini" ) ) );
+    QVERIFY( touch( directory.filePath( "defovlappctrlknuckles.json" ) ) );
+
+    BindingIndex index;
+    QSignalSpy changed( &index, &BindingIndex::changed );
+    index.watch( directory.path() );
+    QCOMPARE( index.size(), std::size_t( 1 ) );
+    QCOMPARE( changed.count(), 1 );
+
+    QVERIFY(
+        touch( directory.filePath( "ovlappscenegamectrlknuckles.json" ) ) );
+    QTRY_VERIFY( index.contains( { "app", "game", "knuckles" } ) );
+    QCOMPARE( index.filePath( "ovlappscenegamectrlknuckles.json" ),
+              directory.filePath( "ovlappscenegamectrlknuckles.json" ) );
+
+    QVERIFY( QFile::remove(
+        directory.filePath( "defovlappctrlknuckles.json" ) ) );
+    QTRY_VERIFY( !index.contains( { "app", "", "knuckles" } ) );
+    QCOMPARE( index.size(), std::size_t( 1 ) );
+}
+
+void BindingsTest::insertIsImmediate()
+{
+    BindingIndex index;
+    QSignalSpy changed( &index, &BindingIndex::changed );
+    index.insert( "defovlappctrlknuckles.json" );
+    QVERIFY( index.contains( { "app", "", "knuckles" } ) );
+    index.insert( "defovlappctrlknuckles.json" );
+    QCOMPARE( changed.count(), 1 );
+}
+
+void BindingsTest::sendsWhatSteamVRExpects()
+{
+    BindingApplyQueue queue;
+    QSignalSpy applied( &queue, &BindingApplyQueue::applied );
+    const QString file = QDir::tempPath() + "/some dir/binding.json";
+    queue.apply( "steam.app.620", "knuckles", file );
+
+    QTRY_COMPARE( applied.count(), 1 );
+    QCOMPARE( applied[0][0].toString(), QString( "steam.app.620" ) );
+    QCOMPARE( applied[0][1].toBool(), true );
+    QCOMPARE( queue.pending(), 0 );
+
+    QCOMPARE( m_steamVR.requests(), 1 );
+    const auto& request = m_steamVR.received.first();
+    QCOMPARE( request.method, QByteArray( "POST" ) );
+    QCOMPARE( request.path, QByteArray( "/input/selectconfig.action" ) );
+    QCOMPARE( request.headers.value( "referer" ),
+              QByteArray( "http://localhost:27062"
+                          "/dashboard/controllerbinding.html" ) );
+    QCOMPARE( request.headers.value( "content-type" ),
+              QByteArray( "application/x-www-form-urlencoded" ) );
+
+    const auto body = QJsonDocument::fromJson( request.body ).object();
+    QCOMPARE( body["app_key"].toString(), QString( "steam.app.620" ) );
+    QCOMPARE( body["controller_type"].toString(), QString( "knuckles" ) );
+    const auto url = QString::fromUtf8(
+        QUrl::fromLocalFile( file ).toEncoded( QUrl::EncodeSpaces
+                                               | QUrl::EncodeReserved ) );
+    QCOMPARE( body["url"].toString(), url );
+    QVERIFY( !url.contains( ' ' ) );
+}
+
+void BindingsTest::coalescesRepeatedRequests()
+{
+    BindingApplyQueue queue;
+    QSignalSpy applied( &queue, &BindingApplyQueue::applied );
+    for ( auto i = 0; i < 5; ++i )
+    {
+        queue.apply( "a", "knuckles", "/first.json" );
+        queue.apply( "b", "knuckles", "/b.json" );
+    }
+    // Replaces the queued one, it hasn't been sent yet.
+    queue.apply( "a", "knuckles", "/second.json" );
+    QCOMPARE( queue.pending(), 2 );
+
+    QTRY_COMPARE( applied.count(), 2 );
+    QTest::qWait( 2 * BindingApplyQueue::k_minIntervalMs );
+    QCOMPARE( m_steamVR.requests(), 2 );
+    const auto first = QJsonDocument::fromJson( m_steamVR.received[0].body );
+    QCOMPARE( first.object()["app_key"].toString(), QString( "a" ) );
+    QVERIFY( first.object()["url"].toString().endsWith( "/second.json" ) );
+}
+
+void BindingsTest::spacesRequestsOut()
+{
+    BindingApplyQueue queue;
+    QSignalSpy applied( &queue, &BindingApplyQueue::applied );
+    queue.apply( "a", "knuckles", "/a.json" );
+    queue.apply( "b", "knuckles", "/b.json" );
+    queue.apply( "c", "knuckles", "/c.json" );
+
+    QTRY_COMPARE( applied.count(), 3 );
+    const auto& received = m_steamVR.received;
+    QCOMPARE( m_steamVR.requests(), 3 );
+    // The server sees them a little later than they were sent, allow for
+    // some jitter.
+    constexpr auto jitter = 20;
+    for ( auto i = 1; i < m_steamVR.requests(); ++i )
+    {
+        QVERIFY( received[i].at - received[i - 1].at
+                 >= BindingApplyQueue::k_minIntervalMs - jitter );
+    }
+}
+
+void BindingsTest::retriesFailedRequests()
+{
+    m_steamVR.answers = { FakeSteamVR::Answer::Refuse,
+                          FakeSteamVR::Answer::Drop };
+    BindingApplyQueue queue;
+    QSignalSpy applied( &queue, &BindingApplyQueue::applied );
+    queue.apply( "a", "knuckles", "/a.json" );
+
+    QTRY_COMPARE( applied.count(), 1 );
+    QCOMPARE( applied[0][1].toBool(), true );
+    QCOMPARE( m_steamVR.requests(), 3 );
+    // Waits longer before each retry.
+    const auto& received = m_steamVR.received;
+    QVERIFY( received[1].at - received[0].at
+             >= BindingApplyQueue::k_retryDelayMs - 20 );
+    QVERIFY( received[2].at - received[1].at
+             >= 2 * BindingApplyQueue::k_retryDelayMs - 20 );
+}
+
+void BindingsTest::givesUpAfterMaxAttempts()
+{
+    m_steamVR.answers = { FakeSteamVR::Answer::Refuse,
+                          FakeSteamVR::Answer::Malformed,
+                          FakeSteamVR::Answer::Refuse };
+    BindingApplyQueue queue;
+    QSignalSpy applied( &queue, &BindingApplyQueue::applied );
+    queue.apply( "a", "knuckles", "/a.json" );
+
+    QTRY_COMPARE( applied.count(), 1 );
+    QCOMPARE( applied[0][1].toBool(), false );
+    QCOMPARE( m_steamVR.requests(), BindingApplyQueue::k_maxAttempts );
+    QCOMPARE( queue.pending(), 0 );
+    QTest::qWait( 4 * BindingApplyQueue::k_retryDelayMs );
+    QCOMPARE( m_steamVR.requests(), BindingApplyQueue::k_maxAttempts );
+}
+
+void BindingsTest::timesOutHungRequests()
+{
+    m_steamVR.answers = { FakeSteamVR::Answer::Hang };
+    BindingApplyQueue queue;
+    QSignalSpy applied( &queue, &BindingApplyQueue::applied );
+    queue.apply( "a", "knuckles", "/a.json" );
+
+    QTRY_COMPARE_WITH_TIMEOUT(
+        applied.count(), 1, 2 * BindingApplyQueue::k_timeoutMs );
+    QCOMPARE( applied[0][1].toBool(), true );
+    QCOMPARE( m_steamVR.requests(), 2 );
+}
+
+QTEST_GUILESS_MAIN( BindingsTest )
+
+#include "tst_bindingstest.moc"
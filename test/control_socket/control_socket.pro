@@ -0,0 +1,26 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE
+
+INCLUDEPATH += ../../src/control_socket \
+    ../../src/utils \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_controlsockettest.cpp \
+    ../../src/control_socket/control_protocol.cpp \
+    ../../src/control_socket/control_server.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/control_socket/control_protocol.h \
+    ../../src/control_socket/control_server.h \
+    ../../src/utils/mpsc_queue.h
+
+win32:LIBS += -lws2_32
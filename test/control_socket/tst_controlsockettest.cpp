@@ -0,0 +1,319 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include "control_protocol.h"
+#include "control_server.h"
+#include "mpsc_queue.h"
+
+#ifndef _WIN32
+#    include <sys/socket.h>
+#    include <sys/stat.h>
+#    include <sys/un.h>
+#    include <unistd.h>
+#    include <cstring>
+#endif
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace control_socket;
+
+namespace
+{
+std::string socketPath( const std::string& name )
+{
+    return ( std::filesystem::temp_directory_path()
+             / ( "ovras-test-" + name + ".sock" ) )
+        .string();
+}
+
+// Sends line from another thread while the test thread plays main loop.
+std::optional<std::string> roundTrip( ControlServer& server,
+                                      const std::string& line,
+                                      const Handler& handler )
+{
+    std::optional<std::string> reply;
+    std::thread client( [&] {
+        reply = sendCommand(
+            server.path(), line, std::chrono::milliseconds( 5000 ) );
+    } );
+
+    std::size_t processed = 0;
+    const auto deadline = Clock::now() + std::chrono::seconds( 5 );
+    while ( processed == 0 && Clock::now() < deadline )
+    {
+        processed = server.processPending( handler );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    client.join();
+    return reply;
+}
+} // namespace
+
+class ControlSocketTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void queueKeepsOrder();
+    void queueRejectsPushWhenFull();
+    void queueWithManyProducers();
+
+    void parsesRequest();
+    void rejectsMalformedRequests();
+    void formatsReplies();
+
+    void runsCommandsOnProcessPending();
+    void reportsHandlerErrors();
+    void answersMalformedLinesDirectly();
+    void leavesRunningInstanceAlone();
+#ifndef _WIN32
+    void replacesStaleSocket();
+    void socketIsPrivate();
+#endif
+};
+
+void ControlSocketTest::queueKeepsOrder()
+{
+    utils::MpscQueue<int, 8> queue;
+    for ( int i = 0; i < 5; ++i )
+    {
+        QVERIFY( queue.tryPush( i ) );
+    }
+    int value = -1;
+    for ( int i = 0; i < 5; ++i )
+    {
+        QVERIFY( queue.tryPop( value ) );
+        QCOMPARE( value, i );
+    }
+    QVERIFY( !queue.tryPop( value ) );
+}
+
+void ControlSocketTest::queueRejectsPushWhenFull()
+{
+    utils::MpscQueue<std::string, 4> queue;
+    for ( int i = 0; i < 4; ++i )
+    {
+        QVERIFY( queue.tryPush( std::to_string( i ) ) );
+    }
+    QVERIFY( !queue.tryPush( "full" ) );
+
+    std::string value;
+    QVERIFY( queue.tryPop( value ) );
+    QCOMPARE( value, std::string( "0" ) );
+    QVERIFY( queue.tryPush( "4" ) );
+
+    for ( int i = 1; i <= 4; ++i )
+    {
+        QVERIFY( queue.tryPop( value ) );
+        QCOMPARE( value, std::to_string( i ) );
+    }
+    QVERIFY( !queue.tryPop( value ) );
+}
+
+void ControlSocketTest::queueWithManyProducers()
+{
+    constexpr int k_producers = 4;
+    constexpr int k_perProducer = 20000;
+    utils::MpscQueue<uint64_t, 64> queue;
+
+    std::vector<std::thread> producers;
+    for ( int p = 0; p < k_producers; ++p )
+    {
+        producers.emplace_back( [&queue, p] {
+            for ( uint64_t i = 0; i < k_perProducer; ++i )
+            {
+                const auto value = ( static_cast<uint64_t>( p ) << 32 ) | i;
+                while ( !queue.tryPush( value ) )
+                {
+                    std::this_thread::yield();
+                }
+            }
+        } );
+    }
+
+    // Every producer's values must arrive complete and in order.
+    std::vector<uint64_t> next( k_producers, 0 );
+    int received = 0;
+    bool ordered = true;
+    while ( received < k_producers * k_perProducer )
+    {
+        uint64_t value = 0;
+        if ( !queue.tryPop( value ) )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto producer = static_cast<std::size_t>( value >> 32 );
+        ordered = ordered && ( value & 0xFFFFFFFFu ) == next[producer];
+        ++next[producer];
+        ++received;
+    }
+    for ( auto& producer : producers )
+    {
+        producer.join();
+    }
+
+    QVERIFY( ordered );
+    uint64_t value = 0;
+    QVERIFY( !queue.tryPop( value ) );
+}
+
+void ControlSocketTest::parsesRequest()
+{
+    std::string error;
+    const auto request = parseRequest(
+        R"({"id":7,"cmd":"settings.get","key":"videoSettings/colorRedNew"})",
+        error );
+    QVERIFY( request.has_value() );
+    QCOMPARE( request->id, nlohmann::json( 7 ) );
+    QCOMPARE( request->command, std::string( "settings.get" ) );
+    QCOMPARE( request->args.at( "key" ).get<std::string>(),
+              std::string( "videoSettings/colorRedNew" ) );
+
+    const auto withoutId = parseRequest( R"({"cmd":"ping"})", error );
+    QVERIFY( withoutId.has_value() );
+    QVERIFY( withoutId->id.is_null() );
+}
+
+void ControlSocketTest::rejectsMalformedRequests()
+{
+    std::string error;
+    QVERIFY( !parseRequest( "{\"cmd\":", error ) );
+    QVERIFY( !error.empty() );
+    QVERIFY( !parseRequest( "[1,2]", error ) );
+    QVERIFY( !parseRequest( R"({"id":1})", error ) );
+    QVERIFY( !parseRequest( R"({"cmd":5})", error ) );
+    QVERIFY( !parseRequest( R"({"cmd":""})", error ) );
+}
+
+void ControlSocketTest::formatsReplies()
+{
+    const auto result = formatResult( "a", { { "value", 1.5 } }, 42 );
+    QCOMPARE( result.back(), '\n' );
+    const auto parsedResult = nlohmann::json::parse( result );
+    QCOMPARE( parsedResult.at( "id" ), nlohmann::json( "a" ) );
+    QCOMPARE( parsedResult.at( "ok" ), nlohmann::json( true ) );
+    QCOMPARE( parsedResult.at( "result" ).at( "value" ).get<double>(), 1.5 );
+    QCOMPARE( parsedResult.at( "latencyUs" ).get<long long>(), 42LL );
+
+    // Invalid UTF-8 is replaced instead of throwing.
+    const auto error = formatError( nullptr, "bad \xFF byte" );
+    const auto parsedError = nlohmann::json::parse( error );
+    QCOMPARE( parsedError.at( "ok" ), nlohmann::json( false ) );
+    QVERIFY( parsedError.at( "id" ).is_null() );
+}
+
+void ControlSocketTest::runsCommandsOnProcessPending()
+{
+    ControlServer server( socketPath( "run" ) );
+    QVERIFY( server.start() );
+
+    const auto mainThread = std::this_thread::get_id();
+    bool ranOnMainThread = false;
+    const auto reply = roundTrip(
+        server, R"({"id":3,"cmd":"ping"})", [&]( const Request& request ) {
+            ranOnMainThread = std::this_thread::get_id() == mainThread;
+            return nlohmann::json{ { "pong", request.command == "ping" } };
+        } );
+
+    QVERIFY( reply.has_value() );
+    const auto parsed = nlohmann::json::parse( *reply );
+    QCOMPARE( parsed.at( "id" ), nlohmann::json( 3 ) );
+    QCOMPARE( parsed.at( "ok" ), nlohmann::json( true ) );
+    QCOMPARE( parsed.at( "result" ).at( "pong" ), nlohmann::json( true ) );
+    QVERIFY( parsed.at( "latencyUs" ).get<long long>() >= 0 );
+    QVERIFY( ranOnMainThread );
+
+    server.stop();
+    QVERIFY( !std::filesystem::exists( server.path() ) );
+}
+
+void ControlSocketTest::reportsHandlerErrors()
+{
+    ControlServer server( socketPath( "error" ) );
+    QVERIFY( server.start() );
+
+    const auto reply = roundTrip(
+        server, R"({"id":"x","cmd":"fail"})", []( const Request& ) {
+            throw std::invalid_argument( "Unknown command 'fail'." );
+            return nlohmann::json{};
+        } );
+
+    QVERIFY( reply.has_value() );
+    const auto parsed = nlohmann::json::parse( *reply );
+    QCOMPARE( parsed.at( "id" ), nlohmann::json( "x" ) );
+    QCOMPARE( parsed.at( "ok" ), nlohmann::json( false ) );
+    QCOMPARE( parsed.at( "error" ).get<std::string>(),
+              std::string( "Unknown command 'fail'." ) );
+}
+
+void ControlSocketTest::answersMalformedLinesDirectly()
+{
+    ControlServer server( socketPath( "malformed" ) );
+    QVERIFY( server.start() );
+
+    // Nobody calls processPending(), the reader answers on its own.
+    const auto reply = sendCommand(
+        server.path(), "not json", std::chrono::milliseconds( 5000 ) );
+    QVERIFY( reply.has_value() );
+    const auto parsed = nlohmann::json::parse( *reply );
+    QCOMPARE( parsed.at( "ok" ), nlohmann::json( false ) );
+
+    std::size_t processed
+        = server.processPending( []( const Request& ) { return nullptr; } );
+    QCOMPARE( processed, std::size_t{ 0 } );
+}
+
+void ControlSocketTest::leavesRunningInstanceAlone()
+{
+    ControlServer first( socketPath( "twice" ) );
+    QVERIFY( first.start() );
+    ControlServer second( socketPath( "twice" ) );
+    QVERIFY( !second.start() );
+
+    const auto reply = roundTrip(
+        first, R"({"id":1,"cmd":"ping"})", []( const Request& ) {
+            return nlohmann::json{};
+        } );
+    QVERIFY( reply.has_value() );
+}
+
+#ifndef _WIN32
+void ControlSocketTest::replacesStaleSocket()
+{
+    const auto path = socketPath( "stale" );
+    std::filesystem::remove( path );
+    // Bound but never listened on and closed without unlinking, like a
+    // crashed instance leaves it.
+    const auto s = socket( AF_UNIX, SOCK_STREAM, 0 );
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::memcpy( address.sun_path, path.c_str(), path.size() );
+    QCOMPARE( bind( s,
+                    reinterpret_cast<sockaddr*>( &address ),
+                    sizeof( address ) ),
+              0 );
+    close( s );
+    QVERIFY( std::filesystem::exists( path ) );
+
+    ControlServer server( path );
+    QVERIFY( server.start() );
+}
+
+void ControlSocketTest::socketIsPrivate()
+{
+    ControlServer server( socketPath( "private" ) );
+    QVERIFY( server.start() );
+    struct stat info
+    {
+    };
+    QCOMPARE( stat( server.path().c_str(), &info ), 0 );
+    QCOMPARE( info.st_mode & ( S_IRWXG | S_IRWXO ), 0u );
+}
+#endif
+
+QTEST_APPLESS_MAIN( ControlSocketTest )
+
+#include "tst_controlsockettest.moc"
@@ -0,0 +1,23 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE
+
+INCLUDEPATH += ../../src/tabcontrollers \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_discoverytest.cpp \
+    ../../src/tabcontrollers/DiscoveryBroadcaster.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/tabcontrollers/DiscoveryBroadcaster.h \
+    ../../src/tabcontrollers/DiscoveryProtocol.h
+
+win32:LIBS += -lws2_32 -liphlpapi
@@ -0,0 +1,308 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include "DiscoveryBroadcaster.h"
+#include "DiscoveryProtocol.h"
+#ifdef Q_OS_LINUX
+#    include <arpa/inet.h>
+#    include <netinet/in.h>
+#    include <sys/socket.h>
+#    include <unistd.h>
+#endif
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace discovery;
+using std::chrono::seconds;
+
+namespace
+{
+uint32_t toNetwork( const uint32_t v )
+{
+    uint32_t out = 0;
+    auto* b = reinterpret_cast<uint8_t*>( &out );
+    b[0] = static_cast<uint8_t>( v >> 24 );
+    b[1] = static_cast<uint8_t>( v >> 16 );
+    b[2] = static_cast<uint8_t>( v >> 8 );
+    b[3] = static_cast<uint8_t>( v );
+    return out;
+}
+
+#ifdef Q_OS_LINUX
+// A UDP socket on a loopback address standing in for one of the peer's
+// addresses.
+class PeerSocket
+{
+public:
+    PeerSocket( const char* address, const uint16_t port )
+        : m_socket( socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP ) )
+    {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons( port );
+        inet_pton( AF_INET, address, &addr.sin_addr );
+        m_bound = bind( m_socket,
+                        reinterpret_cast<sockaddr*>( &addr ),
+                        sizeof( addr ) )
+                  == 0;
+    }
+
+    ~PeerSocket()
+    {
+        close( m_socket );
+    }
+
+    bool bound() const
+    {
+        return m_bound;
+    }
+
+    uint16_t port() const
+    {
+        sockaddr_in addr{};
+        socklen_t length = sizeof( addr );
+        getsockname(
+            m_socket, reinterpret_cast<sockaddr*>( &addr ), &length );
+        return ntohs( addr.sin_port );
+    }
+
+    // Waits up to timeout for a discovery packet, from is set to its sender.
+    bool receive( const std::chrono::milliseconds timeout,
+                  sockaddr_in* from = nullptr )
+    {
+        timeval tv{};
+        tv.tv_sec = static_cast<long>( timeout.count() / 1000 );
+        tv.tv_usec = static_cast<long>( timeout.count() % 1000 * 1000 );
+        setsockopt( m_socket, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+
+        DiscoveryPacket packet{};
+        sockaddr_in sender{};
+        socklen_t length = sizeof( sender );
+        const auto received
+            = recvfrom( m_socket,
+                        &packet,
+                        sizeof( packet ),
+                        0,
+                        reinterpret_cast<sockaddr*>( &sender ),
+                        &length );
+        if ( from )
+        {
+            *from = sender;
+        }
+        return received == static_cast<ssize_t>( sizeof( packet ) );
+    }
+
+    void drain()
+    {
+        while ( receive( std::chrono::milliseconds( 1 ) ) )
+        {
+        }
+    }
+
+    void reply( const sockaddr_in& to )
+    {
+        DiscoveryPacket reply{};
+        reply.magic = toNetwork( DISCOVERY_REPLY_MAGIC );
+        reply.checksum = toNetwork( calculateChecksum( reply ) );
+        sendto( m_socket,
+                &reply,
+                sizeof( reply ),
+                0,
+                reinterpret_cast<const sockaddr*>( &to ),
+                sizeof( to ) );
+    }
+
+private:
+    int m_socket;
+    bool m_bound = false;
+};
+#endif
+} // namespace
+
+class DiscoveryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sendsEveryBaseIntervalWhileDisconnected();
+    void backsOffExponentiallyWhileConnected();
+    void backoffIsCapped();
+    void disconnectResetsBackoff();
+
+    void manualTargetIsKept();
+    void learnedTargetsAreDeduplicated();
+    void learnedTargetsReplaceOldest();
+
+    void directedBroadcastAddress();
+    void replyValidation();
+
+    void disconnectForgetsLearnedTargets();
+};
+
+void DiscoveryTest::sendsEveryBaseIntervalWhileDisconnected()
+{
+    BackoffSchedule schedule( seconds( 1 ), seconds( 32 ) );
+    Clock::time_point now{};
+
+    QVERIFY( schedule.isDue( now ) );
+    for ( int i = 0; i < 5; ++i )
+    {
+        schedule.onSent( now );
+        QVERIFY( !schedule.isDue( now + std::chrono::milliseconds( 999 ) ) );
+        now += seconds( 1 );
+        QVERIFY( schedule.isDue( now ) );
+    }
+}
+
+void DiscoveryTest::backsOffExponentiallyWhileConnected()
+{
+    BackoffSchedule schedule( seconds( 1 ), seconds( 32 ) );
+    Clock::time_point now{};
+    schedule.setPeerConnected( true, now );
+
+    Clock::duration expected = seconds( 1 );
+    for ( int i = 0; i < 4; ++i )
+    {
+        schedule.onSent( now );
+        QCOMPARE( schedule.nextDeadline() - now, expected );
+        now = schedule.nextDeadline();
+        expected *= 2;
+    }
+}
+
+void DiscoveryTest::backoffIsCapped()
+{
+    BackoffSchedule schedule( seconds( 1 ), seconds( 8 ) );
+    Clock::time_point now{};
+    schedule.setPeerConnected( true, now );
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        schedule.onSent( now );
+        now = schedule.nextDeadline();
+    }
+    QCOMPARE( schedule.currentInterval(), Clock::duration( seconds( 8 ) ) );
+}
+
+void DiscoveryTest::disconnectResetsBackoff()
+{
+    BackoffSchedule schedule( seconds( 1 ), seconds( 32 ) );
+    Clock::time_point now{};
+    schedule.setPeerConnected( true, now );
+    for ( int i = 0; i < 4; ++i )
+    {
+        schedule.onSent( now );
+    }
+
+    now += seconds( 2 );
+    schedule.setPeerConnected( false, now );
+    QVERIFY( schedule.isDue( now ) );
+    QCOMPARE( schedule.currentInterval(), Clock::duration( seconds( 1 ) ) );
+}
+
+void DiscoveryTest::manualTargetIsKept()
+{
+    TargetList targets;
+    targets.setManual( 0x0100000a );
+    for ( uint32_t i = 1; i < 10; ++i )
+    {
+        targets.learn( 0x0200000a + ( i << 24 ) );
+    }
+    QCOMPARE( targets.manual(), uint32_t{ 0x0100000a } );
+
+    std::array<uint32_t, TargetList::k_slotCount> out{};
+    QCOMPARE( targets.snapshot( out ), TargetList::k_slotCount );
+    QCOMPARE( out[0], uint32_t{ 0x0100000a } );
+}
+
+void DiscoveryTest::learnedTargetsAreDeduplicated()
+{
+    TargetList targets;
+    QVERIFY( targets.learn( 0x0500000a ) );
+    QVERIFY( !targets.learn( 0x0500000a ) );
+
+    targets.setManual( 0x0500000a );
+    std::array<uint32_t, TargetList::k_slotCount> out{};
+    QCOMPARE( targets.snapshot( out ), std::size_t{ 1 } );
+}
+
+void DiscoveryTest::learnedTargetsReplaceOldest()
+{
+    TargetList targets;
+    for ( uint32_t i = 1; i <= TargetList::k_slotCount; ++i )
+    {
+        targets.learn( i );
+    }
+    // Slots 1..3 held 1, 2, 3; learning 4 replaced 1.
+    std::array<uint32_t, TargetList::k_slotCount> out{};
+    QCOMPARE( targets.snapshot( out ), std::size_t{ 3 } );
+    QCOMPARE( out[0], uint32_t{ 4 } );
+    QCOMPARE( out[1], uint32_t{ 2 } );
+    QCOMPARE( out[2], uint32_t{ 3 } );
+
+    targets.clearLearned();
+    QCOMPARE( targets.snapshot( out ), std::size_t{ 0 } );
+}
+
+void DiscoveryTest::directedBroadcastAddress()
+{
+    // 192.168.1.23/24 in network byte order on a little endian host.
+    const uint32_t address = 0x1701a8c0;
+    const uint32_t mask = 0x00ffffff;
+    QCOMPARE( directedBroadcast( address, mask ), uint32_t{ 0xff01a8c0 } );
+}
+
+void DiscoveryTest::replyValidation()
+{
+    DiscoveryPacket reply{};
+    reply.magic = toNetwork( DISCOVERY_REPLY_MAGIC );
+    reply.checksum = toNetwork( calculateChecksum( reply ) );
+    QVERIFY( isValidDiscoveryReply( reply ) );
+
+    reply.magic = toNetwork( DISCOVERY_MAGIC );
+    reply.checksum = toNetwork( calculateChecksum( reply ) );
+    QVERIFY( !isValidDiscoveryReply( reply ) );
+}
+
+void DiscoveryTest::disconnectForgetsLearnedTargets()
+{
+#ifndef Q_OS_LINUX
+    QSKIP( "Needs more than one loopback address." );
+#else
+    using std::chrono::milliseconds;
+    // The manual target and the address the peer answers from.
+    PeerSocket manual( "127.0.0.2", 0 );
+    QVERIFY( manual.bound() );
+    PeerSocket peer( "127.0.0.3", manual.port() );
+    QVERIFY( peer.bound() );
+
+    DiscoveryBroadcaster broadcaster( 5555, manual.port() );
+    broadcaster.setTargetIP( "127.0.0.2" );
+    QVERIFY( broadcaster.start() );
+
+    sockaddr_in from{};
+    QVERIFY( manual.receive( milliseconds( 5000 ), &from ) );
+    peer.reply( from );
+    QVERIFY( peer.receive( milliseconds( 5000 ) ) );
+    QCOMPARE( broadcaster.learnedPeer(), std::string( "127.0.0.3" ) );
+
+    // Give the worker a chance to see each state.
+    broadcaster.setPeerConnected( true );
+    std::this_thread::sleep_for( milliseconds( 600 ) );
+    broadcaster.setPeerConnected( false );
+    std::this_thread::sleep_for( milliseconds( 600 ) );
+    QCOMPARE( broadcaster.learnedPeer(), std::string() );
+
+    // A send after the disconnect reaches the manual target, the address
+    // learned in the old session is left out.
+    manual.drain();
+    peer.drain();
+    QVERIFY( manual.receive( milliseconds( 5000 ) ) );
+    QVERIFY( !peer.receive( milliseconds( 100 ) ) );
+
+    broadcaster.stop();
+#endif
+}
+
+QTEST_APPLESS_MAIN( DiscoveryTest )
+
+#include "tst_discoverytest.moc"
@@ -1,6 +1,217 @@
 #include <QtTest>
 #include <QDebug>
+#include <array>
+#include <random>
+#include <easylogging++.h>
 #include "input_parser.h"
+#include "keyboard_macro.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+namespace
+{
+// Key codes that are easy to predict, the token value plus one.
+uint32_t fakeKeyCode( const Token token )
+{
+    return static_cast<uint32_t>( token ) + 1;
+}
+
+int resolveCount = 0;
+
+uint32_t countingKeyCode( const Token token )
+{
+    ++resolveCount;
+    return fakeKeyCode( token );
+}
+
+keyboard_macro::MacroOp down( const Token token, const uint32_t delayMs = 0 )
+{
+    return keyboard_macro::MacroOp{ fakeKeyCode( token ), true, delayMs };
+}
+
+keyboard_macro::MacroOp up( const Token token )
+{
+    return keyboard_macro::MacroOp{ fakeKeyCode( token ), false, 0 };
+}
+
+std::vector<keyboard_macro::MacroOp> compileOps( const std::string& text )
+{
+    return keyboard_macro::compileMacro( text, fakeKeyCode ).ops;
+}
+
+std::vector<Token> lexToVector( const std::string& text )
+{
+    std::vector<Token> tokens( lexBufferSize( text.size() ) );
+    tokens.resize(
+        lexKeyboardInputs( text, tokens.data(), tokens.size() ).count );
+    return tokens;
+}
+
+// Random shortcuts made of pieces the lexer treats differently, with the
+// occasional random byte.
+std::string randomShortcut( std::mt19937& random )
+{
+    static const std::vector<std::string> pieces
+        = { "a",      "z",     "0",   "9",   "^",     "*",   ">",
+            "#",      " ",     "\t", "F",   "F1",    "F0",  "G0",
+            "G9",     "G",     "TAB", "TA",  "ENTER", "END", "BACKSPACE",
+            "KPSTAR", "KPSL",  "?",   "A",   "Z",     "~",   "\xff" };
+    std::uniform_int_distribution<std::size_t> piece( 0, pieces.size() );
+    std::uniform_int_distribution<int> byte( -128, 127 );
+    std::uniform_int_distribution<int> length( 0, 24 );
+
+    std::string shortcut;
+    for ( auto i = length( random ); i > 0; --i )
+    {
+        const auto p = piece( random );
+        if ( p == pieces.size() )
+        {
+            shortcut.push_back( static_cast<char>( byte( random ) ) );
+        }
+        else
+        {
+            shortcut += pieces[p];
+        }
+    }
+    return shortcut;
+}
+
+// The two-pass parser as it was before lexKeyboardInputs(), kept frozen so
+// the fuzz test checks the lexer against the old behaviour rather than
+// against itself. Only the logging is left out.
+namespace reference
+{
+    std::optional<Token> getCapitalLiteral( const std::string& input )
+    {
+        static const std::vector<std::pair<std::string, Token>> literals = {
+            { "BACKSPACE", Token::KEY_BACKSPACE },
+            { "SPACE", Token::KEY_SPACE },
+            { "TAB", Token::KEY_TAB },
+            { "ESC", Token::KEY_ESC },
+            { "INS", Token::KEY_INS },
+            { "DEL", Token::KEY_DEL },
+            { "END", Token::KEY_END },
+            { "PGDN", Token::KEY_PGDN },
+            { "PGUP", Token::KEY_PGUP },
+            { "CAPS", Token::KEY_CAPS },
+            { "PRNSCRN", Token::KEY_PRNSCRN },
+            { "PAUSE", Token::KEY_PAUSE },
+            { "SCRLOCK", Token::KEY_SCRLOCK },
+            { "LEFTARROW", Token::KEY_LEFTARROW },
+            { "RIGHTARROW", Token::KEY_RIGHTARROW },
+            { "UPARROW", Token::KEY_UPARROW },
+            { "DOWNARROW", Token::KEY_DOWNARROW },
+            { "KPSLASH", Token::KEY_KPSLASH },
+            { "KPSTAR", Token::KEY_KPSTAR },
+            { "KPMINUS", Token::KEY_KPMINUS },
+            { "KPPLUS", Token::KEY_KPPLUS },
+            { "ENTER", Token::KEY_ENTER },
+            { "BACKSLASH", Token::KEY_BACKSLASH },
+        };
+        for ( const auto& [name, token] : literals )
+        {
+            if ( input == name )
+            {
+                return token;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // F1 to F9 after an 'F', F10 to F19 after a 'G'.
+    std::optional<Token> getFunctionKey( const char prefix, const char digit )
+    {
+        const auto first = prefix == 'F' ? '1' : '0';
+        if ( digit < first || digit > '9' )
+        {
+            return std::nullopt;
+        }
+        const auto offset = prefix == 'F' ? 0 : 9;
+        return static_cast<Token>( offset + digit - first );
+    }
+
+    std::vector<Token> parseKeyboardInputsToTokens( const std::string& inputs )
+    {
+        std::vector<Token> tokens{};
+
+        for ( auto ch = inputs.begin(), end = inputs.end(); ch != end; ++ch )
+        {
+            const auto c = static_cast<unsigned char>( *ch );
+            if ( std::islower( c ) || std::isdigit( c ) )
+            {
+                tokens.push_back( static_cast<Token>( *ch ) );
+                continue;
+            }
+            if ( *ch == '^' || *ch == '*' || *ch == '>' || *ch == '#' )
+            {
+                tokens.push_back( Token::TOKEN_NO_KEYUP_NEXT );
+                tokens.push_back(
+                    *ch == '^'   ? Token::MODIFIER_CTRL
+                    : *ch == '*' ? Token::MODIFIER_ALT
+                    : *ch == '>' ? Token::MODIFIER_SHIFT
+                                 : Token::MODIFIER_SUPER );
+                continue;
+            }
+            if ( std::isspace( c ) )
+            {
+                tokens.push_back( Token::TOKEN_NEW_SEQUENCE );
+            }
+            if ( !std::isupper( c ) || std::isspace( c ) )
+            {
+                continue;
+            }
+
+            if ( *ch == 'F' || *ch == 'G' )
+            {
+                const auto prefix = *ch;
+                ++ch;
+                if ( ch == end )
+                {
+                    break;
+                }
+                const auto token = getFunctionKey( prefix, *ch );
+                if ( !token.has_value() )
+                {
+                    break;
+                }
+                tokens.push_back( *token );
+                continue;
+            }
+
+            std::string characters;
+            characters.push_back( *ch );
+            while ( ch + 1 != end )
+            {
+                ++ch;
+                characters.push_back( *ch );
+                if ( const auto token = getCapitalLiteral( characters );
+                     token.has_value() )
+                {
+                    tokens.push_back( *token );
+                    break;
+                }
+            }
+            if ( ch == end )
+            {
+                break;
+            }
+        }
+
+        return tokens;
+    }
+} // namespace reference
+
+// A few kilobytes of typical shortcuts.
+std::string throughputInput()
+{
+    std::string input;
+    while ( input.size() < 4096 )
+    {
+        input += "^>m *TAB BACKSPACE F5 G2 hello world #d ";
+    }
+    return input;
+}
+} // namespace
 
 class ParserTest : public QObject
 {
@@ -42,6 +253,36 @@ private slots:
     void removeDuplicateModifiers();
 
     void removeIncorrectTokensBenchmark();
+
+    void macroSendsLikeTokens();
+
+    void macroDelays();
+
+    void macroRepeats();
+
+    void macroStopsAtMalformedDirectives();
+
+    void macroRepeatsAreLimited();
+
+    void macroCacheOnlyCompilesChanges();
+
+    void parseAndSendBenchmark();
+
+    void cachedMacroBenchmark();
+
+    void lexerMatchesParserFuzzed();
+
+    void lexerStaysInBufferFuzzed();
+
+    void lexerErrorPositions();
+
+    void macroErrorPositions();
+
+    void lexSixtyfourBackspacesBenchmark();
+
+    void lexThroughputBenchmark();
+
+    void parseThroughputBenchmark();
 };
 
 const std::string alphabet = "abcdefghijklmnopqrstuvxyz";
@@ -492,6 +733,296 @@ void ParserTest::removeIncorrectTokensBenchmark()
     }
 }
 
+void ParserTest::macroSendsLikeTokens()
+{
+    const auto macro = keyboard_macro::compileMacro( "^c >ab", fakeKeyCode );
+    const auto e = std::vector<keyboard_macro::MacroOp>{
+        down( Token::MODIFIER_CTRL ), down( Token::KEY_c ),
+        up( Token::KEY_c ),           up( Token::MODIFIER_CTRL ),
+        down( Token::MODIFIER_SHIFT ), down( Token::KEY_a ),
+        up( Token::KEY_a ),           down( Token::KEY_b ),
+        up( Token::KEY_b ),           up( Token::MODIFIER_SHIFT ),
+    };
+    QVERIFY( macro.ops == e );
+    QCOMPARE( macro.firstKeyCode, fakeKeyCode( Token::MODIFIER_CTRL ) );
+    QVERIFY( !macro.hasDelays() );
+
+    QCOMPARE( keyboard_macro::compileMacro( "F9", fakeKeyCode ).firstKeyCode,
+              fakeKeyCode( Token::KEY_F9 ) );
+    QCOMPARE( keyboard_macro::compileMacro( "", fakeKeyCode ).firstKeyCode,
+              0u );
+}
+
+void ParserTest::macroDelays()
+{
+    auto e = std::vector<keyboard_macro::MacroOp>{
+        down( Token::KEY_a ),
+        up( Token::KEY_a ),
+        down( Token::KEY_b, 250 ),
+        up( Token::KEY_b ),
+    };
+    QVERIFY( compileOps( "a[250]b" ) == e );
+    QVERIFY( keyboard_macro::compileMacro( "a[250]b", fakeKeyCode )
+                 .hasDelays() );
+
+    // Delays add up and modifiers stay held across them.
+    e = std::vector<keyboard_macro::MacroOp>{
+        down( Token::MODIFIER_CTRL ),
+        down( Token::KEY_c, 30 ),
+        up( Token::KEY_c ),
+        up( Token::MODIFIER_CTRL ),
+    };
+    QVERIFY( compileOps( "^[10][20]c" ) == e );
+
+    // Nothing is left to wait for at the end.
+    QCOMPARE( compileOps( "a[100]" ).size(), std::size_t{ 2 } );
+}
+
+void ParserTest::macroRepeats()
+{
+    auto e = std::vector<keyboard_macro::MacroOp>{
+        down( Token::KEY_BACKSPACE ), up( Token::KEY_BACKSPACE ),
+        down( Token::KEY_BACKSPACE ), up( Token::KEY_BACKSPACE ),
+        down( Token::KEY_BACKSPACE ), up( Token::KEY_BACKSPACE ),
+    };
+    QVERIFY( compileOps( "BACKSPACE{3}" ) == e );
+
+    // Only the sequence since the last space is repeated, held modifiers
+    // are released each time.
+    e = std::vector<keyboard_macro::MacroOp>{
+        down( Token::KEY_a ),          up( Token::KEY_a ),
+        down( Token::MODIFIER_CTRL ),  down( Token::KEY_v ),
+        up( Token::KEY_v ),            up( Token::MODIFIER_CTRL ),
+        down( Token::MODIFIER_CTRL ),  down( Token::KEY_v ),
+        up( Token::KEY_v ),            up( Token::MODIFIER_CTRL ),
+    };
+    QVERIFY( compileOps( "a ^v{2}" ) == e );
+
+    // A delay at the end of the sequence is repeated as well.
+    const auto ops = compileOps( "a[50]{2}b" );
+    QCOMPARE( ops.size(), std::size_t{ 8 } );
+    QCOMPARE( ops[2], ( keyboard_macro::MacroOp{ 0, false, 50 } ) );
+    QCOMPARE( ops[5], ( keyboard_macro::MacroOp{ 0, false, 50 } ) );
+    QCOMPARE( ops[6], down( Token::KEY_b ) );
+
+    QVERIFY( compileOps( "a{1}" ) == compileOps( "a" ) );
+}
+
+void ParserTest::macroStopsAtMalformedDirectives()
+{
+    const auto a = compileOps( "a" );
+    QVERIFY( compileOps( "a[x]b" ) == a );
+    QVERIFY( compileOps( "a[]b" ) == a );
+    QVERIFY( compileOps( "a[100b" ) == a );
+    QVERIFY( compileOps( "a{101}b" ) == a );
+    QVERIFY( compileOps( "a{0}b" ) == a );
+    QVERIFY( compileOps( "a[10001]b" ) == a );
+}
+
+void ParserTest::macroRepeatsAreLimited()
+{
+    const auto ops = compileOps( std::string( 64, 'a' ) + "{100}" );
+    QVERIFY( ops.size() <= keyboard_macro::k_maxOps );
+    QCOMPARE( ops.size() % 128, std::size_t{ 0 } );
+}
+
+void ParserTest::macroCacheOnlyCompilesChanges()
+{
+    keyboard_macro::MacroCache cache( countingKeyCode );
+    resolveCount = 0;
+
+    QCOMPARE( cache.get( "^c" ).ops.size(), std::size_t{ 4 } );
+    const auto compiled = resolveCount;
+    QVERIFY( compiled > 0 );
+
+    cache.get( "^c" );
+    cache.get( "^c" );
+    QCOMPARE( resolveCount, compiled );
+
+    QCOMPARE( cache.get( "^v" ).ops.size(), std::size_t{ 4 } );
+    QVERIFY( resolveCount > compiled );
+}
+
+// Parsing and resolving a shortcut, what every press paid before macros were
+// cached.
+void ParserTest::parseAndSendBenchmark()
+{
+    const std::string shortcut = "^>m [50] *TAB BACKSPACE{4}";
+    QBENCHMARK
+    {
+        const auto macro
+            = keyboard_macro::compileMacro( shortcut, fakeKeyCode );
+        QVERIFY( !macro.ops.empty() );
+    }
+}
+
+void ParserTest::cachedMacroBenchmark()
+{
+    const std::string shortcut = "^>m [50] *TAB BACKSPACE{4}";
+    keyboard_macro::MacroCache cache( fakeKeyCode );
+    cache.get( shortcut );
+    QBENCHMARK
+    {
+        QVERIFY( !cache.get( shortcut ).ops.empty() );
+    }
+}
+
+void ParserTest::lexerMatchesParserFuzzed()
+{
+    std::mt19937 random( 46 );
+    for ( int i = 0; i < 20000; ++i )
+    {
+        const auto shortcut = randomShortcut( random );
+        const auto e = removeIncorrectTokens(
+            reference::parseKeyboardInputsToTokens( shortcut ) );
+        if ( lexToVector( shortcut ) != e )
+        {
+            QFAIL( ( "Lexer and parser differ for: " + shortcut ).c_str() );
+        }
+    }
+}
+
+void ParserTest::lexerStaysInBufferFuzzed()
+{
+    std::mt19937 random( 4646 );
+    std::uniform_int_distribution<std::size_t> capacity( 0, 8 );
+    constexpr std::size_t guard = 4;
+    for ( int i = 0; i < 20000; ++i )
+    {
+        const auto shortcut = randomShortcut( random );
+        const auto full = lexToVector( shortcut );
+        const auto size = capacity( random );
+
+        std::vector<Token> buffer( size + guard, Token::KEY_BACKSLASH );
+        const auto result
+            = lexKeyboardInputs( shortcut, buffer.data(), size );
+        QVERIFY( result.count <= size );
+        QVERIFY( std::equal( buffer.begin(),
+                             buffer.begin()
+                                 + static_cast<std::ptrdiff_t>( result.count ),
+                             full.begin() ) );
+        QVERIFY( std::all_of(
+            buffer.begin() + static_cast<std::ptrdiff_t>( size ),
+            buffer.end(),
+            []( Token t ) { return t == Token::KEY_BACKSLASH; } ) );
+        if ( result.count < full.size() )
+        {
+            QVERIFY( !result.ok() );
+        }
+        QVERIFY( result.errorPosition <= shortcut.size() );
+    }
+}
+
+void ParserTest::lexerErrorPositions()
+{
+    std::array<Token, 16> buffer;
+    const auto lex = [&buffer]( const std::string& text,
+                                const std::size_t capacity = 16 ) {
+        return lexKeyboardInputs( text, buffer.data(), capacity );
+    };
+
+    auto result = lex( "^c F5 ENTER" );
+    QVERIFY( result.ok() );
+    QCOMPARE( result.count, std::size_t{ 7 } );
+
+    // Unknown characters are skipped, only the first one is reported.
+    result = lex( "ab?c!" );
+    QCOMPARE( result.error, LexError::UnknownCharacter );
+    QCOMPARE( result.errorPosition, std::size_t{ 2 } );
+    QCOMPARE( result.count, std::size_t{ 3 } );
+    QCOMPARE( buffer[2], Token::KEY_c );
+
+    result = lex( "ab F0c" );
+    QCOMPARE( result.error, LexError::BadFunctionKey );
+    QCOMPARE( result.errorPosition, std::size_t{ 3 } );
+    QCOMPARE( result.count, std::size_t{ 3 } );
+
+    result = lex( "aG" );
+    QCOMPARE( result.error, LexError::BadFunctionKey );
+    QCOMPARE( result.errorPosition, std::size_t{ 1 } );
+
+    result = lex( "a?BACKSPAC" );
+    QCOMPARE( result.error, LexError::UnknownCharacter );
+    QCOMPARE( result.count, std::size_t{ 1 } );
+
+    result = lex( "a BACKSPAC b" );
+    QCOMPARE( result.error, LexError::UnknownKeyName );
+    QCOMPARE( result.errorPosition, std::size_t{ 2 } );
+    QCOMPARE( result.count, std::size_t{ 2 } );
+
+    // A modifier needs room for two tokens.
+    result = lex( "^^^", 3 );
+    QCOMPARE( result.error, LexError::BufferFull );
+    QCOMPARE( result.errorPosition, std::size_t{ 1 } );
+    QCOMPARE( result.count, std::size_t{ 2 } );
+
+    QVERIFY( std::string( lexErrorMessage( LexError::UnknownKeyName ) )
+             != lexErrorMessage( LexError::None ) );
+}
+
+void ParserTest::macroErrorPositions()
+{
+    auto macro = keyboard_macro::compileMacro( "a[10]b?c", fakeKeyCode );
+    QVERIFY( macro.error.has_value() );
+    QCOMPARE( macro.error->position, std::size_t{ 6 } );
+    QCOMPARE( macro.ops.size(), std::size_t{ 6 } );
+
+    macro = keyboard_macro::compileMacro( "a{2}b[x]c", fakeKeyCode );
+    QVERIFY( macro.error.has_value() );
+    QCOMPARE( macro.error->position, std::size_t{ 5 } );
+
+    // A lex error ends the macro like a malformed directive does.
+    macro = keyboard_macro::compileMacro( "a[10]TABX[10]b", fakeKeyCode );
+    QVERIFY( macro.error.has_value() );
+    QCOMPARE( macro.error->position, std::size_t{ 8 } );
+    QVERIFY( macro.ops == compileOps( "a[10]TAB" ) );
+
+    QVERIFY( !keyboard_macro::compileMacro( "^c [50] TAB{3}", fakeKeyCode )
+                  .error.has_value() );
+}
+
+void ParserTest::lexSixtyfourBackspacesBenchmark()
+{
+    const auto input = [] {
+        std::string backspaces;
+        for ( int i = 0; i < 64; ++i )
+        {
+            backspaces += "BACKSPACE";
+        }
+        return backspaces;
+    }();
+    std::array<Token, 64> buffer;
+    QCOMPARE( lexKeyboardInputs( input, buffer.data(), buffer.size() ).count,
+              std::size_t{ 64 } );
+
+    QBENCHMARK
+    {
+        lexKeyboardInputs( input, buffer.data(), buffer.size() );
+    }
+}
+
+void ParserTest::lexThroughputBenchmark()
+{
+    const auto input = throughputInput();
+    std::vector<Token> buffer( lexBufferSize( input.size() ) );
+    QVERIFY( lexKeyboardInputs( input, buffer.data(), buffer.size() ).ok() );
+
+    QBENCHMARK
+    {
+        lexKeyboardInputs( input, buffer.data(), buffer.size() );
+    }
+}
+
+// The same input the old way, for comparison with lexThroughputBenchmark().
+void ParserTest::parseThroughputBenchmark()
+{
+    const auto input = throughputInput();
+    QBENCHMARK
+    {
+        removeIncorrectTokens( ParseKeyboardInputsToTokens( input ) );
+    }
+}
+
 QTEST_APPLESS_MAIN( ParserTest )
 
 #include "./release/tst_parsertest.moc"
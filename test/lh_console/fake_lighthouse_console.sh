@@ -0,0 +1,33 @@
+#!/bin/sh
+# Stands in for an interactive lighthouse_console session in the tests.
+# FAKE_LH_RECEIVERS lists the receivers as RX=TX pairs, an empty TX is an
+# unpaired receiver. With FAKE_LH_IGNORE_EXIT set the console doesn't exit
+# when asked to.
+
+echo "lighthouse_console: Tracker (fake)"
+echo "Attached lighthouse receiver devices:"
+for pair in $FAKE_LH_RECEIVERS; do
+    printf '\t%s\n' "${pair%%=*}"
+done
+printf 'lighthouse_console: '
+
+while read -r command serial; do
+    case "$command" in
+    serial)
+        echo "lighthouse_console: Connected to receiver $serial"
+        for pair in $FAKE_LH_RECEIVERS; do
+            if [ "${pair%%=*}" = "$serial" ] && [ -n "${pair#*=}" ]; then
+                echo "${pair#*=}: Connected to receiver $serial"
+            fi
+        done
+        ;;
+    exit)
+        [ -n "$FAKE_LH_IGNORE_EXIT" ] || exit 0
+        ;;
+    esac
+    printf 'lighthouse_console: '
+done
+
+if [ -n "$FAKE_LH_IGNORE_EXIT" ]; then
+    exec sleep 60
+fi
@@ -0,0 +1,23 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE
+DEFINES += FAKE_CONSOLE_PATH=\\\"$$PWD/fake_lighthouse_console.sh\\\"
+
+INCLUDEPATH += ../../src/openvr \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_lhconsoletest.cpp \
+    ../../src/openvr/lh_console_parser.cpp \
+    ../../src/openvr/lh_console_util.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/openvr/lh_console_parser.h \
+    ../../src/openvr/lh_console_util.h
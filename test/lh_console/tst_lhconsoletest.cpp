@@ -0,0 +1,185 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include <string>
+#include <vector>
+#include "lh_console_parser.h"
+#include "lh_console_util.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using lh_con_util::ConsoleOutputParser;
+using lh_con_util::ConsoleSession;
+using lh_con_util::LHCUtil;
+using Event = ConsoleOutputParser::Event;
+using Type = ConsoleOutputParser::Event::Type;
+
+namespace
+{
+const std::string k_startup = "lighthouse_console: Tracker\r\n"
+                              "Attached lighthouse receiver devices:\r\n"
+                              "\tLHR-1\r\n"
+                              "\tLHR-2\r\n"
+                              "lighthouse_console: ";
+
+std::vector<Event> feedAll( ConsoleOutputParser& parser,
+                            const std::vector<std::string>& chunks )
+{
+    std::vector<Event> events;
+    for ( const auto& chunk : chunks )
+    {
+        for ( auto& event : parser.feed( chunk ) )
+        {
+            events.push_back( std::move( event ) );
+        }
+    }
+    return events;
+}
+} // namespace
+
+class LhConsoleTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void listsReceiversUntilPrompt();
+    void joinsLinesSplitAcrossChunks();
+    void reportsConnectedSources();
+    void splitsPromptsFromFollowingOutput();
+
+    void scansFakeConsole();
+    void reportsMissingConsole();
+    void deletesSessionsAfterConsoleExits();
+    void killsConsoleThatDoesNotExit();
+};
+
+void LhConsoleTest::listsReceiversUntilPrompt()
+{
+    ConsoleOutputParser parser;
+    const auto events = parser.feed( k_startup );
+
+    const std::vector<Event> expected{ { Type::Receiver, "LHR-1" },
+                                       { Type::Receiver, "LHR-2" },
+                                       { Type::Prompt, "" } };
+    QVERIFY( events == expected );
+}
+
+void LhConsoleTest::joinsLinesSplitAcrossChunks()
+{
+    ConsoleOutputParser parser;
+    std::vector<std::string> chunks;
+    for ( std::size_t i = 0; i < k_startup.size(); i += 7 )
+    {
+        chunks.push_back( k_startup.substr( i, 7 ) );
+    }
+    const auto events = feedAll( parser, chunks );
+
+    QCOMPARE( events.size(), std::size_t{ 3 } );
+    QVERIFY( ( events[0] == Event{ Type::Receiver, "LHR-1" } ) );
+    QVERIFY( ( events[1] == Event{ Type::Receiver, "LHR-2" } ) );
+    QVERIFY( ( events[2] == Event{ Type::Prompt, "" } ) );
+}
+
+void LhConsoleTest::reportsConnectedSources()
+{
+    ConsoleOutputParser parser;
+    const auto events = feedAll(
+        parser,
+        { k_startup,
+          "lighthouse_console: Connected to receiver LHR-1\n",
+          "LHR-T1: Connected to receiver LHR-1\nlighthouse_console: " } );
+
+    QCOMPARE( events.size(), std::size_t{ 6 } );
+    QVERIFY( ( events[3] == Event{ Type::Connected, "lighthouse_console" } ) );
+    QVERIFY( ( events[4] == Event{ Type::Connected, "LHR-T1" } ) );
+    QVERIFY( ( events[5] == Event{ Type::Prompt, "" } ) );
+}
+
+void LhConsoleTest::splitsPromptsFromFollowingOutput()
+{
+    ConsoleOutputParser parser;
+    const auto events = parser.feed(
+        "lighthouse_console: lighthouse_console: Connected to receiver LHR-1\n"
+        "lighthouse_console: Tracker\n" );
+
+    const std::vector<Event> expected{
+        { Type::Prompt, "" }, { Type::Connected, "lighthouse_console" } };
+    QVERIFY( events == expected );
+}
+
+void LhConsoleTest::scansFakeConsole()
+{
+#ifdef Q_OS_WIN
+    QSKIP( "The fake console is a shell script." );
+#endif
+    qputenv( "FAKE_LH_RECEIVERS", "LHR-1=LHR-T1 LHR-2= LHR-3=LHR-T3" );
+
+    LHCUtil util( FAKE_CONSOLE_PATH );
+    QSignalSpy receivers( &util, SIGNAL( receiverFound( QString ) ) );
+    QSignalSpy transmitters(
+        &util, SIGNAL( transmitterFound( QString, QString ) ) );
+    QSignalSpy finished( &util, SIGNAL( scanFinished( bool ) ) );
+
+    util.scan();
+    QVERIFY( util.isScanning() );
+    QVERIFY( finished.wait( 10000 ) );
+
+    QVERIFY( !util.isScanning() );
+    QCOMPARE( finished.at( 0 ).at( 0 ).toBool(), true );
+    QCOMPARE( receivers.count(), 3 );
+    QCOMPARE( transmitters.count(), 3 );
+    QCOMPARE( util.GetLinkedTX( "LHR-1" ), QString( "LHR-T1" ) );
+    QCOMPARE( util.GetLinkedTX( "LHR-2" ), QString( "" ) );
+    QCOMPARE( util.GetLinkedRX( "LHR-T3" ), QString( "LHR-3" ) );
+    QVERIFY( util.RXTX_Pairs_[1].Is_Init );
+    QVERIFY( !util.RXTX_Pairs_[1].Is_Paired );
+}
+
+void LhConsoleTest::reportsMissingConsole()
+{
+    LHCUtil util( "does-not-exist/lighthouse_console" );
+    QSignalSpy finished( &util, SIGNAL( scanFinished( bool ) ) );
+
+    util.scan();
+    QVERIFY( finished.count() == 1 || finished.wait( 10000 ) );
+    QCOMPARE( finished.at( 0 ).at( 0 ).toBool(), false );
+}
+
+void LhConsoleTest::deletesSessionsAfterConsoleExits()
+{
+#ifdef Q_OS_WIN
+    QSKIP( "The fake console is a shell script." );
+#endif
+    qputenv( "FAKE_LH_RECEIVERS", "LHR-1=LHR-T1 LHR-2=LHR-T2" );
+
+    LHCUtil util( FAKE_CONSOLE_PATH );
+    QSignalSpy finished( &util, SIGNAL( scanFinished( bool ) ) );
+    util.scan();
+    QVERIFY( finished.wait( 10000 ) );
+
+    QTRY_COMPARE( util.findChildren<ConsoleSession*>().size(), 0 );
+}
+
+void LhConsoleTest::killsConsoleThatDoesNotExit()
+{
+#ifdef Q_OS_WIN
+    QSKIP( "The fake console is a shell script." );
+#endif
+    qputenv( "FAKE_LH_RECEIVERS", "LHR-1=LHR-T1" );
+    qputenv( "FAKE_LH_IGNORE_EXIT", "1" );
+
+    LHCUtil util( FAKE_CONSOLE_PATH );
+    QSignalSpy finished( &util, SIGNAL( scanFinished( bool ) ) );
+    util.scan();
+    QVERIFY( finished.wait( 10000 ) );
+    qunsetenv( "FAKE_LH_IGNORE_EXIT" );
+
+    // Still waiting for the console, not blocked in ~QProcess.
+    QCOMPARE( util.findChildren<ConsoleSession*>().size(), 1 );
+    QTRY_COMPARE_WITH_TIMEOUT( util.findChildren<ConsoleSession*>().size(),
+                               0,
+                               2 * ConsoleSession::k_exitTimeoutMs );
+}
+
+QTEST_GUILESS_MAIN( LhConsoleTest )
+
+#include "tst_lhconsoletest.moc"
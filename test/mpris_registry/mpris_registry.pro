@@ -0,0 +1,21 @@
+QT += testlib dbus
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE ELPP_QT_LOGGING
+
+INCLUDEPATH += ../../src/media_keys \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_mprisregistrytest.cpp \
+    ../../src/media_keys/mpris_registry.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/media_keys/mpris_registry.h \
+    ../../src/media_keys/now_playing.h
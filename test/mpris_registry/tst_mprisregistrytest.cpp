@@ -0,0 +1,399 @@
+#include <QtTest>
+#include <QProcess>
+#include <QtDBus/QtDBus>
+#include <easylogging++.h>
+#include <memory>
+#include "mpris_registry.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+// A media player on its own bus connection, so it has its own unique name
+// like a real player process.
+class FakePlayer : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO( "D-Bus Interface", "org.mpris.MediaPlayer2.Player" )
+    Q_PROPERTY( QString PlaybackStatus READ playbackStatus )
+    Q_PROPERTY( QVariantMap Metadata READ metadata )
+    Q_PROPERTY( qlonglong Position READ position )
+
+public:
+    FakePlayer( const QString& address,
+                const QString& name,
+                const QString& status = "Stopped" )
+        : m_connectionName( "player-" + name ),
+          m_connection(
+              QDBusConnection::connectToBus( address, m_connectionName ) ),
+          m_status( status )
+    {
+        m_connection.registerObject(
+            mpris::k_objectPath,
+            this,
+            QDBusConnection::ExportAllSlots
+                | QDBusConnection::ExportAllProperties );
+        m_connection.registerService( mpris::k_servicePrefix + name );
+    }
+
+    ~FakePlayer() override
+    {
+        QDBusConnection::disconnectFromBus( m_connectionName );
+    }
+
+    QString playbackStatus() const
+    {
+        return m_status;
+    }
+
+    QVariantMap metadata() const
+    {
+        return m_metadata;
+    }
+
+    qlonglong position() const
+    {
+        return m_position;
+    }
+
+    void setPlaybackStatus( const QString& status )
+    {
+        m_status = status;
+        sendPropertiesChanged( { { "PlaybackStatus", status } } );
+    }
+
+    // Like most players, the new Position is only there to be asked for.
+    void setTrack( const QString& title,
+                   const QStringList& artists,
+                   const qlonglong length,
+                   const qlonglong position = 0 )
+    {
+        m_metadata = QVariantMap{ { "xesam:title", title },
+                                  { "xesam:artist", artists },
+                                  { "mpris:length", length } };
+        m_position = position;
+        sendPropertiesChanged( { { "Metadata", m_metadata } } );
+    }
+
+    void seek( const qlonglong position )
+    {
+        m_position = position;
+        auto signal = QDBusMessage::createSignal(
+            mpris::k_objectPath, mpris::k_playerInterface, "Seeked" );
+        signal << position;
+        m_connection.send( signal );
+    }
+
+    QStringList calls;
+
+public slots:
+    void Next()
+    {
+        calls << "Next";
+    }
+    void Previous()
+    {
+        calls << "Previous";
+    }
+    void PlayPause()
+    {
+        calls << "PlayPause";
+    }
+    void Stop()
+    {
+        calls << "Stop";
+    }
+
+private:
+    void sendPropertiesChanged( const QVariantMap& changed )
+    {
+        auto signal = QDBusMessage::createSignal(
+            mpris::k_objectPath,
+            "org.freedesktop.DBus.Properties",
+            "PropertiesChanged" );
+        signal << QString( mpris::k_playerInterface ) << changed
+               << QStringList();
+        m_connection.send( signal );
+    }
+
+    QString m_connectionName;
+    QDBusConnection m_connection;
+    QString m_status;
+    QVariantMap m_metadata;
+    qlonglong m_position = 0;
+};
+
+class MprisRegistryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void findsPlayersAtStart();
+    void tracksPlayersComingAndGoing();
+    void ignoresOtherServices();
+    void callsEveryPlayerWhileNoneIsActive();
+    void callsTheMostRecentlyActivePlayer();
+    void playerPlayingAtStartIsActive();
+    void callsBeforeTheListArriveAreSent();
+    void callsDoNotWaitForPlayers();
+    void nowPlayingIsFetchedAtStart();
+    void nowPlayingFollowsTrackChanges();
+    void nowPlayingFollowsTheActivePlayer();
+    void seekedMovesThePosition();
+
+private:
+    std::unique_ptr<mpris::PlayerRegistry> makeRegistry();
+
+    QProcess m_daemon;
+    QString m_address;
+    int m_connections = 0;
+};
+
+// Everything runs against a private bus, the session's players are never
+// touched.
+void MprisRegistryTest::initTestCase()
+{
+    m_daemon.start( "dbus-daemon",
+                    { "--session", "--nofork", "--print-address" } );
+    if ( !m_daemon.waitForStarted() )
+    {
+        QSKIP( "dbus-daemon is not available." );
+    }
+    QVERIFY( m_daemon.waitForReadyRead( 5000 ) );
+    m_address = QString::fromUtf8( m_daemon.readLine() ).trimmed();
+    QVERIFY( !m_address.isEmpty() );
+}
+
+void MprisRegistryTest::cleanupTestCase()
+{
+    m_daemon.terminate();
+    m_daemon.waitForFinished();
+}
+
+void MprisRegistryTest::cleanup()
+{
+    for ( auto i = 0; i < m_connections; ++i )
+    {
+        QDBusConnection::disconnectFromBus( "registry-"
+                                            + QString::number( i ) );
+    }
+    m_connections = 0;
+}
+
+std::unique_ptr<mpris::PlayerRegistry> MprisRegistryTest::makeRegistry()
+{
+    const auto name = "registry-" + QString::number( m_connections++ );
+    return std::make_unique<mpris::PlayerRegistry>(
+        QDBusConnection::connectToBus( m_address, name ) );
+}
+
+void MprisRegistryTest::findsPlayersAtStart()
+{
+    FakePlayer one( m_address, "one" );
+    FakePlayer two( m_address, "two" );
+
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+    auto players = registry->players();
+    players.sort();
+    QCOMPARE( players,
+              QStringList( { "org.mpris.MediaPlayer2.one",
+                             "org.mpris.MediaPlayer2.two" } ) );
+    QVERIFY( registry->activePlayer().isEmpty() );
+}
+
+void MprisRegistryTest::tracksPlayersComingAndGoing()
+{
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+    QVERIFY( registry->players().isEmpty() );
+
+    QSignalSpy changed( registry.get(),
+                        &mpris::PlayerRegistry::playersChanged );
+    auto player = std::make_unique<FakePlayer>( m_address, "late" );
+    QTRY_COMPARE( registry->players(),
+                  QStringList( { "org.mpris.MediaPlayer2.late" } ) );
+
+    player.reset();
+    QTRY_VERIFY( registry->players().isEmpty() );
+    QCOMPARE( changed.count(), 2 );
+}
+
+void MprisRegistryTest::ignoresOtherServices()
+{
+    auto other = QDBusConnection::connectToBus( m_address, "other" );
+    other.registerService( "org.example.NotAPlayer" );
+    FakePlayer player( m_address, "player" );
+
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+    QCOMPARE( registry->players(),
+              QStringList( { "org.mpris.MediaPlayer2.player" } ) );
+    QDBusConnection::disconnectFromBus( "other" );
+}
+
+void MprisRegistryTest::callsEveryPlayerWhileNoneIsActive()
+{
+    FakePlayer one( m_address, "one" );
+    FakePlayer two( m_address, "two" );
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+
+    registry->call( "Next" );
+    QTRY_COMPARE( one.calls, QStringList( { "Next" } ) );
+    QTRY_COMPARE( two.calls, QStringList( { "Next" } ) );
+}
+
+void MprisRegistryTest::callsTheMostRecentlyActivePlayer()
+{
+    FakePlayer one( m_address, "one" );
+    FakePlayer two( m_address, "two" );
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+
+    one.setPlaybackStatus( "Playing" );
+    QTRY_COMPARE( registry->activePlayer(),
+                  QString( "org.mpris.MediaPlayer2.one" ) );
+    two.setPlaybackStatus( "Playing" );
+    QTRY_COMPARE( registry->activePlayer(),
+                  QString( "org.mpris.MediaPlayer2.two" ) );
+
+    registry->call( "PlayPause" );
+    QTRY_COMPARE( two.calls, QStringList( { "PlayPause" } ) );
+
+    // Pausing keeps it the target, so the next press resumes it.
+    two.setPlaybackStatus( "Paused" );
+    registry->call( "PlayPause" );
+    QTRY_COMPARE( two.calls, QStringList( { "PlayPause", "PlayPause" } ) );
+    QVERIFY( one.calls.isEmpty() );
+
+    one.setPlaybackStatus( "Playing" );
+    QTRY_COMPARE( registry->activePlayer(),
+                  QString( "org.mpris.MediaPlayer2.one" ) );
+    registry->call( "Stop" );
+    QTRY_COMPARE( one.calls, QStringList( { "Stop" } ) );
+    QCOMPARE( two.calls.size(), 2 );
+}
+
+void MprisRegistryTest::playerPlayingAtStartIsActive()
+{
+    FakePlayer idle( m_address, "idle" );
+    FakePlayer playing( m_address, "playing", "Playing" );
+    const auto registry = makeRegistry();
+
+    QTRY_COMPARE( registry->activePlayer(),
+                  QString( "org.mpris.MediaPlayer2.playing" ) );
+    registry->call( "Next" );
+    QTRY_COMPARE( playing.calls, QStringList( { "Next" } ) );
+    QVERIFY( idle.calls.isEmpty() );
+}
+
+void MprisRegistryTest::callsBeforeTheListArriveAreSent()
+{
+    FakePlayer player( m_address, "player" );
+    const auto registry = makeRegistry();
+    QVERIFY( !registry->ready() );
+
+    registry->call( "Previous" );
+    QTRY_COMPARE( player.calls, QStringList( { "Previous" } ) );
+}
+
+void MprisRegistryTest::callsDoNotWaitForPlayers()
+{
+    FakePlayer player( m_address, "player" );
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+
+    // The player runs on this thread, it can only answer once call()
+    // returned to the event loop.
+    registry->call( "Next" );
+    QVERIFY( player.calls.isEmpty() );
+    QTRY_COMPARE( player.calls, QStringList( { "Next" } ) );
+}
+
+void MprisRegistryTest::nowPlayingIsFetchedAtStart()
+{
+    FakePlayer player( m_address, "player", "Playing" );
+    player.setTrack( "Title", { "One", "Two" }, 180000000, 42000000 );
+    const auto registry = makeRegistry();
+
+    QTRY_COMPARE( registry->nowPlaying().title, QString( "Title" ) );
+    const auto track = registry->nowPlaying();
+    QCOMPARE( track.artist, QString( "One, Two" ) );
+    QCOMPARE( track.length, Q_INT64_C( 180000000 ) );
+    QVERIFY( track.playing );
+    QVERIFY( track.lastPosition >= 42000000 );
+    QVERIFY( track.positionAt( track.lastPositionTime
+                               + std::chrono::seconds( 1 ) )
+             >= 43000000 );
+}
+
+void MprisRegistryTest::nowPlayingFollowsTrackChanges()
+{
+    FakePlayer player( m_address, "player", "Playing" );
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( !registry->activePlayer().isEmpty() );
+    QTRY_VERIFY( registry->nowPlaying().playing );
+
+    QSignalSpy changed( registry.get(),
+                        &mpris::PlayerRegistry::nowPlayingChanged );
+    player.setTrack( "Next", { "Artist" }, 60000000, 5000000 );
+    QTRY_COMPARE( registry->nowPlaying().title, QString( "Next" ) );
+    // The position of the new track is asked for once.
+    QTRY_VERIFY( registry->nowPlaying().lastPosition >= 5000000 );
+
+    player.setPlaybackStatus( "Paused" );
+    QTRY_VERIFY( !registry->nowPlaying().playing );
+    const auto paused = registry->nowPlaying();
+    QCOMPARE( paused.positionAt( paused.lastPositionTime
+                                 + std::chrono::seconds( 10 ) ),
+              paused.lastPosition );
+    QVERIFY( changed.count() >= 3 );
+}
+
+void MprisRegistryTest::nowPlayingFollowsTheActivePlayer()
+{
+    FakePlayer one( m_address, "one" );
+    FakePlayer two( m_address, "two" );
+    one.setTrack( "First", { "A" }, 1000000 );
+    two.setTrack( "Second", { "B" }, 1000000 );
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+    // Nothing played yet, so there is nothing to show.
+    QVERIFY( registry->nowPlaying().empty() );
+
+    one.setPlaybackStatus( "Playing" );
+    QTRY_COMPARE( registry->nowPlaying().title, QString( "First" ) );
+    two.setPlaybackStatus( "Playing" );
+    QTRY_COMPARE( registry->nowPlaying().title, QString( "Second" ) );
+
+    // Changes of the other player don't concern the active one.
+    QSignalSpy changed( registry.get(),
+                        &mpris::PlayerRegistry::nowPlayingChanged );
+    one.setTrack( "Elsewhere", { "A" }, 1000000 );
+    two.seek( 1 );
+    QTRY_COMPARE( changed.count(), 1 );
+    QTest::qWait( 100 );
+    QCOMPARE( changed.count(), 1 );
+    QCOMPARE( registry->nowPlaying().title, QString( "Second" ) );
+}
+
+void MprisRegistryTest::seekedMovesThePosition()
+{
+    FakePlayer player( m_address, "player" );
+    player.setTrack( "Title", { "Artist" }, 300000000 );
+    const auto registry = makeRegistry();
+    QTRY_VERIFY( registry->ready() );
+    player.setPlaybackStatus( "Playing" );
+    QTRY_VERIFY( registry->nowPlaying().playing );
+
+    player.seek( 120000000 );
+    QTRY_VERIFY( registry->nowPlaying().lastPosition >= 120000000 );
+    QVERIFY( registry->nowPlaying().lastPosition < 130000000 );
+}
+
+QTEST_GUILESS_MAIN( MprisRegistryTest )
+
+#include "tst_mprisregistrytest.moc"
@@ -0,0 +1,20 @@
+QT += testlib
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../src/tabcontrollers/nowplaying \
+    ../../src/media_keys \
+    ../../src/utils
+
+SOURCES +=  tst_nowplayingtest.cpp \
+    ../../src/tabcontrollers/nowplaying/NowPlayingView.cpp \
+    ../../src/utils/GlyphAtlas.cpp
+
+HEADERS += \
+    ../../src/tabcontrollers/nowplaying/NowPlayingView.h \
+    ../../src/media_keys/now_playing.h \
+    ../../src/utils/GlyphAtlas.h
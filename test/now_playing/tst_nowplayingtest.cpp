@@ -0,0 +1,147 @@
+#include <QtTest>
+#include <QPainter>
+#include <chrono>
+#include "GlyphAtlas.h"
+#include "NowPlayingView.h"
+#include "now_playing.h"
+
+using advsettings::formatPlaybackTime;
+using advsettings::NowPlayingView;
+using keyboardinput::NowPlaying;
+using namespace std::chrono_literals;
+
+class NowPlayingTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void formatsPlaybackTime();
+    void positionIsExtrapolated();
+
+    void atlasRasterizesGlyphsOnce();
+    void atlasCutsLongText();
+
+    void viewRedrawsOnlyWhenItChanges();
+    void viewReusesGlyphs();
+
+private:
+    static NowPlaying track( const bool playing );
+};
+
+NowPlaying NowPlayingTest::track( const bool playing )
+{
+    NowPlaying track;
+    track.title = "A Title";
+    track.artist = "An Artist";
+    track.length = 200000000;
+    track.lastPosition = 10000000;
+    track.lastPositionTime = NowPlaying::Clock::time_point( 1h );
+    track.playing = playing;
+    return track;
+}
+
+void NowPlayingTest::formatsPlaybackTime()
+{
+    QCOMPARE( formatPlaybackTime( 0 ), QString( "0:00" ) );
+    QCOMPARE( formatPlaybackTime( 999999 ), QString( "0:00" ) );
+    QCOMPARE( formatPlaybackTime( 61000000 ), QString( "1:01" ) );
+    QCOMPARE( formatPlaybackTime( Q_INT64_C( 3723000000 ) ),
+              QString( "1:02:03" ) );
+    QCOMPARE( formatPlaybackTime( -5000000 ), QString( "0:00" ) );
+}
+
+void NowPlayingTest::positionIsExtrapolated()
+{
+    auto playing = track( true );
+    const auto start = playing.lastPositionTime;
+    QCOMPARE( playing.positionAt( start ), Q_INT64_C( 10000000 ) );
+    QCOMPARE( playing.positionAt( start + 2s ), Q_INT64_C( 12000000 ) );
+    // Never before the last report, nor past the end.
+    QCOMPARE( playing.positionAt( start - 2s ), Q_INT64_C( 10000000 ) );
+    QCOMPARE( playing.positionAt( start + 1h ), playing.length );
+
+    playing.rate = 2.0;
+    QCOMPARE( playing.positionAt( start + 2s ), Q_INT64_C( 14000000 ) );
+
+    const auto paused = track( false );
+    QCOMPARE( paused.positionAt( start + 2s ), Q_INT64_C( 10000000 ) );
+}
+
+void NowPlayingTest::atlasRasterizesGlyphsOnce()
+{
+    QImage image( 200, 50, QImage::Format_ARGB32_Premultiplied );
+    QPainter painter( &image );
+    GlyphAtlas atlas( QFont(), Qt::white );
+
+    atlas.draw( painter, { 0, 0 }, "aab", 200 );
+    QCOMPARE( atlas.rasterizedCount(), 2 );
+    atlas.draw( painter, { 0, 20 }, "ba", 200 );
+    QCOMPARE( atlas.rasterizedCount(), 2 );
+    QCOMPARE( atlas.width( "ab" ), atlas.width( "a" ) + atlas.width( "b" ) );
+}
+
+void NowPlayingTest::atlasCutsLongText()
+{
+    QImage image( 400, 50, QImage::Format_ARGB32_Premultiplied );
+    QPainter painter( &image );
+    GlyphAtlas atlas( QFont(), Qt::white );
+
+    const QString text( "A rather long title that won't fit" );
+    const auto fullWidth = atlas.width( text );
+    QCOMPARE( atlas.draw( painter, { 0, 0 }, text, fullWidth ), fullWidth );
+
+    // Measuring rasterized everything but the ellipsis.
+    const auto rasterized = atlas.rasterizedCount();
+    const auto maxWidth = fullWidth / 2;
+    const auto drawn = atlas.draw( painter, { 0, 0 }, text, maxWidth );
+    QVERIFY( drawn <= maxWidth );
+    QVERIFY( drawn > 0 );
+    QCOMPARE( atlas.rasterizedCount(), rasterized + 1 );
+}
+
+void NowPlayingTest::viewRedrawsOnlyWhenItChanges()
+{
+    NowPlayingView view;
+    auto playing = track( true );
+    const auto start = playing.lastPositionTime;
+
+    QVERIFY( view.update( playing, start ) );
+    QCOMPARE( view.image().size(),
+              QSize( NowPlayingView::k_width, NowPlayingView::k_height ) );
+    // Same second, same everything.
+    QVERIFY( !view.update( playing, start + 300ms ) );
+    QVERIFY( view.update( playing, start + 1s ) );
+
+    playing.title = "Another Title";
+    QVERIFY( view.update( playing, start + 1s ) );
+    QVERIFY( !view.update( playing, start + 1s ) );
+
+    // A paused track never moves on.
+    auto paused = playing;
+    paused.playing = false;
+    QVERIFY( view.update( paused, start ) );
+    QVERIFY( !view.update( paused, start + 1min ) );
+}
+
+void NowPlayingTest::viewReusesGlyphs()
+{
+    NowPlayingView view;
+    const auto playing = track( true );
+    const auto start = playing.lastPositionTime;
+
+    // Every digit shows up within the first minute.
+    for ( auto second = 0; second < 60; ++second )
+    {
+        view.update( playing, start + std::chrono::seconds( second ) );
+    }
+    const auto rasterized = view.rasterizedCount();
+    for ( auto second = 60; second < 120; ++second )
+    {
+        view.update( playing, start + std::chrono::seconds( second ) );
+    }
+    QCOMPARE( view.rasterizedCount(), rasterized );
+}
+
+QTEST_MAIN( NowPlayingTest )
+
+#include "tst_nowplayingtest.moc"
@@ -0,0 +1,17 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../src/openvr \
+    ../../third-party/openvr/headers
+
+SOURCES +=  tst_settingscachetest.cpp \
+    ../../src/openvr/ovr_settings_cache.cpp
+
+HEADERS += \
+    ../../src/openvr/ovr_settings_cache.h
@@ -0,0 +1,302 @@
+#include <QtTest>
+#include <cstring>
+#include <map>
+#include <string>
+#include <variant>
+#include "ovr_settings_cache.h"
+
+using ovr_settings_wrapper::SettingsCache;
+
+namespace
+{
+// In-memory IVRSettings that counts how often it is asked for a value.
+class MockSettings : public vr::IVRSettings
+{
+public:
+    using Value = std::variant<bool, int32_t, float, std::string>;
+
+    const char* GetSettingsErrorNameFromEnum( vr::EVRSettingsError ) override
+    {
+        return "mock error";
+    }
+
+    void SetBool( const char* section,
+                  const char* key,
+                  bool value,
+                  vr::EVRSettingsError* error ) override
+    {
+        store( section, key, value, error );
+    }
+    void SetInt32( const char* section,
+                   const char* key,
+                   int32_t value,
+                   vr::EVRSettingsError* error ) override
+    {
+        store( section, key, value, error );
+    }
+    void SetFloat( const char* section,
+                   const char* key,
+                   float value,
+                   vr::EVRSettingsError* error ) override
+    {
+        store( section, key, value, error );
+    }
+    void SetString( const char* section,
+                    const char* key,
+                    const char* value,
+                    vr::EVRSettingsError* error ) override
+    {
+        store( section, key, std::string( value ), error );
+    }
+
+    bool GetBool( const char* section,
+                  const char* key,
+                  vr::EVRSettingsError* error ) override
+    {
+        return load<bool>( section, key, error );
+    }
+    int32_t GetInt32( const char* section,
+                      const char* key,
+                      vr::EVRSettingsError* error ) override
+    {
+        return load<int32_t>( section, key, error );
+    }
+    float GetFloat( const char* section,
+                    const char* key,
+                    vr::EVRSettingsError* error ) override
+    {
+        return load<float>( section, key, error );
+    }
+    void GetString( const char* section,
+                    const char* key,
+                    char* value,
+                    uint32_t valueLength,
+                    vr::EVRSettingsError* error ) override
+    {
+        const auto s = load<std::string>( section, key, error );
+        std::strncpy( value, s.c_str(), valueLength - 1 );
+        value[valueLength - 1] = '\0';
+    }
+
+    void RemoveSection( const char* section,
+                        vr::EVRSettingsError* error ) override
+    {
+        for ( auto it = values.begin(); it != values.end(); )
+        {
+            it = it->first.first == section ? values.erase( it ) : ++it;
+        }
+        setError( error, vr::VRSettingsError_None );
+    }
+    void RemoveKeyInSection( const char* section,
+                             const char* key,
+                             vr::EVRSettingsError* error ) override
+    {
+        values.erase( { section, key } );
+        setError( error, vr::VRSettingsError_None );
+    }
+
+    std::map<std::pair<std::string, std::string>, Value> values;
+    int reads = 0;
+    bool failWrites = false;
+
+private:
+    static void setError( vr::EVRSettingsError* out,
+                          const vr::EVRSettingsError error )
+    {
+        if ( out != nullptr )
+        {
+            *out = error;
+        }
+    }
+
+    template <typename T>
+    T load( const char* section, const char* key, vr::EVRSettingsError* error )
+    {
+        ++reads;
+        const auto it = values.find( { section, key } );
+        if ( it == values.end() || !std::holds_alternative<T>( it->second ) )
+        {
+            setError( error, vr::VRSettingsError_UnsetSettingHasNoDefault );
+            return T{};
+        }
+        setError( error, vr::VRSettingsError_None );
+        return std::get<T>( it->second );
+    }
+
+    void store( const char* section,
+                const char* key,
+                Value value,
+                vr::EVRSettingsError* error )
+    {
+        if ( failWrites )
+        {
+            setError( error, vr::VRSettingsError_WriteFailed );
+            return;
+        }
+        values[{ section, key }] = std::move( value );
+        setError( error, vr::VRSettingsError_None );
+    }
+};
+} // namespace
+
+class SettingsCacheTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void repeatedReadsHitTheCache();
+    void failedReadsAreNotCached();
+    void ownWritesUpdateTheCache();
+    void failedWritesDropTheValue();
+    void settingsEventsInvalidateTheirSection();
+    void removeDropsCachedValues();
+    void typeMismatchReadsAgain();
+    void missingBackendReportsAnError();
+};
+
+void SettingsCacheTest::repeatedReadsHitTheCache()
+{
+    MockSettings mock;
+    mock.values[{ "audio", "playbackMirrorDevice" }] = std::string( "hdmi" );
+    SettingsCache cache( [&mock] { return &mock; } );
+
+    for ( int i = 0; i < 10; ++i )
+    {
+        auto error = vr::VRSettingsError_WriteFailed;
+        QCOMPARE( cache.getString( "audio", "playbackMirrorDevice", &error ),
+                  std::string( "hdmi" ) );
+        QCOMPARE( error, vr::VRSettingsError_None );
+    }
+
+    QCOMPARE( mock.reads, 1 );
+    QCOMPARE( cache.misses(), uint64_t{ 1 } );
+    QCOMPARE( cache.hits(), uint64_t{ 9 } );
+}
+
+void SettingsCacheTest::failedReadsAreNotCached()
+{
+    MockSettings mock;
+    SettingsCache cache( [&mock] { return &mock; } );
+
+    auto error = vr::VRSettingsError_None;
+    cache.getBool( "steamvr", "missing", &error );
+    QCOMPARE( error, vr::VRSettingsError_UnsetSettingHasNoDefault );
+    cache.getBool( "steamvr", "missing", &error );
+    QCOMPARE( error, vr::VRSettingsError_UnsetSettingHasNoDefault );
+
+    QCOMPARE( mock.reads, 2 );
+    QCOMPARE( cache.hits(), uint64_t{ 0 } );
+}
+
+void SettingsCacheTest::ownWritesUpdateTheCache()
+{
+    MockSettings mock;
+    mock.values[{ "steamvr", "supersampleScale" }] = 1.0f;
+    SettingsCache cache( [&mock] { return &mock; } );
+
+    QCOMPARE( cache.getFloat( "steamvr", "supersampleScale" ), 1.0f );
+    cache.setFloat( "steamvr", "supersampleScale", 1.5f );
+
+    QCOMPARE( cache.getFloat( "steamvr", "supersampleScale" ), 1.5f );
+    QCOMPARE( std::get<float>( mock.values[{ "steamvr", "supersampleScale" }] ),
+              1.5f );
+    QCOMPARE( mock.reads, 1 );
+}
+
+void SettingsCacheTest::failedWritesDropTheValue()
+{
+    MockSettings mock;
+    mock.values[{ "steamvr", "motionSmoothing" }] = true;
+    SettingsCache cache( [&mock] { return &mock; } );
+
+    QVERIFY( cache.getBool( "steamvr", "motionSmoothing" ) );
+    mock.failWrites = true;
+    auto error = vr::VRSettingsError_None;
+    cache.setBool( "steamvr", "motionSmoothing", false, &error );
+    QCOMPARE( error, vr::VRSettingsError_WriteFailed );
+
+    QVERIFY( cache.getBool( "steamvr", "motionSmoothing" ) );
+    QCOMPARE( mock.reads, 2 );
+}
+
+void SettingsCacheTest::settingsEventsInvalidateTheirSection()
+{
+    MockSettings mock;
+    mock.values[{ vr::k_pch_CollisionBounds_Section, "fadeDistance" }] = 0.7f;
+    mock.values[{ vr::k_pch_SteamVR_Section, "supersampleScale" }] = 1.0f;
+    SettingsCache cache( [&mock] { return &mock; } );
+
+    cache.getFloat( vr::k_pch_CollisionBounds_Section, "fadeDistance" );
+    cache.getFloat( vr::k_pch_SteamVR_Section, "supersampleScale" );
+    QCOMPARE( mock.reads, 2 );
+
+    // Changed by another application.
+    mock.values[{ vr::k_pch_CollisionBounds_Section, "fadeDistance" }] = 0.2f;
+    cache.handleEvent( vr::VREvent_ChaperoneSettingsHaveChanged );
+
+    QCOMPARE(
+        cache.getFloat( vr::k_pch_CollisionBounds_Section, "fadeDistance" ),
+        0.2f );
+    cache.getFloat( vr::k_pch_SteamVR_Section, "supersampleScale" );
+    QCOMPARE( mock.reads, 3 );
+
+    // Events that aren't about settings change nothing.
+    cache.handleEvent( vr::VREvent_MouseMove );
+    cache.getFloat( vr::k_pch_SteamVR_Section, "supersampleScale" );
+    QCOMPARE( mock.reads, 3 );
+
+    // Events without a section drop everything.
+    cache.handleEvent( vr::VREvent_EnvironmentSettingsHaveChanged );
+    cache.getFloat( vr::k_pch_SteamVR_Section, "supersampleScale" );
+    QCOMPARE( mock.reads, 4 );
+}
+
+void SettingsCacheTest::removeDropsCachedValues()
+{
+    MockSettings mock;
+    mock.values[{ "audio", "a" }] = 1;
+    mock.values[{ "audio", "b" }] = 2;
+    SettingsCache cache( [&mock] { return &mock; } );
+
+    QCOMPARE( cache.getInt32( "audio", "a" ), 1 );
+    QCOMPARE( cache.getInt32( "audio", "b" ), 2 );
+
+    cache.removeKeyInSection( "audio", "a" );
+    auto error = vr::VRSettingsError_None;
+    cache.getInt32( "audio", "a", &error );
+    QCOMPARE( error, vr::VRSettingsError_UnsetSettingHasNoDefault );
+    QCOMPARE( cache.getInt32( "audio", "b" ), 2 );
+
+    cache.removeSection( "audio" );
+    cache.getInt32( "audio", "b", &error );
+    QCOMPARE( error, vr::VRSettingsError_UnsetSettingHasNoDefault );
+}
+
+void SettingsCacheTest::typeMismatchReadsAgain()
+{
+    MockSettings mock;
+    mock.values[{ "steamvr", "refreshRate" }] = 90;
+    SettingsCache cache( [&mock] { return &mock; } );
+
+    QCOMPARE( cache.getInt32( "steamvr", "refreshRate" ), 90 );
+    auto error = vr::VRSettingsError_None;
+    cache.getFloat( "steamvr", "refreshRate", &error );
+    QCOMPARE( error, vr::VRSettingsError_UnsetSettingHasNoDefault );
+    QCOMPARE( mock.reads, 2 );
+}
+
+void SettingsCacheTest::missingBackendReportsAnError()
+{
+    SettingsCache cache(
+        [] { return static_cast<vr::IVRSettings*>( nullptr ); } );
+
+    auto error = vr::VRSettingsError_None;
+    QCOMPARE( cache.getString( "audio", "x", &error ), std::string() );
+    QCOMPARE( error, vr::VRSettingsError_IPCFailed );
+    cache.setBool( "audio", "x", true, &error );
+    QCOMPARE( error, vr::VRSettingsError_IPCFailed );
+}
+
+QTEST_APPLESS_MAIN( SettingsCacheTest )
+
+#include "tst_settingscachetest.moc"
@@ -0,0 +1,16 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../src/settings
+
+SOURCES +=  tst_profilestoretest.cpp \
+    ../../src/settings/profile_store.cpp
+
+HEADERS += \
+    ../../src/settings/profile_store.h
@@ -0,0 +1,290 @@
+#include <QtTest>
+#include <string>
+#include <vector>
+#include "profile_store.h"
+
+using namespace settings;
+
+namespace
+{
+// Roughly what a chaperone profile with a 40 quad play area saves.
+ProfileRecord chaperoneLikeRecord( const int seed )
+{
+    ProfileRecord r;
+    r.bools.assign( 20, seed % 2 == 0 );
+    r.ints.assign( 8, seed );
+    for ( int i = 0; i < 40 * 4 * 3 + 40; ++i )
+    {
+        r.doubles.push_back( seed + i * 0.125 );
+    }
+    r.strings = { "Profile " + std::to_string( seed ), "", "ümlaut" };
+    return r;
+}
+
+ProfileStore makeStore( const int profiles )
+{
+    ProfileStore store;
+    for ( int i = 1; i <= profiles; ++i )
+    {
+        store.set( "chaperoneProfiles-" + std::to_string( i ),
+                   chaperoneLikeRecord( i ) );
+    }
+    return store;
+}
+
+std::vector<uint8_t> toBytes( const std::string& s )
+{
+    return std::vector<uint8_t>( s.begin(), s.end() );
+}
+
+void putLittleEndian( std::vector<uint8_t>& out,
+                      const uint32_t value,
+                      const int bytes )
+{
+    for ( int i = 0; i < bytes; ++i )
+    {
+        out.push_back( static_cast<uint8_t>( value >> ( 8 * i ) ) );
+    }
+}
+
+uint32_t referenceCrc32( const std::vector<uint8_t>& data )
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    for ( const auto byte : data )
+    {
+        crc ^= byte;
+        for ( int bit = 0; bit < 8; ++bit )
+        {
+            crc = ( crc & 1 ) ? 0xEDB88320u ^ ( crc >> 1 ) : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// A version 1 store of records that only hold their name as a string.
+std::vector<uint8_t> makeVersion1Store( const std::vector<std::string>& names )
+{
+    auto out = toBytes( "OVRP" );
+    putLittleEndian( out, 1, 2 );
+    putLittleEndian( out, 0, 2 );
+    putLittleEndian( out, static_cast<uint32_t>( names.size() ), 4 );
+    for ( const auto& name : names )
+    {
+        std::vector<uint8_t> payload;
+        const auto key = "profile-" + name;
+        putLittleEndian( payload, static_cast<uint32_t>( key.size() ), 2 );
+        payload.insert( payload.end(), key.begin(), key.end() );
+        for ( const auto count : { 0u, 0u, 0u, 1u } )
+        {
+            putLittleEndian( payload, count, 4 );
+        }
+        putLittleEndian( payload, static_cast<uint32_t>( name.size() ), 4 );
+        payload.insert( payload.end(), name.begin(), name.end() );
+
+        putLittleEndian( out, static_cast<uint32_t>( payload.size() ), 4 );
+        putLittleEndian( out, referenceCrc32( payload ), 4 );
+        out.insert( out.end(), payload.begin(), payload.end() );
+    }
+    return out;
+}
+} // namespace
+
+class ProfileStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip();
+    void indexWithoutBodies();
+    void renameAndErase();
+    void damagedBodyOnlyLosesThatRecord();
+    void damagedBodyIsWrittenBack();
+    void readsVersion1();
+    void damagedVersion1RecordIsWrittenBack();
+    void damagedIndex();
+    void rejectsForeignData();
+
+    void benchmarkEncode();
+    void benchmarkDecodeIndex();
+    void benchmarkLoadOne();
+};
+
+void ProfileStoreTest::roundTrip()
+{
+    auto store = makeStore( 3 );
+    store.set( "empty", ProfileRecord{} );
+
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( store.encode() ), ProfileStoreStatus::Ok );
+    QCOMPARE( decoded.size(), std::size_t{ 4 } );
+    for ( int i = 1; i <= 3; ++i )
+    {
+        ProfileRecord record;
+        QVERIFY(
+            decoded.load( "chaperoneProfiles-" + std::to_string( i ), record ) );
+        QVERIFY( record == chaperoneLikeRecord( i ) );
+    }
+    ProfileRecord record;
+    QVERIFY( decoded.load( "empty", record ) );
+    QVERIFY( record == ProfileRecord{} );
+    QVERIFY( !decoded.load( "chaperoneProfiles-4", record ) );
+
+    // Re-encoding bodies that were never decoded keeps them intact.
+    ProfileStore again;
+    QCOMPARE( again.decode( decoded.encode() ), ProfileStoreStatus::Ok );
+    QVERIFY( again.load( "chaperoneProfiles-2", record ) );
+    QVERIFY( record == chaperoneLikeRecord( 2 ) );
+}
+
+void ProfileStoreTest::indexWithoutBodies()
+{
+    ProfileStore store;
+    store.set( "videoProfiles-1", chaperoneLikeRecord( 7 ), 3 );
+
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( store.encode() ), ProfileStoreStatus::Ok );
+    const auto entry = decoded.indexEntry( "videoProfiles-1" );
+    QVERIFY( entry != nullptr );
+    QCOMPARE( entry->displayName, std::string( "Profile 7" ) );
+    QCOMPARE( entry->flags, uint32_t{ 3 } );
+    QVERIFY( entry->bodySize > 0 );
+    QVERIFY( decoded.indexEntry( "videoProfiles-2" ) == nullptr );
+}
+
+void ProfileStoreTest::renameAndErase()
+{
+    auto store = makeStore( 3 );
+    QVERIFY( store.erase( "chaperoneProfiles-1" ) );
+    QVERIFY( !store.erase( "chaperoneProfiles-1" ) );
+    QVERIFY( store.rename( "chaperoneProfiles-2", "chaperoneProfiles-1" ) );
+    QVERIFY( !store.rename( "chaperoneProfiles-9", "chaperoneProfiles-2" ) );
+
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( store.encode() ), ProfileStoreStatus::Ok );
+    QCOMPARE( decoded.size(), std::size_t{ 2 } );
+    QCOMPARE( decoded.indexEntry( "chaperoneProfiles-1" )->displayName,
+              std::string( "Profile 2" ) );
+}
+
+void ProfileStoreTest::damagedBodyOnlyLosesThatRecord()
+{
+    auto data = makeStore( 3 ).encode();
+    // Bodies are sorted by key and follow the index, the middle of the data
+    // is inside the second body.
+    data[data.size() / 2] ^= 0x10;
+
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( data ), ProfileStoreStatus::Ok );
+    QCOMPARE( decoded.size(), std::size_t{ 3 } );
+    ProfileRecord record;
+    QVERIFY( decoded.load( "chaperoneProfiles-1", record ) );
+    QVERIFY( !decoded.load( "chaperoneProfiles-2", record ) );
+    QVERIFY( decoded.load( "chaperoneProfiles-3", record ) );
+}
+
+void ProfileStoreTest::damagedBodyIsWrittenBack()
+{
+    auto data = makeStore( 3 ).encode();
+    data[data.size() / 2] ^= 0x10;
+
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( data ), ProfileStoreStatus::Ok );
+    decoded.set( "chaperoneProfiles-4", chaperoneLikeRecord( 4 ) );
+    QVERIFY( decoded.erase( "chaperoneProfiles-4" ) );
+    QCOMPARE( decoded.encode(), data );
+}
+
+void ProfileStoreTest::readsVersion1()
+{
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( makeVersion1Store( { "a", "b" } ) ),
+              ProfileStoreStatus::Ok );
+    QCOMPARE( decoded.size(), std::size_t{ 2 } );
+    ProfileRecord record;
+    QVERIFY( decoded.load( "profile-b", record ) );
+    QCOMPARE( record.strings, std::vector<std::string>{ "b" } );
+}
+
+void ProfileStoreTest::damagedVersion1RecordIsWrittenBack()
+{
+    auto data = makeVersion1Store( { "first", "second" } );
+    // Last byte of the second record's name.
+    data.back() ^= 0x01;
+
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( data ), ProfileStoreStatus::Ok );
+    QCOMPARE( decoded.size(), std::size_t{ 2 } );
+    ProfileRecord record;
+    QVERIFY( decoded.load( "profile-first", record ) );
+    QVERIFY( !decoded.load( "profile-second", record ) );
+
+    ProfileStore again;
+    QCOMPARE( again.decode( decoded.encode() ), ProfileStoreStatus::Ok );
+    QVERIFY( !again.load( "profile-second", record ) );
+    const auto entry = again.indexEntry( "profile-second" );
+    QVERIFY( entry != nullptr );
+    QCOMPARE( entry->displayName, std::string( "secone" ) );
+}
+
+void ProfileStoreTest::damagedIndex()
+{
+    auto data = makeStore( 2 ).encode();
+    data[24] ^= 0x01;
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( data ), ProfileStoreStatus::Damaged );
+
+    data = makeStore( 2 ).encode();
+    data.resize( data.size() - 1 );
+    QCOMPARE( decoded.decode( data ), ProfileStoreStatus::Damaged );
+    QCOMPARE( decoded.size(), std::size_t{ 1 } );
+}
+
+void ProfileStoreTest::rejectsForeignData()
+{
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( toBytes( "[chaperoneProfiles-1]\n" ) ),
+              ProfileStoreStatus::Unsupported );
+
+    auto data = makeStore( 1 ).encode();
+    data[4] = ProfileStore::k_version + 1;
+    QCOMPARE( decoded.decode( data ), ProfileStoreStatus::Unsupported );
+    QCOMPARE( decoded.size(), std::size_t{ 0 } );
+}
+
+void ProfileStoreTest::benchmarkEncode()
+{
+    const auto store = makeStore( 50 );
+    std::size_t bytes = 0;
+    QBENCHMARK
+    {
+        bytes = store.encode().size();
+    }
+    QVERIFY( bytes > 0 );
+}
+
+void ProfileStoreTest::benchmarkDecodeIndex()
+{
+    const auto data = makeStore( 50 ).encode();
+    ProfileStore decoded;
+    QBENCHMARK
+    {
+        QCOMPARE( decoded.decode( data ), ProfileStoreStatus::Ok );
+    }
+    QCOMPARE( decoded.size(), std::size_t{ 50 } );
+}
+
+void ProfileStoreTest::benchmarkLoadOne()
+{
+    ProfileStore decoded;
+    QCOMPARE( decoded.decode( makeStore( 50 ).encode() ),
+              ProfileStoreStatus::Ok );
+    ProfileRecord record;
+    QBENCHMARK
+    {
+        QVERIFY( decoded.load( "chaperoneProfiles-25", record ) );
+    }
+}
+
+QTEST_APPLESS_MAIN( ProfileStoreTest )
+
+#include "tst_profilestoretest.moc"
@@ -0,0 +1,22 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE
+
+INCLUDEPATH += ../../src/tabcontrollers/audiomanager \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_pulseaudiotest.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/tabcontrollers/audiomanager/AudioManager.h \
+    ../../src/tabcontrollers/audiomanager/AudioManagerPulse_internal.h
+
+LIBS += -lpulse
@@ -0,0 +1,100 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include "AudioManagerPulse_internal.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using namespace advsettings;
+
+// Needs a running PulseAudio or PipeWire server with a default source and
+// is skipped otherwise. A null sink is enough, its monitor is the source:
+//   pactl load-module module-null-sink sink_name=ovras_test
+//   pactl set-default-source ovras_test.monitor
+class PulseAudioTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void cachesDevices();
+    void muteIsCachedImmediately();
+    void pttToggleLatency();
+    void pttRoundTripLatency();
+
+private:
+    bool m_originalMuted = false;
+};
+
+void PulseAudioTest::initTestCase()
+{
+    initializePulseAudio();
+    if ( !isMicrophoneValid() )
+    {
+        QSKIP( "No PulseAudio server with a default source." );
+    }
+    m_originalMuted = getMicrophoneMuted();
+}
+
+void PulseAudioTest::cleanupTestCase()
+{
+    if ( isMicrophoneValid() )
+    {
+        setMicMuteState( m_originalMuted );
+        drainPulseAudio();
+    }
+    shutdownPulseAudio();
+}
+
+void PulseAudioTest::cachesDevices()
+{
+    const auto id = getCurrentDefaultRecordingDeviceId();
+    const auto devices = returnRecordingDevices();
+    QVERIFY( std::any_of( devices.begin(),
+                          devices.end(),
+                          [&id]( const AudioDevice& d ) {
+                              return d.id() == id;
+                          } ) );
+    QVERIFY( getCurrentDefaultRecordingDeviceName() != "ERROR" );
+}
+
+void PulseAudioTest::muteIsCachedImmediately()
+{
+    QVERIFY( setMicMuteState( true ) );
+    QVERIFY( getMicrophoneMuted() );
+    QVERIFY( setMicMuteState( false ) );
+    QVERIFY( !getMicrophoneMuted() );
+
+    // The server's answer doesn't change what was written last.
+    drainPulseAudio();
+    QVERIFY( !getMicrophoneMuted() );
+}
+
+// What push-to-talk costs the caller.
+void PulseAudioTest::pttToggleLatency()
+{
+    bool muted = false;
+    QBENCHMARK
+    {
+        muted = !muted;
+        setMicMuteState( muted );
+    }
+    drainPulseAudio();
+}
+
+// Until the server applied the change.
+void PulseAudioTest::pttRoundTripLatency()
+{
+    bool muted = false;
+    QBENCHMARK
+    {
+        muted = !muted;
+        setMicMuteState( muted );
+        drainPulseAudio();
+    }
+}
+
+QTEST_APPLESS_MAIN( PulseAudioTest )
+
+#include "tst_pulseaudiotest.moc"
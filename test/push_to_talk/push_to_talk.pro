@@ -0,0 +1,22 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE
+
+INCLUDEPATH += ../../src/tabcontrollers \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_pushtotalktest.cpp \
+    ../../src/tabcontrollers/PushToTalkService.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/tabcontrollers/PushToTalkService.h \
+    ../../src/tabcontrollers/statistics/HdrHistogram.h \
+    ../../src/utils/spsc_queue.h
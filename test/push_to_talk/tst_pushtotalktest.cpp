@@ -0,0 +1,171 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "PushToTalkService.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using push_to_talk::Clock;
+using push_to_talk::PushToTalkService;
+
+namespace
+{
+// Stands in for the audio backend and records what it was asked to do.
+class FakeBackend
+{
+public:
+    bool setMuted( const bool muted )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_blocked.wait( lock, [this] { return !m_blocking; } );
+        m_calls.push_back( muted );
+        m_called.notify_all();
+        return true;
+    }
+
+    bool waitForCalls( const std::size_t count )
+    {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        return m_called.wait_for( lock, std::chrono::seconds( 5 ), [&] {
+            return m_calls.size() >= count;
+        } );
+    }
+
+    void block( const bool blocking )
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_blocking = blocking;
+        }
+        m_blocked.notify_all();
+    }
+
+    std::vector<bool> calls()
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        return m_calls;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_called;
+    std::condition_variable m_blocked;
+    bool m_blocking = false;
+    std::vector<bool> m_calls;
+};
+
+bool waitUntilApplied( const PushToTalkService& service )
+{
+    const auto deadline = Clock::now() + std::chrono::seconds( 5 );
+    while ( service.pending() && Clock::now() < deadline )
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return !service.pending();
+}
+} // namespace
+
+class PushToTalkTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void appliesChangesOffTheCaller();
+    void appliesOnlyTheLatestQueuedChange();
+    void dropsChangesWhenFull();
+    void appliesPendingChangesOnDestruction();
+    void postLatency();
+};
+
+void PushToTalkTest::appliesChangesOffTheCaller()
+{
+    FakeBackend backend;
+    PushToTalkService service(
+        [&backend]( bool muted ) { return backend.setMuted( muted ); } );
+
+    const auto sampled = Clock::now();
+    QVERIFY( service.post( false, sampled ) );
+    QVERIFY( backend.waitForCalls( 1 ) );
+    QVERIFY( service.post( true, Clock::now() ) );
+    QVERIFY( backend.waitForCalls( 2 ) );
+
+    QCOMPARE( backend.calls(), ( std::vector<bool>{ false, true } ) );
+    QVERIFY( waitUntilApplied( service ) );
+    QCOMPARE( service.latencies().totalCount(), uint64_t{ 2 } );
+}
+
+void PushToTalkTest::appliesOnlyTheLatestQueuedChange()
+{
+    FakeBackend backend;
+    PushToTalkService service(
+        [&backend]( bool muted ) { return backend.setMuted( muted ); } );
+
+    // The first change keeps the service busy while the others queue up.
+    backend.block( true );
+    QVERIFY( service.post( true, Clock::now() ) );
+    QVERIFY( service.post( false, Clock::now() ) );
+    QVERIFY( service.post( true, Clock::now() ) );
+    QVERIFY( service.post( false, Clock::now() ) );
+    QVERIFY( service.pending() );
+    backend.block( false );
+
+    QVERIFY( waitUntilApplied( service ) );
+    const auto calls = backend.calls();
+    QVERIFY( calls.size() <= 2 );
+    QCOMPARE( calls.back(), false );
+}
+
+void PushToTalkTest::dropsChangesWhenFull()
+{
+    FakeBackend backend;
+    backend.block( true );
+    PushToTalkService service(
+        [&backend]( bool muted ) { return backend.setMuted( muted ); } );
+
+    // One change may already be taken by the blocked service thread.
+    std::size_t accepted = 0;
+    for ( std::size_t i = 0; i < push_to_talk::k_muteQueueCapacity + 2; ++i )
+    {
+        if ( service.post( i % 2 == 0, Clock::now() ) )
+        {
+            ++accepted;
+        }
+    }
+    QVERIFY( accepted >= push_to_talk::k_muteQueueCapacity );
+    QVERIFY( service.droppedChanges() >= 1 );
+    backend.block( false );
+}
+
+void PushToTalkTest::appliesPendingChangesOnDestruction()
+{
+    FakeBackend backend;
+    {
+        PushToTalkService service(
+            [&backend]( bool muted ) { return backend.setMuted( muted ); } );
+        service.post( true, Clock::now() );
+    }
+    QCOMPARE( backend.calls().back(), true );
+}
+
+void PushToTalkTest::postLatency()
+{
+    std::atomic<int> calls{ 0 };
+    PushToTalkService service( [&calls]( bool ) {
+        ++calls;
+        return true;
+    } );
+
+    bool muted = false;
+    QBENCHMARK
+    {
+        muted = !muted;
+        service.post( muted, Clock::now() );
+    }
+}
+
+QTEST_APPLESS_MAIN( PushToTalkTest )
+
+#include "tst_pushtotalktest.moc"
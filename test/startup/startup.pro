@@ -0,0 +1,22 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE
+
+INCLUDEPATH += ../../src/utils \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_startuptest.cpp \
+    ../../src/utils/startup_profiler.cpp \
+    ../../src/utils/startup_tasks.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/utils/startup_profiler.h \
+    ../../src/utils/startup_tasks.h
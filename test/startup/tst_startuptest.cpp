@@ -0,0 +1,199 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "startup_profiler.h"
+#include "startup_tasks.h"
+
+INITIALIZE_EASYLOGGINGPP
+
+using utils::StartupProfiler;
+using utils::StartupTasks;
+
+class StartupTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void runsDependenciesFirst();
+    void runsIndependentTasksInParallel();
+    void reportsFailuresToDependents();
+    void rejectsUnknownDependencies();
+    void taskGraphOverhead();
+
+    void recordsPhases();
+    void marksFirstFrameOnce();
+};
+
+void StartupTest::runsDependenciesFirst()
+{
+    std::mutex mutex;
+    std::vector<int> order;
+    const auto note = [&]( int value ) {
+        return [&, value] {
+            std::lock_guard<std::mutex> lock( mutex );
+            order.push_back( value );
+        };
+    };
+
+    StartupTasks tasks( 4 );
+    const auto store = tasks.add( "store", note( 0 ) );
+    const auto a = tasks.add( "a", note( 1 ), { store } );
+    const auto b = tasks.add( "b", note( 1 ), { store } );
+    const auto last = tasks.add( "last", note( 2 ), { a, b } );
+    tasks.wait( last );
+
+    QCOMPARE( order.size(), std::size_t{ 4 } );
+    QCOMPARE( order.front(), 0 );
+    QCOMPARE( order[1], 1 );
+    QCOMPARE( order[2], 1 );
+    QCOMPARE( order.back(), 2 );
+}
+
+void StartupTest::runsIndependentTasksInParallel()
+{
+    // Both tasks only finish once the other one started, which can't
+    // happen if they run one after another.
+    std::mutex mutex;
+    std::condition_variable started;
+    int running = 0;
+    std::atomic<int> metEachOther{ 0 };
+    const auto meet = [&] {
+        std::unique_lock<std::mutex> lock( mutex );
+        ++running;
+        started.notify_all();
+        if ( started.wait_for( lock, std::chrono::seconds( 5 ), [&] {
+                 return running == 2;
+             } ) )
+        {
+            ++metEachOther;
+        }
+    };
+
+    StartupTasks tasks( 2 );
+    tasks.add( "first", meet );
+    tasks.add( "second", meet );
+    tasks.waitAll();
+
+    QCOMPARE( metEachOther.load(), 2 );
+}
+
+void StartupTest::reportsFailuresToDependents()
+{
+    bool dependentRan = false;
+    bool independentRan = false;
+
+    StartupTasks tasks( 2 );
+    const auto failing = tasks.add(
+        "failing", [] { throw std::runtime_error( "no profile store" ); } );
+    const auto dependent
+        = tasks.add( "dependent", [&] { dependentRan = true; }, { failing } );
+    const auto independent
+        = tasks.add( "independent", [&] { independentRan = true; } );
+
+    bool threw = false;
+    try
+    {
+        tasks.wait( dependent );
+    }
+    catch ( const std::runtime_error& e )
+    {
+        threw = std::string( e.what() ) == "no profile store";
+    }
+    QVERIFY( threw );
+    QVERIFY( !dependentRan );
+
+    tasks.wait( independent );
+    QVERIFY( independentRan );
+
+    // Dependents added after the failure are skipped as well.
+    const auto late
+        = tasks.add( "late", [&] { dependentRan = true; }, { failing } );
+    threw = false;
+    try
+    {
+        tasks.wait( late );
+    }
+    catch ( const std::runtime_error& )
+    {
+        threw = true;
+    }
+    QVERIFY( threw );
+    QVERIFY( !dependentRan );
+}
+
+void StartupTest::rejectsUnknownDependencies()
+{
+    StartupTasks tasks( 1 );
+    bool threw = false;
+    try
+    {
+        tasks.add( "orphan", [] {}, { 3 } );
+    }
+    catch ( const std::invalid_argument& )
+    {
+        threw = true;
+    }
+    QVERIFY( threw );
+}
+
+void StartupTest::taskGraphOverhead()
+{
+    QBENCHMARK
+    {
+        StartupTasks tasks;
+        const auto store = tasks.add( "store", [] {} );
+        for ( int i = 0; i < 3; ++i )
+        {
+            tasks.add( "profiles", [] {}, { store } );
+        }
+        tasks.waitAll();
+    }
+}
+
+void StartupTest::recordsPhases()
+{
+    StartupProfiler profiler;
+    {
+        const auto phase = profiler.phase( "opengl context" );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+    }
+    std::thread worker( [&profiler] {
+        const auto phase = profiler.phase( "profiles" );
+    } );
+    worker.join();
+
+    const auto phases = profiler.phases();
+    QCOMPARE( phases.size(), std::size_t{ 2 } );
+    QCOMPARE( phases[0].name, std::string( "opengl context" ) );
+    QVERIFY( phases[0].mainThread );
+    QVERIFY( phases[0].duration >= std::chrono::milliseconds( 5 ) );
+    QVERIFY( !phases[1].mainThread );
+    QVERIFY( phases[1].start >= phases[0].start + phases[0].duration );
+
+    // Longest first.
+    const auto summary = profiler.summary( 1 );
+    QVERIFY( summary.find( "opengl context" ) != std::string::npos );
+    QVERIFY( summary.find( "profiles" ) == std::string::npos );
+}
+
+void StartupTest::marksFirstFrameOnce()
+{
+    StartupProfiler profiler;
+    QVERIFY( !profiler.timeToFirstFrame().has_value() );
+
+    QVERIFY( profiler.markFirstFrame() );
+    const auto first = profiler.timeToFirstFrame();
+    QVERIFY( first.has_value() );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+    QVERIFY( !profiler.markFirstFrame() );
+    QCOMPARE( profiler.timeToFirstFrame()->count(), first->count() );
+}
+
+QTEST_APPLESS_MAIN( StartupTest )
+
+#include "tst_startuptest.moc"
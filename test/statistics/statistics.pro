@@ -0,0 +1,22 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+INCLUDEPATH += ../../src/tabcontrollers/statistics \
+    ../../third-party/openvr/headers
+
+SOURCES +=  tst_statisticstest.cpp \
+    ../../src/tabcontrollers/statistics/FrameTimings.cpp \
+    ../../src/tabcontrollers/statistics/SessionFormat.cpp \
+    ../../src/tabcontrollers/statistics/TimeSeries.cpp
+
+HEADERS += \
+    ../../src/tabcontrollers/statistics/FrameTimings.h \
+    ../../src/tabcontrollers/statistics/HdrHistogram.h \
+    ../../src/tabcontrollers/statistics/SessionFormat.h \
+    ../../src/tabcontrollers/statistics/TimeSeries.h
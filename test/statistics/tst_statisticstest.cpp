@@ -0,0 +1,462 @@
+#include <QtTest>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "FrameTimings.h"
+#include "HdrHistogram.h"
+#include "SessionFormat.h"
+#include "TimeSeries.h"
+
+using namespace statistics;
+using Clock = SecondAggregator::Clock;
+
+class StatisticsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void histogramBucketsRoundTrip();
+    void histogramPercentiles();
+    void histogramRemove();
+
+    void windowsSlide();
+    void ringOverwritesOldestSecond();
+
+    void aggregatorEmitsPerSecondDeltas();
+    void aggregatorDropsStalls();
+    void aggregatorAveragesShortStalls();
+    void aggregatorResetsOnNewCompositor();
+
+    void frameTimingsSkipKnownFrames();
+    void frameTimingsDetectSpikes();
+    void frameTimingsCorrelateOverlayTicks();
+    void frameTimingsTrackReprojectionStreaks();
+
+    void sessionRoundTrip();
+    void sessionDeltasStaySmall();
+    void sessionTruncatedRecordIsIgnored();
+    void sessionRejectsForeignFiles();
+};
+
+namespace
+{
+std::vector<vr::Compositor_FrameTiming> makeFrames( const uint32_t firstIndex,
+                                                    const uint32_t count,
+                                                    const float gpuMs )
+{
+    std::vector<vr::Compositor_FrameTiming> frames( count );
+    for ( uint32_t i = 0; i < count; ++i )
+    {
+        auto& f = frames[i];
+        f.m_nSize = sizeof( vr::Compositor_FrameTiming );
+        f.m_nFrameIndex = firstIndex + i;
+        f.m_flSystemTimeInSeconds = ( firstIndex + i ) / 90.0;
+        f.m_flTotalRenderGpuMs = gpuMs;
+        f.m_flClientFrameIntervalMs = 11.1f;
+        f.m_nNumFramePresents = 1;
+    }
+    return frames;
+}
+} // namespace
+
+void StatisticsTest::histogramBucketsRoundTrip()
+{
+    using H = HdrHistogram<5, 20>;
+    for ( uint32_t v = 0; v < ( 1u << 22 ); v += 7 )
+    {
+        const auto index = H::bucketIndex( v );
+        QVERIFY( index < H::k_bucketCount );
+        const auto highest = H::highestEquivalentValue( index );
+        QVERIFY( highest >= v );
+        // Relative error bound of 1 / 2^(SubBucketBits - 1).
+        QVERIFY( highest - v <= v / 16 + 1 );
+    }
+}
+
+void StatisticsTest::histogramPercentiles()
+{
+    HdrHistogram<5, 20> h;
+    QCOMPARE( h.percentile( 50.0 ), 0u );
+    for ( uint32_t v = 1; v <= 100; ++v )
+    {
+        h.record( v );
+    }
+    QCOMPARE( h.totalCount(), uint64_t{ 100 } );
+    QCOMPARE( h.percentile( 50.0 ), 51u );
+    QCOMPARE( h.percentile( 95.0 ), 95u );
+    QCOMPARE( h.percentile( 99.0 ), 99u );
+    QVERIFY( h.maxValue() >= 100u );
+}
+
+void StatisticsTest::histogramRemove()
+{
+    HdrHistogram<5, 20> h;
+    for ( uint32_t v = 1; v <= 100; ++v )
+    {
+        h.record( v );
+    }
+    for ( uint32_t v = 1; v <= 50; ++v )
+    {
+        h.remove( v );
+    }
+    QCOMPARE( h.totalCount(), uint64_t{ 50 } );
+    QCOMPARE( h.percentile( 50.0 ), 75u );
+    // Removing values that were never recorded must not underflow.
+    h.clear();
+    h.remove( 42 );
+    QCOMPARE( h.totalCount(), uint64_t{ 0 } );
+}
+
+void StatisticsTest::windowsSlide()
+{
+    // The store is large, keep it off the stack.
+    auto store = std::make_unique<TimeSeriesStore>();
+
+    // One stuttery minute followed by four smooth ones.
+    SecondSample sample;
+    sample[Metric::DroppedFrames] = 10;
+    for ( int i = 0; i < 60; ++i )
+    {
+        store->push( sample );
+    }
+    QCOMPARE( store->percentile(
+                  Metric::DroppedFrames, Window::OneMinute, 50.0 ),
+              10.0 );
+
+    sample[Metric::DroppedFrames] = 0;
+    for ( int i = 0; i < 4 * 60; ++i )
+    {
+        store->push( sample );
+    }
+    const auto oneMinute
+        = store->percentiles( Metric::DroppedFrames, Window::OneMinute );
+    QCOMPARE( oneMinute.samples, std::size_t{ 60 } );
+    QCOMPARE( oneMinute.p99, 0.0 );
+
+    const auto fiveMinutes
+        = store->percentiles( Metric::DroppedFrames, Window::FiveMinutes );
+    QCOMPARE( fiveMinutes.samples, std::size_t{ 300 } );
+    QCOMPARE( fiveMinutes.p50, 0.0 );
+    QCOMPARE( fiveMinutes.p95, 10.0 );
+    QCOMPARE( fiveMinutes.max, 10.0 );
+
+    // The stuttery minute leaves the five minute window.
+    for ( int i = 0; i < 60; ++i )
+    {
+        store->push( sample );
+    }
+    QCOMPARE(
+        store->percentiles( Metric::DroppedFrames, Window::FiveMinutes ).max,
+        0.0 );
+    QCOMPARE(
+        store->percentiles( Metric::DroppedFrames, Window::SixtyMinutes ).max,
+        10.0 );
+}
+
+void StatisticsTest::ringOverwritesOldestSecond()
+{
+    auto store = std::make_unique<TimeSeriesStore>();
+    SecondSample sample;
+    for ( uint32_t i = 0; i < TimeSeriesStore::k_capacitySeconds + 10; ++i )
+    {
+        sample[Metric::FramePresents] = i;
+        store->push( sample );
+    }
+    QCOMPARE( store->size(), TimeSeriesStore::k_capacitySeconds );
+    QCOMPARE( store->secondsAgo( 0 )[Metric::FramePresents],
+              TimeSeriesStore::k_capacitySeconds + 9 );
+    QCOMPARE( store->secondsAgo( TimeSeriesStore::k_capacitySeconds - 1 )
+                  [Metric::FramePresents],
+              10u );
+    QCOMPARE( store->percentiles( Metric::FramePresents, Window::SixtyMinutes )
+                  .samples,
+              TimeSeriesStore::k_capacitySeconds );
+
+    store->clear();
+    QCOMPARE( store->size(), std::size_t{ 0 } );
+    QCOMPARE(
+        store->percentiles( Metric::FramePresents, Window::OneMinute ).samples,
+        std::size_t{ 0 } );
+}
+
+void StatisticsTest::aggregatorEmitsPerSecondDeltas()
+{
+    SecondAggregator aggregator;
+    Clock::time_point now{};
+    FrameCounters counters{ 1, 1000, 5, 20, 0 };
+
+    QVERIFY( !aggregator.tick( now, counters, 1.0f, 90.0f ) );
+    now += std::chrono::milliseconds( 500 );
+    counters.presents += 45;
+    counters.reprojected += 3;
+    QVERIFY( !aggregator.tick( now, counters, 3.0f, 90.0f ) );
+    now += std::chrono::milliseconds( 500 );
+    counters.presents += 45;
+    counters.dropped += 2;
+
+    const auto sample = aggregator.tick( now, counters, 2.0f, 90.0f );
+    QVERIFY( sample.has_value() );
+    QCOMPARE( ( *sample )[Metric::FramePresents], 90u );
+    QCOMPARE( ( *sample )[Metric::DroppedFrames], 2u );
+    QCOMPARE( ( *sample )[Metric::ReprojectedFrames], 3u );
+    QCOMPARE( ( *sample )[Metric::TimedOut], 0u );
+    QCOMPARE( ( *sample )[Metric::HmdSpeed], 2000u );
+    QCOMPARE( ( *sample )[Metric::HmdRotationRate], 9000u );
+}
+
+void StatisticsTest::aggregatorDropsStalls()
+{
+    SecondAggregator aggregator;
+    Clock::time_point now{};
+    FrameCounters counters{ 1, 0, 0, 0, 0 };
+
+    QVERIFY( !aggregator.tick( now, counters, 0.0f, 0.0f ) );
+    now += std::chrono::seconds( 30 );
+    counters.presents = 2700;
+    QVERIFY( !aggregator.tick( now, counters, 0.0f, 0.0f ) );
+
+    now += std::chrono::seconds( 1 );
+    counters.presents += 90;
+    const auto sample = aggregator.tick( now, counters, 0.0f, 0.0f );
+    QVERIFY( sample.has_value() );
+    QCOMPARE( ( *sample )[Metric::FramePresents], 90u );
+}
+
+void StatisticsTest::aggregatorAveragesShortStalls()
+{
+    SecondAggregator aggregator;
+    Clock::time_point now{};
+    FrameCounters counters{ 1, 0, 0, 0, 0 };
+
+    QVERIFY( !aggregator.tick( now, counters, 0.0f, 0.0f ) );
+    now += std::chrono::milliseconds( 3200 );
+    counters.presents = 270;
+    counters.dropped = 3;
+    auto sample = aggregator.tick( now, counters, 0.0f, 0.0f );
+    QVERIFY( sample.has_value() );
+    QCOMPARE( ( *sample )[Metric::FramePresents], 90u );
+    QCOMPARE( ( *sample )[Metric::DroppedFrames], 1u );
+
+    // The three seconds are used up, the next sample is due a second later.
+    now += std::chrono::milliseconds( 700 );
+    counters.presents += 63;
+    QVERIFY( !aggregator.tick( now, counters, 0.0f, 0.0f ) );
+    now += std::chrono::milliseconds( 100 );
+    counters.presents += 9;
+    sample = aggregator.tick( now, counters, 0.0f, 0.0f );
+    QVERIFY( sample.has_value() );
+    QCOMPARE( ( *sample )[Metric::FramePresents], 72u );
+}
+
+void StatisticsTest::aggregatorResetsOnNewCompositor()
+{
+    SecondAggregator aggregator;
+    Clock::time_point now{};
+
+    QVERIFY( !aggregator.tick( now, { 1, 5000, 0, 0, 0 }, 0.0f, 0.0f ) );
+    now += std::chrono::milliseconds( 900 );
+    QVERIFY( !aggregator.tick( now, { 2, 10, 0, 0, 0 }, 0.0f, 0.0f ) );
+    now += std::chrono::milliseconds( 1000 );
+
+    const auto sample
+        = aggregator.tick( now, { 2, 100, 0, 0, 0 }, 0.0f, 0.0f );
+    QVERIFY( sample.has_value() );
+    QCOMPARE( ( *sample )[Metric::FramePresents], 90u );
+}
+
+void StatisticsTest::frameTimingsSkipKnownFrames()
+{
+    auto collector = std::make_unique<FrameTimingCollector>();
+    const Clock::time_point now{};
+
+    // The newest frame of a batch is held back until the next batch.
+    auto frames = makeFrames( 100, 10, 5.0f );
+    collector->ingest( frames.data(), 10, now );
+    QCOMPARE( collector->size(), std::size_t{ 9 } );
+    QCOMPARE( collector->framesAgo( 0 ).frameIndex, 108u );
+
+    // Overlapping batch, only 109..113 are new.
+    frames = makeFrames( 105, 10, 5.0f );
+    collector->ingest( frames.data(), 10, now );
+    QCOMPARE( collector->size(), std::size_t{ 14 } );
+    QCOMPARE( collector->framesAgo( 0 ).frameIndex, 113u );
+    QCOMPARE( collector->missedFrames(), 0u );
+
+    // Gap of 6 frames between batches.
+    frames = makeFrames( 120, 4, 5.0f );
+    collector->ingest( frames.data(), 4, now );
+    QCOMPARE( collector->missedFrames(), 6u );
+}
+
+void StatisticsTest::frameTimingsDetectSpikes()
+{
+    auto collector = std::make_unique<FrameTimingCollector>();
+    const Clock::time_point now{};
+
+    auto frames = makeFrames( 0, 201, 8.0f );
+    for ( uint32_t i = 0; i < 200; ++i )
+    {
+        frames[i].m_flTotalRenderGpuMs = ( i % 2 ) ? 8.2f : 7.8f;
+    }
+    frames[150].m_flTotalRenderGpuMs = 25.0f;
+    collector->ingest( frames.data(), 201, now );
+
+    QCOMPARE( collector->spikeCount(), std::size_t{ 1 } );
+    const auto& spike = collector->spikesAgo( 0 );
+    QCOMPARE( spike.frameIndex, 150u );
+    QCOMPARE( spike.totalGpuMs, 25.0f );
+    QVERIFY( std::abs( spike.baselineMs - 8.0f ) < 0.5f );
+    // The baseline isn't dragged up by the spike.
+    QVERIFY( std::abs( collector->averageGpuMs() - 8.0f ) < 0.5f );
+}
+
+void StatisticsTest::frameTimingsCorrelateOverlayTicks()
+{
+    auto collector = std::make_unique<FrameTimingCollector>();
+    const Clock::time_point fetchTime = Clock::time_point{}
+                                        + std::chrono::seconds( 10 );
+
+    auto frames = makeFrames( 0, 101, 8.0f );
+    frames[90].m_flTotalRenderGpuMs = 30.0f;
+    // Frame 90 ends 10 frames (~111ms) before the newest frame.
+    const auto frameEnd
+        = fetchTime
+          - std::chrono::duration_cast<Clock::duration>(
+              std::chrono::duration<double>( 10 / 90.0 ) );
+    collector->noteOverlayTick( frameEnd - std::chrono::milliseconds( 5 ),
+                                std::chrono::milliseconds( 4 ) );
+    collector->noteOverlayTick( frameEnd - std::chrono::milliseconds( 500 ),
+                                std::chrono::milliseconds( 50 ) );
+    collector->ingest( frames.data(), 101, fetchTime );
+
+    QCOMPARE( collector->spikeCount(), std::size_t{ 1 } );
+    QVERIFY( std::abs( collector->spikesAgo( 0 ).overlayTickMs - 4.0f )
+             < 0.01f );
+}
+
+void StatisticsTest::frameTimingsTrackReprojectionStreaks()
+{
+    auto collector = std::make_unique<FrameTimingCollector>();
+    auto frames = makeFrames( 0, 21, 8.0f );
+    for ( const auto i : { 2, 3, 6, 7, 8, 9, 12, 13, 14 } )
+    {
+        frames[i].m_nReprojectionFlags = vr::VRCompositor_ReprojectionReason_Gpu;
+    }
+    // Async reprojection being enabled alone is not a reprojected frame.
+    frames[15].m_nReprojectionFlags = vr::VRCompositor_ReprojectionAsync;
+    collector->ingest( frames.data(), 21, {} );
+
+    QCOMPARE( collector->reprojectionStreaks(), 2u );
+    QCOMPARE( collector->longestReprojectionStreak(), 4u );
+    QCOMPARE( collector->currentReprojectionStreak(), 0u );
+
+    collector->reset();
+    QCOMPARE( collector->size(), std::size_t{ 0 } );
+    QCOMPARE( collector->reprojectionStreaks(), 0u );
+}
+
+void StatisticsTest::sessionRoundTrip()
+{
+    std::vector<SessionEvent> events;
+    for ( int i = 0; i < 50; ++i )
+    {
+        SessionEvent e;
+        e.type = static_cast<SessionRecordType>( 1 + i % 5 );
+        e.timestampUs = static_cast<uint64_t>( i ) * 11111;
+        for ( std::size_t f = 0; f < sessionFieldCount( e.type ); ++f )
+        {
+            // Mix of growing, negative and extreme values.
+            e.fields[f] = ( i % 7 == 0 && f == 0 )
+                              ? std::numeric_limits<int64_t>::min()
+                              : static_cast<int64_t>( i * 1000 ) - 3
+                                    * static_cast<int64_t>( f );
+        }
+        events.push_back( e );
+    }
+
+    std::vector<uint8_t> data;
+    SessionEncoder::writeHeader( data, 1700000000123 );
+    SessionEncoder encoder;
+    for ( const auto& e : events )
+    {
+        encoder.encode( e, data );
+    }
+
+    SessionDecoder decoder( data.data(), data.size() );
+    QVERIFY( decoder.valid() );
+    QCOMPARE( decoder.startUnixMs(), uint64_t{ 1700000000123 } );
+
+    SessionEvent decoded;
+    for ( const auto& e : events )
+    {
+        QVERIFY( decoder.next( decoded ) );
+        QCOMPARE( decoded.type, e.type );
+        QCOMPARE( decoded.timestampUs, e.timestampUs );
+        for ( std::size_t f = 0; f < sessionFieldCount( e.type ); ++f )
+        {
+            QCOMPARE( decoded.fields[f], e.fields[f] );
+        }
+    }
+    QVERIFY( !decoder.next( decoded ) );
+    QVERIFY( !decoder.truncated() );
+}
+
+void StatisticsTest::sessionDeltasStaySmall()
+{
+    std::vector<uint8_t> data;
+    SessionEncoder encoder;
+    SessionEvent e;
+    e.type = SessionRecordType::FrameTiming;
+    for ( int i = 0; i < 90; ++i )
+    {
+        e.timestampUs += 11111;
+        e.fields[FrameField::FrameIndex] = 100000 + i;
+        e.fields[FrameField::TotalGpuUs] = 8000 + ( i % 3 );
+        e.fields[FrameField::Presents] = 1;
+        encoder.encode( e, data );
+    }
+    // type + 2 byte dt + nine mostly one byte fields.
+    QVERIFY( data.size() < 90 * 13 );
+}
+
+void StatisticsTest::sessionTruncatedRecordIsIgnored()
+{
+    std::vector<uint8_t> data;
+    SessionEncoder::writeHeader( data, 0 );
+    SessionEncoder encoder;
+    SessionEvent e;
+    e.type = SessionRecordType::Comfort;
+    e.fields[ComfortField::Feature]
+        = static_cast<int64_t>( ComfortFeature::SnapTurn );
+    e.fields[ComfortField::Value] = -4500;
+    encoder.encode( e, data );
+    const auto complete = data.size();
+    e.fields[ComfortField::Value] = 100000;
+    encoder.encode( e, data );
+    data.resize( data.size() - 1 );
+
+    SessionDecoder decoder( data.data(), data.size() );
+    SessionEvent decoded;
+    QVERIFY( decoder.next( decoded ) );
+    QCOMPARE( decoded.fields[ComfortField::Value], int64_t{ -4500 } );
+    QVERIFY( !decoder.next( decoded ) );
+    QVERIFY( decoder.truncated() );
+    QVERIFY( complete < data.size() );
+}
+
+void StatisticsTest::sessionRejectsForeignFiles()
+{
+    const std::vector<uint8_t> garbage( 64, 0x42 );
+    SessionDecoder decoder( garbage.data(), garbage.size() );
+    QVERIFY( !decoder.valid() );
+
+    std::vector<uint8_t> data;
+    SessionEncoder::writeHeader( data, 0 );
+    data[4] = 99;
+    QVERIFY( !SessionDecoder( data.data(), data.size() ).valid() );
+}
+
+QTEST_APPLESS_MAIN( StatisticsTest )
+
+#include "tst_statisticstest.moc"
@@ -0,0 +1,261 @@
+#include <QtTest>
+#include <easylogging++.h>
+#include <chrono>
+#include <set>
+#include <vector>
+#include <unistd.h>
+#include "uinput_device.h"
+#include "uinput_sender.h"
+
+namespace
+{
+// Named before linux/input.h, its KEY_* macros hide these Token names.
+constexpr auto k_0 = Token::KEY_0;
+constexpr auto k_9 = Token::KEY_9;
+constexpr auto k_f1 = Token::KEY_F1;
+constexpr auto k_f12 = Token::KEY_F12;
+constexpr auto k_f19 = Token::KEY_F19;
+constexpr auto k_backspace = Token::KEY_BACKSPACE;
+constexpr auto k_backslash = Token::KEY_BACKSLASH;
+constexpr auto k_enter = Token::KEY_ENTER;
+} // namespace
+
+#include <linux/input.h>
+
+INITIALIZE_EASYLOGGINGPP
+
+namespace
+{
+// A pipe standing in for /dev/uinput, read like an evdev device.
+class StandIn
+{
+public:
+    StandIn()
+    {
+        if ( pipe( m_fds ) != 0 )
+        {
+            m_fds[0] = m_fds[1] = -1;
+        }
+    }
+
+    ~StandIn()
+    {
+        if ( m_fds[0] >= 0 )
+        {
+            close( m_fds[0] );
+        }
+    }
+
+    // The device owns the write end.
+    int takeWriteEnd()
+    {
+        return m_fds[1];
+    }
+
+    // Everything one read() returns, so a batch has to arrive in one piece.
+    std::vector<input_event> readOnce()
+    {
+        std::vector<input_event> events( 256 );
+        const auto bytes = read(
+            m_fds[0], events.data(), events.size() * sizeof( input_event ) );
+        events.resize( bytes > 0 ? static_cast<std::size_t>( bytes )
+                                       / sizeof( input_event )
+                                 : 0 );
+        return events;
+    }
+
+private:
+    int m_fds[2];
+};
+
+std::vector<std::pair<uint16_t, int32_t>>
+    keyEvents( const std::vector<input_event>& events )
+{
+    std::vector<std::pair<uint16_t, int32_t>> keys;
+    for ( const auto& event : events )
+    {
+        if ( event.type == EV_KEY )
+        {
+            keys.emplace_back( event.code, event.value );
+        }
+    }
+    return keys;
+}
+} // namespace
+
+class UinputKeyboardTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void everyTokenHasAKeyCode();
+    void tokensMapToEvdevCodes();
+    void writesOneBatch();
+    void everyKeyIsItsOwnReport();
+    void emptyWriteWritesNothing();
+    void createFailsWithoutUinput();
+    void senderWritesInOrderAfterSettling();
+    void senderStopsDuringDelay();
+};
+
+void UinputKeyboardTest::everyTokenHasAKeyCode()
+{
+    std::set<uint16_t> codes;
+    std::size_t tokens = 0;
+    const auto check = [&codes, &tokens]( const Token first,
+                                          const Token last ) {
+        for ( auto value = static_cast<int>( first );
+              value <= static_cast<int>( last );
+              ++value )
+        {
+            const auto code
+                = uinput_sender::tokenToKeyCode( static_cast<Token>( value ) );
+            QVERIFY( code != 0 );
+            codes.insert( code );
+            ++tokens;
+        }
+    };
+    check( Token::KEY_a, Token::KEY_z );
+    check( k_0, k_9 );
+    check( k_f1, k_f19 );
+    check( k_backspace, k_backslash );
+    check( Token::MODIFIER_CTRL, Token::MODIFIER_TILDE );
+    QCOMPARE( codes.size(), tokens );
+
+    QCOMPARE( uinput_sender::tokenToKeyCode( Token::TOKEN_NEW_SEQUENCE ),
+              uint16_t{ 0 } );
+    QCOMPARE( uinput_sender::tokenToKeyCode( Token::TOKEN_NO_KEYUP_NEXT ),
+              uint16_t{ 0 } );
+}
+
+void UinputKeyboardTest::tokensMapToEvdevCodes()
+{
+    QCOMPARE( uinput_sender::tokenToKeyCode( Token::KEY_a ),
+              uint16_t{ KEY_A } );
+    QCOMPARE( uinput_sender::tokenToKeyCode( Token::KEY_z ),
+              uint16_t{ KEY_Z } );
+    QCOMPARE( uinput_sender::tokenToKeyCode( k_0 ), uint16_t{ KEY_0 } );
+    QCOMPARE( uinput_sender::tokenToKeyCode( k_f12 ), uint16_t{ KEY_F12 } );
+    QCOMPARE( uinput_sender::tokenToKeyCode( k_enter ),
+              uint16_t{ KEY_ENTER } );
+    QCOMPARE( uinput_sender::tokenToKeyCode( Token::MODIFIER_CTRL ),
+              uint16_t{ KEY_LEFTCTRL } );
+    QCOMPARE( uinput_sender::tokenToKeyCode( Token::MODIFIER_SUPER ),
+              uint16_t{ KEY_LEFTMETA } );
+}
+
+void UinputKeyboardTest::writesOneBatch()
+{
+    StandIn standIn;
+    uinput::Device device( standIn.takeWriteEnd() );
+
+    const auto ctrl = uinput_sender::tokenToKeyCode( Token::MODIFIER_CTRL );
+    const auto c = uinput_sender::tokenToKeyCode( Token::KEY_c );
+    QVERIFY( device.write( { { ctrl, true },
+                             { c, true },
+                             { c, false },
+                             { ctrl, false } } ) );
+
+    const auto events = standIn.readOnce();
+    QCOMPARE( events.size(), std::size_t{ 8 } );
+    const auto e = std::vector<std::pair<uint16_t, int32_t>>{
+        { ctrl, 1 }, { c, 1 }, { c, 0 }, { ctrl, 0 }
+    };
+    QVERIFY( keyEvents( events ) == e );
+}
+
+void UinputKeyboardTest::everyKeyIsItsOwnReport()
+{
+    StandIn standIn;
+    uinput::Device device( standIn.takeWriteEnd() );
+
+    std::vector<uinput::KeyEvent> batch;
+    for ( uint16_t i = 0; i < 32; ++i )
+    {
+        batch.push_back( uinput::KeyEvent{ uinput::letterKey( i % 26 ),
+                                           i % 2 == 0 } );
+    }
+    QVERIFY( device.write( batch ) );
+
+    const auto events = standIn.readOnce();
+    QCOMPARE( events.size(), batch.size() * 2 );
+    for ( std::size_t i = 0; i < events.size(); i += 2 )
+    {
+        QCOMPARE( events[i].type, uint16_t{ EV_KEY } );
+        QCOMPARE( events[i + 1].type, uint16_t{ EV_SYN } );
+        QCOMPARE( events[i + 1].code, uint16_t{ SYN_REPORT } );
+    }
+}
+
+void UinputKeyboardTest::emptyWriteWritesNothing()
+{
+    StandIn standIn;
+    {
+        uinput::Device device( standIn.takeWriteEnd() );
+        QVERIFY( device.write( {} ) );
+    }
+    // The device closed the write end, so this sees end of file.
+    QVERIFY( standIn.readOnce().empty() );
+}
+
+void UinputKeyboardTest::createFailsWithoutUinput()
+{
+    QVERIFY( !uinput::Device::create( "/nonexistent/uinput" ) );
+    // Opens, but isn't uinput, so creating the device fails.
+    QVERIFY( !uinput::Device::create( "/dev/null" ) );
+}
+
+void UinputKeyboardTest::senderWritesInOrderAfterSettling()
+{
+    StandIn standIn;
+    const auto settleTime = std::chrono::milliseconds( 50 );
+    const auto start = std::chrono::steady_clock::now();
+    uinput_sender::MacroSender sender(
+        std::make_unique<uinput::Device>( standIn.takeWriteEnd() ),
+        settleTime );
+    QVERIFY( sender.available() );
+
+    const auto a = uinput_sender::tokenToKeyCode( Token::KEY_a );
+    const auto b = uinput_sender::tokenToKeyCode( Token::KEY_b );
+    sender.send( { { a, true, 0 }, { a, false, 20 } } );
+    sender.send( { { b, true, 0 }, { b, false, 0 } } );
+
+    std::vector<std::pair<uint16_t, int32_t>> keys;
+    while ( keys.size() < 4 )
+    {
+        const auto events = keyEvents( standIn.readOnce() );
+        QVERIFY( !events.empty() );
+        keys.insert( keys.end(), events.begin(), events.end() );
+    }
+    QVERIFY( std::chrono::steady_clock::now() - start >= settleTime );
+    const auto e = std::vector<std::pair<uint16_t, int32_t>>{
+        { a, 1 }, { a, 0 }, { b, 1 }, { b, 0 }
+    };
+    QVERIFY( keys == e );
+}
+
+void UinputKeyboardTest::senderStopsDuringDelay()
+{
+    StandIn standIn;
+    const auto a = uinput_sender::tokenToKeyCode( Token::KEY_a );
+    const auto start = std::chrono::steady_clock::now();
+    {
+        uinput_sender::MacroSender sender(
+            std::make_unique<uinput::Device>( standIn.takeWriteEnd() ),
+            std::chrono::milliseconds( 0 ) );
+        sender.send( { { a, true, 0 }, { a, false, 60000 } } );
+        QCOMPARE( keyEvents( standIn.readOnce() ).size(), std::size_t{ 1 } );
+    }
+    QVERIFY( std::chrono::steady_clock::now() - start
+             < std::chrono::seconds( 10 ) );
+    // The device is gone and nothing more was written.
+    QVERIFY( standIn.readOnce().empty() );
+
+    uinput_sender::MacroSender none( nullptr, std::chrono::milliseconds( 0 ) );
+    QVERIFY( !none.available() );
+    none.send( { { a, true, 0 } } );
+}
+
+QTEST_APPLESS_MAIN( UinputKeyboardTest )
+
+#include "tst_uinputkeyboardtest.moc"
@@ -0,0 +1,26 @@
+QT += testlib
+QT -= gui
+CONFIG   += c++1z
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+DEFINES += ELPP_NO_DEFAULT_LOG_FILE
+
+INCLUDEPATH += ../../src/keyboard_input \
+    ../../third-party/easylogging++
+
+SOURCES +=  tst_uinputkeyboardtest.cpp \
+    ../../src/keyboard_input/input_parser.cpp \
+    ../../src/keyboard_input/keyboard_macro.cpp \
+    ../../src/keyboard_input/uinput_device.cpp \
+    ../../src/keyboard_input/uinput_sender.cpp \
+    ../../third-party/easylogging++/easylogging++.cc
+
+HEADERS += \
+    ../../src/keyboard_input/input_parser.h \
+    ../../src/keyboard_input/keyboard_macro.h \
+    ../../src/keyboard_input/uinput_device.h \
+    ../../src/keyboard_input/uinput_sender.h